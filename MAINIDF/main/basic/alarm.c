@@ -0,0 +1,566 @@
+/**
+ * @file alarm.c
+ * @brief 闹钟、倒计时与番茄钟实现
+ *
+ * 堆中 id 0 ~ ALARM_MAX-1 对应闹钟序号，ALARM_MAX 起对应计时器句柄。
+ * 闹钟增删、对时或漂移补偿后重新计算全部闹钟（最多 ALARM_MAX 个），计时器只在启动和到期时更新。
+ * 闹钟的截止时间由系统时间换算到单调时钟，两者之间的偏差（adjtime 平滑调整尚未完成的部分）
+ * 可能让定时器提前到期，到期时再按系统时间检查一次，未到时间则按剩余时间重新放入堆中。
+ */
+
+#include "alarm.h"
+#include <string.h>
+#include <sys/time.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "alarm_heap.h"
+#include "alarm_store.h"
+#include "sys_tz.h"
+#include "settings.h"
+#include "timesync.h"
+
+static const char *TAG = "alarm";
+
+ESP_EVENT_DEFINE_BASE(ALARM_EVENT);
+
+#define ALARM_TASK_STACK    3072
+#define ALARM_TASK_PRIO     4
+#define ALARM_SLACK_US      2000        // 截止时间在此范围内的一起处理
+#define HEAP_CAP            (ALARM_MAX + ALARM_TIMER_MAX)
+#define TIMER_ID(h)         (ALARM_MAX + (h))
+
+/* 任务通知位 */
+#define NOTIFY_DUE          (1 << 0)    // 定时器到期
+#define NOTIFY_RESCHEDULE   (1 << 1)    // 系统时间（对时、漂移补偿）或时区变化
+
+/* 闹钟列表 */
+typedef struct {
+    uint8_t count;
+    alarm_cfg_t alarms[ALARM_MAX];
+} alarm_list_t;
+
+typedef struct {
+    bool active;
+    alarm_kind_t kind;
+    char label[ALARM_LABEL_MAX];
+    int64_t due_us;             // 单调时钟
+    alarm_pomo_cfg_t pomo;
+    alarm_pomo_phase_t phase;
+    uint16_t rounds;
+} alarm_timer_t;
+
+static SemaphoreHandle_t s_mutex = NULL;
+static TaskHandle_t s_task = NULL;
+static esp_timer_handle_t s_timer = NULL;
+
+/* 以下由 s_mutex 保护 */
+static alarm_list_t s_list;
+static alarm_store_t s_store;
+static time_t s_alarm_due[ALARM_MAX];   // 闹钟下次触发的 UTC 时刻，0 表示不触发
+static alarm_timer_t s_timers[ALARM_TIMER_MAX];
+static alarm_heap_node_t s_heap_nodes[HEAP_CAP];
+static uint16_t s_heap_pos[HEAP_CAP];
+static alarm_heap_t s_heap;
+static int64_t s_armed_us = -1;         // 当前定时器的截止时间，-1 表示未启动
+
+static int64_t wall_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// 本地时间对应的 UTC 时刻，夏令时切换附近按切换后的偏移
+static time_t local_to_utc(int64_t local)
+{
+    time_t guess = (time_t)(local - sys_tz_offset((time_t)local));
+    return (time_t)(local - sys_tz_offset(guess));
+}
+
+// 闹钟在 now 之后的下一次触发时刻，没有则返回 0
+static time_t next_occurrence(const alarm_cfg_t *cfg, time_t now)
+{
+    struct tm lt;
+
+    sys_tz_localtime(now, &lt);
+    int64_t midnight = (int64_t)now + sys_tz_offset(now) - (lt.tm_hour * 3600 + lt.tm_min * 60 + lt.tm_sec);
+    for (int d = 0; d <= 7; d++) {
+        if (cfg->days && !(cfg->days & (1 << ((lt.tm_wday + d) % 7)))) {
+            continue;
+        }
+        time_t t = local_to_utc(midnight + d * 86400 + cfg->hour * 3600 + cfg->minute * 60);
+        if (t > now) {
+            return t;
+        }
+    }
+    return 0;
+}
+
+// 重新计算全部闹钟，需持有 s_mutex
+static void schedule_alarms_locked(void)
+{
+    bool valid = timesync_is_valid();
+    int64_t wall = wall_us();
+    int64_t mono = esp_timer_get_time();
+
+    for (int i = 0; i < ALARM_MAX; i++) {
+        const alarm_cfg_t *cfg = &s_list.alarms[i];
+        s_alarm_due[i] = (valid && i < s_list.count && cfg->enabled) ? next_occurrence(cfg, (time_t)(wall / 1000000)) : 0;
+        if (s_alarm_due[i]) {
+            alarm_heap_set(&s_heap, i, mono + (int64_t)s_alarm_due[i] * 1000000 - wall);
+        } else {
+            alarm_heap_remove(&s_heap, i);
+        }
+    }
+}
+
+// 按堆顶启动定时器，需持有 s_mutex
+static void arm_locked(void)
+{
+    alarm_heap_node_t top;
+
+    if (!alarm_heap_peek(&s_heap, &top)) {
+        if (s_armed_us >= 0) {
+            esp_timer_stop(s_timer);
+            s_armed_us = -1;
+        }
+        return;
+    }
+    if (top.key == s_armed_us) {
+        return;
+    }
+
+    int64_t delay = top.key - esp_timer_get_time();
+    esp_timer_stop(s_timer);
+    esp_timer_start_once(s_timer, delay > 0 ? delay : 0);
+    s_armed_us = top.key;
+}
+
+// 保存修改或新增的闹钟，需持有 s_mutex
+static esp_err_t save_locked(int index)
+{
+    esp_err_t err = alarm_store_put(&s_store, s_list.alarms, s_list.count, index);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Save failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+// 保存删除操作，需持有 s_mutex
+static esp_err_t save_remove_locked(int index)
+{
+    esp_err_t err = alarm_store_remove(&s_store, s_list.alarms, s_list.count, index);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Save failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+static void load_locked(void)
+{
+    esp_err_t err = alarm_store_open(&s_store, ALARM_FILE, s_list.alarms, &s_list.count);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Open %s failed: %s, alarms will not be saved", ALARM_FILE, esp_err_to_name(err));
+    }
+}
+
+static void play(const char *melody)
+{
+    if (beep_melody_play(melody) != ESP_OK) {
+        ESP_LOGW(TAG, "Melody '%s' unavailable", melody);
+    }
+}
+
+static uint32_t pomo_phase_ms(const alarm_timer_t *t)
+{
+    uint16_t min = t->phase == ALARM_POMO_WORK ? t->pomo.work_min :
+                   t->phase == ALARM_POMO_SHORT_BREAK ? t->pomo.short_min : t->pomo.long_min;
+    return (uint32_t)min * 60 * 1000;
+}
+
+// 处理一个到期项，填写事件数据，返回要播放的铃声；需持有 s_mutex
+static const char *fire_locked(uint16_t id, int64_t now, int64_t wall, int64_t key, alarm_fired_t *ev, bool *dirty)
+{
+    memset(ev, 0, sizeof(*ev));
+    ev->late_ms = now > key ? (uint32_t)((now - key) / 1000) : 0;
+
+    if (id < ALARM_MAX) {
+        alarm_cfg_t *cfg = &s_list.alarms[id];
+        ev->kind = ALARM_KIND_ALARM;
+        ev->index = id;
+        strlcpy(ev->label, cfg->label, sizeof(ev->label));
+        if (cfg->days == 0) {
+            cfg->enabled = false;
+            *dirty = true;
+        }
+        // 从本次截止时间之后计算，提前处理时不会在同一分钟再响一次
+        time_t from = (time_t)(wall / 1000000);
+        if (s_alarm_due[id] > from) {
+            from = s_alarm_due[id];
+        }
+        s_alarm_due[id] = cfg->enabled ? next_occurrence(cfg, from) : 0;
+        if (s_alarm_due[id]) {
+            alarm_heap_set(&s_heap, id, now + (int64_t)s_alarm_due[id] * 1000000 - wall);
+        }
+        return cfg->melody[0] ? cfg->melody : ALARM_MELODY;
+    }
+
+    int h = id - ALARM_MAX;
+    alarm_timer_t *t = &s_timers[h];
+    ev->kind = t->kind;
+    ev->index = h;
+    strlcpy(ev->label, t->label, sizeof(ev->label));
+    if (t->kind == ALARM_KIND_COUNTDOWN) {
+        t->active = false;
+        return ALARM_MELODY;
+    }
+
+    // 番茄钟进入下一阶段，从上一阶段的截止时间起算，不累积处理延迟
+    if (t->phase == ALARM_POMO_WORK) {
+        t->rounds++;
+        t->phase = (t->pomo.long_every && t->rounds % t->pomo.long_every == 0) ? ALARM_POMO_LONG_BREAK : ALARM_POMO_SHORT_BREAK;
+    } else {
+        t->phase = ALARM_POMO_WORK;
+    }
+    t->due_us += (int64_t)pomo_phase_ms(t) * 1000;
+    alarm_heap_set(&s_heap, id, t->due_us);
+    ev->phase = t->phase;
+    ev->rounds = t->rounds;
+    return ALARM_PHASE_MELODY;
+}
+
+static void process_due(void)
+{
+    alarm_fired_t events[HEAP_CAP];
+    char melody[BEEP_MELODY_NAME_MAX + 1] = "";
+    int n = 0;
+    alarm_heap_node_t top;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    int64_t now = esp_timer_get_time();
+    int64_t wall = wall_us();
+    s_armed_us = -1;
+    while (n < HEAP_CAP && alarm_heap_peek(&s_heap, &top) && top.key <= now + ALARM_SLACK_US) {
+        bool dirty = false;
+        if (top.id < ALARM_MAX && (int64_t)s_alarm_due[top.id] * 1000000 > wall + ALARM_SLACK_US) {
+            // 系统时间比单调时钟走得慢，还没到闹钟时间
+            alarm_heap_set(&s_heap, top.id, now + (int64_t)s_alarm_due[top.id] * 1000000 - wall);
+            continue;
+        }
+        alarm_heap_remove(&s_heap, top.id);
+        const char *m = fire_locked(top.id, now, wall, top.key, &events[n], &dirty);
+        if (dirty) {
+            save_locked(top.id);
+        }
+        // 同时到期时闹钟和倒计时的铃声优先于番茄钟提示音
+        if (melody[0] == '\0' || events[n].kind != ALARM_KIND_POMODORO) {
+            strlcpy(melody, m, sizeof(melody));
+        }
+        n++;
+    }
+    arm_locked();
+    xSemaphoreGive(s_mutex);
+
+    if (melody[0]) {
+        play(melody);
+    }
+    for (int i = 0; i < n; i++) {
+        ESP_LOGI(TAG, "Fired kind %d #%d '%s' (late %lu ms)", events[i].kind, events[i].index, events[i].label,
+                 (unsigned long)events[i].late_ms);
+        esp_event_post(ALARM_EVENT, ALARM_EVENT_FIRED, &events[i], sizeof(events[i]), 0);
+    }
+}
+
+static void alarm_task(void *arg)
+{
+    uint32_t bits;
+
+    for (;;) {
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        if (bits & NOTIFY_RESCHEDULE) {
+            xSemaphoreTake(s_mutex, portMAX_DELAY);
+            schedule_alarms_locked();
+            arm_locked();
+            xSemaphoreGive(s_mutex);
+        }
+        if (bits & NOTIFY_DUE) {
+            process_due();
+        }
+    }
+}
+
+// esp_timer 任务中执行，只通知闹钟任务
+static void timer_cb(void *arg)
+{
+    xTaskNotify(s_task, NOTIFY_DUE, eSetBits);
+}
+
+static void reschedule_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    xTaskNotify(s_task, NOTIFY_RESCHEDULE, eSetBits);
+}
+
+static void tz_changed_cb(setting_id_t id, void *arg)
+{
+    xTaskNotify(s_task, NOTIFY_RESCHEDULE, eSetBits);
+}
+
+esp_err_t alarm_init(void)
+{
+    if (s_mutex) {
+        return ESP_OK;
+    }
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_timer_create_args_t args = {
+        .callback = timer_cb,
+        .name = "alarm",
+    };
+    esp_err_t err = esp_timer_create(&args, &s_timer);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    alarm_heap_init(&s_heap, s_heap_nodes, s_heap_pos, HEAP_CAP);
+    load_locked();
+    xSemaphoreGive(s_mutex);
+
+    if (xTaskCreate(alarm_task, "alarm", ALARM_TASK_STACK, NULL, ALARM_TASK_PRIO, &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_event_handler_register(TIMESYNC_EVENT, TIMESYNC_EVENT_SYNCED, reschedule_cb, NULL);
+    esp_event_handler_register(TIMESYNC_EVENT, TIMESYNC_EVENT_TRIMMED, reschedule_cb, NULL);
+    err = settings_subscribe(SETTING_TIMEZONE, tz_changed_cb, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    xTaskNotify(s_task, NOTIFY_RESCHEDULE, eSetBits);
+    ESP_LOGI(TAG, "%u alarms", s_list.count);
+    return ESP_OK;
+}
+
+int alarm_count(void)
+{
+    return s_list.count;
+}
+
+esp_err_t alarm_get(int index, alarm_cfg_t *out)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (index >= 0 && index < s_list.count) {
+        *out = s_list.alarms[index];
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+static bool cfg_valid(const alarm_cfg_t *cfg)
+{
+    return cfg->hour < 24 && cfg->minute < 60 && cfg->days < 0x80;
+}
+
+esp_err_t alarm_add(const alarm_cfg_t *cfg, int *index)
+{
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!cfg_valid(cfg)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (s_list.count >= ALARM_MAX) {
+        xSemaphoreGive(s_mutex);
+        return ESP_ERR_NO_MEM;
+    }
+    int i = s_list.count++;
+    s_list.alarms[i] = *cfg;
+    esp_err_t err = save_locked(i);
+    schedule_alarms_locked();
+    arm_locked();
+    xSemaphoreGive(s_mutex);
+
+    if (index) {
+        *index = i;
+    }
+    return err;
+}
+
+esp_err_t alarm_update(int index, const alarm_cfg_t *cfg)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!cfg_valid(cfg)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (index >= 0 && index < s_list.count) {
+        if (memcmp(&s_list.alarms[index], cfg, sizeof(*cfg)) == 0) {
+            err = ESP_OK;
+        } else {
+            s_list.alarms[index] = *cfg;
+            err = save_locked(index);
+            schedule_alarms_locked();
+            arm_locked();
+        }
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t alarm_remove(int index)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (index >= 0 && index < s_list.count) {
+        memmove(&s_list.alarms[index], &s_list.alarms[index + 1], (s_list.count - index - 1) * sizeof(alarm_cfg_t));
+        s_list.count--;
+        err = save_remove_locked(index);
+        schedule_alarms_locked();
+        arm_locked();
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t alarm_next(int *index, time_t *when)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    int best = -1;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    for (int i = 0; i < s_list.count; i++) {
+        if (s_alarm_due[i] && (best < 0 || s_alarm_due[i] < s_alarm_due[best])) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        if (index) {
+            *index = best;
+        }
+        if (when) {
+            *when = s_alarm_due[best];
+        }
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+// 启动计时器，需持有 s_mutex
+static esp_err_t timer_start_locked(const alarm_timer_t *t, int *handle)
+{
+    for (int h = 0; h < ALARM_TIMER_MAX; h++) {
+        if (!s_timers[h].active) {
+            s_timers[h] = *t;
+            s_timers[h].active = true;
+            alarm_heap_set(&s_heap, TIMER_ID(h), t->due_us);
+            arm_locked();
+            if (handle) {
+                *handle = h;
+            }
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t alarm_countdown_start(uint32_t seconds, const char *label, int *handle)
+{
+    alarm_timer_t t = {
+        .kind = ALARM_KIND_COUNTDOWN,
+        .due_us = esp_timer_get_time() + (int64_t)seconds * 1000000,
+    };
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (label) {
+        strlcpy(t.label, label, sizeof(t.label));
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    esp_err_t err = timer_start_locked(&t, handle);
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t alarm_pomodoro_start(const alarm_pomo_cfg_t *cfg, int *handle)
+{
+    static const alarm_pomo_cfg_t def = ALARM_POMO_DEFAULT;
+    alarm_timer_t t = {
+        .kind = ALARM_KIND_POMODORO,
+        .pomo = cfg ? *cfg : def,
+        .phase = ALARM_POMO_WORK,
+    };
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (t.pomo.work_min == 0 || t.pomo.short_min == 0 || (t.pomo.long_every && t.pomo.long_min == 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    t.due_us = esp_timer_get_time() + (int64_t)pomo_phase_ms(&t) * 1000;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    esp_err_t err = timer_start_locked(&t, handle);
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t alarm_timer_stop(int handle)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (handle >= 0 && handle < ALARM_TIMER_MAX && s_timers[handle].active) {
+        s_timers[handle].active = false;
+        alarm_heap_remove(&s_heap, TIMER_ID(handle));
+        arm_locked();
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t alarm_timer_remaining(int handle, uint32_t *ms)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (handle >= 0 && handle < ALARM_TIMER_MAX && s_timers[handle].active) {
+        int64_t left = s_timers[handle].due_us - esp_timer_get_time();
+        *ms = left > 0 ? (uint32_t)(left / 1000) : 0;
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
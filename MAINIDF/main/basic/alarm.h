@@ -0,0 +1,167 @@
+/**
+ * @file alarm.h
+ * @brief 闹钟、倒计时与番茄钟
+ *
+ * 所有待触发的闹钟、倒计时和番茄钟阶段按截止时间放在一个最小堆中（alarm_heap.h），
+ * 只为最早的截止时间启动一个 esp_timer，到期后由闹钟任务取出所有到期项、
+ * 计算下一次时间、重新启动定时器：
+ * - 截止时间使用 esp_timer 单调时钟，浅睡眠期间继续计时；
+ *   启用自动浅睡眠（CONFIG_PM_ENABLE）时由该定时器唤醒芯片，平时不占用 CPU
+ * - 闹钟按本地时间（sys_tz.h）计算，对时、漂移补偿或修改时区后重新计算；未对时前闹钟不生效
+ * - 闹钟设置以追加日志保存在 LittleFS（ALARM_FILE，见 alarm_store.h），每次修改只追加一条记录；
+ *   倒计时和番茄钟不保存
+ *
+ * 触发时播放铃声并发布 ALARM_EVENT_FIRED，停止铃声由界面调用 beep_melody_stop()。
+ * 接口线程安全。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_event.h"
+#include "beep_melody.h"
+
+#define ALARM_MAX               16                          // 闹钟个数
+#define ALARM_TIMER_MAX         4                           // 同时运行的倒计时/番茄钟个数
+#define ALARM_LABEL_MAX         16                          // 名称长度（含'\0'）
+#define ALARM_FILE              "/littlefs/alarms.jnl"
+#define ALARM_MELODY            "alarm"                     // 默认铃声
+#define ALARM_PHASE_MELODY      "warn"                      // 番茄钟切换阶段的提示音
+
+ESP_EVENT_DECLARE_BASE(ALARM_EVENT);
+
+/** ALARM_EVENT 事件 */
+typedef enum {
+    ALARM_EVENT_FIRED,          // 到期，数据为 alarm_fired_t
+} alarm_event_t;
+
+/** 类型 */
+typedef enum {
+    ALARM_KIND_ALARM,
+    ALARM_KIND_COUNTDOWN,
+    ALARM_KIND_POMODORO,
+} alarm_kind_t;
+
+/** 番茄钟阶段 */
+typedef enum {
+    ALARM_POMO_WORK,
+    ALARM_POMO_SHORT_BREAK,
+    ALARM_POMO_LONG_BREAK,
+} alarm_pomo_phase_t;
+
+/** 闹钟设置（保存到文件，修改结构时增加 ALARM_STORE_VERSION） */
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t days;               // bit0 星期日 ~ bit6 星期六，0 表示只响一次，响后自动关闭
+    bool enabled;
+    char label[ALARM_LABEL_MAX];
+    char melody[BEEP_MELODY_NAME_MAX + 1];  // 空串使用 ALARM_MELODY
+} alarm_cfg_t;
+
+/** 番茄钟参数 */
+typedef struct {
+    uint16_t work_min;
+    uint16_t short_min;
+    uint16_t long_min;
+    uint8_t long_every;         // 每完成几个工作段后长休息一次
+} alarm_pomo_cfg_t;
+
+#define ALARM_POMO_DEFAULT { .work_min = 25, .short_min = 5, .long_min = 15, .long_every = 4 }
+
+/** ALARM_EVENT_FIRED 数据 */
+typedef struct {
+    alarm_kind_t kind;
+    int index;                  // 闹钟序号，或倒计时/番茄钟句柄
+    char label[ALARM_LABEL_MAX];
+    alarm_pomo_phase_t phase;   // 番茄钟：进入的阶段
+    uint16_t rounds;            // 番茄钟：已完成的工作段数
+    uint32_t late_ms;           // 实际处理时间比截止时间晚多少
+} alarm_fired_t;
+
+/**
+ * 初始化，读取保存的闹钟并启动闹钟任务
+ * 需在挂载 LittleFS、sys_tz_init() 和 esp_event_loop_create_default() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t alarm_init(void);
+
+/**
+ * 闹钟个数
+ * @return int
+ */
+int alarm_count(void);
+
+/**
+ * 读取闹钟
+ * @param index 序号
+ * @param out 输出
+ * @return esp_err_t 越界返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t alarm_get(int index, alarm_cfg_t *out);
+
+/**
+ * 添加闹钟并保存
+ * @param cfg 设置
+ * @param index 输出序号，可为NULL
+ * @return esp_err_t 已满返回 ESP_ERR_NO_MEM，时间无效返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t alarm_add(const alarm_cfg_t *cfg, int *index);
+
+/**
+ * 修改闹钟并保存
+ * @param index 序号
+ * @param cfg 设置
+ * @return esp_err_t 越界返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t alarm_update(int index, const alarm_cfg_t *cfg);
+
+/**
+ * 删除闹钟并保存，后面的闹钟序号减一
+ * @param index 序号
+ * @return esp_err_t 越界返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t alarm_remove(int index);
+
+/**
+ * 下一个要响的闹钟
+ * @param index 输出序号，可为NULL
+ * @param when 输出 UTC 时刻，可为NULL
+ * @return esp_err_t 没有已开启的闹钟或未对时返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t alarm_next(int *index, time_t *when);
+
+/**
+ * 开始倒计时
+ * @param seconds 时长
+ * @param label 名称，可为NULL
+ * @param handle 输出句柄，可为NULL
+ * @return esp_err_t 同时运行的计时器已满返回 ESP_ERR_NO_MEM
+ */
+esp_err_t alarm_countdown_start(uint32_t seconds, const char *label, int *handle);
+
+/**
+ * 开始番茄钟，从工作段开始，直到调用 alarm_timer_stop()
+ * @param cfg 参数，NULL 使用 ALARM_POMO_DEFAULT
+ * @param handle 输出句柄，可为NULL
+ * @return esp_err_t 同时运行的计时器已满返回 ESP_ERR_NO_MEM
+ */
+esp_err_t alarm_pomodoro_start(const alarm_pomo_cfg_t *cfg, int *handle);
+
+/**
+ * 停止倒计时或番茄钟
+ * @param handle 句柄
+ * @return esp_err_t 未在运行返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t alarm_timer_stop(int handle);
+
+/**
+ * 倒计时或番茄钟当前阶段的剩余时间
+ * @param handle 句柄
+ * @param ms 输出
+ * @return esp_err_t 未在运行返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t alarm_timer_remaining(int handle, uint32_t *ms);
@@ -0,0 +1,136 @@
+/**
+ * @file alarm_heap.c
+ * @brief 按截止时间排序的最小堆实现
+ */
+
+#include "alarm_heap.h"
+
+static inline bool before(const alarm_heap_node_t *a, const alarm_heap_node_t *b)
+{
+    return a->key < b->key || (a->key == b->key && a->id < b->id);
+}
+
+static inline void place(alarm_heap_t *h, uint16_t i, alarm_heap_node_t node)
+{
+    h->nodes[i] = node;
+    h->pos[node.id] = i;
+}
+
+static void sift_up(alarm_heap_t *h, uint16_t i)
+{
+    alarm_heap_node_t node = h->nodes[i];
+
+    while (i > 0) {
+        uint16_t parent = (i - 1) / 2;
+        if (!before(&node, &h->nodes[parent])) {
+            break;
+        }
+        place(h, i, h->nodes[parent]);
+        i = parent;
+    }
+    place(h, i, node);
+}
+
+static void sift_down(alarm_heap_t *h, uint16_t i)
+{
+    alarm_heap_node_t node = h->nodes[i];
+
+    for (;;) {
+        uint32_t child = 2 * (uint32_t)i + 1;
+        if (child >= h->size) {
+            break;
+        }
+        if (child + 1 < h->size && before(&h->nodes[child + 1], &h->nodes[child])) {
+            child++;
+        }
+        if (!before(&h->nodes[child], &node)) {
+            break;
+        }
+        place(h, i, h->nodes[child]);
+        i = child;
+    }
+    place(h, i, node);
+}
+
+void alarm_heap_init(alarm_heap_t *h, alarm_heap_node_t *nodes, uint16_t *pos, uint16_t cap)
+{
+    h->nodes = nodes;
+    h->pos = pos;
+    h->size = 0;
+    h->cap = cap;
+    for (uint16_t i = 0; i < cap; i++) {
+        pos[i] = ALARM_HEAP_NONE;
+    }
+}
+
+bool alarm_heap_set(alarm_heap_t *h, uint16_t id, int64_t key)
+{
+    if (id >= h->cap) {
+        return false;
+    }
+
+    uint16_t i = h->pos[id];
+    if (i == ALARM_HEAP_NONE) {
+        i = h->size++;
+        place(h, i, (alarm_heap_node_t){.key = key, .id = id});
+        sift_up(h, i);
+        return true;
+    }
+
+    int64_t old = h->nodes[i].key;
+    h->nodes[i].key = key;
+    if (key < old) {
+        sift_up(h, i);
+    } else {
+        sift_down(h, i);
+    }
+    return true;
+}
+
+bool alarm_heap_remove(alarm_heap_t *h, uint16_t id)
+{
+    if (!alarm_heap_contains(h, id)) {
+        return false;
+    }
+
+    uint16_t i = h->pos[id];
+    h->pos[id] = ALARM_HEAP_NONE;
+    if (--h->size == i) {
+        return true;
+    }
+
+    // 末尾元素补到空位，可能需要上移或下移
+    alarm_heap_node_t last = h->nodes[h->size];
+    place(h, i, last);
+    if (i > 0 && before(&last, &h->nodes[(i - 1) / 2])) {
+        sift_up(h, i);
+    } else {
+        sift_down(h, i);
+    }
+    return true;
+}
+
+bool alarm_heap_contains(const alarm_heap_t *h, uint16_t id)
+{
+    return id < h->cap && h->pos[id] != ALARM_HEAP_NONE;
+}
+
+bool alarm_heap_peek(const alarm_heap_t *h, alarm_heap_node_t *out)
+{
+    if (h->size == 0) {
+        return false;
+    }
+    *out = h->nodes[0];
+    return true;
+}
+
+bool alarm_heap_pop(alarm_heap_t *h, alarm_heap_node_t *out)
+{
+    if (h->size == 0) {
+        return false;
+    }
+    if (out) {
+        *out = h->nodes[0];
+    }
+    return alarm_heap_remove(h, h->nodes[0].id);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file alarm_heap.h
+ * @brief 按截止时间排序的最小堆
+ *
+ * 每个元素由调用方分配的 id（0 ~ cap-1）标识，pos 数组记录 id 在堆中的位置，
+ * 因此除插入、取最小值外，还可以按 id 修改截止时间或删除，均为 O(log n)。
+ * 截止时间相同时 id 小的在前，结果与插入顺序无关。
+ *
+ * 本模块只做计算，不依赖 ESP-IDF；存储由调用方提供，不分配内存，不加锁。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ALARM_HEAP_NONE     UINT16_MAX      // pos 中表示不在堆中
+
+/** 堆元素 */
+typedef struct {
+    int64_t key;            // 截止时间
+    uint16_t id;
+} alarm_heap_node_t;
+
+/** 堆 */
+typedef struct {
+    alarm_heap_node_t *nodes;   // cap 个元素
+    uint16_t *pos;              // id -> 在 nodes 中的下标
+    uint16_t size;
+    uint16_t cap;
+} alarm_heap_t;
+
+/**
+ * 初始化为空堆
+ * @param h 堆
+ * @param nodes 元素存储，cap 个
+ * @param pos 位置表，cap 个
+ * @param cap 容量，不超过 ALARM_HEAP_NONE
+ */
+void alarm_heap_init(alarm_heap_t *h, alarm_heap_node_t *nodes, uint16_t *pos, uint16_t cap);
+
+/**
+ * 插入元素，已在堆中时修改其截止时间
+ * @param h 堆
+ * @param id 元素 id
+ * @param key 截止时间
+ * @return bool id 超出容量返回 false
+ */
+bool alarm_heap_set(alarm_heap_t *h, uint16_t id, int64_t key);
+
+/**
+ * 删除元素
+ * @param h 堆
+ * @param id 元素 id
+ * @return bool 不在堆中返回 false
+ */
+bool alarm_heap_remove(alarm_heap_t *h, uint16_t id);
+
+/**
+ * 元素是否在堆中
+ * @param h 堆
+ * @param id 元素 id
+ * @return bool
+ */
+bool alarm_heap_contains(const alarm_heap_t *h, uint16_t id);
+
+/**
+ * 查看截止时间最早的元素
+ * @param h 堆
+ * @param out 输出
+ * @return bool 堆为空返回 false
+ */
+bool alarm_heap_peek(const alarm_heap_t *h, alarm_heap_node_t *out);
+
+/**
+ * 取出截止时间最早的元素
+ * @param h 堆
+ * @param out 输出，可为NULL
+ * @return bool 堆为空返回 false
+ */
+bool alarm_heap_pop(alarm_heap_t *h, alarm_heap_node_t *out);
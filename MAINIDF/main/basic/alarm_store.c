@@ -0,0 +1,240 @@
+/**
+ * @file alarm_store.c
+ * @brief 闹钟设置的日志式存储实现
+ *
+ * 快照代数只增不减：新快照使用日志中出现过的最大代数加一，
+ * 掉电留下的残缺快照和它之前的记录一起在下一次压缩时丢弃。
+ */
+
+#include "alarm_store.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "alarm_store";
+
+/* 记录类型 */
+enum {
+    REC_PUT = 1,        // 修改或追加 index
+    REC_REMOVE,         // 删除 index
+    REC_BASE,           // 快照开始，index 为快照中的闹钟数
+    REC_SNAP,           // 快照中的第 index 个闹钟
+    REC_END,            // 快照结束
+};
+
+typedef struct {
+    uint8_t version;
+    uint8_t op;
+    uint8_t index;
+    uint8_t reserved;
+    uint32_t gen;
+    alarm_cfg_t cfg;    // 仅 PUT/SNAP
+} store_rec_t;
+
+#define REC_HDR_LEN     offsetof(store_rec_t, cfg)
+
+/** 回放上下文 */
+typedef struct {
+    alarm_cfg_t *alarms;
+    uint8_t count;
+    alarm_cfg_t snap[ALARM_MAX];
+    uint8_t snap_count;
+    uint8_t snap_expect;
+    bool in_snap;
+    uint32_t snap_gen;
+    uint32_t max_gen;
+    uint32_t base_gen;
+    uint32_t skipped;
+} replay_ctx_t;
+
+static bool rec_has_cfg(uint8_t op)
+{
+    return op == REC_PUT || op == REC_SNAP;
+}
+
+static esp_err_t replay_cb(const void *data, size_t len, void *arg)
+{
+    replay_ctx_t *ctx = arg;
+    store_rec_t rec;
+
+    memcpy(&rec, data, len < sizeof(rec) ? len : sizeof(rec));
+    if (len < REC_HDR_LEN || rec.version != ALARM_STORE_VERSION ||
+        len != (rec_has_cfg(rec.op) ? sizeof(rec) : REC_HDR_LEN)) {
+        ctx->skipped++;
+        return ESP_OK;
+    }
+    if (rec.gen > ctx->max_gen) {
+        ctx->max_gen = rec.gen;
+    }
+
+    switch (rec.op) {
+    case REC_PUT:
+        if (rec.index < ctx->count) {
+            ctx->alarms[rec.index] = rec.cfg;
+        } else if (rec.index == ctx->count && ctx->count < ALARM_MAX) {
+            ctx->alarms[ctx->count++] = rec.cfg;
+        } else {
+            ctx->skipped++;
+        }
+        break;
+    case REC_REMOVE:
+        if (rec.index < ctx->count) {
+            memmove(&ctx->alarms[rec.index], &ctx->alarms[rec.index + 1],
+                    (ctx->count - rec.index - 1) * sizeof(alarm_cfg_t));
+            ctx->count--;
+        } else {
+            ctx->skipped++;
+        }
+        break;
+    case REC_BASE:
+        ctx->in_snap = rec.index <= ALARM_MAX;
+        ctx->snap_gen = rec.gen;
+        ctx->snap_expect = rec.index;
+        ctx->snap_count = 0;
+        break;
+    case REC_SNAP:
+        if (ctx->in_snap && rec.gen == ctx->snap_gen && rec.index == ctx->snap_count &&
+            ctx->snap_count < ctx->snap_expect) {
+            ctx->snap[ctx->snap_count++] = rec.cfg;
+        } else {
+            ctx->in_snap = false;
+        }
+        break;
+    case REC_END:
+        if (ctx->in_snap && rec.gen == ctx->snap_gen && ctx->snap_count == ctx->snap_expect) {
+            memcpy(ctx->alarms, ctx->snap, ctx->snap_count * sizeof(alarm_cfg_t));
+            ctx->count = ctx->snap_count;
+            ctx->base_gen = rec.gen;
+        }
+        ctx->in_snap = false;
+        break;
+    default:
+        ctx->skipped++;
+        break;
+    }
+    return ESP_OK;
+}
+
+/* 压缩时保留最近一份完整快照及之后的记录 */
+static bool keep_cb(const void *data, size_t len, void *arg)
+{
+    const alarm_store_t *st = arg;
+    store_rec_t rec;
+
+    if (len < REC_HDR_LEN) {
+        return false;
+    }
+    memcpy(&rec, data, REC_HDR_LEN);
+    return rec.version == ALARM_STORE_VERSION && rec.gen >= st->base_gen;
+}
+
+static esp_err_t append(alarm_store_t *st, uint8_t op, uint32_t gen, uint8_t index, const alarm_cfg_t *cfg)
+{
+    store_rec_t rec;
+
+    memset(&rec, 0, sizeof(rec));   // 结构体末尾的填充也写入文件
+    rec.version = ALARM_STORE_VERSION;
+    rec.op = op;
+    rec.index = index;
+    rec.gen = gen;
+    if (cfg) {
+        rec.cfg = *cfg;
+    }
+    return sys_journal_append(&st->j, &rec, cfg ? sizeof(rec) : REC_HDR_LEN);
+}
+
+/* 日志过大时写快照，END 写入后压缩掉之前的记录 */
+static void maybe_compact(alarm_store_t *st, const alarm_cfg_t *alarms, uint8_t count)
+{
+    if (st->j.size <= ALARM_STORE_COMPACT_SIZE) {
+        return;
+    }
+
+    uint32_t gen = st->gen + 1;
+    esp_err_t err = append(st, REC_BASE, gen, count, NULL);
+    for (uint8_t i = 0; err == ESP_OK && i < count; i++) {
+        err = append(st, REC_SNAP, gen, i, &alarms[i]);
+    }
+    if (err == ESP_OK) {
+        err = append(st, REC_END, gen, 0, NULL);
+    }
+    // BASE 写入后代数就已使用，失败时也不再复用
+    st->gen = gen;
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Snapshot failed: %s", esp_err_to_name(err));
+        return;
+    }
+    st->base_gen = gen;
+    err = sys_journal_compact(&st->j);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Compaction failed: %s", esp_err_to_name(err));
+    }
+}
+
+esp_err_t alarm_store_open(alarm_store_t *st, const char *path, alarm_cfg_t *alarms, uint8_t *count)
+{
+    *count = 0;
+    memset(st, 0, sizeof(*st));
+
+    // 不使用自动压缩：按大小丢弃最旧的记录会破坏回放结果，由快照后手动压缩
+    esp_err_t err = sys_journal_open(&st->j, path, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    sys_journal_set_compactor(&st->j, keep_cb, st);
+
+    replay_ctx_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        sys_journal_close(&st->j);
+        return ESP_ERR_NO_MEM;
+    }
+    ctx->alarms = alarms;
+    err = sys_journal_replay(&st->j, replay_cb, ctx);
+    if (err == ESP_OK) {
+        *count = ctx->count;
+        st->gen = ctx->max_gen;
+        st->base_gen = ctx->base_gen;
+        if (ctx->skipped) {
+            ESP_LOGW(TAG, "%s: skipped %lu records", path, (unsigned long)ctx->skipped);
+        }
+    } else {
+        sys_journal_close(&st->j);
+    }
+    free(ctx);
+    return err;
+}
+
+esp_err_t alarm_store_put(alarm_store_t *st, const alarm_cfg_t *alarms, uint8_t count, uint8_t index)
+{
+    if (index >= count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = append(st, REC_PUT, st->gen, index, &alarms[index]);
+    if (err == ESP_OK) {
+        maybe_compact(st, alarms, count);
+    }
+    return err;
+}
+
+esp_err_t alarm_store_remove(alarm_store_t *st, const alarm_cfg_t *alarms, uint8_t count, uint8_t index)
+{
+    if (index > count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = append(st, REC_REMOVE, st->gen, index, NULL);
+    if (err == ESP_OK) {
+        maybe_compact(st, alarms, count);
+    }
+    return err;
+}
+
+void alarm_store_get_stats(alarm_store_t *st, sys_journal_stats_t *stats)
+{
+    sys_journal_get_stats(&st->j, stats);
+}
+
+void alarm_store_close(alarm_store_t *st)
+{
+    sys_journal_close(&st->j);
+}
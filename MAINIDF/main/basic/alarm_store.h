@@ -0,0 +1,75 @@
+/**
+ * @file alarm_store.h
+ * @brief 闹钟设置的日志式存储
+ *
+ * 闹钟列表保存在追加式日志（sys_journal.h）中，每次修改只追加一条记录，不重写整个文件：
+ * - PUT 修改或追加一个闹钟，REMOVE 删除一个闹钟（后面的序号减一）
+ * - 日志超过 ALARM_STORE_COMPACT_SIZE 时追加一份完整快照（BASE、每个闹钟一条 SNAP、END），
+ *   END 写入后再压缩掉快照之前的记录
+ * - 打开时按顺序回放；没有 END 的快照（写快照时掉电）被忽略，仍使用之前的记录
+ *
+ * 任何时刻掉电，重新打开后得到的都是某次修改之前或之后的完整列表。
+ * 同一存储对象不可并发调用，需由调用方串行化。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "alarm.h"
+#include "sys_journal.h"
+
+#ifndef ALARM_STORE_COMPACT_SIZE
+#define ALARM_STORE_COMPACT_SIZE    4096    // 日志超过此大小时写快照并压缩
+#endif
+#define ALARM_STORE_VERSION         1       // 修改 alarm_cfg_t 时加一，旧版本的记录被忽略
+
+/** 存储对象 */
+typedef struct {
+    sys_journal_t j;
+    uint32_t gen;           // 日志中出现过的最大快照代数，新记录使用此代数
+    uint32_t base_gen;      // 最近一份完整快照的代数，压缩时保留不小于它的记录
+} alarm_store_t;
+
+/**
+ * 打开存储并回放，不存在时创建空列表
+ * @param st 存储对象
+ * @param path 文件路径
+ * @param alarms 输出闹钟列表，ALARM_MAX 个
+ * @param count 输出闹钟个数
+ * @return esp_err_t 操作结果，失败时列表为空
+ */
+esp_err_t alarm_store_open(alarm_store_t *st, const char *path, alarm_cfg_t *alarms, uint8_t *count);
+
+/**
+ * 保存修改或新增的闹钟
+ * @param st 存储对象
+ * @param alarms 修改后的完整列表（需要写快照时使用）
+ * @param count 修改后的闹钟个数
+ * @param index 修改的序号，新增时为 count - 1
+ * @return esp_err_t 操作结果
+ */
+esp_err_t alarm_store_put(alarm_store_t *st, const alarm_cfg_t *alarms, uint8_t count, uint8_t index);
+
+/**
+ * 保存删除操作
+ * @param st 存储对象
+ * @param alarms 删除后的完整列表
+ * @param count 删除后的闹钟个数
+ * @param index 删除的序号
+ * @return esp_err_t 操作结果
+ */
+esp_err_t alarm_store_remove(alarm_store_t *st, const alarm_cfg_t *alarms, uint8_t count, uint8_t index);
+
+/**
+ * 获取日志统计
+ * @param st 存储对象
+ * @param stats 输出
+ */
+void alarm_store_get_stats(alarm_store_t *st, sys_journal_stats_t *stats);
+
+/**
+ * 关闭存储
+ * @param st 存储对象
+ */
+void alarm_store_close(alarm_store_t *st);
@@ -0,0 +1,338 @@
+#include "assets.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "assets";
+
+/*
+    只读资源分区
+    整个资源包映射一次，之后所有指针都直接指向 flash cache 映射区
+
+    字体资源格式 "AFN1"（偏移相对于字体资源起点）：
+      头部 32 字节：魔数(4) 行高(2) 基线(2) bpp(1) cmap数(1) 字形数(2)
+                    下划线位置(1) 下划线粗细(1) 保留(2)
+                    字形表偏移(4) 位图偏移(4) cmap偏移(4) 保留(4)
+      cmap：每条 20 字节：起始码点(4) 范围长度(2) 起始字形(2) 列表长度(2) 类型(1) 保留(1)
+                          码点列表偏移(4) 字形偏移列表偏移(4)，无列表时偏移为0
+      字形表：与 lv_font_fmt_txt_glyph_dsc_t 相同的 8 字节结构
+      位图：按字节对齐的 plain 格式，不压缩
+*/
+
+#define ASSETS_MAGIC        "AST1"
+#define ASSETS_VERSION      1
+#define ASSETS_FONT_MAGIC   "AFN1"
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t version;
+    uint16_t count;
+    uint32_t index_crc;
+    uint32_t total_size;
+    uint32_t names_size;
+    uint32_t reserved[3];
+} asset_pack_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t hash;
+    uint32_t name_off;
+    uint32_t data_off;
+    uint32_t size;
+    uint8_t type;
+    uint8_t reserved[3];
+} asset_entry_t;
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t line_height;
+    int16_t base_line;
+    uint8_t bpp;
+    uint8_t cmap_num;
+    uint16_t glyph_count;
+    int8_t underline_position;
+    int8_t underline_thickness;
+    uint16_t reserved;
+    uint32_t glyph_dsc_off;
+    uint32_t bitmap_off;
+    uint32_t cmap_off;
+    uint32_t reserved2;
+} asset_font_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint16_t list_length;
+    uint8_t type;
+    uint8_t reserved;
+    uint32_t unicode_list_off;
+    uint32_t glyph_id_ofs_off;
+} asset_font_cmap_t;
+
+_Static_assert(sizeof(asset_pack_hdr_t) == 32, "pack header layout");
+_Static_assert(sizeof(asset_entry_t) == 20, "index entry layout");
+_Static_assert(sizeof(asset_font_hdr_t) == 32, "font header layout");
+_Static_assert(sizeof(asset_font_cmap_t) == 20, "font cmap layout");
+_Static_assert(sizeof(lv_font_fmt_txt_glyph_dsc_t) == 8, "glyph dsc must match packed layout (LV_FONT_FMT_TXT_LARGE=0)");
+
+/** 已建立的字体，同名字体只建立一次 */
+typedef struct asset_font {
+    struct asset_font *next;
+    const char *name;                   // 指向映射区名称表
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    lv_font_fmt_txt_glyph_cache_t cache;
+    lv_font_fmt_txt_cmap_t cmaps[];
+} asset_font_t;
+
+static const uint8_t *s_base = NULL;
+static const asset_pack_hdr_t *s_hdr = NULL;
+static const asset_entry_t *s_index = NULL;
+static esp_partition_mmap_handle_t s_mmap_handle;
+static asset_font_t *s_fonts = NULL;
+static SemaphoreHandle_t s_font_lock = NULL;
+
+static uint32_t name_hash(const char *name)
+{
+    // FNV-1a，与 tools/asset_pack.py 一致
+    uint32_t h = 2166136261u;
+    while (*name) {
+        h ^= (uint8_t)*name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+esp_err_t assets_init(void)
+{
+    if (s_base) {
+        return ESP_OK;
+    }
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           ESP_PARTITION_SUBTYPE_ANY,
+                                                           ASSETS_PARTITION_LABEL);
+    if (!part) {
+        ESP_LOGW(TAG, "No \"%s\" partition", ASSETS_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // 先读头部确定资源包大小，只映射实际使用的部分
+    asset_pack_hdr_t hdr;
+    esp_err_t ret = esp_partition_read(part, 0, &hdr, sizeof(hdr));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (memcmp(hdr.magic, ASSETS_MAGIC, 4) != 0 || hdr.version != ASSETS_VERSION) {
+        ESP_LOGW(TAG, "Partition \"%s\" holds no asset pack", ASSETS_PARTITION_LABEL);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (hdr.total_size > part->size ||
+        sizeof(hdr) + (size_t)hdr.count * sizeof(asset_entry_t) > hdr.total_size) {
+        ESP_LOGE(TAG, "Asset pack size %lu invalid", (unsigned long)hdr.total_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const void *ptr;
+    ret = esp_partition_mmap(part, 0, hdr.total_size, ESP_PARTITION_MMAP_DATA, &ptr, &s_mmap_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "mmap failed (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+
+    const uint8_t *base = ptr;
+    const asset_entry_t *index = (const asset_entry_t *)(base + sizeof(asset_pack_hdr_t));
+
+    // 校验索引和名称表，之后查找时不再做边界检查
+    size_t index_len = (size_t)hdr.count * sizeof(asset_entry_t);
+    size_t names_off = sizeof(hdr) + index_len;
+    bool valid = names_off + hdr.names_size <= hdr.total_size &&
+                 esp_rom_crc32_le(0, (const uint8_t *)index, index_len + hdr.names_size) == hdr.index_crc;
+    for (uint16_t i = 0; valid && i < hdr.count; i++) {
+        valid = index[i].name_off >= names_off &&
+                index[i].name_off < names_off + hdr.names_size &&
+                index[i].data_off + index[i].size <= hdr.total_size &&
+                (i == 0 || index[i - 1].hash <= index[i].hash);
+    }
+    if (!valid || (hdr.names_size && base[names_off + hdr.names_size - 1] != '\0')) {
+        ESP_LOGE(TAG, "Asset index corrupted");
+        esp_partition_munmap(s_mmap_handle);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    s_base = base;
+    s_hdr = (const asset_pack_hdr_t *)base;
+    s_index = index;
+    s_font_lock = xSemaphoreCreateMutex();
+
+    ESP_LOGI(TAG, "Mapped %u assets, %lu bytes at %p",
+             hdr.count, (unsigned long)hdr.total_size, ptr);
+    return ESP_OK;
+}
+
+static const asset_entry_t *find_entry(const char *name)
+{
+    if (!s_base || !name) {
+        return NULL;
+    }
+
+    uint32_t h = name_hash(name);
+    int lo = 0, hi = (int)s_hdr->count - 1;
+
+    // 二分找到任意一个哈希相同的条目，再向两侧比较名称处理冲突
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        uint32_t mh = s_index[mid].hash;
+        if (mh < h) {
+            lo = mid + 1;
+        } else if (mh > h) {
+            hi = mid - 1;
+        } else {
+            int i = mid;
+            while (i > 0 && s_index[i - 1].hash == h) {
+                i--;
+            }
+            for (; i < s_hdr->count && s_index[i].hash == h; i++) {
+                if (strcmp((const char *)s_base + s_index[i].name_off, name) == 0) {
+                    return &s_index[i];
+                }
+            }
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t assets_find(const char *name, const void **data, size_t *size, asset_type_t *type)
+{
+    const asset_entry_t *e = find_entry(name);
+    if (!e) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    if (data) {
+        *data = s_base + e->data_off;
+    }
+    if (size) {
+        *size = e->size;
+    }
+    if (type) {
+        *type = (asset_type_t)e->type;
+    }
+    return ESP_OK;
+}
+
+esp_err_t assets_get_img(const char *name, lv_img_dsc_t *dsc)
+{
+    const void *data;
+    size_t size;
+    asset_type_t type;
+
+    esp_err_t ret = assets_find(name, &data, &size, &type);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (type != ASSET_TYPE_IMG || size < sizeof(lv_img_header_t)) {
+        ESP_LOGE(TAG, "%s is not an image", name);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(dsc, 0, sizeof(*dsc));
+    memcpy(&dsc->header, data, sizeof(lv_img_header_t));
+    dsc->data = (const uint8_t *)data + sizeof(lv_img_header_t);
+    dsc->data_size = size - sizeof(lv_img_header_t);
+    return ESP_OK;
+}
+
+static asset_font_t *build_font(const char *name, const uint8_t *data, size_t size)
+{
+    const asset_font_hdr_t *fh = (const asset_font_hdr_t *)data;
+
+    if (size < sizeof(*fh) || memcmp(fh->magic, ASSETS_FONT_MAGIC, 4) != 0 ||
+        fh->cmap_off + (size_t)fh->cmap_num * sizeof(asset_font_cmap_t) > size ||
+        fh->glyph_dsc_off + (size_t)fh->glyph_count * sizeof(lv_font_fmt_txt_glyph_dsc_t) > size ||
+        fh->bitmap_off > size) {
+        ESP_LOGE(TAG, "Font %s is corrupted", name);
+        return NULL;
+    }
+
+    asset_font_t *af = calloc(1, sizeof(*af) + fh->cmap_num * sizeof(lv_font_fmt_txt_cmap_t));
+    if (!af) {
+        return NULL;
+    }
+
+    const asset_font_cmap_t *src = (const asset_font_cmap_t *)(data + fh->cmap_off);
+    for (int i = 0; i < fh->cmap_num; i++) {
+        lv_font_fmt_txt_cmap_t *c = &af->cmaps[i];
+        c->range_start = src[i].range_start;
+        c->range_length = src[i].range_length;
+        c->glyph_id_start = src[i].glyph_id_start;
+        c->list_length = src[i].list_length;
+        c->type = (lv_font_fmt_txt_cmap_type_t)src[i].type;
+        c->unicode_list = src[i].unicode_list_off ?
+                          (const uint16_t *)(data + src[i].unicode_list_off) : NULL;
+        c->glyph_id_ofs_list = src[i].glyph_id_ofs_off ?
+                               (const void *)(data + src[i].glyph_id_ofs_off) : NULL;
+    }
+
+    af->name = name;
+    af->dsc.glyph_bitmap = data + fh->bitmap_off;
+    af->dsc.glyph_dsc = (const lv_font_fmt_txt_glyph_dsc_t *)(data + fh->glyph_dsc_off);
+    af->dsc.cmaps = af->cmaps;
+    af->dsc.kern_dsc = NULL;
+    af->dsc.kern_scale = 0;
+    af->dsc.cmap_num = fh->cmap_num;
+    af->dsc.bpp = fh->bpp;
+    af->dsc.kern_classes = 0;
+    af->dsc.bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+    af->dsc.cache = &af->cache;
+
+    af->font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    af->font.get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    af->font.line_height = fh->line_height;
+    af->font.base_line = fh->base_line;
+    af->font.subpx = LV_FONT_SUBPX_NONE;
+    af->font.underline_position = fh->underline_position;
+    af->font.underline_thickness = fh->underline_thickness;
+    af->font.dsc = &af->dsc;
+    return af;
+}
+
+const lv_font_t *assets_get_font(const char *name)
+{
+    const asset_entry_t *e = find_entry(name);
+    if (!e) {
+        ESP_LOGW(TAG, "Font %s not found", name ? name : "(null)");
+        return NULL;
+    }
+    if (e->type != ASSET_TYPE_FONT) {
+        ESP_LOGE(TAG, "%s is not a font", name);
+        return NULL;
+    }
+
+    const char *stored_name = (const char *)s_base + e->name_off;
+    asset_font_t *af;
+
+    xSemaphoreTake(s_font_lock, portMAX_DELAY);
+    for (af = s_fonts; af; af = af->next) {
+        if (af->name == stored_name) {
+            break;
+        }
+    }
+    if (!af) {
+        af = build_font(stored_name, s_base + e->data_off, e->size);
+        if (af) {
+            af->next = s_fonts;
+            s_fonts = af;
+        }
+    }
+    xSemaphoreGive(s_font_lock);
+
+    return af ? &af->font : NULL;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file assets.h
+ * @brief 只读资源分区
+ *
+ * 字体、图片、铃声等只读资源由 tools/asset_pack.py 打包后烧录到 "assets" 分区，
+ * 启动时通过 esp_partition_mmap 映射到地址空间，经 flash cache 原地访问：
+ * - 不经过文件系统和 stdio 缓冲，也不复制到 RAM
+ * - 按名称的 FNV-1a 哈希在有序索引中二分查找
+ * - 图片/字体适配器直接返回指向映射区的 LVGL 描述符
+ *
+ * 资源包格式（小端）：
+ *   头部 32 字节：魔数 "AST1"、版本(2)、条目数(2)、索引CRC32(4)、总长度(4)、
+ *         名称表长度(4)、保留(12)；CRC 覆盖索引和名称表
+ *   索引：每条 20 字节，按哈希排序：哈希(4)、名称偏移(4)、数据偏移(4)、长度(4)、类型(1)、保留(3)
+ *   名称表：以'\0'结尾的字符串
+ *   数据：每项 4 字节对齐
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#define ASSETS_PARTITION_LABEL  "assets"
+#define ASSETS_NAME_MAX         64
+
+/** 资源类型 */
+typedef enum {
+    ASSET_TYPE_RAW  = 0,    // 原始数据（如 BMF 铃声）
+    ASSET_TYPE_IMG  = 1,    // LVGL 图片：lv_img_header_t(4) + 像素数据
+    ASSET_TYPE_FONT = 2,    // 由 lv_font_conv 二进制字体转换的可原地使用格式
+} asset_type_t;
+
+/**
+ * 映射资源分区
+ * 分区不存在或内容无效时返回错误，之后的查找全部返回 ESP_ERR_NOT_FOUND
+ * @return esp_err_t 操作结果
+ */
+esp_err_t assets_init(void);
+
+/**
+ * 按名称查找资源
+ * @param name 名称（打包时的相对路径，不含扩展名，如 "img/logo"）
+ * @param data 输出指向映射区的数据指针
+ * @param size 输出数据长度，可为NULL
+ * @param type 输出类型，可为NULL
+ * @return esp_err_t 未找到返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t assets_find(const char *name, const void **data, size_t *size, asset_type_t *type);
+
+/**
+ * 获取图片描述符，像素数据指向映射区
+ * @param name 图片名称
+ * @param dsc 输出描述符，由调用方保存（需在图片使用期间保持有效）
+ * @return esp_err_t 操作结果
+ */
+esp_err_t assets_get_img(const char *name, lv_img_dsc_t *dsc);
+
+/**
+ * 获取字体
+ * 首次调用时在 RAM 中建立少量描述结构（字形表、位图指向映射区），之后返回同一对象
+ * @param name 字体名称
+ * @return const lv_font_t* 失败返回 NULL
+ */
+const lv_font_t *assets_get_font(const char *name);
@@ -0,0 +1,383 @@
+/**
+ * @file backlight.c
+ * @brief 背光控制器实现
+ *
+ * 调用方只在 s_mux 保护下记录请求并通知背光任务；计算目标亮度、启动渐变和熄屏后的休眠都在背光任务中进行。
+ * 渐变结束中断只记录结束时的占空比并通知任务，任务按占空比判断是否为当前这次渐变：
+ * 被打断的渐变即使回调也不会被当作完成。完成中断丢失时在计划结束时间后 BACKLIGHT_FADE_SLACK_MS 按完成处理。
+ */
+
+#include "backlight.h"
+#include <stdlib.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "jlc_lcd.h"
+#include "settings.h"
+#include "sys_tz.h"
+#include "timesync.h"
+
+static const char *TAG = "backlight";
+
+#define BL_TASK_STACK       2560
+#define BL_TASK_PRIO        3
+
+/* 任务通知位 */
+#define NOTIFY_REQUEST      (1 << 0)    // 亮度或亮灭变化
+#define NOTIFY_CONFIG       (1 << 1)    // 设置项或环境光数据源变化
+#define NOTIFY_FADE_DONE    (1 << 2)    // 渐变结束中断
+
+ESP_EVENT_DEFINE_BASE(BACKLIGHT_EVENT);
+
+static TaskHandle_t s_task = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/* 以下由 s_mux 保护 */
+static int s_level = 100;
+static bool s_on = false;
+static bool s_pending = false;          // 有尚未应用的请求
+static int s_req_fade_ms = 0;           // 待应用请求的渐变时间
+static backlight_ambient_fn_t s_ambient_fn = NULL;
+static void *s_ambient_arg = NULL;
+static backlight_stats_t s_stats = {.level = 100, .ambient = -1};
+
+/* 以下只在背光任务中访问 */
+static int s_night_start;
+static int s_night_end;
+static int s_night_level;
+static bool s_night = false;
+static int s_ambient = -1;              // 参与计算的环境光，变化超过回差才更新
+static int s_ambient_filt = -1;         // 滤波值（×16）
+static int s_target = -1;               // 最近一次渐变的目标，-1 表示需要重新应用
+static bool s_fading = false;           // 渐变进行中（尚未确认完成）
+static uint32_t s_fade_duty;            // 进行中渐变的目标占空比
+static int s_fade_ms;                   // 进行中渐变的计划时间
+static int64_t s_fade_start_us;
+static bool s_asleep = false;           // 液晶屏休眠、LVGL 暂停中
+
+static volatile uint32_t s_isr_duty;    // 渐变结束中断记录的占空比
+
+static void load_config(void)
+{
+    bsp_display_brightness_curve((lcd_bl_curve_t)settings_get_int(SETTING_BL_CURVE),
+                                 (uint32_t)settings_get_int(SETTING_BL_MIN_DUTY));
+    s_night_start = settings_get_int(SETTING_BL_NIGHT_START);
+    s_night_end = settings_get_int(SETTING_BL_NIGHT_END);
+    s_night_level = settings_get_int(SETTING_BL_NIGHT_LEVEL);
+    s_target = -1; // 曲线可能变化，同一百分比对应的占空比不同
+}
+
+// 本地时间是否在夜间时段，时段可以跨越午夜
+static bool night_now(void)
+{
+    if (s_night_start == s_night_end || !timesync_is_valid()) {
+        return false;
+    }
+    struct tm tm_now;
+    sys_tz_localtime(time(NULL), &tm_now);
+    int h = tm_now.tm_hour;
+    if (s_night_start < s_night_end) {
+        return h >= s_night_start && h < s_night_end;
+    }
+    return h >= s_night_start || h < s_night_end;
+}
+
+// 读取环境光并一阶滤波，参与计算的值只在变化超过回差时更新，避免亮度来回跳动
+static int ambient_now(void)
+{
+    taskENTER_CRITICAL(&s_mux);
+    backlight_ambient_fn_t fn = s_ambient_fn;
+    void *arg = s_ambient_arg;
+    taskEXIT_CRITICAL(&s_mux);
+
+    int raw = fn ? fn(arg) : -1;
+    if (raw < 0) {
+        s_ambient_filt = -1;
+        return -1;
+    }
+    if (raw > 100) {
+        raw = 100;
+    }
+    if (s_ambient_filt < 0) {
+        s_ambient_filt = raw * 16;
+    } else {
+        s_ambient_filt += (raw * 16 - s_ambient_filt) / 4;
+    }
+    int filt = (s_ambient_filt + 8) / 16;
+    if (s_ambient < 0 || abs(filt - s_ambient) >= BACKLIGHT_AMBIENT_HYST || (filt != s_ambient && (filt == 0 || filt == 100))) {
+        return filt;
+    }
+    return s_ambient;
+}
+
+// 更新夜间时段和环境光，返回是否有变化
+static bool evaluate(void)
+{
+    bool night = night_now();
+    int ambient = ambient_now();
+    bool changed = night != s_night || ambient != s_ambient;
+    s_night = night;
+    s_ambient = ambient;
+    return changed;
+}
+
+static int effective_level(int level)
+{
+    if (s_ambient >= 0) {
+        level = level * (BACKLIGHT_AMBIENT_FLOOR + (100 - BACKLIGHT_AMBIENT_FLOOR) * s_ambient / 100) / 100;
+    }
+    if (s_night && level > s_night_level) {
+        level = s_night_level;
+    }
+    return level < 1 ? 1 : level;
+}
+
+// 渐变结束：发布完成事件，熄屏渐变结束后让液晶屏休眠、暂停 LVGL
+static void fade_done(int64_t now, uint32_t duty)
+{
+    backlight_fade_done_t done = {
+        .target = s_target,
+        .planned_ms = s_fading ? s_fade_ms : 0,
+        .elapsed_ms = s_fading ? (uint32_t)((now - s_fade_start_us) / 1000) : 0,
+    };
+    s_fading = false;
+    ESP_LOGI(TAG, "%lld ms: fade to %d%% (duty %lu) done, %lu/%lu ms", (long long)(now / 1000), done.target,
+             (unsigned long)duty, (unsigned long)done.elapsed_ms, (unsigned long)done.planned_ms);
+    esp_event_post(BACKLIGHT_EVENT, BACKLIGHT_EVENT_FADE_DONE, &done, sizeof(done), pdMS_TO_TICKS(100));
+
+    taskENTER_CRITICAL(&s_mux);
+    bool on = s_on;
+    s_stats.completed++;
+    taskEXIT_CRITICAL(&s_mux);
+
+    if (!on && s_target == 0 && !s_asleep) {
+        s_asleep = bsp_display_sleep(true) == ESP_OK;
+        ESP_LOGI(TAG, "%lld ms: panel sleep%s", (long long)(esp_timer_get_time() / 1000), s_asleep ? "" : " failed");
+        if (s_asleep) {
+            esp_event_post(BACKLIGHT_EVENT, BACKLIGHT_EVENT_SLEEP, NULL, 0, pdMS_TO_TICKS(100));
+        }
+        taskENTER_CRITICAL(&s_mux);
+        s_stats.asleep = s_asleep;
+        taskEXIT_CRITICAL(&s_mux);
+    }
+}
+
+// 中断中执行，只记录占空比并通知背光任务
+static bool fade_end_isr(uint32_t duty, void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    s_isr_duty = duty;
+    xTaskNotifyFromISR(s_task, NOTIFY_FADE_DONE, eSetBits, &woken);
+    return woken == pdTRUE;
+}
+
+// 按最新的请求启动渐变，fade_ms 为 0 时使用自动调节的渐变时间
+static void apply(int64_t now)
+{
+    taskENTER_CRITICAL(&s_mux);
+    bool on = s_on;
+    int level = s_level;
+    int fade_ms = s_req_fade_ms ? s_req_fade_ms : BACKLIGHT_AUTO_FADE_MS;
+    s_pending = false;
+    s_req_fade_ms = 0;
+    taskEXIT_CRITICAL(&s_mux);
+
+    int target = on ? effective_level(level) : 0;
+    if (target == s_target) {
+        taskENTER_CRITICAL(&s_mux);
+        s_stats.unchanged++;
+        taskEXIT_CRITICAL(&s_mux);
+        return;
+    }
+
+    // 休眠中亮屏：先唤醒液晶屏、恢复 LVGL，再渐亮
+    if (target > 0 && s_asleep) {
+        bsp_display_sleep(false);
+        s_asleep = false;
+        ESP_LOGI(TAG, "%lld ms: panel wake", (long long)(esp_timer_get_time() / 1000));
+        esp_event_post(BACKLIGHT_EVENT, BACKLIGHT_EVENT_WAKE, NULL, 0, pdMS_TO_TICKS(100));
+        now = esp_timer_get_time(); // 唤醒需要等待驱动芯片退出睡眠
+    }
+
+    bool retarget = s_fading;
+    uint32_t duty = bsp_display_brightness_duty(target);
+    s_target = target;
+    if (!retarget && bsp_display_brightness_get_duty() == duty) {
+        fade_done(now, duty); // 已在目标亮度，不启动渐变
+        return;
+    }
+    ESP_LOGI(TAG, "%lld ms: fade to %d%% over %d ms%s (level %d, night %d, ambient %d)", (long long)(now / 1000),
+             target, fade_ms, retarget ? ", retarget" : "", level, s_night, s_ambient);
+    if (bsp_display_brightness_fade(target, fade_ms) != ESP_OK) {
+        s_target = -1; // 下次请求时重试
+        s_fading = false;
+        return;
+    }
+    s_fading = true;
+    s_fade_duty = duty;
+    s_fade_ms = fade_ms;
+    s_fade_start_us = now;
+
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.fades++;
+    if (retarget) {
+        s_stats.retargets++;
+    }
+    s_stats.target = target;
+    s_stats.night = s_night;
+    s_stats.ambient = s_ambient;
+    s_stats.asleep = s_asleep;
+    taskEXIT_CRITICAL(&s_mux);
+}
+
+static void backlight_task(void *arg)
+{
+    int64_t apply_at = -1;      // 待应用的时刻，-1 表示没有
+    int64_t next_eval = 0;
+
+    load_config();
+    for (;;) {
+        int64_t now = esp_timer_get_time();
+        taskENTER_CRITICAL(&s_mux);
+        bool on = s_on;
+        taskEXIT_CRITICAL(&s_mux);
+
+        int64_t deadline = on ? next_eval : INT64_MAX;
+        if (apply_at >= 0 && apply_at < deadline) {
+            deadline = apply_at;
+        }
+        int64_t fade_timeout = s_fade_start_us + (s_fade_ms + BACKLIGHT_FADE_SLACK_MS) * 1000LL;
+        if (s_fading && fade_timeout < deadline) {
+            deadline = fade_timeout;
+        }
+        TickType_t wait = deadline == INT64_MAX ? portMAX_DELAY
+                        : deadline <= now       ? 0
+                                                : pdMS_TO_TICKS((deadline - now) / 1000) + 1;
+
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, wait);
+        now = esp_timer_get_time();
+        taskENTER_CRITICAL(&s_mux);
+        on = s_on;
+        taskEXIT_CRITICAL(&s_mux);
+
+        if (s_fading && (bits & NOTIFY_FADE_DONE) && s_isr_duty == s_fade_duty) {
+            fade_done(now, s_isr_duty);
+        } else if (s_fading && now >= s_fade_start_us + (s_fade_ms + BACKLIGHT_FADE_SLACK_MS) * 1000LL) {
+            ESP_LOGW(TAG, "no fade end interrupt, duty %lu", (unsigned long)bsp_display_brightness_get_duty());
+            taskENTER_CRITICAL(&s_mux);
+            s_stats.timeouts++;
+            taskEXIT_CRITICAL(&s_mux);
+            fade_done(now, s_fade_duty);
+        }
+        bits &= ~NOTIFY_FADE_DONE;
+        if (bits & NOTIFY_CONFIG) {
+            load_config();
+            apply_at = now;
+        }
+        if ((bits & NOTIFY_REQUEST) && apply_at < 0) {
+            apply_at = now + BACKLIGHT_COALESCE_MS * 1000LL;
+        }
+        // 请求到达时也重新检查，亮屏时直接渐变到夜间/环境光调节后的亮度
+        if (on && (bits || now >= next_eval)) {
+            next_eval = now + BACKLIGHT_EVAL_MS * 1000LL;
+            if (evaluate() && apply_at < 0) {
+                apply_at = now;
+            }
+        }
+        if (apply_at >= 0 && now >= apply_at) {
+            apply_at = -1;
+            apply(now);
+        }
+    }
+}
+
+static void request(int fade_ms)
+{
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.requests++;
+    if (s_pending) {
+        s_stats.coalesced++;
+    }
+    s_pending = true;
+    s_req_fade_ms = fade_ms;
+    taskEXIT_CRITICAL(&s_mux);
+    if (s_task) {
+        xTaskNotify(s_task, NOTIFY_REQUEST, eSetBits);
+    }
+}
+
+static void config_changed_cb(setting_id_t id, void *arg)
+{
+    switch (id) {
+    case SETTING_BL_CURVE:
+    case SETTING_BL_MIN_DUTY:
+    case SETTING_BL_NIGHT_START:
+    case SETTING_BL_NIGHT_END:
+    case SETTING_BL_NIGHT_LEVEL:
+        xTaskNotify(s_task, NOTIFY_CONFIG, eSetBits);
+        break;
+    default:
+        break;
+    }
+}
+
+esp_err_t backlight_init(void)
+{
+    if (s_task) {
+        return ESP_OK;
+    }
+    if (xTaskCreate(backlight_task, "backlight", BL_TASK_STACK, NULL, BL_TASK_PRIO, &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    bsp_display_brightness_fade_cb(fade_end_isr, NULL);
+    // 只占一个订阅位，在回调中筛选 SETTING_BL_*
+    esp_err_t err = settings_subscribe(SETTING_ANY, config_changed_cb, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    xTaskNotify(s_task, NOTIFY_REQUEST, eSetBits); // 应用初始化前记录的请求
+    return ESP_OK;
+}
+
+void backlight_set_level(int percent)
+{
+    if (percent < 1) {
+        percent = 1;
+    } else if (percent > 100) {
+        percent = 100;
+    }
+    taskENTER_CRITICAL(&s_mux);
+    s_level = percent;
+    s_stats.level = percent;
+    taskEXIT_CRITICAL(&s_mux);
+    request(settings_get_int(SETTING_FADE_MS));
+}
+
+void backlight_set_screen_on(bool on)
+{
+    taskENTER_CRITICAL(&s_mux);
+    s_on = on;
+    taskEXIT_CRITICAL(&s_mux);
+    request(on ? settings_get_int(SETTING_FADE_MS) : LCD_FADE_TIME_MS);
+}
+
+void backlight_set_ambient_source(backlight_ambient_fn_t fn, void *arg)
+{
+    taskENTER_CRITICAL(&s_mux);
+    s_ambient_fn = fn;
+    s_ambient_arg = arg;
+    taskEXIT_CRITICAL(&s_mux);
+    if (s_task) {
+        xTaskNotify(s_task, NOTIFY_CONFIG, eSetBits);
+    }
+}
+
+void backlight_get_stats(backlight_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file backlight.h
+ * @brief 背光控制器
+ *
+ * 在用户设定亮度的基础上自动调节背光：
+ * - 亮度百分比按设置的曲线（默认 CIE 1931）换算为占空比，并保证不低于最低占空比，见 jlc_lcd.h
+ * - 夜间时段（本地时间，来自 sys_tz / timesync，未对时不生效）亮度不超过夜间上限
+ * - 注册环境光数据源后按环境光缩放，最暗时为设定亮度的 BACKLIGHT_AMBIENT_FLOOR%
+ *
+ * 亮度请求在后台任务中合并：BACKLIGHT_COALESCE_MS 内的多次请求只按最后一次渐变，目标不变时不重新启动渐变。
+ * 渐变进行中的新请求从当前亮度直接转向新目标，不等待也不跳变。
+ * 每次渐变结束发布 BACKLIGHT_EVENT_FADE_DONE（被新目标打断的不发布）；
+ * 熄屏渐变结束后依次让液晶屏休眠、暂停 LVGL（bsp_display_sleep），发布 BACKLIGHT_EVENT_SLEEP，
+ * 亮屏时先唤醒再渐亮。设置项 SETTING_BL_* 修改后立即生效。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#define BACKLIGHT_COALESCE_MS   50      // 合并窗口
+#define BACKLIGHT_EVAL_MS       5000    // 亮屏时检查夜间时段和环境光的周期
+#define BACKLIGHT_AUTO_FADE_MS  2000    // 自动调节的渐变时间
+#define BACKLIGHT_AMBIENT_FLOOR 30      // 环境光为 0 时的亮度（设定亮度的百分比）
+#define BACKLIGHT_AMBIENT_HYST  5       // 滤波后的环境光变化超过此值才调整
+#define BACKLIGHT_FADE_SLACK_MS 200     // 超过计划结束时间仍没有完成中断时按已完成处理
+
+ESP_EVENT_DECLARE_BASE(BACKLIGHT_EVENT);
+
+/** BACKLIGHT_EVENT 事件 */
+typedef enum {
+    BACKLIGHT_EVENT_FADE_DONE,      // 渐变结束，数据为 backlight_fade_done_t
+    BACKLIGHT_EVENT_SLEEP,          // 背光已关闭，液晶屏休眠、LVGL 暂停，无数据
+    BACKLIGHT_EVENT_WAKE,           // 液晶屏唤醒、LVGL 恢复，随后开始渐亮，无数据
+} backlight_event_t;
+
+/** BACKLIGHT_EVENT_FADE_DONE 数据 */
+typedef struct {
+    int target;                 // 目标亮度，0 为关闭
+    uint32_t planned_ms;        // 计划渐变时间
+    uint32_t elapsed_ms;        // 从启动到完成中断的实际时间
+} backlight_fade_done_t;
+
+/**
+ * 环境光数据源，在背光任务中调用，应尽快返回
+ * @param arg 注册时的参数
+ * @return int 环境光强度 0~100，小于 0 表示暂无数据
+ */
+typedef int (*backlight_ambient_fn_t)(void *arg);
+
+/** 统计信息 */
+typedef struct {
+    uint32_t requests;      // 亮度请求次数
+    uint32_t coalesced;     // 在合并窗口内被后续请求覆盖的次数
+    uint32_t retargets;     // 渐变进行中转向新目标的次数
+    uint32_t unchanged;     // 目标不变而跳过的次数
+    uint32_t fades;         // 启动的渐变次数
+    uint32_t completed;     // 完成的渐变次数
+    uint32_t timeouts;      // 没有等到完成中断的次数
+    int level;              // 用户设定亮度
+    int target;             // 当前目标亮度，0 为关闭
+    int ambient;            // 滤波后的环境光，-1 表示没有数据
+    bool night;             // 处于夜间时段
+    bool asleep;            // 液晶屏休眠中
+} backlight_stats_t;
+
+/**
+ * 初始化，创建背光任务（需在设置和背光 PWM 初始化之后调用）
+ * 初始为熄屏状态，调用 backlight_set_screen_on(true) 后打开
+ * @return esp_err_t 操作结果
+ */
+esp_err_t backlight_init(void);
+
+/**
+ * 设置用户亮度（不保存）
+ * @param percent 1~100
+ */
+void backlight_set_level(int percent);
+
+/**
+ * 亮屏/熄屏，熄屏期间不检查夜间时段和环境光
+ * @param on 是否亮屏
+ */
+void backlight_set_screen_on(bool on);
+
+/**
+ * 注册环境光数据源
+ * @param fn 数据源，NULL 表示取消
+ * @param arg 传给数据源的参数
+ */
+void backlight_set_ambient_source(backlight_ambient_fn_t fn, void *arg);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void backlight_get_stats(backlight_stats_t *stats);
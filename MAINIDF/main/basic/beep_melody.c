@@ -0,0 +1,321 @@
+/**
+ * 蜂鸣器旋律播放
+ * 从LittleFS流式读取BMF旋律文件并驱动蜂鸣器
+ * 每次只读取一条事件，文件内容不整体载入内存
+ * 文件格式见 beep_melody.h
+ */
+#include "beep_melody.h"
+#include "beepdrive.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MELODY_TASK_STACK   3072
+#define MELODY_TASK_PRIO    4
+#define MELODY_QUEUE_LEN    2
+#define MELODY_PATH_MAX     64
+#define MELODY_IOBUF_SIZE   128     // stdio缓冲区大小，决定单次读flash的字节数
+#define MELODY_LOOP_DEPTH   4       // 最大循环嵌套层数
+
+static const char *TAG = "MELODY";
+
+typedef struct {
+    bool stop;                      // true 表示停止命令
+    char path[MELODY_PATH_MAX];
+} melody_cmd_t;
+
+typedef struct {
+    long offset;                    // 循环起点（LOOP_START之后）的文件偏移
+    int16_t remaining;              // 剩余重复次数，-1表示尚未读取到LOOP_END
+} melody_loop_t;
+
+typedef struct {
+    uint8_t volume;
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint8_t sustain;
+    uint16_t release_ms;
+} melody_voice_t;
+
+static QueueHandle_t melody_queue = NULL;
+static volatile bool melody_playing = false;
+static char melody_iobuf[MELODY_IOBUF_SIZE];
+
+/*
+ * 等待指定时间，期间若收到新命令则提前返回true（当前播放被打断）
+ */
+static bool melody_wait(uint32_t ms)
+{
+    melody_cmd_t peek;
+    if (ms == 0) {
+        return uxQueueMessagesWaiting(melody_queue) > 0;
+    }
+    return xQueuePeek(melody_queue, &peek, pdMS_TO_TICKS(ms)) == pdTRUE;
+}
+
+static bool melody_read_u8(FILE *f, uint8_t *out)
+{
+    int c = fgetc(f);
+    if (c == EOF) {
+        return false;
+    }
+    *out = (uint8_t)c;
+    return true;
+}
+
+static bool melody_read_u16(FILE *f, uint16_t *out)
+{
+    uint8_t lo, hi;
+    if (!melody_read_u8(f, &lo) || !melody_read_u8(f, &hi)) {
+        return false;
+    }
+    *out = (uint16_t)(lo | (hi << 8));
+    return true;
+}
+
+/*
+ * 播放一个音符，freq为0表示休止，返回true表示被新命令打断
+ * 包络和时长由音调引擎的硬件渐变与定时器完成
+ */
+static bool melody_play_note(const melody_voice_t *v, uint16_t freq, uint16_t duration)
+{
+    if (duration == 0) {
+        return melody_wait(0);
+    }
+
+    const beep_tone_t tone = {
+        .freq = freq,
+        .volume = freq ? v->volume : 0,
+        .sustain = v->sustain,
+        .attack_ms = v->attack_ms,
+        .decay_ms = v->decay_ms,
+        .release_ms = v->release_ms,
+        .duration_ms = duration,
+    };
+    if (beep_tone_start(&tone) != ESP_OK) {
+        // 频率超出范围等错误按休止处理，保持节奏
+        beep_stop();
+        return melody_wait(duration);
+    }
+    // 新命令到达时melody_send()会调用beep_stop()结束等待
+    beep_tone_wait(portMAX_DELAY);
+    return melody_wait(0);
+}
+
+/*
+ * 流式播放一个BMF文件，返回true表示被新命令打断
+ */
+static bool melody_play_stream(FILE *f)
+{
+    uint8_t hdr[8];
+    if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr) || memcmp(hdr, "BMF1", 4) != 0) {
+        ESP_LOGE(TAG, "Invalid BMF header");
+        return false;
+    }
+    if (hdr[4] != 1) {
+        ESP_LOGE(TAG, "Unsupported BMF version: %d", hdr[4]);
+        return false;
+    }
+
+    melody_voice_t voice = {
+        .volume = hdr[5] > 100 ? 100 : hdr[5],
+        .sustain = 100,
+    };
+    melody_loop_t loops[MELODY_LOOP_DEPTH];
+    int depth = 0;
+    bool interrupted = false;
+
+    while (!interrupted) {
+        uint8_t op;
+        if (!melody_read_u8(f, &op) || op == BMF_OP_END) {
+            break;
+        }
+
+        switch (op) {
+        case BMF_OP_NOTE: {
+            uint16_t freq, ms;
+            if (!melody_read_u16(f, &freq) || !melody_read_u16(f, &ms)) {
+                goto truncated;
+            }
+            interrupted = melody_play_note(&voice, freq, ms);
+            break;
+        }
+        case BMF_OP_REST: {
+            uint16_t ms;
+            if (!melody_read_u16(f, &ms)) {
+                goto truncated;
+            }
+            interrupted = melody_play_note(&voice, 0, ms);
+            break;
+        }
+        case BMF_OP_VOLUME: {
+            uint8_t vol;
+            if (!melody_read_u8(f, &vol)) {
+                goto truncated;
+            }
+            voice.volume = vol > 100 ? 100 : vol;
+            break;
+        }
+        case BMF_OP_ENVELOPE: {
+            uint8_t env[4];
+            if (fread(env, 1, sizeof(env), f) != sizeof(env)) {
+                goto truncated;
+            }
+            voice.attack_ms = env[0] * 4;
+            voice.decay_ms = env[1] * 4;
+            voice.sustain = env[2] > 100 ? 100 : env[2];
+            voice.release_ms = env[3] * 4;
+            break;
+        }
+        case BMF_OP_LOOP_START:
+            if (depth >= MELODY_LOOP_DEPTH) {
+                ESP_LOGE(TAG, "Loop nesting too deep");
+                return false;
+            }
+            loops[depth].offset = ftell(f);
+            loops[depth].remaining = -1;
+            depth++;
+            break;
+        case BMF_OP_LOOP_END: {
+            uint8_t count;
+            if (!melody_read_u8(f, &count)) {
+                goto truncated;
+            }
+            if (depth == 0) {
+                ESP_LOGW(TAG, "LOOP_END without LOOP_START");
+                break;
+            }
+            melody_loop_t *lp = &loops[depth - 1];
+            if (ftell(f) - 2 == lp->offset) {
+                // 空循环体会让播放任务空转
+                ESP_LOGW(TAG, "Empty loop ignored");
+                depth--;
+                break;
+            }
+            if (lp->remaining < 0) {
+                lp->remaining = count;
+            }
+            if (count == 0 || lp->remaining > 0) {
+                if (count != 0) {
+                    lp->remaining--;
+                }
+                fseek(f, lp->offset, SEEK_SET);
+                interrupted = melody_wait(0);
+            } else {
+                depth--;
+            }
+            break;
+        }
+        default:
+            ESP_LOGE(TAG, "Unknown BMF opcode 0x%02x at %ld", op, ftell(f) - 1);
+            return false;
+        }
+    }
+    return interrupted;
+
+truncated:
+    ESP_LOGE(TAG, "Truncated BMF file");
+    return false;
+}
+
+static void melody_task(void *arg)
+{
+    melody_cmd_t cmd;
+
+    for (;;) {
+        if (xQueueReceive(melody_queue, &cmd, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (cmd.stop) {
+            continue;
+        }
+
+        FILE *f = fopen(cmd.path, "rb");
+        if (!f) {
+            ESP_LOGE(TAG, "Failed to open %s", cmd.path);
+            continue;
+        }
+        setvbuf(f, melody_iobuf, _IOFBF, sizeof(melody_iobuf));
+
+        ESP_LOGI(TAG, "Playing %s", cmd.path);
+        melody_playing = true;
+        bool interrupted = melody_play_stream(f);
+        melody_playing = false;
+        fclose(f);
+        beep_stop();
+
+        ESP_LOGD(TAG, "Finished %s%s", cmd.path, interrupted ? " (interrupted)" : "");
+    }
+}
+
+esp_err_t beep_melody_init(void)
+{
+    if (melody_queue) {
+        return ESP_OK;
+    }
+
+    melody_queue = xQueueCreate(MELODY_QUEUE_LEN, sizeof(melody_cmd_t));
+    if (!melody_queue) {
+        ESP_LOGE(TAG, "Failed to create melody queue");
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(melody_task, "melody_task", MELODY_TASK_STACK, NULL, MELODY_TASK_PRIO, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create melody task");
+        vQueueDelete(melody_queue);
+        melody_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t melody_send(const melody_cmd_t *cmd)
+{
+    if (!melody_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xQueueSend(melody_queue, cmd, pdMS_TO_TICKS(100)) != pdPASS) {
+        ESP_LOGE(TAG, "Melody queue full");
+        return ESP_ERR_TIMEOUT;
+    }
+    // 打断正在播放的音符，播放任务随后会读到新命令
+    if (melody_playing) {
+        beep_stop();
+    }
+    return ESP_OK;
+}
+
+esp_err_t beep_melody_play_file(const char *path)
+{
+    if (!path || !*path || strlen(path) >= MELODY_PATH_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    melody_cmd_t cmd = { .stop = false };
+    strncpy(cmd.path, path, sizeof(cmd.path) - 1);
+    return melody_send(&cmd);
+}
+
+esp_err_t beep_melody_play(const char *name)
+{
+    if (!name || !*name || strlen(name) > BEEP_MELODY_NAME_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    char path[MELODY_PATH_MAX];
+    snprintf(path, sizeof(path), BEEP_MELODY_DIR "/%s" BEEP_MELODY_EXT, name);
+    return beep_melody_play_file(path);
+}
+
+esp_err_t beep_melody_stop(void)
+{
+    melody_cmd_t cmd = { .stop = true };
+    return melody_send(&cmd);
+}
+
+bool beep_melody_is_playing(void)
+{
+    return melody_playing;
+}
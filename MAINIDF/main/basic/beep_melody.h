@@ -0,0 +1,116 @@
+/**
+ * @file beep_melody.h
+ * @brief 蜂鸣器旋律播放模块
+ *
+ * 从LittleFS的"/littlefs/sounds/"目录读取BMF格式的二进制旋律文件，
+ * 由后台任务逐条流式解析并驱动蜂鸣器，整个文件不会被读入内存。
+ * 铃声文件不链接进固件，闹钟等铃声不占用应用分区空间。
+ *
+ * BMF文件格式（多字节字段均为小端）：
+ *
+ *   文件头（8字节）：
+ *     'B' 'M' 'F' '1'  魔数
+ *     uint8_t  version       格式版本，当前为1
+ *     uint8_t  volume        初始音量 0-100
+ *     uint16_t reserved      保留，写0
+ *
+ *   事件流（每条以1字节操作码开头）：
+ *     0x00 END                              结束
+ *     0x10 NOTE     uint16 freq, uint16 ms  播放音符
+ *     0x20 REST     uint16 ms               休止
+ *     0x30 VOLUME   uint8 volume            设置音量 0-100
+ *     0x40 ENVELOPE uint8 attack_ms/4, uint8 decay_ms/4,
+ *                   uint8 sustain(0-100), uint8 release_ms/4
+ *                                           设置后续音符的包络
+ *     0x50 LOOP_START                       循环起点
+ *     0x51 LOOP_END uint8 count             回到循环起点，count为额外重复次数，0表示无限循环
+ *
+ * 主机端可使用 tools/rtttl2bmf.py 将RTTTL铃声转换为BMF文件。
+ *
+ * @note 使用前需要先调用beep_init()并挂载LittleFS。
+ */
+
+#ifndef _BEEP_MELODY_H_
+#define _BEEP_MELODY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BEEP_MELODY_DIR         "/littlefs/sounds"   // 铃声目录
+#define BEEP_MELODY_EXT         ".bmf"               // 铃声文件扩展名
+#define BEEP_MELODY_NAME_MAX    32                   // 铃声名称最大长度（不含扩展名）
+
+/* BMF操作码 */
+#define BMF_OP_END          0x00
+#define BMF_OP_NOTE         0x10
+#define BMF_OP_REST         0x20
+#define BMF_OP_VOLUME       0x30
+#define BMF_OP_ENVELOPE     0x40
+#define BMF_OP_LOOP_START   0x50
+#define BMF_OP_LOOP_END     0x51
+
+/**
+ * @brief 初始化旋律播放模块
+ *
+ * 创建播放任务和命令队列。
+ *
+ * @return esp_err_t
+ *         - ESP_OK: 初始化成功
+ *         - ESP_ERR_NO_MEM: 任务或队列创建失败
+ *
+ * @note 可以重复调用，不会产生副作用。
+ */
+esp_err_t beep_melody_init(void);
+
+/**
+ * @brief 按名称播放铃声
+ *
+ * 播放"/littlefs/sounds/<name>.bmf"，立即返回。
+ * 若当前已有铃声在播放，会被新铃声打断。
+ *
+ * @param name 铃声名称，例如"warn"、"alarm"
+ * @return esp_err_t
+ *         - ESP_OK: 播放请求已提交
+ *         - ESP_ERR_INVALID_STATE: 未初始化
+ *         - ESP_ERR_INVALID_ARG: 名称为空或过长
+ *         - ESP_ERR_TIMEOUT: 命令队列已满
+ */
+esp_err_t beep_melody_play(const char *name);
+
+/**
+ * @brief 按路径播放BMF文件
+ *
+ * 与beep_melody_play()相同，但直接指定文件完整路径。
+ *
+ * @param path BMF文件路径
+ * @return esp_err_t 同beep_melody_play()
+ */
+esp_err_t beep_melody_play_file(const char *path);
+
+/**
+ * @brief 停止当前播放
+ *
+ * @return esp_err_t
+ *         - ESP_OK: 停止请求已提交
+ *         - ESP_ERR_INVALID_STATE: 未初始化
+ *         - ESP_ERR_TIMEOUT: 命令队列已满
+ */
+esp_err_t beep_melody_stop(void);
+
+/**
+ * @brief 查询是否正在播放
+ *
+ * @return true 正在播放，false 空闲
+ */
+bool beep_melody_is_playing(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BEEP_MELODY_H_ */
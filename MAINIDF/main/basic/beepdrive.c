@@ -5,25 +5,200 @@
  * PWM驱动 最大占空比50%
  * 频率范围 200Hz - 2.7kHz
  * 闲置时置低电平
+ *
+ * 音调引擎：
+ * - 音量通过占空比控制，占空比按基波幅度 sin(pi*d) 反算，音量刻度近似线性
+ * - 起音/衰减/释放由LEDC硬件渐变完成，起止均有最短渐变，消除咔哒声
+ * - 各阶段切换由esp_timer按绝对时间调度（回调运行在esp_timer任务中，不在ISR中），
+ *   不受FreeRTOS tick(10ms)粒度影响，也不会累积误差
+ * - 低速模式下LEDC在PWM周期边界才应用新分频，发声中改频不会产生毛刺
  */
 #include "beepdrive.h"
 #include "driver/ledc.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <stdlib.h> // 添加malloc的头文件
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include <math.h>
+#include <string.h>
 
 #define BEEP_GPIO           42
 #define BEEP_LEDC_CHANNEL   LEDC_CHANNEL_1
-#define BEEP_LEDC_TIMER     LEDC_TIMER_0
+#define BEEP_LEDC_TIMER     LEDC_TIMER_1    // 背光占用TIMER_0，蜂鸣器改频不能影响背光
 #define BEEP_LEDC_MODE      LEDC_LOW_SPEED_MODE
-#define BEEP_LEDC_DUTY      2048            // 占空比 50% (4096的50%)
+#define BEEP_LEDC_RES       LEDC_TIMER_12_BIT
+#define BEEP_LEDC_PERIOD    4096            // 12位分辨率的满量程
+#define BEEP_LEDC_DUTY      2048            // 占空比 50% (4096的50%)，对应最大音量
 #define BEEP_LEDC_FREQ_MIN  200             // 最小频率 200Hz
 #define BEEP_LEDC_FREQ_MAX  2700            // 最大频率 2.7kHz
+#define BEEP_CLICK_FADE_MS  4               // 起音/停止的最短渐变时间
+#define BEEP_LOCK_TIMEOUT   pdMS_TO_TICKS(100)
+
+#define BEEP_EVT_DONE       BIT0
+
+typedef enum {
+    TONE_IDLE = 0,
+    TONE_ATTACK,
+    TONE_DECAY,
+    TONE_SUSTAIN,
+    TONE_RELEASE,
+} tone_phase_t;
+
+/* 当前音符的调度状态，所有时间点均相对start_us，单位ms */
+typedef struct {
+    beep_tone_t tone;
+    tone_phase_t phase;
+    int64_t start_us;
+    int64_t deadline_us;        // 当前阶段预定结束的绝对时间
+    uint32_t attack_end;
+    uint32_t decay_end;
+    uint32_t release_start;
+    uint32_t peak_duty;
+    uint32_t sustain_duty;
+    volatile uint32_t gen;      // 外部停止或重启定时器时加一，已在等锁的回调据此识别自己已过期
+} tone_state_t;
 
 static const char *TAG = "BEEP";
 static bool beep_initialized = false;
+static uint8_t beep_volume = 100;          // 当前音量 0-100
+
+static SemaphoreHandle_t beep_mutex = NULL;
+static EventGroupHandle_t beep_events = NULL;
+static esp_timer_handle_t tone_timer = NULL;
+static tone_state_t tone_state;
+static uint32_t cur_duty = 0;              // 最近一次设定的目标占空比
+static uint32_t cur_freq = 0;              // 当前定时器频率
+static beep_timing_stats_t timing_stats;
+
+/*
+ * 音量(0-100)转占空比
+ * 方波基波幅度与 sin(pi*d) 成正比，d=50%时最大
+ */
+static uint32_t volume_to_duty(uint8_t volume)
+{
+    if (volume == 0) {
+        return 0;
+    }
+    if (volume >= 100) {
+        return BEEP_LEDC_DUTY;
+    }
+    return (uint32_t)(BEEP_LEDC_PERIOD * asinf(volume / 100.0f) / (float)M_PI + 0.5f);
+}
+
+/* 以下apply函数需在持有beep_mutex时调用 */
+static esp_err_t beep_apply_duty(uint32_t duty, uint32_t fade_ms)
+{
+    esp_err_t ret;
+
+#if SOC_LEDC_SUPPORT_FADE_STOP
+    // 打断进行中的渐变，新渐变从当前实际占空比开始
+    ledc_fade_stop(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL);
+#endif
+
+    if (fade_ms == 0 || duty == ledc_get_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL)) {
+        ret = ledc_set_duty_and_update(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL, duty, 0);
+    } else {
+        ret = ledc_set_fade_time_and_start(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL, duty, fade_ms, LEDC_FADE_NO_WAIT);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set duty %lu: %s", (unsigned long)duty, esp_err_to_name(ret));
+        return ret;
+    }
+    cur_duty = duty;
+    return ESP_OK;
+}
+
+static esp_err_t beep_apply_freq(uint16_t freq)
+{
+    if (freq == cur_freq) {
+        return ESP_OK;
+    }
+    esp_err_t ret = ledc_set_freq(BEEP_LEDC_MODE, BEEP_LEDC_TIMER, freq);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ledc_set_freq failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    cur_freq = freq;
+    return ESP_OK;
+}
+
+static int64_t tone_phase_deadline(void)
+{
+    uint32_t ms;
+    switch (tone_state.phase) {
+    case TONE_ATTACK:  ms = tone_state.attack_end; break;
+    case TONE_DECAY:   ms = tone_state.decay_end; break;
+    case TONE_SUSTAIN: ms = tone_state.release_start; break;
+    case TONE_RELEASE: ms = tone_state.tone.duration_ms; break;
+    default:           return 0;
+    }
+    return tone_state.start_us + (int64_t)ms * 1000;
+}
+
+/* 进入下一阶段并设置对应的硬件渐变 */
+static void tone_next_phase(void)
+{
+    switch (tone_state.phase) {
+    case TONE_ATTACK:
+        tone_state.phase = TONE_DECAY;
+        beep_apply_duty(tone_state.sustain_duty, tone_state.decay_end - tone_state.attack_end);
+        break;
+    case TONE_DECAY:
+        tone_state.phase = TONE_SUSTAIN;
+        break;
+    case TONE_SUSTAIN:
+        tone_state.phase = TONE_RELEASE;
+        beep_apply_duty(0, tone_state.tone.duration_ms - tone_state.release_start);
+        break;
+    case TONE_RELEASE:
+    default:
+        tone_state.phase = TONE_IDLE;
+        timing_stats.tones++;
+        xEventGroupSetBits(beep_events, BEEP_EVT_DONE);
+        break;
+    }
+}
+
+/* 推进已到期的阶段，并为下一个到期时间启动定时器 */
+static void tone_run(int64_t now)
+{
+    while (tone_state.phase != TONE_IDLE) {
+        int64_t deadline = tone_phase_deadline();
+        if (deadline > now) {
+            tone_state.deadline_us = deadline;
+            esp_timer_start_once(tone_timer, deadline - now);
+            return;
+        }
+        tone_next_phase();
+    }
+}
+
+static void tone_timer_cb(void *arg)
+{
+    // 先记下代数再等锁：等锁期间 beep_stop() 或新音符重启了定时器时，本次回调属于旧音符，直接返回
+    uint32_t gen = tone_state.gen;
+    xSemaphoreTake(beep_mutex, portMAX_DELAY);
+    if (gen != tone_state.gen) {
+        xSemaphoreGive(beep_mutex);
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    int64_t late = now - tone_state.deadline_us;
+    timing_stats.transitions++;
+    timing_stats.total_late_us += late;
+    if (late > timing_stats.max_late_us) {
+        timing_stats.max_late_us = late;
+    }
+    ESP_LOGD(TAG, "tone %uHz phase %d at %lld us (+%lld us from start), late %lld us",
+             tone_state.tone.freq, tone_state.phase, now, now - tone_state.start_us, late);
+
+    tone_run(now);
+    xSemaphoreGive(beep_mutex);
+}
 
 esp_err_t beep_init(void)
 {
@@ -32,11 +207,33 @@ esp_err_t beep_init(void)
         return ESP_OK;
     }
 
+    if (!beep_mutex) {
+        beep_mutex = xSemaphoreCreateMutex();
+        beep_events = xEventGroupCreate();
+        if (!beep_mutex || !beep_events) {
+            ESP_LOGE(TAG, "Failed to create beep mutex/event group");
+            return ESP_ERR_NO_MEM;
+        }
+        xEventGroupSetBits(beep_events, BEEP_EVT_DONE);
+    }
+
+    if (!tone_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = tone_timer_cb,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "beep_tone",
+        };
+        esp_err_t ret = esp_timer_create(&timer_args, &tone_timer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "esp_timer_create failed: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
 
     ledc_timer_config_t ledc_timer = {
         .speed_mode       = BEEP_LEDC_MODE,
         .timer_num        = BEEP_LEDC_TIMER,
-        .duty_resolution  = LEDC_TIMER_12_BIT,
+        .duty_resolution  = BEEP_LEDC_RES,
         .freq_hz          = BEEP_LEDC_FREQ_MAX,
         .clk_cfg          = LEDC_AUTO_CLK,
     };
@@ -45,6 +242,7 @@ esp_err_t beep_init(void)
         ESP_LOGE(TAG, "ledc_timer_config failed: %s", esp_err_to_name(ret));
         return ret;
     }
+    cur_freq = BEEP_LEDC_FREQ_MAX;
 
     ledc_channel_config_t ledc_channel = {
         .speed_mode     = BEEP_LEDC_MODE,
@@ -61,165 +259,223 @@ esp_err_t beep_init(void)
         return ret;
     }
 
-    // 初始状态为停止
-    ret = ledc_set_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL, 0);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_set_duty failed: %s", esp_err_to_name(ret));
+    // 渐变功能与背光共用，已安装时返回ESP_ERR_INVALID_STATE
+    ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "ledc_fade_func_install failed: %s", esp_err_to_name(ret));
         return ret;
     }
-    ret = ledc_update_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL);
+
+    // 初始状态为停止
+    ret = ledc_set_duty_and_update(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL, 0, 0);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_update_duty failed: %s", esp_err_to_name(ret));
+        ESP_LOGE(TAG, "ledc_set_duty_and_update failed: %s", esp_err_to_name(ret));
         return ret;
     }
+    cur_duty = 0;
+    memset(&tone_state, 0, sizeof(tone_state));
 
     beep_initialized = true;
     ESP_LOGI(TAG, "Beep initialized on GPIO %d", BEEP_GPIO);
     return ESP_OK;
 }
 
-
-esp_err_t beep_set_freq(uint16_t freq)
+esp_err_t beep_tone_start(const beep_tone_t *tone)
 {
     if (!beep_initialized) {
-        ESP_LOGE(TAG, "Buzzer not initialized");
         return ESP_ERR_INVALID_STATE;
     }
+    if (!tone || tone->duration_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (tone->volume > 0 && (tone->freq < BEEP_LEDC_FREQ_MIN || tone->freq > BEEP_LEDC_FREQ_MAX)) {
+        ESP_LOGE(TAG, "Invalid frequency: %d Hz (range: %d-%d Hz)",
+                tone->freq, BEEP_LEDC_FREQ_MIN, BEEP_LEDC_FREQ_MAX);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (xSemaphoreTake(beep_mutex, BEEP_LOCK_TIMEOUT) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
 
-    if (!beep_initialized) {
-        ESP_LOGE(TAG, "Buzzer not initialized");
-        return ESP_ERR_INVALID_STATE;
+    esp_timer_stop(tone_timer);
+    tone_state.gen++;
+    xEventGroupClearBits(beep_events, BEEP_EVT_DONE);
+
+    tone_state_t *st = &tone_state;
+    st->tone = *tone;
+    if (st->tone.volume > 100) {
+        st->tone.volume = 100;
+    }
+    if (st->tone.sustain > 100) {
+        st->tone.sustain = 100;
     }
 
-    if (freq < BEEP_LEDC_FREQ_MIN || freq > BEEP_LEDC_FREQ_MAX) {
-        ESP_LOGE(TAG, "Invalid frequency: %d Hz (range: %d-%d Hz)", 
-                freq, BEEP_LEDC_FREQ_MIN, BEEP_LEDC_FREQ_MAX);
-        return ESP_ERR_INVALID_ARG;
+    uint32_t dur = st->tone.duration_ms;
+    uint32_t release = st->tone.release_ms;
+    uint32_t attack = st->tone.attack_ms;
+    // 从静音起音时至少保留最短渐变，避免咔哒声；发声中切换音符则保持连奏
+    if (cur_duty == 0 && attack < BEEP_CLICK_FADE_MS) {
+        attack = BEEP_CLICK_FADE_MS;
     }
-    
-    esp_err_t ret = ledc_set_freq(BEEP_LEDC_MODE, BEEP_LEDC_TIMER, freq);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_set_freq failed: %s", esp_err_to_name(ret));
-        return ret;
+    if (release < BEEP_CLICK_FADE_MS && dur >= 2 * BEEP_CLICK_FADE_MS) {
+        release = BEEP_CLICK_FADE_MS;
     }
-    
-    ret = ledc_set_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL, BEEP_LEDC_DUTY);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_set_duty failed: %s", esp_err_to_name(ret));
-        return ret;
+    if (release > dur) {
+        release = dur;
+    }
+    st->release_start = dur - release;
+    st->attack_end = attack < st->release_start ? attack : st->release_start;
+    st->decay_end = st->attack_end + st->tone.decay_ms;
+    if (st->decay_end > st->release_start) {
+        st->decay_end = st->release_start;
+    }
+
+    st->peak_duty = volume_to_duty(st->tone.volume);
+    // 没有衰减段时持续段保持峰值音量
+    st->sustain_duty = st->tone.decay_ms ? volume_to_duty(st->tone.volume * st->tone.sustain / 100) : st->peak_duty;
+
+    esp_err_t ret = ESP_OK;
+    if (st->tone.volume > 0) {
+        ret = beep_apply_freq(st->tone.freq);
+    }
+    if (ret == ESP_OK) {
+        st->start_us = esp_timer_get_time();
+        st->phase = TONE_ATTACK;
+        ret = beep_apply_duty(st->peak_duty, st->attack_end);
+        tone_run(st->start_us);
     }
-    
-    ret = ledc_update_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_update_duty failed: %s", esp_err_to_name(ret));
-        return ret;
+        st->phase = TONE_IDLE;
+        xEventGroupSetBits(beep_events, BEEP_EVT_DONE);
     }
-    
-    ESP_LOGD(TAG, "Beep frequency set to %d Hz", freq);
-    return ESP_OK;
+
+    xSemaphoreGive(beep_mutex);
+    ESP_LOGD(TAG, "Tone %dHz vol %d dur %lums (A%lu D%lu R%lu)", tone->freq, tone->volume,
+             (unsigned long)dur, (unsigned long)st->attack_end,
+             (unsigned long)(st->decay_end - st->attack_end), (unsigned long)release);
+    return ret;
 }
 
-esp_err_t beep_stop(void)
+esp_err_t beep_tone_wait(TickType_t timeout)
 {
     if (!beep_initialized) {
-        ESP_LOGE(TAG, "Buzzer not initialized");
         return ESP_ERR_INVALID_STATE;
     }
+    EventBits_t bits = xEventGroupWaitBits(beep_events, BEEP_EVT_DONE, pdFALSE, pdTRUE, timeout);
+    return (bits & BEEP_EVT_DONE) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
 
+esp_err_t beep_set_freq(uint16_t freq)
+{
     if (!beep_initialized) {
         ESP_LOGE(TAG, "Buzzer not initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
-    esp_err_t ret = ledc_set_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL, 0);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_set_duty failed: %s", esp_err_to_name(ret));
-        return ret;
+    if (freq < BEEP_LEDC_FREQ_MIN || freq > BEEP_LEDC_FREQ_MAX) {
+        ESP_LOGE(TAG, "Invalid frequency: %d Hz (range: %d-%d Hz)",
+                freq, BEEP_LEDC_FREQ_MIN, BEEP_LEDC_FREQ_MAX);
+        return ESP_ERR_INVALID_ARG;
     }
-    
-    ret = ledc_update_duty(BEEP_LEDC_MODE, BEEP_LEDC_CHANNEL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "ledc_update_duty failed: %s", esp_err_to_name(ret));
-        return ret;
+    if (xSemaphoreTake(beep_mutex, BEEP_LOCK_TIMEOUT) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
     }
-    
-    ESP_LOGD(TAG, "Beep stopped");
-    return ESP_OK;
+
+    // 持续发声，直到beep_stop()或下一个音符
+    esp_timer_stop(tone_timer);
+    tone_state.gen++;
+    tone_state.phase = TONE_IDLE;
+    xEventGroupSetBits(beep_events, BEEP_EVT_DONE);
+
+    esp_err_t ret = beep_apply_freq(freq);
+    if (ret == ESP_OK) {
+        ret = beep_apply_duty(volume_to_duty(beep_volume), cur_duty ? 0 : BEEP_CLICK_FADE_MS);
+    }
+    xSemaphoreGive(beep_mutex);
+
+    if (ret == ESP_OK) {
+        ESP_LOGD(TAG, "Beep frequency set to %d Hz", freq);
+    }
+    return ret;
 }
 
-static void beep_stop_async_task(void *arg)
+esp_err_t beep_set_volume(uint8_t volume)
 {
-    int delay_ms = *((int *)arg);
-    free(arg); // 释放分配的内存
-    
-    // 延时一段时间后停止蜂鸣器
-    vTaskDelay(pdMS_TO_TICKS(delay_ms));
-    
-    esp_err_t ret = beep_stop();
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "beep_stop failed in async task: %s", esp_err_to_name(ret));
+    if (volume > 100) {
+        volume = 100;
     }
-    
-    vTaskDelete(NULL);
+    beep_volume = volume;
+
+    // beep_set_freq()的持续发声立即应用新音量
+    if (beep_initialized && xSemaphoreTake(beep_mutex, BEEP_LOCK_TIMEOUT) == pdTRUE) {
+        if (tone_state.phase == TONE_IDLE && cur_duty > 0) {
+            beep_apply_duty(volume_to_duty(volume), BEEP_CLICK_FADE_MS);
+        }
+        xSemaphoreGive(beep_mutex);
+    }
+    ESP_LOGD(TAG, "Beep volume set to %d%%", volume);
+    return ESP_OK;
 }
 
-esp_err_t play_note(uint16_t freq, uint32_t duration_ms)
+esp_err_t beep_stop(void)
 {
     if (!beep_initialized) {
+        ESP_LOGE(TAG, "Buzzer not initialized");
         return ESP_ERR_INVALID_STATE;
     }
-
-    if (!beep_initialized) {
-        return ESP_ERR_INVALID_STATE;
+    if (xSemaphoreTake(beep_mutex, BEEP_LOCK_TIMEOUT) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
     }
 
-    esp_err_t ret = beep_set_freq(freq);
+    esp_timer_stop(tone_timer);
+    tone_state.gen++;
+    tone_state.phase = TONE_IDLE;
+    esp_err_t ret = beep_apply_duty(0, BEEP_CLICK_FADE_MS);
+    xEventGroupSetBits(beep_events, BEEP_EVT_DONE);
+    xSemaphoreGive(beep_mutex);
+
+    ESP_LOGD(TAG, "Beep stopped");
+    return ret;
+}
+
+esp_err_t play_note(uint16_t freq, uint32_t duration_ms)
+{
+    esp_err_t ret = play_note_async(freq, duration_ms);
     if (ret != ESP_OK) {
         return ret;
     }
-    
-    // 播放指定时长
-    vTaskDelay(pdMS_TO_TICKS(duration_ms));
-    
-    ret = beep_stop();
+
+    // 播放指定时长，多等一个tick以覆盖tick粒度
+    ret = beep_tone_wait(pdMS_TO_TICKS(duration_ms) + 2);
+    if (ret == ESP_ERR_TIMEOUT) {
+        ret = beep_stop();
+    }
     return ret;
 }
 
 esp_err_t play_note_async(uint16_t freq, uint32_t duration_ms)
 {
-    if (!beep_initialized) {
-        return ESP_ERR_INVALID_STATE;
-    }
+    const beep_tone_t tone = {
+        .freq = freq,
+        .volume = beep_volume,
+        .duration_ms = duration_ms,
+    };
 
-    if (!beep_initialized) {
-        return ESP_ERR_INVALID_STATE;
-    }
+    ESP_LOGD(TAG, "Playing note at %d Hz for %lu ms", freq, (unsigned long)duration_ms);
+    return beep_tone_start(&tone);
+}
 
-    esp_err_t ret = beep_set_freq(freq);
-    if (ret != ESP_OK) {
-        return ret;
+void beep_get_timing_stats(beep_timing_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    if (beep_mutex && xSemaphoreTake(beep_mutex, BEEP_LOCK_TIMEOUT) == pdTRUE) {
+        *stats = timing_stats;
+        xSemaphoreGive(beep_mutex);
+    } else {
+        memset(stats, 0, sizeof(*stats));
     }
-    
-    ESP_LOGD(TAG, "Playing note at %d Hz for %d ms", freq, duration_ms);
-    
-    // 创建一个任务在duration_ms后停止蜂鸣器
-    int *delay_arg = malloc(sizeof(int));
-    if (delay_arg == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for delay_arg");
-        beep_stop(); // 停止蜂鸣器
-        return ESP_ERR_NO_MEM;
-    }
-    *delay_arg = duration_ms;
-    
-    if (xTaskCreate(beep_stop_async_task, "beep_stop_async", 2048, delay_arg, 5, NULL) != pdPASS) {
-        free(delay_arg);
-        ESP_LOGE(TAG, "Failed to create async task");
-        beep_stop(); // 停止蜂鸣器
-        return ESP_ERR_NO_MEM;
-    }
-    
-    ESP_LOGD(TAG, "Async task created successfully");
-    return ESP_OK;
 }
 
 esp_err_t beep_deinit(void)
@@ -228,15 +484,11 @@ esp_err_t beep_deinit(void)
         return ESP_OK;
     }
 
-    if (!beep_initialized) {
-        return ESP_OK;
-    }
-
     // 停止蜂鸣器
     beep_stop();
-    
+
     beep_initialized = false;
     ESP_LOGI(TAG, "Beep deinitialized");
-    
+
     return ESP_OK;
 }
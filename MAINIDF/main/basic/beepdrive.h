@@ -4,6 +4,8 @@
  * 
  * 本驱动程序使用LEDC模块控制蜂鸣器发声，提供同步和异步播放功能。
  * 蜂鸣器连接到GPIO 42，支持频率范围200Hz-2700Hz，最大占空比50%。
+ * 音量通过占空比控制，起音/衰减/释放包络由LEDC硬件渐变完成，
+ * 包络阶段由esp_timer按绝对时间调度。
  * 
  * @note 在使用任何蜂鸣器功能前，必须先调用beep_init()进行初始化。
  * @note 本驱动程序是线程安全的，支持多任务环境下的并发访问。
@@ -14,11 +16,38 @@
 
 #include <stdint.h>
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief 音符参数
+ *
+ * 包络各段时长之和超过duration_ms时，依次缩短衰减段和起音段。
+ * decay_ms为0时sustain无效，持续段保持峰值音量。
+ */
+typedef struct {
+    uint16_t freq;          ///< 频率(Hz)，volume为0时忽略
+    uint8_t  volume;        ///< 峰值音量 0-100，0表示休止
+    uint8_t  sustain;       ///< 持续段音量，占峰值的百分比 0-100
+    uint16_t attack_ms;     ///< 起音时长
+    uint16_t decay_ms;      ///< 衰减时长
+    uint16_t release_ms;    ///< 释放时长（包含在duration_ms内）
+    uint32_t duration_ms;   ///< 音符总时长
+} beep_tone_t;
+
+/**
+ * @brief 音调引擎定时统计，用于验证调度精度
+ */
+typedef struct {
+    uint32_t tones;         ///< 已完成的音符数
+    uint32_t transitions;   ///< 定时器触发的阶段切换次数
+    int64_t  max_late_us;   ///< 阶段切换的最大延迟
+    int64_t  total_late_us; ///< 阶段切换的累计延迟
+} beep_timing_stats_t;
+
 /**
  * @brief 初始化蜂鸣器驱动
  * 
@@ -48,6 +77,18 @@ esp_err_t beep_init(void);
  */
 esp_err_t beep_set_freq(uint16_t freq);
 
+/**
+ * @brief 设置蜂鸣器音量
+ * 
+ * 音量通过缩放PWM占空比实现。对beep_set_freq()的持续发声立即生效，
+ * 对play_note()/play_note_async()在下一个音符生效。
+ * 
+ * @param volume 音量(0-100)，超出范围按100处理
+ * @return esp_err_t
+ *         - ESP_OK: 设置成功
+ */
+esp_err_t beep_set_volume(uint8_t volume);
+
 /**
  * @brief 停止蜂鸣器发声
  * 
@@ -91,13 +132,52 @@ esp_err_t play_note(uint16_t freq, uint32_t duration_ms);
  *         - ESP_ERR_INVALID_STATE: 未初始化
  *         - ESP_ERR_INVALID_ARG: 频率超出范围
  *         - ESP_ERR_TIMEOUT: 获取互斥锁超时
- *         - ESP_ERR_NO_MEM: 任务创建或内存分配失败
  *         - 其他: LEDC操作错误
  * 
  * @note 异步播放时，如果再次调用播放函数，会覆盖之前的播放。
+ * @note 到时停止由音调引擎的定时器完成，不会创建额外任务。
  */
 esp_err_t play_note_async(uint16_t freq, uint32_t duration_ms);
 
+/**
+ * @brief 开始播放一个带包络的音符(异步)
+ * 
+ * 立即返回，包络各阶段在后台按时间表执行。若上一个音符仍在发声，
+ * 新音符会从当前音量连奏过渡，不经过静音。
+ * 
+ * @param tone 音符参数
+ * @return esp_err_t
+ *         - ESP_OK: 开始播放
+ *         - ESP_ERR_INVALID_STATE: 未初始化
+ *         - ESP_ERR_INVALID_ARG: 参数为空、时长为0或频率超出范围
+ *         - ESP_ERR_TIMEOUT: 获取互斥锁超时
+ *         - 其他: LEDC操作错误
+ */
+esp_err_t beep_tone_start(const beep_tone_t *tone);
+
+/**
+ * @brief 等待当前音符播放结束
+ * 
+ * beep_stop()或新的beep_set_freq()也会结束等待。
+ * 
+ * @param timeout 最长等待时间(tick)
+ * @return esp_err_t
+ *         - ESP_OK: 已播放结束
+ *         - ESP_ERR_INVALID_STATE: 未初始化
+ *         - ESP_ERR_TIMEOUT: 超时
+ */
+esp_err_t beep_tone_wait(TickType_t timeout);
+
+/**
+ * @brief 获取音调引擎的定时统计
+ * 
+ * 阶段切换的实际时间与计划时间之差，配合DEBUG级别日志中的时间戳
+ * 可用于核对包络时序。
+ * 
+ * @param stats 输出统计数据
+ */
+void beep_get_timing_stats(beep_timing_stats_t *stats);
+
 /**
  * @brief 反初始化蜂鸣器驱动
  * 
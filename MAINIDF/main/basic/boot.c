@@ -0,0 +1,237 @@
+#include "boot.h"
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_bit_defs.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "BOOT";
+
+/*
+    启动编排
+    每个阶段一个任务，在事件组上等待依赖位，完成后置位自己的位
+    首帧位独立于阶段位，延后阶段额外依赖它
+*/
+
+#define BOOT_FIRST_FRAME_BIT    BIT(23)
+#define BOOT_STAGE_BITS(n)      ((n) >= 32 ? 0xFFFFFFFFu : (BIT(n) - 1))
+
+typedef struct {
+    int64_t start_us;       // 相对上电时间
+    int64_t end_us;
+    esp_err_t result;
+    BaseType_t core;        // 实际运行的核心
+} boot_stage_stat_t;
+
+static const boot_stage_t *s_stages = NULL;
+static size_t s_count = 0;
+static boot_stage_stat_t s_stats[BOOT_MAX_STAGES];
+static EventGroupHandle_t s_events = NULL;
+static uint32_t s_failed = 0;
+static size_t s_remaining = 0;
+static uint32_t s_progress_done = 0;
+static uint32_t s_progress_total = 0;
+static boot_progress_cb_t s_progress_cb = NULL;
+static int64_t s_run_us = 0;
+static int64_t s_first_frame_us = 0;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 记录阶段结果、推进进度并置位，依赖它的阶段随之开始（失败时跳过）
+static void boot_stage_finish(size_t id)
+{
+    const boot_stage_t *st = &s_stages[id];
+    boot_stage_stat_t *stat = &s_stats[id];
+
+    portENTER_CRITICAL(&s_lock);
+    if (stat->result != ESP_OK) {
+        s_failed |= BIT(id);
+    }
+    bool last = --s_remaining == 0;
+    uint32_t done = (st->flags & BOOT_STAGE_DEFERRED) ? 0 : ++s_progress_done;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (done && s_progress_cb) {
+        s_progress_cb(st->name, done, s_progress_total);
+    }
+
+    xEventGroupSetBits(s_events, BIT(id));
+
+    // 负责首帧的阶段结束时仍未报告首帧（失败或因依赖失败而跳过），放行延后阶段
+    if ((st->flags & BOOT_STAGE_FIRST_FRAME) && !(xEventGroupGetBits(s_events) & BOOT_FIRST_FRAME_BIT)) {
+        if (stat->result != ESP_OK) {
+            ESP_LOGE(TAG, "Stage %s ended without a first frame, starting deferred stages", st->name);
+        } else {
+            ESP_LOGW(TAG, "Stage %s did not report the first frame, starting deferred stages", st->name);
+        }
+        xEventGroupSetBits(s_events, BOOT_FIRST_FRAME_BIT);
+    }
+
+    if (last) {
+        boot_report();
+    }
+}
+
+static void boot_stage_task(void *arg)
+{
+    size_t id = (size_t)arg;
+    const boot_stage_t *st = &s_stages[id];
+    boot_stage_stat_t *stat = &s_stats[id];
+
+    uint32_t wait = st->deps;
+    if (st->flags & BOOT_STAGE_DEFERRED) {
+        wait |= BOOT_FIRST_FRAME_BIT;
+    }
+    if (wait) {
+        xEventGroupWaitBits(s_events, wait, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    stat->start_us = esp_timer_get_time();
+    stat->core = xPortGetCoreID();
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t failed_deps = s_failed & st->deps;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (failed_deps) {
+        ESP_LOGW(TAG, "Stage %s skipped, dependency failed", st->name);
+        stat->result = ESP_ERR_INVALID_STATE;
+    } else {
+        stat->result = st->fn();
+        if (stat->result != ESP_OK) {
+            ESP_LOGE(TAG, "Stage %s failed (%s)", st->name, esp_err_to_name(stat->result));
+        }
+    }
+    stat->end_us = esp_timer_get_time();
+
+    boot_stage_finish(id);
+    vTaskDelete(NULL);
+}
+
+void boot_set_progress_cb(boot_progress_cb_t cb)
+{
+    s_progress_cb = cb;
+}
+
+esp_err_t boot_run(const boot_stage_t *stages, size_t count)
+{
+    if (!stages || count == 0 || count > BOOT_MAX_STAGES || s_stages) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 只允许依赖表中存在的阶段，且不能依赖自己
+    for (size_t i = 0; i < count; i++) {
+        if ((stages[i].deps & ~BOOT_STAGE_BITS(count)) || (stages[i].deps & BIT(i))) {
+            ESP_LOGE(TAG, "Stage %s has invalid dependencies", stages[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    s_events = xEventGroupCreate();
+    if (!s_events) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_stages = stages;
+    s_count = count;
+    s_remaining = count;
+    s_progress_done = 0;
+    s_progress_total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!(stages[i].flags & BOOT_STAGE_DEFERRED)) {
+            s_progress_total++;
+        }
+    }
+    s_run_us = esp_timer_get_time();
+    memset(s_stats, 0, sizeof(s_stats));
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t stack = stages[i].stack ? stages[i].stack : BOOT_STAGE_STACK;
+        if (xTaskCreatePinnedToCore(boot_stage_task, stages[i].name, stack, (void *)i,
+                                    BOOT_STAGE_PRIORITY, NULL, stages[i].core) != pdPASS) {
+            // 无法创建任务时记为失败并置位，依赖它的阶段按失败跳过；
+            // 不能在当前任务中执行：它会等待尚未创建的阶段
+            ESP_LOGE(TAG, "No memory for stage task %s", stages[i].name);
+            s_stats[i].start_us = s_stats[i].end_us = esp_timer_get_time();
+            s_stats[i].core = xPortGetCoreID();
+            s_stats[i].result = ESP_ERR_NO_MEM;
+            boot_stage_finish(i);
+        }
+    }
+
+    // 等待所有非延后阶段
+    uint32_t mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!(stages[i].flags & BOOT_STAGE_DEFERRED)) {
+            mask |= BIT(i);
+        }
+    }
+    return boot_wait(mask, portMAX_DELAY);
+}
+
+void boot_first_frame(void)
+{
+    if (!s_events || (xEventGroupGetBits(s_events) & BOOT_FIRST_FRAME_BIT)) {
+        return;
+    }
+
+    s_first_frame_us = esp_timer_get_time();
+    xEventGroupSetBits(s_events, BOOT_FIRST_FRAME_BIT);
+    ESP_LOGI(TAG, "First frame at %lld ms", s_first_frame_us / 1000);
+}
+
+esp_err_t boot_wait(uint32_t mask, TickType_t timeout)
+{
+    if (!s_events) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(s_events, mask, pdFALSE, pdTRUE, timeout);
+    if ((bits & mask) != mask) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t failed = s_failed & mask;
+    portEXIT_CRITICAL(&s_lock);
+    return failed ? ESP_FAIL : ESP_OK;
+}
+
+void boot_report(void)
+{
+    if (!s_stages) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Boot report (times since power-on, orchestrator started at %lld ms):", s_run_us / 1000);
+    ESP_LOGI(TAG, "  %-12s %4s %8s %8s %8s  %s", "stage", "core", "start", "end", "took", "result");
+
+    int64_t last_end = 0;
+    for (size_t i = 0; i < s_count; i++) {
+        const boot_stage_stat_t *st = &s_stats[i];
+        if (st->end_us == 0) {
+            ESP_LOGI(TAG, "  %-12s %4s %8s %8s %8s  %s", s_stages[i].name, "-", "-", "-", "-", "pending");
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-12s %4d %6lldms %6lldms %6lldms  %s%s",
+                 s_stages[i].name, (int)st->core, st->start_us / 1000, st->end_us / 1000,
+                 (st->end_us - st->start_us) / 1000, esp_err_to_name(st->result),
+                 (s_stages[i].flags & BOOT_STAGE_DEFERRED) ? " (deferred)" : "");
+        if (st->end_us > last_end) {
+            last_end = st->end_us;
+        }
+    }
+
+    if (s_first_frame_us) {
+        int64_t ttfp_ms = s_first_frame_us / 1000;
+        if (ttfp_ms > BOOT_TTFP_TARGET_MS) {
+            ESP_LOGW(TAG, "  time-to-first-pixel %lld ms, over target %d ms", ttfp_ms, BOOT_TTFP_TARGET_MS);
+        } else {
+            ESP_LOGI(TAG, "  time-to-first-pixel %lld ms (target %d ms)", ttfp_ms, BOOT_TTFP_TARGET_MS);
+        }
+    } else {
+        ESP_LOGW(TAG, "  first frame not reported");
+    }
+    ESP_LOGI(TAG, "  all stages done at %lld ms", last_end / 1000);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file boot.h
+ * @brief 启动编排
+ *
+ * 把启动过程拆成若干阶段，每个阶段声明所依赖的阶段：
+ * - 依赖满足即开始，互不依赖的阶段在两个核心上并行执行
+ * - BOOT_STAGE_DEFERRED 阶段在首帧显示（boot_first_frame()）之后才开始，
+ *   用于文件系统挂载等不影响首屏的耗时操作
+ * - 负责首帧的阶段标记 BOOT_STAGE_FIRST_FRAME，它失败、被跳过或结束时仍未报告首帧，
+ *   则记录错误并放行延后阶段，避免它们永远等待
+ * - 所有阶段结束后输出各阶段耗时和首帧时间（time-to-first-pixel）报告
+ *
+ * 依赖的阶段失败时，本阶段跳过并记为失败。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#define BOOT_MAX_STAGES         16
+#define BOOT_STAGE_STACK        4096    // 默认阶段任务栈
+#define BOOT_STAGE_PRIORITY     5
+#define BOOT_TTFP_TARGET_MS     400     // 首帧时间目标（从上电开始计）
+
+/* 阶段标志 */
+#define BOOT_STAGE_DEFERRED     (1 << 0)    // 首帧显示后才开始
+#define BOOT_STAGE_FIRST_FRAME  (1 << 1)    // 该阶段调用 boot_first_frame()
+
+/** 阶段函数 */
+typedef esp_err_t (*boot_stage_fn_t)(void);
+
+/** 进度回调：每个非延后阶段结束时在该阶段的任务中调用 */
+typedef void (*boot_progress_cb_t)(const char *stage, uint32_t done, uint32_t total);
+
+/**
+ * 启动阶段描述，数组下标即阶段编号，deps 为依赖阶段编号的位掩码 BIT(n)
+ */
+typedef struct {
+    const char *name;
+    boot_stage_fn_t fn;
+    uint32_t deps;
+    uint32_t flags;
+    BaseType_t core;        // 运行核心，tskNO_AFFINITY 表示不限
+    uint32_t stack;         // 任务栈大小，0 使用 BOOT_STAGE_STACK
+} boot_stage_t;
+
+/**
+ * 设置进度回调，需在 boot_run() 之前调用
+ * @param cb 回调，NULL 取消
+ */
+void boot_set_progress_cb(boot_progress_cb_t cb);
+
+/**
+ * 启动所有阶段并等待非延后阶段完成
+ * 延后阶段在首帧后于后台继续执行
+ * @param stages 阶段表，需在整个启动过程中保持有效（通常为静态常量）
+ * @param count 阶段数，不超过 BOOT_MAX_STAGES
+ * @return esp_err_t 有阶段失败时返回 ESP_FAIL
+ */
+esp_err_t boot_run(const boot_stage_t *stages, size_t count);
+
+/**
+ * 标记首帧已显示，放行延后阶段
+ * 可重复调用，只记录第一次
+ */
+void boot_first_frame(void);
+
+/**
+ * 等待指定阶段完成
+ * @param mask 阶段位掩码
+ * @param timeout 超时
+ * @return esp_err_t 超时返回 ESP_ERR_TIMEOUT，阶段失败返回 ESP_FAIL
+ */
+esp_err_t boot_wait(uint32_t mask, TickType_t timeout);
+
+/**
+ * 输出各阶段耗时报告（所有阶段结束后会自动调用一次）
+ */
+void boot_report(void);
@@ -0,0 +1,92 @@
+/**
+ * @file clock_drift.c
+ * @brief 晶振漂移估计实现
+ */
+
+#include "clock_drift.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define OUTLIER_SIGMA   5.0f    // 偏离超过 5 sigma 的样本视为异常（时间被外部修改等）
+
+void clock_drift_init(clock_drift_t *d, float ppm, float err_ppm, uint16_t samples)
+{
+    d->has_ref = false;
+    d->outliers = 0;
+    if (err_ppm > 0 && err_ppm <= CLOCK_DRIFT_INIT_ERR_PPM && fabsf(ppm) < 500.0f) {
+        d->ppm = ppm;
+        d->err_ppm = err_ppm;
+        d->samples = samples;
+    } else {
+        d->ppm = 0;
+        d->err_ppm = CLOCK_DRIFT_INIT_ERR_PPM;
+        d->samples = 0;
+    }
+}
+
+bool clock_drift_update(clock_drift_t *d, int64_t mono_us, int64_t time_us)
+{
+    if (!d->has_ref) {
+        d->has_ref = true;
+        d->ref_mono_us = mono_us;
+        d->ref_time_us = time_us;
+        return false;
+    }
+
+    int64_t span = time_us - d->ref_time_us;
+    if (span < CLOCK_DRIFT_MIN_SPAN_US) {
+        return false; // 保留原参考点，下次得到更长的基线
+    }
+
+    float sample = (float)((double)((mono_us - d->ref_mono_us) - span) * 1e6 / (double)span);
+    float sample_err = (float)(2.0 * CLOCK_DRIFT_JITTER_US * 1e6 / (double)span);
+
+    d->ref_mono_us = mono_us;
+    d->ref_time_us = time_us;
+
+    float prior_var = d->err_ppm * d->err_ppm + CLOCK_DRIFT_PROCESS_PPM * CLOCK_DRIFT_PROCESS_PPM;
+    float meas_var = sample_err * sample_err;
+
+    if (d->samples > 0 && fabsf(sample - d->ppm) > OUTLIER_SIGMA * sqrtf(prior_var + meas_var)) {
+        d->outliers++;
+        d->err_ppm *= 2; // 连续异常说明估计已失效（如更换硬件），放宽后接受新样本
+        return false;
+    }
+
+    float w = prior_var / (prior_var + meas_var);
+    d->ppm += w * (sample - d->ppm);
+    d->err_ppm = sqrtf(prior_var * meas_var / (prior_var + meas_var));
+    if (d->samples < UINT16_MAX) {
+        d->samples++;
+    }
+    return true;
+}
+
+int64_t clock_drift_predict_us(const clock_drift_t *d, int64_t elapsed_us)
+{
+    return (int64_t)((double)elapsed_us * d->ppm / 1e6);
+}
+
+uint32_t clock_drift_interval_ms(const clock_drift_t *d, uint32_t tolerance_ms, uint32_t min_ms, uint32_t max_ms)
+{
+    // 补偿后的剩余误差按不确定度增长
+    double ms = d->err_ppm > 0 ? (double)tolerance_ms * 1e6 / d->err_ppm : (double)max_ms;
+
+    if (ms < min_ms) {
+        return min_ms;
+    }
+    if (ms > max_ms) {
+        return max_ms;
+    }
+    return (uint32_t)ms;
+}
+
+bool clock_drift_need_step(bool valid, int64_t offset_us, int64_t step_us)
+{
+    return !valid || llabs(offset_us) > step_us;
+}
+
+int64_t clock_drift_trim_us(const clock_drift_t *d, int64_t elapsed_us, int64_t pending_us)
+{
+    return pending_us - clock_drift_predict_us(d, elapsed_us);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file clock_drift.h
+ * @brief 晶振漂移估计
+ *
+ * 每次对时得到一对（本地单调时钟，参考时间），相邻两次的差值给出一个漂移率样本。
+ * 样本误差按对时抖动除以间隔估计，间隔越长样本越准；新样本与当前估计按方差加权合并，
+ * 每次合并前给当前估计加上过程噪声，允许温度变化带来的缓慢漂移。
+ *
+ * 估计的不确定度决定下次对时的间隔：误差积累到容限所需的时间。
+ * 对时结果的校正方式（直接设置或平滑调整）和两次对时之间的漂移补偿量也在这里计算。
+ *
+ * 本模块只做计算，不读时钟、不依赖 ESP-IDF，时间由调用方传入，可在主机上用模拟时钟验证。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CLOCK_DRIFT_INIT_ERR_PPM    50.0f   // 没有历史数据时的不确定度（晶振标称误差量级）
+#define CLOCK_DRIFT_JITTER_US       50000   // 单次对时的时间误差（网络延迟抖动）
+#define CLOCK_DRIFT_MIN_SPAN_US     (10 * 60 * 1000000LL) // 短于此间隔的样本不参与估计
+#define CLOCK_DRIFT_PROCESS_PPM     0.5f    // 每个样本之间漂移率可能的变化
+
+/** 漂移估计状态 */
+typedef struct {
+    float ppm;              // 漂移率，正数表示本地时钟偏快
+    float err_ppm;          // 不确定度（1 sigma）
+    uint16_t samples;       // 已合并的样本数
+    uint16_t outliers;      // 被丢弃的异常样本数
+    bool has_ref;           // 有上一次对时的参考点
+    int64_t ref_mono_us;    // 参考点的本地单调时钟
+    int64_t ref_time_us;    // 参考点的参考时间
+} clock_drift_t;
+
+/**
+ * 初始化
+ * @param d 状态
+ * @param ppm 保存的漂移率
+ * @param err_ppm 保存的不确定度，<=0 表示没有历史数据
+ * @param samples 保存的样本数
+ */
+void clock_drift_init(clock_drift_t *d, float ppm, float err_ppm, uint16_t samples);
+
+/**
+ * 加入一次对时结果
+ * @param d 状态
+ * @param mono_us 对时时的本地单调时钟
+ * @param time_us 对时得到的参考时间
+ * @return bool 估计值有更新（第一次对时或间隔太短时为 false）
+ */
+bool clock_drift_update(clock_drift_t *d, int64_t mono_us, int64_t time_us);
+
+/**
+ * 本地时钟经过 elapsed_us 后的预计偏差
+ * @param d 状态
+ * @param elapsed_us 本地单调时钟经过的时间
+ * @return int64_t 本地时钟比参考时间快的微秒数
+ */
+int64_t clock_drift_predict_us(const clock_drift_t *d, int64_t elapsed_us);
+
+/**
+ * 下次对时的间隔：按当前不确定度，误差积累到 tolerance_ms 所需的时间
+ * @param d 状态
+ * @param tolerance_ms 允许的时间误差
+ * @param min_ms 最短间隔
+ * @param max_ms 最长间隔
+ * @return uint32_t 间隔（毫秒）
+ */
+uint32_t clock_drift_interval_ms(const clock_drift_t *d, uint32_t tolerance_ms, uint32_t min_ms, uint32_t max_ms);
+
+/**
+ * 对时后是否直接设置时间
+ * @param valid 系统时间此前是否有效
+ * @param offset_us 本地时间减参考时间
+ * @param step_us 偏差超过此值直接设置
+ * @return bool true 直接设置时间，false 用 adjtime 平滑调整 -offset_us
+ */
+bool clock_drift_need_step(bool valid, int64_t offset_us, int64_t step_us);
+
+/**
+ * 漂移补偿后的 adjtime 调整量：在尚未完成的调整上扣除 elapsed_us 内积累的偏差
+ * @param d 状态
+ * @param elapsed_us 自上次补偿以来本地单调时钟经过的时间
+ * @param pending_us adjtime 尚未完成的调整量
+ * @return int64_t 新的调整量
+ */
+int64_t clock_drift_trim_us(const clock_drift_t *d, int64_t elapsed_us, int64_t pending_us);
@@ -0,0 +1,847 @@
+/**
+ * @file home_mqtt.c
+ * @brief 智能家居 MQTT 客户端实现
+ *
+ * 连接管理、批量发送和队列保存在 home_mqtt 任务中执行；esp-mqtt 的事件在其自身任务中回调，
+ * 连接状态和 PUBACK 转给 home_mqtt 任务，设备状态直接在回调中处理。
+ * QoS 0 消息交给 esp-mqtt 后即移出队列；QoS 1 消息留在队列中，收到 PUBACK 后才移出，
+ * 连接断开时未确认的消息在下次连接后重发。
+ * s_outbox 由 s_lock 保护（发送期间不持锁），设备表和统计由 s_mux 保护。
+ */
+
+#include "home_mqtt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_mac.h"
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+#include "esp_crt_bundle.h"
+#endif
+#include "mqtt_client.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "mqtt_outbox.h"
+#include "settings.h"
+#include "sys_file.h"
+#include "wifi_mgr.h"
+#include "wifi_policy.h"
+
+static const char *TAG = "home_mqtt";
+
+ESP_EVENT_DEFINE_BASE(HOME_MQTT_EVENT);
+
+#define HOME_TASK_STACK     4096
+#define HOME_TASK_PRIO      2
+#define HOME_FILE_VERSION   1
+#define URL_MAX             96
+#define PREFIX_MAX          24
+#define NODE_LEN            12      // "clock-XXXXXX"
+#define CMD_QUEUE_LEN       16
+
+typedef enum {
+    CMD_NET_UP,
+    CMD_NET_DOWN,
+    CMD_LINK_UP,
+    CMD_LINK_DOWN,
+    CMD_QUEUED,
+    CMD_FLUSH,
+    CMD_SCREEN_ON,
+    CMD_SCREEN_OFF,
+    CMD_CONFIG,
+    CMD_PUBACK,
+} cmd_type_t;
+
+typedef struct {
+    uint8_t type;               // cmd_type_t
+    int msg_id;                 // CMD_PUBACK
+} cmd_t;
+
+/* 已发出、等待 PUBACK 的 QoS 1 消息 */
+typedef struct {
+    int msg_id;
+    uint32_t seq;               // 队列中的记录序号
+} inflight_t;
+
+/* 队列文件 */
+typedef struct {
+    uint8_t version;
+    uint8_t reserved[3];
+    mqtt_outbox_t outbox;
+} home_file_t;
+
+typedef struct {
+    char name[HOME_MQTT_NAME_MAX + 1];
+    char state[HOME_MQTT_STATE_MAX + 1];
+    int8_t on;
+} device_t;
+
+static QueueHandle_t s_cmd_queue = NULL;
+static SemaphoreHandle_t s_lock = NULL;    // 保护 s_outbox、s_dirty_us、s_inflight_count
+static mqtt_outbox_t s_outbox;
+static int64_t s_dirty_us = 0;              // 队列第一次未保存的修改时间，0 表示已保存
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;  // 保护 s_devices、s_stats
+static device_t s_devices[HOME_MQTT_DEVICES];
+static home_mqtt_stats_t s_stats;
+static volatile bool s_link_up = false;
+
+/* 配置，只在客户端停止时由 home_mqtt 任务修改 */
+static char s_url[URL_MAX];
+static char s_prefix[PREFIX_MAX];
+static char s_node[NODE_LEN + 1];
+static char s_status_topic[PREFIX_MAX + NODE_LEN + 8];
+
+/* 以下只在 home_mqtt 任务中访问（初始化时除外） */
+static esp_mqtt_client_handle_t s_client = NULL;
+static bool s_net_up = false;
+static bool s_screen_on = true;
+static bool s_started = false;
+static bool s_flush_now = false;
+static bool s_file_has_data = false;
+static int64_t s_retry_us = 0;          // 等待重连的时间，0 表示不在等待
+static int64_t s_start_after_us = 0;    // 启动失败后推迟
+static int64_t s_last_flush_us = 0;
+static int64_t s_linger_until_us = 0;
+static wifi_policy_t s_backoff;
+static uint32_t s_send_seq = 0;         // 本次连接中下一条要发送的记录序号，之前的 QoS 1 记录在等待确认
+static inflight_t s_inflight[HOME_MQTT_INFLIGHT];
+static uint16_t s_inflight_count = 0;     // 只在 home_mqtt 任务中修改，入队时读取
+static bool s_inflight_full = false;    // 发送因等待确认的消息过多而暂停
+
+static void send_cmd_arg(cmd_type_t type, int msg_id)
+{
+    cmd_t cmd = {.type = type, .msg_id = msg_id};
+    if (s_cmd_queue) {
+        xQueueSend(s_cmd_queue, &cmd, pdMS_TO_TICKS(100));
+    }
+}
+
+static void send_cmd(cmd_type_t type)
+{
+    send_cmd_arg(type, 0);
+}
+
+static uint16_t queued(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    uint16_t count = mqtt_outbox_count(&s_outbox);
+    xSemaphoreGive(s_lock);
+    return count;
+}
+
+// 队列中尚未发出的消息数，调用方持有 s_lock
+static uint16_t unsent_locked(void)
+{
+    uint16_t count = mqtt_outbox_count(&s_outbox);
+    return count > s_inflight_count ? count - s_inflight_count : 0;
+}
+
+static uint16_t unsent(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    uint16_t count = unsent_locked();
+    xSemaphoreGive(s_lock);
+    return count;
+}
+
+// 入队，调用方任务中执行；urgent 时立即发送，否则只在需要重新计算发送时间时唤醒任务
+static esp_err_t enqueue(const char *topic, const char *value, uint8_t flags, bool urgent)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool ok = mqtt_outbox_push(&s_outbox, topic, value, strlen(value), flags);
+    uint16_t count = unsent_locked(); // 等待确认的消息不算在批次内
+    if (ok && s_dirty_us == 0) {
+        s_dirty_us = esp_timer_get_time();
+    }
+    xSemaphoreGive(s_lock);
+
+    if (!ok) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (urgent) {
+        send_cmd(CMD_FLUSH);
+    } else if (count == 1 || count == HOME_MQTT_BATCH_MAX) {
+        send_cmd(CMD_QUEUED); // 新的一批开始或已满
+    }
+    return ESP_OK;
+}
+
+/* ---------------- 设备状态（esp-mqtt 任务） ---------------- */
+
+static int8_t parse_on(const char *s)
+{
+    static const char *const on[] = {"on", "1", "true", "open"};
+    static const char *const off[] = {"off", "0", "false", "closed"};
+
+    for (int i = 0; i < 4; i++) {
+        if (strcasecmp(s, on[i]) == 0) {
+            return 1;
+        }
+        if (strcasecmp(s, off[i]) == 0) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// <前缀>/device/<名称>/state
+static void handle_device(const char *topic, int topic_len, const char *data, int len)
+{
+    static const char suffix[] = "/state";
+    size_t prefix_len = strlen(s_prefix);
+    const size_t mid_len = sizeof("/device/") - 1;
+    const size_t suffix_len = sizeof(suffix) - 1;
+
+    if ((size_t)topic_len <= prefix_len + mid_len + suffix_len || memcmp(topic, s_prefix, prefix_len) != 0 ||
+        memcmp(topic + prefix_len, "/device/", mid_len) != 0 ||
+        memcmp(topic + topic_len - suffix_len, suffix, suffix_len) != 0) {
+        return;
+    }
+    const char *name = topic + prefix_len + mid_len;
+    size_t name_len = topic + topic_len - suffix_len - name;
+    if (name_len > HOME_MQTT_NAME_MAX) {
+        return;
+    }
+
+    home_mqtt_device_t dev = {.on = -1};
+    memcpy(dev.name, name, name_len);
+    dev.name[name_len] = '\0';
+    if (len > HOME_MQTT_STATE_MAX) {
+        len = HOME_MQTT_STATE_MAX;
+    }
+    memcpy(dev.state, data, len);
+    dev.state[len] = '\0';
+    dev.on = parse_on(dev.state);
+
+    bool changed = false;
+    int free_slot = -1;
+    int slot = -1;
+
+    taskENTER_CRITICAL(&s_mux);
+    for (int i = 0; i < HOME_MQTT_DEVICES; i++) {
+        if (s_devices[i].name[0] == '\0') {
+            free_slot = free_slot < 0 ? i : free_slot;
+        } else if (strcmp(s_devices[i].name, dev.name) == 0) {
+            slot = i;
+        }
+    }
+    if (len == 0) {
+        // 空的保留消息表示设备已删除
+        if (slot >= 0) {
+            s_devices[slot].name[0] = '\0';
+            changed = true;
+        }
+    } else {
+        if (slot < 0) {
+            slot = free_slot;
+        }
+        if (slot >= 0 && (s_devices[slot].name[0] == '\0' || strcmp(s_devices[slot].state, dev.state) != 0)) {
+            strcpy(s_devices[slot].name, dev.name);
+            strcpy(s_devices[slot].state, dev.state);
+            s_devices[slot].on = dev.on;
+            changed = true;
+        }
+    }
+    s_stats.device_updates += changed;
+    taskEXIT_CRITICAL(&s_mux);
+
+    if (len > 0 && slot < 0) {
+        ESP_LOGW(TAG, "Device table full, ignore %s", dev.name);
+        return;
+    }
+    if (changed) {
+        if (len == 0) {
+            dev.name[0] = '\0';
+            dev.state[0] = '\0';
+        }
+        dev.slot = slot;
+        esp_event_post(HOME_MQTT_EVENT, HOME_MQTT_EVENT_DEVICE, &dev, sizeof(dev), pdMS_TO_TICKS(100));
+    }
+}
+
+static void clear_devices(void)
+{
+    for (int i = 0; i < HOME_MQTT_DEVICES; i++) {
+        taskENTER_CRITICAL(&s_mux);
+        bool had = s_devices[i].name[0] != '\0';
+        s_devices[i].name[0] = '\0';
+        taskEXIT_CRITICAL(&s_mux);
+        if (had) {
+            home_mqtt_device_t dev = {.slot = i, .on = -1};
+            esp_event_post(HOME_MQTT_EVENT, HOME_MQTT_EVENT_DEVICE, &dev, sizeof(dev), pdMS_TO_TICKS(100));
+        }
+    }
+}
+
+static void mqtt_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    esp_mqtt_event_handle_t event = data;
+    char topic[PREFIX_MAX + 16];
+
+    switch ((esp_mqtt_event_id_t)id) {
+    case MQTT_EVENT_CONNECTED:
+        snprintf(topic, sizeof(topic), "%s/device/+/state", s_prefix);
+        esp_mqtt_client_subscribe(event->client, topic, 0);
+        esp_mqtt_client_publish(event->client, s_status_topic, "online", 0, 1, 1);
+        send_cmd(CMD_LINK_UP);
+        break;
+    case MQTT_EVENT_DISCONNECTED:
+        send_cmd(CMD_LINK_DOWN);
+        break;
+    case MQTT_EVENT_PUBLISHED:
+        send_cmd_arg(CMD_PUBACK, event->msg_id);
+        break;
+    case MQTT_EVENT_DATA:
+        // 设备状态很短，分片的大消息不是设备状态
+        if (event->current_data_offset == 0 && event->data_len == event->total_data_len) {
+            handle_device(event->topic, event->topic_len, event->data, event->data_len);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* ---------------- 队列文件 ---------------- */
+
+static void save(void)
+{
+    home_file_t *file = malloc(sizeof(*file));
+    if (!file) {
+        return;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    file->version = HOME_FILE_VERSION;
+    memset(file->reserved, 0, sizeof(file->reserved));
+    file->outbox = s_outbox;
+    s_dirty_us = 0;
+    xSemaphoreGive(s_lock);
+
+    uint16_t count = mqtt_outbox_count(&file->outbox);
+    esp_err_t err = sys_file_write_atomic(HOME_MQTT_FILE, file, sizeof(*file));
+    free(file);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Save failed: %s", esp_err_to_name(err));
+        return;
+    }
+    s_file_has_data = count > 0;
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.saves++;
+    taskEXIT_CRITICAL(&s_mux);
+    ESP_LOGD(TAG, "Saved %u messages", count);
+}
+
+static void load(void)
+{
+    size_t len = 0;
+    home_file_t *file = sys_file_read_all(HOME_MQTT_FILE, &len, false);
+
+    if (!file) {
+        return;
+    }
+    if (len == sizeof(*file) && file->version == HOME_FILE_VERSION && mqtt_outbox_check(&file->outbox)) {
+        s_outbox = file->outbox;
+        s_file_has_data = mqtt_outbox_count(&s_outbox) > 0;
+        ESP_LOGI(TAG, "Loaded %u queued messages", mqtt_outbox_count(&s_outbox));
+    } else {
+        ESP_LOGW(TAG, "Discard %s (%u bytes)", HOME_MQTT_FILE, (unsigned)len);
+    }
+    free(file);
+}
+
+// 连接时队列随时会发出，只在离线时保存；发送完后清掉文件中已发出的消息，重启后不重发
+static void maybe_save(int64_t now)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    uint16_t count = mqtt_outbox_count(&s_outbox);
+    if (count == 0 && !s_file_has_data) {
+        s_dirty_us = 0; // 文件和队列都是空的，不需要写
+    }
+    int64_t dirty_us = s_dirty_us;
+    xSemaphoreGive(s_lock);
+
+    if (dirty_us == 0) {
+        return;
+    }
+    if (s_link_up) {
+        if (count == 0 && s_file_has_data) {
+            save();
+        }
+    } else if (now >= dirty_us + HOME_MQTT_SAVE_MS * 1000LL) {
+        save();
+    }
+}
+
+/* ---------------- 连接与发送（home_mqtt 任务） ---------------- */
+
+static void load_config(void)
+{
+    uint8_t mac[6] = {0};
+
+    settings_get_str(SETTING_MQTT_URL, s_url, sizeof(s_url));
+    settings_get_str(SETTING_MQTT_PREFIX, s_prefix, sizeof(s_prefix));
+    esp_efuse_mac_get_default(mac);
+    snprintf(s_node, sizeof(s_node), "clock-%02x%02x%02x", mac[3], mac[4], mac[5]);
+    snprintf(s_status_topic, sizeof(s_status_topic), "%s/%s/status", s_prefix, s_node);
+}
+
+static void start_link(int64_t now)
+{
+    if (!s_client) {
+        const esp_mqtt_client_config_t cfg = {
+            .broker.address.uri = s_url,
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+            .broker.verification.crt_bundle_attach = esp_crt_bundle_attach,
+#endif
+            .credentials.client_id = s_node,
+            .session.keepalive = HOME_MQTT_KEEPALIVE_S,
+            .session.last_will = {
+                .topic = s_status_topic,
+                .msg = "offline",
+                .qos = 1,
+                .retain = 1,
+            },
+            .network.disable_auto_reconnect = true, // 由本模块按退避策略重连
+        };
+        s_client = esp_mqtt_client_init(&cfg);
+        if (!s_client) {
+            ESP_LOGE(TAG, "Bad config %s", s_url);
+            s_url[0] = '\0'; // 设置修改后重新读取
+            return;
+        }
+        esp_mqtt_client_register_event(s_client, MQTT_EVENT_ANY, mqtt_event_cb, NULL);
+    }
+
+    esp_err_t err = esp_mqtt_client_start(s_client);
+    if (err != ESP_OK) {
+        s_start_after_us = now + wifi_policy_fail(&s_backoff, s_screen_on ? WIFI_POLICY_SCREEN_ON : WIFI_POLICY_SCREEN_OFF) * 1000LL;
+        ESP_LOGW(TAG, "Start failed: %s", esp_err_to_name(err));
+        return;
+    }
+    s_started = true;
+    s_retry_us = 0;
+}
+
+// 未确认的消息仍在队列中，下次连接后从队首重新发送
+static void forget_inflight(void)
+{
+    s_inflight_full = false;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_inflight_count = 0;
+    s_send_seq = s_outbox.seq;
+    xSemaphoreGive(s_lock);
+}
+
+static void link_down(void)
+{
+    bool was_up = s_link_up;
+    s_link_up = false;
+    forget_inflight();
+    if (was_up) {
+        esp_event_post(HOME_MQTT_EVENT, HOME_MQTT_EVENT_DISCONNECTED, NULL, 0, pdMS_TO_TICKS(100));
+    }
+}
+
+static void stop_link(void)
+{
+    if (s_link_up) {
+        esp_mqtt_client_publish(s_client, s_status_topic, "offline", 0, 0, 1);
+    }
+    esp_mqtt_client_stop(s_client);
+    s_started = false;
+    s_retry_us = 0;
+    link_down();
+    ESP_LOGD(TAG, "Stopped");
+}
+
+static void destroy_link(void)
+{
+    if (s_started) {
+        stop_link();
+    }
+    if (s_client) {
+        esp_mqtt_client_destroy(s_client);
+        s_client = NULL;
+    }
+}
+
+static uint32_t batch_interval_ms(void)
+{
+    return s_screen_on ? HOME_MQTT_BATCH_MS : HOME_MQTT_BATCH_OFF_MS;
+}
+
+// 熄屏时只在有数据要发送时连接
+static bool want_link(int64_t now, uint16_t count)
+{
+    if (!s_url[0] || !s_net_up || now < s_start_after_us) {
+        return false;
+    }
+    if (s_screen_on || s_flush_now) {
+        return true;
+    }
+    if (count > 0 && now >= s_last_flush_us + batch_interval_ms() * 1000LL) {
+        return true;
+    }
+    return now < s_linger_until_us;
+}
+
+// count 不含等待确认的消息
+static bool flush_due(int64_t now, uint16_t count)
+{
+    return count > 0 && !s_inflight_full &&
+           (s_flush_now || count >= HOME_MQTT_BATCH_MAX || now >= s_last_flush_us + batch_interval_ms() * 1000LL);
+}
+
+// 移出已发出的记录，调用方持有 s_lock
+static void remove_sent(uint32_t seq)
+{
+    mqtt_outbox_pop(&s_outbox, seq);
+    if (s_dirty_us == 0) {
+        s_dirty_us = esp_timer_get_time();
+    }
+}
+
+// 一次连续发送队列中尚未发出的消息，按入队顺序；等待确认的消息达到上限时暂停，收到确认后继续
+static void flush(int64_t now)
+{
+    mqtt_outbox_rec_t *rec = malloc(sizeof(*rec));
+    uint32_t sent = 0;
+
+    if (!rec) {
+        return;
+    }
+    while (s_link_up) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        bool have = mqtt_outbox_peek_from(&s_outbox, s_send_seq, rec);
+        xSemaphoreGive(s_lock);
+        if (!have) {
+            break;
+        }
+        bool qos1 = rec->flags & MQTT_OUTBOX_QOS1;
+        if (qos1 && s_inflight_count == HOME_MQTT_INFLIGHT) {
+            s_inflight_full = true;
+            break;
+        }
+
+        int msg_id = esp_mqtt_client_publish(s_client, rec->topic, rec->payload, rec->len, qos1 ? 1 : 0,
+                                             (rec->flags & MQTT_OUTBOX_RETAIN) ? 1 : 0);
+        if (msg_id < 0) {
+            ESP_LOGW(TAG, "Publish %s failed", rec->topic);
+            break; // 连接已断开，剩余的下次发送
+        }
+        s_send_seq = rec->seq + 1;
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        if (qos1) {
+            s_inflight[s_inflight_count++] = (inflight_t){.msg_id = msg_id, .seq = rec->seq};
+        } else {
+            remove_sent(rec->seq);
+        }
+        xSemaphoreGive(s_lock);
+        sent++;
+    }
+    free(rec);
+
+    s_flush_now = false;
+    s_last_flush_us = now;
+    if (!s_screen_on) {
+        s_linger_until_us = esp_timer_get_time() + HOME_MQTT_LINGER_MS * 1000LL;
+    }
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.batches++;
+    s_stats.published += sent;
+    taskEXIT_CRITICAL(&s_mux);
+    ESP_LOGD(TAG, "Sent %lu messages", (unsigned long)sent);
+}
+
+// 收到 PUBACK，移出对应的记录；该记录可能已被同主题的新值作废
+static void acked(int msg_id)
+{
+    for (int i = 0; i < s_inflight_count; i++) {
+        if (s_inflight[i].msg_id == msg_id) {
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+            remove_sent(s_inflight[i].seq);
+            s_inflight[i] = s_inflight[--s_inflight_count];
+            xSemaphoreGive(s_lock);
+            if (s_inflight_full) {
+                s_inflight_full = false;
+                s_flush_now = true;
+            }
+            return;
+        }
+    }
+}
+
+static void run(void)
+{
+    int64_t now = esp_timer_get_time();
+    uint16_t count = unsent();
+
+    if (!want_link(now, count)) {
+        if (s_started) {
+            stop_link();
+        }
+    } else if (!s_started) {
+        start_link(now);
+    } else if (!s_link_up && s_retry_us != 0 && now >= s_retry_us) {
+        s_retry_us = 0;
+        esp_mqtt_client_reconnect(s_client);
+    }
+
+    if (s_link_up && flush_due(now, count)) {
+        flush(now);
+    }
+    maybe_save(esp_timer_get_time());
+}
+
+// 取尚未到达的最早截止时间；已到达的事件在 run() 中处理过，仍未处理说明暂时不能执行
+static void consider(int64_t *deadline, int64_t t, int64_t now)
+{
+    if (t > now && t < *deadline) {
+        *deadline = t;
+    }
+}
+
+static TickType_t next_wait(void)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t deadline = INT64_MAX;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int64_t dirty_us = s_dirty_us;
+    uint16_t count = unsent_locked();
+    xSemaphoreGive(s_lock);
+
+    if (s_net_up && s_url[0]) {
+        consider(&deadline, s_start_after_us, now);
+        if (count > 0) {
+            consider(&deadline, s_last_flush_us + batch_interval_ms() * 1000LL, now);
+        }
+        if (s_started) {
+            consider(&deadline, s_retry_us, now);
+            consider(&deadline, s_linger_until_us, now);
+        }
+    }
+    if (dirty_us != 0 && !s_link_up) {
+        consider(&deadline, dirty_us + HOME_MQTT_SAVE_MS * 1000LL, now);
+    }
+    if (deadline == INT64_MAX) {
+        return portMAX_DELAY;
+    }
+    return pdMS_TO_TICKS((deadline - now) / 1000) + 1;
+}
+
+static void home_task(void *arg)
+{
+    cmd_t cmd;
+
+    while (1) {
+        if (xQueueReceive(s_cmd_queue, &cmd, next_wait()) == pdTRUE) {
+            int64_t now = esp_timer_get_time();
+            switch (cmd.type) {
+            case CMD_NET_UP:
+                s_net_up = true;
+                s_start_after_us = 0;
+                wifi_policy_reset(&s_backoff);
+                break;
+            case CMD_NET_DOWN:
+                s_net_up = false;
+                break;
+            case CMD_LINK_UP:
+                if (!s_started) {
+                    break; // 停止前已在途的事件
+                }
+                forget_inflight();
+                s_link_up = true;
+                s_flush_now = queued() > 0; // 离线期间积累的消息和上次未确认的消息立即发送
+                wifi_policy_reset(&s_backoff);
+                taskENTER_CRITICAL(&s_mux);
+                s_stats.connects++;
+                s_stats.wakeups += !s_screen_on;
+                taskEXIT_CRITICAL(&s_mux);
+                ESP_LOGI(TAG, "Connected to %s", s_url);
+                esp_event_post(HOME_MQTT_EVENT, HOME_MQTT_EVENT_CONNECTED, NULL, 0, pdMS_TO_TICKS(100));
+                break;
+            case CMD_LINK_DOWN:
+                if (!s_started) {
+                    break;
+                }
+                link_down();
+                s_retry_us = now + wifi_policy_fail(&s_backoff, s_screen_on ? WIFI_POLICY_SCREEN_ON : WIFI_POLICY_SCREEN_OFF) * 1000LL;
+                ESP_LOGW(TAG, "Disconnected, retry in %lld s", (long long)((s_retry_us - now) / 1000000));
+                break;
+            case CMD_QUEUED:
+                break; // 重新计算等待时间
+            case CMD_FLUSH:
+                s_flush_now = true;
+                break;
+            case CMD_SCREEN_ON:
+                s_screen_on = true;
+                break;
+            case CMD_SCREEN_OFF:
+                // 断开前先发出队列中的消息
+                s_screen_on = false;
+                s_flush_now = s_link_up && queued() > 0;
+                s_linger_until_us = now + HOME_MQTT_LINGER_MS * 1000LL;
+                break;
+            case CMD_CONFIG:
+                destroy_link();
+                clear_devices();
+                load_config();
+                s_start_after_us = 0;
+                wifi_policy_reset(&s_backoff);
+                break;
+            case CMD_PUBACK:
+                acked(cmd.msg_id);
+                break;
+            }
+        }
+        run();
+    }
+}
+
+static void wifi_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    if (id == WIFI_MGR_EVENT_CONNECTED) {
+        send_cmd(CMD_NET_UP);
+    } else if (id == WIFI_MGR_EVENT_DISCONNECTED) {
+        send_cmd(CMD_NET_DOWN);
+    }
+}
+
+static void config_changed_cb(setting_id_t id, void *arg)
+{
+    send_cmd(CMD_CONFIG);
+}
+
+esp_err_t home_mqtt_init(void)
+{
+    if (s_cmd_queue) {
+        return ESP_OK;
+    }
+
+    wifi_policy_init(&s_backoff, esp_random()); // 与 WLAN 重连相同的默认退避参数
+
+    mqtt_outbox_init(&s_outbox);
+    load();
+    load_config();
+
+    s_lock = xSemaphoreCreateMutex();
+    s_cmd_queue = xQueueCreate(CMD_QUEUE_LEN, sizeof(cmd_t));
+    if (!s_lock || !s_cmd_queue) {
+        goto fail;
+    }
+    if (xTaskCreate(home_task, "home_mqtt", HOME_TASK_STACK, NULL, HOME_TASK_PRIO, NULL) != pdPASS) {
+        goto fail;
+    }
+
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_CONNECTED, wifi_event_cb, NULL);
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_DISCONNECTED, wifi_event_cb, NULL);
+    esp_err_t err = settings_subscribe(SETTING_MQTT_URL, config_changed_cb, NULL);
+    if (err == ESP_OK) {
+        err = settings_subscribe(SETTING_MQTT_PREFIX, config_changed_cb, NULL);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (wifi_mgr_get_state() == WIFI_MGR_STATE_CONNECTED) {
+        send_cmd(CMD_NET_UP);
+    }
+    if (!s_url[0]) {
+        ESP_LOGI(TAG, "No broker configured");
+    }
+    return ESP_OK;
+
+fail:
+    if (s_cmd_queue) {
+        vQueueDelete(s_cmd_queue);
+        s_cmd_queue = NULL;
+    }
+    if (s_lock) {
+        vSemaphoreDelete(s_lock);
+        s_lock = NULL;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t home_mqtt_publish(const char *name, const char *value, uint32_t flags)
+{
+    char topic[MQTT_OUTBOX_TOPIC_MAX + 2];
+
+    if (!s_cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    int n = snprintf(topic, sizeof(topic), "%s/%s/%s", s_prefix, s_node, name);
+    if (n < 0 || n > MQTT_OUTBOX_TOPIC_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t ob_flags = 0;
+    ob_flags |= (flags & HOME_MQTT_F_RETAIN) ? MQTT_OUTBOX_RETAIN : 0;
+    ob_flags |= (flags & HOME_MQTT_F_LATEST) ? MQTT_OUTBOX_LATEST : 0;
+    ob_flags |= (flags & HOME_MQTT_F_NOW) ? MQTT_OUTBOX_QOS1 : 0;
+    return enqueue(topic, value, ob_flags, flags & HOME_MQTT_F_NOW);
+}
+
+esp_err_t home_mqtt_device_set(const char *name, const char *value)
+{
+    char topic[MQTT_OUTBOX_TOPIC_MAX + 2];
+
+    if (!s_cmd_queue || !s_link_up) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    int n = snprintf(topic, sizeof(topic), "%s/device/%s/set", s_prefix, name);
+    if (n < 0 || n > MQTT_OUTBOX_TOPIC_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // 连续操作同一设备时只发送最后一次
+    return enqueue(topic, value, MQTT_OUTBOX_QOS1 | MQTT_OUTBOX_LATEST, true);
+}
+
+esp_err_t home_mqtt_device_toggle(uint8_t slot)
+{
+    char name[HOME_MQTT_NAME_MAX + 1];
+    int8_t on = -1;
+
+    if (slot >= HOME_MQTT_DEVICES) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    taskENTER_CRITICAL(&s_mux);
+    strcpy(name, s_devices[slot].name);
+    if (name[0]) {
+        on = s_devices[slot].on;
+    }
+    taskEXIT_CRITICAL(&s_mux);
+
+    if (on < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return home_mqtt_device_set(name, on ? "OFF" : "ON");
+}
+
+void home_mqtt_set_screen_on(bool on)
+{
+    send_cmd(on ? CMD_SCREEN_ON : CMD_SCREEN_OFF);
+}
+
+void home_mqtt_get_stats(home_mqtt_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+
+    if (!s_lock) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    stats->queued = mqtt_outbox_count(&s_outbox);
+    stats->dropped = s_outbox.dropped;
+    stats->coalesced = s_outbox.coalesced;
+    xSemaphoreGive(s_lock);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file home_mqtt.h
+ * @brief 智能家居 MQTT 客户端
+ *
+ * 连接设置项 SETTING_MQTT_URL 指定的服务器（mqtt:// 或 mqtts://，可含用户名密码），为空时不启用：
+ * - 上报：home_mqtt_publish() 写入待发送队列（mqtt_outbox），按批发送：亮屏时每 HOME_MQTT_BATCH_MS
+ *   或队列达到 HOME_MQTT_BATCH_MAX 条时发送一次，HOME_MQTT_F_NOW 立即发送；
+ *   未连接时队列保留，变化后延迟 HOME_MQTT_SAVE_MS 写入 LittleFS，重启后继续发送
+ * - 熄屏时不保持连接，不产生心跳唤醒：每 HOME_MQTT_BATCH_OFF_MS 连接一次发送队列，
+ *   发送完等待 HOME_MQTT_LINGER_MS 后断开；亮屏时重新连接
+ * - 设备状态：订阅 <前缀>/device/+/state 的保留消息，最多跟踪 HOME_MQTT_DEVICES 个设备，
+ *   只在某个设备的状态变化时发布 HOME_MQTT_EVENT_DEVICE，界面逐个更新
+ * - 控制：home_mqtt_device_set() 发布 <前缀>/device/<名称>/set
+ *
+ * 本机主题为 <前缀>/clock-XXXXXX/<名称>（XXXXXX 为 MAC 后三字节），
+ * 连接后发布保留消息 status=online，遗嘱和主动断开时为 offline。
+ * WLAN 断开时断开连接，失败后按 wifi_policy 指数退避重连。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#define HOME_MQTT_FILE          "/littlefs/mqtt_outbox.bin"
+#define HOME_MQTT_KEEPALIVE_S   120                 // 亮屏连接时的心跳间隔
+#define HOME_MQTT_BATCH_MS      (60 * 1000)         // 亮屏时的发送间隔
+#define HOME_MQTT_BATCH_OFF_MS  (15 * 60 * 1000)    // 熄屏时的发送间隔
+#define HOME_MQTT_BATCH_MAX     16                  // 队列达到此条数时立即发送
+#define HOME_MQTT_LINGER_MS     5000                // 熄屏时发送完保持连接的时间（等待确认和设备状态）
+#define HOME_MQTT_SAVE_MS       (60 * 1000)         // 未连接时队列变化后写入文件的延迟
+#define HOME_MQTT_INFLIGHT      8                   // 等待 PUBACK 的 QoS 1 消息数上限，达到后暂停发送
+#define HOME_MQTT_DEVICES       4                   // 跟踪的设备数
+#define HOME_MQTT_NAME_MAX      15                  // 设备名称最大长度
+#define HOME_MQTT_STATE_MAX     23                  // 设备状态最大长度，超长截断
+
+/* home_mqtt_publish() 选项 */
+#define HOME_MQTT_F_RETAIN  0x01    // 保留消息
+#define HOME_MQTT_F_LATEST  0x02    // 状态类数据：队列中同一主题只保留最新值
+#define HOME_MQTT_F_NOW     0x04    // 立即发送（QoS 1，收到确认后才移出队列），熄屏时也会连接
+
+ESP_EVENT_DECLARE_BASE(HOME_MQTT_EVENT);
+
+/** HOME_MQTT_EVENT 事件 */
+typedef enum {
+    HOME_MQTT_EVENT_CONNECTED,      // 已连接服务器，无数据
+    HOME_MQTT_EVENT_DISCONNECTED,   // 连接断开（含熄屏主动断开），无数据
+    HOME_MQTT_EVENT_DEVICE,         // 设备状态变化，数据为 home_mqtt_device_t
+} home_mqtt_event_t;
+
+/** 设备状态 */
+typedef struct {
+    uint8_t slot;                           // 0 ~ HOME_MQTT_DEVICES-1
+    int8_t on;                              // 1 开，0 关，-1 不是开关量（见 state）
+    char name[HOME_MQTT_NAME_MAX + 1];      // 空串表示设备已删除（收到空的保留消息）
+    char state[HOME_MQTT_STATE_MAX + 1];    // 原始内容
+} home_mqtt_device_t;
+
+/** 统计信息 */
+typedef struct {
+    uint32_t connects;          // 连接成功次数
+    uint32_t wakeups;           // 其中熄屏时为发送而连接的次数
+    uint32_t batches;           // 发送批次数
+    uint32_t published;         // 发送的消息数
+    uint32_t queued;            // 当前队列中的消息数
+    uint32_t dropped;           // 队列满丢弃的消息数
+    uint32_t coalesced;         // 被同主题新值替换的消息数
+    uint32_t saves;             // 队列写入文件次数
+    uint32_t device_updates;    // 设备状态变化次数
+} home_mqtt_stats_t;
+
+/**
+ * 初始化，读取保存的队列，需在 LittleFS 挂载和 wifi_mgr_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t home_mqtt_init(void);
+
+/**
+ * 上报本机数据，主题为 <前缀>/clock-XXXXXX/<name>
+ * @param name 名称
+ * @param value 内容
+ * @param flags HOME_MQTT_F_*
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE，主题或内容过长返回 ESP_ERR_INVALID_SIZE
+ */
+esp_err_t home_mqtt_publish(const char *name, const char *value, uint32_t flags);
+
+/**
+ * 控制设备，立即发送；控制命令不适合延迟执行，未连接时不排队
+ * @param name 设备名称
+ * @param value 内容，如 "ON" / "OFF"
+ * @return esp_err_t 未连接返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t home_mqtt_device_set(const char *name, const char *value);
+
+/**
+ * 切换开关量设备
+ * @param slot 设备位置（home_mqtt_device_t.slot）
+ * @return esp_err_t 没有该设备或不是开关量返回 ESP_ERR_NOT_FOUND，其余同 home_mqtt_device_set()
+ */
+esp_err_t home_mqtt_device_toggle(uint8_t slot);
+
+/**
+ * 亮屏/熄屏，熄屏时发送完队列后断开连接
+ * @param on 是否亮屏
+ */
+void home_mqtt_set_screen_on(bool on);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void home_mqtt_get_stats(home_mqtt_stats_t *stats);
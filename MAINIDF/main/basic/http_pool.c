@@ -0,0 +1,664 @@
+/**
+ * @file http_pool.c
+ * @brief 共用的 HTTP 客户端实现
+ *
+ * 每个连接槽保存一个 esp_http_client 句柄。响应读完后不关闭，
+ * 下次对同一主机 esp_http_client_set_url() + esp_http_client_open() 时直接在原连接上发送请求；
+ * 服务器已关闭的连接在打开或读取响应头失败时重连一次。
+ * 连接槽、缓存和等待执行的请求只在 HTTP 任务中访问，统计信息由 s_mux 保护。
+ */
+
+#include "http_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_http_client.h"
+#include "esp_event.h"
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+#include "esp_crt_bundle.h"
+#endif
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "wifi_mgr.h"
+
+static const char *TAG = "http_pool";
+
+#define HTTP_TASK_STACK     8192    // TLS 握手在本任务栈上执行
+#define HTTP_TASK_PRIO      3
+#define HTTP_BUFFER_SIZE    1024
+#define READ_CHUNK          512
+#define ORIGIN_MAX          64
+#define ETAG_MAX            64
+#define DATE_MAX            32
+
+/* 连接槽 */
+typedef struct {
+    esp_http_client_handle_t client;
+    char origin[ORIGIN_MAX];
+    int64_t last_us;
+} slot_t;
+
+/* 缓存项，url 和 body 在 PSRAM 中 */
+typedef struct {
+    char *url;
+    uint8_t *body;
+    uint32_t len;
+    int64_t expires_us;         // 此前不发请求；0 表示每次都要验证
+    int64_t last_us;
+    char etag[ETAG_MAX];
+    char last_modified[DATE_MAX];
+} cache_entry_t;
+
+/* 从响应头中取得的信息 */
+typedef struct {
+    bool connected;             // 本次请求新建了连接
+    bool close;                 // 服务器要求关闭连接
+    bool no_store;
+    int32_t max_age;            // -1 表示没有
+    uint32_t header_bytes;
+    char etag[ETAG_MAX];
+    char last_modified[DATE_MAX];
+} resp_meta_t;
+
+/* 队列中的请求，url 为 NULL 表示关闭所有连接 */
+typedef struct {
+    char *url;
+    uint32_t flags;
+    int64_t deadline_us;
+    http_pool_body_cb_t on_body;
+    void *body_arg;
+    http_pool_done_cb_t on_done;
+    void *done_arg;
+} pool_req_t;
+
+/* 同步请求等待完成 */
+typedef struct {
+    SemaphoreHandle_t done;
+    esp_err_t err;
+    http_pool_result_t res;
+} sync_wait_t;
+
+static QueueHandle_t s_queue = NULL;
+static TaskHandle_t s_task = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;  // 保护 s_stats
+static http_pool_stats_t s_stats;
+
+/* 以下只在 HTTP 任务中访问 */
+static slot_t s_slots[HTTP_POOL_SLOTS];
+static cache_entry_t s_cache[HTTP_POOL_CACHE_ENTRIES];
+static uint32_t s_cache_used = 0;
+static pool_req_t s_pending[HTTP_POOL_QUEUE_LEN];
+static int s_pending_count = 0;
+static resp_meta_t s_meta;
+
+#define STAT_ADD(field, n) do {         \
+        taskENTER_CRITICAL(&s_mux);     \
+        s_stats.field += (n);           \
+        taskEXIT_CRITICAL(&s_mux);      \
+    } while (0)
+
+static void *psram_alloc(size_t size)
+{
+    void *p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : malloc(size);
+}
+
+// 取出 scheme://host:port 部分，没有路径时到 '?' 或 '#' 为止
+static bool url_origin(const char *url, char *out, size_t len)
+{
+    const char *p = strstr(url, "://");
+    if (!p) {
+        return false;
+    }
+    p += 3;
+    size_t n = (size_t)(p - url) + strcspn(p, "/?#");
+    if (n >= len) {
+        return false;
+    }
+    memcpy(out, url, n);
+    out[n] = '\0';
+    return true;
+}
+
+// 校验值被截断后无法使用，放不下时留空
+static void copy_str(char *dst, size_t len, const char *src)
+{
+    size_t n = strlen(src);
+    if (n < len) {
+        memcpy(dst, src, n + 1);
+    } else {
+        dst[0] = '\0';
+    }
+}
+
+static esp_err_t http_event_cb(esp_http_client_event_t *evt)
+{
+    if (evt->event_id == HTTP_EVENT_ON_CONNECTED) {
+        s_meta.connected = true;
+    } else if (evt->event_id == HTTP_EVENT_ON_HEADER) {
+        const char *key = evt->header_key;
+        const char *val = evt->header_value;
+        s_meta.header_bytes += strlen(key) + strlen(val) + 4;
+        if (strcasecmp(key, "ETag") == 0) {
+            copy_str(s_meta.etag, sizeof(s_meta.etag), val);
+        } else if (strcasecmp(key, "Last-Modified") == 0) {
+            copy_str(s_meta.last_modified, sizeof(s_meta.last_modified), val);
+        } else if (strcasecmp(key, "Connection") == 0) {
+            s_meta.close = strcasecmp(val, "close") == 0;
+        } else if (strcasecmp(key, "Cache-Control") == 0) {
+            const char *age = strstr(val, "max-age=");
+            if (strstr(val, "no-store")) {
+                s_meta.no_store = true;
+            }
+            if (strstr(val, "no-cache")) {
+                s_meta.max_age = 0;
+            } else if (age) {
+                s_meta.max_age = atoi(age + 8);
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+/* ---------- 连接槽 ---------- */
+
+static void slot_free(slot_t *s)
+{
+    if (s->client) {
+        esp_http_client_cleanup(s->client);
+        s->client = NULL;
+    }
+    s->origin[0] = '\0';
+}
+
+// 取得 url 所在主机的连接，没有时新建（替换最久未用的）
+static slot_t *slot_get(const char *url, bool *reused)
+{
+    char origin[ORIGIN_MAX];
+    slot_t *slot = &s_slots[0];
+
+    if (!url_origin(url, origin, sizeof(origin))) {
+        return NULL;
+    }
+    for (int i = 0; i < HTTP_POOL_SLOTS; i++) {
+        if (s_slots[i].client && strcmp(s_slots[i].origin, origin) == 0) {
+            *reused = true;
+            esp_http_client_set_url(s_slots[i].client, url);
+            return &s_slots[i];
+        }
+        if (!s_slots[i].client) {
+            slot = &s_slots[i];
+        } else if (slot->client && s_slots[i].last_us < slot->last_us) {
+            slot = &s_slots[i];
+        }
+    }
+
+    slot_free(slot);
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .timeout_ms = HTTP_POOL_TIMEOUT_MS,
+        .buffer_size = HTTP_BUFFER_SIZE,
+        .keep_alive_enable = true,
+        .event_handler = http_event_cb,
+#if CONFIG_MBEDTLS_CERTIFICATE_BUNDLE
+        .crt_bundle_attach = esp_crt_bundle_attach,
+#endif
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        .save_client_session = true,
+#endif
+    };
+    slot->client = esp_http_client_init(&cfg);
+    if (!slot->client) {
+        return NULL;
+    }
+    strcpy(slot->origin, origin);
+    *reused = false;
+    return slot;
+}
+
+static void close_all(void)
+{
+    for (int i = 0; i < HTTP_POOL_SLOTS; i++) {
+        slot_free(&s_slots[i]);
+    }
+}
+
+static void close_idle(void)
+{
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < HTTP_POOL_SLOTS; i++) {
+        if (s_slots[i].client && now - s_slots[i].last_us >= HTTP_POOL_IDLE_MS * 1000LL) {
+            ESP_LOGD(TAG, "Close idle %s", s_slots[i].origin);
+            slot_free(&s_slots[i]);
+        }
+    }
+}
+
+/* ---------- 缓存 ---------- */
+
+static cache_entry_t *cache_find(const char *url)
+{
+    for (int i = 0; i < HTTP_POOL_CACHE_ENTRIES; i++) {
+        if (s_cache[i].url && strcmp(s_cache[i].url, url) == 0) {
+            return &s_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static void cache_drop(cache_entry_t *e)
+{
+    s_cache_used -= e->len;
+    free(e->url);
+    free(e->body);
+    memset(e, 0, sizeof(*e));
+}
+
+// 最久未用的缓存项，only_used 为 false 时优先返回空项
+static cache_entry_t *cache_lru(bool only_used)
+{
+    cache_entry_t *lru = NULL;
+    for (int i = 0; i < HTTP_POOL_CACHE_ENTRIES; i++) {
+        if (!s_cache[i].url) {
+            if (!only_used) {
+                return &s_cache[i];
+            }
+        } else if (!lru || s_cache[i].last_us < lru->last_us) {
+            lru = &s_cache[i];
+        }
+    }
+    return lru;
+}
+
+// 保存响应体，body 的所有权转给缓存
+static void cache_store(const char *url, uint8_t *body, uint32_t len)
+{
+    cache_entry_t *e = cache_find(url);
+    if (e) {
+        cache_drop(e);
+    }
+    // 按最近使用淘汰，直到放得下
+    while (s_cache_used + len > HTTP_POOL_CACHE_BYTES && (e = cache_lru(true)) != NULL) {
+        cache_drop(e);
+    }
+    e = cache_lru(false);
+    if (e->url) {
+        cache_drop(e);
+    }
+
+    e->url = psram_alloc(strlen(url) + 1);
+    if (!e->url) {
+        free(body);
+        return;
+    }
+    strcpy(e->url, url);
+    e->body = body;
+    e->len = len;
+    e->last_us = esp_timer_get_time();
+    e->expires_us = s_meta.max_age > 0 ? e->last_us + s_meta.max_age * 1000000LL : 0;
+    strcpy(e->etag, s_meta.etag);
+    strcpy(e->last_modified, s_meta.last_modified);
+    s_cache_used += len;
+}
+
+static esp_err_t cache_replay(const cache_entry_t *e, const pool_req_t *req)
+{
+    // 分块回调，与网络读取时的行为一致
+    for (uint32_t off = 0; off < e->len; off += READ_CHUNK) {
+        uint32_t n = e->len - off < READ_CHUNK ? e->len - off : READ_CHUNK;
+        esp_err_t err = req->on_body((const char *)e->body + off, n, req->body_arg);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    STAT_ADD(saved_bytes, e->len);
+    return ESP_OK;
+}
+
+/* ---------- 执行请求 ---------- */
+
+// 发送请求并读取响应头；复用的连接已被服务器关闭时重连一次
+static esp_err_t open_request(slot_t *slot, bool reused, int64_t *content_len)
+{
+    for (int attempt = 0; attempt < 2; attempt++) {
+        memset(&s_meta, 0, sizeof(s_meta));
+        s_meta.max_age = -1;
+        esp_err_t err = esp_http_client_open(slot->client, 0);
+        if (err == ESP_OK) {
+            *content_len = esp_http_client_fetch_headers(slot->client);
+            if (*content_len >= 0) {
+                return ESP_OK;
+            }
+            err = ESP_FAIL;
+        }
+        esp_http_client_close(slot->client);
+        if (!reused || s_meta.connected) {
+            return err;
+        }
+        ESP_LOGD(TAG, "Stale connection to %s, reconnect", slot->origin);
+    }
+    return ESP_FAIL;
+}
+
+static esp_err_t execute(const pool_req_t *req, http_pool_result_t *res)
+{
+    int64_t t0 = esp_timer_get_time();
+    cache_entry_t *entry = (req->flags & HTTP_POOL_F_CACHE) ? cache_find(req->url) : NULL;
+
+    memset(res, 0, sizeof(*res));
+    if (entry && entry->expires_us > t0) {
+        res->status = 200;
+        res->from_cache = true;
+        entry->last_us = t0;
+        STAT_ADD(cache_fresh, 1);
+        return cache_replay(entry, req);
+    }
+
+    bool reused = false;
+    slot_t *slot = slot_get(req->url, &reused);
+    if (!slot) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_http_client_handle_t client = slot->client;
+
+    // 条件请求头，上一次请求留下的先删除
+    esp_http_client_set_method(client, HTTP_METHOD_GET);
+    esp_http_client_delete_header(client, "If-None-Match");
+    esp_http_client_delete_header(client, "If-Modified-Since");
+    if (entry && entry->etag[0]) {
+        esp_http_client_set_header(client, "If-None-Match", entry->etag);
+    }
+    if (entry && entry->last_modified[0]) {
+        esp_http_client_set_header(client, "If-Modified-Since", entry->last_modified);
+    }
+
+    int64_t content_len = 0;
+    esp_err_t err = open_request(slot, reused, &content_len);
+    res->reused = !s_meta.connected;
+    if (s_meta.connected) {
+        STAT_ADD(handshakes, 1);
+    } else {
+        STAT_ADD(reuses, 1);
+    }
+    if (err != ESP_OK) {
+        slot_free(slot);
+        return err;
+    }
+
+    res->status = esp_http_client_get_status_code(client);
+    uint32_t rx = s_meta.header_bytes;
+
+    if (res->status == 304 && entry) {
+        STAT_ADD(not_modified, 1);
+        res->status = 200;
+        res->from_cache = true;
+        entry->last_us = esp_timer_get_time();
+        if (s_meta.max_age > 0) {
+            entry->expires_us = entry->last_us + s_meta.max_age * 1000000LL;
+        }
+        int flushed = 0;
+        esp_http_client_flush_response(client, &flushed);
+        err = cache_replay(entry, req);
+    } else if (res->status >= 200 && res->status < 300) {
+        // 有校验信息或有效期的小响应边读边保存
+        bool cacheable = (req->flags & HTTP_POOL_F_CACHE) && !s_meta.no_store &&
+                         (s_meta.etag[0] || s_meta.last_modified[0] || s_meta.max_age > 0) &&
+                         content_len <= HTTP_POOL_CACHE_MAX_BODY;
+        uint32_t cap = content_len > 0 ? (uint32_t)content_len : HTTP_POOL_CACHE_MAX_BODY;
+        uint8_t *capture = cacheable ? psram_alloc(cap) : NULL;
+        char buf[READ_CHUNK];
+        int n;
+
+        while ((n = esp_http_client_read(client, buf, sizeof(buf))) > 0) {
+            res->bytes += n;
+            if (capture && res->bytes <= cap) {
+                memcpy(capture + res->bytes - n, buf, n);
+            }
+            err = req->on_body(buf, n, req->body_arg);
+            if (err != ESP_OK) {
+                break;
+            }
+        }
+        if (n < 0) {
+            err = ESP_FAIL;
+        }
+        if (err == ESP_OK && !esp_http_client_is_complete_data_received(client)) {
+            err = ESP_ERR_INVALID_SIZE;
+        }
+        if (capture && err == ESP_OK && res->bytes <= cap) {
+            cache_store(req->url, capture, res->bytes);
+        } else {
+            free(capture);
+        }
+        rx += res->bytes;
+    } else {
+        ESP_LOGW(TAG, "HTTP %d for %s", res->status, req->url);
+        int flushed = 0;
+        esp_http_client_flush_response(client, &flushed);
+        rx += flushed;
+        err = ESP_ERR_INVALID_RESPONSE;
+    }
+    STAT_ADD(rx_bytes, rx);
+
+    // 响应没有读完或服务器要求关闭时不能复用
+    if (err != ESP_OK && err != ESP_ERR_INVALID_RESPONSE) {
+        esp_http_client_close(client);
+    } else if (s_meta.close) {
+        esp_http_client_close(client);
+    }
+    slot->last_us = esp_timer_get_time();
+    res->elapsed_ms = (slot->last_us - t0) / 1000;
+    return err;
+}
+
+static void run(pool_req_t *req)
+{
+    http_pool_result_t res;
+    esp_err_t err = execute(req, &res);
+
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.requests++;
+    s_stats.failures += err != ESP_OK;
+    s_stats.cache_used = s_cache_used;
+    taskEXIT_CRITICAL(&s_mux);
+
+    ESP_LOGD(TAG, "GET %s: %s, HTTP %d, %lu bytes, %lu ms%s%s", req->url, esp_err_to_name(err), res.status,
+             (unsigned long)res.bytes, (unsigned long)res.elapsed_ms, res.reused ? ", reused" : "",
+             res.from_cache ? ", cached" : "");
+    if (req->on_done) {
+        req->on_done(err, &res, req->done_arg);
+    }
+    free(req->url);
+}
+
+/* ---------- 任务 ---------- */
+
+static bool batch_due(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    if (s_pending_count == HTTP_POOL_QUEUE_LEN) {
+        return true;
+    }
+    for (int i = 0; i < s_pending_count; i++) {
+        if (!(s_pending[i].flags & HTTP_POOL_F_DEFER) || s_pending[i].deadline_us <= now) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 本批执行所有已提交的请求，包括还可以推迟的
+static void run_batch(void)
+{
+    pool_req_t req;
+
+    while (s_pending_count < HTTP_POOL_QUEUE_LEN && xQueueReceive(s_queue, &req, 0) == pdTRUE) {
+        if (req.url) {
+            s_pending[s_pending_count++] = req;
+        } else {
+            close_all();
+        }
+    }
+    for (int i = 0; i < s_pending_count; i++) {
+        run(&s_pending[i]);
+    }
+    ESP_LOGD(TAG, "Batch of %d", s_pending_count);
+    s_pending_count = 0;
+    STAT_ADD(batches, 1);
+}
+
+static TickType_t next_wait(void)
+{
+    int64_t deadline = INT64_MAX;
+
+    for (int i = 0; i < s_pending_count; i++) {
+        if (s_pending[i].deadline_us < deadline) {
+            deadline = s_pending[i].deadline_us;
+        }
+    }
+    for (int i = 0; i < HTTP_POOL_SLOTS; i++) {
+        if (s_slots[i].client && s_slots[i].last_us + HTTP_POOL_IDLE_MS * 1000LL < deadline) {
+            deadline = s_slots[i].last_us + HTTP_POOL_IDLE_MS * 1000LL;
+        }
+    }
+    if (deadline == INT64_MAX) {
+        return portMAX_DELAY;
+    }
+    int64_t now = esp_timer_get_time();
+    return deadline <= now ? 0 : pdMS_TO_TICKS((deadline - now) / 1000) + 1;
+}
+
+static void http_pool_task(void *arg)
+{
+    pool_req_t req;
+
+    while (1) {
+        if (s_pending_count < HTTP_POOL_QUEUE_LEN && xQueueReceive(s_queue, &req, next_wait()) == pdTRUE) {
+            if (req.url) {
+                s_pending[s_pending_count++] = req;
+            } else {
+                close_all();
+            }
+        }
+        if (batch_due()) {
+            run_batch();
+        }
+        close_idle();
+    }
+}
+
+static void wifi_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    pool_req_t req = {0};
+    xQueueSend(s_queue, &req, pdMS_TO_TICKS(100));
+}
+
+esp_err_t http_pool_init(void)
+{
+    if (s_queue) {
+        return ESP_OK;
+    }
+
+    s_queue = xQueueCreate(HTTP_POOL_QUEUE_LEN, sizeof(pool_req_t));
+    if (!s_queue) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(http_pool_task, "http", HTTP_TASK_STACK, NULL, HTTP_TASK_PRIO, &s_task) != pdPASS) {
+        vQueueDelete(s_queue);
+        s_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_DISCONNECTED, wifi_event_cb, NULL);
+    return ESP_OK;
+}
+
+esp_err_t http_pool_submit(const http_pool_req_t *req)
+{
+    if (!s_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    pool_req_t item = {
+        .url = strdup(req->url),
+        .flags = req->flags,
+        .deadline_us = esp_timer_get_time() +
+                       ((req->flags & HTTP_POOL_F_DEFER) ? req->defer_ms * 1000LL : 0),
+        .on_body = req->on_body,
+        .body_arg = req->body_arg,
+        .on_done = req->on_done,
+        .done_arg = req->done_arg,
+    };
+    if (!item.url) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xQueueSend(s_queue, &item, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        free(item.url);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+static void sync_done(esp_err_t err, const http_pool_result_t *res, void *arg)
+{
+    sync_wait_t *w = arg;
+    w->err = err;
+    w->res = *res;
+    xSemaphoreGive(w->done);
+}
+
+esp_err_t http_pool_get(const char *url, uint32_t flags, http_pool_body_cb_t on_body, void *arg,
+                        http_pool_result_t *res)
+{
+    if (!s_queue || xTaskGetCurrentTaskHandle() == s_task) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    StaticSemaphore_t sem_buf;
+    sync_wait_t w = {
+        .done = xSemaphoreCreateBinaryStatic(&sem_buf),
+    };
+    http_pool_req_t req = {
+        .url = url,
+        .flags = flags & ~HTTP_POOL_F_DEFER,
+        .on_body = on_body,
+        .body_arg = arg,
+        .on_done = sync_done,
+        .done_arg = &w,
+    };
+    esp_err_t err = http_pool_submit(&req);
+    if (err == ESP_OK) {
+        xSemaphoreTake(w.done, portMAX_DELAY);
+        err = w.err;
+        if (res) {
+            *res = w.res;
+        }
+    }
+    vSemaphoreDelete(w.done);
+    return err;
+}
+
+void http_pool_get_stats(http_pool_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+}
+
+void http_pool_report(void)
+{
+    http_pool_stats_t st;
+    http_pool_get_stats(&st);
+    ESP_LOGI(TAG, "%lu requests (%lu failed) in %lu batches, %lu handshakes, %lu reused",
+             (unsigned long)st.requests, (unsigned long)st.failures, (unsigned long)st.batches,
+             (unsigned long)st.handshakes, (unsigned long)st.reuses);
+    ESP_LOGI(TAG, "Cache: %lu fresh, %lu not modified, %lu bytes used; rx %llu bytes, saved %llu bytes",
+             (unsigned long)st.cache_fresh, (unsigned long)st.not_modified, (unsigned long)st.cache_used,
+             (unsigned long long)st.rx_bytes, (unsigned long long)st.saved_bytes);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file http_pool.h
+ * @brief 共用的 HTTP 客户端
+ *
+ * 所有 HTTP(S) 请求由一个任务串行执行，各服务不再各自建立连接：
+ * - 按 scheme://host:port 保持长连接（最多 HTTP_POOL_SLOTS 个），空闲 HTTP_POOL_IDLE_MS 后关闭；
+ *   HTTPS 使用证书包校验，并保存 TLS 会话，重连时恢复会话、省去完整握手
+ * - 带 HTTP_POOL_F_CACHE 的请求保存响应的 ETag / Last-Modified，之后发送条件请求，
+ *   304 时由缓存提供内容；Cache-Control: max-age 未过期时不发请求。缓存放在 PSRAM，
+ *   总大小 HTTP_POOL_CACHE_BYTES，按最近使用淘汰
+ * - 带 HTTP_POOL_F_DEFER 的请求最多推迟 defer_ms，期间有其他请求时一起执行，
+ *   同一批请求在一次唤醒中连续完成，射频集中工作
+ * - 响应体按块回调，不缓存整个响应（需要缓存的小响应除外）
+ *
+ * WLAN 断开时关闭所有连接。回调在 HTTP 任务中执行，不能在回调中调用 http_pool_get()。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define HTTP_POOL_SLOTS             3                   // 同时保持的连接数
+#define HTTP_POOL_IDLE_MS           15000               // 空闲连接保持时间
+#define HTTP_POOL_TIMEOUT_MS        10000               // 单个请求的网络超时
+#define HTTP_POOL_QUEUE_LEN         8                   // 等待执行的请求数上限
+#define HTTP_POOL_CACHE_BYTES       (64 * 1024)         // 响应缓存总大小
+#define HTTP_POOL_CACHE_ENTRIES     8
+#define HTTP_POOL_CACHE_MAX_BODY    (16 * 1024)         // 超过此大小的响应不缓存
+
+/* 请求选项 */
+#define HTTP_POOL_F_CACHE   0x01    // 可缓存：保存响应，之后发送条件请求
+#define HTTP_POOL_F_DEFER   0x02    // 可推迟：与其他请求合并执行，最多推迟 defer_ms
+
+/** 请求结果 */
+typedef struct {
+    int status;                 // HTTP 状态码，内容来自缓存时为 200，连接失败为 0
+    bool from_cache;            // 内容来自缓存（未过期或服务器返回 304）
+    bool reused;                // 复用了已有连接
+    uint32_t bytes;             // 经网络收到的响应体字节数
+    uint32_t elapsed_ms;        // 执行耗时（不含排队和推迟时间）
+} http_pool_result_t;
+
+/**
+ * 响应体回调，按顺序收到整个响应体
+ * @return esp_err_t 返回非 ESP_OK 时中止请求，该值作为请求结果
+ */
+typedef esp_err_t (*http_pool_body_cb_t)(const char *data, size_t len, void *arg);
+
+/**
+ * 请求完成回调
+ * @param err 结果：ESP_OK；连接或读取失败；非 2xx 状态返回 ESP_ERR_INVALID_RESPONSE；或响应体回调返回的错误
+ * @param res 详细结果
+ * @param arg 用户参数
+ */
+typedef void (*http_pool_done_cb_t)(esp_err_t err, const http_pool_result_t *res, void *arg);
+
+/** 异步请求 */
+typedef struct {
+    const char *url;            // 提交时复制
+    uint32_t flags;             // HTTP_POOL_F_*
+    uint32_t defer_ms;          // HTTP_POOL_F_DEFER 时最多推迟的时间
+    http_pool_body_cb_t on_body;
+    void *body_arg;
+    http_pool_done_cb_t on_done;    // 可为NULL
+    void *done_arg;
+} http_pool_req_t;
+
+/** 统计信息 */
+typedef struct {
+    uint32_t requests;          // 执行的请求数
+    uint32_t failures;          // 失败数
+    uint32_t handshakes;        // 新建连接数（TCP 连接，HTTPS 含 TLS 握手）
+    uint32_t reuses;            // 复用已有连接的请求数
+    uint32_t cache_fresh;       // 缓存未过期、没有发送请求的次数
+    uint32_t not_modified;      // 条件请求返回 304 的次数
+    uint32_t batches;           // 执行批次数
+    uint32_t cache_used;        // 缓存占用的字节数
+    uint64_t rx_bytes;          // 经网络收到的响应头和响应体字节数（不含 TLS 开销）
+    uint64_t saved_bytes;       // 由缓存提供、没有经网络传输的响应体字节数
+} http_pool_stats_t;
+
+/**
+ * 初始化，创建 HTTP 任务，需在 wifi_mgr_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t http_pool_init(void);
+
+/**
+ * 提交异步请求（GET）
+ * @param req 请求
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE，队列满返回 ESP_ERR_TIMEOUT
+ */
+esp_err_t http_pool_submit(const http_pool_req_t *req);
+
+/**
+ * 同步请求（GET），等待执行完成
+ * @param url 地址
+ * @param flags HTTP_POOL_F_CACHE，不能推迟
+ * @param on_body 响应体回调，在 HTTP 任务中执行
+ * @param arg 回调参数
+ * @param res 输出结果，可为NULL
+ * @return esp_err_t 同 http_pool_done_cb_t 的 err；在 HTTP 任务中调用返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t http_pool_get(const char *url, uint32_t flags, http_pool_body_cb_t on_body, void *arg,
+                        http_pool_result_t *res);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void http_pool_get_stats(http_pool_stats_t *stats);
+
+/**
+ * 输出统计信息到日志
+ */
+void http_pool_report(void);
@@ -24,6 +24,22 @@ esp_err_t bsp_i2c_init(void)
 /***********************************************************/
 /****************    LCD显示屏 ↓   *************************/
 
+static volatile bool s_bl_fading = false; // 渐变进行中，由渐变结束中断清除
+static lcd_bl_fade_cb_t s_bl_fade_cb = NULL;
+static void *s_bl_fade_arg = NULL;
+
+// 渐变结束（中断中执行）；被 ledc_fade_stop 打断的渐变不一定回调，调用方应以 duty 判断是哪次渐变
+static bool bsp_display_fade_end_isr(const ledc_cb_param_t *param, void *user_arg)
+{
+    if (param->event != LEDC_FADE_END_EVT)
+    {
+        return false;
+    }
+    s_bl_fading = false;
+    lcd_bl_fade_cb_t cb = s_bl_fade_cb;
+    return cb ? cb(param->duty, s_bl_fade_arg) : false;
+}
+
 // 背光PWM初始化
 esp_err_t bsp_display_brightness_init(void)
 {
@@ -48,9 +64,57 @@ esp_err_t bsp_display_brightness_init(void)
     ESP_ERROR_CHECK(ledc_channel_config(&LCD_backlight_channel));
 
     // 安装LEDC渐变功能，这个函数会占用LEDC模块的中断
-    ESP_ERROR_CHECK(ledc_fade_func_install(0));
+    // 蜂鸣器驱动也使用渐变功能，先初始化的一方负责安装
+    esp_err_t ret = ledc_fade_func_install(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+    {
+        ESP_ERROR_CHECK(ret);
+    }
 
-    return ESP_OK;
+    // 渐变结束回调按通道注册，与蜂鸣器互不影响
+    ledc_cbs_t cbs = {.fade_cb = bsp_display_fade_end_isr};
+    return ledc_cb_register(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH, &cbs, NULL);
+}
+
+/*
+ * 亮度曲线：人眼感受的亮度与占空比不成线性，低亮度段线性映射会明显偏亮、高亮度段变化不明显。
+ * CIE 1931 明度公式把百分比当作明度 L*（0~100）换算为相对亮度 Y，表格在编译期由常量表达式生成。
+ */
+#define LCD_CIE_Y(l) ((l) <= 8 ? (l) / 903.3 : (((l) + 16.0) / 116.0) * (((l) + 16.0) / 116.0) * (((l) + 16.0) / 116.0))
+#define LCD_CIE_DUTY(l) ((uint16_t)(LCD_CIE_Y(l) * LCD_BL_DUTY_MAX + 0.5))
+#define LCD_CIE_ROW(t) LCD_CIE_DUTY(t + 0), LCD_CIE_DUTY(t + 1), LCD_CIE_DUTY(t + 2), LCD_CIE_DUTY(t + 3), LCD_CIE_DUTY(t + 4), \
+                       LCD_CIE_DUTY(t + 5), LCD_CIE_DUTY(t + 6), LCD_CIE_DUTY(t + 7), LCD_CIE_DUTY(t + 8), LCD_CIE_DUTY(t + 9)
+
+static const uint16_t s_cie_duty[101] = {
+    LCD_CIE_ROW(0), LCD_CIE_ROW(10), LCD_CIE_ROW(20), LCD_CIE_ROW(30), LCD_CIE_ROW(40),
+    LCD_CIE_ROW(50), LCD_CIE_ROW(60), LCD_CIE_ROW(70), LCD_CIE_ROW(80), LCD_CIE_ROW(90),
+    LCD_CIE_DUTY(100)};
+
+static lcd_bl_curve_t s_bl_curve = LCD_BL_CURVE_CIE1931;
+static uint32_t s_bl_min_duty = LCD_BL_MIN_DUTY;
+
+// 设置亮度曲线和最低占空比
+void bsp_display_brightness_curve(lcd_bl_curve_t curve, uint32_t min_duty)
+{
+    s_bl_curve = curve;
+    s_bl_min_duty = min_duty < LCD_BL_DUTY_MAX ? min_duty : LCD_BL_DUTY_MAX;
+}
+
+// 亮度百分比换算为占空比：0 为关闭，1~100 按曲线映射到 [最低占空比, 最大占空比]
+uint32_t bsp_display_brightness_duty(int brightness_percent)
+{
+    if (brightness_percent <= 0)
+    {
+        return 0;
+    }
+    if (brightness_percent > 100)
+    {
+        brightness_percent = 100;
+    }
+
+    uint32_t duty = s_bl_curve == LCD_BL_CURVE_LINEAR ? (LCD_BL_DUTY_MAX * brightness_percent) / 100
+                                                      : s_cie_duty[brightness_percent];
+    return s_bl_min_duty + duty * (LCD_BL_DUTY_MAX - s_bl_min_duty) / LCD_BL_DUTY_MAX;
 }
 
 // 背光亮度设置（立即生效）
@@ -65,16 +129,32 @@ esp_err_t bsp_display_brightness_set(int brightness_percent)
         brightness_percent = 0;
     }
 
-    ESP_LOGI(TAG, "Setting LCD backlight: %d%%", brightness_percent);
-    // LEDC resolution set to 10bits, thus: 100% = 1023
-    uint32_t duty_cycle = (1023 * brightness_percent) / 100;
+    uint32_t duty_cycle = bsp_display_brightness_duty(brightness_percent);
+    ESP_LOGI(TAG, "Setting LCD backlight: %d%% (duty %lu)", brightness_percent, (unsigned long)duty_cycle);
     ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH, duty_cycle));
     ESP_ERROR_CHECK(ledc_update_duty(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH));
 
     return ESP_OK;
 }
 
-// 背光亮度渐变设置（平滑过渡）
+// 注册渐变结束回调（中断中调用）
+void bsp_display_brightness_fade_cb(lcd_bl_fade_cb_t cb, void *arg)
+{
+    s_bl_fade_arg = arg;
+    s_bl_fade_cb = cb;
+}
+
+// 当前占空比（渐变中为渐变到的位置）
+uint32_t bsp_display_brightness_get_duty(void)
+{
+    return ledc_get_duty(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH);
+}
+
+/*
+ * 背光亮度渐变设置（平滑过渡，不阻塞）
+ * 正在渐变时先停在当前占空比，再从这里渐变到新目标，亮度不会跳变；
+ * 渐变结束时调用 bsp_display_brightness_fade_cb() 注册的回调
+ */
 esp_err_t bsp_display_brightness_fade(int target_brightness_percent, int fade_time_ms)
 {
     if (fade_time_ms <= 0)
@@ -91,27 +171,40 @@ esp_err_t bsp_display_brightness_fade(int target_brightness_percent, int fade_ti
         target_brightness_percent = 0;
     }
 
-    ESP_LOGI(TAG, "Fading LCD backlight to: %d%% over %dms", target_brightness_percent, fade_time_ms);
+    // 按亮度曲线计算目标占空比
+    uint32_t target_duty = bsp_display_brightness_duty(target_brightness_percent);
 
-    // 计算目标占空比 (10位分辨率 = 1023)
-    uint32_t target_duty = (1023 * target_brightness_percent) / 100;
+    // 打断进行中的渐变，占空比保持在停止时的位置
+    if (s_bl_fading)
+    {
+        ESP_RETURN_ON_ERROR(ledc_fade_stop(LEDC_LOW_SPEED_MODE, LCD_LEDC_CH), TAG, "Fade stop failed");
+    }
+    ESP_LOGD(TAG, "Fading LCD backlight: duty %lu -> %lu (%d%%) over %dms",
+             (unsigned long)bsp_display_brightness_get_duty(), (unsigned long)target_duty,
+             target_brightness_percent, fade_time_ms);
 
     // 设置渐变参数
-    ESP_ERROR_CHECK(ledc_set_fade_with_time(
-        LEDC_LOW_SPEED_MODE, // speed_mode
-        LCD_LEDC_CH,         // channel
-        target_duty,         // target_duty
-        fade_time_ms         // max_fade_time_ms
-        ));
+    ESP_RETURN_ON_ERROR(ledc_set_fade_with_time(
+                            LEDC_LOW_SPEED_MODE, // speed_mode
+                            LCD_LEDC_CH,         // channel
+                            target_duty,         // target_duty
+                            fade_time_ms         // max_fade_time_ms
+                            ),
+                        TAG, "Fade setup failed");
 
     // 启动渐变
-    ESP_ERROR_CHECK(ledc_fade_start(
+    s_bl_fading = true;
+    esp_err_t ret = ledc_fade_start(
         LEDC_LOW_SPEED_MODE, // speed_mode
         LCD_LEDC_CH,         // channel
         LCD_FADE_MODE        // fade_mode
-        ));
-
-    return ESP_OK;
+    );
+    if (ret != ESP_OK)
+    {
+        s_bl_fading = false;
+        ESP_LOGE(TAG, "Fade start failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
 }
 
 // 关闭背光
@@ -205,13 +298,75 @@ esp_err_t bsp_lcd_init(void)
     return ret;
 }
 
+// 液晶屏初始化并打开显示（背光保持原状态，由调用方在画面就绪后打开）
+esp_err_t bsp_display_start(void)
+{
+    if (panel_handle)
+    {
+        return ESP_OK; // 已由启动画面提前初始化
+    }
+
+    ESP_RETURN_ON_ERROR(bsp_display_new(), TAG, "Display init failed"); // 液晶屏驱动初始化
+    return esp_lcd_panel_disp_on_off(panel_handle, true);              // 打开液晶屏显示
+}
+
+/*
+ * 熄屏休眠：暂停LVGL（停止节拍，界面不再刷新，触摸不响应），再关闭显示并让驱动芯片进入睡眠
+ * 唤醒顺序相反，唤醒后整屏重绘一次；应在背光已关闭时调用
+ */
+esp_err_t bsp_display_sleep(bool sleep)
+{
+    if (!panel_handle)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret;
+    if (sleep)
+    {
+        if (disp)
+        {
+            lvgl_port_stop();
+        }
+        esp_lcd_panel_disp_on_off(panel_handle, false);
+        ret = esp_lcd_panel_disp_sleep(panel_handle, true);
+    }
+    else
+    {
+        ret = esp_lcd_panel_disp_sleep(panel_handle, false);
+        esp_lcd_panel_disp_on_off(panel_handle, true);
+        if (disp)
+        {
+            lvgl_port_resume();
+            if (lvgl_port_lock(0))
+            {
+                lv_obj_invalidate(lv_scr_act());
+                lvgl_port_unlock();
+            }
+        }
+    }
+    return ret;
+}
+
+esp_lcd_panel_handle_t bsp_display_get_panel(void)
+{
+    return panel_handle;
+}
+
+esp_lcd_panel_io_handle_t bsp_display_get_io(void)
+{
+    return io_handle;
+}
+
 // 液晶屏初始化+添加LVGL接口
 static lv_disp_t *bsp_display_lcd_init(void)
 {
-    /* 初始化液晶屏 */
-    bsp_display_new();                             // 液晶屏驱动初始化
-    lcd_set_color(0xffff);                         // 设置整屏背景白色
-    esp_lcd_panel_disp_on_off(panel_handle, true); // 打开液晶屏显示
+    /* 初始化液晶屏，已显示启动画面时跳过，避免白屏闪烁 */
+    if (!panel_handle)
+    {
+        bsp_display_start();
+        lcd_set_color(0x0000); // 设置整屏背景黑色
+    }
 
     /* 液晶屏添加LVGL接口 */
     ESP_LOGD(TAG, "Add LCD screen");
@@ -281,18 +436,31 @@ static lv_indev_t *bsp_display_indev_init(lv_disp_t *disp)
     return lvgl_port_add_touch(&touch_cfg);
 }
 
-// 开发板显示初始化
-void bsp_lvgl_start(void)
+// 初始化LVGL
+void bsp_lvgl_init(void)
 {
-    /* 初始化LVGL */
     lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
     lvgl_port_init(&lvgl_cfg);
+}
 
+// 液晶屏和触摸屏添加LVGL接口
+void bsp_lvgl_add_display(void)
+{
     /* 初始化液晶屏 并添加LVGL接口 */
     disp = bsp_display_lcd_init();
 
     /* 初始化触摸屏 并添加LVGL接口 */
     disp_indev = bsp_display_indev_init(disp);
+}
+
+// 开发板显示初始化
+void bsp_lvgl_start(void)
+{
+    /* 初始化LVGL */
+    bsp_lvgl_init();
+
+    /* 添加液晶屏和触摸屏 */
+    bsp_lvgl_add_display();
 
     /* 打开液晶屏背光 */
     bsp_display_backlight_on();
@@ -52,15 +52,37 @@ esp_err_t bsp_i2c_init(void); // 初始化I2C接口
 
 #define LCD_FADE_TIME_MS 500            // 默认渐变时间500ms
 #define LCD_FADE_MODE LEDC_FADE_NO_WAIT // 非阻塞模式
+#define LCD_BL_DUTY_MAX 1023            // 10位分辨率的最大占空比
+#define LCD_BL_MIN_DUTY 8               // 默认最低占空比，背光LED低于此值会闪烁或不亮
+
+// 亮度曲线
+typedef enum
+{
+    LCD_BL_CURVE_LINEAR = 0,  // 占空比与百分比成正比
+    LCD_BL_CURVE_CIE1931 = 1, // 按 CIE 1931 明度换算，感受上均匀
+} lcd_bl_curve_t;
+
+// 背光渐变结束回调，在中断中执行；duty 为结束时的占空比，返回是否唤醒了更高优先级的任务
+typedef bool (*lcd_bl_fade_cb_t)(uint32_t duty, void *arg);
 
 esp_err_t bsp_display_brightness_init(void);
+void bsp_display_brightness_curve(lcd_bl_curve_t curve, uint32_t min_duty);
+uint32_t bsp_display_brightness_duty(int brightness_percent);
 esp_err_t bsp_display_brightness_set(int brightness_percent);
 esp_err_t bsp_display_brightness_fade(int target_brightness_percent, int fade_time_ms);
+void bsp_display_brightness_fade_cb(lcd_bl_fade_cb_t cb, void *arg);
+uint32_t bsp_display_brightness_get_duty(void);
+esp_err_t bsp_display_sleep(bool sleep);
 esp_err_t bsp_display_backlight_off(void);
 esp_err_t bsp_display_backlight_on(void);
 esp_err_t bsp_lcd_init(void);
+esp_err_t bsp_display_start(void);
+esp_lcd_panel_handle_t bsp_display_get_panel(void);
+esp_lcd_panel_io_handle_t bsp_display_get_io(void);
 void lcd_set_color(uint16_t color);
 void lcd_draw_pictrue(int x_start, int y_start, int x_end, int y_end, const unsigned char *gImage);
+void bsp_lvgl_init(void);
+void bsp_lvgl_add_display(void);
 void bsp_lvgl_start(void);
 /***************    LCD显示屏 ↑   *************************/
 /***********************************************************/
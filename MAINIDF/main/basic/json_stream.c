@@ -0,0 +1,401 @@
+/**
+ * @file json_stream.c
+ * @brief 流式 JSON 解析实现
+ *
+ * 逐字节状态机。数字和 true/false/null 在遇到第一个不属于它们的字符时结束，
+ * 该字符随后按新状态重新处理；数字只检查字符集，不严格校验格式。
+ */
+
+#include "json_stream.h"
+#include <string.h>
+
+enum {
+    ST_VALUE,       // 等待值
+    ST_OBJ_FIRST,   // '{' 之后：键名或 '}'
+    ST_OBJ_KEY,     // ',' 之后：键名
+    ST_COLON,       // 键名之后
+    ST_ARR_FIRST,   // '[' 之后：值或 ']'
+    ST_AFTER,       // 值之后：',' 或结束符
+    ST_STRING,
+    ST_ESCAPE,
+    ST_UNICODE,
+    ST_NUMBER,
+    ST_LITERAL,
+    ST_DONE,
+    ST_ERROR,
+};
+
+static inline bool is_ws(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline void val_putc(json_stream_t *js, char c)
+{
+    if (js->val_len < JSON_STREAM_VALUE_MAX - 1) {
+        js->val[js->val_len++] = c;
+    }
+}
+
+// 写入一个完整的 UTF-8 字符，放不下时整体丢弃，避免截断出半个字符
+static void val_put_utf8(json_stream_t *js, uint32_t cp)
+{
+    char b[4];
+    int n;
+
+    if (cp < 0x80) {
+        b[0] = cp;
+        n = 1;
+    } else if (cp < 0x800) {
+        b[0] = 0xc0 | (cp >> 6);
+        b[1] = 0x80 | (cp & 0x3f);
+        n = 2;
+    } else if (cp < 0x10000) {
+        b[0] = 0xe0 | (cp >> 12);
+        b[1] = 0x80 | ((cp >> 6) & 0x3f);
+        b[2] = 0x80 | (cp & 0x3f);
+        n = 3;
+    } else {
+        b[0] = 0xf0 | (cp >> 18);
+        b[1] = 0x80 | ((cp >> 12) & 0x3f);
+        b[2] = 0x80 | ((cp >> 6) & 0x3f);
+        b[3] = 0x80 | (cp & 0x3f);
+        n = 4;
+    }
+    if (js->val_len + n < JSON_STREAM_VALUE_MAX) {
+        memcpy(js->val + js->val_len, b, n);
+        js->val_len += n;
+    }
+}
+
+// 没有等到低位代理项的高位代理项按替换字符输出
+static void flush_surrogate(json_stream_t *js)
+{
+    if (js->surrogate) {
+        js->surrogate = 0;
+        val_put_utf8(js, 0xfffd);
+    }
+}
+
+// 路径截到当前层的起点，再接上 '.' 和 s
+static void path_set(json_stream_t *js, const char *s, size_t n)
+{
+    size_t len = js->stack[js->depth - 1].path_len;
+
+    if (len > 0 && len < JSON_STREAM_PATH_MAX - 1) {
+        js->path[len++] = '.';
+    }
+    if (n > JSON_STREAM_PATH_MAX - 1 - len) {
+        n = JSON_STREAM_PATH_MAX - 1 - len;
+    }
+    memcpy(js->path + len, s, n);
+    len += n;
+    js->path[len] = '\0';
+    js->path_len = len;
+}
+
+static void path_set_index(json_stream_t *js)
+{
+    char num[6];
+    uint16_t i = js->stack[js->depth - 1].index;
+    size_t n = sizeof(num);
+
+    do {
+        num[--n] = '0' + i % 10;
+        i /= 10;
+    } while (i);
+    path_set(js, num + n, sizeof(num) - n);
+}
+
+static void emit(json_stream_t *js, json_stream_type_t type)
+{
+    js->val[js->val_len] = '\0';
+    if (js->cb) {
+        js->cb(js->path, type, js->val, js->arg);
+    }
+}
+
+static void value_done(json_stream_t *js)
+{
+    js->state = js->depth == 0 ? ST_DONE : ST_AFTER;
+}
+
+static bool push(json_stream_t *js, bool array)
+{
+    if (js->depth == JSON_STREAM_DEPTH_MAX) {
+        return false;
+    }
+    js->stack[js->depth].path_len = js->path_len;
+    js->stack[js->depth].index = 0;
+    js->stack[js->depth].array = array;
+    js->depth++;
+    js->state = array ? ST_ARR_FIRST : ST_OBJ_FIRST;
+    return true;
+}
+
+static bool pop(json_stream_t *js, bool array)
+{
+    if (js->depth == 0 || js->stack[js->depth - 1].array != array) {
+        return false;
+    }
+    js->depth--;
+    js->path_len = js->stack[js->depth].path_len;
+    js->path[js->path_len] = '\0';
+    value_done(js);
+    return true;
+}
+
+static void string_done(json_stream_t *js)
+{
+    flush_surrogate(js);
+    if (js->in_key) {
+        path_set(js, js->val, js->val_len);
+        js->state = ST_COLON;
+    } else {
+        emit(js, JSON_STREAM_STRING);
+        value_done(js);
+    }
+}
+
+static void literal_done(json_stream_t *js)
+{
+    js->val[js->val_len] = '\0';
+    if (strcmp(js->val, "true") == 0 || strcmp(js->val, "false") == 0) {
+        emit(js, JSON_STREAM_BOOL);
+    } else if (strcmp(js->val, "null") == 0) {
+        emit(js, JSON_STREAM_NULL);
+    } else {
+        js->state = ST_ERROR;
+        return;
+    }
+    value_done(js);
+}
+
+static void begin_value(json_stream_t *js, char c)
+{
+    js->val_len = 0;
+    if (c == '{') {
+        if (!push(js, false)) {
+            js->state = ST_ERROR;
+        }
+    } else if (c == '[') {
+        if (!push(js, true)) {
+            js->state = ST_ERROR;
+        }
+    } else if (c == '"') {
+        js->in_key = false;
+        js->state = ST_STRING;
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        val_putc(js, c);
+        js->state = ST_NUMBER;
+    } else if (c >= 'a' && c <= 'z') {
+        val_putc(js, c);
+        js->state = ST_LITERAL;
+    } else {
+        js->state = ST_ERROR;
+    }
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static void unicode_done(json_stream_t *js)
+{
+    uint16_t code = js->esc_code;
+
+    if (code >= 0xd800 && code < 0xdc00) {
+        flush_surrogate(js);
+        js->surrogate = code;
+    } else if (code >= 0xdc00 && code < 0xe000) {
+        if (js->surrogate) {
+            val_put_utf8(js, 0x10000 + ((uint32_t)(js->surrogate - 0xd800) << 10) + (code - 0xdc00));
+            js->surrogate = 0;
+        } else {
+            val_put_utf8(js, 0xfffd);
+        }
+    } else {
+        flush_surrogate(js);
+        val_put_utf8(js, code);
+    }
+    js->state = ST_STRING;
+}
+
+// 处理一个字符，返回 false 表示需要按新状态重新处理同一个字符
+static bool step(json_stream_t *js, char c)
+{
+    switch (js->state) {
+    case ST_VALUE:
+        if (!is_ws(c)) {
+            begin_value(js, c);
+        }
+        return true;
+
+    case ST_ARR_FIRST:
+        if (is_ws(c)) {
+            return true;
+        }
+        if (c == ']') {
+            pop(js, true);
+            return true;
+        }
+        path_set_index(js);
+        js->state = ST_VALUE;
+        return false;
+
+    case ST_OBJ_FIRST:
+    case ST_OBJ_KEY:
+        if (is_ws(c)) {
+            return true;
+        }
+        if (c == '}' && js->state == ST_OBJ_FIRST) {
+            pop(js, false);
+        } else if (c == '"') {
+            js->val_len = 0;
+            js->in_key = true;
+            js->state = ST_STRING;
+        } else {
+            js->state = ST_ERROR;
+        }
+        return true;
+
+    case ST_COLON:
+        if (c == ':') {
+            js->state = ST_VALUE;
+        } else if (!is_ws(c)) {
+            js->state = ST_ERROR;
+        }
+        return true;
+
+    case ST_AFTER:
+        if (is_ws(c)) {
+            return true;
+        }
+        if (c == ',') {
+            if (js->stack[js->depth - 1].array) {
+                js->stack[js->depth - 1].index++;
+                path_set_index(js);
+                js->state = ST_VALUE;
+            } else {
+                js->state = ST_OBJ_KEY;
+            }
+        } else if (!((c == ']' && pop(js, true)) || (c == '}' && pop(js, false)))) {
+            js->state = ST_ERROR;
+        }
+        return true;
+
+    case ST_STRING:
+        if (c == '"') {
+            string_done(js);
+        } else if (c == '\\') {
+            js->state = ST_ESCAPE;
+        } else if ((uint8_t)c < 0x20) {
+            js->state = ST_ERROR;
+        } else {
+            flush_surrogate(js);
+            // 多字节字符在截断处可能不完整，截断后的内容只用于显示
+            val_putc(js, c);
+        }
+        return true;
+
+    case ST_ESCAPE: {
+        static const char from[] = "\"\\/bfnrt";
+        static const char to[] = "\"\\/\b\f\n\r\t";
+        const char *p = c ? strchr(from, c) : NULL;
+        if (c == 'u') {
+            js->esc_len = 0;
+            js->esc_code = 0;
+            js->state = ST_UNICODE;
+        } else if (p) {
+            flush_surrogate(js);
+            val_putc(js, to[p - from]);
+            js->state = ST_STRING;
+        } else {
+            js->state = ST_ERROR;
+        }
+        return true;
+    }
+
+    case ST_UNICODE: {
+        int v = hex_value(c);
+        if (v < 0) {
+            js->state = ST_ERROR;
+            return true;
+        }
+        js->esc_code = (js->esc_code << 4) | v;
+        if (++js->esc_len == 4) {
+            unicode_done(js);
+        }
+        return true;
+    }
+
+    case ST_NUMBER:
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+            val_putc(js, c);
+            return true;
+        }
+        emit(js, JSON_STREAM_NUMBER);
+        value_done(js);
+        return false;
+
+    case ST_LITERAL:
+        if (c >= 'a' && c <= 'z') {
+            val_putc(js, c);
+            return true;
+        }
+        literal_done(js);
+        return js->state == ST_ERROR;
+
+    case ST_DONE:
+        if (!is_ws(c)) {
+            js->state = ST_ERROR;
+        }
+        return true;
+
+    default:
+        return true;
+    }
+}
+
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *arg)
+{
+    memset(js, 0, sizeof(*js));
+    js->cb = cb;
+    js->arg = arg;
+    js->state = ST_VALUE;
+}
+
+esp_err_t json_stream_feed(json_stream_t *js, const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        while (!step(js, data[i])) {
+        }
+        if (js->state == ST_ERROR) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        js->offset++;
+    }
+    return ESP_OK;
+}
+
+esp_err_t json_stream_finish(json_stream_t *js)
+{
+    // 顶层的数字或字面量没有结束符
+    if (js->depth == 0 && js->state == ST_NUMBER) {
+        emit(js, JSON_STREAM_NUMBER);
+        js->state = ST_DONE;
+    } else if (js->depth == 0 && js->state == ST_LITERAL) {
+        literal_done(js);
+    }
+    return js->state == ST_DONE ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file json_stream.h
+ * @brief 流式 JSON 解析
+ *
+ * 数据按块送入（如 HTTP 响应每次读到的内容），解析器逐字节推进状态机，
+ * 每遇到一个标量值就以"路径 + 文本"回调一次，不建立文档树，也不缓存整个响应：
+ * - 路径由键名和数组下标以'.'连接，如 {"daily":{"t":[1,2]}} 中的 2 为 "daily.t.1"
+ * - 回调中比较路径即可只取需要的字段，其余值解析后直接丢弃
+ * - 内存只有固定大小的路径、值缓冲区和嵌套栈，超长的键或字符串值会被截断（仍继续解析）
+ *
+ * 本模块只做计算，不依赖 ESP-IDF 的其他组件。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define JSON_STREAM_PATH_MAX    64      // 路径最大长度（含'\0'）
+#define JSON_STREAM_VALUE_MAX   48      // 键名和字符串值最大长度（含'\0'）
+#define JSON_STREAM_DEPTH_MAX   8       // 最大嵌套层数
+
+/** 值类型 */
+typedef enum {
+    JSON_STREAM_STRING,     // 已解码转义，UTF-8
+    JSON_STREAM_NUMBER,     // 原始文本，可用 strtod/strtol 转换
+    JSON_STREAM_BOOL,       // "true" 或 "false"
+    JSON_STREAM_NULL,       // "null"
+} json_stream_type_t;
+
+/**
+ * 标量值回调
+ * @param path 路径，顶层标量为空串
+ * @param type 类型
+ * @param value 值的文本，已以'\0'结尾
+ * @param arg 用户参数
+ */
+typedef void (*json_stream_cb_t)(const char *path, json_stream_type_t type, const char *value, void *arg);
+
+/** 解析器状态，由 json_stream_init() 初始化 */
+typedef struct {
+    json_stream_cb_t cb;
+    void *arg;
+    uint8_t state;
+    uint8_t depth;
+    bool in_key;                            // 正在读取的字符串是键名
+    uint8_t esc_len;                        // \uXXXX 已读取的十六进制位数
+    uint16_t esc_code;                      // \uXXXX 的值
+    uint16_t surrogate;                     // 等待低位代理项的高位代理项
+    uint16_t val_len;
+    uint16_t path_len;
+    struct {
+        uint16_t path_len;                  // 进入该层时的路径长度
+        uint16_t index;                     // 数组下标
+        bool array;
+    } stack[JSON_STREAM_DEPTH_MAX];
+    char path[JSON_STREAM_PATH_MAX];
+    char val[JSON_STREAM_VALUE_MAX];
+    uint32_t offset;                        // 已处理的字节数，出错时为出错位置
+} json_stream_t;
+
+/**
+ * 初始化解析器
+ * @param js 解析器
+ * @param cb 标量值回调
+ * @param arg 回调参数
+ */
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *arg);
+
+/**
+ * 送入一块数据，可以在任意位置分块
+ * @param js 解析器
+ * @param data 数据
+ * @param len 长度
+ * @return esp_err_t 语法错误或嵌套超过 JSON_STREAM_DEPTH_MAX 返回 ESP_ERR_INVALID_RESPONSE，之后的数据都会被拒绝
+ */
+esp_err_t json_stream_feed(json_stream_t *js, const char *data, size_t len);
+
+/**
+ * 数据结束，检查文档是否完整
+ * @param js 解析器
+ * @return esp_err_t 文档不完整或出过错返回 ESP_ERR_INVALID_RESPONSE
+ */
+esp_err_t json_stream_finish(json_stream_t *js);
@@ -0,0 +1,358 @@
+/**
+ * @file lunar.c
+ * @brief 农历、节气与节日实现
+ *
+ * lunar_year_info 每年一项：
+ *   bit0~12   按顺序各月的大小（含闰月），1 为 30 天
+ *   bit13~16  闰月月份，0 表示无闰月；闰月紧跟在同名月之后
+ *   bit17~22  正月初一距公历 1 月 1 日的天数
+ */
+
+#include "lunar.h"
+#include <string.h>
+
+#define YEAR_COUNT  (LUNAR_YEAR_MAX - LUNAR_YEAR_MIN + 1)
+
+/* 由 tools/lunar_table.py 生成，见 lunar_data.c */
+extern const uint32_t lunar_year_info[YEAR_COUNT];
+extern const uint8_t lunar_term_base[24];
+extern const uint8_t lunar_term_delta[YEAR_COUNT][6];
+
+static const char *const s_term_names[24] = {
+    "小寒", "大寒", "立春", "雨水", "惊蛰", "春分", "清明", "谷雨",
+    "立夏", "小满", "芒种", "夏至", "小暑", "大暑", "立秋", "处暑",
+    "白露", "秋分", "寒露", "霜降", "立冬", "小雪", "大雪", "冬至",
+};
+
+static const char *const s_holiday_names[LUNAR_HOLIDAY_MAX] = {
+    [LUNAR_HOLIDAY_NONE]        = "",
+    [LUNAR_HOLIDAY_NEW_YEAR]    = "元旦",
+    [LUNAR_HOLIDAY_SPRING]      = "春节",
+    [LUNAR_HOLIDAY_WOMEN]       = "妇女节",
+    [LUNAR_HOLIDAY_QINGMING]    = "清明节",
+    [LUNAR_HOLIDAY_LABOUR]      = "劳动节",
+    [LUNAR_HOLIDAY_CHILDREN]    = "儿童节",
+    [LUNAR_HOLIDAY_DRAGON_BOAT] = "端午节",
+    [LUNAR_HOLIDAY_MID_AUTUMN]  = "中秋节",
+    [LUNAR_HOLIDAY_NATIONAL]    = "国庆节",
+};
+
+/* 公历节日：月 * 100 + 日 */
+static const struct {
+    uint16_t mmdd;
+    uint8_t holiday;
+} s_solar_holidays[] = {
+    {101, LUNAR_HOLIDAY_NEW_YEAR},
+    {308, LUNAR_HOLIDAY_WOMEN},
+    {501, LUNAR_HOLIDAY_LABOUR},
+    {601, LUNAR_HOLIDAY_CHILDREN},
+    {1001, LUNAR_HOLIDAY_NATIONAL},
+};
+
+/* 农历节日（非闰月） */
+static const struct {
+    uint8_t month;
+    uint8_t day;
+    uint8_t holiday;
+} s_lunar_holidays[] = {
+    {1, 1, LUNAR_HOLIDAY_SPRING},
+    {5, 5, LUNAR_HOLIDAY_DRAGON_BOAT},
+    {8, 15, LUNAR_HOLIDAY_MID_AUTUMN},
+};
+
+#define INFO_SIZES(v)   ((v) & 0x1fff)
+#define INFO_LEAP(v)    (((v) >> 13) & 0xf)
+#define INFO_NY(v)      ((v) >> 17)
+
+// 公历日期到 1970-01-01 的天数
+static int32_t days_from_civil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civil_from_days(int32_t z, int *y, int *m, int *d)
+{
+    z += 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = (unsigned)(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int)yoe + era * 400 + (*m <= 2);
+}
+
+static int month_days(int y, int m)
+{
+    static const uint8_t mdays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return mdays[m - 1] + (m == 2 && leap);
+}
+
+// 农历 y 年正月初一
+static int32_t new_year_days(int y)
+{
+    return days_from_civil(y, 1, 1) + INFO_NY(lunar_year_info[y - LUNAR_YEAR_MIN]);
+}
+
+// 农历年第 k 个月（从 0 起，含闰月）的起始偏移
+static inline int month_start(uint32_t sizes, int k)
+{
+    return 29 * k + __builtin_popcount(sizes & ((1u << k) - 1));
+}
+
+static inline int month_count(uint32_t info)
+{
+    return INFO_LEAP(info) ? 13 : 12;
+}
+
+// 天数转农历，days 需在支持范围内
+static void lunar_from_days(int32_t days, lunar_date_t *out)
+{
+    int y;
+    int cm, cd;
+
+    civil_from_days(days, &y, &cm, &cd);
+    if (y > LUNAR_YEAR_MAX || days < new_year_days(y)) {
+        y--;
+    }
+
+    uint32_t info = lunar_year_info[y - LUNAR_YEAR_MIN];
+    uint32_t sizes = INFO_SIZES(info);
+    int offset = days - new_year_days(y);
+
+    // 每月 29 或 30 天，offset / 30 与实际月序最多差 1
+    int k = offset / 30;
+    if (k + 1 < month_count(info) && month_start(sizes, k + 1) <= offset) {
+        k++;
+    }
+
+    int leap = INFO_LEAP(info);
+    out->year = y;
+    out->day = offset - month_start(sizes, k) + 1;
+    out->leap = leap && k == leap;
+    out->month = (leap && k >= leap) ? k : k + 1;
+}
+
+static bool solar_in_range(int year, int month, int day)
+{
+    if (month < 1 || month > 12 || day < 1 || year < LUNAR_YEAR_MIN || year > LUNAR_YEAR_MAX + 1 ||
+        day > month_days(year, month)) {
+        return false;
+    }
+    int32_t days = days_from_civil(year, month, day);
+    return days >= new_year_days(LUNAR_YEAR_MIN) && days < days_from_civil(LUNAR_YEAR_MAX + 1, 1, 29);
+}
+
+esp_err_t lunar_from_solar(int year, int month, int day, lunar_date_t *out)
+{
+    if (!solar_in_range(year, month, day)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    lunar_from_days(days_from_civil(year, month, day), out);
+    return ESP_OK;
+}
+
+esp_err_t lunar_to_solar(const lunar_date_t *date, int *year, int *month, int *day)
+{
+    if (date->year < LUNAR_YEAR_MIN || date->year > LUNAR_YEAR_MAX || date->month < 1 || date->month > 12 ||
+        date->day < 1 || date->day > 30) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t info = lunar_year_info[date->year - LUNAR_YEAR_MIN];
+    int leap = INFO_LEAP(info);
+    if (date->leap && date->month != leap) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int k = (leap && (date->month > leap || date->leap)) ? date->month : date->month - 1;
+    if (date->day == 30 && !(INFO_SIZES(info) & (1u << k))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    civil_from_days(new_year_days(date->year) + month_start(INFO_SIZES(info), k) + date->day - 1, year, month, day);
+    return ESP_OK;
+}
+
+int lunar_term_day(int year, int term)
+{
+    if (year < LUNAR_YEAR_MIN || year > LUNAR_YEAR_MAX || term < 0 || term >= 24) {
+        return 0;
+    }
+    const uint8_t *delta = lunar_term_delta[year - LUNAR_YEAR_MIN];
+    return lunar_term_base[term] + ((delta[term / 4] >> (2 * (term % 4))) & 3);
+}
+
+int lunar_solar_term(int year, int month, int day)
+{
+    if (month < 1 || month > 12) {
+        return LUNAR_NO_TERM;
+    }
+    // 每月两个节气，上半月为节、下半月为中气
+    int term = (month - 1) * 2 + (day >= 15);
+    return lunar_term_day(year, term) == day ? term : LUNAR_NO_TERM;
+}
+
+const char *lunar_term_name(int term)
+{
+    return term >= 0 && term < 24 ? s_term_names[term] : "";
+}
+
+// 已知农历日期和节气时判断节日
+static lunar_holiday_t holiday_of(int month, int day, const lunar_date_t *ld, int term)
+{
+    for (size_t i = 0; i < sizeof(s_solar_holidays) / sizeof(s_solar_holidays[0]); i++) {
+        if (s_solar_holidays[i].mmdd == month * 100 + day) {
+            return s_solar_holidays[i].holiday;
+        }
+    }
+    if (!ld->leap) {
+        for (size_t i = 0; i < sizeof(s_lunar_holidays) / sizeof(s_lunar_holidays[0]); i++) {
+            if (s_lunar_holidays[i].month == ld->month && s_lunar_holidays[i].day == ld->day) {
+                return s_lunar_holidays[i].holiday;
+            }
+        }
+    }
+    return term == 6 ? LUNAR_HOLIDAY_QINGMING : LUNAR_HOLIDAY_NONE;
+}
+
+lunar_holiday_t lunar_holiday(int year, int month, int day)
+{
+    lunar_date_t ld;
+
+    if (lunar_from_solar(year, month, day, &ld) != ESP_OK) {
+        return LUNAR_HOLIDAY_NONE;
+    }
+    return holiday_of(month, day, &ld, lunar_solar_term(year, month, day));
+}
+
+const char *lunar_holiday_name(lunar_holiday_t holiday)
+{
+    return holiday < LUNAR_HOLIDAY_MAX ? s_holiday_names[holiday] : "";
+}
+
+size_t lunar_format(const lunar_date_t *date, char *buf, size_t len)
+{
+    static const char *const months[12] = {
+        "正", "二", "三", "四", "五", "六", "七", "八", "九", "十", "冬", "腊",
+    };
+    static const char *const digits[10] = {
+        "十", "一", "二", "三", "四", "五", "六", "七", "八", "九",
+    };
+    static const char *const tens[4] = {"初", "十", "廿", "三"};
+    char tmp[32];
+    size_t n = 0;
+
+    if (date->month < 1 || date->month > 12 || date->day < 1 || date->day > 30) {
+        return 0;
+    }
+
+#define APPEND(s) do { size_t l_ = strlen(s); memcpy(tmp + n, s, l_); n += l_; } while (0)
+    if (date->leap) {
+        APPEND("闰");
+    }
+    APPEND(months[date->month - 1]);
+    APPEND("月");
+    if (date->day == 10) {
+        APPEND("初十");
+    } else if (date->day == 20) {
+        APPEND("二十");
+    } else if (date->day == 30) {
+        APPEND("三十");
+    } else {
+        APPEND(tens[date->day / 10]);
+        APPEND(digits[date->day % 10]);
+    }
+#undef APPEND
+
+    if (n >= len) {
+        return 0;
+    }
+    memcpy(buf, tmp, n);
+    buf[n] = '\0';
+    return n;
+}
+
+esp_err_t lunar_month_fill(int year, int month, lunar_month_t *out)
+{
+    if (month < 1 || month > 12 || !solar_in_range(year, month, 1) ||
+        !solar_in_range(year, month, month_days(year, month))) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    out->year = year;
+    out->month = month;
+    out->days = month_days(year, month);
+    out->mark_mask = 0;
+    memset(out->term, LUNAR_NO_TERM, sizeof(out->term));
+
+    // 每月两个节气
+    int t0 = (month - 1) * 2;
+    for (int t = t0; t < t0 + 2; t++) {
+        int d = lunar_term_day(year, t);
+        if (d > 0) {
+            out->term[d - 1] = t;
+        }
+    }
+
+    // 只转换月初，之后逐日递推
+    lunar_date_t ld;
+    lunar_from_days(days_from_civil(year, month, 1), &ld);
+    uint32_t info = lunar_year_info[ld.year - LUNAR_YEAR_MIN];
+    int k = (INFO_LEAP(info) && (ld.leap || ld.month > INFO_LEAP(info))) ? ld.month : ld.month - 1;
+
+    for (int d = 1; d <= out->days; d++) {
+        out->lunar[d - 1] = ld;
+        out->holiday[d - 1] = holiday_of(month, d, &ld, out->term[d - 1] == LUNAR_NO_TERM ? -1 : out->term[d - 1]);
+        if (out->holiday[d - 1] != LUNAR_HOLIDAY_NONE || out->term[d - 1] != LUNAR_NO_TERM) {
+            out->mark_mask |= 1u << (d - 1);
+        }
+
+        if (ld.day < 29 + ((INFO_SIZES(info) >> k) & 1)) {
+            ld.day++;
+            continue;
+        }
+        // 下一个农历月
+        ld.day = 1;
+        if (++k == month_count(info)) {
+            k = 0;
+            ld.year++;
+            if (ld.year > LUNAR_YEAR_MAX) {
+                continue; // 范围检查保证不会再使用
+            }
+            info = lunar_year_info[ld.year - LUNAR_YEAR_MIN];
+        }
+        int leap = INFO_LEAP(info);
+        ld.leap = leap && k == leap;
+        ld.month = (leap && k >= leap) ? k : k + 1;
+    }
+    return ESP_OK;
+}
+
+const lunar_month_t *lunar_cache_get(lunar_cache_t *cache, int year, int month)
+{
+    int slot = 0;
+
+    for (int i = 0; i < LUNAR_CACHE_MONTHS; i++) {
+        if (cache->used[i] && cache->months[i].year == year && cache->months[i].month == month) {
+            cache->used[i] = ++cache->clock;
+            return &cache->months[i];
+        }
+        if (cache->used[i] < cache->used[slot]) {
+            slot = i;
+        }
+    }
+
+    if (lunar_month_fill(year, month, &cache->months[slot]) != ESP_OK) {
+        cache->used[slot] = 0;
+        return NULL;
+    }
+    cache->used[slot] = ++cache->clock;
+    return &cache->months[slot];
+}
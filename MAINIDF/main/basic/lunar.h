@@ -0,0 +1,147 @@
+/**
+ * @file lunar.h
+ * @brief 农历、节气与节日
+ *
+ * 数据表由 tools/lunar_table.py 生成（lunar_data.c），每个农历年 4 字节、每年节气 6 字节：
+ * - 公历转农历 O(1)：按正月初一的偏移确定农历年，再由各月大小的位图和 popcount 直接定位月份
+ * - 节气日期查表，不做天文计算
+ * - 日历按月计算（lunar_month_fill()），从月初一次转换后逐日递推，整月的节日和节气一次得出；
+ *   lunar_cache_t 缓存最近使用的几个月，翻页和每日刷新不重复计算
+ *
+ * 公历支持 1900-01-31（农历 1900 年正月初一）至 2101-01-28，节气支持 1900~2100 年。
+ * 本模块只做计算，不依赖 ESP-IDF 的其他组件；lunar_cache_t 不加锁，由使用方保证单线程访问。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define LUNAR_YEAR_MIN      1900
+#define LUNAR_YEAR_MAX      2100
+#define LUNAR_CACHE_MONTHS  3       // 缓存的月数（当前月与前后翻页）
+#define LUNAR_NO_TERM       0xff
+
+/** 农历日期 */
+typedef struct {
+    int16_t year;           // 农历年（正月初一起算）
+    uint8_t month;          // 1~12
+    uint8_t day;            // 1~30
+    bool leap;              // 闰月
+} lunar_date_t;
+
+/** 节日 */
+typedef enum {
+    LUNAR_HOLIDAY_NONE,
+    LUNAR_HOLIDAY_NEW_YEAR,         // 元旦
+    LUNAR_HOLIDAY_SPRING,           // 春节
+    LUNAR_HOLIDAY_WOMEN,            // 妇女节
+    LUNAR_HOLIDAY_QINGMING,         // 清明节（按节气）
+    LUNAR_HOLIDAY_LABOUR,           // 劳动节
+    LUNAR_HOLIDAY_CHILDREN,         // 儿童节
+    LUNAR_HOLIDAY_DRAGON_BOAT,      // 端午节
+    LUNAR_HOLIDAY_MID_AUTUMN,       // 中秋节
+    LUNAR_HOLIDAY_NATIONAL,         // 国庆节
+    LUNAR_HOLIDAY_MAX,
+} lunar_holiday_t;
+
+/** 一个公历月的农历信息 */
+typedef struct {
+    int16_t year;
+    uint8_t month;
+    uint8_t days;                   // 当月天数
+    lunar_date_t lunar[31];         // 下标为日期-1
+    uint8_t term[31];               // 节气序号（0 为小寒），LUNAR_NO_TERM 表示没有
+    uint8_t holiday[31];            // lunar_holiday_t
+    uint32_t mark_mask;             // bit(d-1)：该日有节日或节气，用于日历高亮
+} lunar_month_t;
+
+/** 按月缓存 */
+typedef struct {
+    lunar_month_t months[LUNAR_CACHE_MONTHS];
+    uint32_t used[LUNAR_CACHE_MONTHS];      // 最近使用的序号，0 表示空
+    uint32_t clock;
+} lunar_cache_t;
+
+/**
+ * 公历转农历
+ * @param year 公历年
+ * @param month 1~12
+ * @param day 1~31
+ * @param out 输出
+ * @return esp_err_t 超出范围返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t lunar_from_solar(int year, int month, int day, lunar_date_t *out);
+
+/**
+ * 农历转公历
+ * @param date 农历日期
+ * @param year 输出公历年
+ * @param month 输出月
+ * @param day 输出日
+ * @return esp_err_t 日期不存在（如小月三十、该年无此闰月）或超出范围返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t lunar_to_solar(const lunar_date_t *date, int *year, int *month, int *day);
+
+/**
+ * 某年某个节气的日期
+ * @param year 公历年
+ * @param term 节气序号，0 为小寒，23 为冬至
+ * @return int 所在月（term / 2 + 1）的日期，超出范围返回 0
+ */
+int lunar_term_day(int year, int term);
+
+/**
+ * 公历日期是否为节气
+ * @return int 节气序号，不是节气返回 LUNAR_NO_TERM
+ */
+int lunar_solar_term(int year, int month, int day);
+
+/**
+ * 节气名称
+ * @param term 节气序号
+ * @return const char* UTF-8 字符串
+ */
+const char *lunar_term_name(int term);
+
+/**
+ * 公历日期的节日
+ * @return lunar_holiday_t 没有或超出范围返回 LUNAR_HOLIDAY_NONE
+ */
+lunar_holiday_t lunar_holiday(int year, int month, int day);
+
+/**
+ * 节日名称
+ * @param holiday 节日
+ * @return const char* UTF-8 字符串，LUNAR_HOLIDAY_NONE 返回空串
+ */
+const char *lunar_holiday_name(lunar_holiday_t holiday);
+
+/**
+ * 格式化农历日期，如"闰四月初五"、"腊月廿三"
+ * @param date 农历日期
+ * @param buf 输出缓冲区，24 字节足够
+ * @param len 缓冲区大小
+ * @return size_t 输出长度，缓冲区不足时返回0
+ */
+size_t lunar_format(const lunar_date_t *date, char *buf, size_t len);
+
+/**
+ * 计算一个公历月的农历、节气和节日
+ * @param year 公历年
+ * @param month 1~12
+ * @param out 输出
+ * @return esp_err_t 月份中有超出范围的日期时返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t lunar_month_fill(int year, int month, lunar_month_t *out);
+
+/**
+ * 从缓存获取一个月的信息，不在缓存中时计算并替换最久未用的一项
+ * @param cache 缓存，首次使用前清零
+ * @param year 公历年
+ * @param month 1~12
+ * @return const lunar_month_t* 超出范围返回NULL；指针在下次调用前有效
+ */
+const lunar_month_t *lunar_cache_get(lunar_cache_t *cache, int year, int month);
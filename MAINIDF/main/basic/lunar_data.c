@@ -0,0 +1,246 @@
+/**
+ * @file lunar_data.c
+ * @brief 农历与节气数据（由 tools/lunar_table.py 生成，请勿手工修改）
+ */
+
+#include <stdint.h>
+
+/* 1900~2100 年，格式见 lunar.c */
+const uint32_t lunar_year_info[201] = {
+    0x3d16d2, 0x620752, 0x4c0ea5, 0x38b64a, 0x5c064b, 0x440a9b, 0x309556, 0x56056a,  // 1900
+    0x400b59, 0x2a5752, 0x500752, 0x3adb25, 0x600b25, 0x480a4b, 0x32b4ab, 0x5802ad,  // 1908
+    0x42056b, 0x2c4b69, 0x520da9, 0x3efd92, 0x640e92, 0x4c0d25, 0x36ba4d, 0x5c0a56,  // 1916
+    0x4602b6, 0x2e95b5, 0x5606d4, 0x400ea9, 0x2c5e92, 0x500e92, 0x3acd26, 0x5e052b,  // 1924
+    0x480a57, 0x32b2b6, 0x580b5a, 0x4406d4, 0x2e6ec9, 0x520749, 0x3cf693, 0x620a93,  // 1932
+    0x4c052b, 0x34ca5b, 0x5a0aad, 0x46056a, 0x309b55, 0x560ba4, 0x400b49, 0x2a5a93,  // 1940
+    0x500a95, 0x38f52d, 0x5e0536, 0x480aad, 0x34b5aa, 0x5805b2, 0x420da5, 0x2e7d4a,  // 1948
+    0x540d4a, 0x3d0a95, 0x600a97, 0x4c0556, 0x36cab5, 0x5a0ad5, 0x4606d2, 0x308ea5,  // 1956
+    0x560ea5, 0x40064a, 0x286c97, 0x4e0a9b, 0x3af55a, 0x5e056a, 0x480b69, 0x34b752,  // 1964
+    0x5a0b52, 0x420b25, 0x2c964b, 0x520a4b, 0x3d14ab, 0x6002ad, 0x4a056d, 0x36cb69,  // 1972
+    0x5c0da9, 0x460d92, 0x309d25, 0x560d25, 0x415a4d, 0x640a56, 0x4e02b6, 0x38c5b5,  // 1980
+    0x5e06d5, 0x480ea9, 0x34be92, 0x5a0e92, 0x440d26, 0x2c6a56, 0x500a57, 0x3d14d6,  // 1988
+    0x62035a, 0x4a06d5, 0x36b6c9, 0x5c0749, 0x460693, 0x2e952b, 0x54052b, 0x3e0a5b,  // 1996
+    0x2a555a, 0x4e056a, 0x38fb55, 0x600ba4, 0x4a0b49, 0x32ba93, 0x580a95, 0x42052d,  // 2004
+    0x2c8aad, 0x500ab5, 0x3d35aa, 0x6205d2, 0x4c0da5, 0x36dd4a, 0x5c0d4a, 0x460c95,  // 2012
+    0x30952e, 0x540556, 0x3e0ab5, 0x2a55b2, 0x5006d2, 0x38cea5, 0x5e0725, 0x48064b,  // 2020
+    0x32ac97, 0x560cab, 0x42055a, 0x2c6ad6, 0x520b69, 0x3d7752, 0x620b52, 0x4c0b25,  // 2028
+    0x36da4b, 0x5a0a4b, 0x4404ab, 0x2ea55b, 0x5405ad, 0x3e0b6a, 0x2a5b52, 0x500d92,  // 2036
+    0x3afd25, 0x5e0d25, 0x480a55, 0x32b4ad, 0x5804b6, 0x4005b5, 0x2c6daa, 0x520ec9,  // 2044
+    0x3f1e92, 0x620e92, 0x4c0d26, 0x36ca56, 0x5a0a57, 0x4404d6, 0x2e86d5, 0x540755,  // 2052
+    0x400749, 0x286e93, 0x4e0693, 0x38f52b, 0x5e052b, 0x460a5b, 0x32b55a, 0x58056a,  // 2060
+    0x420b65, 0x2c974a, 0x520b4a, 0x3d1a95, 0x620a95, 0x4a052d, 0x34caad, 0x5a0ab5,  // 2068
+    0x4605aa, 0x2e8ba5, 0x540da5, 0x400d4a, 0x2a7c95, 0x4e0c96, 0x38f94e, 0x5e0556,  // 2076
+    0x480ab5, 0x32b5b2, 0x5806d2, 0x420ea5, 0x2e8e4a, 0x50068b, 0x3b0c97, 0x6004ab,  // 2084
+    0x4a055b, 0x34cad6, 0x5a0b6a, 0x460752, 0x309725, 0x540b45, 0x3e0a8b, 0x28549b,  // 2092
+    0x4e04ab,  // 2100
+};
+
+/* 各节气最早的日期 */
+const uint8_t lunar_term_base[24] = {
+    4, 19, 3, 18, 4, 19, 4, 19, 4, 20, 4, 20, 6, 22, 6, 22, 6, 22, 7, 22, 6, 21, 6, 21,
+};
+
+/* 各年节气相对最早日期的偏移，每个节气 2 位，小寒在最低位 */
+const uint8_t lunar_term_delta[201][6] = {
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1900
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1901
+    {0x6a, 0xaa, 0xba, 0xaa, 0xaa, 0xaa},  // 1902
+    {0xaa, 0xaf, 0xbb, 0xba, 0xab, 0xaa},  // 1903
+    {0xab, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1904
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1905
+    {0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa},  // 1906
+    {0xaa, 0xaf, 0xbb, 0xba, 0xab, 0xaa},  // 1907
+    {0xab, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1908
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1909
+    {0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa},  // 1910
+    {0xaa, 0xaf, 0xba, 0xba, 0xab, 0xaa},  // 1911
+    {0xab, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1912
+    {0x56, 0x9a, 0xaa, 0xa6, 0xa6, 0x6a},  // 1913
+    {0x5a, 0x9a, 0xaa, 0xaa, 0xaa, 0x6a},  // 1914
+    {0xaa, 0xae, 0xba, 0xaa, 0xab, 0xaa},  // 1915
+    {0xaa, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1916
+    {0x56, 0x9a, 0xa6, 0xa6, 0xa6, 0x5a},  // 1917
+    {0x5a, 0x9a, 0xaa, 0xaa, 0xaa, 0x6a},  // 1918
+    {0xaa, 0xae, 0xba, 0xaa, 0xab, 0xaa},  // 1919
+    {0xaa, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1920
+    {0x56, 0x5a, 0xa6, 0xa6, 0xa6, 0x5a},  // 1921
+    {0x5a, 0x9a, 0xaa, 0xaa, 0xaa, 0x6a},  // 1922
+    {0xaa, 0xaa, 0xba, 0xaa, 0xab, 0xaa},  // 1923
+    {0xaa, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1924
+    {0x56, 0x5a, 0xa6, 0xa6, 0xa6, 0x5a},  // 1925
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1926
+    {0x6a, 0xaa, 0xba, 0xaa, 0xab, 0xaa},  // 1927
+    {0xaa, 0x5a, 0xa6, 0x65, 0x56, 0x55},  // 1928
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1929
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1930
+    {0x6a, 0xaa, 0xba, 0xaa, 0xaa, 0xaa},  // 1931
+    {0xaa, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1932
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1933
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1934
+    {0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa},  // 1935
+    {0xaa, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1936
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1937
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1938
+    {0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa},  // 1939
+    {0xaa, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1940
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1941
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1942
+    {0x6a, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa},  // 1943
+    {0xaa, 0x5a, 0x65, 0x65, 0x56, 0x55},  // 1944
+    {0x56, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1945
+    {0x56, 0x9a, 0xaa, 0xa6, 0xa6, 0x6a},  // 1946
+    {0x6a, 0x9a, 0xaa, 0xaa, 0xaa, 0xaa},  // 1947
+    {0xaa, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 1948
+    {0x55, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1949
+    {0x56, 0x5a, 0xa6, 0xa6, 0xa6, 0x6a},  // 1950
+    {0x5a, 0x9a, 0xaa, 0xaa, 0xaa, 0x6a},  // 1951
+    {0xaa, 0x59, 0x65, 0x55, 0x56, 0x55},  // 1952
+    {0x55, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1953
+    {0x56, 0x5a, 0xa6, 0xa6, 0xa6, 0x5a},  // 1954
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1955
+    {0xaa, 0x55, 0x65, 0x55, 0x56, 0x55},  // 1956
+    {0x55, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1957
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1958
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1959
+    {0x6a, 0x55, 0x65, 0x55, 0x55, 0x55},  // 1960
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1961
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1962
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1963
+    {0x6a, 0x55, 0x65, 0x55, 0x55, 0x55},  // 1964
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1965
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1966
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1967
+    {0x6a, 0x55, 0x55, 0x55, 0x55, 0x55},  // 1968
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1969
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1970
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xaa, 0x6a},  // 1971
+    {0x6a, 0x55, 0x55, 0x55, 0x55, 0x55},  // 1972
+    {0x55, 0x5a, 0x65, 0x65, 0x56, 0x55},  // 1973
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1974
+    {0x5a, 0x9a, 0xaa, 0xa6, 0xa6, 0x6a},  // 1975
+    {0x6a, 0x45, 0x55, 0x55, 0x55, 0x55},  // 1976
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 1977
+    {0x56, 0x5a, 0xa6, 0x65, 0x96, 0x5a},  // 1978
+    {0x56, 0x9a, 0xa6, 0xa6, 0xa6, 0x6a},  // 1979
+    {0x6a, 0x45, 0x55, 0x55, 0x55, 0x55},  // 1980
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 1981
+    {0x56, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1982
+    {0x56, 0x5a, 0xa6, 0xa6, 0xa6, 0x6a},  // 1983
+    {0x5a, 0x45, 0x55, 0x51, 0x55, 0x55},  // 1984
+    {0x55, 0x59, 0x65, 0x55, 0x56, 0x55},  // 1985
+    {0x55, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 1986
+    {0x56, 0x5a, 0xa6, 0xa5, 0xa6, 0x5a},  // 1987
+    {0x5a, 0x45, 0x55, 0x51, 0x55, 0x15},  // 1988
+    {0x55, 0x55, 0x65, 0x55, 0x55, 0x55},  // 1989
+    {0x55, 0x5a, 0x66, 0x65, 0x96, 0x56},  // 1990
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1991
+    {0x5a, 0x45, 0x55, 0x51, 0x55, 0x15},  // 1992
+    {0x15, 0x55, 0x65, 0x55, 0x55, 0x55},  // 1993
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1994
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1995
+    {0x5a, 0x45, 0x55, 0x51, 0x55, 0x15},  // 1996
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 1997
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 1998
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 1999
+    {0x5a, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2000
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2001
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 2002
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 2003
+    {0x5a, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2004
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2005
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2006
+    {0x56, 0x5a, 0xa6, 0x65, 0xa6, 0x5a},  // 2007
+    {0x5a, 0x45, 0x55, 0x51, 0x51, 0x15},  // 2008
+    {0x15, 0x45, 0x55, 0x55, 0x55, 0x55},  // 2009
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2010
+    {0x56, 0x5a, 0xa6, 0x65, 0x96, 0x5a},  // 2011
+    {0x5a, 0x45, 0x51, 0x51, 0x51, 0x15},  // 2012
+    {0x15, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2013
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2014
+    {0x56, 0x5a, 0xa6, 0x65, 0x96, 0x56},  // 2015
+    {0x56, 0x05, 0x51, 0x51, 0x51, 0x15},  // 2016
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2017
+    {0x55, 0x59, 0x65, 0x55, 0x56, 0x55},  // 2018
+    {0x55, 0x5a, 0x66, 0x65, 0x96, 0x56},  // 2019
+    {0x56, 0x05, 0x51, 0x10, 0x51, 0x15},  // 2020
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2021
+    {0x55, 0x55, 0x65, 0x55, 0x55, 0x55},  // 2022
+    {0x55, 0x5a, 0x66, 0x65, 0x96, 0x56},  // 2023
+    {0x56, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2024
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2025
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2026
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 2027
+    {0x56, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2028
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2029
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2030
+    {0x55, 0x5a, 0x66, 0x65, 0x56, 0x55},  // 2031
+    {0x56, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2032
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2033
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2034
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2035
+    {0x56, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2036
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2037
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2038
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2039
+    {0x56, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2040
+    {0x05, 0x45, 0x51, 0x51, 0x51, 0x15},  // 2041
+    {0x15, 0x45, 0x55, 0x55, 0x55, 0x55},  // 2042
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2043
+    {0x56, 0x05, 0x51, 0x10, 0x41, 0x05},  // 2044
+    {0x05, 0x05, 0x51, 0x51, 0x51, 0x15},  // 2045
+    {0x15, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2046
+    {0x55, 0x5a, 0x65, 0x55, 0x56, 0x55},  // 2047
+    {0x56, 0x05, 0x11, 0x10, 0x41, 0x01},  // 2048
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x15},  // 2049
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2050
+    {0x55, 0x55, 0x65, 0x55, 0x55, 0x55},  // 2051
+    {0x55, 0x05, 0x11, 0x10, 0x41, 0x01},  // 2052
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x15},  // 2053
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2054
+    {0x55, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2055
+    {0x55, 0x05, 0x11, 0x10, 0x41, 0x01},  // 2056
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2057
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2058
+    {0x55, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2059
+    {0x55, 0x05, 0x11, 0x10, 0x01, 0x00},  // 2060
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2061
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2062
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2063
+    {0x55, 0x05, 0x11, 0x10, 0x01, 0x00},  // 2064
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2065
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2066
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2067
+    {0x55, 0x05, 0x10, 0x00, 0x01, 0x00},  // 2068
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2069
+    {0x05, 0x45, 0x51, 0x51, 0x51, 0x15},  // 2070
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2071
+    {0x55, 0x05, 0x10, 0x00, 0x01, 0x00},  // 2072
+    {0x01, 0x05, 0x51, 0x10, 0x41, 0x05},  // 2073
+    {0x05, 0x45, 0x51, 0x51, 0x51, 0x15},  // 2074
+    {0x15, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2075
+    {0x55, 0x05, 0x10, 0x00, 0x01, 0x00},  // 2076
+    {0x01, 0x05, 0x51, 0x10, 0x41, 0x05},  // 2077
+    {0x05, 0x05, 0x51, 0x50, 0x51, 0x15},  // 2078
+    {0x15, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2079
+    {0x55, 0x05, 0x10, 0x00, 0x01, 0x00},  // 2080
+    {0x01, 0x05, 0x11, 0x10, 0x41, 0x01},  // 2081
+    {0x05, 0x05, 0x51, 0x10, 0x51, 0x15},  // 2082
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2083
+    {0x55, 0x04, 0x10, 0x00, 0x00, 0x00},  // 2084
+    {0x00, 0x05, 0x11, 0x10, 0x41, 0x01},  // 2085
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x15},  // 2086
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x55},  // 2087
+    {0x55, 0x00, 0x00, 0x00, 0x00, 0x00},  // 2088
+    {0x00, 0x05, 0x11, 0x10, 0x41, 0x01},  // 2089
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2090
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2091
+    {0x55, 0x00, 0x00, 0x00, 0x00, 0x00},  // 2092
+    {0x00, 0x05, 0x11, 0x10, 0x01, 0x00},  // 2093
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2094
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2095
+    {0x15, 0x00, 0x00, 0x00, 0x00, 0x00},  // 2096
+    {0x00, 0x05, 0x11, 0x00, 0x01, 0x00},  // 2097
+    {0x01, 0x05, 0x51, 0x10, 0x51, 0x05},  // 2098
+    {0x05, 0x45, 0x55, 0x51, 0x55, 0x15},  // 2099
+    {0x15, 0x55, 0x55, 0x55, 0x55, 0x55},  // 2100
+};
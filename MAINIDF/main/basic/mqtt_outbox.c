@@ -0,0 +1,242 @@
+/**
+ * @file mqtt_outbox.c
+ * @brief 待发送 MQTT 消息的环形缓冲区实现
+ *
+ * 记录头：flags(1) topic_len(1) payload_len(2, 小端)，随后是主题和内容，均可跨越数组末尾。
+ */
+
+#include "mqtt_outbox.h"
+#include <string.h>
+
+#define HDR_SIZE    4
+#define REC_DEAD    0x80    // 已作废
+
+typedef struct {
+    uint8_t flags;
+    uint8_t topic_len;
+    uint16_t payload_len;
+} rec_hdr_t;
+
+static uint16_t wrap(uint32_t pos)
+{
+    return pos % MQTT_OUTBOX_BYTES;
+}
+
+static void ring_read(const mqtt_outbox_t *ob, uint32_t pos, void *dst, size_t len)
+{
+    pos = wrap(pos);
+    size_t first = MQTT_OUTBOX_BYTES - pos;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(dst, ob->buf + pos, first);
+    memcpy((uint8_t *)dst + first, ob->buf, len - first);
+}
+
+static void ring_write(mqtt_outbox_t *ob, uint32_t pos, const void *src, size_t len)
+{
+    pos = wrap(pos);
+    size_t first = MQTT_OUTBOX_BYTES - pos;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(ob->buf + pos, src, first);
+    memcpy(ob->buf, (const uint8_t *)src + first, len - first);
+}
+
+static rec_hdr_t read_hdr(const mqtt_outbox_t *ob, uint32_t pos)
+{
+    uint8_t raw[HDR_SIZE];
+    ring_read(ob, pos, raw, HDR_SIZE);
+    return (rec_hdr_t){
+        .flags = raw[0],
+        .topic_len = raw[1],
+        .payload_len = raw[2] | (raw[3] << 8),
+    };
+}
+
+static uint16_t rec_size(const rec_hdr_t *h)
+{
+    return HDR_SIZE + h->topic_len + h->payload_len;
+}
+
+// 移出队首记录
+static void drop_head(mqtt_outbox_t *ob)
+{
+    rec_hdr_t h = read_hdr(ob, ob->head);
+    uint16_t size = rec_size(&h);
+
+    if (!(h.flags & REC_DEAD)) {
+        ob->count--;
+    }
+    ob->head = wrap(ob->head + size);
+    ob->used -= size;
+    ob->seq++;
+    if (ob->used == 0) {
+        ob->head = 0;
+    }
+}
+
+// 回收队首已作废的记录
+static void reclaim(mqtt_outbox_t *ob)
+{
+    while (ob->used > 0 && (read_hdr(ob, ob->head).flags & REC_DEAD)) {
+        drop_head(ob);
+    }
+}
+
+// 作废同主题且带 LATEST 的旧记录
+static void coalesce(mqtt_outbox_t *ob, const char *topic, uint8_t topic_len)
+{
+    char buf[MQTT_OUTBOX_TOPIC_MAX];
+    uint32_t pos = ob->head;
+    uint32_t end = ob->head + ob->used;
+
+    while (pos < end) {
+        rec_hdr_t h = read_hdr(ob, pos);
+        if (!(h.flags & REC_DEAD) && (h.flags & MQTT_OUTBOX_LATEST) && h.topic_len == topic_len) {
+            ring_read(ob, pos + HDR_SIZE, buf, topic_len);
+            if (memcmp(buf, topic, topic_len) == 0) {
+                uint8_t flags = h.flags | REC_DEAD;
+                ring_write(ob, pos, &flags, 1);
+                ob->count--;
+                ob->coalesced++;
+            }
+        }
+        pos += rec_size(&h);
+    }
+    reclaim(ob);
+}
+
+void mqtt_outbox_init(mqtt_outbox_t *ob)
+{
+    memset(ob, 0, sizeof(*ob));
+}
+
+bool mqtt_outbox_push(mqtt_outbox_t *ob, const char *topic, const void *payload, size_t len, uint8_t flags)
+{
+    size_t topic_len = strlen(topic);
+
+    if (topic_len == 0 || topic_len > MQTT_OUTBOX_TOPIC_MAX || len > MQTT_OUTBOX_PAYLOAD_MAX) {
+        return false;
+    }
+    flags &= MQTT_OUTBOX_FLAGS;
+    if (flags & MQTT_OUTBOX_LATEST) {
+        coalesce(ob, topic, topic_len);
+    }
+
+    uint16_t size = HDR_SIZE + topic_len + len;
+    while (MQTT_OUTBOX_BYTES - ob->used < size) {
+        if (!(read_hdr(ob, ob->head).flags & REC_DEAD)) {
+            ob->dropped++;
+        }
+        drop_head(ob);
+        reclaim(ob);
+    }
+
+    uint8_t hdr[HDR_SIZE] = {flags, topic_len, len & 0xff, len >> 8};
+    uint32_t pos = ob->head + ob->used;
+    ring_write(ob, pos, hdr, HDR_SIZE);
+    ring_write(ob, pos + HDR_SIZE, topic, topic_len);
+    ring_write(ob, pos + HDR_SIZE + topic_len, payload, len);
+    ob->used += size;
+    ob->count++;
+    return true;
+}
+
+// 找到序号不早于 seq 的第一条记录（含作废的），返回其位置和序号
+static bool find(const mqtt_outbox_t *ob, uint32_t seq, uint32_t *pos, uint32_t *rec_seq)
+{
+    uint32_t end = ob->head + ob->used;
+
+    *pos = ob->head;
+    *rec_seq = ob->seq;
+    // 序号会回绕，按差值比较
+    while (*pos < end && (int32_t)(*rec_seq - seq) < 0) {
+        rec_hdr_t h = read_hdr(ob, *pos);
+        *pos += rec_size(&h);
+        (*rec_seq)++;
+    }
+    return *pos < end;
+}
+
+bool mqtt_outbox_peek_from(mqtt_outbox_t *ob, uint32_t seq, mqtt_outbox_rec_t *rec)
+{
+    uint32_t pos, rec_seq;
+
+    reclaim(ob);
+    if (!find(ob, seq, &pos, &rec_seq)) {
+        return false;
+    }
+
+    uint32_t end = ob->head + ob->used;
+    rec_hdr_t h = read_hdr(ob, pos);
+    while (h.flags & REC_DEAD) {
+        pos += rec_size(&h);
+        rec_seq++;
+        if (pos >= end) {
+            return false;
+        }
+        h = read_hdr(ob, pos);
+    }
+    rec->seq = rec_seq;
+    rec->flags = h.flags;
+    rec->len = h.payload_len;
+    ring_read(ob, pos + HDR_SIZE, rec->topic, h.topic_len);
+    rec->topic[h.topic_len] = '\0';
+    ring_read(ob, pos + HDR_SIZE + h.topic_len, rec->payload, h.payload_len);
+    rec->payload[h.payload_len] = '\0';
+    return true;
+}
+
+bool mqtt_outbox_peek(mqtt_outbox_t *ob, mqtt_outbox_rec_t *rec)
+{
+    return mqtt_outbox_peek_from(ob, ob->seq, rec);
+}
+
+bool mqtt_outbox_pop(mqtt_outbox_t *ob, uint32_t seq)
+{
+    uint32_t pos, rec_seq;
+
+    if (!find(ob, seq, &pos, &rec_seq) || rec_seq != seq) {
+        return false;
+    }
+    uint8_t flags = read_hdr(ob, pos).flags;
+    if (flags & REC_DEAD) {
+        return false;
+    }
+    if (pos == ob->head) {
+        drop_head(ob);
+    } else {
+        flags |= REC_DEAD;
+        ring_write(ob, pos, &flags, 1);
+        ob->count--;
+    }
+    reclaim(ob);
+    return true;
+}
+
+bool mqtt_outbox_check(const mqtt_outbox_t *ob)
+{
+    if (ob->head >= MQTT_OUTBOX_BYTES || ob->used > MQTT_OUTBOX_BYTES) {
+        return false;
+    }
+
+    uint32_t pos = ob->head;
+    uint32_t end = ob->head + ob->used;
+    uint16_t live = 0;
+
+    while (pos < end) {
+        if (end - pos < HDR_SIZE) {
+            return false;
+        }
+        rec_hdr_t h = read_hdr(ob, pos);
+        if (h.topic_len == 0 || h.topic_len > MQTT_OUTBOX_TOPIC_MAX || h.payload_len > MQTT_OUTBOX_PAYLOAD_MAX ||
+            (h.flags & ~(MQTT_OUTBOX_FLAGS | REC_DEAD))) {
+            return false;
+        }
+        live += !(h.flags & REC_DEAD);
+        pos += rec_size(&h);
+    }
+    return pos == end && live == ob->count;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file mqtt_outbox.h
+ * @brief 待发送 MQTT 消息的环形缓冲区
+ *
+ * 消息按变长记录（4 字节头 + 主题 + 内容）连续存放在固定大小的字节数组中，可跨越数组末尾：
+ * - 空间不足时丢弃最早的记录，保证最新的数据能进入队列
+ * - 带 MQTT_OUTBOX_LATEST 的消息入队时作废队列中同主题的旧记录（状态类数据只需要最新值），
+ *   作废的记录到达队首时回收
+ * - 取出分两步：peek 复制记录，发送成功（QoS 1 为收到确认）后按序号 pop；记录的序号从队首起连续编号，
+ *   移出队首不改变其余记录的序号，期间记录被丢弃或作废时 pop 不会误删
+ *
+ * 结构体不含指针，可直接整体写入文件；从文件读回后用 mqtt_outbox_check() 校验。
+ * 本模块只做计算，不依赖 ESP-IDF；不分配内存，不加锁。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define MQTT_OUTBOX_BYTES       4096    // 缓冲区大小（含记录头）
+#define MQTT_OUTBOX_TOPIC_MAX   64      // 主题最大长度（不含'\0'）
+#define MQTT_OUTBOX_PAYLOAD_MAX 128     // 内容最大长度
+
+/* 记录标志 */
+#define MQTT_OUTBOX_QOS1    0x01    // 以 QoS 1 发送
+#define MQTT_OUTBOX_RETAIN  0x02    // 保留消息
+#define MQTT_OUTBOX_LATEST  0x04    // 同一主题只保留最新值
+#define MQTT_OUTBOX_FLAGS   0x07    // 调用方可用的标志
+
+/** 缓冲区 */
+typedef struct {
+    uint16_t head;              // 最早记录的位置
+    uint16_t used;              // 已用字节数（含已作废的记录）
+    uint16_t count;             // 有效记录数
+    uint16_t reserved;
+    uint32_t seq;               // 已移出队首的记录数
+    uint32_t dropped;           // 空间不足丢弃的记录数
+    uint32_t coalesced;         // 被同主题新值作废的记录数
+    uint8_t buf[MQTT_OUTBOX_BYTES];
+} mqtt_outbox_t;
+
+/** 取出的记录 */
+typedef struct {
+    uint32_t seq;               // 传给 mqtt_outbox_pop()
+    uint8_t flags;              // MQTT_OUTBOX_*
+    uint16_t len;               // 内容长度
+    char topic[MQTT_OUTBOX_TOPIC_MAX + 1];
+    char payload[MQTT_OUTBOX_PAYLOAD_MAX + 1];  // 以 len 为准，后面补'\0'（空内容时为空串）
+} mqtt_outbox_rec_t;
+
+/**
+ * 初始化为空
+ * @param ob 缓冲区
+ */
+void mqtt_outbox_init(mqtt_outbox_t *ob);
+
+/**
+ * 入队
+ * @param ob 缓冲区
+ * @param topic 主题
+ * @param payload 内容
+ * @param len 内容长度
+ * @param flags MQTT_OUTBOX_*
+ * @return bool 主题为空或过长、内容过长返回 false
+ */
+bool mqtt_outbox_push(mqtt_outbox_t *ob, const char *topic, const void *payload, size_t len, uint8_t flags);
+
+/**
+ * 复制队首记录，不移出
+ * @param ob 缓冲区
+ * @param rec 输出
+ * @return bool 队列为空返回 false
+ */
+bool mqtt_outbox_peek(mqtt_outbox_t *ob, mqtt_outbox_rec_t *rec);
+
+/**
+ * 从指定序号起复制第一条有效记录，不移出；用于已发出、等待确认的记录之后继续发送
+ * @param ob 缓冲区
+ * @param seq 起始序号，早于队首时从队首开始
+ * @param rec 输出
+ * @return bool 没有这样的记录返回 false
+ */
+bool mqtt_outbox_peek_from(mqtt_outbox_t *ob, uint32_t seq, mqtt_outbox_rec_t *rec);
+
+/**
+ * 移出 peek 得到的记录，可以不在队首（不在队首时先作废，到达队首时回收）
+ * @param ob 缓冲区
+ * @param seq 记录的序号
+ * @return bool 该记录已不在队列中（已被丢弃或作废）返回 false
+ */
+bool mqtt_outbox_pop(mqtt_outbox_t *ob, uint32_t seq);
+
+/**
+ * 校验从文件读回的缓冲区
+ * @param ob 缓冲区
+ * @return bool 记录完整且计数一致
+ */
+bool mqtt_outbox_check(const mqtt_outbox_t *ob);
+
+/**
+ * 有效记录数
+ * @param ob 缓冲区
+ * @return uint16_t 记录数
+ */
+static inline uint16_t mqtt_outbox_count(const mqtt_outbox_t *ob)
+{
+    return ob->count;
+}
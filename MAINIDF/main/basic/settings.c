@@ -0,0 +1,382 @@
+#include "settings.h"
+#include "sys_kv.h"
+#include <string.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "SETTINGS";
+
+#define SETTINGS_MAX_SUBSCRIBERS 8   // 当前 7 个：sys_tz、alarm、backlight（SETTING_ANY）、weather×2、home_mqtt×2
+
+/* 设置值的静态存储，由表展开生成 */
+typedef struct {
+#define SETTINGS_FIELD_INT(id, field, key, def, lo, hi) int32_t field;
+#define SETTINGS_FIELD_FLOAT(id, field, key, def, lo, hi) float field;
+#define SETTINGS_FIELD_STR(id, field, key, def, maxlen) char field[(maxlen) + 1];
+    SETTINGS_SCHEMA(SETTINGS_FIELD_INT, SETTINGS_FIELD_FLOAT, SETTINGS_FIELD_STR)
+#undef SETTINGS_FIELD_INT
+#undef SETTINGS_FIELD_FLOAT
+#undef SETTINGS_FIELD_STR
+} settings_values_t;
+
+typedef struct {
+    const char *key;
+    setting_type_t type;
+    uint16_t offset;
+    uint16_t size;          // 字符串为缓冲区大小（含'\0'）
+    int32_t imin, imax, idef;
+    float fmin, fmax, fdef;
+    const char *sdef;
+} setting_desc_t;
+
+/* 描述表，放在 flash 中 */
+static const setting_desc_t setting_descs[SETTING_COUNT] = {
+#define SETTINGS_DESC_INT(id, field, k, def, lo, hi)                                   \
+    [id] = { .key = k, .type = SETTING_TYPE_INT,                                       \
+             .offset = offsetof(settings_values_t, field), .size = sizeof(int32_t),    \
+             .imin = (lo), .imax = (hi), .idef = (def) },
+#define SETTINGS_DESC_FLOAT(id, field, k, def, lo, hi)                                 \
+    [id] = { .key = k, .type = SETTING_TYPE_FLOAT,                                     \
+             .offset = offsetof(settings_values_t, field), .size = sizeof(float),      \
+             .fmin = (lo), .fmax = (hi), .fdef = (def) },
+#define SETTINGS_DESC_STR(id, field, k, def, maxlen)                                   \
+    [id] = { .key = k, .type = SETTING_TYPE_STR,                                       \
+             .offset = offsetof(settings_values_t, field), .size = (maxlen) + 1,       \
+             .sdef = (def) },
+    SETTINGS_SCHEMA(SETTINGS_DESC_INT, SETTINGS_DESC_FLOAT, SETTINGS_DESC_STR)
+#undef SETTINGS_DESC_INT
+#undef SETTINGS_DESC_FLOAT
+#undef SETTINGS_DESC_STR
+};
+
+/* 编译期检查：键名长度、默认值范围 */
+#define SETTINGS_CHECK_INT(id, field, k, def, lo, hi)                                  \
+    _Static_assert(sizeof(k) <= 16, "setting key too long: " k);                       \
+    _Static_assert((lo) <= (def) && (def) <= (hi), "default out of range: " k);
+#define SETTINGS_CHECK_FLOAT(id, field, k, def, lo, hi)                                \
+    _Static_assert(sizeof(k) <= 16, "setting key too long: " k);
+#define SETTINGS_CHECK_STR(id, field, k, def, maxlen)                                  \
+    _Static_assert(sizeof(k) <= 16, "setting key too long: " k);                       \
+    _Static_assert(sizeof(def) <= (maxlen) + 1, "default too long: " k);
+SETTINGS_SCHEMA(SETTINGS_CHECK_INT, SETTINGS_CHECK_FLOAT, SETTINGS_CHECK_STR)
+#undef SETTINGS_CHECK_INT
+#undef SETTINGS_CHECK_FLOAT
+#undef SETTINGS_CHECK_STR
+
+_Static_assert(SETTING_COUNT <= 32, "loaded bitmap holds at most 32 settings");
+
+typedef struct {
+    setting_id_t id;
+    settings_cb_t cb;
+    void *arg;
+} settings_sub_t;
+
+static settings_values_t values;
+static uint32_t loaded_mask = 0;
+static SemaphoreHandle_t settings_mutex = NULL;
+static settings_sub_t subscribers[SETTINGS_MAX_SUBSCRIBERS];
+
+static inline void *setting_ptr(setting_id_t id)
+{
+    return (uint8_t *)&values + setting_descs[id].offset;
+}
+
+static void setting_apply_default(setting_id_t id)
+{
+    const setting_desc_t *d = &setting_descs[id];
+    switch (d->type) {
+    case SETTING_TYPE_INT:
+        *(int32_t *)setting_ptr(id) = d->idef;
+        break;
+    case SETTING_TYPE_FLOAT:
+        *(float *)setting_ptr(id) = d->fdef;
+        break;
+    case SETTING_TYPE_STR:
+        strlcpy(setting_ptr(id), d->sdef, d->size);
+        break;
+    }
+}
+
+/* 首次访问时从 NVS 加载，需持有 settings_mutex */
+static void setting_ensure_loaded(setting_id_t id)
+{
+    if (loaded_mask & (1UL << id)) {
+        return;
+    }
+
+    const setting_desc_t *d = &setting_descs[id];
+    esp_err_t err;
+
+    switch (d->type) {
+    case SETTING_TYPE_INT: {
+        int32_t v;
+        err = sys_kv_get_i32(d->key, &v);
+        if (err == ESP_OK && (v < d->imin || v > d->imax)) {
+            ESP_LOGW(TAG, "'%s' = %ld out of range, using default", d->key, (long)v);
+            err = ESP_ERR_INVALID_STATE;
+        }
+        if (err == ESP_OK) {
+            *(int32_t *)setting_ptr(id) = v;
+        }
+        break;
+    }
+    case SETTING_TYPE_FLOAT: {
+        float v;
+        err = sys_kv_get_float(d->key, &v);
+        if (err == ESP_OK && !(v >= d->fmin && v <= d->fmax)) {
+            ESP_LOGW(TAG, "'%s' out of range, using default", d->key);
+            err = ESP_ERR_INVALID_STATE;
+        }
+        if (err == ESP_OK) {
+            *(float *)setting_ptr(id) = v;
+        }
+        break;
+    }
+    case SETTING_TYPE_STR:
+    default: {
+        size_t len = d->size;
+        err = sys_kv_get_str(d->key, setting_ptr(id), &len);
+        break;
+    }
+    }
+
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NVS_NOT_FOUND && err != ESP_ERR_INVALID_STATE) {
+            ESP_LOGW(TAG, "Failed to load '%s': %s", d->key, esp_err_to_name(err));
+        }
+        setting_apply_default(id);
+    }
+    loaded_mask |= 1UL << id;
+}
+
+static bool setting_valid(setting_id_t id, setting_type_t type)
+{
+    if ((unsigned)id >= SETTING_COUNT || setting_descs[id].type != type) {
+        ESP_LOGE(TAG, "Invalid setting access: id %d type %d", id, type);
+        return false;
+    }
+    return settings_mutex != NULL;
+}
+
+static void settings_notify(setting_id_t id)
+{
+    settings_sub_t subs[SETTINGS_MAX_SUBSCRIBERS];
+
+    // 复制一份后在锁外回调，回调中可以再读写设置
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    memcpy(subs, subscribers, sizeof(subs));
+    xSemaphoreGive(settings_mutex);
+
+    for (int i = 0; i < SETTINGS_MAX_SUBSCRIBERS; i++) {
+        if (subs[i].cb && (subs[i].id == id || subs[i].id == SETTING_ANY)) {
+            subs[i].cb(id, subs[i].arg);
+        }
+    }
+}
+
+esp_err_t settings_init(void)
+{
+    if (settings_mutex) {
+        return ESP_OK;
+    }
+    settings_mutex = xSemaphoreCreateMutex();
+    if (!settings_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+    loaded_mask = 0;
+    memset(subscribers, 0, sizeof(subscribers));
+    ESP_LOGI(TAG, "%d settings registered", SETTING_COUNT);
+    return ESP_OK;
+}
+
+int32_t settings_get_int(setting_id_t id)
+{
+    if (!setting_valid(id, SETTING_TYPE_INT)) {
+        return 0;
+    }
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    setting_ensure_loaded(id);
+    int32_t v = *(int32_t *)setting_ptr(id);
+    xSemaphoreGive(settings_mutex);
+    return v;
+}
+
+esp_err_t settings_set_int(setting_id_t id, int32_t value)
+{
+    if (!setting_valid(id, SETTING_TYPE_INT)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const setting_desc_t *d = &setting_descs[id];
+    if (value < d->imin || value > d->imax) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    setting_ensure_loaded(id);
+    int32_t *p = setting_ptr(id);
+    bool changed = (*p != value);
+    *p = value;
+    xSemaphoreGive(settings_mutex);
+
+    if (!changed) {
+        return ESP_OK;
+    }
+    esp_err_t err = sys_kv_set_i32(d->key, value);
+    settings_notify(id);
+    return err;
+}
+
+float settings_get_float(setting_id_t id)
+{
+    if (!setting_valid(id, SETTING_TYPE_FLOAT)) {
+        return 0.0f;
+    }
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    setting_ensure_loaded(id);
+    float v = *(float *)setting_ptr(id);
+    xSemaphoreGive(settings_mutex);
+    return v;
+}
+
+esp_err_t settings_set_float(setting_id_t id, float value)
+{
+    if (!setting_valid(id, SETTING_TYPE_FLOAT)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const setting_desc_t *d = &setting_descs[id];
+    if (!(value >= d->fmin && value <= d->fmax)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    setting_ensure_loaded(id);
+    float *p = setting_ptr(id);
+    bool changed = (*p != value);
+    *p = value;
+    xSemaphoreGive(settings_mutex);
+
+    if (!changed) {
+        return ESP_OK;
+    }
+    esp_err_t err = sys_kv_set_float(d->key, value);
+    settings_notify(id);
+    return err;
+}
+
+esp_err_t settings_get_str(setting_id_t id, char *buf, size_t len)
+{
+    if (!setting_valid(id, SETTING_TYPE_STR)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!buf || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    setting_ensure_loaded(id);
+    strlcpy(buf, setting_ptr(id), len);
+    xSemaphoreGive(settings_mutex);
+    return ESP_OK;
+}
+
+esp_err_t settings_set_str(setting_id_t id, const char *value)
+{
+    if (!setting_valid(id, SETTING_TYPE_STR) || !value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const setting_desc_t *d = &setting_descs[id];
+    if (strlen(value) >= d->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    setting_ensure_loaded(id);
+    char *p = setting_ptr(id);
+    bool changed = strcmp(p, value) != 0;
+    strlcpy(p, value, d->size);
+    xSemaphoreGive(settings_mutex);
+
+    if (!changed) {
+        return ESP_OK;
+    }
+    esp_err_t err = sys_kv_set_str(d->key, value);
+    settings_notify(id);
+    return err;
+}
+
+esp_err_t settings_reset(setting_id_t id)
+{
+    if ((unsigned)id >= SETTING_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const setting_desc_t *d = &setting_descs[id];
+    switch (d->type) {
+    case SETTING_TYPE_INT:
+        return settings_set_int(id, d->idef);
+    case SETTING_TYPE_FLOAT:
+        return settings_set_float(id, d->fdef);
+    case SETTING_TYPE_STR:
+    default:
+        return settings_set_str(id, d->sdef);
+    }
+}
+
+void settings_reload(void)
+{
+    if (!settings_mutex) {
+        return;
+    }
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    loaded_mask = 0;
+    xSemaphoreGive(settings_mutex);
+}
+
+const char *settings_describe(setting_id_t id, setting_type_t *type)
+{
+    if ((unsigned)id >= SETTING_COUNT) {
+        return NULL;
+    }
+    if (type) {
+        *type = setting_descs[id].type;
+    }
+    return setting_descs[id].key;
+}
+
+esp_err_t settings_subscribe(setting_id_t id, settings_cb_t cb, void *arg)
+{
+    if (!cb || (unsigned)id > SETTING_ANY || !settings_mutex) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = ESP_ERR_NO_MEM;
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    for (int i = 0; i < SETTINGS_MAX_SUBSCRIBERS; i++) {
+        if (!subscribers[i].cb) {
+            subscribers[i] = (settings_sub_t){ .id = id, .cb = cb, .arg = arg };
+            err = ESP_OK;
+            break;
+        }
+    }
+    xSemaphoreGive(settings_mutex);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No space for subscriber");
+    }
+    return err;
+}
+
+esp_err_t settings_unsubscribe(setting_id_t id, settings_cb_t cb)
+{
+    if (!settings_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    xSemaphoreTake(settings_mutex, portMAX_DELAY);
+    for (int i = 0; i < SETTINGS_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].cb == cb && subscribers[i].id == id) {
+            memset(&subscribers[i], 0, sizeof(subscribers[i]));
+            err = ESP_OK;
+            break;
+        }
+    }
+    xSemaphoreGive(settings_mutex);
+    return err;
+}
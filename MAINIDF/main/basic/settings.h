@@ -0,0 +1,128 @@
+/**
+ * @file settings.h
+ * @brief 设置子系统
+ *
+ * 设置项由 settings_schema.h 中的表统一定义，值保存在静态存储中：
+ * - 首次访问某一项时才从 NVS（sys_kv）读取，启动时不读取未使用的设置
+ * - 读不到或超出范围时使用表中的默认值
+ * - 修改后写入 sys_kv（延迟合并提交），并通知订阅者
+ *
+ * 读写接口线程安全；订阅回调在调用 settings_set_*() 的任务中执行，不持有内部锁。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "settings_schema.h"
+
+typedef enum {
+#define SETTINGS_ENUM_ITEM(id, ...) id,
+    SETTINGS_SCHEMA(SETTINGS_ENUM_ITEM, SETTINGS_ENUM_ITEM, SETTINGS_ENUM_ITEM)
+#undef SETTINGS_ENUM_ITEM
+    SETTING_COUNT,
+    SETTING_ANY = SETTING_COUNT,    // 订阅时表示所有设置项
+} setting_id_t;
+
+typedef enum {
+    SETTING_TYPE_INT,
+    SETTING_TYPE_FLOAT,
+    SETTING_TYPE_STR,
+} setting_type_t;
+
+/** 设置变更回调：id - 变更的设置项；arg - 订阅时传入的参数 */
+typedef void (*settings_cb_t)(setting_id_t id, void *arg);
+
+/**
+ * 初始化设置子系统（不读取任何设置项）
+ * 需在 sys_kv_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t settings_init(void);
+
+/**
+ * 读取整数设置
+ * @param id 设置项
+ * @return int32_t 当前值，类型不符时返回0
+ */
+int32_t settings_get_int(setting_id_t id);
+
+/**
+ * 修改整数设置
+ * @param id 设置项
+ * @param value 新值
+ * @return esp_err_t 超出范围返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t settings_set_int(setting_id_t id, int32_t value);
+
+/**
+ * 读取浮点设置
+ * @param id 设置项
+ * @return float 当前值，类型不符时返回0
+ */
+float settings_get_float(setting_id_t id);
+
+/**
+ * 修改浮点设置
+ * @param id 设置项
+ * @param value 新值
+ * @return esp_err_t 超出范围返回 ESP_ERR_INVALID_ARG
+ */
+esp_err_t settings_set_float(setting_id_t id, float value);
+
+/**
+ * 读取字符串设置
+ * @param id 设置项
+ * @param buf 输出缓冲区
+ * @param len 缓冲区大小，不足时截断
+ * @return esp_err_t 操作结果
+ */
+esp_err_t settings_get_str(setting_id_t id, char *buf, size_t len);
+
+/**
+ * 修改字符串设置
+ * @param id 设置项
+ * @param value 新值
+ * @return esp_err_t 超出最大长度返回 ESP_ERR_INVALID_SIZE
+ */
+esp_err_t settings_set_str(setting_id_t id, const char *value);
+
+/**
+ * 恢复默认值
+ * @param id 设置项
+ * @return esp_err_t 操作结果
+ */
+esp_err_t settings_reset(setting_id_t id);
+
+/**
+ * 丢弃已加载的值，之后每一项在下次访问时重新从 sys_kv 读取
+ * 不通知订阅者
+ */
+void settings_reload(void);
+
+/**
+ * 查询设置项的类型和键名
+ * @param id 设置项
+ * @param type 输出类型，可为NULL
+ * @return const char* NVS键名，id无效时返回NULL
+ */
+const char *settings_describe(setting_id_t id, setting_type_t *type);
+
+/**
+ * 订阅设置变更
+ * @param id 设置项，SETTING_ANY 表示全部
+ * @param cb 回调
+ * @param arg 用户参数，回调时原样传回
+ * @return esp_err_t 订阅数已满返回 ESP_ERR_NO_MEM
+ */
+esp_err_t settings_subscribe(setting_id_t id, settings_cb_t cb, void *arg);
+
+/**
+ * 取消订阅
+ * @param id 订阅时的设置项
+ * @param cb 订阅时的回调
+ * @return esp_err_t 未找到返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t settings_unsubscribe(setting_id_t id, settings_cb_t cb);
@@ -0,0 +1,44 @@
+/**
+ * @file settings_schema.h
+ * @brief 设置项定义表
+ *
+ * 所有设置项的键、类型、默认值和范围都只在这里定义一次，
+ * settings.h / settings.c 通过 X-macro 展开生成枚举、存储和描述表。
+ *
+ * SETTING_INT(id, field, key, default, min, max)
+ * SETTING_FLOAT(id, field, key, default, min, max)
+ * SETTING_STR(id, field, key, default, max_len)
+ *
+ * - id    设置项枚举名
+ * - field 存储结构中的成员名
+ * - key   NVS 键名（最长15字符，发布后不要修改）
+ *
+ * 新增设置项只需在表中添加一行；删除或改名会丢失已保存的值。
+ */
+
+#pragma once
+
+#define SETTINGS_SCHEMA(SETTING_INT, SETTING_FLOAT, SETTING_STR)                          \
+    /* 背光（曲线：0 线性、1 CIE 1931；最低占空比为 10 位） */                               \
+    SETTING_INT(SETTING_BRIGHTNESS,      brightness,      "bl_level",   100, 1, 100)       \
+    SETTING_INT(SETTING_BRIGHTNESS_HIGH, brightness_high, "bl_step_hi", 100, 1, 100)       \
+    SETTING_INT(SETTING_BRIGHTNESS_MID,  brightness_mid,  "bl_step_mid", 50, 1, 100)       \
+    SETTING_INT(SETTING_BRIGHTNESS_LOW,  brightness_low,  "bl_step_lo",  25, 1, 100)       \
+    SETTING_INT(SETTING_FADE_MS,         fade_ms,         "bl_fade_ms", 500, 1, 5000)      \
+    SETTING_INT(SETTING_BL_CURVE,        bl_curve,        "bl_curve",     1, 0, 1)         \
+    SETTING_INT(SETTING_BL_MIN_DUTY,     bl_min_duty,     "bl_min_duty",  8, 0, 255)       \
+    /* 夜间自动调暗（本地时间整点，开始与结束相同时不启用）和夜间亮度上限 */                    \
+    SETTING_INT(SETTING_BL_NIGHT_START,  bl_night_start,  "bl_night_on",  22, 0, 23)       \
+    SETTING_INT(SETTING_BL_NIGHT_END,    bl_night_end,    "bl_night_off", 7, 0, 23)        \
+    SETTING_INT(SETTING_BL_NIGHT_LEVEL,  bl_night_level,  "bl_night_lvl", 20, 1, 100)      \
+    /* WLAN（旧版本保存位置，由 wifi_store 导入后清空） */                                    \
+    SETTING_STR(SETTING_WIFI_SSID,       wifi_ssid,       "wifi_ssid",  "", 32)            \
+    SETTING_STR(SETTING_WIFI_PASS,       wifi_pass,       "wifi_pass",  "", 64)            \
+    /* 时间（时区为 tz.h 中的 IANA 名称） */                                                  \
+    SETTING_STR(SETTING_TIMEZONE,        tz_name,         "tz_name",    "Asia/Shanghai", 31) \
+    /* 天气位置（纬度、经度，默认北京） */                                                 \
+    SETTING_FLOAT(SETTING_WEATHER_LAT,   weather_lat,     "wx_lat",     39.90f, -90, 90)   \
+    SETTING_FLOAT(SETTING_WEATHER_LON,   weather_lon,     "wx_lon",     116.40f, -180, 180)  \
+    /* 智能家居 MQTT 服务器（为空时不启用）和主题前缀 */                                      \
+    SETTING_STR(SETTING_MQTT_URL,        mqtt_url,        "mqtt_url",   "", 95)            \
+    SETTING_STR(SETTING_MQTT_PREFIX,     mqtt_prefix,     "mqtt_prefix", "home", 23)
@@ -0,0 +1,196 @@
+#include "splash.h"
+
+#include <string.h>
+#include <stdbool.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "jlc_lcd.h"
+
+static const char *TAG = "SPLASH";
+
+/*
+    启动画面
+    两个带缓冲区交替使用：发送当前带的同时解码下一带
+    通过发送一个空命令等待之前排队的像素数据全部发送完成，之后才复用缓冲区
+*/
+
+#define SPLASH_W        BSP_LCD_H_RES
+#define SPLASH_H        BSP_LCD_V_RES
+#define LCD_CMD_NOP     0x00
+
+/** RLE 解码状态 */
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    uint16_t color;
+    int run;
+    bool literal;
+} rle_t;
+
+static esp_lcd_panel_handle_t s_panel = NULL;
+static esp_lcd_panel_io_handle_t s_io = NULL;
+static StaticSemaphore_t s_lock_buf;
+static SemaphoreHandle_t s_lock = NULL;    // splash_init() 中创建，之后只读
+static bool s_active = false;
+static int s_bar_x, s_bar_y;
+static int s_bar_px = 0;        // 已绘制的进度条宽度
+
+// 转换为发送顺序（高字节在前）
+static inline uint16_t panel_color(uint16_t rgb565)
+{
+    return (uint16_t)((rgb565 >> 8) | (rgb565 << 8));
+}
+
+static inline uint16_t rle_next(rle_t *r)
+{
+    if (r->run == 0) {
+        if (r->p >= r->end) {
+            return panel_color(SPLASH_BG);
+        }
+        uint8_t c = *r->p++;
+        r->run = (c & 0x7F) + 1;
+        r->literal = !(c & 0x80);
+        if (!r->literal) {
+            memcpy(&r->color, r->p, 2);
+            r->p += 2;
+        }
+    }
+
+    r->run--;
+    if (r->literal) {
+        uint16_t v;
+        memcpy(&v, r->p, 2);
+        r->p += 2;
+        return v;
+    }
+    return r->color;
+}
+
+// 等待已排队的像素数据发送完成
+static void splash_sync(void)
+{
+    esp_lcd_panel_io_tx_param(s_io, LCD_CMD_NOP, NULL, 0);
+}
+
+static void fill(uint16_t *p, uint16_t color, int n)
+{
+    for (int i = 0; i < n; i++) {
+        p[i] = color;
+    }
+}
+
+void splash_init(void)
+{
+    if (!s_lock) {
+        s_lock = xSemaphoreCreateMutexStatic(&s_lock_buf);
+    }
+}
+
+esp_err_t splash_show(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io)
+{
+    if (!panel || !io) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_lock) {
+        return ESP_ERR_INVALID_STATE; // 未调用 splash_init()
+    }
+
+    size_t band_bytes = SPLASH_W * SPLASH_BAND_LINES * sizeof(uint16_t);
+    uint16_t *bufs[2];
+    bufs[0] = heap_caps_malloc(band_bytes, MALLOC_CAP_DMA);
+    bufs[1] = heap_caps_malloc(band_bytes, MALLOC_CAP_DMA);
+    if (!bufs[0] || !bufs[1]) {
+        ESP_LOGE(TAG, "No memory for splash buffers");
+        heap_caps_free(bufs[0]);
+        heap_caps_free(bufs[1]);
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_panel = panel;
+    s_io = io;
+    const splash_img_t *logo = &splash_logo;
+    int logo_x = (SPLASH_W - logo->w) / 2;
+    int logo_y = (SPLASH_H - logo->h) / 2 - 16;
+    s_bar_x = (SPLASH_W - SPLASH_BAR_W) / 2;
+    s_bar_y = logo_y + logo->h + 28;
+    s_bar_px = 0;
+
+    rle_t rle = { .p = logo->data, .end = logo->data + logo->size };
+    uint16_t bg = panel_color(SPLASH_BG);
+    uint16_t track = panel_color(SPLASH_BAR_TRACK);
+
+    for (int y0 = 0, b = 0; y0 < SPLASH_H; y0 += SPLASH_BAND_LINES, b ^= 1) {
+        int lines = SPLASH_H - y0 < SPLASH_BAND_LINES ? SPLASH_H - y0 : SPLASH_BAND_LINES;
+        uint16_t *buf = bufs[b];
+
+        for (int l = 0; l < lines; l++) {
+            int y = y0 + l;
+            uint16_t *row = buf + l * SPLASH_W;
+            fill(row, bg, SPLASH_W);
+            if (y >= logo_y && y < logo_y + logo->h) {
+                for (int x = 0; x < logo->w; x++) {
+                    row[logo_x + x] = rle_next(&rle);
+                }
+            }
+            if (y >= s_bar_y && y < s_bar_y + SPLASH_BAR_H) {
+                fill(row + s_bar_x, track, SPLASH_BAR_W);
+            }
+        }
+
+        // 解码本带时上一带仍在发送；等它发完再排队本带，下一轮即可复用上一带的缓冲区
+        splash_sync();
+        esp_lcd_panel_draw_bitmap(panel, 0, y0, SPLASH_W, y0 + lines, buf);
+    }
+    splash_sync();
+
+    heap_caps_free(bufs[0]);
+    heap_caps_free(bufs[1]);
+    ESP_LOGI(TAG, "Splash shown at %lld ms", esp_timer_get_time() / 1000);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_active = true;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
+
+void splash_progress(int percent)
+{
+    if (!s_lock) {
+        return;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int px = SPLASH_BAR_W * percent / 100;
+    if (s_active && px > s_bar_px) {
+        int w = px - s_bar_px;
+        uint16_t *buf = heap_caps_malloc(w * SPLASH_BAR_H * sizeof(uint16_t), MALLOC_CAP_DMA);
+        if (buf) {
+            fill(buf, panel_color(SPLASH_BAR_FILL), w * SPLASH_BAR_H);
+            esp_lcd_panel_draw_bitmap(s_panel, s_bar_x + s_bar_px, s_bar_y,
+                                      s_bar_x + px, s_bar_y + SPLASH_BAR_H, buf);
+            splash_sync();
+            heap_caps_free(buf);
+            s_bar_px = px;
+        }
+    }
+    xSemaphoreGive(s_lock);
+}
+
+void splash_finish(void)
+{
+    if (!s_lock) {
+        return;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_active = false;
+    xSemaphoreGive(s_lock);
+}
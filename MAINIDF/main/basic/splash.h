@@ -0,0 +1,63 @@
+/**
+ * @file splash.h
+ * @brief 启动画面
+ *
+ * 在 LVGL 启动之前直接通过屏幕驱动绘制启动画面：
+ * - 液晶屏初始化后立即显示居中的 logo 和进度条，避免白屏等待
+ * - logo 为 RLE 压缩的 RGB565 数据，由 tools/img2splash.py 生成，逐带解码后发送
+ * - 进度条只重绘新增部分
+ * - splash_finish() 之后不再访问屏幕，由 LVGL 接管并直接覆盖整屏
+ *
+ * 压缩格式：控制字节 c，c & 0x80 为重复段，(c & 0x7F) + 1 个相同像素，后跟 1 个像素；
+ * 否则为原样段，后跟 c + 1 个像素。像素按发送顺序（高字节在前）保存，像素流跨行连续。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#define SPLASH_BG           0x10C4  // 背景色 RGB565 (0x10,0x18,0x20)，与 img2splash.py 默认值一致
+#define SPLASH_BAR_TRACK    0x3186  // 进度条底色
+#define SPLASH_BAR_FILL     0x351E  // 进度条颜色
+#define SPLASH_BAR_W        160
+#define SPLASH_BAR_H        4
+#define SPLASH_BAND_LINES   16      // 每次发送的行数
+
+/** RLE 压缩图片 */
+typedef struct {
+    uint16_t w;
+    uint16_t h;
+    uint32_t size;
+    const uint8_t *data;
+} splash_img_t;
+
+/** 默认 logo（ui/splash_logo.c） */
+extern const splash_img_t splash_logo;
+
+/**
+ * 创建互斥锁，需在启动阶段任务创建之前调用（静态分配，不会失败）
+ */
+void splash_init(void);
+
+/**
+ * 绘制启动画面
+ * @param panel 液晶屏句柄
+ * @param io 液晶屏 IO 句柄，用于等待数据发送完成
+ * @return esp_err_t 操作结果
+ */
+esp_err_t splash_show(esp_lcd_panel_handle_t panel, esp_lcd_panel_io_handle_t io);
+
+/**
+ * 更新进度条，可在任意任务中调用
+ * @param percent 0 ~ 100，小于当前进度时忽略
+ */
+void splash_progress(int percent);
+
+/**
+ * 结束启动画面，之后的进度更新被忽略
+ * 需在 LVGL 接管屏幕之前调用
+ */
+void splash_finish(void);
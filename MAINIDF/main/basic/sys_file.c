@@ -0,0 +1,550 @@
+#include "sys_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "sys_journal.h"
+
+static const char *TAG = "SYSFILE";
+
+/*
+    流式文件读写
+    直接使用 POSIX 文件描述符，数据从 LittleFS 读入调用方缓冲区，
+    不经过 stdio 的 FILE 缓冲，也不按文件大小分配内存
+*/
+
+static esp_err_t errno_to_err(int e)
+{
+    switch (e) {
+    case ENOENT: return ESP_ERR_NOT_FOUND;
+    case ENOMEM: return ESP_ERR_NO_MEM;
+    case ENOSPC: return ESP_ERR_NO_MEM;
+    case EINVAL: return ESP_ERR_INVALID_ARG;
+    default:     return ESP_FAIL;
+    }
+}
+
+esp_err_t sys_file_open(sys_file_t *f, const char *path, int flags)
+{
+    if (!f || !path) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int oflag;
+    if (flags & SYS_FILE_APPEND) {
+        oflag = O_WRONLY | O_CREAT | O_APPEND;
+    } else if (flags & SYS_FILE_WRITE) {
+        oflag = ((flags & SYS_FILE_READ) ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+    } else {
+        oflag = O_RDONLY;
+        if (flags & SYS_FILE_CREATE) {
+            oflag |= O_CREAT;
+        }
+    }
+
+    f->fd = open(path, oflag, 0644);
+    if (f->fd < 0) {
+        int e = errno;
+        if (e != ENOENT) {
+            ESP_LOGE(TAG, "Failed to open %s, errno=%d (%s)", path, e, strerror(e));
+        }
+        return errno_to_err(e);
+    }
+    return ESP_OK;
+}
+
+esp_err_t sys_file_read(sys_file_t *f, void *buf, size_t len, size_t *out_len)
+{
+    if (!f || f->fd < 0 || !buf || !out_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ssize_t n;
+    do {
+        n = read(f->fd, buf, len);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0) {
+        ESP_LOGE(TAG, "Read error, errno=%d (%s)", errno, strerror(errno));
+        *out_len = 0;
+        return errno_to_err(errno);
+    }
+    *out_len = (size_t)n;
+    return ESP_OK;
+}
+
+esp_err_t sys_file_write(sys_file_t *f, const void *data, size_t len)
+{
+    if (!f || f->fd < 0 || (!data && len)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint8_t *p = data;
+    while (len > 0) {
+        ssize_t n = write(f->fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ESP_LOGE(TAG, "Write error, errno=%d (%s)", errno, strerror(errno));
+            return errno_to_err(errno);
+        }
+        if (n == 0) {
+            ESP_LOGE(TAG, "Write error, no space left");
+            return ESP_ERR_NO_MEM;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t sys_file_seek(sys_file_t *f, long offset, int whence)
+{
+    if (!f || f->fd < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (lseek(f->fd, offset, whence) < 0) {
+        return errno_to_err(errno);
+    }
+    return ESP_OK;
+}
+
+esp_err_t sys_file_size(sys_file_t *f, size_t *size)
+{
+    struct stat st;
+    if (!f || f->fd < 0 || !size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (fstat(f->fd, &st) != 0) {
+        return errno_to_err(errno);
+    }
+    *size = (size_t)st.st_size;
+    return ESP_OK;
+}
+
+esp_err_t sys_file_sync(sys_file_t *f)
+{
+    if (!f || f->fd < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (fsync(f->fd) != 0) {
+        ESP_LOGE(TAG, "fsync failed, errno=%d (%s)", errno, strerror(errno));
+        return errno_to_err(errno);
+    }
+    return ESP_OK;
+}
+
+void sys_file_close(sys_file_t *f)
+{
+    if (f && f->fd >= 0) {
+        close(f->fd);
+        f->fd = -1;
+    }
+}
+
+esp_err_t sys_file_read_chunks(const char *path, void *buf, size_t buf_len,
+                               sys_file_chunk_cb_t cb, void *arg)
+{
+    if (!buf || buf_len == 0 || !cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sys_file_t f;
+    esp_err_t ret = sys_file_open(&f, path, SYS_FILE_READ);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    for (;;) {
+        size_t n;
+        ret = sys_file_read(&f, buf, buf_len, &n);
+        if (ret != ESP_OK || n == 0) {
+            break;
+        }
+        ret = cb(buf, n, arg);
+        if (ret != ESP_OK) {
+            break;
+        }
+    }
+
+    sys_file_close(&f);
+    return ret;
+}
+
+/* ---------------- 行/记录迭代器 ---------------- */
+
+esp_err_t sys_file_iter_open(sys_file_iter_t *it, const char *path, void *buf, size_t cap)
+{
+    if (!it || !buf || cap < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(it, 0, sizeof(*it));
+    it->buf = buf;
+    it->cap = cap;
+    return sys_file_open(&it->file, path, SYS_FILE_READ);
+}
+
+/**
+ * 把未消费数据移到缓冲区开头，并从文件补充数据
+ * 保留最后1字节用于放置行尾'\0'
+ */
+static esp_err_t iter_fill(sys_file_iter_t *it)
+{
+    if (it->start > 0) {
+        memmove(it->buf, it->buf + it->start, it->end - it->start);
+        it->end -= it->start;
+        it->start = 0;
+    }
+
+    size_t room = it->cap - 1 - it->end;
+    if (room == 0 || it->eof) {
+        return ESP_OK;
+    }
+
+    size_t n;
+    esp_err_t ret = sys_file_read(&it->file, it->buf + it->end, room, &n);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (n == 0) {
+        it->eof = true;
+    }
+    it->end += n;
+    return ESP_OK;
+}
+
+static void iter_emit(sys_file_iter_t *it, size_t line_end, size_t next,
+                      const char **line, size_t *len)
+{
+    char *s = it->buf + it->start;
+    size_t l = line_end - it->start;
+
+    if (l > 0 && s[l - 1] == '\r') {
+        l--;
+    }
+    s[l] = '\0';
+
+    *line = s;
+    *len = l;
+    it->start = next;
+    it->line_no++;
+}
+
+esp_err_t sys_file_next_line(sys_file_iter_t *it, const char **line, size_t *len)
+{
+    if (!it || !it->buf || !line || !len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (;;) {
+        char *base = it->buf + it->start;
+        size_t avail = it->end - it->start;
+        char *nl = memchr(base, '\n', avail);
+
+        if (it->skip_to_nl) {
+            // 丢弃上一条过长行的剩余部分
+            if (nl) {
+                it->start += (size_t)(nl - base) + 1;
+                it->skip_to_nl = false;
+                continue;
+            }
+            it->start = it->end;
+            if (it->eof) {
+                return ESP_ERR_NOT_FOUND;
+            }
+        } else if (nl) {
+            size_t pos = (size_t)(nl - it->buf);
+            iter_emit(it, pos, pos + 1, line, len);
+            return ESP_OK;
+        } else if (it->eof) {
+            if (avail == 0) {
+                return ESP_ERR_NOT_FOUND;
+            }
+            // 最后一行没有换行符
+            iter_emit(it, it->end, it->end, line, len);
+            return ESP_OK;
+        } else if (it->start == 0 && it->end == it->cap - 1) {
+            // 窗口已满仍未找到换行：返回截断的内容，剩余部分下次丢弃
+            ESP_LOGW(TAG, "Line %lu longer than %u bytes, truncated",
+                     (unsigned long)(it->line_no + 1), (unsigned)(it->cap - 1));
+            iter_emit(it, it->end, it->end, line, len);
+            it->skip_to_nl = true;
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        esp_err_t ret = iter_fill(it);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+}
+
+esp_err_t sys_file_next_record(sys_file_iter_t *it, const void **rec, size_t rec_size)
+{
+    if (!it || !it->buf || !rec || rec_size == 0 || rec_size > it->cap - 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    while (it->end - it->start < rec_size) {
+        if (it->eof) {
+            if (it->end == it->start) {
+                return ESP_ERR_NOT_FOUND;
+            }
+            ESP_LOGW(TAG, "Trailing %u bytes, less than one record",
+                     (unsigned)(it->end - it->start));
+            it->start = it->end;
+            return ESP_ERR_INVALID_SIZE;
+        }
+        esp_err_t ret = iter_fill(it);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    *rec = it->buf + it->start;
+    it->start += rec_size;
+    return ESP_OK;
+}
+
+void sys_file_iter_close(sys_file_iter_t *it)
+{
+    if (it) {
+        sys_file_close(&it->file);
+        it->start = it->end = 0;
+    }
+}
+
+/* ---------------- 整文件操作 ---------------- */
+
+static esp_err_t write_with_flags(const char *path, const void *data, size_t len, int flags)
+{
+    sys_file_t f;
+    esp_err_t ret = sys_file_open(&f, path, flags);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = sys_file_write(&f, data, len);
+    sys_file_close(&f);
+    return ret;
+}
+
+esp_err_t sys_file_write_all(const char *path, const void *data, size_t len)
+{
+    return write_with_flags(path, data, len, SYS_FILE_WRITE);
+}
+
+esp_err_t sys_file_write_atomic(const char *path, const void *data, size_t len)
+{
+    char tmp[SYS_FILE_PATH_MAX];
+    if (!path || snprintf(tmp, sizeof(tmp), "%s" SYS_FILE_TMP_SUFFIX, path) >= (int)sizeof(tmp)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sys_file_t f;
+    esp_err_t ret = sys_file_open(&f, tmp, SYS_FILE_WRITE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = sys_file_write(&f, data, len);
+    if (ret == ESP_OK) {
+        ret = sys_file_sync(&f);
+    }
+    sys_file_close(&f);
+
+    if (ret == ESP_OK && rename(tmp, path) != 0) {
+        ESP_LOGE(TAG, "rename %s failed, errno=%d (%s)", tmp, errno, strerror(errno));
+        ret = errno_to_err(errno);
+    }
+    if (ret != ESP_OK) {
+        unlink(tmp);
+    }
+    return ret;
+}
+
+esp_err_t sys_file_append(const char *path, const void *data, size_t len)
+{
+    return write_with_flags(path, data, len, SYS_FILE_APPEND);
+}
+
+void *sys_file_read_all(const char *path, size_t *len, bool prefer_psram)
+{
+    sys_file_t f;
+    if (sys_file_open(&f, path, SYS_FILE_READ) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open file %s", path);
+        return NULL;
+    }
+
+    size_t size;
+    if (sys_file_size(&f, &size) != ESP_OK) {
+        sys_file_close(&f);
+        return NULL;
+    }
+
+    uint8_t *content = NULL;
+    if (prefer_psram) {
+        content = heap_caps_malloc(size + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!content) {
+        content = malloc(size + 1);
+    }
+    if (!content) {
+        ESP_LOGE(TAG, "Memory allocation failed (%u bytes)", (unsigned)(size + 1));
+        sys_file_close(&f);
+        return NULL;
+    }
+
+    size_t total = 0;
+    while (total < size) {
+        size_t n;
+        if (sys_file_read(&f, content + total, size - total, &n) != ESP_OK || n == 0) {
+            break;
+        }
+        total += n;
+    }
+    sys_file_close(&f);
+
+    if (total != size) {
+        ESP_LOGE(TAG, "Read error: expected %u bytes, read %u bytes",
+                 (unsigned)size, (unsigned)total);
+        free(content);
+        return NULL;
+    }
+
+    content[size] = '\0';
+    if (len) {
+        *len = size;
+    }
+    return content;
+}
+
+/* ---------------- 吞吐量测试 ---------------- */
+
+static esp_err_t bench_sink(const void *data, size_t len, void *arg)
+{
+    // 逐块累加校验，避免读取被优化掉，同时模拟最轻的消费者
+    uint32_t *sum = arg;
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i += 64) {
+        *sum += p[i];
+    }
+    return ESP_OK;
+}
+
+void sys_file_benchmark(const char *path)
+{
+    static const size_t chunk_sizes[] = { 64, 256, 1024, 4096, 16384 };
+
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        ESP_LOGE(TAG, "Benchmark file %s not found", path);
+        return;
+    }
+
+    uint8_t *buf = malloc(chunk_sizes[sizeof(chunk_sizes) / sizeof(chunk_sizes[0]) - 1]);
+    if (!buf) {
+        ESP_LOGE(TAG, "Benchmark buffer allocation failed");
+        return;
+    }
+
+    ESP_LOGI(TAG, "Read benchmark: %s, %ld bytes", path, (long)st.st_size);
+
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+        uint32_t sum = 0;
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t ret = sys_file_read_chunks(path, buf, chunk_sizes[i], bench_sink, &sum);
+        int64_t us = esp_timer_get_time() - t0;
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "  chunk %5u: failed (%s)", (unsigned)chunk_sizes[i], esp_err_to_name(ret));
+            continue;
+        }
+        ESP_LOGI(TAG, "  chunk %5u: %7lld us, %6lld KB/s",
+                 (unsigned)chunk_sizes[i], (long long)us,
+                 (long long)(us > 0 ? (int64_t)st.st_size * 1000000 / 1024 / us : 0));
+    }
+
+    // 对照：原 sys_read_file 的整文件读取方式（stdio + 整体分配）
+    int64_t t0 = esp_timer_get_time();
+    FILE *fp = fopen(path, "r");
+    if (fp) {
+        char *all = malloc(st.st_size + 1);
+        if (all) {
+            fread(all, 1, st.st_size, fp);
+            free(all);
+        }
+        fclose(fp);
+        int64_t us = esp_timer_get_time() - t0;
+        ESP_LOGI(TAG, "  stdio whole-file: %7lld us, %6lld KB/s, heap %ld bytes",
+                 (long long)us, (long long)(us > 0 ? (int64_t)st.st_size * 1000000 / 1024 / us : 0),
+                 (long)st.st_size + 1);
+    }
+
+    free(buf);
+}
+
+void sys_file_write_benchmark(const char *dir)
+{
+    static const size_t sizes[] = { 32, 256, 2048 };
+    static const int rounds = 20;
+    char path[SYS_FILE_PATH_MAX - sizeof(SYS_FILE_TMP_SUFFIX)];
+
+    uint8_t *data = malloc(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+    if (!data) {
+        return;
+    }
+    memset(data, 0x5A, sizes[sizeof(sizes) / sizeof(sizes[0]) - 1]);
+
+    ESP_LOGI(TAG, "Write benchmark in %s, %d rounds", dir, rounds);
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        int64_t t_plain = 0, t_atomic = 0, t_journal = 0;
+
+        snprintf(path, sizeof(path), "%s/bench.bin", dir);
+        for (int r = 0; r < rounds; r++) {
+            int64_t t0 = esp_timer_get_time();
+            sys_file_write_all(path, data, sizes[i]);
+            t_plain += esp_timer_get_time() - t0;
+
+            t0 = esp_timer_get_time();
+            sys_file_write_atomic(path, data, sizes[i]);
+            t_atomic += esp_timer_get_time() - t0;
+        }
+        unlink(path);
+
+        snprintf(path, sizeof(path), "%s/bench.jnl", dir);
+        sys_journal_t j;
+        sys_journal_stats_t st = { 0 };
+        if (sizes[i] <= SYS_JOURNAL_MAX_RECORD && sys_journal_open(&j, path, 0) == ESP_OK) {
+            for (int r = 0; r < rounds; r++) {
+                int64_t t0 = esp_timer_get_time();
+                sys_journal_append(&j, data, sizes[i]);
+                t_journal += esp_timer_get_time() - t0;
+            }
+            sys_journal_get_stats(&j, &st);
+            sys_journal_close(&j);
+            unlink(path);
+        }
+
+        if (st.appends) {
+            ESP_LOGI(TAG, "  %4u B: plain %6lld us, atomic %6lld us, journal %6lld us (amp x%.2f)",
+                     (unsigned)sizes[i], (long long)(t_plain / rounds), (long long)(t_atomic / rounds),
+                     (long long)(t_journal / rounds), (double)st.written_bytes / st.payload_bytes);
+        } else {
+            ESP_LOGI(TAG, "  %4u B: plain %6lld us, atomic %6lld us, journal n/a (record > %d B)",
+                     (unsigned)sizes[i], (long long)(t_plain / rounds), (long long)(t_atomic / rounds),
+                     SYS_JOURNAL_MAX_RECORD);
+        }
+    }
+
+    free(data);
+}
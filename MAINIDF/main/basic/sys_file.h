@@ -0,0 +1,204 @@
+/**
+ * @file sys_file.h
+ * @brief 流式文件读写
+ *
+ * 基于 POSIX open/read/write（经 VFS 直达 LittleFS），不经过 stdio 缓冲：
+ * - 分块读取直接写入调用方缓冲区，不整体分配文件大小的内存
+ * - 行/定长记录迭代器在调用方提供的窗口缓冲区内原地返回数据，不额外复制
+ * - 写入按字节长度进行，可写二进制数据
+ * - 需要整文件内容时可选择在 PSRAM 中分配
+ * - sys_file_write_atomic() 先写临时文件再 rename，掉电时只会看到旧内容或新内容
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/* 打开方式 */
+#define SYS_FILE_READ       0x01    // 只读
+#define SYS_FILE_WRITE      0x02    // 写入，截断已有内容
+#define SYS_FILE_APPEND     0x04    // 追加写入
+#define SYS_FILE_CREATE     0x08    // 不存在时创建（WRITE/APPEND 默认包含）
+
+#define SYS_FILE_PATH_MAX   96      // 含临时文件后缀的最长路径
+#define SYS_FILE_TMP_SUFFIX ".tmp"
+
+/** 文件句柄 */
+typedef struct {
+    int fd;
+} sys_file_t;
+
+/** 行/记录迭代器，数据存放在调用方提供的 buf 中 */
+typedef struct {
+    sys_file_t file;
+    char *buf;
+    size_t cap;
+    size_t start;           // 未消费数据起点
+    size_t end;             // 未消费数据终点
+    bool eof;
+    bool skip_to_nl;        // 上一行过长，丢弃到下一个换行
+    uint32_t line_no;       // 已返回的行数
+} sys_file_iter_t;
+
+/** 分块回调：返回非 ESP_OK 时停止读取并把该值返回给调用方 */
+typedef esp_err_t (*sys_file_chunk_cb_t)(const void *data, size_t len, void *arg);
+
+/**
+ * 打开文件
+ * @param f 句柄
+ * @param path 路径
+ * @param flags SYS_FILE_* 组合
+ * @return esp_err_t 文件不存在返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t sys_file_open(sys_file_t *f, const char *path, int flags);
+
+/**
+ * 读取最多 len 字节
+ * @param f 句柄
+ * @param buf 缓冲区
+ * @param len 缓冲区大小
+ * @param out_len 实际读取字节数，0 表示文件结束
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_read(sys_file_t *f, void *buf, size_t len, size_t *out_len);
+
+/**
+ * 写入 len 字节（写完或出错才返回）
+ * @param f 句柄
+ * @param data 数据
+ * @param len 长度
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_write(sys_file_t *f, const void *data, size_t len);
+
+/**
+ * 移动读写位置
+ * @param f 句柄
+ * @param offset 偏移
+ * @param whence SEEK_SET / SEEK_CUR / SEEK_END
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_seek(sys_file_t *f, long offset, int whence);
+
+/**
+ * 获取文件大小
+ * @param f 句柄
+ * @param size 输出大小
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_size(sys_file_t *f, size_t *size);
+
+/**
+ * 把已写入的数据刷到 flash
+ * @param f 句柄
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_sync(sys_file_t *f);
+
+/**
+ * 关闭文件
+ * @param f 句柄
+ */
+void sys_file_close(sys_file_t *f);
+
+/**
+ * 按块读取整个文件，每块调用一次回调
+ * @param path 路径
+ * @param buf 块缓冲区
+ * @param buf_len 块大小
+ * @param cb 回调
+ * @param arg 回调参数
+ * @return esp_err_t 操作结果或回调返回的错误
+ */
+esp_err_t sys_file_read_chunks(const char *path, void *buf, size_t buf_len,
+                               sys_file_chunk_cb_t cb, void *arg);
+
+/**
+ * 打开行/记录迭代器
+ * @param it 迭代器
+ * @param path 路径
+ * @param buf 窗口缓冲区，需大于最长行或记录
+ * @param cap 缓冲区大小
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_iter_open(sys_file_iter_t *it, const char *path, void *buf, size_t cap);
+
+/**
+ * 读取下一行（去掉行尾 \n 和 \r）
+ * 返回的指针指向窗口缓冲区，已以'\0'结尾，下次调用前有效
+ * @param it 迭代器
+ * @param line 输出行首
+ * @param len 输出行长度
+ * @return esp_err_t ESP_ERR_NOT_FOUND 表示结束；
+ *         ESP_ERR_INVALID_SIZE 表示行超过缓冲区，返回截断内容，剩余部分被丢弃
+ */
+esp_err_t sys_file_next_line(sys_file_iter_t *it, const char **line, size_t *len);
+
+/**
+ * 读取下一条定长记录
+ * 返回的指针指向窗口缓冲区，下次调用前有效
+ * @param it 迭代器
+ * @param rec 输出记录
+ * @param rec_size 记录大小，不能超过缓冲区大小
+ * @return esp_err_t ESP_ERR_NOT_FOUND 表示结束；末尾不足一条记录返回 ESP_ERR_INVALID_SIZE
+ */
+esp_err_t sys_file_next_record(sys_file_iter_t *it, const void **rec, size_t rec_size);
+
+/**
+ * 关闭迭代器
+ * @param it 迭代器
+ */
+void sys_file_iter_close(sys_file_iter_t *it);
+
+/**
+ * 写入整个文件（二进制安全，截断原内容）
+ * @param path 路径
+ * @param data 数据
+ * @param len 长度
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_write_all(const char *path, const void *data, size_t len);
+
+/**
+ * 原子替换整个文件
+ * 写入 path.tmp 并 fsync，再 rename 覆盖 path。LittleFS 的 rename 是原子的，
+ * 任何时刻掉电后 path 要么是完整的旧内容，要么是完整的新内容。
+ * @param path 路径
+ * @param data 数据
+ * @param len 长度
+ * @return esp_err_t 操作结果，失败时 path 保持原内容
+ */
+esp_err_t sys_file_write_atomic(const char *path, const void *data, size_t len);
+
+/**
+ * 追加数据到文件末尾
+ * @param path 路径
+ * @param data 数据
+ * @param len 长度
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_file_append(const char *path, const void *data, size_t len);
+
+/**
+ * 读取整个文件到新分配的内存，末尾额外补'\0'
+ * @param path 路径
+ * @param len 输出文件长度，可为NULL
+ * @param prefer_psram true 时优先在 PSRAM 分配，不足时退回内部内存
+ * @return void* 使用 free() 释放，失败返回 NULL
+ */
+void *sys_file_read_all(const char *path, size_t *len, bool prefer_psram);
+
+/**
+ * 读取吞吐量测试：以不同块大小读取文件并输出结果到日志
+ * @param path 测试文件路径，建议大于 64KB
+ */
+void sys_file_benchmark(const char *path);
+
+/**
+ * 写入延迟测试：对比直接覆盖、原子替换和日志追加的耗时与写放大，输出到日志
+ * @param dir 测试目录，测试文件用完后删除
+ */
+void sys_file_write_benchmark(const char *dir);
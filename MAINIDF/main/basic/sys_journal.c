@@ -0,0 +1,334 @@
+#include "sys_journal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
+
+static const char *TAG = "SYSJNL";
+
+/*
+    追加式日志
+    记录头 8 字节：魔数 0xA5、保留 0、长度（小端 u16）、CRC32（小端 u32，覆盖长度和数据）
+    扫描时遇到第一条无效记录即认为到达末尾
+*/
+
+#define JOURNAL_MAGIC   0xA5
+#define JOURNAL_WIN     (SYS_JOURNAL_HDR_SIZE + SYS_JOURNAL_MAX_RECORD + 1)
+
+typedef esp_err_t (*scan_cb_t)(const void *rec, size_t len, void *arg);
+
+/** 重写上下文 */
+typedef struct {
+    sys_journal_t *j;
+    sys_file_t out;
+    bool compact;           // 是否应用筛选回调
+    size_t drop;            // 需丢弃的最旧数据量
+    size_t dropped;
+    size_t written;
+    uint32_t records;
+} rewrite_ctx_t;
+
+static uint32_t record_crc(const void *data, uint16_t len)
+{
+    uint8_t l[2] = { len & 0xFF, len >> 8 };
+    uint32_t crc = esp_rom_crc32_le(0, l, sizeof(l));
+    return esp_rom_crc32_le(crc, data, len);
+}
+
+static size_t record_build(uint8_t *buf, const void *data, uint16_t len)
+{
+    uint32_t crc = record_crc(data, len);
+
+    buf[0] = JOURNAL_MAGIC;
+    buf[1] = 0;
+    buf[2] = len & 0xFF;
+    buf[3] = len >> 8;
+    buf[4] = crc & 0xFF;
+    buf[5] = (crc >> 8) & 0xFF;
+    buf[6] = (crc >> 16) & 0xFF;
+    buf[7] = crc >> 24;
+    memcpy(buf + SYS_JOURNAL_HDR_SIZE, data, len);
+    return SYS_JOURNAL_HDR_SIZE + len;
+}
+
+/**
+ * 从头扫描有效记录
+ * @param valid 输出有效前缀长度
+ * @param count 输出有效记录数
+ */
+static esp_err_t journal_scan(const char *path, scan_cb_t cb, void *arg,
+                              size_t *valid, uint32_t *count)
+{
+    *valid = 0;
+    *count = 0;
+
+    char *win = malloc(JOURNAL_WIN);
+    if (!win) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    sys_file_iter_t it;
+    esp_err_t ret = sys_file_iter_open(&it, path, win, JOURNAL_WIN);
+    if (ret != ESP_OK) {
+        free(win);
+        return ret == ESP_ERR_NOT_FOUND ? ESP_OK : ret;
+    }
+
+    for (;;) {
+        const uint8_t *hdr;
+        const void *rec;
+
+        esp_err_t r = sys_file_next_record(&it, (const void **)&hdr, SYS_JOURNAL_HDR_SIZE);
+        if (r != ESP_OK) {
+            if (r != ESP_ERR_NOT_FOUND && r != ESP_ERR_INVALID_SIZE) {
+                ret = r;
+            }
+            break;
+        }
+
+        // 读取数据时窗口可能移动，先取出头部字段
+        uint16_t len = hdr[2] | (hdr[3] << 8);
+        uint32_t crc = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | ((uint32_t)hdr[7] << 24);
+        if (hdr[0] != JOURNAL_MAGIC || len == 0 || len > SYS_JOURNAL_MAX_RECORD) {
+            break;
+        }
+
+        r = sys_file_next_record(&it, &rec, len);
+        if (r != ESP_OK) {
+            if (r != ESP_ERR_NOT_FOUND && r != ESP_ERR_INVALID_SIZE) {
+                ret = r;
+            }
+            break;
+        }
+        if (record_crc(rec, len) != crc) {
+            break;
+        }
+
+        if (cb) {
+            ret = cb(rec, len, arg);
+            if (ret != ESP_OK) {
+                break;
+            }
+        }
+        *valid += SYS_JOURNAL_HDR_SIZE + len;
+        (*count)++;
+    }
+
+    sys_file_iter_close(&it);
+    free(win);
+    return ret;
+}
+
+static esp_err_t count_kept_cb(const void *rec, size_t len, void *arg)
+{
+    rewrite_ctx_t *ctx = arg;
+    if (!ctx->j->keep || ctx->j->keep(rec, len, ctx->j->keep_arg)) {
+        ctx->written += SYS_JOURNAL_HDR_SIZE + len;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t rewrite_cb(const void *rec, size_t len, void *arg)
+{
+    rewrite_ctx_t *ctx = arg;
+    sys_journal_t *j = ctx->j;
+    size_t sz = SYS_JOURNAL_HDR_SIZE + len;
+
+    if (ctx->compact) {
+        if (j->keep && !j->keep(rec, len, j->keep_arg)) {
+            return ESP_OK;
+        }
+        if (ctx->dropped < ctx->drop) {
+            ctx->dropped += sz;
+            return ESP_OK;
+        }
+    }
+
+    uint8_t buf[SYS_JOURNAL_HDR_SIZE + SYS_JOURNAL_MAX_RECORD];
+    record_build(buf, rec, len);
+    esp_err_t ret = sys_file_write(&ctx->out, buf, sz);
+    if (ret == ESP_OK) {
+        ctx->written += sz;
+        ctx->records++;
+    }
+    return ret;
+}
+
+/**
+ * 把有效记录写入临时文件后原子替换原文件，重新以追加方式打开
+ * @param compact false 时原样复制有效前缀（用于截掉损坏的尾部）
+ */
+static esp_err_t journal_rewrite(sys_journal_t *j, bool compact)
+{
+    char tmp[SYS_FILE_PATH_MAX + sizeof(SYS_FILE_TMP_SUFFIX)];
+    snprintf(tmp, sizeof(tmp), "%s" SYS_FILE_TMP_SUFFIX, j->path);
+
+    sys_file_close(&j->file);
+
+    rewrite_ctx_t ctx = { .j = j, .compact = compact };
+    size_t valid;
+    uint32_t count;
+    esp_err_t ret = ESP_OK;
+
+    if (compact && j->max_size) {
+        ret = journal_scan(j->path, count_kept_cb, &ctx, &valid, &count);
+        size_t target = j->max_size / 2;
+        ctx.drop = ctx.written > target ? ctx.written - target : 0;
+        ctx.written = 0;
+    }
+
+    if (ret == ESP_OK) {
+        ret = sys_file_open(&ctx.out, tmp, SYS_FILE_WRITE);
+    }
+    if (ret == ESP_OK) {
+        ret = journal_scan(j->path, rewrite_cb, &ctx, &valid, &count);
+        if (ret == ESP_OK) {
+            ret = sys_file_sync(&ctx.out);
+        }
+        sys_file_close(&ctx.out);
+        if (ret == ESP_OK && rename(tmp, j->path) != 0) {
+            ESP_LOGE(TAG, "rename %s failed, errno=%d (%s)", tmp, errno, strerror(errno));
+            ret = ESP_FAIL;
+        }
+        if (ret != ESP_OK) {
+            unlink(tmp);
+        }
+    }
+
+    if (ret == ESP_OK) {
+        j->size = ctx.written;
+        j->records = ctx.records;
+        j->stats.written_bytes += ctx.written;
+        if (compact) {
+            j->stats.compactions++;
+        }
+    }
+
+    // 无论重写是否成功都重新打开，失败时原文件保持不变
+    esp_err_t open_ret = sys_file_open(&j->file, j->path, SYS_FILE_APPEND);
+    return ret != ESP_OK ? ret : open_ret;
+}
+
+esp_err_t sys_journal_open(sys_journal_t *j, const char *path, size_t max_size)
+{
+    if (!j || !path || strlen(path) >= sizeof(j->path)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(j, 0, sizeof(*j));
+    strcpy(j->path, path);
+    j->file.fd = -1;
+    j->max_size = max_size;
+
+    // 上次压缩中途掉电留下的临时文件
+    char tmp[SYS_FILE_PATH_MAX + sizeof(SYS_FILE_TMP_SUFFIX)];
+    snprintf(tmp, sizeof(tmp), "%s" SYS_FILE_TMP_SUFFIX, path);
+    unlink(tmp);
+
+    esp_err_t ret = journal_scan(path, NULL, NULL, &j->size, &j->records);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    struct stat st;
+    if (stat(path, &st) == 0 && (size_t)st.st_size > j->size) {
+        j->stats.recovered_bytes = st.st_size - j->size;
+        ESP_LOGW(TAG, "%s: dropping %lu bytes of torn tail after %lu records",
+                 path, (unsigned long)j->stats.recovered_bytes, (unsigned long)j->records);
+        return journal_rewrite(j, false);
+    }
+
+    return sys_file_open(&j->file, path, SYS_FILE_APPEND);
+}
+
+void sys_journal_set_compactor(sys_journal_t *j, sys_journal_keep_cb_t keep, void *arg)
+{
+    j->keep = keep;
+    j->keep_arg = arg;
+}
+
+esp_err_t sys_journal_append(sys_journal_t *j, const void *data, size_t len)
+{
+    if (!j || j->file.fd < 0 || !data || len == 0 || len > SYS_JOURNAL_MAX_RECORD) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t buf[SYS_JOURNAL_HDR_SIZE + SYS_JOURNAL_MAX_RECORD];
+    size_t sz = record_build(buf, data, len);
+
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t ret = sys_file_write(&j->file, buf, sz);
+    if (ret == ESP_OK) {
+        ret = sys_file_sync(&j->file);
+    }
+    if (ret != ESP_OK) {
+        // 写了一半的记录会让之后追加的记录全部无法读出，先恢复到有效前缀
+        ESP_LOGE(TAG, "%s: append failed (%s)", j->path, esp_err_to_name(ret));
+        journal_rewrite(j, false);
+        return ret;
+    }
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    j->size += sz;
+    j->records++;
+    j->stats.appends++;
+    j->stats.payload_bytes += len;
+    j->stats.written_bytes += sz;
+    if (us > j->stats.max_append_us) {
+        j->stats.max_append_us = us;
+    }
+
+    if (j->max_size && j->size > j->max_size) {
+        ret = sys_journal_compact(j);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "%s: compaction failed (%s)", j->path, esp_err_to_name(ret));
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t sys_journal_replay(sys_journal_t *j, sys_journal_replay_cb_t cb, void *arg)
+{
+    if (!j || !cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t valid;
+    uint32_t count;
+    return journal_scan(j->path, cb, arg, &valid, &count);
+}
+
+esp_err_t sys_journal_compact(sys_journal_t *j)
+{
+    if (!j) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t before = j->size;
+    esp_err_t ret = journal_rewrite(j, true);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "%s: compacted %u -> %u bytes, %lu records",
+                 j->path, (unsigned)before, (unsigned)j->size, (unsigned long)j->records);
+    }
+    return ret;
+}
+
+void sys_journal_get_stats(sys_journal_t *j, sys_journal_stats_t *stats)
+{
+    if (j && stats) {
+        *stats = j->stats;
+    }
+}
+
+void sys_journal_close(sys_journal_t *j)
+{
+    if (j) {
+        sys_file_close(&j->file);
+    }
+}
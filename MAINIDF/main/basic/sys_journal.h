@@ -0,0 +1,111 @@
+/**
+ * @file sys_journal.h
+ * @brief 追加式日志文件
+ *
+ * 适合频繁小量写入的数据（闹钟、事件记录等），每次写入只追加一条记录：
+ * - 记录格式：魔数(1) 保留(1) 长度(2) CRC32(4) 数据(长度)
+ * - 每次追加后 fsync，掉电最多丢失正在写的那一条
+ * - 打开时从头校验，遇到不完整或 CRC 错误的记录即停止，之后的内容被丢弃
+ * - 文件超过 max_size 时自动压缩：按回调筛选需要保留的记录，
+ *   仍然过大则丢弃最旧的记录，压缩结果经 sys_file_write_atomic 同样的临时文件+rename 原子替换
+ *
+ * 同一个日志对象不可并发调用，需由调用方串行化。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sys_file.h"
+
+#define SYS_JOURNAL_MAX_RECORD  256     // 单条记录最大长度
+#define SYS_JOURNAL_HDR_SIZE    8
+
+/** 压缩筛选回调：返回 true 保留该记录，需对同一记录给出相同结果 */
+typedef bool (*sys_journal_keep_cb_t)(const void *rec, size_t len, void *arg);
+
+/** 回放回调：返回非 ESP_OK 时停止回放并返回该值 */
+typedef esp_err_t (*sys_journal_replay_cb_t)(const void *rec, size_t len, void *arg);
+
+/**
+ * 日志统计
+ */
+typedef struct {
+    uint32_t appends;           // 追加次数
+    uint32_t compactions;       // 压缩次数
+    uint32_t recovered_bytes;   // 打开时丢弃的损坏尾部字节数
+    uint32_t payload_bytes;     // 调用方写入的数据字节数
+    uint32_t written_bytes;     // 实际写入文件的字节数（含记录头和压缩重写）
+    uint32_t max_append_us;     // 单次追加最长耗时
+} sys_journal_stats_t;
+
+/**
+ * 日志对象
+ */
+typedef struct {
+    char path[SYS_FILE_PATH_MAX];
+    sys_file_t file;
+    size_t size;                // 文件中有效数据的字节数
+    uint32_t records;           // 有效记录数
+    size_t max_size;            // 自动压缩阈值，0 表示不自动压缩
+    sys_journal_keep_cb_t keep;
+    void *keep_arg;
+    sys_journal_stats_t stats;
+} sys_journal_t;
+
+/**
+ * 打开日志，不存在时创建；尾部损坏的记录会被截掉
+ * @param j 日志对象
+ * @param path 文件路径
+ * @param max_size 自动压缩阈值（字节），0 表示不自动压缩
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_journal_open(sys_journal_t *j, const char *path, size_t max_size);
+
+/**
+ * 设置压缩时的筛选回调，未设置时只丢弃最旧的记录
+ * @param j 日志对象
+ * @param keep 筛选回调
+ * @param arg 回调参数
+ */
+void sys_journal_set_compactor(sys_journal_t *j, sys_journal_keep_cb_t keep, void *arg);
+
+/**
+ * 追加一条记录并 fsync
+ * @param j 日志对象
+ * @param data 数据
+ * @param len 长度，1 ~ SYS_JOURNAL_MAX_RECORD
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_journal_append(sys_journal_t *j, const void *data, size_t len);
+
+/**
+ * 按写入顺序回放所有有效记录
+ * @param j 日志对象
+ * @param cb 回调，rec 指向内部缓冲区，仅在回调内有效
+ * @param arg 回调参数
+ * @return esp_err_t 操作结果或回调返回的错误
+ */
+esp_err_t sys_journal_replay(sys_journal_t *j, sys_journal_replay_cb_t cb, void *arg);
+
+/**
+ * 立即压缩：保留筛选通过的记录，总量超过 max_size 一半时再丢弃最旧的记录
+ * @param j 日志对象
+ * @return esp_err_t 操作结果，失败时原文件不变
+ */
+esp_err_t sys_journal_compact(sys_journal_t *j);
+
+/**
+ * 获取统计数据
+ * @param j 日志对象
+ * @param stats 输出统计
+ */
+void sys_journal_get_stats(sys_journal_t *j, sys_journal_stats_t *stats);
+
+/**
+ * 关闭日志
+ * @param j 日志对象
+ */
+void sys_journal_close(sys_journal_t *j);
@@ -0,0 +1,544 @@
+#include "sys_kv.h"
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "SYSKV";
+
+/*
+    NVS 写回缓存
+    - 唯一的 nvs 句柄在 sys_kv_init() 中打开
+    - 缓存条目按 LRU 淘汰，脏条目淘汰前先写回
+    - 写回由低优先级任务完成，首个脏写入后最多延迟 SYS_KV_COMMIT_DELAY_MS，
+      期间的所有写入合并为一次提交
+*/
+
+#define KV_FLUSH_TASK_STACK 3072
+#define KV_FLUSH_TASK_PRIO  2
+
+typedef enum {
+    KV_T_I32 = 1,
+    KV_T_FLOAT,     // 以 u32 位模式保存
+    KV_T_STR,       // 长度含结尾'\0'
+    KV_T_BLOB,
+} kv_type_t;
+
+typedef struct {
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    uint8_t type;
+    bool used;
+    bool dirty;     // 尚未写回 flash
+    bool erased;    // 已删除（脏时表示待删除，干净时为不存在的缓存）
+    bool retype;    // 类型发生变化，写回前需先删除旧条目
+    uint16_t len;
+    uint32_t last_use;
+    union {
+        int32_t i32;
+        uint32_t u32;
+        uint8_t *ptr;
+    } v;
+} kv_entry_t;
+
+static nvs_handle_t kv_handle;
+static bool kv_ready = false;
+static SemaphoreHandle_t kv_mutex = NULL;
+static TaskHandle_t kv_flush_task_handle = NULL;
+static kv_entry_t kv_cache[SYS_KV_CACHE_SIZE];
+static uint32_t kv_clock = 0;
+static bool kv_commit_pending = false;     // 直写的大数据等待提交
+static sys_kv_stats_t kv_stats;
+
+static bool kv_is_ptr_type(uint8_t type)
+{
+    return type == KV_T_STR || type == KV_T_BLOB;
+}
+
+static void kv_entry_free_value(kv_entry_t *e)
+{
+    if (kv_is_ptr_type(e->type) && e->v.ptr) {
+        free(e->v.ptr);
+    }
+    e->v.ptr = NULL;
+    e->len = 0;
+}
+
+static kv_entry_t *kv_find(const char *key)
+{
+    for (int i = 0; i < SYS_KV_CACHE_SIZE; i++) {
+        if (kv_cache[i].used && strcmp(kv_cache[i].key, key) == 0) {
+            kv_cache[i].last_use = ++kv_clock;
+            return &kv_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t kv_write_entry(kv_entry_t *e)
+{
+    esp_err_t err = ESP_OK;
+
+    if (e->erased || e->retype) {
+        err = nvs_erase_key(kv_handle, e->key);
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            err = ESP_OK;
+        }
+        kv_stats.nvs_writes++;
+    }
+    if (err == ESP_OK && !e->erased) {
+        switch (e->type) {
+        case KV_T_I32:
+            err = nvs_set_i32(kv_handle, e->key, e->v.i32);
+            break;
+        case KV_T_FLOAT:
+            err = nvs_set_u32(kv_handle, e->key, e->v.u32);
+            break;
+        case KV_T_STR:
+            err = nvs_set_str(kv_handle, e->key, (const char *)e->v.ptr);
+            break;
+        case KV_T_BLOB:
+            err = nvs_set_blob(kv_handle, e->key, e->v.ptr, e->len);
+            break;
+        default:
+            err = ESP_ERR_INVALID_STATE;
+            break;
+        }
+        kv_stats.nvs_writes++;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error writing NVS key '%s': %s", e->key, esp_err_to_name(err));
+        return err;
+    }
+    e->dirty = false;
+    e->retype = false;
+    return ESP_OK;
+}
+
+static esp_err_t kv_flush_locked(void)
+{
+    esp_err_t result = ESP_OK;
+    bool written = kv_commit_pending;
+
+    for (int i = 0; i < SYS_KV_CACHE_SIZE; i++) {
+        kv_entry_t *e = &kv_cache[i];
+        if (!e->used || !e->dirty) {
+            continue;
+        }
+        esp_err_t err = kv_write_entry(e);
+        if (err != ESP_OK) {
+            result = err;
+        }
+        written = true;
+    }
+
+    if (written) {
+        esp_err_t err = nvs_commit(kv_handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Error committing NVS changes: %s", esp_err_to_name(err));
+            result = err;
+        } else {
+            kv_commit_pending = false;
+            kv_stats.commits++;
+        }
+    }
+    return result;
+}
+
+/* 分配缓存条目，缓存已满时淘汰最久未用的干净条目 */
+static kv_entry_t *kv_alloc(const char *key)
+{
+    kv_entry_t *victim = NULL;
+
+    for (int pass = 0; pass < 2 && !victim; pass++) {
+        for (int i = 0; i < SYS_KV_CACHE_SIZE; i++) {
+            kv_entry_t *e = &kv_cache[i];
+            if (!e->used) {
+                victim = e;
+                break;
+            }
+            if (!e->dirty && (!victim || e->last_use < victim->last_use)) {
+                victim = e;
+            }
+        }
+        if (!victim) {
+            // 全部为脏条目，先写回再淘汰
+            kv_flush_locked();
+        }
+    }
+    if (!victim) {
+        return NULL;
+    }
+
+    if (victim->used) {
+        kv_entry_free_value(victim);
+    }
+    memset(victim, 0, sizeof(*victim));
+    strcpy(victim->key, key);
+    victim->used = true;
+    victim->last_use = ++kv_clock;
+    return victim;
+}
+
+static void kv_schedule_flush(void)
+{
+    if (kv_flush_task_handle) {
+        xTaskNotifyGive(kv_flush_task_handle);
+    }
+}
+
+static void kv_flush_task(void *arg)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // 合并窗口：窗口内的后续写入不会推迟本次写回
+        vTaskDelay(pdMS_TO_TICKS(SYS_KV_COMMIT_DELAY_MS));
+        ulTaskNotifyTake(pdTRUE, 0);
+        sys_kv_flush();
+    }
+}
+
+static esp_err_t kv_check(const char *key)
+{
+    if (!kv_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!key || !*key || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+/* 把缓存条目的值复制给调用方 */
+static esp_err_t kv_copy_out(const kv_entry_t *e, void *buf, size_t *len)
+{
+    if (!kv_is_ptr_type(e->type)) {
+        memcpy(buf, &e->v.u32, sizeof(uint32_t));
+        return ESP_OK;
+    }
+    size_t cap = *len;
+    *len = e->len;
+    if (!buf) {
+        return ESP_OK;
+    }
+    if (cap < e->len) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(buf, e->v.ptr, e->len);
+    return ESP_OK;
+}
+
+/* 缓存未命中时从 NVS 读取，可缓存的值同时放入缓存 */
+static esp_err_t kv_load(const char *key, kv_type_t type, void *buf, size_t *len)
+{
+    esp_err_t err;
+    kv_entry_t *e;
+
+    kv_stats.misses++;
+
+    if (!kv_is_ptr_type(type)) {
+        uint32_t raw;
+        err = (type == KV_T_I32) ? nvs_get_i32(kv_handle, key, (int32_t *)&raw)
+                                 : nvs_get_u32(kv_handle, key, &raw);
+        if (err != ESP_OK) {
+            return err;
+        }
+        e = kv_alloc(key);
+        if (e) {
+            e->type = type;
+            e->v.u32 = raw;
+        }
+        memcpy(buf, &raw, sizeof(raw));
+        return ESP_OK;
+    }
+
+    size_t need = 0;
+    err = (type == KV_T_STR) ? nvs_get_str(kv_handle, key, NULL, &need)
+                             : nvs_get_blob(kv_handle, key, NULL, &need);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (need > SYS_KV_CACHE_MAX_VAL) {
+        // 大数据不缓存，直接读入调用方缓冲区
+        if (!buf) {
+            *len = need;
+            return ESP_OK;
+        }
+        return (type == KV_T_STR) ? nvs_get_str(kv_handle, key, buf, len)
+                                  : nvs_get_blob(kv_handle, key, buf, len);
+    }
+
+    uint8_t *data = malloc(need ? need : 1);
+    if (!data) {
+        return ESP_ERR_NO_MEM;
+    }
+    size_t got = need;
+    err = (type == KV_T_STR) ? nvs_get_str(kv_handle, key, (char *)data, &got)
+                             : nvs_get_blob(kv_handle, key, data, &got);
+    if (err != ESP_OK) {
+        free(data);
+        return err;
+    }
+
+    e = kv_alloc(key);
+    if (!e) {
+        free(data);
+        return ESP_ERR_NO_MEM;
+    }
+    e->type = type;
+    e->v.ptr = data;
+    e->len = got;
+    return kv_copy_out(e, buf, len);
+}
+
+static esp_err_t kv_get(const char *key, kv_type_t type, void *buf, size_t *len)
+{
+    esp_err_t err = kv_check(key);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (kv_is_ptr_type(type) && !len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(kv_mutex, portMAX_DELAY);
+    kv_entry_t *e = kv_find(key);
+    if (e) {
+        kv_stats.hits++;
+        if (e->erased) {
+            err = ESP_ERR_NVS_NOT_FOUND;
+        } else if (e->type != type) {
+            err = ESP_ERR_NVS_TYPE_MISMATCH;
+        } else {
+            err = kv_copy_out(e, buf, len);
+        }
+    } else {
+        err = kv_load(key, type, buf, len);
+    }
+    xSemaphoreGive(kv_mutex);
+    return err;
+}
+
+static esp_err_t kv_set(const char *key, kv_type_t type, const void *data, size_t len)
+{
+    esp_err_t err = kv_check(key);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    xSemaphoreTake(kv_mutex, portMAX_DELAY);
+    kv_entry_t *e = kv_find(key);
+
+    // 值未变化时不产生任何写入
+    if (e && !e->erased && e->type == type) {
+        bool same = kv_is_ptr_type(type) ? (e->len == len && memcmp(e->v.ptr, data, len) == 0)
+                                         : memcmp(&e->v.u32, data, sizeof(uint32_t)) == 0;
+        if (same) {
+            kv_stats.skipped++;
+            xSemaphoreGive(kv_mutex);
+            return ESP_OK;
+        }
+    }
+
+    // 旧条目类型不同或有待执行的删除时，写回前需要先删除 NVS 中的旧条目
+    bool retype = e && (e->retype || (e->erased ? e->dirty : e->type != type));
+
+    if (kv_is_ptr_type(type) && len > SYS_KV_CACHE_MAX_VAL) {
+        // 大数据直写 NVS，只延迟提交
+        if (e) {
+            if (retype) {
+                nvs_erase_key(kv_handle, key);
+                kv_stats.nvs_writes++;
+            }
+            kv_entry_free_value(e);
+            e->used = false;
+        }
+        err = (type == KV_T_STR) ? nvs_set_str(kv_handle, key, data)
+                                 : nvs_set_blob(kv_handle, key, data, len);
+        kv_stats.nvs_writes++;
+        if (err == ESP_OK) {
+            kv_commit_pending = true;
+            kv_schedule_flush();
+        } else {
+            ESP_LOGE(TAG, "Error setting NVS key '%s': %s", key, esp_err_to_name(err));
+        }
+        xSemaphoreGive(kv_mutex);
+        return err;
+    }
+
+    uint8_t *copy = NULL;
+    if (kv_is_ptr_type(type)) {
+        copy = malloc(len ? len : 1);
+        if (!copy) {
+            xSemaphoreGive(kv_mutex);
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(copy, data, len);
+    }
+
+    if (e) {
+        kv_entry_free_value(e);
+    } else {
+        e = kv_alloc(key);
+        if (!e) {
+            free(copy);
+            xSemaphoreGive(kv_mutex);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    e->type = type;
+    e->erased = false;
+    e->retype = retype;
+    e->dirty = true;
+    if (copy) {
+        e->v.ptr = copy;
+        e->len = len;
+    } else {
+        memcpy(&e->v.u32, data, sizeof(uint32_t));
+    }
+
+    kv_schedule_flush();
+    xSemaphoreGive(kv_mutex);
+    return ESP_OK;
+}
+
+esp_err_t sys_kv_init(void)
+{
+    if (kv_ready) {
+        return ESP_OK;
+    }
+
+    kv_mutex = xSemaphoreCreateMutex();
+    if (!kv_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = nvs_open(SYS_KV_NAMESPACE, NVS_READWRITE, &kv_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        vSemaphoreDelete(kv_mutex);
+        kv_mutex = NULL;
+        return err;
+    }
+
+    if (xTaskCreate(kv_flush_task, "kv_flush", KV_FLUSH_TASK_STACK, NULL, KV_FLUSH_TASK_PRIO,
+                    &kv_flush_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create flush task");
+        nvs_close(kv_handle);
+        vSemaphoreDelete(kv_mutex);
+        kv_mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(kv_cache, 0, sizeof(kv_cache));
+    kv_ready = true;
+    ESP_LOGI(TAG, "KV store ready, namespace '%s'", SYS_KV_NAMESPACE);
+    return ESP_OK;
+}
+
+esp_err_t sys_kv_get_i32(const char *key, int32_t *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return kv_get(key, KV_T_I32, out, NULL);
+}
+
+esp_err_t sys_kv_set_i32(const char *key, int32_t value)
+{
+    return kv_set(key, KV_T_I32, &value, sizeof(value));
+}
+
+esp_err_t sys_kv_get_float(const char *key, float *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return kv_get(key, KV_T_FLOAT, out, NULL);
+}
+
+esp_err_t sys_kv_set_float(const char *key, float value)
+{
+    return kv_set(key, KV_T_FLOAT, &value, sizeof(value));
+}
+
+esp_err_t sys_kv_get_str(const char *key, char *buf, size_t *len)
+{
+    return kv_get(key, KV_T_STR, buf, len);
+}
+
+esp_err_t sys_kv_set_str(const char *key, const char *value)
+{
+    if (!value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return kv_set(key, KV_T_STR, value, strlen(value) + 1);
+}
+
+esp_err_t sys_kv_get_blob(const char *key, void *buf, size_t *len)
+{
+    return kv_get(key, KV_T_BLOB, buf, len);
+}
+
+esp_err_t sys_kv_set_blob(const char *key, const void *data, size_t len)
+{
+    if (!data && len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return kv_set(key, KV_T_BLOB, data, len);
+}
+
+esp_err_t sys_kv_erase(const char *key)
+{
+    esp_err_t err = kv_check(key);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    xSemaphoreTake(kv_mutex, portMAX_DELAY);
+    kv_entry_t *e = kv_find(key);
+    if (!e) {
+        e = kv_alloc(key);
+    } else if (e->erased) {
+        xSemaphoreGive(kv_mutex);
+        return ESP_OK;
+    }
+    if (e) {
+        kv_entry_free_value(e);
+        e->erased = true;
+        e->dirty = true;
+        kv_schedule_flush();
+    } else {
+        err = ESP_ERR_NO_MEM;
+    }
+    xSemaphoreGive(kv_mutex);
+    return err;
+}
+
+esp_err_t sys_kv_flush(void)
+{
+    if (!kv_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(kv_mutex, portMAX_DELAY);
+    esp_err_t err = kv_flush_locked();
+    xSemaphoreGive(kv_mutex);
+    return err;
+}
+
+void sys_kv_get_stats(sys_kv_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    if (!kv_ready) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    xSemaphoreTake(kv_mutex, portMAX_DELAY);
+    *stats = kv_stats;
+    xSemaphoreGive(kv_mutex);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file sys_kv.h
+ * @brief 键值存储（NVS 写回缓存）
+ *
+ * 在 NVS 命名空间 "storage" 之上提供类型化的键值读写：
+ * - 启动时打开一次句柄并一直持有，不再每次访问都 nvs_open/nvs_close
+ * - 读写使用调用方提供的缓冲区，可重入、线程安全
+ * - 小数据在内存中缓存，写入先标记为脏，延迟合并后统一写入 flash 并 nvs_commit，
+ *   相同值的重复写入不会产生 flash 写操作
+ * - 超过 SYS_KV_CACHE_MAX_VAL 的字符串/二进制数据直接写入 NVS，仅延迟提交
+ *
+ * 每个键只保存一种类型，用其它类型读取会返回 ESP_ERR_NVS_TYPE_MISMATCH
+ * （已缓存时）或 ESP_ERR_NVS_NOT_FOUND（从 NVS 读取时）。
+ * 关机或断电前应调用 sys_kv_flush()。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "nvs.h"
+
+#define SYS_KV_NAMESPACE        "storage"
+#define SYS_KV_CACHE_SIZE       32      // 缓存条目数
+#define SYS_KV_CACHE_MAX_VAL    128     // 可缓存的最大字符串/二进制长度（字节）
+#define SYS_KV_COMMIT_DELAY_MS  3000    // 首次写入到写回 flash 的最长延迟
+
+/**
+ * 键值存储统计
+ */
+typedef struct {
+    uint32_t hits;          // 缓存命中次数
+    uint32_t misses;        // 缓存未命中（读 NVS）次数
+    uint32_t skipped;       // 值未变化而省去的写入次数
+    uint32_t nvs_writes;    // 实际 nvs_set/nvs_erase 次数
+    uint32_t commits;       // nvs_commit 次数
+} sys_kv_stats_t;
+
+/**
+ * 初始化键值存储
+ * 需在 nvs_flash_init() 之后调用，可重复调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_init(void);
+
+/**
+ * 读取整数
+ * @param key 键（最长15字符）
+ * @param out 输出值
+ * @return esp_err_t ESP_OK / ESP_ERR_NVS_NOT_FOUND / ESP_ERR_NVS_TYPE_MISMATCH 等
+ */
+esp_err_t sys_kv_get_i32(const char *key, int32_t *out);
+
+/**
+ * 写入整数
+ * @param key 键
+ * @param value 值
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_set_i32(const char *key, int32_t value);
+
+/**
+ * 读取浮点数
+ * @param key 键
+ * @param out 输出值
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_get_float(const char *key, float *out);
+
+/**
+ * 写入浮点数
+ * @param key 键
+ * @param value 值
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_set_float(const char *key, float value);
+
+/**
+ * 读取字符串
+ * @param key 键
+ * @param buf 输出缓冲区，为 NULL 时仅返回所需长度
+ * @param len 输入为缓冲区大小，输出为字符串长度（含结尾'\0'）
+ * @return esp_err_t 缓冲区不足时返回 ESP_ERR_NVS_INVALID_LENGTH
+ */
+esp_err_t sys_kv_get_str(const char *key, char *buf, size_t *len);
+
+/**
+ * 写入字符串
+ * @param key 键
+ * @param value 字符串
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_set_str(const char *key, const char *value);
+
+/**
+ * 读取二进制数据
+ * @param key 键
+ * @param buf 输出缓冲区，为 NULL 时仅返回所需长度
+ * @param len 输入为缓冲区大小，输出为数据长度
+ * @return esp_err_t 缓冲区不足时返回 ESP_ERR_NVS_INVALID_LENGTH
+ */
+esp_err_t sys_kv_get_blob(const char *key, void *buf, size_t *len);
+
+/**
+ * 写入二进制数据
+ * @param key 键
+ * @param data 数据
+ * @param len 数据长度
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_set_blob(const char *key, const void *data, size_t len);
+
+/**
+ * 删除键
+ * @param key 键
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_erase(const char *key);
+
+/**
+ * 立即把所有脏数据写入 flash 并提交
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_kv_flush(void);
+
+/**
+ * 获取统计数据
+ * @param stats 输出统计
+ */
+void sys_kv_get_stats(sys_kv_stats_t *stats);
@@ -3,6 +3,8 @@
  * @brief 核心系统功能支持
  * 
  * 提供文件读写、NVS存储等基础功能接口。
+ * NVS键值读写由 sys_kv.h 提供（缓存句柄、类型化、延迟提交）。
+ * 分块/逐行/二进制文件读写由 sys_file.h 提供。
  */
 
 #pragma once
@@ -20,7 +22,11 @@
 #include "esp_task_wdt.h"
 #include "beepdrive.h"
 #include "nvs.h"
+#include "sys_kv.h"
+#include "sys_file.h"
 #include "esp_sntp.h"
+#include "time_fmt.h"
+#include "sys_tz.h"
 
 /**
  * 获取当前UNIX
@@ -31,35 +37,32 @@ uint32_t sys_get_unix_time(void);
 
 /**
  * 获取当前日期
+ * 返回共享的静态缓冲区，多任务同时调用会互相覆盖，新代码请使用 sys_get_date_r()
  * @param format 日期格式
  * @return char* 当前日期字符串
  */
 char *sys_get_date(const char* format);
 
 /**
- * NVS获取键值
- * @param key 键
- * @return char* 值字符串
- */
-char *sys_nvs_get(const char* key);
-
-/**
- * NVS设置键值
- * @param key 键
- * @param value 值
- * @return esp_err_t 操作结果
+ * 获取当前日期，写入调用方的缓冲区（可重入）
+ * 格式见 time_fmt.h，不支持的格式回退到 strftime；反复使用同一格式时请直接用 time_fmt
+ * @param format 日期格式
+ * @param buf 输出缓冲区
+ * @param len 缓冲区大小
+ * @return size_t 输出长度，缓冲区不足时返回0
  */
-esp_err_t sys_nvs_set(const char* key, const char* value);
+size_t sys_get_date_r(const char *format, char *buf, size_t len);
 
 /**
- * 读取文件
+ * 读取整个文本文件（按文件大小分配内存）
+ * 大文件请使用 sys_file_read_chunks() 或 sys_file_iter_open()
  * @param path 文件路径
- * @return char* 文件内容字符串
+ * @return char* 文件内容字符串，使用 free() 释放
  */
 char *sys_read_file(const char *path);
 
 /**
- * 写入文件
+ * 写入文件（原子替换，掉电不会留下截断的文件）
  * @param path 文件路径
  * @param content 文件内容
  * @return esp_err_t 操作结果
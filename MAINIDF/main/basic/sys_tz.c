@@ -0,0 +1,97 @@
+/**
+ * @file sys_tz.c
+ * @brief 系统时区实现
+ */
+
+#include "sys_tz.h"
+#include <stdlib.h>
+#include "esp_log.h"
+#include "settings.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "sys_tz";
+
+#define SYS_TZ_DEFAULT  "Asia/Shanghai"
+
+static tz_t s_tz;
+static bool s_ready = false;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // 保护 s_tz
+
+static void apply_setting(void)
+{
+    char name[32];
+    tz_t tz;
+
+    settings_get_str(SETTING_TIMEZONE, name, sizeof(name));
+    const tz_zone_t *zone = tz_find(name);
+    if (!zone) {
+        ESP_LOGW(TAG, "Unknown timezone '%s', using %s", name, SYS_TZ_DEFAULT);
+        zone = tz_find(SYS_TZ_DEFAULT);
+    }
+    tz_load(&tz, zone);
+
+    taskENTER_CRITICAL(&s_mux);
+    s_tz = tz;
+    s_ready = true;
+    taskEXIT_CRITICAL(&s_mux);
+
+    setenv("TZ", zone->posix, 1);
+    tzset();
+    ESP_LOGI(TAG, "Timezone %s (%s)", zone->name, zone->posix);
+}
+
+static void on_setting_changed(setting_id_t id, void *arg)
+{
+    apply_setting();
+}
+
+esp_err_t sys_tz_init(void)
+{
+    if (s_ready) {
+        return ESP_OK;
+    }
+    apply_setting();
+    return settings_subscribe(SETTING_TIMEZONE, on_setting_changed, NULL);
+}
+
+const tz_zone_t *sys_tz_zone(void)
+{
+    return s_ready ? s_tz.zone : NULL;
+}
+
+esp_err_t sys_tz_set(const char *name)
+{
+    if (!tz_find(name)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return settings_set_str(SETTING_TIMEZONE, name);
+}
+
+int32_t sys_tz_offset(time_t utc)
+{
+    int32_t offset = 0;
+
+    taskENTER_CRITICAL(&s_mux);
+    if (s_ready) {
+        offset = tz_offset(&s_tz, utc, NULL);
+    }
+    taskEXIT_CRITICAL(&s_mux);
+    return offset;
+}
+
+void sys_tz_localtime(time_t utc, struct tm *out)
+{
+    bool dst = false;
+    int32_t offset = 0;
+
+    taskENTER_CRITICAL(&s_mux);
+    if (s_ready) {
+        offset = tz_offset(&s_tz, utc, &dst);
+    }
+    taskEXIT_CRITICAL(&s_mux);
+
+    time_t local = utc + offset;
+    gmtime_r(&local, out);
+    out->tm_isdst = dst;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file sys_tz.h
+ * @brief 系统时区
+ *
+ * 时区名称保存在设置 SETTING_TIMEZONE 中，修改设置后立即生效。
+ * 本地时间换算使用 tz.h 的缓存区间，同一区间内 O(1)；同时设置 TZ 环境变量，
+ * 直接调用 localtime_r()/mktime() 的代码得到相同结果。
+ *
+ * 接口线程安全。
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <time.h>
+#include "esp_err.h"
+#include "tz.h"
+
+/**
+ * 按设置加载时区并订阅变更，需在 settings_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t sys_tz_init(void);
+
+/**
+ * 当前时区
+ * @return const tz_zone_t*
+ */
+const tz_zone_t *sys_tz_zone(void);
+
+/**
+ * 选择时区并保存到设置
+ * @param name IANA 名称，见 tz_zone_get()
+ * @return esp_err_t 不支持的时区返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t sys_tz_set(const char *name);
+
+/**
+ * UTC 时刻对应的本地偏移
+ * @param utc UTC 时刻
+ * @return int32_t 偏移（秒）
+ */
+int32_t sys_tz_offset(time_t utc);
+
+/**
+ * UTC 时刻转换为本地时间，未初始化时按 UTC
+ * @param utc UTC 时刻
+ * @param out 输出
+ */
+void sys_tz_localtime(time_t utc, struct tm *out);
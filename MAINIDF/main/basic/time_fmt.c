@@ -0,0 +1,298 @@
+/**
+ * @file time_fmt.c
+ * @brief 日期时间格式化实现
+ */
+
+#include "time_fmt.h"
+#include <string.h>
+
+/* 字段依赖的时间分量 */
+#define F_SEC   0x01
+#define F_MIN   0x02
+#define F_HOUR  0x04
+#define F_MDAY  0x08
+#define F_MON   0x10
+#define F_YEAR  0x20
+#define F_WDAY  0x40
+#define F_YDAY  0x80
+
+enum {
+    T_LIT,
+    T_YEAR4, T_YEAR2, T_MON, T_MDAY, T_MDAY_SP, T_YDAY,
+    T_HOUR24, T_HOUR12, T_MIN, T_SEC, T_AMPM,
+    T_WDAY_ABBR, T_WDAY_FULL, T_MON_ABBR, T_MON_FULL,
+    T_COUNT,
+};
+
+static const struct {
+    char spec;
+    uint8_t width;      // 0 表示宽度可变
+    uint8_t max;        // 最大宽度
+    uint8_t field;
+} s_specs[T_COUNT] = {
+    [T_YEAR4]     = {'Y', 4, 4, F_YEAR},
+    [T_YEAR2]     = {'y', 2, 2, F_YEAR},
+    [T_MON]       = {'m', 2, 2, F_MON},
+    [T_MDAY]      = {'d', 2, 2, F_MDAY},
+    [T_MDAY_SP]   = {'e', 2, 2, F_MDAY},
+    [T_YDAY]      = {'j', 3, 3, F_YDAY},
+    [T_HOUR24]    = {'H', 2, 2, F_HOUR},
+    [T_HOUR12]    = {'I', 2, 2, F_HOUR},
+    [T_MIN]       = {'M', 2, 2, F_MIN},
+    [T_SEC]       = {'S', 2, 2, F_SEC},
+    [T_AMPM]      = {'p', 2, 2, F_HOUR},
+    [T_WDAY_ABBR] = {'a', 3, 3, F_WDAY},
+    [T_WDAY_FULL] = {'A', 0, 9, F_WDAY},
+    [T_MON_ABBR]  = {'b', 3, 3, F_MON},
+    [T_MON_FULL]  = {'B', 0, 9, F_MON},
+};
+
+static const char *const s_wday[7] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday",
+};
+static const char *const s_mon[12] = {
+    "January", "February", "March", "April", "May", "June",
+    "July", "August", "September", "October", "November", "December",
+};
+
+static int clampi(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static inline void put2(char *out, int v)
+{
+    out[0] = '0' + v / 10;
+    out[1] = '0' + v % 10;
+}
+
+// 输出一个字段，返回长度；out 至少有 s_specs[type].max 字节
+static size_t render(uint8_t type, const struct tm *tm, char *out)
+{
+    int v;
+
+    switch (type) {
+    case T_YEAR4:
+        v = clampi(tm->tm_year + 1900, 0, 9999);
+        put2(out, v / 100);
+        put2(out + 2, v % 100);
+        return 4;
+    case T_YEAR2:
+        put2(out, clampi(tm->tm_year + 1900, 0, 9999) % 100);
+        return 2;
+    case T_MON:
+        put2(out, clampi(tm->tm_mon + 1, 1, 12));
+        return 2;
+    case T_MDAY:
+        put2(out, clampi(tm->tm_mday, 1, 31));
+        return 2;
+    case T_MDAY_SP:
+        put2(out, clampi(tm->tm_mday, 1, 31));
+        if (out[0] == '0') {
+            out[0] = ' ';
+        }
+        return 2;
+    case T_YDAY:
+        v = clampi(tm->tm_yday + 1, 1, 366);
+        out[0] = '0' + v / 100;
+        put2(out + 1, v % 100);
+        return 3;
+    case T_HOUR24:
+        put2(out, clampi(tm->tm_hour, 0, 23));
+        return 2;
+    case T_HOUR12:
+        v = clampi(tm->tm_hour, 0, 23) % 12;
+        put2(out, v ? v : 12);
+        return 2;
+    case T_MIN:
+        put2(out, clampi(tm->tm_min, 0, 59));
+        return 2;
+    case T_SEC:
+        put2(out, clampi(tm->tm_sec, 0, 60));
+        return 2;
+    case T_AMPM:
+        out[0] = tm->tm_hour < 12 ? 'A' : 'P';
+        out[1] = 'M';
+        return 2;
+    case T_WDAY_ABBR:
+        memcpy(out, s_wday[clampi(tm->tm_wday, 0, 6)], 3);
+        return 3;
+    case T_MON_ABBR:
+        memcpy(out, s_mon[clampi(tm->tm_mon, 0, 11)], 3);
+        return 3;
+    case T_WDAY_FULL: {
+        const char *s = s_wday[clampi(tm->tm_wday, 0, 6)];
+        size_t n = strlen(s);
+        memcpy(out, s, n);
+        return n;
+    }
+    case T_MON_FULL: {
+        const char *s = s_mon[clampi(tm->tm_mon, 0, 11)];
+        size_t n = strlen(s);
+        memcpy(out, s, n);
+        return n;
+    }
+    default:
+        return 0;
+    }
+}
+
+static esp_err_t add_lit(time_fmt_t *f, uint8_t *lit_len, const char *s, size_t n)
+{
+    if (*lit_len + n > TIME_FMT_MAX_LEN - 1) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // 与前一个文本段相邻时合并
+    if (f->count == 0 || f->tok[f->count - 1].type != T_LIT) {
+        if (f->count == TIME_FMT_MAX_TOKENS) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        f->tok[f->count].type = T_LIT;
+        f->tok[f->count].off = *lit_len;
+        f->tok[f->count].len = 0;
+        f->count++;
+    }
+    memcpy(&f->lit[*lit_len], s, n);
+    *lit_len += n;
+    f->tok[f->count - 1].len += n;
+    return ESP_OK;
+}
+
+esp_err_t time_fmt_compile(time_fmt_t *f, const char *fmt)
+{
+    uint8_t lit_len = 0;
+    size_t max_len = 0;
+
+    memset(f, 0, sizeof(*f));
+    while (*fmt) {
+        const char *p = strchr(fmt, '%');
+        size_t n = p ? (size_t)(p - fmt) : strlen(fmt);
+        if (n) {
+            esp_err_t err = add_lit(f, &lit_len, fmt, n);
+            if (err != ESP_OK) {
+                return err;
+            }
+            max_len += n;
+            fmt += n;
+            continue;
+        }
+
+        char spec = fmt[1];
+        fmt += spec ? 2 : 1;
+        if (spec == '%') {
+            esp_err_t err = add_lit(f, &lit_len, "%", 1);
+            if (err != ESP_OK) {
+                return err;
+            }
+            max_len++;
+            continue;
+        }
+
+        uint8_t type = T_LIT;
+        for (uint8_t t = T_LIT + 1; t < T_COUNT; t++) {
+            if (s_specs[t].spec == spec) {
+                type = t;
+                break;
+            }
+        }
+        if (type == T_LIT) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        if (f->count == TIME_FMT_MAX_TOKENS) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        f->tok[f->count++].type = type;
+        max_len += s_specs[type].max;
+        f->fields |= s_specs[type].field;
+        if (s_specs[type].width == 0) {
+            f->var_fields |= s_specs[type].field;
+        }
+    }
+
+    if (max_len > TIME_FMT_MAX_LEN - 1) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    f->max_len = max_len;
+    return ESP_OK;
+}
+
+static size_t format_full(const time_fmt_t *f, const struct tm *tm, char *buf, uint8_t *pos)
+{
+    size_t n = 0;
+
+    for (uint8_t i = 0; i < f->count; i++) {
+        if (pos) {
+            pos[i] = n;
+        }
+        if (f->tok[i].type == T_LIT) {
+            memcpy(buf + n, &f->lit[f->tok[i].off], f->tok[i].len);
+            n += f->tok[i].len;
+        } else {
+            n += render(f->tok[i].type, tm, buf + n);
+        }
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+size_t time_fmt_format(const time_fmt_t *f, const struct tm *tm, char *buf, size_t len)
+{
+    if (len > f->max_len) {
+        return format_full(f, tm, buf, NULL);
+    }
+
+    // 缓冲区可能不够，先写到临时区
+    char tmp[TIME_FMT_MAX_LEN];
+    size_t n = format_full(f, tm, tmp, NULL);
+    if (n >= len) {
+        return 0;
+    }
+    memcpy(buf, tmp, n + 1);
+    return n;
+}
+
+static uint16_t changed_fields(const struct tm *a, const struct tm *b)
+{
+    uint16_t m = 0;
+
+    m |= a->tm_sec != b->tm_sec ? F_SEC : 0;
+    m |= a->tm_min != b->tm_min ? F_MIN : 0;
+    m |= a->tm_hour != b->tm_hour ? F_HOUR : 0;
+    m |= a->tm_mday != b->tm_mday ? F_MDAY : 0;
+    m |= a->tm_mon != b->tm_mon ? F_MON : 0;
+    m |= a->tm_year != b->tm_year ? F_YEAR : 0;
+    m |= a->tm_wday != b->tm_wday ? F_WDAY : 0;
+    m |= a->tm_yday != b->tm_yday ? F_YDAY : 0;
+    return m;
+}
+
+bool time_fmt_update(const time_fmt_t *f, time_fmt_cache_t *cache, const struct tm *tm)
+{
+    if (!cache->valid) {
+        format_full(f, tm, cache->buf, cache->pos);
+        cache->tm = *tm;
+        cache->valid = true;
+        return true;
+    }
+
+    uint16_t changed = changed_fields(&cache->tm, tm) & f->fields;
+    cache->tm = *tm;
+    if (changed == 0) {
+        return false;
+    }
+    if (changed & f->var_fields) {
+        // 可变宽度字段变化，后面的位置都会移动
+        format_full(f, tm, cache->buf, cache->pos);
+        return true;
+    }
+
+    // 宽度固定，原位重写受影响的字段
+    for (uint8_t i = 0; i < f->count; i++) {
+        uint8_t type = f->tok[i].type;
+        if (type != T_LIT && (s_specs[type].field & changed)) {
+            render(type, tm, cache->buf + cache->pos[i]);
+        }
+    }
+    return true;
+}
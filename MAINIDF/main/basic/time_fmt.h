@@ -0,0 +1,76 @@
+/**
+ * @file time_fmt.h
+ * @brief 日期时间格式化
+ *
+ * 格式串先用 time_fmt_compile() 解析成描述符，之后每次格式化只按描述符填数字，
+ * 不再解析格式串；输出写入调用方提供的缓冲区，不使用静态缓冲区、不分配内存，可重入。
+ *
+ * 支持的格式（与 strftime 的 C locale 一致）：
+ *   %Y 年(4位)  %y 年(2位)  %m 月  %d 日  %e 日(空格补齐)  %j 年内第几天
+ *   %H 时(24)  %I 时(12)  %M 分  %S 秒  %p AM/PM
+ *   %a/%A 星期缩写/全称  %b/%B 月份缩写/全称  %%
+ * 其他字符（包括中文）原样输出。
+ *
+ * 需要周期刷新的显示（如每秒刷新的时钟）使用 time_fmt_update()：
+ * 缓存上一次的结果，只重写值发生变化的字段，只有秒变化时只改两个字符。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+#include "esp_err.h"
+
+#define TIME_FMT_MAX_TOKENS     16      // 格式串最多的字段+文本段数
+#define TIME_FMT_MAX_LEN        64      // 输出最大长度（含'\0'），也是文本段总长上限
+
+/** 编译后的格式 */
+typedef struct {
+    struct {
+        uint8_t type;       // 字段类型，内部使用
+        uint8_t off;        // 文本段在 lit 中的位置
+        uint8_t len;        // 文本段长度
+    } tok[TIME_FMT_MAX_TOKENS];
+    uint8_t count;
+    uint8_t max_len;        // 最长输出（不含'\0'）
+    uint16_t fields;        // 格式用到的时间分量
+    uint16_t var_fields;    // 输出宽度可变的字段依赖的时间分量
+    char lit[TIME_FMT_MAX_LEN];
+} time_fmt_t;
+
+/** 增量格式化的缓存 */
+typedef struct {
+    char buf[TIME_FMT_MAX_LEN];     // 当前文本
+    uint8_t pos[TIME_FMT_MAX_TOKENS]; // 各段在 buf 中的位置
+    struct tm tm;                   // 生成 buf 时的时间
+    bool valid;
+} time_fmt_cache_t;
+
+/**
+ * 解析格式串
+ * @param f 输出描述符
+ * @param fmt 格式串
+ * @return esp_err_t 不支持的格式返回 ESP_ERR_NOT_SUPPORTED，过长返回 ESP_ERR_INVALID_SIZE
+ */
+esp_err_t time_fmt_compile(time_fmt_t *f, const char *fmt);
+
+/**
+ * 格式化
+ * @param f 描述符
+ * @param tm 时间
+ * @param buf 输出缓冲区
+ * @param len 缓冲区大小
+ * @return size_t 输出长度（不含'\0'），缓冲区不足时返回0（与 strftime 相同）
+ */
+size_t time_fmt_format(const time_fmt_t *f, const struct tm *tm, char *buf, size_t len);
+
+/**
+ * 增量格式化，结果在 cache->buf 中
+ * @param f 描述符
+ * @param cache 缓存，首次使用前清零
+ * @param tm 时间
+ * @return bool 文本有变化
+ */
+bool time_fmt_update(const time_fmt_t *f, time_fmt_cache_t *cache, const struct tm *tm);
@@ -0,0 +1,343 @@
+/**
+ * @file timesync.c
+ * @brief 网络对时服务实现
+ *
+ * 覆盖 ESP-IDF 的弱函数 sntp_sync_time()，SNTP 收到应答后不直接修改时间，
+ * 而是把结果送到对时任务，由任务决定直接设置还是平滑调整，并更新漂移估计。
+ */
+
+#include "timesync.h"
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_sntp.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "clock_drift.h"
+#include "sys_kv.h"
+#include "wifi_mgr.h"
+
+static const char *TAG = "timesync";
+
+ESP_EVENT_DEFINE_BASE(TIMESYNC_EVENT);
+
+#define TIMESYNC_TASK_STACK     3072
+#define TIMESYNC_TASK_PRIO      3
+#define SNTP_TIMEOUT_MS         30000   // 等待服务器应答的时间
+#define STEP_THRESHOLD_MS       60000   // 偏差超过此值直接设置时间，否则平滑调整
+#define VALID_AFTER_UNIX        1704067200 // 2024-01-01，早于此时间认为系统时间无效
+
+#define KEY_DRIFT_PPM   "clk_ppm"
+#define KEY_DRIFT_ERR   "clk_err"
+#define KEY_DRIFT_N     "clk_n"
+
+typedef enum {
+    CMD_NET_UP,
+    CMD_NET_DOWN,
+    CMD_SYNCED,
+    CMD_REQUEST,
+} cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    int64_t mono_us;        // CMD_SYNCED：收到应答时的单调时钟
+    int64_t server_us;      // 服务器时间
+    int64_t local_us;       // 收到应答时的系统时间
+} timesync_cmd_t;
+
+static QueueHandle_t s_cmd_queue = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // 保护 s_stats
+static timesync_stats_t s_stats;
+
+/* 以下只在对时任务中访问 */
+static volatile bool s_valid = false;
+static bool s_net_up = false;
+static bool s_sntp_running = false;
+static int64_t s_next_sync_us = 0;      // 单调时钟，0 表示尽快对时
+static int64_t s_sntp_deadline_us;
+static int64_t s_last_trim_us;
+static clock_drift_t s_drift;
+
+static int64_t now_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+// SNTP 收到应答，在 lwIP 任务中执行
+void sntp_sync_time(struct timeval *tv)
+{
+    timesync_cmd_t cmd = {
+        .type = CMD_SYNCED,
+        .mono_us = esp_timer_get_time(),
+        .server_us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec,
+        .local_us = now_us(),
+    };
+
+    if (s_cmd_queue) {
+        xQueueSend(s_cmd_queue, &cmd, 0);
+    }
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+static void send_simple(cmd_type_t type)
+{
+    timesync_cmd_t cmd = {.type = type};
+    xQueueSend(s_cmd_queue, &cmd, pdMS_TO_TICKS(100));
+}
+
+static void wifi_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    if (id == WIFI_MGR_EVENT_CONNECTED) {
+        send_simple(CMD_NET_UP);
+    } else if (id == WIFI_MGR_EVENT_DISCONNECTED) {
+        send_simple(CMD_NET_DOWN);
+    }
+}
+
+static void sntp_start(void)
+{
+    if (s_sntp_running) {
+        return;
+    }
+
+    esp_sntp_setoperatingmode(ESP_SNTP_OPMODE_POLL);
+    esp_sntp_setservername(0, TIMESYNC_SERVER);
+#if CONFIG_LWIP_SNTP_MAX_SERVERS > 1
+    esp_sntp_setservername(1, TIMESYNC_SERVER_2);
+#endif
+    esp_sntp_init();
+    s_sntp_running = true;
+    s_sntp_deadline_us = esp_timer_get_time() + SNTP_TIMEOUT_MS * 1000LL;
+    ESP_LOGI(TAG, "Sync started");
+}
+
+static void sntp_halt(void)
+{
+    if (s_sntp_running) {
+        esp_sntp_stop();
+        s_sntp_running = false;
+    }
+}
+
+static void schedule(uint32_t interval_ms)
+{
+    s_next_sync_us = esp_timer_get_time() + interval_ms * 1000LL;
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.interval_ms = interval_ms;
+    taskEXIT_CRITICAL(&s_mux);
+}
+
+static void save_drift(void)
+{
+    sys_kv_set_float(KEY_DRIFT_PPM, s_drift.ppm);
+    sys_kv_set_float(KEY_DRIFT_ERR, s_drift.err_ppm);
+    sys_kv_set_i32(KEY_DRIFT_N, s_drift.samples);
+}
+
+static void on_synced(const timesync_cmd_t *cmd)
+{
+    sntp_halt();
+
+    int64_t offset_us = cmd->local_us - cmd->server_us;
+    bool stepped = clock_drift_need_step(s_valid, offset_us, STEP_THRESHOLD_MS * 1000LL);
+
+    if (stepped) {
+        // 补上从收到应答到现在经过的时间
+        int64_t t = cmd->server_us + (esp_timer_get_time() - cmd->mono_us);
+        struct timeval tv = {
+            .tv_sec = t / 1000000,
+            .tv_usec = t % 1000000,
+        };
+        settimeofday(&tv, NULL);
+    } else {
+        // 新的测量取代尚未完成的调整
+        struct timeval delta = {
+            .tv_sec = -offset_us / 1000000,
+            .tv_usec = -offset_us % 1000000,
+        };
+        adjtime(&delta, NULL);
+    }
+    s_valid = true;
+    s_last_trim_us = cmd->mono_us;
+
+    if (clock_drift_update(&s_drift, cmd->mono_us, cmd->server_us)) {
+        save_drift();
+    }
+    uint32_t interval = clock_drift_interval_ms(&s_drift, TIMESYNC_TOLERANCE_MS,
+                                                TIMESYNC_MIN_INTERVAL_MS, TIMESYNC_MAX_INTERVAL_MS);
+    schedule(interval);
+
+    int32_t offset_ms = (int32_t)(offset_us / 1000);
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.syncs++;
+    if (!stepped) {
+        s_stats.last_offset_ms = offset_ms;
+        if (abs(offset_ms) > s_stats.max_offset_ms) {
+            s_stats.max_offset_ms = abs(offset_ms);
+        }
+    }
+    s_stats.drift_ppm = s_drift.ppm;
+    s_stats.drift_err_ppm = s_drift.err_ppm;
+    taskEXIT_CRITICAL(&s_mux);
+
+    ESP_LOGI(TAG, "Synced, offset %ld ms (%s), drift %.2f +/- %.2f ppm (%u samples), next in %lu s",
+             (long)offset_ms, stepped ? "step" : "slew", s_drift.ppm, s_drift.err_ppm, s_drift.samples,
+             (unsigned long)(interval / 1000));
+
+    timesync_info_t info = {
+        .offset_ms = offset_ms,
+        .stepped = stepped,
+        .next_ms = interval,
+    };
+    esp_event_post(TIMESYNC_EVENT, TIMESYNC_EVENT_SYNCED, &info, sizeof(info), pdMS_TO_TICKS(100));
+}
+
+// 按估计的漂移率补偿自上次补偿以来积累的偏差
+static void trim(void)
+{
+    int64_t mono = esp_timer_get_time();
+    int64_t elapsed = mono - s_last_trim_us;
+    s_last_trim_us = mono;
+    if (clock_drift_predict_us(&s_drift, elapsed) == 0) {
+        return;
+    }
+
+    struct timeval pending;
+    adjtime(NULL, &pending);
+    int64_t pending_us = (int64_t)pending.tv_sec * 1000000 + pending.tv_usec;
+    int64_t total = clock_drift_trim_us(&s_drift, elapsed, pending_us);
+    struct timeval delta = {
+        .tv_sec = total / 1000000,
+        .tv_usec = total % 1000000,
+    };
+    adjtime(&delta, NULL);
+
+    int32_t trim_us = (int32_t)(total - pending_us);
+    ESP_LOGD(TAG, "Trim %ld us", (long)trim_us);
+    esp_event_post(TIMESYNC_EVENT, TIMESYNC_EVENT_TRIMMED, &trim_us, sizeof(trim_us), pdMS_TO_TICKS(100));
+}
+
+static TickType_t next_wait(void)
+{
+    int64_t deadline = INT64_MAX;
+
+    if (s_sntp_running) {
+        deadline = s_sntp_deadline_us;
+    } else if (s_net_up) {
+        deadline = s_next_sync_us;
+    }
+    if (s_valid && s_drift.samples > 0 && s_last_trim_us + TIMESYNC_TRIM_MS * 1000LL < deadline) {
+        deadline = s_last_trim_us + TIMESYNC_TRIM_MS * 1000LL;
+    }
+
+    if (deadline == INT64_MAX) {
+        return portMAX_DELAY;
+    }
+    int64_t now = esp_timer_get_time();
+    return deadline <= now ? 0 : pdMS_TO_TICKS((deadline - now) / 1000) + 1;
+}
+
+static void timesync_task(void *arg)
+{
+    timesync_cmd_t cmd;
+
+    while (1) {
+        if (xQueueReceive(s_cmd_queue, &cmd, next_wait()) == pdTRUE) {
+            switch (cmd.type) {
+            case CMD_NET_UP:
+                s_net_up = true;
+                break;
+            case CMD_NET_DOWN:
+                s_net_up = false;
+                sntp_halt(); // 到时间后等下次连接
+                break;
+            case CMD_SYNCED:
+                if (s_sntp_running) {
+                    on_synced(&cmd);
+                }
+                break;
+            case CMD_REQUEST:
+                s_next_sync_us = 0;
+                break;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (s_sntp_running && now >= s_sntp_deadline_us) {
+            sntp_halt();
+            taskENTER_CRITICAL(&s_mux);
+            s_stats.failures++;
+            taskEXIT_CRITICAL(&s_mux);
+            ESP_LOGW(TAG, "No response, retry in %d s", TIMESYNC_RETRY_MS / 1000);
+            schedule(TIMESYNC_RETRY_MS);
+        }
+        if (!s_sntp_running && s_net_up && now >= s_next_sync_us) {
+            sntp_start();
+        }
+        if (s_valid && s_drift.samples > 0 && now >= s_last_trim_us + TIMESYNC_TRIM_MS * 1000LL) {
+            trim();
+        }
+    }
+}
+
+esp_err_t timesync_init(void)
+{
+    if (s_cmd_queue) {
+        return ESP_OK;
+    }
+
+    float ppm = 0, err = 0;
+    int32_t n = 0;
+    sys_kv_get_float(KEY_DRIFT_PPM, &ppm);
+    sys_kv_get_float(KEY_DRIFT_ERR, &err);
+    sys_kv_get_i32(KEY_DRIFT_N, &n);
+    clock_drift_init(&s_drift, ppm, err, (uint16_t)n);
+    s_stats.drift_ppm = s_drift.ppm;
+    s_stats.drift_err_ppm = s_drift.err_ppm;
+    ESP_LOGI(TAG, "Drift %.2f +/- %.2f ppm (%u samples)", s_drift.ppm, s_drift.err_ppm, s_drift.samples);
+
+    s_valid = time(NULL) >= VALID_AFTER_UNIX;
+    s_cmd_queue = xQueueCreate(4, sizeof(timesync_cmd_t));
+    if (!s_cmd_queue) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(timesync_task, "timesync", TIMESYNC_TASK_STACK, NULL, TIMESYNC_TASK_PRIO, NULL) != pdPASS) {
+        vQueueDelete(s_cmd_queue);
+        s_cmd_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_CONNECTED, wifi_event_cb, NULL);
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_DISCONNECTED, wifi_event_cb, NULL);
+    if (wifi_mgr_get_state() == WIFI_MGR_STATE_CONNECTED) {
+        send_simple(CMD_NET_UP);
+    }
+    return ESP_OK;
+}
+
+bool timesync_is_valid(void)
+{
+    return s_valid;
+}
+
+esp_err_t timesync_request(void)
+{
+    if (!s_cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    send_simple(CMD_REQUEST);
+    return ESP_OK;
+}
+
+void timesync_get_stats(timesync_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+}
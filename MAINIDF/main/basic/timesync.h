@@ -0,0 +1,80 @@
+/**
+ * @file timesync.h
+ * @brief 网络对时服务
+ *
+ * WLAN 连接后通过 SNTP 对时，对时完成即停止 SNTP，按漂移估计决定下次对时时间：
+ * - 首次对时（时间无效或偏差超过 35 分钟）直接设置时间，之后用 adjtime 平滑调整，不跳变
+ * - 用 clock_drift 估计晶振漂移率，保存在 sys_kv 中，重启后继续使用
+ * - 两次对时之间每 TIMESYNC_TRIM_MS 按估计的漂移率微调一次系统时间
+ * - 对时间隔随估计不确定度减小而延长（TIMESYNC_MIN_INTERVAL_MS ~ TIMESYNC_MAX_INTERVAL_MS），
+ *   减少唤醒射频的次数
+ *
+ * 到了对时时间但 WLAN 未连接时不主动连接，等下次连接成功后再对时。
+ * 对时完成后发布 TIMESYNC_EVENT_SYNCED，每次漂移补偿后发布 TIMESYNC_EVENT_TRIMMED；
+ * 按单调时钟计算截止时间的模块（如 alarm）收到这两个事件后应按系统时间重新计算。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#define TIMESYNC_SERVER             "ntp.aliyun.com"
+#define TIMESYNC_SERVER_2           "pool.ntp.org"      // LWIP_SNTP_MAX_SERVERS > 1 时使用
+#define TIMESYNC_TOLERANCE_MS       500                 // 两次对时之间允许积累的误差
+#define TIMESYNC_MIN_INTERVAL_MS    (30 * 60 * 1000)
+#define TIMESYNC_MAX_INTERVAL_MS    (24 * 60 * 60 * 1000)
+#define TIMESYNC_RETRY_MS           (5 * 60 * 1000)     // 对时失败后的重试间隔
+#define TIMESYNC_TRIM_MS            (10 * 60 * 1000)    // 漂移补偿周期
+
+ESP_EVENT_DECLARE_BASE(TIMESYNC_EVENT);
+
+/** TIMESYNC_EVENT 事件 */
+typedef enum {
+    TIMESYNC_EVENT_SYNCED,      // 对时完成，数据为 timesync_info_t
+    TIMESYNC_EVENT_TRIMMED,     // 漂移补偿调整了系统时间，数据为 int32_t 本次追加的调整量（微秒）
+} timesync_event_t;
+
+/** 对时结果 */
+typedef struct {
+    int32_t offset_ms;          // 对时前本地时间与服务器时间的偏差（本地快为正）
+    bool stepped;               // 直接设置了时间（首次对时）
+    uint32_t next_ms;           // 到下次对时的间隔
+} timesync_info_t;
+
+/** 统计信息 */
+typedef struct {
+    uint32_t syncs;             // 对时成功次数
+    uint32_t failures;          // 超时次数
+    int32_t last_offset_ms;     // 最近一次对时的偏差
+    int32_t max_offset_ms;      // 首次对时之后出现的最大偏差（绝对值）
+    float drift_ppm;            // 估计的漂移率
+    float drift_err_ppm;        // 漂移率不确定度
+    uint32_t interval_ms;       // 当前对时间隔
+} timesync_stats_t;
+
+/**
+ * 初始化对时服务，需在 wifi_mgr_init() 和 sys_kv_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t timesync_init(void);
+
+/**
+ * 系统时间是否已经对时
+ * @return bool
+ */
+bool timesync_is_valid(void);
+
+/**
+ * 立即对时（WLAN 未连接时在连接后执行）
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t timesync_request(void);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void timesync_get_stats(timesync_stats_t *stats);
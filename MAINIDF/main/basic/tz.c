@@ -0,0 +1,184 @@
+/**
+ * @file tz.c
+ * @brief 时区与夏令时换算实现
+ */
+
+#include "tz.h"
+#include <string.h>
+
+#define DAY_SEC     86400
+#define NO_RULE     {0, 0, 0, 0}
+
+/* POSIX 串与偏移、规则必须一致，修改时两边一起改 */
+static const tz_zone_t s_zones[] = {
+    {"Asia/Shanghai",       "CST-8",                        480, 480, NO_RULE, NO_RULE},
+    {"Asia/Hong_Kong",      "HKT-8",                        480, 480, NO_RULE, NO_RULE},
+    {"Asia/Taipei",         "CST-8",                        480, 480, NO_RULE, NO_RULE},
+    {"Asia/Singapore",      "<+08>-8",                      480, 480, NO_RULE, NO_RULE},
+    {"Asia/Tokyo",          "JST-9",                        540, 540, NO_RULE, NO_RULE},
+    {"Asia/Seoul",          "KST-9",                        540, 540, NO_RULE, NO_RULE},
+    {"Asia/Kolkata",        "IST-5:30",                     330, 330, NO_RULE, NO_RULE},
+    {"Asia/Dubai",          "<+04>-4",                      240, 240, NO_RULE, NO_RULE},
+    {"Europe/Moscow",       "MSK-3",                        180, 180, NO_RULE, NO_RULE},
+    {"Europe/London",       "GMT0BST,M3.5.0/1,M10.5.0",     0,   60,  {3, 5, 0, 60},  {10, 5, 0, 120}},
+    {"Europe/Berlin",       "CET-1CEST,M3.5.0,M10.5.0/3",   60,  120, {3, 5, 0, 120}, {10, 5, 0, 180}},
+    {"Europe/Paris",        "CET-1CEST,M3.5.0,M10.5.0/3",   60,  120, {3, 5, 0, 120}, {10, 5, 0, 180}},
+    {"America/New_York",    "EST5EDT,M3.2.0,M11.1.0",       -300, -240, {3, 2, 0, 120}, {11, 1, 0, 120}},
+    {"America/Chicago",     "CST6CDT,M3.2.0,M11.1.0",       -360, -300, {3, 2, 0, 120}, {11, 1, 0, 120}},
+    {"America/Denver",      "MST7MDT,M3.2.0,M11.1.0",       -420, -360, {3, 2, 0, 120}, {11, 1, 0, 120}},
+    {"America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0",       -480, -420, {3, 2, 0, 120}, {11, 1, 0, 120}},
+    {"Australia/Sydney",    "AEST-10AEDT,M10.1.0,M4.1.0/3", 600, 660, {10, 1, 0, 120}, {4, 1, 0, 180}},
+    {"Pacific/Auckland",    "NZST-12NZDT,M9.5.0,M4.1.0/3",  720, 780, {9, 5, 0, 120},  {4, 1, 0, 180}},
+    {"UTC",                 "UTC0",                         0,   0,   NO_RULE, NO_RULE},
+};
+
+#define ZONE_COUNT (sizeof(s_zones) / sizeof(s_zones[0]))
+
+// 公历日期到 1970-01-01 的天数
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+// 天数对应的年份
+static int64_t year_from_days(int64_t z)
+{
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = (unsigned)(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    return (int64_t)yoe + era * 400 + (mp >= 10);
+}
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+static bool is_leap(int64_t y)
+{
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+// 规则在 y 年对应的 UTC 时刻，before_min 为切换前的偏移
+static int64_t rule_time(const tz_rule_t *r, int64_t y, int16_t before_min)
+{
+    static const uint8_t mdays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int64_t days;
+
+    if (r->week >= 5) {
+        unsigned last = mdays[r->month - 1] + (r->month == 2 && is_leap(y));
+        days = days_from_civil(y, r->month, last);
+        int wd = (int)((days % 7 + 11) % 7);   // 1970-01-01 是星期四
+        days -= (wd - r->wday + 7) % 7;
+    } else {
+        days = days_from_civil(y, r->month, 1);
+        int wd = (int)((days % 7 + 11) % 7);
+        days += (r->wday - wd + 7) % 7 + (r->week - 1) * 7;
+    }
+    return days * DAY_SEC + (int64_t)(r->minute - before_min) * 60;
+}
+
+// 生成从 first_year 开始的切换表
+static void build(tz_t *tz, int64_t first_year)
+{
+    const tz_zone_t *z = tz->zone;
+
+    tz->first_year = (int16_t)first_year;
+    tz->count = 0;
+    tz->dst_mask = 0;
+    for (int64_t y = first_year; y < first_year + TZ_TABLE_YEARS; y++) {
+        int64_t on = rule_time(&z->start, y, z->std_min);
+        int64_t off = rule_time(&z->end, y, z->dst_min);
+        // 南半球一年内先退出再进入夏令时
+        if (on < off) {
+            tz->dst_mask |= 1u << tz->count;
+            tz->at[tz->count++] = on;
+            tz->at[tz->count++] = off;
+        } else {
+            tz->at[tz->count++] = off;
+            tz->dst_mask |= 1u << tz->count;
+            tz->at[tz->count++] = on;
+        }
+    }
+}
+
+const tz_zone_t *tz_find(const char *name)
+{
+    for (size_t i = 0; i < ZONE_COUNT; i++) {
+        if (strcmp(s_zones[i].name, name) == 0) {
+            return &s_zones[i];
+        }
+    }
+    return NULL;
+}
+
+size_t tz_zone_count(void)
+{
+    return ZONE_COUNT;
+}
+
+const tz_zone_t *tz_zone_get(size_t index)
+{
+    return index < ZONE_COUNT ? &s_zones[index] : NULL;
+}
+
+void tz_load(tz_t *tz, const tz_zone_t *zone)
+{
+    memset(tz, 0, sizeof(*tz));
+    tz->zone = zone;
+    if (zone->dst_min == zone->std_min) {
+        // 无夏令时，整条时间轴一个区间
+        tz->lo = INT64_MIN;
+        tz->hi = INT64_MAX;
+        tz->offset = zone->std_min * 60;
+    }
+}
+
+int32_t tz_offset(tz_t *tz, time_t utc, bool *dst)
+{
+    int64_t t = (int64_t)utc;
+
+    if (t < tz->lo || t >= tz->hi) {
+        if (tz->count == 0 || t < tz->at[0] || t >= tz->at[tz->count - 1]) {
+            // 从前一年开始生成，保证 t 落在表内
+            build(tz, year_from_days(floor_div(t, DAY_SEC)) - 1);
+        }
+
+        // at[lo] <= t < at[hi]
+        uint8_t lo = 0, hi = tz->count - 1;
+        while (hi - lo > 1) {
+            uint8_t mid = (lo + hi) / 2;
+            if (tz->at[mid] <= t) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        tz->lo = tz->at[lo];
+        tz->hi = tz->at[hi];
+        tz->dst = (tz->dst_mask >> lo) & 1;
+        tz->offset = (tz->dst ? tz->zone->dst_min : tz->zone->std_min) * 60;
+    }
+
+    if (dst) {
+        *dst = tz->dst;
+    }
+    return tz->offset;
+}
+
+void tz_localtime(tz_t *tz, time_t utc, struct tm *out)
+{
+    bool dst;
+    time_t local = utc + tz_offset(tz, utc, &dst);
+
+    gmtime_r(&local, out);
+    out->tm_isdst = dst;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file tz.h
+ * @brief 时区与夏令时换算
+ *
+ * 内置常用时区表，每个时区记录标准时间偏移和夏令时规则（与 POSIX TZ 的 Mm.w.d/time 相同）。
+ * 换算时按规则生成一段年份（TZ_TABLE_YEARS）的切换时刻表，并缓存当前所在区间 [lo, hi)：
+ * - 时间落在缓存区间内：直接返回偏移，O(1)
+ * - 跨过切换点：在切换表中二分查找，更新缓存
+ * - 超出切换表的年份范围：以该年份为起点重新生成
+ *
+ * 本模块只做计算，不依赖 ESP-IDF；tz_t 不加锁，多任务共用时由调用方保护（见 sys_tz.h）。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define TZ_TABLE_YEARS      16                      // 切换表覆盖的年数
+#define TZ_MAX_TRANS        (TZ_TABLE_YEARS * 2)
+
+/** 夏令时切换规则：month 月第 week 个星期 wday 的当地 minute 分钟（按切换前的偏移） */
+typedef struct {
+    uint8_t month;          // 1~12
+    uint8_t week;           // 1~4，5 表示最后一个
+    uint8_t wday;           // 0 表示星期日
+    int16_t minute;         // 一天内的分钟数
+} tz_rule_t;
+
+/** 时区定义 */
+typedef struct {
+    const char *name;       // IANA 名称，保存在设置中
+    const char *posix;      // 对应的 POSIX TZ 串
+    int16_t std_min;        // 标准时间的 UTC 偏移（分钟，东正西负）
+    int16_t dst_min;        // 夏令时的 UTC 偏移，与 std_min 相同表示不使用夏令时
+    tz_rule_t start;        // 进入夏令时
+    tz_rule_t end;          // 退出夏令时
+} tz_zone_t;
+
+/** 换算状态 */
+typedef struct {
+    const tz_zone_t *zone;
+    int16_t first_year;     // 切换表的起始年份
+    uint8_t count;          // 切换点个数，0 表示尚未生成
+    uint32_t dst_mask;      // 第 i 位：切换点 i 之后是否为夏令时
+    int64_t at[TZ_MAX_TRANS];   // 切换时刻（UTC 秒），升序
+    int64_t lo, hi;         // 缓存区间 [lo, hi)
+    int32_t offset;         // 缓存区间内的偏移（秒）
+    bool dst;               // 缓存区间内是否为夏令时
+} tz_t;
+
+/**
+ * 按名称查找时区
+ * @param name IANA 名称
+ * @return const tz_zone_t* 未找到返回NULL
+ */
+const tz_zone_t *tz_find(const char *name);
+
+/**
+ * 内置时区个数
+ * @return size_t
+ */
+size_t tz_zone_count(void);
+
+/**
+ * 按序号获取内置时区（用于列表显示）
+ * @param index 序号
+ * @return const tz_zone_t* 越界返回NULL
+ */
+const tz_zone_t *tz_zone_get(size_t index);
+
+/**
+ * 选择时区，清空切换表和缓存
+ * @param tz 状态
+ * @param zone 时区
+ */
+void tz_load(tz_t *tz, const tz_zone_t *zone);
+
+/**
+ * UTC 时刻对应的本地偏移
+ * @param tz 状态
+ * @param utc UTC 时刻
+ * @param dst 输出是否为夏令时，可为NULL
+ * @return int32_t 偏移（秒），本地时间 = utc + 偏移
+ */
+int32_t tz_offset(tz_t *tz, time_t utc, bool *dst);
+
+/**
+ * UTC 时刻转换为本地时间
+ * @param tz 状态
+ * @param utc UTC 时刻
+ * @param out 输出，tm_isdst 按是否夏令时设置
+ */
+void tz_localtime(tz_t *tz, time_t utc, struct tm *out);
@@ -0,0 +1,587 @@
+/**
+ * @file weather.c
+ * @brief 天气与空气质量服务实现
+ *
+ * 调度在天气任务中执行，天气和空气质量两个请求一起提交给 http_pool（可推迟，定时刷新时与其他请求合并），
+ * 天气任务等待两个请求都完成；响应体在 HTTP 任务中送入解析器；
+ * s_data 由天气任务写入，其他任务通过 weather_get() 在临界区内复制。
+ */
+
+#include "weather.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "http_pool.h"
+#include "json_stream.h"
+#include "settings.h"
+#include "sys_file.h"
+#include "timesync.h"
+#include "wifi_mgr.h"
+#include "wifi_policy.h"
+
+static const char *TAG = "weather";
+
+ESP_EVENT_DEFINE_BASE(WEATHER_EVENT);
+
+#define WEATHER_TASK_STACK  4096    // 网络请求在 http_pool 任务中执行
+#define WEATHER_TASK_PRIO   2
+#define WEATHER_FILE_VERSION 1
+#define URL_MAX             320
+#define HAZE_PM25           150.0f  // PM2.5 重度污染，无降水时显示为霾
+
+/* 判断数据有明显变化的阈值 */
+#define CHANGE_TEMP_C       2.0f
+#define CHANGE_AQI          20
+
+/* 失败退避参数 */
+#define BACKOFF_ON  { .base_ms = 60 * 1000,  .max_ms = 30 * 60 * 1000, .jitter_pct = 20 }
+#define BACKOFF_OFF { .base_ms = 120 * 1000, .max_ms = 60 * 60 * 1000, .jitter_pct = 20 }
+
+typedef enum {
+    CMD_NET_UP,
+    CMD_NET_DOWN,
+    CMD_TIME_SYNCED,
+    CMD_REQUEST,
+    CMD_SCREEN_ON,
+    CMD_SCREEN_OFF,
+    CMD_LOCATION,
+} cmd_type_t;
+
+/* 缓存文件 */
+typedef struct {
+    uint8_t version;
+    uint8_t reserved[3];
+    float lat;
+    float lon;
+    weather_t data;
+} weather_file_t;
+
+/* 解析时已取得的字段 */
+enum {
+    SEEN_TEMP = 1 << 0,
+    SEEN_CODE = 1 << 1,
+};
+
+typedef struct {
+    weather_t *w;
+    uint32_t seen;
+} parse_ctx_t;
+
+/* 一个请求的解析状态，在天气任务栈上，两个请求都完成后才释放 */
+typedef struct {
+    json_stream_t js;
+    parse_ctx_t ctx;
+    esp_err_t err;
+    http_pool_result_t res;
+    TaskHandle_t waiter;
+} fetch_req_t;
+
+static QueueHandle_t s_cmd_queue = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;  // 保护 s_data、s_have、s_stats
+static weather_t s_data;
+static bool s_have = false;
+static weather_stats_t s_stats;
+
+/* 以下只在天气任务中访问（初始化时除外） */
+static bool s_net_up = false;
+static bool s_screen_on = true;
+static bool s_time_known = false;
+static bool s_failed = false;
+static float s_lat, s_lon;
+static uint32_t s_interval_ms = WEATHER_INTERVAL_MS;
+static int64_t s_base_us = 0;           // 上次获取（或缓存数据获取时）的单调时钟
+static uint32_t s_wait_ms = 0;          // 从 s_base_us 起的等待时间，亮屏值
+static int64_t s_net_up_us = 0;
+static wifi_policy_t s_backoff;
+
+static const char *const s_sky_names[WEATHER_SKY_MAX] = {
+    [WEATHER_SKY_UNKNOWN]  = "",
+    [WEATHER_SKY_CLEAR]    = "晴",
+    [WEATHER_SKY_CLOUDY]   = "多云",
+    [WEATHER_SKY_OVERCAST] = "阴",
+    [WEATHER_SKY_FOG]      = "雾",
+    [WEATHER_SKY_HAZE]     = "霾",
+    [WEATHER_SKY_RAIN]     = "雨",
+    [WEATHER_SKY_SNOW]     = "雪",
+    [WEATHER_SKY_THUNDER]  = "雷阵雨",
+};
+
+// WMO 4677 天气代码归类
+static weather_sky_t sky_from_wmo(uint8_t code, float pm25)
+{
+    weather_sky_t sky;
+
+    if (code == 0 || code == 1) {
+        sky = WEATHER_SKY_CLEAR;
+    } else if (code == 2) {
+        sky = WEATHER_SKY_CLOUDY;
+    } else if (code == 3) {
+        sky = WEATHER_SKY_OVERCAST;
+    } else if (code == 45 || code == 48) {
+        return WEATHER_SKY_FOG;
+    } else if ((code >= 71 && code <= 77) || code == 85 || code == 86) {
+        return WEATHER_SKY_SNOW;
+    } else if (code >= 95) {
+        return WEATHER_SKY_THUNDER;
+    } else if (code >= 51 && code <= 82) {
+        return WEATHER_SKY_RAIN;
+    } else {
+        return WEATHER_SKY_UNKNOWN;
+    }
+    return pm25 >= HAZE_PM25 ? WEATHER_SKY_HAZE : sky;
+}
+
+// 蒲福风级，km/h
+static uint8_t wind_level(float kmh)
+{
+    static const uint8_t limits[12] = {1, 6, 12, 20, 29, 39, 50, 62, 75, 89, 103, 118};
+    uint8_t level = 0;
+
+    while (level < 12 && kmh >= limits[level]) {
+        level++;
+    }
+    return level;
+}
+
+static bool changed_from(const weather_t *a, const weather_t *b)
+{
+    if (a->sky != b->sky || fabsf(a->temp_c - b->temp_c) >= CHANGE_TEMP_C) {
+        return true;
+    }
+    return a->aqi >= 0 && b->aqi >= 0 && abs(a->aqi - b->aqi) >= CHANGE_AQI;
+}
+
+static void json_cb(const char *path, json_stream_type_t type, const char *value, void *arg)
+{
+    parse_ctx_t *ctx = arg;
+    weather_t *w = ctx->w;
+
+    if (type != JSON_STREAM_NUMBER) {
+        return; // null 保持未知
+    }
+    float v = strtof(value, NULL);
+
+    if (strcmp(path, "current.temperature_2m") == 0) {
+        w->temp_c = v;
+        ctx->seen |= SEEN_TEMP;
+    } else if (strcmp(path, "current.weather_code") == 0) {
+        w->wmo_code = (uint8_t)v;
+        ctx->seen |= SEEN_CODE;
+    } else if (strcmp(path, "current.relative_humidity_2m") == 0) {
+        w->humidity = (uint8_t)v;
+    } else if (strcmp(path, "current.wind_speed_10m") == 0) {
+        w->wind_kmh = v;
+    } else if (strcmp(path, "daily.temperature_2m_max.0") == 0) {
+        w->temp_max_c = v;
+    } else if (strcmp(path, "daily.temperature_2m_min.0") == 0) {
+        w->temp_min_c = v;
+    } else if (strcmp(path, "current.us_aqi") == 0) {
+        w->aqi = (int16_t)v;
+    } else if (strcmp(path, "current.pm2_5") == 0) {
+        w->pm25 = v;
+    }
+}
+
+// 响应体按块送入流式解析器
+static esp_err_t body_cb(const char *data, size_t len, void *arg)
+{
+    json_stream_t *js = arg;
+    esp_err_t err = json_stream_feed(js, data, len);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Bad JSON at byte %lu", (unsigned long)js->offset);
+    }
+    return err;
+}
+
+// 请求完成，在 HTTP 任务中执行
+static void done_cb(esp_err_t err, const http_pool_result_t *res, void *arg)
+{
+    fetch_req_t *r = arg;
+
+    if (err == ESP_OK) {
+        err = json_stream_finish(&r->js);
+    } else if (res->status != 0 && res->status != 200) {
+        ESP_LOGW(TAG, "HTTP %d", res->status);
+    }
+    r->err = err;
+    r->res = *res;
+    xTaskNotifyGive(r->waiter);
+}
+
+// 提交一个可推迟的请求，完成时通知当前任务
+static esp_err_t submit_json(const char *url, fetch_req_t *r, weather_t *w, uint32_t defer_ms)
+{
+    r->ctx = (parse_ctx_t){.w = w};
+    r->err = ESP_FAIL;
+    r->waiter = xTaskGetCurrentTaskHandle();
+    json_stream_init(&r->js, json_cb, &r->ctx);
+
+    http_pool_req_t req = {
+        .url = url,
+        .flags = HTTP_POOL_F_CACHE | HTTP_POOL_F_DEFER,
+        .defer_ms = defer_ms,
+        .on_body = body_cb,
+        .body_arg = &r->js,
+        .on_done = done_cb,
+        .done_arg = r,
+    };
+    return http_pool_submit(&req);
+}
+
+static void load_location(void)
+{
+    s_lat = settings_get_float(SETTING_WEATHER_LAT);
+    s_lon = settings_get_float(SETTING_WEATHER_LON);
+}
+
+static void save(const weather_t *w)
+{
+    weather_file_t file = {
+        .version = WEATHER_FILE_VERSION,
+        .lat = s_lat,
+        .lon = s_lon,
+        .data = *w,
+    };
+    esp_err_t err = sys_file_write_atomic(WEATHER_FILE, &file, sizeof(file));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Save failed: %s", esp_err_to_name(err));
+    }
+}
+
+static void load(void)
+{
+    size_t len = 0;
+    weather_file_t *file = sys_file_read_all(WEATHER_FILE, &len, false);
+
+    if (!file) {
+        return;
+    }
+    if (len == sizeof(*file) && file->version == WEATHER_FILE_VERSION &&
+        fabsf(file->lat - s_lat) < 0.005f && fabsf(file->lon - s_lon) < 0.005f) {
+        s_data = file->data;
+        s_have = true;
+    } else {
+        ESP_LOGW(TAG, "Discard %s (%u bytes)", WEATHER_FILE, (unsigned)len);
+    }
+    free(file);
+}
+
+static void drop(void)
+{
+    taskENTER_CRITICAL(&s_mux);
+    bool had = s_have;
+    s_have = false;
+    taskEXIT_CRITICAL(&s_mux);
+    if (had) {
+        esp_event_post(WEATHER_EVENT, WEATHER_EVENT_EXPIRED, NULL, 0, pdMS_TO_TICKS(100));
+    }
+}
+
+// 尽快获取
+static void schedule_now(void)
+{
+    s_base_us = esp_timer_get_time();
+    s_wait_ms = 0;
+    s_failed = false;
+    wifi_policy_reset(&s_backoff);
+}
+
+// 对时后按缓存数据的实际获取时间安排下次刷新，过期则丢弃
+static void check_age(void)
+{
+    s_time_known = true;
+    if (!s_have || s_data.fetched_at == 0 || s_failed) {
+        return;
+    }
+
+    int64_t age = (int64_t)time(NULL) - s_data.fetched_at;
+    if (age > WEATHER_MAX_AGE_S || age < -WEATHER_MAX_AGE_S) {
+        ESP_LOGI(TAG, "Cache expired (%lld s)", (long long)age);
+        drop();
+        schedule_now();
+        return;
+    }
+    if (age < 0) {
+        age = 0;
+    }
+    s_base_us = esp_timer_get_time() - age * 1000000;
+    s_wait_ms = s_interval_ms;
+}
+
+static int64_t next_fetch_us(void)
+{
+    uint32_t wait = s_wait_ms;
+    if (!s_failed && !s_screen_on) {
+        wait *= WEATHER_SCREEN_OFF_MUL;
+    }
+    int64_t deadline = s_base_us + wait * 1000LL;
+
+    // 有缓存但不知道它的新旧，先等对时
+    if (!s_time_known && s_have && deadline < s_net_up_us + WEATHER_TIME_WAIT_MS * 1000LL) {
+        deadline = s_net_up_us + WEATHER_TIME_WAIT_MS * 1000LL;
+    }
+    return deadline;
+}
+
+static void fetch(void)
+{
+    char url[URL_MAX];
+    weather_t w = {
+        .pm25 = -1,
+        .aqi = -1,
+    };
+    fetch_req_t reqs[2];
+    int submitted = 0;
+    // 定时刷新可以推迟，与其他请求一起发出；立即刷新（启动、位置改变、手动）不推迟
+    uint32_t defer_ms = s_wait_ms ? WEATHER_DEFER_MS : 0;
+
+    // 两个请求一起提交，在同一批中连续完成
+    snprintf(url, sizeof(url), WEATHER_FORECAST_URL, s_lat, s_lon);
+    esp_err_t err = submit_json(url, &reqs[0], &w, defer_ms);
+    if (err == ESP_OK) {
+        submitted++;
+        snprintf(url, sizeof(url), WEATHER_AIR_URL, s_lat, s_lon);
+        if (submit_json(url, &reqs[1], &w, defer_ms) == ESP_OK) {
+            submitted++;
+        }
+    }
+    for (int i = 0; i < submitted; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+
+    uint32_t bytes = 0, elapsed_ms = 0;
+    for (int i = 0; i < submitted; i++) {
+        bytes += reqs[i].res.bytes;
+        elapsed_ms += reqs[i].res.elapsed_ms;
+    }
+    if (submitted > 0) {
+        err = reqs[0].err;
+    }
+    if (err == ESP_OK && (reqs[0].ctx.seen & (SEEN_TEMP | SEEN_CODE)) != (SEEN_TEMP | SEEN_CODE)) {
+        err = ESP_ERR_INVALID_RESPONSE;
+    }
+    // 空气质量失败不影响天气数据
+    esp_err_t air_err = submitted == 2 ? reqs[1].err : ESP_ERR_INVALID_STATE;
+    if (err == ESP_OK && air_err != ESP_OK) {
+        ESP_LOGW(TAG, "Air quality failed: %s", esp_err_to_name(air_err));
+        w.aqi = -1;
+        w.pm25 = -1;
+    }
+
+    s_base_us = esp_timer_get_time();
+
+    if (err != ESP_OK) {
+        s_failed = true;
+        s_wait_ms = wifi_policy_fail(&s_backoff, s_screen_on ? WIFI_POLICY_SCREEN_ON : WIFI_POLICY_SCREEN_OFF);
+        taskENTER_CRITICAL(&s_mux);
+        s_stats.failures++;
+        taskEXIT_CRITICAL(&s_mux);
+        ESP_LOGW(TAG, "Fetch failed: %s, retry in %lu s", esp_err_to_name(err), (unsigned long)(s_wait_ms / 1000));
+        return;
+    }
+
+    w.fetched_at = timesync_is_valid() ? (int64_t)time(NULL) : 0;
+    w.sky = sky_from_wmo(w.wmo_code, w.pm25);
+    w.wind_level = wind_level(w.wind_kmh);
+
+    // 变化明显时缩短间隔，否则逐步延长
+    bool changed = !s_have || changed_from(&s_data, &w);
+    if (changed) {
+        s_interval_ms = s_interval_ms / 2 > WEATHER_INTERVAL_MIN_MS ? s_interval_ms / 2 : WEATHER_INTERVAL_MIN_MS;
+    } else {
+        s_interval_ms = s_interval_ms / 2 * 3 < WEATHER_INTERVAL_MAX_MS ? s_interval_ms / 2 * 3 : WEATHER_INTERVAL_MAX_MS;
+    }
+    s_failed = false;
+    s_wait_ms = s_interval_ms;
+    wifi_policy_reset(&s_backoff);
+
+    taskENTER_CRITICAL(&s_mux);
+    s_data = w;
+    s_have = true;
+    s_stats.fetches++;
+    s_stats.changed += changed;
+    s_stats.last_bytes = bytes;
+    s_stats.last_ms = elapsed_ms;
+    s_stats.interval_ms = s_interval_ms;
+    taskEXIT_CRITICAL(&s_mux);
+
+    ESP_LOGI(TAG, "%s %.1f C, AQI %d, %lu bytes in %lu ms, next in %lu min", s_sky_names[w.sky], w.temp_c, w.aqi,
+             (unsigned long)bytes, (unsigned long)elapsed_ms, (unsigned long)(s_interval_ms / 60000));
+    save(&w);
+    esp_event_post(WEATHER_EVENT, WEATHER_EVENT_UPDATED, &w, sizeof(w), pdMS_TO_TICKS(100));
+}
+
+static TickType_t next_wait(void)
+{
+    if (!s_net_up) {
+        return portMAX_DELAY;
+    }
+    int64_t deadline = next_fetch_us();
+    int64_t now = esp_timer_get_time();
+    return deadline <= now ? 0 : pdMS_TO_TICKS((deadline - now) / 1000) + 1;
+}
+
+static void weather_task(void *arg)
+{
+    uint8_t cmd;
+
+    while (1) {
+        if (xQueueReceive(s_cmd_queue, &cmd, next_wait()) == pdTRUE) {
+            switch (cmd) {
+            case CMD_NET_UP:
+                s_net_up = true;
+                s_net_up_us = esp_timer_get_time();
+                break;
+            case CMD_NET_DOWN:
+                s_net_up = false;
+                break;
+            case CMD_TIME_SYNCED:
+                check_age();
+                break;
+            case CMD_REQUEST:
+                schedule_now();
+                break;
+            case CMD_SCREEN_ON:
+                s_screen_on = true;
+                break;
+            case CMD_SCREEN_OFF:
+                s_screen_on = false;
+                break;
+            case CMD_LOCATION:
+                load_location();
+                drop();
+                schedule_now();
+                break;
+            }
+        }
+
+        if (s_net_up && esp_timer_get_time() >= next_fetch_us()) {
+            fetch();
+        }
+    }
+}
+
+static void send_cmd(cmd_type_t type)
+{
+    uint8_t cmd = type;
+    if (s_cmd_queue) {
+        xQueueSend(s_cmd_queue, &cmd, pdMS_TO_TICKS(100));
+    }
+}
+
+static void wifi_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    if (id == WIFI_MGR_EVENT_CONNECTED) {
+        send_cmd(CMD_NET_UP);
+    } else if (id == WIFI_MGR_EVENT_DISCONNECTED) {
+        send_cmd(CMD_NET_DOWN);
+    }
+}
+
+static void timesync_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    send_cmd(CMD_TIME_SYNCED);
+}
+
+static void location_changed_cb(setting_id_t id, void *arg)
+{
+    send_cmd(CMD_LOCATION);
+}
+
+esp_err_t weather_init(void)
+{
+    if (s_cmd_queue) {
+        return ESP_OK;
+    }
+
+    static const wifi_policy_cfg_t on = BACKOFF_ON, off = BACKOFF_OFF;
+    wifi_policy_init(&s_backoff, esp_random());
+    wifi_policy_set(&s_backoff, WIFI_POLICY_SCREEN_ON, &on);
+    wifi_policy_set(&s_backoff, WIFI_POLICY_SCREEN_OFF, &off);
+
+    load_location();
+    load();
+    schedule_now();
+    if (timesync_is_valid()) {
+        check_age();
+    }
+    s_stats.interval_ms = s_interval_ms;
+
+    s_cmd_queue = xQueueCreate(8, sizeof(uint8_t));
+    if (!s_cmd_queue) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(weather_task, "weather", WEATHER_TASK_STACK, NULL, WEATHER_TASK_PRIO, NULL) != pdPASS) {
+        vQueueDelete(s_cmd_queue);
+        s_cmd_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // 启动时立即显示缓存
+    if (s_have) {
+        ESP_LOGI(TAG, "Cached %s %.1f C", s_sky_names[s_data.sky], s_data.temp_c);
+        esp_event_post(WEATHER_EVENT, WEATHER_EVENT_UPDATED, &s_data, sizeof(s_data), pdMS_TO_TICKS(100));
+    }
+
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_CONNECTED, wifi_event_cb, NULL);
+    esp_event_handler_register(WIFI_MGR_EVENT, WIFI_MGR_EVENT_DISCONNECTED, wifi_event_cb, NULL);
+    esp_event_handler_register(TIMESYNC_EVENT, TIMESYNC_EVENT_SYNCED, timesync_event_cb, NULL);
+    esp_err_t err = settings_subscribe(SETTING_WEATHER_LAT, location_changed_cb, NULL);
+    if (err == ESP_OK) {
+        err = settings_subscribe(SETTING_WEATHER_LON, location_changed_cb, NULL);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (wifi_mgr_get_state() == WIFI_MGR_STATE_CONNECTED) {
+        send_cmd(CMD_NET_UP);
+    }
+    return ESP_OK;
+}
+
+esp_err_t weather_get(weather_t *out)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    taskENTER_CRITICAL(&s_mux);
+    if (s_have) {
+        *out = s_data;
+        err = ESP_OK;
+    }
+    taskEXIT_CRITICAL(&s_mux);
+    return err;
+}
+
+esp_err_t weather_request(void)
+{
+    if (!s_cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    send_cmd(CMD_REQUEST);
+    return ESP_OK;
+}
+
+void weather_set_screen_on(bool on)
+{
+    send_cmd(on ? CMD_SCREEN_ON : CMD_SCREEN_OFF);
+}
+
+const char *weather_sky_name(weather_sky_t sky)
+{
+    return sky < WEATHER_SKY_MAX ? s_sky_names[sky] : "";
+}
+
+void weather_get_stats(weather_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+}
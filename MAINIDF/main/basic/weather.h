@@ -0,0 +1,122 @@
+/**
+ * @file weather.h
+ * @brief 天气与空气质量服务
+ *
+ * 通过 http_pool 从 Open-Meteo 获取当前天气、当日最高/最低气温和空气质量（无需密钥）：
+ * - 响应边读边用 json_stream 解析，只取需要的字段，不缓存整个响应
+ * - 最近一次结果原子写入 LittleFS，启动时立即发布，对时后按获取时间判断是否过期
+ * - 刷新间隔自适应：数据有明显变化时缩短，连续没有变化时延长
+ *   （WEATHER_INTERVAL_MIN_MS ~ WEATHER_INTERVAL_MAX_MS），熄屏时再乘以 WEATHER_SCREEN_OFF_MUL；
+ *   失败后按 wifi_policy 指数退避
+ * - 到时间但 WLAN 未连接时不主动连接，等下次连接成功后再获取
+ * - 定时刷新的两个请求以 HTTP_POOL_F_DEFER 提交，最多推迟 WEATHER_DEFER_MS，与其他请求在同一次唤醒中完成
+ *
+ * 位置来自设置项 SETTING_WEATHER_LAT / SETTING_WEATHER_LON，修改后丢弃缓存并立即重新获取。
+ * 数据更新后发布 WEATHER_EVENT_UPDATED，缓存过期时发布 WEATHER_EVENT_EXPIRED。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#define WEATHER_FORECAST_URL    "http://api.open-meteo.com/v1/forecast?latitude=%.2f&longitude=%.2f" \
+                                "&current=temperature_2m,relative_humidity_2m,weather_code,wind_speed_10m" \
+                                "&daily=temperature_2m_max,temperature_2m_min&forecast_days=1&timezone=auto"
+#define WEATHER_AIR_URL         "http://air-quality-api.open-meteo.com/v1/air-quality?latitude=%.2f&longitude=%.2f" \
+                                "&current=us_aqi,pm2_5"
+#define WEATHER_FILE            "/littlefs/weather.bin"
+#define WEATHER_INTERVAL_MS     (30 * 60 * 1000)    // 初始刷新间隔
+#define WEATHER_INTERVAL_MIN_MS (15 * 60 * 1000)
+#define WEATHER_INTERVAL_MAX_MS (2 * 60 * 60 * 1000)
+#define WEATHER_SCREEN_OFF_MUL  4                   // 熄屏时刷新间隔的倍数
+#define WEATHER_MAX_AGE_S       (6 * 60 * 60)       // 超过此时间的数据不再显示
+#define WEATHER_TIME_WAIT_MS    60000               // 有缓存但未对时，联网后最多等待对时的时间
+#define WEATHER_DEFER_MS        60000               // 定时刷新最多推迟的时间，期间与其他 HTTP 请求合并
+
+ESP_EVENT_DECLARE_BASE(WEATHER_EVENT);
+
+/** WEATHER_EVENT 事件 */
+typedef enum {
+    WEATHER_EVENT_UPDATED,      // 数据更新（包括启动时读取缓存），数据为 weather_t
+    WEATHER_EVENT_EXPIRED,      // 缓存过期或位置改变，已无可显示的数据，无数据
+} weather_event_t;
+
+/** 天气现象 */
+typedef enum {
+    WEATHER_SKY_UNKNOWN,
+    WEATHER_SKY_CLEAR,          // 晴
+    WEATHER_SKY_CLOUDY,         // 多云
+    WEATHER_SKY_OVERCAST,       // 阴
+    WEATHER_SKY_FOG,            // 雾
+    WEATHER_SKY_HAZE,           // 霾（无降水且 PM2.5 重度污染）
+    WEATHER_SKY_RAIN,           // 雨（含毛毛雨、冻雨、阵雨）
+    WEATHER_SKY_SNOW,           // 雪
+    WEATHER_SKY_THUNDER,        // 雷阵雨
+    WEATHER_SKY_MAX,
+} weather_sky_t;
+
+/** 天气数据 */
+typedef struct {
+    int64_t fetched_at;         // 获取时间（UTC 秒），未对时获取的为 0
+    float temp_c;               // 当前气温
+    float temp_max_c;           // 当日最高气温
+    float temp_min_c;           // 当日最低气温
+    float wind_kmh;             // 10 米风速
+    float pm25;                 // PM2.5（μg/m³），负数表示未知
+    int16_t aqi;                // 空气质量指数（美国 AQI 标准），-1 表示未知
+    uint8_t humidity;           // 相对湿度（%）
+    uint8_t wmo_code;           // WMO 天气代码
+    uint8_t sky;                // weather_sky_t
+    uint8_t wind_level;         // 风力等级（蒲福风级 0~12）
+} weather_t;
+
+/** 统计信息 */
+typedef struct {
+    uint32_t fetches;           // 成功次数
+    uint32_t failures;          // 失败次数
+    uint32_t changed;           // 数据有明显变化的次数
+    uint32_t last_bytes;        // 最近一次收到的响应字节数（两个请求之和）
+    uint32_t last_ms;           // 最近一次获取耗时（不含排队和推迟时间）
+    uint32_t interval_ms;       // 当前刷新间隔（亮屏时）
+} weather_stats_t;
+
+/**
+ * 初始化天气服务，读取缓存，需在 LittleFS 挂载和 wifi_mgr_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t weather_init(void);
+
+/**
+ * 获取最近的数据
+ * @param out 输出
+ * @return esp_err_t 没有数据返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t weather_get(weather_t *out);
+
+/**
+ * 立即刷新（WLAN 未连接时在连接后执行）
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t weather_request(void);
+
+/**
+ * 亮屏/熄屏，熄屏时延长刷新间隔，亮屏时数据已到期则立即刷新
+ * @param on 是否亮屏
+ */
+void weather_set_screen_on(bool on);
+
+/**
+ * 天气现象名称
+ * @param sky 天气现象
+ * @return const char* UTF-8 字符串，未知返回空串
+ */
+const char *weather_sky_name(weather_sky_t sky);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void weather_get_stats(weather_stats_t *stats);
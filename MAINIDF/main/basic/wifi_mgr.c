@@ -0,0 +1,914 @@
+/**
+ * @file wifi_mgr.c
+ * @brief WLAN 管理任务实现
+ *
+ * 所有 esp_wifi 调用都在管理任务中执行。驱动事件（扫描完成、断开、获取IP）
+ * 只转成命令送回任务，由任务按当前状态处理，状态和扫描进度不需要加锁。
+ * 定时动作（取消扫描超时、连接超时、BACKOFF 到期、射频空闲关闭）通过
+ * 队列等待超时实现，不另建定时器。
+ */
+
+#include "wifi_mgr.h"
+#include "wifi_store.h"
+#include "wifi_policy.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_random.h"
+#include "esp_netif.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+static const char *TAG = "wifi_mgr";
+
+ESP_EVENT_DEFINE_BASE(WIFI_MGR_EVENT);
+
+#define WIFI_MGR_TASK_STACK     4096
+#define WIFI_MGR_TASK_PRIO      4
+#define WIFI_MGR_QUEUE_LEN      12
+#define CHAN_MAX_RECORDS        16      // 单个信道最多读取的网络数
+#define STOP_TIMEOUT_MS         500     // 取消后等待驱动结束扫描的时间
+#define CONNECT_TIMEOUT_MS      15000   // 单次连接尝试超时
+#define FAST_CONNECT_TIMEOUT_MS 3000    // 指定 BSSID/信道直连的超时，只扫描一个信道
+#define EVENT_POST_TIMEOUT_MS   100
+#define EVENT_CMD_TIMEOUT_MS    20      // 驱动事件转命令时等待队列的时间，事件改变状态，不能丢
+#define OWN_DISCONNECT_MS       1000    // 主动断开后在此时间内到达的断开事件视为主动断开产生
+
+typedef enum {
+    CMD_SCAN,
+    CMD_CANCEL,
+    CMD_CONNECT,
+    CMD_DISCONNECT,
+    CMD_SCREEN,             // reason 为 1 表示亮屏
+    CMD_CHAN_DONE,          // 驱动完成一个信道的扫描
+    CMD_STA_DISCONNECTED,   // 驱动报告断开/连接失败
+    CMD_GOT_IP,
+} cmd_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t reason;         // CMD_STA_DISCONNECTED / CMD_SCREEN
+    uint32_t ip;            // CMD_GOT_IP
+    char ssid[33];          // CMD_CONNECT
+    char password[65];
+} wifi_mgr_cmd_t;
+
+typedef enum {
+    SCAN_IDLE,
+    SCAN_RUNNING,
+    SCAN_STOPPING,  // 已调用 esp_wifi_scan_stop，等待驱动确认
+} scan_state_t;
+
+static const char *const s_state_names[WIFI_MGR_STATE_MAX] = {
+    "off", "init", "scanning", "connecting", "connected", "backoff",
+};
+
+static QueueHandle_t s_cmd_queue = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // 保护 s_stats
+static wifi_mgr_stats_t s_stats;
+
+/* 以下只在管理任务中访问 */
+static volatile wifi_mgr_state_t s_state = WIFI_MGR_STATE_OFF;
+static int64_t s_state_since_us;
+static bool s_radio_on = false;
+static int64_t s_radio_since_us;
+
+static volatile scan_state_t s_scan_state = SCAN_IDLE;
+static bool s_scan_pending = false;     // 有扫描请求等待执行
+static int64_t s_stop_deadline_us;
+static uint8_t s_chan;                  // 当前扫描信道
+static uint8_t s_chan_last;
+static int64_t s_scan_start_us;
+static uint32_t s_seen[WIFI_MGR_MAX_APS]; // 已上报 SSID 的哈希，用于去重
+static uint16_t s_seen_count;
+static wifi_ap_record_t s_records[CHAN_MAX_RECORDS];
+
+static char s_ssid[33];                 // 目标网络
+static char s_password[65];
+static wifi_store_entry_t s_known;      // 目标网络上次连接的 AP
+static bool s_known_valid = false;      // s_known 中有可用的 BSSID/信道
+static bool s_fast = false;             // 本次尝试为直连
+static bool s_connect_pending = false;  // 等扫描结束后开始连接
+static int64_t s_ignore_disconnect_until_us; // 在此之前的一次断开事件是主动断开产生的，0 表示没有
+static uint8_t s_attempt;               // 本轮连续尝试次数
+static int64_t s_connect_start_us;      // 本轮开始时间，用于统计连接耗时
+static int64_t s_attempt_start_us;
+static int64_t s_backoff_until_us;      // 0 表示没有等待中的重试
+static wifi_policy_t s_policy;
+static bool s_screen_on = true;
+static int64_t s_quality_next_us;       // 下次读取信号强度的时间
+static uint8_t s_bars;                  // 最近一次发布的信号格数
+
+static void send_cmd(const wifi_mgr_cmd_t *cmd, TickType_t timeout)
+{
+    if (xQueueSend(s_cmd_queue, cmd, timeout) != pdPASS) {
+        ESP_LOGW(TAG, "Command queue full, drop %d", cmd->type);
+    }
+}
+
+static esp_err_t send_simple(cmd_type_t type)
+{
+    if (!s_cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    wifi_mgr_cmd_t cmd = {.type = type};
+    send_cmd(&cmd, pdMS_TO_TICKS(100));
+    return ESP_OK;
+}
+
+// 驱动事件转成命令，在默认事件循环任务中执行
+static void wifi_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    wifi_mgr_cmd_t cmd = {0};
+
+    if (base == WIFI_EVENT && id == WIFI_EVENT_SCAN_DONE) {
+        cmd.type = CMD_CHAN_DONE;
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_DISCONNECTED) {
+        cmd.type = CMD_STA_DISCONNECTED;
+        cmd.reason = ((wifi_event_sta_disconnected_t *)data)->reason;
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        cmd.type = CMD_GOT_IP;
+        cmd.ip = ((ip_event_got_ip_t *)data)->ip_info.ip.addr;
+    } else {
+        return;
+    }
+    send_cmd(&cmd, pdMS_TO_TICKS(EVENT_CMD_TIMEOUT_MS));
+}
+
+static void post_event(wifi_mgr_event_t id, const void *data, size_t len)
+{
+    esp_err_t err = esp_event_post(WIFI_MGR_EVENT, id, data, len, pdMS_TO_TICKS(EVENT_POST_TIMEOUT_MS));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Post event %d failed: %s", (int)id, esp_err_to_name(err));
+    }
+}
+
+static void set_state(wifi_mgr_state_t state)
+{
+    if (state == s_state) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    uint32_t stayed = (uint32_t)((now - s_state_since_us) / 1000);
+
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.time_ms[s_state] += stayed;
+    s_stats.entries[state]++;
+    s_stats.transitions++;
+    taskEXIT_CRITICAL(&s_mux);
+
+    ESP_LOGI(TAG, "%s -> %s (after %lu ms)", s_state_names[s_state], s_state_names[state], (unsigned long)stayed);
+    s_state = state;
+    s_state_since_us = now;
+    post_event(WIFI_MGR_EVENT_STATE, &state, sizeof(state));
+}
+
+static esp_err_t radio_on(void)
+{
+    if (s_radio_on) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = esp_wifi_start();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Start radio failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    s_radio_on = true;
+    s_radio_since_us = esp_timer_get_time();
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.radio_starts++;
+    taskEXIT_CRITICAL(&s_mux);
+    return ESP_OK;
+}
+
+// 主动断开，随后的一次断开事件不计为连接失败；驱动未启动时不会有事件，不做标记。
+// 标记只在 OWN_DISCONNECT_MS 内有效，没有等到事件时不会吞掉之后真正的断开
+static void disconnect_own(void)
+{
+    if (esp_wifi_disconnect() == ESP_OK) {
+        s_ignore_disconnect_until_us = esp_timer_get_time() + OWN_DISCONNECT_MS * 1000LL;
+    }
+}
+
+static void radio_off(void)
+{
+    if (!s_radio_on) {
+        return;
+    }
+
+    esp_wifi_stop();
+    s_radio_on = false;
+    uint32_t on_ms = (uint32_t)((esp_timer_get_time() - s_radio_since_us) / 1000);
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.radio_on_ms += on_ms;
+    taskEXIT_CRITICAL(&s_mux);
+    ESP_LOGI(TAG, "Radio off after %lu ms", (unsigned long)on_ms);
+}
+
+/* ---------------- 扫描 ---------------- */
+
+static uint32_t ssid_hash(const uint8_t *ssid)
+{
+    uint32_t h = 2166136261u;
+    while (*ssid) {
+        h = (h ^ *ssid++) * 16777619u;
+    }
+    return h;
+}
+
+static esp_err_t scan_channel(uint8_t chan)
+{
+    wifi_scan_config_t cfg = {
+        .channel = chan,
+        .show_hidden = false,
+        .scan_type = WIFI_SCAN_TYPE_ACTIVE,
+        .scan_time.active = {
+            .min = 0,
+            .max = WIFI_MGR_CHAN_SCAN_MS,
+        },
+    };
+    return esp_wifi_scan_start(&cfg, false);
+}
+
+static void connect_begin(void);
+
+static void scan_finish(bool cancelled)
+{
+    wifi_mgr_scan_done_t done = {
+        .count = s_seen_count,
+        .cancelled = cancelled,
+        .duration_ms = (uint32_t)((esp_timer_get_time() - s_scan_start_us) / 1000),
+    };
+
+    s_scan_state = SCAN_IDLE;
+    ESP_LOGI(TAG, "Scan %s: %u APs in %lu ms", cancelled ? "cancelled" : "done",
+             done.count, (unsigned long)done.duration_ms);
+    post_event(WIFI_MGR_EVENT_SCAN_DONE, &done, sizeof(done));
+
+    if (s_state == WIFI_MGR_STATE_SCANNING) {
+        set_state(WIFI_MGR_STATE_INIT);
+    }
+    if (s_connect_pending) {
+        connect_begin();
+    } else if (s_state == WIFI_MGR_STATE_BACKOFF) {
+        radio_off(); // BACKOFF 期间的扫描结束后继续关闭射频
+    }
+}
+
+static void scan_begin(void)
+{
+    if (radio_on() != ESP_OK) {
+        return;
+    }
+
+    wifi_country_t country;
+    uint8_t first = 1;
+    s_chan_last = 13;
+    if (esp_wifi_get_country(&country) == ESP_OK && country.nchan > 0) {
+        first = country.schan;
+        s_chan_last = country.schan + country.nchan - 1;
+    }
+
+    s_seen_count = 0;
+    s_chan = first;
+    s_scan_start_us = esp_timer_get_time();
+    s_scan_state = SCAN_RUNNING;
+    if (s_state == WIFI_MGR_STATE_INIT) {
+        set_state(WIFI_MGR_STATE_SCANNING);
+    }
+    post_event(WIFI_MGR_EVENT_SCAN_START, NULL, 0);
+
+    esp_err_t err = scan_channel(s_chan);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Scan start failed: %s", esp_err_to_name(err));
+        scan_finish(false);
+    }
+}
+
+static void scan_stop(void)
+{
+    if (s_scan_state == SCAN_RUNNING) {
+        esp_wifi_scan_stop();
+        s_scan_state = SCAN_STOPPING;
+        s_stop_deadline_us = esp_timer_get_time() + STOP_TIMEOUT_MS * 1000LL;
+    }
+}
+
+// 读取本信道结果，上报未出现过的网络
+static void collect_channel(void)
+{
+    uint16_t n = CHAN_MAX_RECORDS;
+
+    // 读取后驱动释放本次扫描结果占用的内存
+    if (esp_wifi_scan_get_ap_records(&n, s_records) != ESP_OK) {
+        return;
+    }
+
+    for (uint16_t i = 0; i < n && s_seen_count < WIFI_MGR_MAX_APS; i++) {
+        const wifi_ap_record_t *rec = &s_records[i];
+        if (rec->ssid[0] == '\0') {
+            continue;
+        }
+
+        uint32_t h = ssid_hash(rec->ssid);
+        bool seen = false;
+        for (uint16_t j = 0; j < s_seen_count; j++) {
+            if (s_seen[j] == h) {
+                seen = true;
+                break;
+            }
+        }
+        if (seen) {
+            continue;
+        }
+        s_seen[s_seen_count++] = h;
+
+        wifi_mgr_ap_t ap = {
+            .rssi = rec->rssi,
+            .channel = rec->primary,
+            .authmode = rec->authmode,
+        };
+        strlcpy(ap.ssid, (const char *)rec->ssid, sizeof(ap.ssid));
+        post_event(WIFI_MGR_EVENT_SCAN_AP, &ap, sizeof(ap));
+    }
+}
+
+static void stop_complete(void)
+{
+    esp_wifi_clear_ap_list();
+    scan_finish(true);
+}
+
+static void on_chan_done(void)
+{
+    if (s_scan_state == SCAN_STOPPING) {
+        stop_complete();
+    } else if (s_scan_state == SCAN_RUNNING) {
+        collect_channel();
+        if (++s_chan > s_chan_last) {
+            scan_finish(false);
+        } else if (scan_channel(s_chan) != ESP_OK) {
+            ESP_LOGE(TAG, "Scan channel %u failed", s_chan);
+            scan_finish(false);
+        }
+    }
+}
+
+/* ---------------- 连接 ---------------- */
+
+static void post_fail(wifi_mgr_event_t id, uint8_t reason, bool give_up, uint32_t retry_ms)
+{
+    wifi_mgr_fail_t fail = {
+        .reason = reason,
+        .give_up = give_up,
+        .retry_ms = retry_ms,
+    };
+    strlcpy(fail.ssid, s_ssid, sizeof(fail.ssid));
+    post_event(id, &fail, sizeof(fail));
+}
+
+// 密码错误等重试也无法恢复的原因
+static bool is_auth_failure(uint8_t reason)
+{
+    return reason == WIFI_REASON_AUTH_FAIL ||
+           reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT ||
+           reason == WIFI_REASON_HANDSHAKE_TIMEOUT ||
+           reason == WIFI_REASON_NO_AP_FOUND_W_COMPATIBLE_SECURITY ||
+           reason == WIFI_REASON_NO_AP_FOUND_IN_AUTHMODE_THRESHOLD;
+}
+
+static void connect_attempt(void);
+
+static void connect_failed(uint8_t reason)
+{
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.connect_fail++;
+    if (s_fast) {
+        s_stats.fast_fallback++;
+    }
+    taskEXIT_CRITICAL(&s_mux);
+    ESP_LOGW(TAG, "Connect to '%s' failed (reason %u), attempt %u%s", s_ssid, reason, s_attempt,
+             s_fast ? " (cached AP)" : "");
+
+    if (s_attempt < WIFI_MGR_CONNECT_RETRY) {
+        connect_attempt();
+        return;
+    }
+
+    if (is_auth_failure(reason)) {
+        post_fail(WIFI_MGR_EVENT_CONNECT_FAILED, reason, true, 0);
+        s_ssid[0] = '\0';
+        set_state(WIFI_MGR_STATE_INIT);
+        return;
+    }
+
+    uint32_t delay = wifi_policy_fail(&s_policy, s_screen_on ? WIFI_POLICY_SCREEN_ON : WIFI_POLICY_SCREEN_OFF);
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.backoff_rounds++;
+    s_stats.last_backoff_ms = delay;
+    taskEXIT_CRITICAL(&s_mux);
+    ESP_LOGI(TAG, "Retry '%s' in %lu ms (round %u)", s_ssid, (unsigned long)delay, s_policy.failures);
+
+    post_fail(WIFI_MGR_EVENT_CONNECT_FAILED, reason, false, delay);
+    s_backoff_until_us = esp_timer_get_time() + delay * 1000LL;
+    set_state(WIFI_MGR_STATE_BACKOFF);
+    if (s_scan_state == SCAN_IDLE) {
+        radio_off();
+    }
+}
+
+// 每轮第一次尝试使用缓存的 BSSID/信道直连，之后按 SSID 全信道连接
+static void apply_config(void)
+{
+    wifi_config_t cfg = {
+        .sta = {
+            .threshold.authmode = s_password[0] ? WIFI_AUTH_WPA2_PSK : WIFI_AUTH_OPEN,
+            .sae_pwe_h2e = WPA3_SAE_PWE_BOTH,
+            .sae_h2e_identifier = "",
+        },
+    };
+    memcpy(cfg.sta.ssid, s_ssid, strnlen(s_ssid, sizeof(cfg.sta.ssid)));
+    memcpy(cfg.sta.password, s_password, strnlen(s_password, sizeof(cfg.sta.password)));
+
+    s_fast = s_attempt == 1 && s_known_valid;
+    if (s_fast) {
+        cfg.sta.scan_method = WIFI_FAST_SCAN;
+        cfg.sta.bssid_set = true;
+        memcpy(cfg.sta.bssid, s_known.bssid, sizeof(cfg.sta.bssid));
+        cfg.sta.channel = s_known.channel;
+    } else {
+        cfg.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    }
+    esp_wifi_set_config(WIFI_IF_STA, &cfg);
+}
+
+static void connect_attempt(void)
+{
+    s_attempt++;
+    s_attempt_start_us = esp_timer_get_time();
+    apply_config();
+    esp_err_t err = esp_wifi_connect();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_wifi_connect failed: %s", esp_err_to_name(err));
+        connect_failed(WIFI_REASON_UNSPECIFIED);
+    }
+}
+
+static void connect_begin(void)
+{
+    s_connect_pending = false;
+    s_backoff_until_us = 0;
+    if (s_ssid[0] == '\0') {
+        return;
+    }
+    if (radio_on() != ESP_OK) {
+        post_fail(WIFI_MGR_EVENT_CONNECT_FAILED, WIFI_REASON_UNSPECIFIED, true, 0);
+        set_state(WIFI_MGR_STATE_INIT);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Connecting to '%s'%s", s_ssid, s_known_valid ? " via cached AP" : "");
+    s_attempt = 0;
+    s_connect_start_us = esp_timer_get_time();
+    set_state(WIFI_MGR_STATE_CONNECTING);
+    connect_attempt();
+}
+
+static void on_connect_cmd(const wifi_mgr_cmd_t *cmd)
+{
+    // 先断开当前连接，旧连接的断开事件不计入新连接的失败
+    if (s_state == WIFI_MGR_STATE_CONNECTED || s_state == WIFI_MGR_STATE_CONNECTING) {
+        disconnect_own();
+    }
+
+    strlcpy(s_ssid, cmd->ssid, sizeof(s_ssid));
+    strlcpy(s_password, cmd->password, sizeof(s_password));
+    s_known_valid = wifi_store_find(s_ssid, &s_known) == ESP_OK && s_known.channel != 0;
+    wifi_policy_reset(&s_policy); // 新的连接请求从第一轮开始
+
+    if (s_scan_state != SCAN_IDLE) {
+        // 用户主动连接优先，取消扫描后再连接
+        s_connect_pending = true;
+        scan_stop();
+        return;
+    }
+    connect_begin();
+}
+
+static void on_disconnect_cmd(void)
+{
+    bool was_connected = s_state == WIFI_MGR_STATE_CONNECTED;
+
+    s_connect_pending = false;
+    s_backoff_until_us = 0;
+    if (was_connected || s_state == WIFI_MGR_STATE_CONNECTING) {
+        disconnect_own();
+    }
+    if (was_connected) {
+        post_fail(WIFI_MGR_EVENT_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE, true, 0);
+    }
+    s_ssid[0] = '\0';
+    if (s_state != WIFI_MGR_STATE_OFF) {
+        set_state(s_scan_state == SCAN_IDLE ? WIFI_MGR_STATE_INIT : WIFI_MGR_STATE_SCANNING);
+    }
+}
+
+static void on_sta_disconnected(uint8_t reason)
+{
+    if (s_ignore_disconnect_until_us) {
+        bool own = esp_timer_get_time() < s_ignore_disconnect_until_us;
+        s_ignore_disconnect_until_us = 0;
+        if (own) {
+            return;
+        }
+    }
+
+    if (s_state == WIFI_MGR_STATE_CONNECTING) {
+        connect_failed(reason);
+    } else if (s_state == WIFI_MGR_STATE_CONNECTED) {
+        ESP_LOGW(TAG, "Lost '%s' (reason %u), reconnecting", s_ssid, reason);
+        post_fail(WIFI_MGR_EVENT_DISCONNECTED, reason, false, 0);
+        s_attempt = 0;
+        s_connect_start_us = esp_timer_get_time();
+        set_state(WIFI_MGR_STATE_CONNECTING);
+        connect_attempt();
+    }
+}
+
+static void on_got_ip(uint32_t ip)
+{
+    if (s_state != WIFI_MGR_STATE_CONNECTING) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    uint32_t ms = (uint32_t)((now - s_connect_start_us) / 1000);
+    taskENTER_CRITICAL(&s_mux);
+    s_stats.connect_ok++;
+    s_stats.last_connect_ms = ms;
+    if (ms > s_stats.max_connect_ms) {
+        s_stats.max_connect_ms = ms;
+    }
+    if (s_fast) {
+        s_stats.fast_ok++;
+    }
+    if (s_stats.boot_to_ip_ms == 0) {
+        s_stats.boot_to_ip_ms = (uint32_t)(now / 1000);
+    }
+    taskEXIT_CRITICAL(&s_mux);
+
+    wifi_mgr_conn_t conn = {
+        .ip = ip,
+        .connect_ms = ms,
+        .fast = s_fast,
+    };
+    strlcpy(conn.ssid, s_ssid, sizeof(conn.ssid));
+
+    // 记住这次连接的 AP，下次直连
+    wifi_ap_record_t ap;
+    if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+        conn.rssi = ap.rssi;
+        conn.channel = ap.primary;
+
+        memset(&s_known, 0, sizeof(s_known));
+        strlcpy(s_known.ssid, s_ssid, sizeof(s_known.ssid));
+        strlcpy(s_known.password, s_password, sizeof(s_known.password));
+        memcpy(s_known.bssid, ap.bssid, sizeof(s_known.bssid));
+        s_known.channel = ap.primary;
+        s_known.authmode = ap.authmode;
+        s_known_valid = true;
+        wifi_store_save(&s_known);
+    }
+
+    ESP_LOGI(TAG, "Connected to '%s' in %lu ms%s, ip " IPSTR, s_ssid, (unsigned long)ms,
+             s_fast ? " (cached AP)" : "", IP2STR((esp_ip4_addr_t *)&ip));
+    wifi_policy_reset(&s_policy);
+    s_bars = wifi_mgr_rssi_bars(conn.rssi);
+    s_quality_next_us = now + WIFI_MGR_QUALITY_MS * 1000LL;
+    set_state(WIFI_MGR_STATE_CONNECTED);
+    post_event(WIFI_MGR_EVENT_CONNECTED, &conn, sizeof(conn));
+}
+
+/* ---------------- 屏幕状态和连接质量 ---------------- */
+
+static int64_t quality_period_us(void)
+{
+    return (s_screen_on ? WIFI_MGR_QUALITY_MS : WIFI_MGR_QUALITY_MS * 6) * 1000LL;
+}
+
+static void on_screen_cmd(bool on)
+{
+    s_screen_on = on;
+    if (!on || s_state != WIFI_MGR_STATE_BACKOFF || s_backoff_until_us == 0) {
+        return;
+    }
+
+    // 亮屏后用户可能在看状态，剩余等待超过亮屏策略时提前重试
+    int64_t until = esp_timer_get_time() + wifi_policy_delay(&s_policy, WIFI_POLICY_SCREEN_ON) * 1000LL;
+    if (until < s_backoff_until_us) {
+        ESP_LOGI(TAG, "Screen on, retry in %lld ms", (long long)((until - esp_timer_get_time()) / 1000));
+        s_backoff_until_us = until;
+    }
+}
+
+static void poll_quality(void)
+{
+    wifi_ap_record_t ap;
+
+    s_quality_next_us = esp_timer_get_time() + quality_period_us();
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) {
+        return;
+    }
+
+    wifi_mgr_quality_t q = {
+        .rssi = ap.rssi,
+        .bars = wifi_mgr_rssi_bars(ap.rssi),
+    };
+    if (q.bars != s_bars) {
+        s_bars = q.bars;
+        post_event(WIFI_MGR_EVENT_QUALITY, &q, sizeof(q));
+    }
+}
+
+/* ---------------- 任务 ---------------- */
+
+static int64_t attempt_deadline(void)
+{
+    return s_attempt_start_us + (s_fast ? FAST_CONNECT_TIMEOUT_MS : CONNECT_TIMEOUT_MS) * 1000LL;
+}
+
+// 距离最近一个定时动作的等待时间
+static TickType_t next_wait(void)
+{
+    int64_t deadline = INT64_MAX;
+
+    if (s_scan_state == SCAN_STOPPING) {
+        deadline = s_stop_deadline_us;
+    }
+    if (s_state == WIFI_MGR_STATE_CONNECTING && attempt_deadline() < deadline) {
+        deadline = attempt_deadline();
+    }
+    if (s_state == WIFI_MGR_STATE_BACKOFF && s_backoff_until_us && s_backoff_until_us < deadline) {
+        deadline = s_backoff_until_us;
+    }
+    if (s_state == WIFI_MGR_STATE_CONNECTED && s_quality_next_us < deadline) {
+        deadline = s_quality_next_us;
+    }
+    if (s_state == WIFI_MGR_STATE_INIT && s_radio_on && s_state_since_us + WIFI_MGR_RADIO_IDLE_MS * 1000LL < deadline) {
+        deadline = s_state_since_us + WIFI_MGR_RADIO_IDLE_MS * 1000LL;
+    }
+
+    if (deadline == INT64_MAX) {
+        return portMAX_DELAY;
+    }
+    int64_t now = esp_timer_get_time();
+    return deadline <= now ? 0 : pdMS_TO_TICKS((deadline - now) / 1000) + 1;
+}
+
+static void handle_timeouts(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    if (s_scan_state == SCAN_STOPPING && now >= s_stop_deadline_us) {
+        // 驱动没有在超时内确认停止，按已停止处理
+        stop_complete();
+    }
+    if (s_state == WIFI_MGR_STATE_CONNECTING && now >= attempt_deadline()) {
+        disconnect_own();
+        connect_failed(WIFI_REASON_CONNECTION_FAIL);
+    }
+    if (s_state == WIFI_MGR_STATE_BACKOFF && s_backoff_until_us && now >= s_backoff_until_us) {
+        s_backoff_until_us = 0;
+        if (s_scan_state == SCAN_IDLE) {
+            connect_begin();
+        } else {
+            s_connect_pending = true; // 等扫描结束
+        }
+    }
+    if (s_state == WIFI_MGR_STATE_CONNECTED && now >= s_quality_next_us) {
+        poll_quality();
+    }
+    if (s_state == WIFI_MGR_STATE_INIT && s_radio_on && now >= s_state_since_us + WIFI_MGR_RADIO_IDLE_MS * 1000LL) {
+        radio_off();
+    }
+}
+
+static void wifi_mgr_task(void *arg)
+{
+    wifi_mgr_cmd_t cmd;
+
+    while (1) {
+        if (xQueueReceive(s_cmd_queue, &cmd, next_wait()) == pdTRUE) {
+            switch (cmd.type) {
+            case CMD_SCAN:
+                s_scan_pending = true;
+                break;
+            case CMD_CANCEL:
+                s_scan_pending = false;
+                scan_stop();
+                break;
+            case CMD_CONNECT:
+                on_connect_cmd(&cmd);
+                break;
+            case CMD_DISCONNECT:
+                on_disconnect_cmd();
+                break;
+            case CMD_SCREEN:
+                on_screen_cmd(cmd.reason);
+                break;
+            case CMD_CHAN_DONE:
+                on_chan_done();
+                break;
+            case CMD_STA_DISCONNECTED:
+                on_sta_disconnected(cmd.reason);
+                break;
+            case CMD_GOT_IP:
+                on_got_ip(cmd.ip);
+                break;
+            }
+        }
+        handle_timeouts();
+
+        // 扫描请求在没有扫描和连接进行时执行
+        if (s_scan_pending && s_scan_state == SCAN_IDLE && !s_connect_pending &&
+            s_state != WIFI_MGR_STATE_CONNECTING) {
+            s_scan_pending = false;
+            scan_begin();
+        }
+    }
+}
+
+esp_err_t wifi_mgr_init(void)
+{
+    if (s_cmd_queue) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = esp_netif_init();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Netif init failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    err = esp_event_loop_create_default();
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) { // 已由其他模块创建
+        ESP_LOGE(TAG, "Event loop create failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    if (esp_netif_create_default_wifi_sta() == NULL) {
+        ESP_LOGE(TAG, "Create STA netif failed");
+        return ESP_FAIL;
+    }
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    err = esp_wifi_init(&cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi init failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    esp_wifi_set_storage(WIFI_STORAGE_RAM); // 配置由本模块和 wifi_store 管理，不写驱动自己的NVS
+    wifi_store_init();
+    esp_wifi_set_mode(WIFI_MODE_STA);
+
+    s_cmd_queue = xQueueCreate(WIFI_MGR_QUEUE_LEN, sizeof(wifi_mgr_cmd_t));
+    if (!s_cmd_queue) {
+        return ESP_ERR_NO_MEM;
+    }
+    wifi_policy_init(&s_policy, esp_random());
+    s_state_since_us = esp_timer_get_time();
+    set_state(WIFI_MGR_STATE_INIT);
+    if (xTaskCreate(wifi_mgr_task, "wifi_mgr", WIFI_MGR_TASK_STACK, NULL, WIFI_MGR_TASK_PRIO, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create task");
+        vQueueDelete(s_cmd_queue);
+        s_cmd_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, wifi_event_cb, NULL);
+    esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, wifi_event_cb, NULL);
+    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, wifi_event_cb, NULL);
+
+    ESP_LOGI(TAG, "WiFi manager ready");
+    return ESP_OK;
+}
+
+bool wifi_mgr_is_ready(void)
+{
+    return s_cmd_queue != NULL;
+}
+
+esp_err_t wifi_mgr_scan_start(void)
+{
+    return send_simple(CMD_SCAN);
+}
+
+esp_err_t wifi_mgr_scan_cancel(void)
+{
+    return send_simple(CMD_CANCEL);
+}
+
+bool wifi_mgr_is_scanning(void)
+{
+    return s_scan_state != SCAN_IDLE;
+}
+
+esp_err_t wifi_mgr_connect(const char *ssid, const char *password)
+{
+    if (!s_cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (ssid == NULL || ssid[0] == '\0') {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    wifi_mgr_cmd_t cmd = {.type = CMD_CONNECT};
+    strlcpy(cmd.ssid, ssid, sizeof(cmd.ssid));
+    strlcpy(cmd.password, password ? password : "", sizeof(cmd.password));
+    send_cmd(&cmd, pdMS_TO_TICKS(100));
+    return ESP_OK;
+}
+
+esp_err_t wifi_mgr_connect_known(void)
+{
+    wifi_store_entry_t entry;
+
+    if (!s_cmd_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (wifi_store_get(0, &entry) != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return wifi_mgr_connect(entry.ssid, entry.password);
+}
+
+esp_err_t wifi_mgr_disconnect(void)
+{
+    return send_simple(CMD_DISCONNECT);
+}
+
+void wifi_mgr_set_screen_on(bool on)
+{
+    if (!s_cmd_queue) {
+        return;
+    }
+    wifi_mgr_cmd_t cmd = {.type = CMD_SCREEN, .reason = on};
+    send_cmd(&cmd, pdMS_TO_TICKS(100));
+}
+
+uint8_t wifi_mgr_rssi_bars(int8_t rssi)
+{
+    if (rssi >= -55) {
+        return 4;
+    } else if (rssi >= -67) {
+        return 3;
+    } else if (rssi >= -78) {
+        return 2;
+    }
+    return 1;
+}
+
+wifi_mgr_state_t wifi_mgr_get_state(void)
+{
+    return s_state;
+}
+
+const char *wifi_mgr_state_name(wifi_mgr_state_t state)
+{
+    return state < WIFI_MGR_STATE_MAX ? s_state_names[state] : "?";
+}
+
+void wifi_mgr_get_stats(wifi_mgr_stats_t *stats)
+{
+    int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    stats->time_ms[s_state] += (uint32_t)((now - s_state_since_us) / 1000);
+    if (s_radio_on) {
+        stats->radio_on_ms += (uint32_t)((now - s_radio_since_us) / 1000);
+    }
+    taskEXIT_CRITICAL(&s_mux);
+}
+
+void wifi_mgr_report(void)
+{
+    wifi_mgr_stats_t st;
+    wifi_mgr_get_stats(&st);
+
+    ESP_LOGI(TAG, "state %s, %lu transitions", wifi_mgr_state_name(s_state), (unsigned long)st.transitions);
+    for (int i = WIFI_MGR_STATE_INIT; i < WIFI_MGR_STATE_MAX; i++) {
+        ESP_LOGI(TAG, "  %-10s entered %4lu times, %8lu ms", s_state_names[i],
+                 (unsigned long)st.entries[i], (unsigned long)st.time_ms[i]);
+    }
+    ESP_LOGI(TAG, "connect ok %lu, failed attempts %lu, last %lu ms, max %lu ms",
+             (unsigned long)st.connect_ok, (unsigned long)st.connect_fail,
+             (unsigned long)st.last_connect_ms, (unsigned long)st.max_connect_ms);
+    ESP_LOGI(TAG, "backoff rounds %lu, last wait %lu ms", (unsigned long)st.backoff_rounds,
+             (unsigned long)st.last_backoff_ms);
+    ESP_LOGI(TAG, "cached AP ok %lu, fallback %lu, boot to ip %lu ms",
+             (unsigned long)st.fast_ok, (unsigned long)st.fast_fallback, (unsigned long)st.boot_to_ip_ms);
+    ESP_LOGI(TAG, "radio started %lu times, on %lu ms", (unsigned long)st.radio_starts,
+             (unsigned long)st.radio_on_ms);
+}
@@ -0,0 +1,215 @@
+/**
+ * @file wifi_mgr.h
+ * @brief WLAN 管理任务
+ *
+ * 网络协议栈和 WLAN 驱动只在 wifi_mgr_init() 中初始化一次，之后所有 esp_wifi
+ * 调用都在管理任务中执行，对外接口只向任务发送命令，可在任意任务中调用。
+ *
+ * 状态机：
+ *   OFF ──init──> INIT ──scan──> SCANNING ──done──> INIT
+ *                  │ connect
+ *                  v
+ *              CONNECTING ──got ip──> CONNECTED ──断开──> CONNECTING
+ *                  │ 重试次数用完
+ *                  v
+ *               BACKOFF ──到时──> CONNECTING
+ * 密码错误等认证失败不进入 BACKOFF，直接回到 INIT；其他失败一直按退避策略重试，
+ * 路由器重启等情况下恢复后会自动连上。BACKOFF 等待时间由 wifi_policy 计算
+ * （指数退避加抖动，熄屏时更长），亮屏时若剩余等待超过亮屏策略的时间会提前重试。
+ * CONNECTED / BACKOFF 状态下也可以扫描，状态不变；连接过程中的扫描请求等连接结果出来后执行。
+ *
+ * 连接成功的网络由 wifi_store 保存，连接已知网络时第一次尝试直接使用上次的 BSSID 和信道，
+ * 跳过全信道扫描；失败后的重试改为普通连接（驱动扫描全部信道）。
+ *
+ * 射频只在需要时开启：INIT 状态空闲超过 WIFI_MGR_RADIO_IDLE_MS 以及 BACKOFF 等待期间关闭射频。
+ * 已连接时定期读取信号强度，格数变化时发布 WIFI_MGR_EVENT_QUALITY。
+ *
+ * 扫描逐信道进行（每个信道一次非阻塞扫描），每发现一个新网络就通过默认事件循环
+ * 发布 WIFI_MGR_EVENT_SCAN_AP，界面可以逐条加入列表。
+ * 事件在默认事件循环任务中分发，处理函数中更新界面需获取 lvgl_port_lock。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_event.h"
+#include "esp_wifi_types.h"
+
+#define WIFI_MGR_MAX_APS        32      // 一轮扫描最多上报的网络数（按 SSID 去重）
+#define WIFI_MGR_CHAN_SCAN_MS   120     // 每个信道的主动扫描时间
+#define WIFI_MGR_CONNECT_RETRY  3       // 进入 BACKOFF 前的连续重试次数
+#define WIFI_MGR_QUALITY_MS     10000   // 已连接时读取信号强度的周期（熄屏时 x6）
+#define WIFI_MGR_RADIO_IDLE_MS  10000   // INIT 状态空闲多久后关闭射频
+
+ESP_EVENT_DECLARE_BASE(WIFI_MGR_EVENT);
+
+/** WIFI_MGR_EVENT 事件 */
+typedef enum {
+    WIFI_MGR_EVENT_STATE,           // 状态变化，数据为 wifi_mgr_state_t（新状态）
+    WIFI_MGR_EVENT_SCAN_START,      // 开始扫描，无数据
+    WIFI_MGR_EVENT_SCAN_AP,         // 发现网络，数据为 wifi_mgr_ap_t
+    WIFI_MGR_EVENT_SCAN_DONE,       // 扫描结束，数据为 wifi_mgr_scan_done_t
+    WIFI_MGR_EVENT_CONNECTED,       // 已获取IP，数据为 wifi_mgr_conn_t
+    WIFI_MGR_EVENT_DISCONNECTED,    // 已连接的网络断开，数据为 wifi_mgr_fail_t
+    WIFI_MGR_EVENT_CONNECT_FAILED,  // 连接失败，数据为 wifi_mgr_fail_t
+    WIFI_MGR_EVENT_QUALITY,         // 信号格数变化，数据为 wifi_mgr_quality_t
+} wifi_mgr_event_t;
+
+/** 状态 */
+typedef enum {
+    WIFI_MGR_STATE_OFF,         // 未初始化
+    WIFI_MGR_STATE_INIT,        // 协议栈已初始化，未连接
+    WIFI_MGR_STATE_SCANNING,    // 未连接时扫描中
+    WIFI_MGR_STATE_CONNECTING,  // 连接中（含立即重试）
+    WIFI_MGR_STATE_CONNECTED,   // 已获取IP
+    WIFI_MGR_STATE_BACKOFF,     // 连接失败，等待后重试
+    WIFI_MGR_STATE_MAX,
+} wifi_mgr_state_t;
+
+/** 扫描到的网络 */
+typedef struct {
+    char ssid[33];
+    int8_t rssi;
+    uint8_t channel;
+    wifi_auth_mode_t authmode;
+} wifi_mgr_ap_t;
+
+/** 扫描结束信息 */
+typedef struct {
+    uint16_t count;         // 本轮上报的网络数
+    bool cancelled;         // 被取消
+    uint32_t duration_ms;   // 本轮扫描耗时
+} wifi_mgr_scan_done_t;
+
+/** 连接成功信息 */
+typedef struct {
+    char ssid[33];
+    uint32_t ip;            // IPv4 地址，网络字节序
+    int8_t rssi;
+    uint8_t channel;
+    uint32_t connect_ms;    // 从开始连接到获取IP的耗时
+    bool fast;              // 使用缓存的 BSSID/信道直连成功
+} wifi_mgr_conn_t;
+
+/** 断开/失败信息 */
+typedef struct {
+    char ssid[33];
+    uint8_t reason;         // wifi_err_reason_t
+    bool give_up;           // 不再自动重试（认证失败或主动断开）
+    uint32_t retry_ms;      // 下次自动重试的等待时间，0 表示立即重试或不再重试
+} wifi_mgr_fail_t;
+
+/** 连接质量 */
+typedef struct {
+    int8_t rssi;
+    uint8_t bars;           // 信号格数 1~4
+} wifi_mgr_quality_t;
+
+/** 统计信息 */
+typedef struct {
+    uint32_t entries[WIFI_MGR_STATE_MAX];   // 进入各状态的次数
+    uint32_t time_ms[WIFI_MGR_STATE_MAX];   // 各状态累计停留时间（含当前状态）
+    uint32_t transitions;                   // 状态切换总次数
+    uint32_t connect_ok;                    // 连接成功次数
+    uint32_t connect_fail;                  // 单次连接尝试失败次数
+    uint32_t last_connect_ms;               // 最近一次连接耗时
+    uint32_t max_connect_ms;                // 最长连接耗时
+    uint32_t fast_ok;                       // 缓存直连成功次数
+    uint32_t fast_fallback;                 // 缓存直连失败、改为普通连接的次数
+    uint32_t boot_to_ip_ms;                 // 开机到首次获取IP的时间，0表示尚未连接
+    uint32_t backoff_rounds;                // 进入退避等待的次数
+    uint32_t last_backoff_ms;               // 最近一次退避等待时间
+    uint32_t radio_starts;                  // 射频开启次数
+    uint32_t radio_on_ms;                   // 射频累计开启时间
+} wifi_mgr_stats_t;
+
+/**
+ * 初始化网络接口、默认事件循环和 WLAN 驱动，创建管理任务
+ * 只执行一次，重复调用直接返回 ESP_OK；需在 nvs_flash_init() 之后调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t wifi_mgr_init(void);
+
+/**
+ * 是否已完成初始化，未完成时扫描和连接接口返回 ESP_ERR_INVALID_STATE
+ * @return bool
+ */
+bool wifi_mgr_is_ready(void);
+
+/**
+ * 异步开始一轮扫描，正在扫描时忽略
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t wifi_mgr_scan_start(void);
+
+/**
+ * 取消正在进行的扫描，之后会收到 cancelled 为 true 的 SCAN_DONE
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t wifi_mgr_scan_cancel(void);
+
+/**
+ * 是否正在扫描
+ * @return bool
+ */
+bool wifi_mgr_is_scanning(void);
+
+/**
+ * 异步连接网络，已连接其他网络时先断开；正在扫描时先取消扫描
+ * 连接成功后保存到已知网络
+ * @param ssid 网络名称
+ * @param password 密码，开放网络为空串
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t wifi_mgr_connect(const char *ssid, const char *password);
+
+/**
+ * 连接最近一次连接成功的网络
+ * @return esp_err_t 没有已知网络返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t wifi_mgr_connect_known(void);
+
+/**
+ * 断开并停止自动重连
+ * @return esp_err_t 未初始化返回 ESP_ERR_INVALID_STATE
+ */
+esp_err_t wifi_mgr_disconnect(void);
+
+/**
+ * 设置屏幕状态，选择对应的重连策略
+ * @param on 是否亮屏
+ */
+void wifi_mgr_set_screen_on(bool on);
+
+/**
+ * 信号强度换算为格数
+ * @param rssi 信号强度（dBm）
+ * @return uint8_t 1~4
+ */
+uint8_t wifi_mgr_rssi_bars(int8_t rssi);
+
+/**
+ * 获取当前状态
+ * @return wifi_mgr_state_t
+ */
+wifi_mgr_state_t wifi_mgr_get_state(void);
+
+/**
+ * 状态名称
+ * @param state 状态
+ * @return const char*
+ */
+const char *wifi_mgr_state_name(wifi_mgr_state_t state);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void wifi_mgr_get_stats(wifi_mgr_stats_t *stats);
+
+/**
+ * 输出状态统计到日志
+ */
+void wifi_mgr_report(void);
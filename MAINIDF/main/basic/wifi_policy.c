@@ -0,0 +1,79 @@
+/**
+ * @file wifi_policy.c
+ * @brief WLAN 重连策略实现
+ */
+
+#include "wifi_policy.h"
+#include <string.h>
+
+static const wifi_policy_cfg_t s_default_cfg[WIFI_POLICY_MODE_MAX] = {
+    [WIFI_POLICY_SCREEN_ON] = WIFI_POLICY_DEFAULT_ON,
+    [WIFI_POLICY_SCREEN_OFF] = WIFI_POLICY_DEFAULT_OFF,
+};
+
+// xorshift32
+static uint32_t next_rand(wifi_policy_t *p)
+{
+    uint32_t x = p->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    p->rng = x;
+    return x;
+}
+
+void wifi_policy_init(wifi_policy_t *p, uint32_t seed)
+{
+    memcpy(p->cfg, s_default_cfg, sizeof(p->cfg));
+    p->failures = 0;
+    p->rng = seed ? seed : 0x9E3779B9u;
+}
+
+void wifi_policy_set(wifi_policy_t *p, wifi_policy_mode_t mode, const wifi_policy_cfg_t *cfg)
+{
+    if (mode < WIFI_POLICY_MODE_MAX) {
+        p->cfg[mode] = *cfg;
+        if (p->cfg[mode].jitter_pct > 100) {
+            p->cfg[mode].jitter_pct = 100;
+        }
+    }
+}
+
+uint32_t wifi_policy_delay(wifi_policy_t *p, wifi_policy_mode_t mode)
+{
+    if (p->failures == 0 || mode >= WIFI_POLICY_MODE_MAX) {
+        return 0;
+    }
+
+    const wifi_policy_cfg_t *cfg = &p->cfg[mode];
+    uint64_t delay = cfg->base_ms;
+    for (uint16_t i = 1; i < p->failures && delay < cfg->max_ms; i++) {
+        delay <<= 1;
+    }
+    if (delay > cfg->max_ms) {
+        delay = cfg->max_ms;
+    }
+
+    // 在 [delay * (1 - j), delay * (1 + j)] 内均匀分布，结果不超过上限
+    if (cfg->jitter_pct) {
+        uint64_t span = delay * cfg->jitter_pct / 100;
+        delay = delay - span + next_rand(p) % (2 * span + 1);
+        if (delay > cfg->max_ms) {
+            delay = cfg->max_ms;
+        }
+    }
+    return (uint32_t)delay;
+}
+
+uint32_t wifi_policy_fail(wifi_policy_t *p, wifi_policy_mode_t mode)
+{
+    if (p->failures < UINT16_MAX) {
+        p->failures++;
+    }
+    return wifi_policy_delay(p, mode);
+}
+
+void wifi_policy_reset(wifi_policy_t *p)
+{
+    p->failures = 0;
+}
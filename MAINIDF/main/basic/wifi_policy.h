@@ -0,0 +1,81 @@
+/**
+ * @file wifi_policy.h
+ * @brief WLAN 重连策略
+ *
+ * 连接失败（一轮立即重试用完）后等待多久再试：指数退避加随机抖动，
+ * 亮屏和熄屏使用不同的参数，熄屏时退避更快变长，减少射频开启时间。
+ *
+ * 第 n 轮失败后的等待时间：min(base << (n-1), max)，再在 ±jitter_pct% 范围内随机。
+ * 抖动避免多台设备在路由器重启后同时重连。
+ *
+ * 本模块只做计算，不读时钟、不依赖 ESP-IDF：只返回等待时长，由调用方读时钟并保存截止时间，
+ * 随机数由种子决定，结果可重现。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** 策略模式 */
+typedef enum {
+    WIFI_POLICY_SCREEN_ON,
+    WIFI_POLICY_SCREEN_OFF,
+    WIFI_POLICY_MODE_MAX,
+} wifi_policy_mode_t;
+
+/** 退避参数 */
+typedef struct {
+    uint32_t base_ms;       // 第一轮失败后的等待时间
+    uint32_t max_ms;        // 等待时间上限
+    uint8_t jitter_pct;     // 随机抖动幅度（百分比，0~100）
+} wifi_policy_cfg_t;
+
+/** 策略状态 */
+typedef struct {
+    wifi_policy_cfg_t cfg[WIFI_POLICY_MODE_MAX];
+    uint16_t failures;      // 连续失败轮数，连接成功后清零
+    uint32_t rng;           // 随机数状态
+} wifi_policy_t;
+
+/** 默认参数 */
+#define WIFI_POLICY_DEFAULT_ON  { .base_ms = 5000,  .max_ms = 5 * 60 * 1000,  .jitter_pct = 20 }
+#define WIFI_POLICY_DEFAULT_OFF { .base_ms = 30000, .max_ms = 30 * 60 * 1000, .jitter_pct = 20 }
+
+/**
+ * 初始化为默认参数
+ * @param p 策略
+ * @param seed 随机数种子，0 会被替换为固定的非零值
+ */
+void wifi_policy_init(wifi_policy_t *p, uint32_t seed);
+
+/**
+ * 修改某个模式的参数
+ * @param p 策略
+ * @param mode 模式
+ * @param cfg 参数
+ */
+void wifi_policy_set(wifi_policy_t *p, wifi_policy_mode_t mode, const wifi_policy_cfg_t *cfg);
+
+/**
+ * 记录一轮失败并返回等待时间
+ * @param p 策略
+ * @param mode 当前模式
+ * @return uint32_t 等待时间（毫秒）
+ */
+uint32_t wifi_policy_fail(wifi_policy_t *p, wifi_policy_mode_t mode);
+
+/**
+ * 按当前失败轮数计算某个模式下的等待时间，不增加失败次数
+ * 用于模式切换（如亮屏）时重新计算剩余等待时间
+ * @param p 策略
+ * @param mode 模式
+ * @return uint32_t 等待时间（毫秒），没有失败时为0
+ */
+uint32_t wifi_policy_delay(wifi_policy_t *p, wifi_policy_mode_t mode);
+
+/**
+ * 连接成功，清零失败次数
+ * @param p 策略
+ */
+void wifi_policy_reset(wifi_policy_t *p);
@@ -0,0 +1,173 @@
+/**
+ * @file wifi_store.c
+ * @brief 已知 WLAN 网络存储实现
+ */
+
+#include "wifi_store.h"
+#include <stddef.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sys_kv.h"
+#include "settings.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "wifi_store";
+
+#define WIFI_STORE_KEY      "wifi_known"
+#define WIFI_STORE_VERSION  1
+
+/* NVS 中保存的格式，修改结构时增加版本号 */
+typedef struct {
+    uint8_t version;
+    uint8_t count;
+    wifi_store_entry_t entries[WIFI_STORE_MAX];
+} wifi_store_blob_t;
+
+static wifi_store_blob_t s_store;
+static SemaphoreHandle_t s_mutex = NULL;
+
+static int find_locked(const char *ssid)
+{
+    for (int i = 0; i < s_store.count; i++) {
+        if (strcmp(s_store.entries[i].ssid, ssid) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static esp_err_t write_locked(void)
+{
+    size_t len = offsetof(wifi_store_blob_t, entries) + s_store.count * sizeof(wifi_store_entry_t);
+    esp_err_t err = sys_kv_set_blob(WIFI_STORE_KEY, &s_store, len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Save failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+// 旧版本只在设置中保存最近一次连接的网络
+static void migrate_settings(void)
+{
+    wifi_store_entry_t entry = {0};
+
+    settings_get_str(SETTING_WIFI_SSID, entry.ssid, sizeof(entry.ssid));
+    if (entry.ssid[0] == '\0') {
+        return;
+    }
+    settings_get_str(SETTING_WIFI_PASS, entry.password, sizeof(entry.password));
+    s_store.entries[0] = entry;
+    s_store.count = 1;
+    if (write_locked() == ESP_OK) {
+        settings_reset(SETTING_WIFI_SSID);
+        settings_reset(SETTING_WIFI_PASS);
+        ESP_LOGI(TAG, "Imported '%s' from settings", entry.ssid);
+    }
+}
+
+esp_err_t wifi_store_init(void)
+{
+    if (s_mutex) {
+        return ESP_OK;
+    }
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_mutex) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    size_t len = sizeof(s_store);
+    esp_err_t err = sys_kv_get_blob(WIFI_STORE_KEY, &s_store, &len);
+    if (err != ESP_OK || s_store.version != WIFI_STORE_VERSION || s_store.count > WIFI_STORE_MAX ||
+        len != offsetof(wifi_store_blob_t, entries) + s_store.count * sizeof(wifi_store_entry_t)) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Discard stored networks (%s)", esp_err_to_name(err));
+        }
+        memset(&s_store, 0, sizeof(s_store));
+        s_store.version = WIFI_STORE_VERSION;
+        migrate_settings();
+    }
+    ESP_LOGI(TAG, "%u known networks", s_store.count);
+    xSemaphoreGive(s_mutex);
+    return ESP_OK;
+}
+
+int wifi_store_count(void)
+{
+    return s_store.count;
+}
+
+esp_err_t wifi_store_get(int index, wifi_store_entry_t *out)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (index >= 0 && index < s_store.count) {
+        *out = s_store.entries[index];
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t wifi_store_find(const char *ssid, wifi_store_entry_t *out)
+{
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    int i = find_locked(ssid);
+    if (i >= 0 && out) {
+        *out = s_store.entries[i];
+    }
+    xSemaphoreGive(s_mutex);
+    return i >= 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t wifi_store_save(const wifi_store_entry_t *entry)
+{
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (entry->ssid[0] == '\0') {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    int i = find_locked(entry->ssid);
+    if (i == 0 && memcmp(&s_store.entries[0], entry, sizeof(*entry)) == 0) {
+        xSemaphoreGive(s_mutex); // 已是最近一个且没有变化
+        return ESP_OK;
+    }
+
+    // 移到最前：已存在时覆盖原位置，否则淘汰最后一个
+    int last = i >= 0 ? i : (s_store.count < WIFI_STORE_MAX ? s_store.count++ : WIFI_STORE_MAX - 1);
+    memmove(&s_store.entries[1], &s_store.entries[0], last * sizeof(wifi_store_entry_t));
+    s_store.entries[0] = *entry;
+    esp_err_t err = write_locked();
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+esp_err_t wifi_store_forget(const char *ssid)
+{
+    if (!s_mutex) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    int i = find_locked(ssid);
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    if (i >= 0) {
+        memmove(&s_store.entries[i], &s_store.entries[i + 1], (s_store.count - i - 1) * sizeof(wifi_store_entry_t));
+        s_store.count--;
+        memset(&s_store.entries[s_store.count], 0, sizeof(wifi_store_entry_t));
+        err = write_locked();
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
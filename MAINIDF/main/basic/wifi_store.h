@@ -0,0 +1,69 @@
+/**
+ * @file wifi_store.h
+ * @brief 已知 WLAN 网络存储
+ *
+ * 保存连接成功过的网络（SSID、密码、最近一次的 BSSID/信道/认证方式），
+ * 按最近使用排序，整体作为一个二进制值保存在 sys_kv 中。
+ * 内容未变化时不写 NVS，重复连接同一个 AP 不会产生 flash 写操作。
+ *
+ * 首次初始化时会把旧版本保存在设置项 SETTING_WIFI_SSID/PASS 中的网络导入。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define WIFI_STORE_MAX      4       // 最多保存的网络数，超出时淘汰最久未用的
+
+/** 已知网络 */
+typedef struct {
+    char ssid[33];
+    char password[65];
+    uint8_t bssid[6];       // 最近一次连接的 AP，全0表示未知
+    uint8_t channel;        // 最近一次连接的信道，0表示未知
+    uint8_t authmode;       // wifi_auth_mode_t
+} wifi_store_entry_t;
+
+/**
+ * 从 sys_kv 读取已知网络，需在 sys_kv_init() 和 settings_init() 之后调用，可重复调用
+ * @return esp_err_t 操作结果
+ */
+esp_err_t wifi_store_init(void);
+
+/**
+ * 已知网络数量
+ * @return int
+ */
+int wifi_store_count(void);
+
+/**
+ * 按最近使用顺序读取
+ * @param index 0 为最近一次连接的网络
+ * @param out 输出
+ * @return esp_err_t 越界返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t wifi_store_get(int index, wifi_store_entry_t *out);
+
+/**
+ * 按 SSID 查找
+ * @param ssid 网络名称
+ * @param out 输出，可为NULL
+ * @return esp_err_t 未找到返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t wifi_store_find(const char *ssid, wifi_store_entry_t *out);
+
+/**
+ * 保存网络并移到最前，已存在时更新
+ * @param entry 网络信息
+ * @return esp_err_t 操作结果
+ */
+esp_err_t wifi_store_save(const wifi_store_entry_t *entry);
+
+/**
+ * 删除网络
+ * @param ssid 网络名称
+ * @return esp_err_t 未找到返回 ESP_ERR_NOT_FOUND
+ */
+esp_err_t wifi_store_forget(const char *ssid);
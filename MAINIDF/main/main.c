@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <time.h>
 #include "basic/jlc_lcd.h"
 #include "demos/lv_demos.h"
 #include "esp_littlefs.h"
@@ -8,12 +9,30 @@
 #include "nvs_flash.h"
 #include "esp_log.h"
 #include "esp_task_wdt.h"
+#include "esp_event.h"
 #include "basic/beepdrive.h"
+#include "basic/beep_melody.h"
+#include "basic/sys_kv.h"
+#include "basic/settings.h"
+#include "basic/assets.h"
+#include "basic/boot.h"
+#include "basic/splash.h"
+#include "basic/wifi_mgr.h"
+#include "basic/timesync.h"
+#include "basic/time_fmt.h"
+#include "basic/sys_tz.h"
+#include "basic/alarm.h"
+#include "basic/lunar.h"
+#include "basic/weather.h"
+#include "basic/http_pool.h"
+#include "basic/home_mqtt.h"
+#include "basic/backlight.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
 #include "ui/app_ui.h"
+#include "ui/ui_bind.h"
 
 static const char *TAG = "MAPP";
 
@@ -147,10 +166,10 @@ bool init_gpio(void)
         }
         ESP_LOGI(TAG, "GPIO%d initialized", gpios[i].pin);
 
-        // 初始化背光为开启状态
+        // 背光先保持关闭，启动画面绘制完成后再由LEDC渐亮，避免显示未初始化的显存
         if (gpios[i].pin == 8)
         {
-            gpio_set_level(8, 1);
+            gpio_set_level(8, 0);
             sys_status.screen_on = true;
             sys_status.screen_brightness = 100; // 默认100%亮度
         }
@@ -159,19 +178,100 @@ bool init_gpio(void)
     return true;
 }
 
+#define STATUS_POLL_MS 1000      // 时间刷新周期
+#define BATTERY_POLL_COUNT 10    // 每10个周期读取一次电池
+
+// 电量变化2%以上或充电状态变化时上报（滤掉采样抖动），队列中只保留最新值，随下一批发送
+static void report_battery(void)
+{
+    static int last_percent = -100;
+    static bool last_charging = false;
+    int percent = (int)(sys_status.battery_percentage + 0.5f);
+    char buf[8];
+
+    if (percent > last_percent - 2 && percent < last_percent + 2 && sys_status.is_charging == last_charging)
+    {
+        return;
+    }
+    snprintf(buf, sizeof(buf), "%d", percent);
+    if (home_mqtt_publish("battery", buf, HOME_MQTT_F_RETAIN | HOME_MQTT_F_LATEST) != ESP_OK ||
+        home_mqtt_publish("charging", sys_status.is_charging ? "1" : "0", HOME_MQTT_F_RETAIN | HOME_MQTT_F_LATEST) != ESP_OK)
+    {
+        return; // 服务尚未启动，下次再报
+    }
+    last_percent = percent;
+    last_charging = sys_status.is_charging;
+}
+
+/**
+ * 刷新状态栏数据，只写入界面绑定，由LVGL任务统一更新控件
+ */
+static void status_poll(void)
+{
+    static uint32_t count = 0;
+    static time_fmt_t time_fmt;
+    static time_fmt_cache_t time_cache;
+    static int last_yday = -1;
+
+    if (count == 0)
+    {
+        time_fmt_compile(&time_fmt, "%H:%M:%S");
+    }
+
+    // 对时前不显示无效时间；每秒只重写变化的数字
+    if (timesync_is_valid())
+    {
+        time_t now = time(NULL);
+        struct tm tm_now;
+        sys_tz_localtime(now, &tm_now);
+        if (time_fmt_update(&time_fmt, &time_cache, &tm_now))
+        {
+            ui_bind_set_str(UI_BIND_TIME, time_cache.buf);
+        }
+        // 日期变化时更新节日（本地时区）
+        if (tm_now.tm_yday != last_yday)
+        {
+            last_yday = tm_now.tm_yday;
+            ui_bind_set_str(UI_BIND_FESTIVAL,
+                            lunar_holiday_name(lunar_holiday(tm_now.tm_year + 1900, tm_now.tm_mon + 1, tm_now.tm_mday)));
+        }
+    }
+    else
+    {
+        ui_bind_set_str(UI_BIND_TIME, "--:--:--");
+    }
+
+    if (count++ % BATTERY_POLL_COUNT == 0)
+    {
+        sys_status.battery_percentage = read_bat_percentage();
+        sys_status.is_charging = is_charging();
+        ui_bind_set(UI_BIND_BATTERY, (int32_t)(sys_status.battery_percentage + 0.5f), sys_status.is_charging ? "chg" : "");
+        report_battery();
+    }
+}
+
 /**
  * 系统消息处理任务
  */
 void system_message_task(void *pvParameters)
 {
     system_message_t msg;
+    TickType_t last_poll = xTaskGetTickCount();
 
     ESP_LOGI(TAG, "System message task started");
+    status_poll();
 
     while (1)
     {
-        // 等待接收消息，超时时间为 portMAX_DELAY（永久等待）
-        if (xQueueReceive(system_message_queue, &msg, portMAX_DELAY) == pdTRUE)
+        // 等待消息，到达刷新周期时更新状态栏
+        TickType_t elapsed = xTaskGetTickCount() - last_poll;
+        TickType_t wait = elapsed >= pdMS_TO_TICKS(STATUS_POLL_MS) ? 0 : pdMS_TO_TICKS(STATUS_POLL_MS) - elapsed;
+        if (xQueueReceive(system_message_queue, &msg, wait) != pdTRUE)
+        {
+            last_poll = xTaskGetTickCount();
+            status_poll();
+        }
+        else
         {
             ESP_LOGI(TAG, "Received message type: %d, param: %d", msg.type, msg.param);
 
@@ -179,24 +279,32 @@ void system_message_task(void *pvParameters)
             {
             case SYS_MSG_SCREEN_ON:
                 ESP_LOGI(TAG, "Processing: Turn screen ON");
-                bsp_display_brightness_fade(sys_status.screen_brightness, LCD_FADE_TIME_MS); // 恢复到默认亮度
+                backlight_set_screen_on(true); // 恢复到设定亮度（夜间/环境光调节后）
                 sys_status.screen_on = true;
+                wifi_mgr_set_screen_on(true); // 亮屏重连策略
+                weather_set_screen_on(true); // 数据已到期时立即刷新
+                home_mqtt_set_screen_on(true); // 恢复连接，接收设备状态
                 break;
 
             case SYS_MSG_SCREEN_OFF:
                 ESP_LOGI(TAG, "Processing: Turn screen OFF");
-                bsp_display_backlight_off();
+                backlight_set_screen_on(false); // 渐灭后液晶屏休眠、LVGL暂停
                 sys_status.screen_on = false;
+                wifi_mgr_set_screen_on(false); // 熄屏时退避更长
+                weather_set_screen_on(false); // 熄屏时延长刷新间隔
+                home_mqtt_set_screen_on(false); // 发送完队列后断开，不再有心跳
                 break;
 
             case SYS_MSG_SET_BRIGHTNESS:
                 ESP_LOGI(TAG, "Processing: Set brightness to %d", msg.param);
-                bsp_display_brightness_fade(msg.param, LCD_FADE_TIME_MS);
+                backlight_set_level(msg.param); // 连续调节时只渐变到最后一次的亮度
                 sys_status.screen_brightness = msg.param;
+                settings_set_int(SETTING_BRIGHTNESS, msg.param); // 保存，重启后恢复
                 break;
 
             case SYS_MSG_POWER_OFF:
                 ESP_LOGI(TAG, "Processing: Power off system");
+                sys_kv_flush(); // 写回未提交的设置
                 ACC(0); // 关闭电源
                 break;
             case SYS_MSG_MSC:
@@ -269,19 +377,22 @@ void key_event_handler(int gpio, key_event_t evt, void *arg)
         else if (duration >= pdMS_TO_TICKS(3000)) // 长按3秒以上调整亮度
         {
             ESP_LOGI("KEY", "Adjust brightness triggered");
-            // 亮度循环：100% -> 50% -> 25% -> 100%
+            // 亮度循环：高 -> 中 -> 低 -> 高（默认 100% -> 50% -> 25%）
+            int high = settings_get_int(SETTING_BRIGHTNESS_HIGH);
+            int mid = settings_get_int(SETTING_BRIGHTNESS_MID);
+            int low = settings_get_int(SETTING_BRIGHTNESS_LOW);
             int new_brightness;
-            if (sys_status.screen_brightness == 100)
+            if (sys_status.screen_brightness == high)
             {
-                new_brightness = 50;
+                new_brightness = mid;
             }
-            else if (sys_status.screen_brightness == 50)
+            else if (sys_status.screen_brightness == mid)
             {
-                new_brightness = 25;
+                new_brightness = low;
             }
             else
             {
-                new_brightness = 100;
+                new_brightness = high;
             }
             send_system_message(SYS_MSG_SET_BRIGHTNESS, new_brightness);
         }
@@ -311,6 +422,194 @@ void default_key_cbReg()
     hw_key_register_callback(HOME_KEY_GPIO, key_event_handler, NULL);
 }
 
+/*
+ * 启动阶段
+ * 上电锁存（GPIO/ACC）在 app_main 中最先串行完成，其余按依赖关系并行：
+ * 显示链路固定在核心1，存储和外设放在核心0，文件系统挂载推迟到首帧之后
+ * 液晶屏初始化后立即显示启动画面，各阶段完成时推进进度条，UI阶段由LVGL接管
+ */
+enum
+{
+    STAGE_I2C,
+    STAGE_ADC,
+    STAGE_BEEP,
+    STAGE_NVS,
+    STAGE_KEYS,
+    STAGE_ASSETS,
+    STAGE_DISPLAY,
+    STAGE_SYSMSG,
+    STAGE_UI,
+    STAGE_FS,
+    STAGE_WIFI,
+    STAGE_ALARM,
+    STAGE_WEATHER,
+    STAGE_MQTT,
+};
+
+static esp_err_t stage_i2c(void)
+{
+    return bsp_i2c_init();
+}
+
+static esp_err_t stage_adc(void)
+{
+    init_adc();
+    return ESP_OK;
+}
+
+static esp_err_t stage_beep(void)
+{
+    ESP_LOGI(TAG, "Initializing buzzer...");
+    esp_err_t ret = beep_init(); // 初始化蜂鸣器
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    ret = play_note_async(1500, 200); // 播放启动音，1500Hz，持续200ms
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to play startup sound: %s", esp_err_to_name(ret));
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stage_nvs(void)
+{
+    init_nvs();
+    esp_err_t ret = sys_kv_init();
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    ret = settings_init();
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    return sys_tz_init();
+}
+
+static esp_err_t stage_keys(void)
+{
+    // 初始化按键模块并注册回调
+    if (!hw_key_init())
+    {
+        ESP_LOGE("KEY", "Key module init failed");
+        return ESP_FAIL;
+    }
+    hw_key_add(PW_KEY_GPIO, KEY_PRESS_LEVEL);
+    hw_key_add(HOME_KEY_GPIO, KEY_PRESS_LEVEL);
+    default_key_cbReg();
+    return ESP_OK;
+}
+
+static esp_err_t stage_assets(void)
+{
+    assets_init(); // 映射只读资源分区，没有资源包时字体/图片仍使用编译进固件的版本
+    return ESP_OK;
+}
+
+static esp_err_t stage_display(void)
+{
+    esp_err_t ret = bsp_display_start(); // 初始化液晶屏，不添加LVGL接口
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    splash_show(bsp_display_get_panel(), bsp_display_get_io());
+
+    // 启动画面就绪后按保存的亮度打开背光，之后的亮度变化都经过背光控制器
+    sys_status.screen_brightness = settings_get_int(SETTING_BRIGHTNESS);
+    backlight_set_level(sys_status.screen_brightness);
+    backlight_set_screen_on(true);
+    return backlight_init();
+}
+
+static esp_err_t stage_sysmsg(void)
+{
+    // 创建系统消息处理任务
+    if (xTaskCreate(system_message_task, "sys_msg_task", SYSTEM_TASK_STACK_SIZE, NULL, SYSTEM_TASK_PRIORITY, NULL) != pdPASS)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stage_ui(void)
+{
+    bsp_lvgl_init(); // 初始化LVGL
+
+    // 持锁完成添加屏幕、创建主界面和首帧渲染，LVGL的第一帧就是主界面，不会出现空白屏
+    lvgl_port_lock(0);
+    splash_finish();
+    bsp_lvgl_add_display();
+    mainscr_init(); // 初始化主屏幕UI
+    lv_refr_now(NULL);
+    lvgl_port_unlock();
+
+    boot_first_frame();
+    return ESP_OK;
+}
+
+static esp_err_t stage_fs(void)
+{
+    init_littlefs(); // 初始化文件系统，挂载失败时会格式化，耗时较长
+    beep_melody_init(); // 铃声文件位于LittleFS，挂载后再启用旋律播放
+    return ESP_OK;
+}
+
+static esp_err_t stage_wifi(void)
+{
+    esp_err_t ret = wifi_mgr_init(); // 网络协议栈和WLAN驱动只初始化一次
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+    http_pool_init(); // 各服务共用的HTTP连接
+    timesync_init(); // 连接成功后自动对时
+    wifi_mgr_connect_known(); // 有已知网络时用上次的AP直连，没有时射频保持关闭
+    return ESP_OK;
+}
+
+static esp_err_t stage_alarm(void)
+{
+    return alarm_init(); // 闹钟保存在LittleFS，按本地时间计算
+}
+
+static esp_err_t stage_weather(void)
+{
+    return weather_init(); // 先发布LittleFS中的缓存，联网后再刷新
+}
+
+static esp_err_t stage_mqtt(void)
+{
+    return home_mqtt_init(); // 读取LittleFS中未发送的消息，联网后再连接
+}
+
+static void boot_progress(const char *stage, uint32_t done, uint32_t total)
+{
+    splash_progress(done * 100 / total);
+}
+
+static const boot_stage_t boot_stages[] = {
+    [STAGE_I2C]     = {"i2c",     stage_i2c,      0,                                                        0,                      1, 0},
+    [STAGE_ADC]     = {"adc",     stage_adc,      0,                                                        0,                      0, 0},
+    [STAGE_BEEP]    = {"beep",    stage_beep,     0,                                                        0,                      0, 0},
+    [STAGE_NVS]     = {"nvs",     stage_nvs,      0,                                                        0,                      0, 0},
+    [STAGE_KEYS]    = {"keys",    stage_keys,     BIT(STAGE_NVS),                                           0,                      0, 0},
+    [STAGE_ASSETS]  = {"assets",  stage_assets,   0,                                                        0,                      1, 0},
+    // 背光与蜂鸣器共用LEDC渐变服务，等蜂鸣器安装完成再初始化背光；背光亮度来自设置
+    [STAGE_DISPLAY] = {"display", stage_display,  BIT(STAGE_BEEP) | BIT(STAGE_NVS),                         0,                      1, 0},
+    [STAGE_SYSMSG]  = {"sysmsg",  stage_sysmsg,   BIT(STAGE_DISPLAY) | BIT(STAGE_NVS) | BIT(STAGE_ADC),     0,                      0, 0},
+    [STAGE_UI]      = {"ui",      stage_ui,       BIT(STAGE_DISPLAY) | BIT(STAGE_I2C) | BIT(STAGE_ASSETS),  BOOT_STAGE_FIRST_FRAME, 1, 6144},
+    [STAGE_FS]      = {"fs",      stage_fs,       0,                                                        BOOT_STAGE_DEFERRED,    0, 0},
+    [STAGE_WIFI]    = {"wifi",    stage_wifi,     BIT(STAGE_NVS),                                           BOOT_STAGE_DEFERRED,    0, 0},
+    [STAGE_ALARM]   = {"alarm",   stage_alarm,    BIT(STAGE_FS) | BIT(STAGE_NVS),                           BOOT_STAGE_DEFERRED,    0, 0},
+    [STAGE_WEATHER] = {"weather", stage_weather,  BIT(STAGE_FS) | BIT(STAGE_WIFI),                          BOOT_STAGE_DEFERRED,    0, 0},
+    [STAGE_MQTT]    = {"mqtt",    stage_mqtt,     BIT(STAGE_FS) | BIT(STAGE_WIFI),                          BOOT_STAGE_DEFERRED,    0, 0},
+};
+
 void app_main(void)
 {
     // 初始化系统状态
@@ -332,47 +631,17 @@ void app_main(void)
         return;
     }
 
-    // 初始化GPIO
+    // 初始化GPIO并锁存电源，必须最先完成
     init_gpio();
-    ACC(1);         // 使能电源
-    bsp_i2c_init(); // I2C初始化
-    init_adc();
-
-    // 初始化按键模块并注册回调
-    if (!hw_key_init())
-    {
-        ESP_LOGE("KEY", "Key module init failed");
-    }
-    else
-    {
-        hw_key_add(PW_KEY_GPIO, KEY_PRESS_LEVEL);
-        hw_key_add(HOME_KEY_GPIO, KEY_PRESS_LEVEL);
-        default_key_cbReg();
-    }
-
-    ACC(1);
+    ACC(1); // 使能电源
 
-    ESP_LOGI(TAG, "Initializing buzzer...");
-    beep_init();                   // 初始化蜂鸣器
-    vTaskDelay(pdMS_TO_TICKS(10)); // 稍等一下确保初始化完成
+    // 默认事件循环先于各阶段创建，界面初始化时即可注册WLAN事件处理
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
 
-    ESP_LOGI(TAG, "Playing startup sound...");
-    esp_err_t result = play_note_async(1500, 200); // 播放启动音，1500Hz，持续200ms
-    if (result != ESP_OK)
-    {
-        ESP_LOGE(TAG, "Failed to play startup sound: %s", esp_err_to_name(result));
-    }
-    else
+    splash_init(); // 进度回调在各阶段任务中调用，锁需先于阶段任务创建
+    boot_set_progress_cb(boot_progress);
+    if (boot_run(boot_stages, sizeof(boot_stages) / sizeof(boot_stages[0])) != ESP_OK)
     {
-        ESP_LOGI(TAG, "Startup sound played successfully");
+        ESP_LOGE(TAG, "Some boot stages failed, see boot report");
     }
-
-    init_littlefs(); // 初始化文件系统
-    init_nvs();
-    bsp_lvgl_start(); // 初始化液晶屏lvgl接口
-
-    // 创建系统消息处理任务
-    xTaskCreate(system_message_task, "sys_msg_task", SYSTEM_TASK_STACK_SIZE, NULL, SYSTEM_TASK_PRIORITY, NULL);
-
-    mainscr_init(); // 初始化主屏幕UI
-}
\ No newline at end of file
+}
@@ -1,5 +1,13 @@
+#include <stdio.h>
+#include <math.h>
 #include "basic/jlc_lcd.h"
 #include "app_ui.h"
+#include "ui_bind.h"
+#include "ui_perf.h"
+#include "basic/wifi_mgr.h"
+#include "basic/weather.h"
+#include "basic/home_mqtt.h"
+#include "basic/assets.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -7,8 +15,15 @@ static const char *TAG = "mainscr";
 
 LV_FONT_DECLARE(font_alipuhui20);
 
-// 全局主屏幕对象
-lv_obj_t *main_screen = NULL;
+#define LOGO_SIZE   24      // 标题图标显示尺寸
+
+// 主屏幕控件
+static main_scr_widgets_t s_main;
+// 标题图标，像素数据在资源分区映射区
+static lv_img_dsc_t s_logo_dsc;
+
+_Static_assert(UI_BIND_DEVICE_0 + HOME_MQTT_DEVICES - 1 == UI_BIND_DEVICE_3, "device binds");
+_Static_assert(sizeof(s_main.devices) / sizeof(s_main.devices[0]) == HOME_MQTT_DEVICES, "device widgets");
 
 // WiFi应用按钮回调
 static void btn_wifi_app_cb(lv_event_t * e)
@@ -17,16 +32,7 @@ static void btn_wifi_app_cb(lv_event_t * e)
 
     if(code == LV_EVENT_CLICKED) {
         ESP_LOGI(TAG, "WiFi APP button clicked");
-        
-        lvgl_port_lock(0);
-        // 清理主屏幕
-        if(main_screen) {
-            lv_obj_del(main_screen);
-            main_screen = NULL;
-        }
-        lvgl_port_unlock();
-        
-        // 启动WiFi应用
+        // 启动WiFi应用，主屏幕保留在后台
         start_wifi_app();
     }
 }
@@ -53,87 +59,272 @@ static void btn_about_cb(lv_event_t * e)
     }
 }
 
-// 创建主屏幕
-void create_main_screen(void)
+// 设备点击回调：切换开关量设备
+static void device_click_cb(lv_event_t * e)
+{
+    uint8_t slot = (uint8_t)(uintptr_t)lv_event_get_user_data(e);
+    esp_err_t err = home_mqtt_device_toggle(slot);
+
+    if(err != ESP_OK) {
+        ESP_LOGW(TAG, "Toggle device %u: %s", slot, esp_err_to_name(err));
+    }
+}
+
+// 设备状态：开为绿色，关为灰色
+static void apply_device(lv_obj_t *obj, const ui_bind_val_t *val)
+{
+    lv_color_t color;
+
+    if(val->num == 1) {
+        color = lv_palette_main(LV_PALETTE_GREEN);
+    } else if(val->num == 0) {
+        color = lv_palette_main(LV_PALETTE_GREY);
+    } else {
+        color = lv_color_black();
+    }
+    lv_obj_set_style_text_color(obj, color, 0);
+    lv_label_set_text(obj, val->str);
+}
+
+// WLAN 状态：已连接时图标高亮
+static void apply_wifi(lv_obj_t *obj, const ui_bind_val_t *val)
+{
+    lv_color_t color;
+
+    if(val->num == 0) {
+        color = lv_palette_main(LV_PALETTE_GREY);
+    } else if(val->num == 1) {
+        color = lv_palette_main(LV_PALETTE_ORANGE); // 信号弱
+    } else {
+        color = lv_palette_main(LV_PALETTE_BLUE);
+    }
+    lv_obj_set_style_text_color(obj, color, 0);
+}
+
+// 电池电量：图标档位加百分比，充电时显示充电符号
+static void apply_battery(lv_obj_t *obj, const ui_bind_val_t *val)
+{
+    const char *icon;
+
+    if(val->str[0]) {
+        icon = LV_SYMBOL_CHARGE;
+    } else if(val->num > 80) {
+        icon = LV_SYMBOL_BATTERY_FULL;
+    } else if(val->num > 55) {
+        icon = LV_SYMBOL_BATTERY_3;
+    } else if(val->num > 30) {
+        icon = LV_SYMBOL_BATTERY_2;
+    } else if(val->num > 10) {
+        icon = LV_SYMBOL_BATTERY_1;
+    } else {
+        icon = LV_SYMBOL_BATTERY_EMPTY;
+    }
+    lv_label_set_text_fmt(obj, "%s %d%%", icon, (int)val->num);
+}
+
+// 创建主屏幕（由屏幕管理器在持锁时调用）
+static void main_scr_create(lv_obj_t *scr)
 {
-    lvgl_port_lock(0);
-    
-    // 清理当前屏幕
-    lv_obj_clean(lv_scr_act());
-    
     // 创建主屏幕容器
-    main_screen = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(main_screen, 320, 240);
-    lv_obj_set_style_border_width(main_screen, 0, 0);
-    lv_obj_set_style_pad_all(main_screen, 0, 0);
-    lv_obj_set_style_radius(main_screen, 0, 0);
+    s_main.root = lv_obj_create(scr);
+    lv_obj_set_size(s_main.root, 320, 240);
+    lv_obj_set_style_border_width(s_main.root, 0, 0);
+    lv_obj_set_style_pad_all(s_main.root, 0, 0);
+    lv_obj_set_style_radius(s_main.root, 0, 0);
     
     // 创建标题
-    lv_obj_t *title = lv_label_create(main_screen);
-    lv_label_set_text(title, "触屏时钟");
-    lv_obj_set_style_text_font(title, &siyuan_20, 0);
-    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 10);
+    s_main.title = lv_label_create(s_main.root);
+    lv_label_set_text(s_main.title, "触屏时钟");
+    lv_obj_set_style_text_font(s_main.title, &siyuan_20, 0);
+    lv_obj_align(s_main.title, LV_ALIGN_TOP_MID, 0, 10);
+
+    // 标题图标来自资源分区，没有资源包时不显示
+    if(assets_get_img("img/logo", &s_logo_dsc) == ESP_OK) {
+        s_main.logo = lv_img_create(s_main.root);
+        lv_img_set_src(s_main.logo, &s_logo_dsc);
+        lv_img_set_size_mode(s_main.logo, LV_IMG_SIZE_MODE_REAL);
+        lv_img_set_zoom(s_main.logo, LV_IMG_ZOOM_NONE * LOGO_SIZE / s_logo_dsc.header.h);
+        lv_obj_align_to(s_main.logo, s_main.title, LV_ALIGN_OUT_LEFT_MID, -6, 0);
+    }
     
     // 创建WiFi应用按钮
-    lv_obj_t *btn_wifi = lv_btn_create(main_screen);
-    lv_obj_set_size(btn_wifi, 120, 60);
-    lv_obj_align(btn_wifi, LV_ALIGN_CENTER, 0, -40);
-    lv_obj_add_event_cb(btn_wifi, btn_wifi_app_cb, LV_EVENT_CLICKED, NULL);
+    s_main.btn_wifi = lv_btn_create(s_main.root);
+    lv_obj_set_size(s_main.btn_wifi, 120, 60);
+    lv_obj_align(s_main.btn_wifi, LV_ALIGN_CENTER, 0, -40);
+    lv_obj_add_event_cb(s_main.btn_wifi, btn_wifi_app_cb, LV_EVENT_CLICKED, NULL);
     
-    lv_obj_t *label_wifi = lv_label_create(btn_wifi);
+    lv_obj_t *label_wifi = lv_label_create(s_main.btn_wifi);
     lv_label_set_text(label_wifi, "WiFi设置");
     lv_obj_set_style_text_font(label_wifi, &siyuan_20, 0);
     lv_obj_center(label_wifi);
     
     // 创建设置按钮
-    lv_obj_t *btn_settings = lv_btn_create(main_screen);
-    lv_obj_set_size(btn_settings, 120, 60);
-    lv_obj_align(btn_settings, LV_ALIGN_CENTER, 0, 30);
-    lv_obj_add_event_cb(btn_settings, btn_settings_cb, LV_EVENT_CLICKED, NULL);
+    s_main.btn_settings = lv_btn_create(s_main.root);
+    lv_obj_set_size(s_main.btn_settings, 120, 60);
+    lv_obj_align(s_main.btn_settings, LV_ALIGN_CENTER, 0, 30);
+    lv_obj_add_event_cb(s_main.btn_settings, btn_settings_cb, LV_EVENT_CLICKED, NULL);
     
-    lv_obj_t *label_settings = lv_label_create(btn_settings);
+    lv_obj_t *label_settings = lv_label_create(s_main.btn_settings);
     lv_label_set_text(label_settings, "设置");
     lv_obj_set_style_text_font(label_settings, &siyuan_20, 0);
     lv_obj_center(label_settings);
     
     // 创建关于按钮
-    lv_obj_t *btn_about = lv_btn_create(main_screen);
-    lv_obj_set_size(btn_about, 120, 60);
-    lv_obj_align(btn_about, LV_ALIGN_BOTTOM_MID, 0, -30);
-    lv_obj_add_event_cb(btn_about, btn_about_cb, LV_EVENT_CLICKED, NULL);
+    s_main.btn_about = lv_btn_create(s_main.root);
+    lv_obj_set_size(s_main.btn_about, 120, 60);
+    lv_obj_align(s_main.btn_about, LV_ALIGN_BOTTOM_MID, 0, -30);
+    lv_obj_add_event_cb(s_main.btn_about, btn_about_cb, LV_EVENT_CLICKED, NULL);
     
-    lv_obj_t *label_about = lv_label_create(btn_about);
+    lv_obj_t *label_about = lv_label_create(s_main.btn_about);
     lv_label_set_text(label_about, "关于");
     lv_obj_set_style_text_font(label_about, &siyuan_20, 0);
     lv_obj_center(label_about);
     
-    // 显示当前时间（模拟）
-    lv_obj_t *time_label = lv_label_create(main_screen);
-    lv_label_set_text(time_label, "12:34:56");
-    lv_obj_set_style_text_font(time_label, &siyuan_20, 0);
-    lv_obj_align(time_label, LV_ALIGN_TOP_RIGHT, -10, 10);
-    
-    lvgl_port_unlock();
-    
-    ESP_LOGI(TAG, "Main screen created");
+    // 显示当前时间
+    s_main.time = lv_label_create(s_main.root);
+    lv_label_set_text(s_main.time, "--:--:--");
+    lv_obj_set_style_text_font(s_main.time, &siyuan_20, 0);
+    lv_obj_align(s_main.time, LV_ALIGN_TOP_RIGHT, -10, 10);
+    ui_bind_attach(UI_BIND_TIME, s_main.time, NULL);
+
+    // 节日，显示在时间下方
+    s_main.festival = lv_label_create(s_main.root);
+    lv_label_set_text(s_main.festival, "");
+    lv_obj_set_style_text_font(s_main.festival, &siyuan_20, 0);
+    lv_obj_set_style_text_color(s_main.festival, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_align_to(s_main.festival, s_main.time, LV_ALIGN_OUT_BOTTOM_RIGHT, 0, 4);
+    ui_bind_attach(UI_BIND_FESTIVAL, s_main.festival, NULL);
+
+    // WLAN 和电池状态
+    s_main.wifi = lv_label_create(s_main.root);
+    lv_label_set_text(s_main.wifi, LV_SYMBOL_WIFI);
+    lv_obj_set_style_text_font(s_main.wifi, &lv_font_montserrat_20, 0);
+    lv_obj_set_style_text_color(s_main.wifi, lv_palette_main(LV_PALETTE_GREY), 0);
+    lv_obj_align(s_main.wifi, LV_ALIGN_TOP_LEFT, 10, 12);
+    ui_bind_attach(UI_BIND_WIFI, s_main.wifi, apply_wifi);
+
+    s_main.battery = lv_label_create(s_main.root);
+    lv_label_set_text(s_main.battery, LV_SYMBOL_BATTERY_EMPTY);
+    lv_obj_set_style_text_font(s_main.battery, &lv_font_montserrat_20, 0);
+    lv_obj_align_to(s_main.battery, s_main.wifi, LV_ALIGN_OUT_RIGHT_MID, 8, 0);
+    ui_bind_attach(UI_BIND_BATTERY, s_main.battery, apply_battery);
+
+    // 天气，显示在状态图标下方
+    s_main.weather = lv_label_create(s_main.root);
+    lv_label_set_text(s_main.weather, "");
+    lv_obj_set_style_text_font(s_main.weather, &siyuan_20, 0);
+    lv_obj_align(s_main.weather, LV_ALIGN_TOP_LEFT, 10, 40);
+    ui_bind_attach(UI_BIND_WEATHER, s_main.weather, NULL);
+
+    // 智能家居设备，显示在天气下方，点击切换开关
+    for(int i = 0; i < HOME_MQTT_DEVICES; i++) {
+        lv_obj_t *label = lv_label_create(s_main.root);
+        lv_label_set_text(label, "");
+        lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
+        lv_obj_set_width(label, 90);
+        lv_obj_set_style_text_font(label, &siyuan_20, 0);
+        lv_obj_align(label, LV_ALIGN_TOP_LEFT, 10, 72 + i * 28);
+        lv_obj_add_flag(label, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(label, device_click_cb, LV_EVENT_CLICKED, (void *)(uintptr_t)i);
+        ui_bind_attach(UI_BIND_DEVICE_0 + i, label, apply_device);
+        s_main.devices[i] = label;
+    }
 }
 
-// 更新主屏幕时间
+static void main_scr_destroy(lv_obj_t *scr)
+{
+    memset(&s_main, 0, sizeof(s_main));
+}
+
+const main_scr_widgets_t *main_scr_widgets(void)
+{
+    return &s_main;
+}
+
+const scr_desc_t main_scr_desc = {
+    .name = "main",
+    .create = main_scr_create,
+    .destroy = main_scr_destroy,
+    .flags = SCR_FLAG_KEEP, // 主屏幕常驻
+};
+
+// 返回主屏幕
+void backToMS(void)
+{
+    scr_mgr_show(SCR_ID_MAIN, LV_SCR_LOAD_ANIM_MOVE_RIGHT);
+}
+
+// 更新主屏幕时间，可在任意任务中调用，下一个刷新周期统一更新
 void update_main_screen_time(const char *time_str)
 {
-    lvgl_port_lock(0);
-    lv_obj_t *time_label = lv_obj_get_child(main_screen, 3); // 根据创建顺序获取时间标签
-    if(time_label && lv_obj_check_type(time_label, &lv_label_class)) {
-        lv_label_set_text(time_label, time_str);
+    ui_bind_set_str(UI_BIND_TIME, time_str);
+}
+
+// WLAN连接状态写入状态栏绑定，在默认事件循环任务中执行，不需要LVGL锁
+static void wifi_status_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    if(id == WIFI_MGR_EVENT_CONNECTED) {
+        const wifi_mgr_conn_t *conn = data;
+        ui_bind_set(UI_BIND_WIFI, wifi_mgr_rssi_bars(conn->rssi), conn->ssid);
+    } else if(id == WIFI_MGR_EVENT_QUALITY) {
+        const wifi_mgr_quality_t *q = data;
+        ui_bind_set_int(UI_BIND_WIFI, q->bars);
+    } else if(id == WIFI_MGR_EVENT_DISCONNECTED || id == WIFI_MGR_EVENT_CONNECT_FAILED) {
+        ui_bind_set_int(UI_BIND_WIFI, 0);
+    }
+}
+
+// 天气写入绑定，在默认事件循环任务中执行
+static void weather_status_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    if(id == WEATHER_EVENT_UPDATED) {
+        const weather_t *w = data;
+        char text[UI_BIND_STR_LEN];
+        // 字库中没有雨、雪、雷，这些天气只显示气温
+        const char *sky = w->sky <= WEATHER_SKY_HAZE ? weather_sky_name(w->sky) : "";
+        snprintf(text, sizeof(text), "%s%s%d℃", sky, sky[0] ? " " : "", (int)lroundf(w->temp_c));
+        ui_bind_set(UI_BIND_WEATHER, w->aqi, text);
+    } else if(id == WEATHER_EVENT_EXPIRED) {
+        ui_bind_set(UI_BIND_WEATHER, -1, "");
+    }
+}
+
+// 设备状态写入对应的绑定，只更新变化的设备，在默认事件循环任务中执行
+static void device_status_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    const home_mqtt_device_t *dev = data;
+    char text[UI_BIND_STR_LEN];
+
+    if(dev->slot >= HOME_MQTT_DEVICES) {
+        return;
     }
-    lvgl_port_unlock();
+    if(dev->name[0] == '\0') {
+        text[0] = '\0';
+    } else if(dev->on >= 0) {
+        snprintf(text, sizeof(text), "%s %s", dev->name, dev->on ? "开" : "关");
+    } else {
+        snprintf(text, sizeof(text), "%s %s", dev->name, dev->state);
+    }
+    ui_bind_set(UI_BIND_DEVICE_0 + dev->slot, dev->on, text);
 }
 
 // 初始化主屏幕
 void mainscr_init(void)
 {
-    // 创建主屏幕
-    create_main_screen();
+    ui_bind_init();
+    ui_perf_attach(NULL);
+    scr_mgr_init(0);
+    scr_mgr_register(SCR_ID_MAIN, &main_scr_desc);
+    scr_mgr_register(SCR_ID_WIFI, &wifi_scr_desc);
+
+    // WLAN事件处理在这里一次注册：此时还没有需要LVGL锁的处理函数，持锁注册不会死锁
+    esp_event_handler_register(WIFI_MGR_EVENT, ESP_EVENT_ANY_ID, wifi_status_cb, NULL);
+    esp_event_handler_register(WEATHER_EVENT, ESP_EVENT_ANY_ID, weather_status_cb, NULL);
+    esp_event_handler_register(HOME_MQTT_EVENT, HOME_MQTT_EVENT_DEVICE, device_status_cb, NULL);
+    wifi_app_events_init();
+
+    // 创建并显示主屏幕，其他屏幕首次进入时再创建
+    scr_mgr_show(SCR_ID_MAIN, LV_SCR_LOAD_ANIM_NONE);
     
     ESP_LOGI(TAG, "Main screen initialized");
 }
\ No newline at end of file
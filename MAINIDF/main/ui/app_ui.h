@@ -2,20 +2,52 @@
 
 void start_wifi_app(void);
 
+// 注册WiFi应用的WLAN事件处理（在mainscr_init中调用一次）
+void wifi_app_events_init(void);
+
 #ifndef MAINSCR_H
 #define MAINSCR_H
 
 #include "lvgl.h"
+#include "scr_mgr.h"
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
-    // 创建主屏幕
-    void create_main_screen(void);
-
-    // 更新主屏幕时间
+    // 屏幕编号
+    enum
+    {
+        SCR_ID_MAIN = 0,
+        SCR_ID_WIFI,
+    };
+
+    // 主屏幕控件，屏幕未创建时均为NULL
+    typedef struct
+    {
+        lv_obj_t *root;
+        lv_obj_t *title;
+        lv_obj_t *logo;         // 资源包中没有 img/logo 时为NULL
+        lv_obj_t *time;
+        lv_obj_t *festival;
+        lv_obj_t *wifi;
+        lv_obj_t *battery;
+        lv_obj_t *weather;
+        lv_obj_t *devices[4];   // 智能家居设备，与 UI_BIND_DEVICE_* 对应
+        lv_obj_t *btn_wifi;
+        lv_obj_t *btn_settings;
+        lv_obj_t *btn_about;
+    } main_scr_widgets_t;
+
+    // 获取主屏幕控件（需持有LVGL锁访问控件）
+    const main_scr_widgets_t *main_scr_widgets(void);
+
+    // 屏幕描述
+    extern const scr_desc_t main_scr_desc;
+    extern const scr_desc_t wifi_scr_desc;
+
+    // 更新主屏幕时间（写入时间绑定，可在任意任务中调用）
     void update_main_screen_time(const char *time_str);
 
     // 初始化主屏幕
@@ -24,6 +56,9 @@ extern "C"
     // 返回主屏幕函数（外部可调用）
     void backToMS(void);
 
+    // 删除WiFi应用屏幕，释放内存
+    void stop_wifi_app(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,15 +1,21 @@
 #include "app_ui.h"
 #include "basic/jlc_lcd.h"
-#include "esp_wifi.h"
-#include "freertos/event_groups.h"
 #include "esp_event.h"
+#include "ui_bind.h"
+#include "ui_perf.h"
+#include "basic/wifi_mgr.h"
+#include "basic/wifi_store.h"
 
 static const char *TAG = "app_wifi_ui";
 
 LV_FONT_DECLARE(font_alipuhui20);
 
 // 全局变量改为静态，避免命名冲突
+static lv_obj_t *wifi_scr = NULL;           // wifi应用屏幕，由屏幕管理器创建和缓存
 static lv_obj_t *wifi_scan_page = NULL;     // wifi扫描页面 obj
+static lv_obj_t *label_wifi_scan = NULL;    // 扫描状态提示label
+static lv_obj_t *spinner_scan = NULL;       // 扫描中动画
+static lv_obj_t *label_scan_btn = NULL;     // 刷新/取消按钮的图标
 static lv_obj_t *wifi_connect_page = NULL;  // wifi连接页面 obj
 static lv_obj_t *wifi_password_page = NULL; // wifi密码页面 obj
 static lv_obj_t *wifi_list = NULL;          // wifi列表  list
@@ -20,31 +26,11 @@ static lv_obj_t *roller_letter_low = NULL;  // 小写字母roller
 static lv_obj_t *roller_letter_up = NULL;   // 大写字母roller
 static lv_obj_t *label_wifi_name = NULL;    // wifi名称label
 
-#define DEFAULT_SCAN_LIST_SIZE   10                // 最大扫描wifi个数
-
-// wifi事件组
-static EventGroupHandle_t s_wifi_event_group = NULL;
-// wifi事件
-#define WIFI_CONNECTED_BIT    BIT0
-#define WIFI_FAIL_BIT         BIT1
-#define WIFI_START_BIT        BIT2
-// wifi最大重连次数
-#define EXAMPLE_ESP_MAXIMUM_RETRY  3
-
-// wifi账号队列
-static QueueHandle_t xQueueWifiAccount = NULL;
-// 队列要传输的内容
-typedef struct {
-    char wifi_ssid[32];  // 获取wifi名称
-    char wifi_password[64]; // 获取wifi密码         
-} wifi_account_t;
-
-// 返回主屏幕函数
-void backToMS(void)
+#define WIFI_LIST_HEIGHT   175     // 列表高度，下方留出按钮栏
+
+// 关闭密码/连接子页面，回到扫描列表（需持有LVGL锁）
+static void close_sub_pages(void)
 {
-    lvgl_port_lock(0);
-    
-    // 清理当前屏幕的所有对象
     if(wifi_password_page) {
         lv_obj_del(wifi_password_page);
         wifi_password_page = NULL;
@@ -52,16 +38,8 @@ void backToMS(void)
     if(wifi_connect_page) {
         lv_obj_del(wifi_connect_page);
         wifi_connect_page = NULL;
+        label_wifi_connect = NULL;
     }
-    if(wifi_scan_page) {
-        lv_obj_del(wifi_scan_page);
-        wifi_scan_page = NULL;
-    }
-    
-    // 返回主屏幕
-    create_main_screen();
-    
-    lvgl_port_unlock();
 }
 
 // 密码roller的遮罩显示效果
@@ -184,7 +162,7 @@ static void lv_wifi_connect(void)
     lv_style_set_width(&style, 320);  
     lv_style_set_height(&style, 240); 
 
-    wifi_connect_page = lv_obj_create(lv_scr_act());
+    wifi_connect_page = lv_obj_create(wifi_scr);
     lv_obj_add_style(wifi_connect_page, &style, 0);
 
     // 绘制label提示
@@ -217,16 +195,10 @@ static void btn_connect_cb(lv_event_t * e)
         const char *wifi_password = lv_textarea_get_text(ta_pass_text);
         if(*wifi_password != '\0') // 判断是否为空字符串
         {
-            wifi_account_t wifi_account;
-            strncpy(wifi_account.wifi_ssid, wifi_ssid, sizeof(wifi_account.wifi_ssid)-1);
-            strncpy(wifi_account.wifi_password, wifi_password, sizeof(wifi_account.wifi_password)-1);
-            ESP_LOGI(TAG, "connected to ap SSID:%s password:%s",
-                    wifi_account.wifi_ssid, wifi_account.wifi_password);
-            lv_wifi_connect(); // 显示wifi连接界面
-            // 发送WiFi账号密码信息到队列
-            if(xQueueWifiAccount) {
-                xQueueSend(xQueueWifiAccount, &wifi_account, portMAX_DELAY); 
-            }
+            ESP_LOGI(TAG, "Connect to SSID:%s", wifi_ssid);
+            // 连接由WLAN管理任务执行，成功后保存到已知网络，结果通过事件返回
+            wifi_mgr_connect(wifi_ssid, wifi_password);
+            lv_wifi_connect(); // 显示wifi连接界面（会删除密码页面）
         }
     }
 }
@@ -273,7 +245,7 @@ static void list_btn_cb(lv_event_t * e)
     lvgl_port_lock(0);
     
     // 创建密码输入页面
-    wifi_password_page = lv_obj_create(lv_scr_act());
+    wifi_password_page = lv_obj_create(wifi_scr);
     lv_obj_set_size(wifi_password_page, 320, 240);
     lv_obj_set_style_border_width(wifi_password_page, 0, 0); // 设置边框宽度
     lv_obj_set_style_pad_all(wifi_password_page, 0, 0);  // 设置间隙
@@ -311,6 +283,12 @@ static void list_btn_cb(lv_event_t * e)
     lv_obj_align(ta_pass_text, LV_ALIGN_TOP_LEFT, 10, 40); // 位置
     lv_obj_add_state(ta_pass_text, LV_STATE_FOCUSED); // 显示光标
 
+    // 如果是已知网络，自动填入保存的密码
+    wifi_store_entry_t known;
+    if(wifi_name && wifi_store_find(wifi_name, &known) == ESP_OK) {
+        lv_textarea_set_text(ta_pass_text, known.password);
+    }
+
     // 创建“连接按钮”
     lv_obj_t *btn_connect = lv_btn_create(wifi_password_page);
     lv_obj_align(btn_connect, LV_ALIGN_TOP_LEFT, 170, 40);
@@ -421,137 +399,79 @@ static void list_btn_cb(lv_event_t * e)
     lvgl_port_unlock();
 }
 
-static void event_handler(void* arg, esp_event_base_t event_base,
-                                int32_t event_id, void* event_data)
+// 刷新/取消按钮：扫描中点击取消，空闲时点击重新扫描
+static void btn_scan_cb(lv_event_t * e)
 {
-    static int s_retry_num = 0;
-
-    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        xEventGroupSetBits(s_wifi_event_group, WIFI_START_BIT);
-    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < EXAMPLE_ESP_MAXIMUM_RETRY) {
-            esp_wifi_connect();
-            s_retry_num++;
-            ESP_LOGI(TAG, "retry to connect to the AP");
+    if(lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        if(wifi_mgr_is_scanning()) {
+            wifi_mgr_scan_cancel();
         } else {
-            xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+            wifi_mgr_scan_start();
         }
-        ESP_LOGI(TAG,"connect to the AP fail");
-    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
-        ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "got ip:" IPSTR, IP2STR(&event->ip_info.ip));
-        s_retry_num = 0;
-        xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
 
-// 扫描附近wifi
-static void wifi_scan(wifi_ap_record_t ap_info[], uint16_t *ap_number)
+// WLAN管理事件，在默认事件循环任务中执行
+static void wifi_mgr_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
 {
-    if(s_wifi_event_group == NULL) {
-        s_wifi_event_group = xEventGroupCreate();
+    lvgl_port_lock(0);
+    if(wifi_list == NULL) { // 屏幕已被删除
+        lvgl_port_unlock();
+        return;
     }
 
-    ESP_ERROR_CHECK(esp_netif_init());
-    ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_t *sta_netif = esp_netif_create_default_wifi_sta();
-    assert(sta_netif);
-
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
-
-    esp_event_handler_instance_t instance_any_id;
-    esp_event_handler_instance_t instance_got_ip;
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
-                                                        ESP_EVENT_ANY_ID,
-                                                        &event_handler,
-                                                        NULL,
-                                                        &instance_any_id));
-    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT,
-                                                        IP_EVENT_STA_GOT_IP,
-                                                        &event_handler,
-                                                        NULL,
-                                                        &instance_got_ip));
-    
-    uint16_t ap_count = 0;
-    
-    memset(ap_info, 0, *ap_number * sizeof(wifi_ap_record_t));
-
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_start());
-    esp_wifi_scan_start(NULL, true);
+    if(id == WIFI_MGR_EVENT_CONNECTED) {
+        if(label_wifi_connect) {
+            lv_label_set_text(label_wifi_connect, "WLAN连接成功");
+        }
+    } else if(id == WIFI_MGR_EVENT_CONNECT_FAILED) {
+        // BACKOFF 后管理任务会自动重试，这里只提示本轮失败
+        if(label_wifi_connect) {
+            lv_label_set_text(label_wifi_connect, "WLAN连接失败");
+        }
+    } else if(id == WIFI_MGR_EVENT_SCAN_START) {
+        lv_obj_clean(wifi_list);
+        lv_label_set_text(label_wifi_scan, "WLAN扫描中...");
+        lv_obj_clear_flag(label_wifi_scan, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(spinner_scan, LV_OBJ_FLAG_HIDDEN);
+        lv_label_set_text(label_scan_btn, LV_SYMBOL_CLOSE);
+        ui_perf_reset();
+    } else if(id == WIFI_MGR_EVENT_SCAN_AP) {
+        const wifi_mgr_ap_t *ap = data;
+        ESP_LOGI(TAG, "SSID %s, RSSI %d, channel %u", ap->ssid, ap->rssi, ap->channel);
+        lv_obj_add_flag(label_wifi_scan, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_t *btn = lv_list_add_btn(wifi_list, LV_SYMBOL_WIFI, ap->ssid);
+        lv_obj_add_event_cb(btn, list_btn_cb, LV_EVENT_CLICKED, NULL); // 添加点击回调函数
+    } else if(id == WIFI_MGR_EVENT_SCAN_DONE) {
+        const wifi_mgr_scan_done_t *done = data;
+        lv_obj_add_flag(spinner_scan, LV_OBJ_FLAG_HIDDEN);
+        lv_label_set_text(label_scan_btn, LV_SYMBOL_REFRESH);
+        if(done->count == 0) {
+            lv_label_set_text(label_wifi_scan, done->cancelled ? "扫描已取消" : "未发现WLAN");
+            lv_obj_clear_flag(label_wifi_scan, LV_OBJ_FLAG_HIDDEN);
+        }
 
-    ESP_LOGI(TAG, "Max AP number ap_info can hold = %u", *ap_number);
-    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_num(&ap_count));  // 获取扫描到的wifi数量
-    ESP_ERROR_CHECK(esp_wifi_scan_get_ap_records(ap_number, ap_info)); // 获取真实的获取到wifi数量和信息
-    ESP_LOGI(TAG, "Total APs scanned = %u, actual AP number ap_info holds = %u", ap_count, *ap_number);
+        ui_perf_stats_t perf;
+        ui_perf_get(&perf);
+        ESP_LOGI(TAG, "During scan (%lu ms): %lu frames, render avg %lu ms max %lu ms, max gap %lu ms, %lu slow",
+                 (unsigned long)done->duration_ms, (unsigned long)perf.frames,
+                 (unsigned long)perf.render_ms_avg, (unsigned long)perf.render_ms_max,
+                 (unsigned long)perf.gap_ms_max, (unsigned long)perf.slow_frames);
+    }
+    lvgl_port_unlock();
 }
 
-// lcd处理任务
-static void wifi_connect(void *arg)
+// 注册WLAN管理事件处理，处理函数常驻不注销
+void wifi_app_events_init(void)
 {
-    wifi_account_t wifi_account;
-
-    while (true)
-    {
-        // 如果收到wifi账号队列消息
-        if(xQueueReceive(xQueueWifiAccount, &wifi_account, portMAX_DELAY))
-        {
-            wifi_config_t wifi_config = {
-                .sta = {
-                    .threshold.authmode = WIFI_AUTH_WPA2_PSK,
-                    .sae_pwe_h2e = WPA3_SAE_PWE_BOTH,
-                    .sae_h2e_identifier = "",
-                    },
-            };
-            strncpy((char *)wifi_config.sta.ssid, wifi_account.wifi_ssid, sizeof(wifi_config.sta.ssid)-1);
-            strncpy((char *)wifi_config.sta.password, wifi_account.wifi_password, sizeof(wifi_config.sta.password)-1);
-            ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config) );
-            ESP_LOGI(TAG, "connected to ap SSID:%s password:%s",
-                 wifi_config.sta.ssid, wifi_config.sta.password);
-            esp_wifi_connect();
-            /* Waiting until either the connection is established (WIFI_CONNECTED_BIT) or connection failed for the maximum
-            * number of re-tries (WIFI_FAIL_BIT). The bits are set by event_handler() (see above) */
-            EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
-            WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
-            pdFALSE,
-            pdFALSE,
-            portMAX_DELAY);
-
-            /* xEventGroupWaitBits() returns the bits before the call returned, hence we can test which event actually
-            * happened. */
-            lvgl_port_lock(0);
-            if (bits & WIFI_CONNECTED_BIT) {
-                ESP_LOGI(TAG, "connected to ap SSID:%s password:%s",
-                        wifi_config.sta.ssid, wifi_config.sta.password);
-                if(label_wifi_connect) {
-                    lv_label_set_text(label_wifi_connect, "WLAN连接成功");
-                }
-            } else if (bits & WIFI_FAIL_BIT) {
-                ESP_LOGI(TAG, "Failed to connect to SSID:%s, password:%s",
-                        wifi_config.sta.ssid, wifi_config.sta.password);
-                if(label_wifi_connect) {
-                    lv_label_set_text(label_wifi_connect, "WLAN连接失败");
-                }
-            } else {
-                ESP_LOGE(TAG, "UNEXPECTED EVENT");
-                if(label_wifi_connect) {
-                    lv_label_set_text(label_wifi_connect, "WLAN连接异常");
-                }
-            }
-            lvgl_port_unlock();
-        }
-    }
+    esp_event_handler_register(WIFI_MGR_EVENT, ESP_EVENT_ANY_ID, wifi_mgr_event_cb, NULL);
 }
 
-// 启动WiFi应用
-void start_wifi_app(void)
+// 创建WiFi应用屏幕（由屏幕管理器在持锁时调用）
+static void wifi_scr_create(lv_obj_t *scr)
 {
-    lvgl_port_lock(0);
-    
-    // 清理当前屏幕
-    lv_obj_clean(lv_scr_act());
-    
+    wifi_scr = scr;
+
     // 创建WLAN扫描页面
     static lv_style_t style;
     lv_style_init(&style);
@@ -562,14 +482,27 @@ void start_wifi_app(void)
     lv_style_set_width(&style, 320);  // 宽
     lv_style_set_height(&style, 240); // 高
     
-    wifi_scan_page = lv_obj_create(lv_scr_act());  
+    wifi_scan_page = lv_obj_create(scr);  
     lv_obj_add_style(wifi_scan_page, &style, 0);
+
+    // 创建wifi信息列表，扫描结果逐条加入
+    wifi_list = lv_list_create(wifi_scan_page);
+    lv_obj_set_size(wifi_list, lv_pct(100), WIFI_LIST_HEIGHT);
+    lv_obj_align(wifi_list, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_set_style_border_width(wifi_list, 0, 0);
+    lv_obj_set_style_text_font(wifi_list, &siyuan_20, 0);
+    lv_obj_set_scrollbar_mode(wifi_list, LV_SCROLLBAR_MODE_OFF); // 隐藏wifi_list滚动条
     
     // 在WLAN扫描页面显示提示
-    lv_obj_t *label_wifi_scan = lv_label_create(wifi_scan_page);
+    label_wifi_scan = lv_label_create(wifi_scan_page);
     lv_label_set_text(label_wifi_scan, "WLAN扫描中...");
     lv_obj_set_style_text_font(label_wifi_scan, &siyuan_20, 0);
     lv_obj_align(label_wifi_scan, LV_ALIGN_CENTER, 0, -50);
+
+    // 扫描中动画
+    spinner_scan = lv_spinner_create(wifi_scan_page, 1000, 60);
+    lv_obj_set_size(spinner_scan, 36, 36);
+    lv_obj_align(spinner_scan, LV_ALIGN_BOTTOM_LEFT, 20, -22);
     
     // 添加返回主屏幕按钮
     lv_obj_t *btn_back = lv_btn_create(wifi_scan_page);
@@ -580,58 +513,80 @@ void start_wifi_app(void)
     lv_obj_t *label_back = lv_label_create(btn_back);
     lv_label_set_text(label_back, "返回主屏");
     lv_obj_center(label_back);
-    
-    lvgl_port_unlock();
 
-    // 扫描WLAN信息
-    wifi_ap_record_t ap_info[DEFAULT_SCAN_LIST_SIZE];  // 记录扫描到的wifi信息
-    uint16_t ap_number = DEFAULT_SCAN_LIST_SIZE; 
-    wifi_scan(ap_info, &ap_number); // 扫描附近wifi
+    // 刷新/取消扫描按钮
+    lv_obj_t *btn_scan = lv_btn_create(wifi_scan_page);
+    lv_obj_set_size(btn_scan, 60, 40);
+    lv_obj_align(btn_scan, LV_ALIGN_BOTTOM_RIGHT, -10, -20);
+    lv_obj_add_event_cb(btn_scan, btn_scan_cb, LV_EVENT_CLICKED, NULL);
 
-    lvgl_port_lock(0);
-    // 扫描附近wifi信息成功后 删除提示文字
-    lv_obj_del(label_wifi_scan); 
-    // 创建wifi信息列表
-    wifi_list = lv_list_create(wifi_scan_page);
-    lv_obj_set_size(wifi_list, lv_pct(100), lv_pct(100));
-    lv_obj_set_style_border_width(wifi_list, 0, 0);
-    lv_obj_set_style_text_font(wifi_list, &siyuan_20, 0);
-    lv_obj_set_scrollbar_mode(wifi_list, LV_SCROLLBAR_MODE_OFF); // 隐藏wifi_list滚动条
-    // 显示wifi信息
-    lv_obj_t * btn;
-    for (int i = 0; i < ap_number; i++) {
-        ESP_LOGI(TAG, "SSID \t\t%s", ap_info[i].ssid);  // 终端输出wifi名称
-        ESP_LOGI(TAG, "RSSI \t\t%d", ap_info[i].rssi);  // 终端输出wifi信号质量
-        // 添加wifi列表
-        btn = lv_list_add_btn(wifi_list, LV_SYMBOL_WIFI, (const char *)ap_info[i].ssid); 
-        lv_obj_add_event_cb(btn, list_btn_cb, LV_EVENT_CLICKED, NULL); // 添加点击回调函数
+    label_scan_btn = lv_label_create(btn_scan);
+    lv_label_set_text(label_scan_btn, LV_SYMBOL_REFRESH);
+    lv_obj_set_style_text_font(label_scan_btn, &lv_font_montserrat_20, 0);
+    lv_obj_center(label_scan_btn);
+}
+
+// 重新进入时回到扫描列表，不保留上次的密码/连接页面
+static void wifi_scr_show(lv_obj_t *scr)
+{
+    close_sub_pages();
+}
+
+// 离开时取消未完成的扫描
+static void wifi_scr_hide(lv_obj_t *scr)
+{
+    if(wifi_mgr_is_scanning()) {
+        wifi_mgr_scan_cancel();
     }
-    lvgl_port_unlock();
-    
-    // 创建wifi连接任务
-    if(xQueueWifiAccount == NULL) {
-        xQueueWifiAccount = xQueueCreate(2, sizeof(wifi_account_t));
-        xTaskCreatePinnedToCore(wifi_connect, "wifi_connect", 4 * 1024, NULL, 5, NULL, 1);  // 创建wifi连接任务
+}
+
+// 屏幕被删除，清理保存的控件指针
+static void wifi_scr_destroy(lv_obj_t *scr)
+{
+    wifi_scr = NULL;
+    wifi_scan_page = NULL;
+    label_wifi_scan = NULL;
+    spinner_scan = NULL;
+    label_scan_btn = NULL;
+    wifi_list = NULL;
+    wifi_password_page = NULL;
+    wifi_connect_page = NULL;
+    label_wifi_connect = NULL;
+    ta_pass_text = NULL;
+    roller_num = NULL;
+    roller_letter_low = NULL;
+    roller_letter_up = NULL;
+    label_wifi_name = NULL;
+}
+
+const scr_desc_t wifi_scr_desc = {
+    .name = "wifi",
+    .create = wifi_scr_create,
+    .show = wifi_scr_show,
+    .hide = wifi_scr_hide,
+    .destroy = wifi_scr_destroy,
+};
+
+// 启动WiFi应用：切换屏幕后在后台扫描，结果通过事件逐条加入列表
+void start_wifi_app(void)
+{
+    scr_mgr_show(SCR_ID_WIFI, LV_SCR_LOAD_ANIM_MOVE_LEFT);
+
+    if(!wifi_mgr_is_ready()) {
+        // WLAN 在首帧之后的延后启动阶段初始化，刚开机时可能还没有完成
+        lvgl_port_lock(0);
+        if(label_wifi_scan) {
+            lv_label_set_text(label_wifi_scan, "WLAN未就绪");
+            lv_obj_add_flag(spinner_scan, LV_OBJ_FLAG_HIDDEN);
+        }
+        lvgl_port_unlock();
+        return;
     }
+    wifi_mgr_scan_start();
 }
 
-// 停止WiFi应用，清理资源
+// 停止WiFi应用，删除屏幕释放内存
 void stop_wifi_app(void)
 {
-    lvgl_port_lock(0);
-    
-    if(wifi_password_page) {
-        lv_obj_del(wifi_password_page);
-        wifi_password_page = NULL;
-    }
-    if(wifi_connect_page) {
-        lv_obj_del(wifi_connect_page);
-        wifi_connect_page = NULL;
-    }
-    if(wifi_scan_page) {
-        lv_obj_del(wifi_scan_page);
-        wifi_scan_page = NULL;
-    }
-    
-    lvgl_port_unlock();
-}
\ No newline at end of file
+    scr_mgr_drop(SCR_ID_WIFI);
+}
@@ -0,0 +1,244 @@
+/**
+ * @file scr_mgr.c
+ * @brief 屏幕管理实现
+ *
+ * LV_MEM_CUSTOM=y 时 LVGL 直接使用系统堆，lv_mem_monitor 没有数据，
+ * 因此屏幕占用按创建前后系统堆剩余量的差值估算。创建在 LVGL 锁内完成，
+ * 其他任务同时分配内存会带来少量误差，只用于淘汰决策和统计。
+ */
+
+#include "scr_mgr.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_lvgl_port.h"
+
+static const char *TAG = "scr_mgr";
+
+typedef struct {
+    const scr_desc_t *desc;
+    lv_obj_t *scr;
+    size_t cost;            // 创建时估算的占用
+    uint32_t last_used;     // 最近一次进入前台的序号，用于LRU
+} scr_slot_t;
+
+static scr_slot_t s_slots[SCR_MGR_MAX_SCREENS];
+static size_t s_budget = SCR_MGR_DEFAULT_BUDGET;
+static int s_current = -1;
+static uint32_t s_use_seq = 0;
+static lv_obj_t *s_boot_scr = NULL;     // LVGL 注册显示时创建的默认屏幕，首次切换后删除
+static scr_mgr_stats_t s_stats;
+
+static bool slot_valid(int id)
+{
+    return id >= 0 && id < SCR_MGR_MAX_SCREENS && s_slots[id].desc != NULL;
+}
+
+// 屏幕正在前台或正在参与切换动画时不能删除
+static bool slot_busy(int id)
+{
+    lv_disp_t *disp = lv_disp_get_default();
+    lv_obj_t *scr = s_slots[id].scr;
+
+    if(id == s_current || scr == lv_scr_act()) {
+        return true;
+    }
+    return disp && (scr == disp->prev_scr || scr == disp->scr_to_load);
+}
+
+static void slot_destroy(int id)
+{
+    scr_slot_t *slot = &s_slots[id];
+
+    if(slot->desc->destroy) {
+        slot->desc->destroy(slot->scr);
+    }
+    lv_obj_del(slot->scr);
+    slot->scr = NULL;
+    s_stats.cached_bytes -= slot->cost;
+    slot->cost = 0;
+}
+
+static esp_err_t slot_create(int id)
+{
+    scr_slot_t *slot = &s_slots[id];
+    size_t before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    slot->scr = lv_obj_create(NULL);
+    if(slot->scr == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    slot->desc->create(slot->scr);
+
+    size_t after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    slot->cost = before > after ? before - after : 0;
+    s_stats.cached_bytes += slot->cost;
+    if(s_stats.cached_bytes > s_stats.peak_cached_bytes) {
+        s_stats.peak_cached_bytes = s_stats.cached_bytes;
+    }
+    s_stats.creates++;
+    ESP_LOGI(TAG, "Created '%s' (%u bytes)", slot->desc->name, (unsigned)slot->cost);
+    return ESP_OK;
+}
+
+// 超出预算时按LRU销毁后台屏幕
+static void evict_over_budget(void)
+{
+    while(s_stats.cached_bytes > s_budget) {
+        int victim = -1;
+        for(int i = 0; i < SCR_MGR_MAX_SCREENS; i++) {
+            scr_slot_t *slot = &s_slots[i];
+            if(slot->scr == NULL || (slot->desc->flags & SCR_FLAG_KEEP) || slot_busy(i)) {
+                continue;
+            }
+            if(victim < 0 || slot->last_used < s_slots[victim].last_used) {
+                victim = i;
+            }
+        }
+        if(victim < 0) {
+            break; // 剩下的都不能淘汰
+        }
+        ESP_LOGI(TAG, "Evict '%s' (%u bytes, cached %u / budget %u)", s_slots[victim].desc->name,
+                 (unsigned)s_slots[victim].cost, (unsigned)s_stats.cached_bytes, (unsigned)s_budget);
+        slot_destroy(victim);
+        s_stats.evictions++;
+    }
+}
+
+esp_err_t scr_mgr_init(size_t budget)
+{
+    lvgl_port_lock(0);
+    s_budget = budget ? budget : SCR_MGR_DEFAULT_BUDGET;
+    s_boot_scr = lv_scr_act();
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+esp_err_t scr_mgr_register(int id, const scr_desc_t *desc)
+{
+    if(id < 0 || id >= SCR_MGR_MAX_SCREENS || desc == NULL || desc->create == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(s_slots[id].desc != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_slots[id].desc = desc;
+    return ESP_OK;
+}
+
+esp_err_t scr_mgr_show(int id, lv_scr_load_anim_t anim)
+{
+    if(!slot_valid(id)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    lvgl_port_lock(0);
+    if(id == s_current) {
+        lvgl_port_unlock();
+        return ESP_OK;
+    }
+
+    int64_t start = esp_timer_get_time();
+    scr_slot_t *slot = &s_slots[id];
+    bool cold = slot->scr == NULL;
+
+    if(cold) {
+        esp_err_t ret = slot_create(id);
+        if(ret != ESP_OK) {
+            lvgl_port_unlock();
+            ESP_LOGE(TAG, "Create '%s' failed", slot->desc->name);
+            return ret;
+        }
+    }
+
+    if(s_current >= 0 && s_slots[s_current].desc->hide) {
+        s_slots[s_current].desc->hide(s_slots[s_current].scr);
+    }
+    if(slot->desc->show) {
+        slot->desc->show(slot->scr);
+    }
+
+    // 首次切换时删除LVGL的默认屏幕，其余屏幕由管理器保留
+    bool del_prev = s_boot_scr != NULL && lv_scr_act() == s_boot_scr;
+    uint32_t time = anim == LV_SCR_LOAD_ANIM_NONE ? 0 : SCR_MGR_ANIM_TIME_MS;
+    lv_scr_load_anim(slot->scr, anim, time, 0, del_prev);
+    if(del_prev) {
+        s_boot_scr = NULL;
+    }
+
+    s_current = id;
+    slot->last_used = ++s_use_seq;
+    evict_over_budget();
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+    s_stats.switches++;
+    s_stats.last_switch_us = us;
+    if(cold && us > s_stats.max_cold_us) {
+        s_stats.max_cold_us = us;
+    } else if(!cold && us > s_stats.max_warm_us) {
+        s_stats.max_warm_us = us;
+    }
+    lvgl_port_unlock();
+
+    ESP_LOGI(TAG, "Show '%s' (%s) in %lu us", slot->desc->name, cold ? "cold" : "cached", (unsigned long)us);
+    return ESP_OK;
+}
+
+lv_obj_t *scr_mgr_get(int id)
+{
+    return slot_valid(id) ? s_slots[id].scr : NULL;
+}
+
+int scr_mgr_current(void)
+{
+    return s_current;
+}
+
+esp_err_t scr_mgr_drop(int id)
+{
+    if(!slot_valid(id)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    lvgl_port_lock(0);
+    if(s_slots[id].scr == NULL) {
+        // 没有创建过
+    } else if(slot_busy(id)) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        slot_destroy(id);
+    }
+    lvgl_port_unlock();
+    return ret;
+}
+
+void scr_mgr_get_stats(scr_mgr_stats_t *stats)
+{
+    lvgl_port_lock(0);
+    *stats = s_stats;
+    lvgl_port_unlock();
+    stats->heap_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+}
+
+void scr_mgr_report(void)
+{
+    scr_mgr_stats_t st;
+    scr_mgr_get_stats(&st);
+
+    ESP_LOGI(TAG, "switches %lu, creates %lu, evictions %lu",
+             (unsigned long)st.switches, (unsigned long)st.creates, (unsigned long)st.evictions);
+    ESP_LOGI(TAG, "switch time: last %lu us, max cold %lu us, max cached %lu us",
+             (unsigned long)st.last_switch_us, (unsigned long)st.max_cold_us, (unsigned long)st.max_warm_us);
+    ESP_LOGI(TAG, "cached %u bytes (peak %u, budget %u), heap min free %u",
+             (unsigned)st.cached_bytes, (unsigned)st.peak_cached_bytes, (unsigned)s_budget,
+             (unsigned)st.heap_min_free);
+    for(int i = 0; i < SCR_MGR_MAX_SCREENS; i++) {
+        if(s_slots[i].desc) {
+            ESP_LOGI(TAG, "  [%d] %-10s %s %6u bytes", i, s_slots[i].desc->name,
+                     s_slots[i].scr ? (i == s_current ? "active" : "cached") : "-     ",
+                     (unsigned)s_slots[i].cost);
+        }
+    }
+}
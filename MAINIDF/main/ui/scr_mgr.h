@@ -0,0 +1,101 @@
+/**
+ * @file scr_mgr.h
+ * @brief 屏幕管理
+ *
+ * 每个应用界面是一个独立的 LVGL screen（lv_obj_create(NULL)），首次进入时才创建，
+ * 离开后保留在内存中，再次进入直接用 lv_scr_load_anim 切换，不再清空重建。
+ * 缓存的屏幕总占用超过预算时，按最近最少使用的顺序销毁不在前台的屏幕。
+ *
+ * 所有接口内部会获取 lvgl_port_lock（可重入），可以在 LVGL 回调或其他任务中调用。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#define SCR_MGR_MAX_SCREENS     8
+#define SCR_MGR_DEFAULT_BUDGET  (96 * 1024)  // 缓存屏幕的默认内存预算（字节）
+#define SCR_MGR_ANIM_TIME_MS    200
+
+/* 屏幕标志 */
+#define SCR_FLAG_KEEP   0x01    // 常驻，不参与淘汰
+
+/** 屏幕描述，须为静态存储 */
+typedef struct {
+    const char *name;
+    void (*create)(lv_obj_t *scr);  // 在 scr 上创建控件，必需
+    void (*show)(lv_obj_t *scr);    // 切到前台前调用，用于刷新数据，可为NULL
+    void (*hide)(lv_obj_t *scr);    // 离开前台时调用，可为NULL
+    void (*destroy)(lv_obj_t *scr); // 屏幕被删除前调用，清理保存的控件指针，可为NULL
+    uint8_t flags;                  // SCR_FLAG_*
+} scr_desc_t;
+
+/** 统计信息 */
+typedef struct {
+    uint32_t switches;          // 切换次数
+    uint32_t creates;           // 创建次数（含淘汰后重建）
+    uint32_t evictions;         // 因超出预算被销毁的次数
+    uint32_t last_switch_us;    // 最近一次切换耗时（含创建）
+    uint32_t max_cold_us;       // 需要创建屏幕时的最长切换耗时
+    uint32_t max_warm_us;       // 复用缓存屏幕时的最长切换耗时
+    size_t cached_bytes;        // 当前缓存屏幕的估计占用
+    size_t peak_cached_bytes;   // 缓存占用峰值
+    size_t heap_min_free;       // 堆历史最低剩余（LVGL 使用系统堆）
+} scr_mgr_stats_t;
+
+/**
+ * 初始化屏幕管理
+ * @param budget 缓存屏幕的内存预算（字节），0 使用默认值
+ * @return esp_err_t 操作结果
+ */
+esp_err_t scr_mgr_init(size_t budget);
+
+/**
+ * 注册屏幕
+ * @param id 屏幕编号，0 ~ SCR_MGR_MAX_SCREENS-1
+ * @param desc 屏幕描述
+ * @return esp_err_t 操作结果
+ */
+esp_err_t scr_mgr_register(int id, const scr_desc_t *desc);
+
+/**
+ * 切换到指定屏幕，不存在时先创建
+ * @param id 屏幕编号
+ * @param anim 切换动画，LV_SCR_LOAD_ANIM_NONE 为立即切换
+ * @return esp_err_t 操作结果
+ */
+esp_err_t scr_mgr_show(int id, lv_scr_load_anim_t anim);
+
+/**
+ * 获取屏幕对象
+ * @param id 屏幕编号
+ * @return lv_obj_t* 未创建时返回NULL
+ */
+lv_obj_t *scr_mgr_get(int id);
+
+/**
+ * 获取当前前台屏幕编号
+ * @return int 没有时返回 -1
+ */
+int scr_mgr_current(void);
+
+/**
+ * 删除屏幕（不能是前台屏幕），下次进入时重新创建
+ * @param id 屏幕编号
+ * @return esp_err_t 操作结果
+ */
+esp_err_t scr_mgr_drop(int id);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void scr_mgr_get_stats(scr_mgr_stats_t *stats);
+
+/**
+ * 输出各屏幕占用和切换耗时到日志
+ */
+void scr_mgr_report(void);
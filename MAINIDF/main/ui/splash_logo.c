@@ -0,0 +1,244 @@
+/* 由 tools/img2splash.py 从 splash_logo.ppm 生成，请勿手动修改 */
+#include "splash.h"
+
+static const uint8_t splash_logo_data[3705] = {
+    0xff, 0x10, 0xc4, 0xff, 0x10, 0xc4, 0xcb, 0x10, 0xc4, 0x07, 0x19, 0x25, 0x21, 0x46, 0x29, 0x86,
+    0x29, 0x87, 0x29, 0x87, 0x29, 0x86, 0x21, 0x46, 0x19, 0x25, 0xd1, 0x10, 0xc4, 0x13, 0x29, 0x86,
+    0x3a, 0x29, 0x63, 0x2d, 0x84, 0x51, 0xa5, 0x35, 0xbd, 0xd7, 0xc6, 0x38, 0xce, 0x79, 0xd6, 0x9a,
+    0xd6, 0xba, 0xd6, 0xba, 0xd6, 0x9a, 0xce, 0x79, 0xc6, 0x38, 0xbd, 0xd7, 0xa5, 0x35, 0x84, 0x51,
+    0x63, 0x2d, 0x3a, 0x29, 0x29, 0x86, 0xc7, 0x10, 0xc4, 0x05, 0x21, 0x45, 0x42, 0x49, 0x7b, 0xf0,
+    0xb5, 0x96, 0xce, 0x9a, 0xe7, 0x3c, 0x8f, 0xf7, 0x9e, 0x05, 0xe7, 0x3c, 0xce, 0x9a, 0xb5, 0x96,
+    0x7b, 0xf0, 0x42, 0x49, 0x21, 0x45, 0xc0, 0x10, 0xc4, 0x04, 0x19, 0x05, 0x42, 0x4a, 0x8c, 0x72,
+    0xc6, 0x39, 0xe7, 0x3c, 0x97, 0xf7, 0x9e, 0x04, 0xe7, 0x3c, 0xc6, 0x39, 0x8c, 0x72, 0x42, 0x4a,
+    0x19, 0x05, 0xbb, 0x10, 0xc4, 0x03, 0x21, 0x66, 0x63, 0x4d, 0xb5, 0xd7, 0xe7, 0x3c, 0x9d, 0xf7,
+    0x9e, 0x03, 0xe7, 0x3c, 0xb5, 0xd7, 0x63, 0x4d, 0x21, 0x66, 0xb7, 0x10, 0xc4, 0x03, 0x29, 0x86,
+    0x73, 0xcf, 0xce, 0x59, 0xef, 0x7d, 0xa1, 0xf7, 0x9e, 0x03, 0xef, 0x7d, 0xce, 0x59, 0x73, 0xcf,
+    0x29, 0x86, 0xb3, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x6b, 0x6e, 0xce, 0x59, 0x8e, 0xf7, 0x9e, 0x09,
+    0xef, 0x7d, 0xe7, 0x3c, 0xde, 0xfb, 0xd6, 0xdb, 0xd6, 0xba, 0xd6, 0xba, 0xd6, 0xdb, 0xde, 0xfb,
+    0xe7, 0x3c, 0xef, 0x7d, 0x8e, 0xf7, 0x9e, 0x02, 0xce, 0x59, 0x6b, 0x6e, 0x19, 0x25, 0xb0, 0x10,
+    0xc4, 0x02, 0x4a, 0x8b, 0xb5, 0xd7, 0xef, 0x7d, 0x8a, 0xf7, 0x9e, 0x13, 0xef, 0x5d, 0xce, 0x9a,
+    0xb5, 0xb7, 0x8c, 0x92, 0x6b, 0x6e, 0x4a, 0x8b, 0x3a, 0x29, 0x31, 0xe8, 0x29, 0xa7, 0x29, 0x87,
+    0x29, 0x87, 0x29, 0xa7, 0x31, 0xe8, 0x3a, 0x29, 0x4a, 0x8b, 0x6b, 0x6e, 0x8c, 0x92, 0xb5, 0xb7,
+    0xce, 0x9a, 0xef, 0x5d, 0x8a, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0xb5, 0xd7, 0x4a, 0x8b, 0xad, 0x10,
+    0xc4, 0x02, 0x21, 0x46, 0x8c, 0x72, 0xe7, 0x1c, 0x89, 0xf7, 0x9e, 0x04, 0xde, 0xfc, 0xbd, 0xd7,
+    0x7c, 0x10, 0x42, 0x6a, 0x29, 0x86, 0x8f, 0x10, 0xc4, 0x04, 0x29, 0x86, 0x42, 0x6a, 0x7c, 0x10,
+    0xbd, 0xd7, 0xde, 0xfc, 0x89, 0xf7, 0x9e, 0x02, 0xe7, 0x1c, 0x8c, 0x72, 0x21, 0x46, 0xaa, 0x10,
+    0xc4, 0x01, 0x42, 0x4a, 0xbd, 0xd7, 0x88, 0xf7, 0x9e, 0x04, 0xef, 0x5d, 0xc6, 0x38, 0x7c, 0x10,
+    0x3a, 0x08, 0x10, 0xe4, 0x95, 0x10, 0xc4, 0x04, 0x10, 0xe4, 0x3a, 0x08, 0x7c, 0x10, 0xc6, 0x38,
+    0xef, 0x5d, 0x88, 0xf7, 0x9e, 0x01, 0xbd, 0xd7, 0x42, 0x4a, 0xa7, 0x10, 0xc4, 0x02, 0x10, 0xe4,
+    0x63, 0x4d, 0xde, 0xdb, 0x87, 0xf7, 0x9e, 0x03, 0xef, 0x5d, 0xb5, 0xb6, 0x5a, 0xec, 0x21, 0x46,
+    0x9b, 0x10, 0xc4, 0x03, 0x21, 0x46, 0x5a, 0xec, 0xb5, 0xb6, 0xef, 0x5d, 0x87, 0xf7, 0x9e, 0x02,
+    0xde, 0xdb, 0x63, 0x4d, 0x10, 0xe4, 0xa4, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x84, 0x51, 0xe7, 0x3c,
+    0x86, 0xf7, 0x9e, 0x03, 0xef, 0x7d, 0xb5, 0xd7, 0x52, 0xcc, 0x19, 0x05, 0x9f, 0x10, 0xc4, 0x03,
+    0x19, 0x05, 0x52, 0xcc, 0xb5, 0xd7, 0xef, 0x7d, 0x86, 0xf7, 0x9e, 0x02, 0xe7, 0x3c, 0x84, 0x51,
+    0x19, 0x25, 0xa2, 0x10, 0xc4, 0x02, 0x21, 0x25, 0x9c, 0xd3, 0xef, 0x7d, 0x86, 0xf7, 0x9e, 0x02,
+    0xd6, 0x9a, 0x6b, 0x6e, 0x19, 0x25, 0xa3, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x6b, 0x6e, 0xd6, 0x9a,
+    0x86, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0x9c, 0xd3, 0x21, 0x25, 0xa0, 0x10, 0xc4, 0x02, 0x21, 0x46,
+    0xa5, 0x34, 0xef, 0x7d, 0x85, 0xf7, 0x9e, 0x02, 0xef, 0x5d, 0x9d, 0x14, 0x31, 0xc7, 0xa7, 0x10,
+    0xc4, 0x02, 0x31, 0xc7, 0x9d, 0x14, 0xef, 0x5d, 0x85, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0xa5, 0x34,
+    0x21, 0x46, 0x9e, 0x10, 0xc4, 0x01, 0x21, 0x25, 0xa5, 0x34, 0x86, 0xf7, 0x9e, 0x02, 0xde, 0xdb,
+    0x6b, 0x6e, 0x19, 0x05, 0xa9, 0x10, 0xc4, 0x02, 0x19, 0x05, 0x6b, 0x6e, 0xde, 0xdb, 0x86, 0xf7,
+    0x9e, 0x01, 0xa5, 0x34, 0x21, 0x25, 0x9c, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x9c, 0xd3, 0xef, 0x7d,
+    0x85, 0xf7, 0x9e, 0x01, 0xc6, 0x38, 0x4a, 0x6a, 0x95, 0x10, 0xc4, 0x01, 0x11, 0x26, 0x11, 0x26,
+    0x95, 0x10, 0xc4, 0x01, 0x4a, 0x6a, 0xc6, 0x38, 0x85, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0x9c, 0xd3,
+    0x19, 0x25, 0x9a, 0x10, 0xc4, 0x02, 0x10, 0xe4, 0x84, 0x51, 0xef, 0x7d, 0x85, 0xf7, 0x9e, 0x01,
+    0xb5, 0x96, 0x31, 0xc7, 0x94, 0x10, 0xc4, 0x05, 0x11, 0x06, 0x23, 0x32, 0x2c, 0x5a, 0x2c, 0x5a,
+    0x23, 0x32, 0x11, 0x06, 0x94, 0x10, 0xc4, 0x01, 0x31, 0xc7, 0xb5, 0x96, 0x85, 0xf7, 0x9e, 0x02,
+    0xef, 0x7d, 0x84, 0x51, 0x10, 0xe4, 0x99, 0x10, 0xc4, 0x01, 0x63, 0x4d, 0xe7, 0x3c, 0x85, 0xf7,
+    0x9e, 0x01, 0xad, 0x55, 0x21, 0x66, 0x95, 0x10, 0xc4, 0x00, 0x23, 0x32, 0x83, 0x35, 0x1e, 0x00,
+    0x23, 0x32, 0x95, 0x10, 0xc4, 0x01, 0x21, 0x66, 0xad, 0x55, 0x85, 0xf7, 0x9e, 0x01, 0xe7, 0x3c,
+    0x63, 0x4d, 0x98, 0x10, 0xc4, 0x01, 0x42, 0x4a, 0xde, 0xdb, 0x85, 0xf7, 0x9e, 0x01, 0xad, 0x55,
+    0x21, 0x46, 0x95, 0x10, 0xc4, 0x01, 0x11, 0x26, 0x2c, 0x5a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x5a,
+    0x11, 0x26, 0x95, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xad, 0x55, 0x85, 0xf7, 0x9e, 0x01, 0xde, 0xdb,
+    0x42, 0x4a, 0x96, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xbd, 0xd7, 0x85, 0xf7, 0x9e, 0x01, 0xb5, 0x96,
+    0x21, 0x66, 0x96, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a,
+    0x11, 0x47, 0x96, 0x10, 0xc4, 0x01, 0x21, 0x66, 0xb5, 0x96, 0x85, 0xf7, 0x9e, 0x01, 0xbd, 0xd7,
+    0x21, 0x46, 0x95, 0x10, 0xc4, 0x00, 0x8c, 0x72, 0x85, 0xf7, 0x9e, 0x01, 0xc6, 0x38, 0x31, 0xc7,
+    0x97, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47,
+    0x97, 0x10, 0xc4, 0x01, 0x31, 0xc7, 0xc6, 0x38, 0x85, 0xf7, 0x9e, 0x00, 0x8c, 0x72, 0x94, 0x10,
+    0xc4, 0x01, 0x4a, 0x8b, 0xe7, 0x1c, 0x84, 0xf7, 0x9e, 0x01, 0xde, 0xdb, 0x4a, 0x6a, 0x98, 0x10,
+    0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x98, 0x10,
+    0xc4, 0x01, 0x4a, 0x6a, 0xde, 0xdb, 0x84, 0xf7, 0x9e, 0x01, 0xe7, 0x1c, 0x4a, 0x8b, 0x92, 0x10,
+    0xc4, 0x01, 0x19, 0x25, 0xb5, 0xd7, 0x84, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x6b, 0x6e, 0x99, 0x10,
+    0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x99, 0x10,
+    0xc4, 0x01, 0x6b, 0x6e, 0xef, 0x5d, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xd7, 0x19, 0x25, 0x91, 0x10,
+    0xc4, 0x01, 0x6b, 0x6e, 0xef, 0x7d, 0x84, 0xf7, 0x9e, 0x01, 0x9d, 0x14, 0x19, 0x05, 0x99, 0x10,
+    0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x99, 0x10,
+    0xc4, 0x01, 0x19, 0x05, 0x9d, 0x14, 0x84, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x6b, 0x6e, 0x90, 0x10,
+    0xc4, 0x01, 0x29, 0x86, 0xce, 0x59, 0x84, 0xf7, 0x9e, 0x01, 0xd6, 0x9a, 0x31, 0xc7, 0x9a, 0x10,
+    0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9a, 0x10,
+    0xc4, 0x01, 0x31, 0xc7, 0xd6, 0x9a, 0x84, 0xf7, 0x9e, 0x01, 0xce, 0x59, 0x29, 0x86, 0x8f, 0x10,
+    0xc4, 0x00, 0x73, 0xcf, 0x84, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x6b, 0x6e, 0x9b, 0x10, 0xc4, 0x01,
+    0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9b, 0x10, 0xc4, 0x01,
+    0x6b, 0x6e, 0xef, 0x7d, 0x84, 0xf7, 0x9e, 0x00, 0x73, 0xcf, 0x8e, 0x10, 0xc4, 0x01, 0x21, 0x66,
+    0xce, 0x59, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xd7, 0x19, 0x25, 0x9b, 0x10, 0xc4, 0x01, 0x11, 0x47,
+    0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9b, 0x10, 0xc4, 0x01, 0x19, 0x25,
+    0xb5, 0xd7, 0x84, 0xf7, 0x9e, 0x01, 0xce, 0x59, 0x21, 0x66, 0x8d, 0x10, 0xc4, 0x01, 0x63, 0x4d,
+    0xef, 0x7d, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x52, 0xcc, 0x9c, 0x10, 0xc4, 0x01, 0x11, 0x47,
+    0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9c, 0x10, 0xc4, 0x01, 0x52, 0xcc,
+    0xef, 0x5d, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x63, 0x4d, 0x8c, 0x10, 0xc4, 0x01, 0x19, 0x05,
+    0xb5, 0xd7, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xb6, 0x19, 0x05, 0x9c, 0x10, 0xc4, 0x01, 0x11, 0x47,
+    0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9c, 0x10, 0xc4, 0x01, 0x19, 0x05,
+    0xb5, 0xb6, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xd7, 0x19, 0x05, 0x8b, 0x10, 0xc4, 0x01, 0x42, 0x4a,
+    0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x5a, 0xec, 0x9d, 0x10, 0xc4, 0x01, 0x11, 0x47,
+    0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9d, 0x10, 0xc4, 0x01, 0x5a, 0xec,
+    0xef, 0x5d, 0x83, 0xf7, 0x9e, 0x01, 0xe7, 0x3c, 0x42, 0x4a, 0x8b, 0x10, 0xc4, 0x00, 0x8c, 0x72,
+    0x84, 0xf7, 0x9e, 0x01, 0xc6, 0x38, 0x21, 0x46, 0x9d, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a,
+    0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9d, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xc6, 0x38,
+    0x84, 0xf7, 0x9e, 0x00, 0x8c, 0x72, 0x8a, 0x10, 0xc4, 0x01, 0x21, 0x45, 0xc6, 0x39, 0x84, 0xf7,
+    0x9e, 0x00, 0x7c, 0x10, 0x9e, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01,
+    0x2c, 0x7a, 0x11, 0x47, 0x9e, 0x10, 0xc4, 0x00, 0x7c, 0x10, 0x84, 0xf7, 0x9e, 0x01, 0xc6, 0x39,
+    0x21, 0x45, 0x89, 0x10, 0xc4, 0x01, 0x42, 0x49, 0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xde, 0xfc,
+    0x3a, 0x08, 0x9e, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a,
+    0x11, 0x47, 0x9e, 0x10, 0xc4, 0x01, 0x3a, 0x08, 0xde, 0xfc, 0x83, 0xf7, 0x9e, 0x01, 0xe7, 0x3c,
+    0x42, 0x49, 0x89, 0x10, 0xc4, 0x00, 0x7b, 0xf0, 0x84, 0xf7, 0x9e, 0x01, 0xbd, 0xd7, 0x10, 0xe4,
+    0x9e, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47,
+    0x9e, 0x10, 0xc4, 0x01, 0x10, 0xe4, 0xbd, 0xd7, 0x84, 0xf7, 0x9e, 0x00, 0x7b, 0xf0, 0x89, 0x10,
+    0xc4, 0x00, 0xb5, 0x96, 0x84, 0xf7, 0x9e, 0x00, 0x7c, 0x10, 0x9f, 0x10, 0xc4, 0x01, 0x11, 0x47,
+    0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9f, 0x10, 0xc4, 0x00, 0x7c, 0x10,
+    0x84, 0xf7, 0x9e, 0x00, 0xb5, 0x96, 0x88, 0x10, 0xc4, 0x01, 0x29, 0x86, 0xce, 0x9a, 0x83, 0xf7,
+    0x9e, 0x01, 0xef, 0x5d, 0x42, 0x6a, 0x9f, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35,
+    0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9f, 0x10, 0xc4, 0x01, 0x42, 0x6a, 0xef, 0x5d, 0x83, 0xf7,
+    0x9e, 0x01, 0xce, 0x9a, 0x29, 0x86, 0x87, 0x10, 0xc4, 0x01, 0x3a, 0x29, 0xe7, 0x3c, 0x83, 0xf7,
+    0x9e, 0x01, 0xce, 0x9a, 0x29, 0x86, 0x9f, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35,
+    0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0x9f, 0x10, 0xc4, 0x01, 0x29, 0x86, 0xce, 0x9a, 0x83, 0xf7,
+    0x9e, 0x01, 0xe7, 0x3c, 0x3a, 0x29, 0x87, 0x10, 0xc4, 0x00, 0x63, 0x2d, 0x84, 0xf7, 0x9e, 0x00,
+    0xb5, 0xb7, 0xa0, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a,
+    0x11, 0x47, 0xa0, 0x10, 0xc4, 0x00, 0xb5, 0xb7, 0x84, 0xf7, 0x9e, 0x00, 0x63, 0x2d, 0x87, 0x10,
+    0xc4, 0x00, 0x84, 0x51, 0x84, 0xf7, 0x9e, 0x00, 0x8c, 0x92, 0xa0, 0x10, 0xc4, 0x01, 0x11, 0x47,
+    0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a, 0x11, 0x47, 0xa0, 0x10, 0xc4, 0x00, 0x8c, 0x92,
+    0x84, 0xf7, 0x9e, 0x00, 0x84, 0x51, 0x87, 0x10, 0xc4, 0x00, 0xa5, 0x35, 0x84, 0xf7, 0x9e, 0x00,
+    0x6b, 0x6e, 0xa0, 0x10, 0xc4, 0x01, 0x11, 0x47, 0x2c, 0x7a, 0x83, 0x35, 0x1e, 0x01, 0x2c, 0x7a,
+    0x11, 0x47, 0xa0, 0x10, 0xc4, 0x00, 0x6b, 0x6e, 0x84, 0xf7, 0x9e, 0x00, 0xa5, 0x35, 0x87, 0x10,
+    0xc4, 0x00, 0xbd, 0xd7, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x4a, 0x8b, 0xa0, 0x10, 0xc4, 0x07,
+    0x11, 0x47, 0x75, 0x9b, 0xc6, 0xfe, 0xef, 0x7e, 0xef, 0x7e, 0xc6, 0xfe, 0x75, 0x9b, 0x11, 0x47,
+    0xa0, 0x10, 0xc4, 0x01, 0x4a, 0x8b, 0xef, 0x7d, 0x83, 0xf7, 0x9e, 0x00, 0xbd, 0xd7, 0x86, 0x10,
+    0xc4, 0x01, 0x19, 0x25, 0xc6, 0x38, 0x83, 0xf7, 0x9e, 0x01, 0xe7, 0x3c, 0x3a, 0x29, 0xa0, 0x10,
+    0xc4, 0x00, 0x8c, 0xb3, 0x85, 0xf7, 0x9e, 0x00, 0x8c, 0xb3, 0xa0, 0x10, 0xc4, 0x01, 0x3a, 0x29,
+    0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xc6, 0x38, 0x19, 0x25, 0x85, 0x10, 0xc4, 0x01, 0x21, 0x46,
+    0xce, 0x79, 0x83, 0xf7, 0x9e, 0x01, 0xde, 0xfb, 0x31, 0xe8, 0x9f, 0x10, 0xc4, 0x00, 0x5b, 0x2d,
+    0x87, 0xf7, 0x9e, 0x00, 0x5b, 0x2d, 0x9f, 0x10, 0xc4, 0x01, 0x31, 0xe8, 0xde, 0xfb, 0x83, 0xf7,
+    0x9e, 0x01, 0xce, 0x79, 0x21, 0x46, 0x85, 0x10, 0xc4, 0x01, 0x29, 0x86, 0xd6, 0x9a, 0x83, 0xf7,
+    0x9e, 0x01, 0xd6, 0xdb, 0x29, 0xa7, 0x9f, 0x10, 0xc4, 0x00, 0xbd, 0xd7, 0x87, 0xf7, 0x9e, 0x00,
+    0xbd, 0xd7, 0x9f, 0x10, 0xc4, 0x01, 0x29, 0xa7, 0xd6, 0xdb, 0x83, 0xf7, 0x9e, 0x01, 0xd6, 0x9a,
+    0x29, 0x86, 0x85, 0x10, 0xc4, 0x01, 0x29, 0x87, 0xd6, 0xba, 0x83, 0xf7, 0x9e, 0x01, 0xd6, 0xba,
+    0x29, 0x87, 0x9f, 0x10, 0xc4, 0x00, 0xef, 0x5d, 0x87, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x11, 0x05,
+    0x9e, 0x10, 0xc4, 0x01, 0x29, 0x87, 0xd6, 0xba, 0x83, 0xf7, 0x9e, 0x01, 0xd6, 0xba, 0x29, 0x87,
+    0x85, 0x10, 0xc4, 0x01, 0x29, 0x87, 0xd6, 0xba, 0x83, 0xf7, 0x9e, 0x01, 0xd6, 0xba, 0x29, 0x87,
+    0x9f, 0x10, 0xc4, 0x00, 0xef, 0x5d, 0x87, 0xf7, 0x9e, 0x03, 0xef, 0x7e, 0x2b, 0xf7, 0x1a, 0x0b,
+    0x10, 0xe4, 0x9c, 0x10, 0xc4, 0x01, 0x29, 0x87, 0xd6, 0xba, 0x83, 0xf7, 0x9e, 0x01, 0xd6, 0xba,
+    0x29, 0x87, 0x85, 0x10, 0xc4, 0x01, 0x29, 0x86, 0xd6, 0x9a, 0x83, 0xf7, 0x9e, 0x01, 0xd6, 0xdb,
+    0x29, 0xa7, 0x9f, 0x10, 0xc4, 0x00, 0xbd, 0xd7, 0x87, 0xf7, 0x9e, 0x04, 0xc6, 0xfe, 0x35, 0x1e,
+    0x2c, 0xdc, 0x23, 0x95, 0x11, 0xa9, 0x9b, 0x10, 0xc4, 0x01, 0x29, 0xa7, 0xd6, 0xdb, 0x83, 0xf7,
+    0x9e, 0x01, 0xd6, 0x9a, 0x29, 0x86, 0x85, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xce, 0x79, 0x83, 0xf7,
+    0x9e, 0x01, 0xde, 0xfb, 0x31, 0xe8, 0x9f, 0x10, 0xc4, 0x00, 0x5b, 0x2d, 0x87, 0xf7, 0x9e, 0x00,
+    0x75, 0xfe, 0x82, 0x35, 0x1e, 0x02, 0x2c, 0xbb, 0x23, 0x32, 0x11, 0x68, 0x99, 0x10, 0xc4, 0x01,
+    0x31, 0xe8, 0xde, 0xfb, 0x83, 0xf7, 0x9e, 0x01, 0xce, 0x79, 0x21, 0x46, 0x85, 0x10, 0xc4, 0x01,
+    0x19, 0x25, 0xc6, 0x38, 0x83, 0xf7, 0x9e, 0x01, 0xe7, 0x3c, 0x3a, 0x29, 0xa0, 0x10, 0xc4, 0x00,
+    0x8c, 0x72, 0x85, 0xf7, 0x9e, 0x00, 0x9e, 0x7e, 0x85, 0x35, 0x1e, 0x02, 0x2c, 0x7a, 0x1a, 0xd0,
+    0x11, 0x26, 0x97, 0x10, 0xc4, 0x01, 0x3a, 0x29, 0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xc6, 0x38,
+    0x19, 0x25, 0x86, 0x10, 0xc4, 0x00, 0xbd, 0xd7, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x4a, 0x8b,
+    0xa1, 0x10, 0xc4, 0x07, 0x5b, 0x2d, 0xbd, 0xd7, 0xef, 0x5d, 0xef, 0x5d, 0xbd, 0xf7, 0x63, 0xf2,
+    0x2b, 0xf7, 0x2c, 0xfd, 0x86, 0x35, 0x1e, 0x02, 0x2c, 0x39, 0x1a, 0x4d, 0x11, 0x05, 0x95, 0x10,
+    0xc4, 0x01, 0x4a, 0x8b, 0xef, 0x7d, 0x83, 0xf7, 0x9e, 0x00, 0xbd, 0xd7, 0x87, 0x10, 0xc4, 0x00,
+    0xa5, 0x35, 0x84, 0xf7, 0x9e, 0x00, 0x6b, 0x6e, 0xa7, 0x10, 0xc4, 0x02, 0x11, 0x05, 0x1a, 0x4d,
+    0x2c, 0x39, 0x86, 0x35, 0x1e, 0x03, 0x2c, 0xfd, 0x2b, 0xf7, 0x1a, 0x0b, 0x10, 0xe4, 0x93, 0x10,
+    0xc4, 0x00, 0x6b, 0x6e, 0x84, 0xf7, 0x9e, 0x00, 0xa5, 0x35, 0x87, 0x10, 0xc4, 0x00, 0x84, 0x51,
+    0x84, 0xf7, 0x9e, 0x00, 0x8c, 0x92, 0xa9, 0x10, 0xc4, 0x02, 0x11, 0x26, 0x1a, 0xd0, 0x2c, 0x7a,
+    0x86, 0x35, 0x1e, 0x02, 0x2c, 0xdc, 0x23, 0x95, 0x11, 0xa9, 0x92, 0x10, 0xc4, 0x00, 0x8c, 0x92,
+    0x84, 0xf7, 0x9e, 0x00, 0x84, 0x51, 0x87, 0x10, 0xc4, 0x00, 0x63, 0x2d, 0x84, 0xf7, 0x9e, 0x00,
+    0xb5, 0xb7, 0xab, 0x10, 0xc4, 0x02, 0x11, 0x68, 0x23, 0x32, 0x2c, 0xbb, 0x86, 0x35, 0x1e, 0x02,
+    0x2c, 0xbb, 0x23, 0x32, 0x11, 0x67, 0x90, 0x10, 0xc4, 0x00, 0xb5, 0xb7, 0x84, 0xf7, 0x9e, 0x00,
+    0x63, 0x2d, 0x87, 0x10, 0xc4, 0x01, 0x3a, 0x29, 0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xce, 0x9a,
+    0x29, 0x86, 0xac, 0x10, 0xc4, 0x02, 0x11, 0xa9, 0x23, 0x95, 0x2c, 0xdc, 0x86, 0x35, 0x1e, 0x01,
+    0x2c, 0x39, 0x11, 0x67, 0x8e, 0x10, 0xc4, 0x01, 0x29, 0x86, 0xce, 0x9a, 0x83, 0xf7, 0x9e, 0x01,
+    0xe7, 0x3c, 0x3a, 0x29, 0x87, 0x10, 0xc4, 0x01, 0x29, 0x86, 0xce, 0x9a, 0x83, 0xf7, 0x9e, 0x01,
+    0xef, 0x5d, 0x42, 0x6a, 0xad, 0x10, 0xc4, 0x03, 0x10, 0xe4, 0x1a, 0x0b, 0x2b, 0xf7, 0x2c, 0xfd,
+    0x85, 0x35, 0x1e, 0x00, 0x1a, 0xaf, 0x8e, 0x10, 0xc4, 0x01, 0x42, 0x6a, 0xef, 0x5d, 0x83, 0xf7,
+    0x9e, 0x01, 0xce, 0x9a, 0x29, 0x86, 0x88, 0x10, 0xc4, 0x00, 0xb5, 0x96, 0x84, 0xf7, 0x9e, 0x00,
+    0x7c, 0x10, 0xaf, 0x10, 0xc4, 0x02, 0x11, 0x05, 0x1a, 0x4d, 0x2c, 0x39, 0x84, 0x35, 0x1e, 0x00,
+    0x1a, 0xaf, 0x8e, 0x10, 0xc4, 0x00, 0x7c, 0x10, 0x84, 0xf7, 0x9e, 0x00, 0xb5, 0x96, 0x89, 0x10,
+    0xc4, 0x00, 0x7b, 0xf0, 0x84, 0xf7, 0x9e, 0x01, 0xbd, 0xd7, 0x10, 0xe4, 0xb0, 0x10, 0xc4, 0x06,
+    0x11, 0x26, 0x1a, 0xd0, 0x2c, 0x7a, 0x35, 0x1e, 0x35, 0x1e, 0x2c, 0x39, 0x11, 0x67, 0x8d, 0x10,
+    0xc4, 0x01, 0x10, 0xe4, 0xbd, 0xd7, 0x84, 0xf7, 0x9e, 0x00, 0x7b, 0xf0, 0x89, 0x10, 0xc4, 0x01,
+    0x42, 0x49, 0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xde, 0xfc, 0x3a, 0x08, 0xb2, 0x10, 0xc4, 0x03,
+    0x11, 0x68, 0x1a, 0xaf, 0x1a, 0xaf, 0x11, 0x67, 0x8e, 0x10, 0xc4, 0x01, 0x3a, 0x08, 0xde, 0xfc,
+    0x83, 0xf7, 0x9e, 0x01, 0xe7, 0x3c, 0x42, 0x49, 0x89, 0x10, 0xc4, 0x01, 0x21, 0x45, 0xc6, 0x39,
+    0x84, 0xf7, 0x9e, 0x00, 0x7c, 0x10, 0xc5, 0x10, 0xc4, 0x00, 0x7c, 0x10, 0x84, 0xf7, 0x9e, 0x01,
+    0xc6, 0x39, 0x21, 0x45, 0x8a, 0x10, 0xc4, 0x00, 0x8c, 0x72, 0x84, 0xf7, 0x9e, 0x01, 0xc6, 0x38,
+    0x21, 0x46, 0xc3, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xc6, 0x38, 0x84, 0xf7, 0x9e, 0x00, 0x8c, 0x72,
+    0x8b, 0x10, 0xc4, 0x01, 0x42, 0x4a, 0xe7, 0x3c, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x5a, 0xec,
+    0xc3, 0x10, 0xc4, 0x01, 0x5a, 0xec, 0xef, 0x5d, 0x83, 0xf7, 0x9e, 0x01, 0xe7, 0x3c, 0x42, 0x4a,
+    0x8b, 0x10, 0xc4, 0x01, 0x19, 0x05, 0xb5, 0xd7, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xb6, 0x19, 0x05,
+    0xc1, 0x10, 0xc4, 0x01, 0x19, 0x05, 0xb5, 0xb6, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xd7, 0x19, 0x05,
+    0x8c, 0x10, 0xc4, 0x01, 0x63, 0x4d, 0xef, 0x7d, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x52, 0xcc,
+    0xc1, 0x10, 0xc4, 0x01, 0x52, 0xcc, 0xef, 0x5d, 0x83, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x63, 0x4d,
+    0x8d, 0x10, 0xc4, 0x01, 0x21, 0x66, 0xce, 0x59, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xd7, 0x19, 0x25,
+    0xbf, 0x10, 0xc4, 0x01, 0x19, 0x25, 0xb5, 0xd7, 0x84, 0xf7, 0x9e, 0x01, 0xce, 0x59, 0x21, 0x66,
+    0x8e, 0x10, 0xc4, 0x00, 0x73, 0xcf, 0x84, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x6b, 0x6e, 0xbf, 0x10,
+    0xc4, 0x01, 0x6b, 0x6e, 0xef, 0x7d, 0x84, 0xf7, 0x9e, 0x00, 0x73, 0xcf, 0x8f, 0x10, 0xc4, 0x01,
+    0x29, 0x86, 0xce, 0x59, 0x84, 0xf7, 0x9e, 0x01, 0xd6, 0x9a, 0x31, 0xc7, 0xbd, 0x10, 0xc4, 0x01,
+    0x31, 0xc7, 0xd6, 0x9a, 0x84, 0xf7, 0x9e, 0x01, 0xce, 0x59, 0x29, 0x86, 0x90, 0x10, 0xc4, 0x01,
+    0x6b, 0x6e, 0xef, 0x7d, 0x84, 0xf7, 0x9e, 0x01, 0x9d, 0x14, 0x19, 0x05, 0xbb, 0x10, 0xc4, 0x01,
+    0x19, 0x05, 0x9d, 0x14, 0x84, 0xf7, 0x9e, 0x01, 0xef, 0x7d, 0x6b, 0x6e, 0x91, 0x10, 0xc4, 0x01,
+    0x19, 0x25, 0xb5, 0xd7, 0x84, 0xf7, 0x9e, 0x01, 0xef, 0x5d, 0x6b, 0x6e, 0xbb, 0x10, 0xc4, 0x01,
+    0x6b, 0x6e, 0xef, 0x5d, 0x84, 0xf7, 0x9e, 0x01, 0xb5, 0xd7, 0x19, 0x25, 0x92, 0x10, 0xc4, 0x01,
+    0x4a, 0x8b, 0xe7, 0x1c, 0x84, 0xf7, 0x9e, 0x01, 0xde, 0xdb, 0x4a, 0x6a, 0xb9, 0x10, 0xc4, 0x01,
+    0x4a, 0x6a, 0xde, 0xdb, 0x84, 0xf7, 0x9e, 0x01, 0xe7, 0x1c, 0x4a, 0x8b, 0x94, 0x10, 0xc4, 0x00,
+    0x8c, 0x72, 0x85, 0xf7, 0x9e, 0x01, 0xc6, 0x38, 0x31, 0xc7, 0xb7, 0x10, 0xc4, 0x01, 0x31, 0xc7,
+    0xc6, 0x38, 0x85, 0xf7, 0x9e, 0x00, 0x8c, 0x72, 0x95, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xbd, 0xd7,
+    0x85, 0xf7, 0x9e, 0x01, 0xb5, 0x96, 0x21, 0x66, 0xb5, 0x10, 0xc4, 0x01, 0x21, 0x66, 0xb5, 0x96,
+    0x85, 0xf7, 0x9e, 0x01, 0xbd, 0xd7, 0x21, 0x46, 0x96, 0x10, 0xc4, 0x01, 0x42, 0x4a, 0xde, 0xdb,
+    0x85, 0xf7, 0x9e, 0x01, 0xad, 0x55, 0x21, 0x46, 0xb3, 0x10, 0xc4, 0x01, 0x21, 0x46, 0xad, 0x55,
+    0x85, 0xf7, 0x9e, 0x01, 0xde, 0xdb, 0x42, 0x4a, 0x98, 0x10, 0xc4, 0x01, 0x63, 0x4d, 0xe7, 0x3c,
+    0x85, 0xf7, 0x9e, 0x01, 0xad, 0x55, 0x21, 0x66, 0xb1, 0x10, 0xc4, 0x01, 0x21, 0x66, 0xad, 0x55,
+    0x85, 0xf7, 0x9e, 0x01, 0xe7, 0x3c, 0x63, 0x4d, 0x99, 0x10, 0xc4, 0x02, 0x10, 0xe4, 0x84, 0x51,
+    0xef, 0x7d, 0x85, 0xf7, 0x9e, 0x01, 0xb5, 0x96, 0x31, 0xc7, 0xaf, 0x10, 0xc4, 0x01, 0x31, 0xc7,
+    0xb5, 0x96, 0x85, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0x84, 0x51, 0x10, 0xe4, 0x9a, 0x10, 0xc4, 0x02,
+    0x19, 0x25, 0x9c, 0xd3, 0xef, 0x7d, 0x85, 0xf7, 0x9e, 0x01, 0xc6, 0x38, 0x4a, 0x6a, 0xad, 0x10,
+    0xc4, 0x01, 0x4a, 0x6a, 0xc6, 0x38, 0x85, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0x9c, 0xd3, 0x19, 0x25,
+    0x9c, 0x10, 0xc4, 0x01, 0x21, 0x25, 0xa5, 0x34, 0x86, 0xf7, 0x9e, 0x02, 0xde, 0xdb, 0x6b, 0x6e,
+    0x19, 0x05, 0xa9, 0x10, 0xc4, 0x02, 0x19, 0x05, 0x6b, 0x6e, 0xde, 0xdb, 0x86, 0xf7, 0x9e, 0x01,
+    0xa5, 0x34, 0x21, 0x25, 0x9e, 0x10, 0xc4, 0x02, 0x21, 0x46, 0xa5, 0x34, 0xef, 0x7d, 0x85, 0xf7,
+    0x9e, 0x02, 0xef, 0x5d, 0x9d, 0x14, 0x31, 0xc7, 0xa7, 0x10, 0xc4, 0x02, 0x31, 0xc7, 0x9d, 0x14,
+    0xef, 0x5d, 0x85, 0xf7, 0x9e, 0x02, 0xef, 0x7d, 0xa5, 0x34, 0x21, 0x46, 0xa0, 0x10, 0xc4, 0x02,
+    0x21, 0x25, 0x9c, 0xd3, 0xef, 0x7d, 0x86, 0xf7, 0x9e, 0x02, 0xd6, 0x9a, 0x6b, 0x6e, 0x19, 0x25,
+    0xa3, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x6b, 0x6e, 0xd6, 0x9a, 0x86, 0xf7, 0x9e, 0x02, 0xef, 0x7d,
+    0x9c, 0xd3, 0x21, 0x25, 0xa2, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x84, 0x51, 0xe7, 0x3c, 0x86, 0xf7,
+    0x9e, 0x03, 0xef, 0x7d, 0xb5, 0xd7, 0x52, 0xcc, 0x19, 0x05, 0x9f, 0x10, 0xc4, 0x03, 0x19, 0x05,
+    0x52, 0xcc, 0xb5, 0xd7, 0xef, 0x7d, 0x86, 0xf7, 0x9e, 0x02, 0xe7, 0x3c, 0x84, 0x51, 0x19, 0x25,
+    0xa4, 0x10, 0xc4, 0x02, 0x10, 0xe4, 0x63, 0x4d, 0xde, 0xdb, 0x87, 0xf7, 0x9e, 0x03, 0xef, 0x5d,
+    0xb5, 0xb6, 0x5a, 0xec, 0x21, 0x46, 0x9b, 0x10, 0xc4, 0x03, 0x21, 0x46, 0x5a, 0xec, 0xb5, 0xb6,
+    0xef, 0x5d, 0x87, 0xf7, 0x9e, 0x02, 0xde, 0xdb, 0x63, 0x4d, 0x10, 0xe4, 0xa7, 0x10, 0xc4, 0x01,
+    0x42, 0x4a, 0xbd, 0xd7, 0x88, 0xf7, 0x9e, 0x04, 0xef, 0x5d, 0xc6, 0x38, 0x7c, 0x10, 0x3a, 0x08,
+    0x10, 0xe4, 0x95, 0x10, 0xc4, 0x04, 0x10, 0xe4, 0x3a, 0x08, 0x7c, 0x10, 0xc6, 0x38, 0xef, 0x5d,
+    0x88, 0xf7, 0x9e, 0x01, 0xbd, 0xd7, 0x42, 0x4a, 0xaa, 0x10, 0xc4, 0x02, 0x21, 0x46, 0x8c, 0x72,
+    0xe7, 0x1c, 0x89, 0xf7, 0x9e, 0x04, 0xde, 0xfc, 0xbd, 0xd7, 0x7c, 0x10, 0x42, 0x6a, 0x29, 0x86,
+    0x8f, 0x10, 0xc4, 0x04, 0x29, 0x86, 0x42, 0x6a, 0x7c, 0x10, 0xbd, 0xd7, 0xde, 0xfc, 0x89, 0xf7,
+    0x9e, 0x02, 0xe7, 0x1c, 0x8c, 0x72, 0x21, 0x46, 0xad, 0x10, 0xc4, 0x02, 0x4a, 0x8b, 0xb5, 0xd7,
+    0xef, 0x7d, 0x8a, 0xf7, 0x9e, 0x13, 0xef, 0x5d, 0xce, 0x9a, 0xb5, 0xb7, 0x8c, 0x92, 0x6b, 0x6e,
+    0x4a, 0x8b, 0x3a, 0x29, 0x31, 0xe8, 0x29, 0xa7, 0x29, 0x87, 0x29, 0x87, 0x29, 0xa7, 0x31, 0xe8,
+    0x3a, 0x29, 0x4a, 0x8b, 0x6b, 0x6e, 0x8c, 0x92, 0xb5, 0xb7, 0xce, 0x9a, 0xef, 0x5d, 0x8a, 0xf7,
+    0x9e, 0x02, 0xef, 0x7d, 0xb5, 0xd7, 0x4a, 0x8b, 0xb0, 0x10, 0xc4, 0x02, 0x19, 0x25, 0x6b, 0x6e,
+    0xce, 0x59, 0x8e, 0xf7, 0x9e, 0x09, 0xef, 0x7d, 0xe7, 0x3c, 0xde, 0xfb, 0xd6, 0xdb, 0xd6, 0xba,
+    0xd6, 0xba, 0xd6, 0xdb, 0xde, 0xfb, 0xe7, 0x3c, 0xef, 0x7d, 0x8e, 0xf7, 0x9e, 0x02, 0xce, 0x59,
+    0x6b, 0x6e, 0x19, 0x25, 0xb3, 0x10, 0xc4, 0x03, 0x29, 0x86, 0x73, 0xcf, 0xce, 0x59, 0xef, 0x7d,
+    0xa1, 0xf7, 0x9e, 0x03, 0xef, 0x7d, 0xce, 0x59, 0x73, 0xcf, 0x29, 0x86, 0xb7, 0x10, 0xc4, 0x03,
+    0x21, 0x66, 0x63, 0x4d, 0xb5, 0xd7, 0xe7, 0x3c, 0x9d, 0xf7, 0x9e, 0x03, 0xe7, 0x3c, 0xb5, 0xd7,
+    0x63, 0x4d, 0x21, 0x66, 0xbb, 0x10, 0xc4, 0x04, 0x19, 0x05, 0x42, 0x4a, 0x8c, 0x72, 0xc6, 0x39,
+    0xe7, 0x3c, 0x97, 0xf7, 0x9e, 0x04, 0xe7, 0x3c, 0xc6, 0x39, 0x8c, 0x72, 0x42, 0x4a, 0x19, 0x05,
+    0xc0, 0x10, 0xc4, 0x05, 0x21, 0x45, 0x42, 0x49, 0x7b, 0xf0, 0xb5, 0x96, 0xce, 0x9a, 0xe7, 0x3c,
+    0x8f, 0xf7, 0x9e, 0x05, 0xe7, 0x3c, 0xce, 0x9a, 0xb5, 0x96, 0x7b, 0xf0, 0x42, 0x49, 0x21, 0x45,
+    0xc7, 0x10, 0xc4, 0x13, 0x29, 0x86, 0x3a, 0x29, 0x63, 0x2d, 0x84, 0x51, 0xa5, 0x35, 0xbd, 0xd7,
+    0xc6, 0x38, 0xce, 0x79, 0xd6, 0x9a, 0xd6, 0xba, 0xd6, 0xba, 0xd6, 0x9a, 0xce, 0x79, 0xc6, 0x38,
+    0xbd, 0xd7, 0xa5, 0x35, 0x84, 0x51, 0x63, 0x2d, 0x3a, 0x29, 0x29, 0x86, 0xd1, 0x10, 0xc4, 0x07,
+    0x19, 0x25, 0x21, 0x46, 0x29, 0x86, 0x29, 0x87, 0x29, 0x87, 0x29, 0x86, 0x21, 0x46, 0x19, 0x25,
+    0xff, 0x10, 0xc4, 0xff, 0x10, 0xc4, 0xcb, 0x10, 0xc4,
+};
+
+const splash_img_t splash_logo = {
+    .w = 96,
+    .h = 96,
+    .size = sizeof(splash_logo_data),
+    .data = splash_logo_data,
+};
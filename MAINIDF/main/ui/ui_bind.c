@@ -0,0 +1,187 @@
+/**
+ * @file ui_bind.c
+ * @brief 界面数据绑定实现
+ */
+
+#include "ui_bind.h"
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_lvgl_port.h"
+
+static const char *TAG = "ui_bind";
+
+typedef struct {
+    ui_bind_val_t pending;  // 数据源写入的最新值
+    ui_bind_val_t shown;    // 已应用到控件的值
+    bool dirty;
+    bool valid;             // shown 中有已应用的值
+} bind_slot_t;
+
+typedef struct {
+    lv_obj_t *obj;
+    ui_bind_apply_t apply;
+    ui_bind_id_t id;
+} bind_sub_t;
+
+static bind_slot_t s_slots[UI_BIND_MAX];
+static bind_sub_t s_subs[UI_BIND_MAX_SUBS];
+static ui_bind_stats_t s_stats;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED; // 只保护 s_slots 和 s_stats 的写入计数
+static lv_timer_t *s_timer = NULL;
+
+static void apply_label(lv_obj_t *obj, const ui_bind_val_t *val)
+{
+    lv_label_set_text(obj, val->str);
+}
+
+static void apply_subs(ui_bind_id_t id, const ui_bind_val_t *val)
+{
+    for(int i = 0; i < UI_BIND_MAX_SUBS; i++) {
+        if(s_subs[i].obj && s_subs[i].id == id) {
+            s_subs[i].apply(s_subs[i].obj, val);
+            s_stats.applies++;
+        }
+    }
+}
+
+// LVGL 任务中每个刷新周期执行一次
+static void flush_cb(lv_timer_t *timer)
+{
+    int64_t start = 0;
+    bool any = false;
+
+    for(int id = 0; id < UI_BIND_MAX; id++) {
+        bind_slot_t *slot = &s_slots[id];
+        ui_bind_val_t val;
+
+        taskENTER_CRITICAL(&s_mux);
+        bool dirty = slot->dirty;
+        if(dirty) {
+            val = slot->pending;
+            slot->dirty = false;
+        }
+        taskEXIT_CRITICAL(&s_mux);
+
+        if(!dirty) {
+            continue;
+        }
+        if(slot->valid && val.num == slot->shown.num && strcmp(val.str, slot->shown.str) == 0) {
+            s_stats.unchanged++;
+            continue;
+        }
+        if(!any) {
+            any = true;
+            start = esp_timer_get_time();
+        }
+        slot->shown = val;
+        slot->valid = true;
+        apply_subs(id, &val);
+    }
+
+    if(any) {
+        uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+        s_stats.flushes++;
+        if(us > s_stats.max_flush_us) {
+            s_stats.max_flush_us = us;
+        }
+    }
+}
+
+static void obj_delete_cb(lv_event_t *e)
+{
+    lv_obj_t *obj = lv_event_get_target(e);
+
+    for(int i = 0; i < UI_BIND_MAX_SUBS; i++) {
+        if(s_subs[i].obj == obj) {
+            s_subs[i].obj = NULL;
+        }
+    }
+}
+
+esp_err_t ui_bind_init(void)
+{
+    if(s_timer) {
+        return ESP_OK;
+    }
+
+    lvgl_port_lock(0);
+    s_timer = lv_timer_create(flush_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+    lvgl_port_unlock();
+    if(s_timer == NULL) {
+        ESP_LOGE(TAG, "Create flush timer failed");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static void bind_write(ui_bind_id_t id, const int32_t *num, const char *str)
+{
+    if(id >= UI_BIND_MAX) {
+        return;
+    }
+
+    bind_slot_t *slot = &s_slots[id];
+    taskENTER_CRITICAL(&s_mux);
+    if(slot->dirty) {
+        s_stats.coalesced++;
+    }
+    if(num) {
+        slot->pending.num = *num;
+    }
+    if(str) {
+        strlcpy(slot->pending.str, str, sizeof(slot->pending.str));
+    }
+    slot->dirty = true;
+    s_stats.sets++;
+    taskEXIT_CRITICAL(&s_mux);
+}
+
+void ui_bind_set_int(ui_bind_id_t id, int32_t num)
+{
+    bind_write(id, &num, NULL);
+}
+
+void ui_bind_set_str(ui_bind_id_t id, const char *str)
+{
+    bind_write(id, NULL, str ? str : "");
+}
+
+void ui_bind_set(ui_bind_id_t id, int32_t num, const char *str)
+{
+    bind_write(id, &num, str ? str : "");
+}
+
+esp_err_t ui_bind_attach(ui_bind_id_t id, lv_obj_t *obj, ui_bind_apply_t apply)
+{
+    if(id >= UI_BIND_MAX || obj == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for(int i = 0; i < UI_BIND_MAX_SUBS; i++) {
+        if(s_subs[i].obj) {
+            continue;
+        }
+        s_subs[i].obj = obj;
+        s_subs[i].apply = apply ? apply : apply_label;
+        s_subs[i].id = id;
+        lv_obj_add_event_cb(obj, obj_delete_cb, LV_EVENT_DELETE, NULL);
+
+        // 新建的控件直接显示已应用的值，尚未应用的值等下一个周期
+        if(s_slots[id].valid) {
+            s_subs[i].apply(obj, &s_slots[id].shown);
+        }
+        return ESP_OK;
+    }
+
+    ESP_LOGE(TAG, "Too many bindings");
+    return ESP_ERR_NO_MEM;
+}
+
+void ui_bind_get_stats(ui_bind_stats_t *stats)
+{
+    taskENTER_CRITICAL(&s_mux);
+    *stats = s_stats;
+    taskEXIT_CRITICAL(&s_mux);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file ui_bind.h
+ * @brief 界面数据绑定
+ *
+ * 数据源（任意任务）只写入绑定的最新值并标记为脏，不需要获取 LVGL 锁；
+ * LVGL 任务中的定时器每个刷新周期统一处理一次，把脏值应用到订阅它的控件上。
+ * 一个周期内多次写入只保留最后一次，相同的值不会重复设置控件。
+ *
+ * 控件删除时自动解除订阅，屏幕被屏幕管理器销毁后无需额外处理。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lvgl.h"
+
+#define UI_BIND_STR_LEN     32      // 字符串值最大长度（含'\0'）
+#define UI_BIND_MAX_SUBS    16      // 订阅总数上限
+
+/** 绑定的数据 */
+typedef enum {
+    UI_BIND_TIME,       // 时间文本
+    UI_BIND_BATTERY,    // 电池电量百分比，num 为 0~100，str 非空表示正在充电
+    UI_BIND_WIFI,       // WLAN 状态，num 为 0 表示未连接、1~4 为信号格数，str 为网络名称
+    UI_BIND_FESTIVAL,   // 当天的节日名称，不是节日时为空串
+    UI_BIND_WEATHER,    // 天气，str 为显示文本，没有数据时为空串；num 为空气质量指数，-1 表示未知
+    UI_BIND_DEVICE_0,   // 智能家居设备（连续 HOME_MQTT_DEVICES 个），str 为显示文本，没有设备时为空串；
+    UI_BIND_DEVICE_1,   // num 为 1 开、0 关、-1 不是开关量
+    UI_BIND_DEVICE_2,
+    UI_BIND_DEVICE_3,
+    UI_BIND_MAX,
+} ui_bind_id_t;
+
+/** 绑定值 */
+typedef struct {
+    int32_t num;
+    char str[UI_BIND_STR_LEN];
+} ui_bind_val_t;
+
+/** 把值应用到控件，在 LVGL 任务中调用 */
+typedef void (*ui_bind_apply_t)(lv_obj_t *obj, const ui_bind_val_t *val);
+
+/** 统计信息 */
+typedef struct {
+    uint32_t sets;          // 写入次数
+    uint32_t coalesced;     // 覆盖了尚未应用的值的写入次数
+    uint32_t unchanged;     // 与已显示的值相同而跳过的次数
+    uint32_t flushes;       // 有脏值的刷新周期数
+    uint32_t applies;       // 控件更新次数
+    uint32_t max_flush_us;  // 单个周期处理的最长耗时
+} ui_bind_stats_t;
+
+/**
+ * 初始化，创建刷新定时器（需在 LVGL 初始化之后调用）
+ * @return esp_err_t 操作结果
+ */
+esp_err_t ui_bind_init(void);
+
+/**
+ * 写入数字值（保留原字符串）
+ * @param id 绑定
+ * @param num 数值
+ */
+void ui_bind_set_int(ui_bind_id_t id, int32_t num);
+
+/**
+ * 写入字符串值（保留原数值）
+ * @param id 绑定
+ * @param str 字符串，超长截断
+ */
+void ui_bind_set_str(ui_bind_id_t id, const char *str);
+
+/**
+ * 同时写入数字和字符串
+ * @param id 绑定
+ * @param num 数值
+ * @param str 字符串，NULL 表示空串
+ */
+void ui_bind_set(ui_bind_id_t id, int32_t num, const char *str);
+
+/**
+ * 订阅绑定，已有值时立即应用一次（需持有 LVGL 锁）
+ * @param id 绑定
+ * @param obj 控件
+ * @param apply 应用函数，NULL 表示把 str 设置为标签文本
+ * @return esp_err_t 订阅已满返回 ESP_ERR_NO_MEM
+ */
+esp_err_t ui_bind_attach(ui_bind_id_t id, lv_obj_t *obj, ui_bind_apply_t apply);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void ui_bind_get_stats(ui_bind_stats_t *stats);
@@ -0,0 +1,72 @@
+/**
+ * @file ui_perf.c
+ * @brief 界面帧时间统计实现
+ */
+
+#include "ui_perf.h"
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_lvgl_port.h"
+
+typedef struct {
+    uint32_t frames;
+    uint32_t render_ms_max;
+    uint32_t render_ms_total;
+    uint32_t gap_ms_max;
+    uint32_t slow_frames;
+    int64_t last_us;        // 上一帧结束时间，0 表示还没有
+} perf_state_t;
+
+static perf_state_t s_perf;
+
+// LVGL 任务中每帧刷新结束后调用
+static void monitor_cb(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+    int64_t now = esp_timer_get_time();
+
+    if(s_perf.last_us) {
+        uint32_t gap = (uint32_t)((now - s_perf.last_us) / 1000);
+        if(gap > s_perf.gap_ms_max) {
+            s_perf.gap_ms_max = gap;
+        }
+        if(gap > UI_PERF_SLOW_GAP_MS) {
+            s_perf.slow_frames++;
+        }
+    }
+    s_perf.last_us = now;
+    s_perf.frames++;
+    s_perf.render_ms_total += time_ms;
+    if(time_ms > s_perf.render_ms_max) {
+        s_perf.render_ms_max = time_ms;
+    }
+}
+
+void ui_perf_attach(lv_disp_t *disp)
+{
+    lvgl_port_lock(0);
+    if(disp == NULL) {
+        disp = lv_disp_get_default();
+    }
+    if(disp) {
+        disp->driver->monitor_cb = monitor_cb;
+    }
+    lvgl_port_unlock();
+}
+
+void ui_perf_reset(void)
+{
+    lvgl_port_lock(0);
+    memset(&s_perf, 0, sizeof(s_perf));
+    lvgl_port_unlock();
+}
+
+void ui_perf_get(ui_perf_stats_t *stats)
+{
+    lvgl_port_lock(0);
+    stats->frames = s_perf.frames;
+    stats->render_ms_max = s_perf.render_ms_max;
+    stats->render_ms_avg = s_perf.frames ? s_perf.render_ms_total / s_perf.frames : 0;
+    stats->gap_ms_max = s_perf.gap_ms_max;
+    stats->slow_frames = s_perf.slow_frames;
+    lvgl_port_unlock();
+}
@@ -0,0 +1,40 @@
+/**
+ * @file ui_perf.h
+ * @brief 界面帧时间统计
+ *
+ * 通过显示驱动的 monitor_cb 记录每帧渲染耗时和相邻两帧的间隔。
+ * 界面有动画时帧间隔应接近刷新周期，LVGL 任务被阻塞时会表现为间隔突增。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/** 统计信息，自上次 ui_perf_reset() 起 */
+typedef struct {
+    uint32_t frames;            // 帧数
+    uint32_t render_ms_max;     // 单帧最长渲染时间
+    uint32_t render_ms_avg;     // 平均渲染时间
+    uint32_t gap_ms_max;        // 相邻两帧的最长间隔
+    uint32_t slow_frames;       // 间隔超过 UI_PERF_SLOW_GAP_MS 的帧数
+} ui_perf_stats_t;
+
+#define UI_PERF_SLOW_GAP_MS     100
+
+/**
+ * 挂接到显示驱动
+ * @param disp 显示，NULL 使用默认显示
+ */
+void ui_perf_attach(lv_disp_t *disp);
+
+/**
+ * 清零统计
+ */
+void ui_perf_reset(void);
+
+/**
+ * 获取统计信息
+ * @param stats 输出
+ */
+void ui_perf_get(ui_perf_stats_t *stats);
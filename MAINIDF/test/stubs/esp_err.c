@@ -0,0 +1,12 @@
+#include <stdio.h>
+#include "esp_err.h"
+#include "esp_log.h"
+
+esp_log_level_t host_log_level = ESP_LOG_INFO;
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    static char buf[16];
+    snprintf(buf, sizeof(buf), "0x%x", code);
+    return buf;
+}
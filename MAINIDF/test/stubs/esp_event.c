@@ -0,0 +1,45 @@
+#include <pthread.h>
+#include "esp_event.h"
+
+#define HOST_MAX_HANDLERS 32
+
+static struct {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t handler;
+    void *arg;
+} s_handlers[HOST_MAX_HANDLERS];
+static int s_count;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+esp_err_t esp_event_handler_register(esp_event_base_t base, int32_t id, esp_event_handler_t handler, void *arg)
+{
+    esp_err_t err = ESP_ERR_NO_MEM;
+
+    pthread_mutex_lock(&s_lock);
+    if (s_count < HOST_MAX_HANDLERS) {
+        s_handlers[s_count].base = base;
+        s_handlers[s_count].id = id;
+        s_handlers[s_count].handler = handler;
+        s_handlers[s_count].arg = arg;
+        s_count++;
+        err = ESP_OK;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t esp_event_post(esp_event_base_t base, int32_t id, const void *data, size_t size, TickType_t ticks)
+{
+    pthread_mutex_lock(&s_lock);
+    int count = s_count;
+    pthread_mutex_unlock(&s_lock);
+
+    // 处理函数只会追加，不会删除，不持锁调用
+    for (int i = 0; i < count; i++) {
+        if (s_handlers[i].base == base && (s_handlers[i].id == ESP_EVENT_ANY_ID || s_handlers[i].id == id)) {
+            s_handlers[i].handler(s_handlers[i].arg, base, id, (void *)data);
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,363 @@
+#include "esp_http_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#define HOST_MAX_HEADERS 8
+
+struct esp_http_client {
+    char host[64];
+    char port[8];
+    char path[256];
+    int fd;                     // -1 表示未连接
+    int timeout_ms;
+    bool keep_alive;
+    http_event_handle_cb cb;
+    void *user_data;
+    struct {
+        char key[32];
+        char value[128];
+    } headers[HOST_MAX_HEADERS];
+    int header_count;
+    char rbuf[1024];
+    size_t rpos, rlen;
+    int status;
+    bool chunked;
+    bool until_close;           // 没有长度也不是分块，读到连接关闭为止
+    int64_t remain;             // 当前块或整个响应体剩余的字节数
+    bool complete;
+};
+
+static void fire(esp_http_client_handle_t h, esp_http_client_event_id_t id, char *key, char *value)
+{
+    esp_http_client_event_t evt = {
+        .event_id = id,
+        .client = h,
+        .user_data = h->user_data,
+        .header_key = key,
+        .header_value = value,
+    };
+    if (h->cb) {
+        h->cb(&evt);
+    }
+}
+
+// 只支持 http://host[:port][/path][?query]
+static esp_err_t parse_url(esp_http_client_handle_t h, const char *url)
+{
+    if (strncmp(url, "http://", 7) != 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    const char *p = url + 7;
+    size_t n = strcspn(p, ":/?#");
+    if (n == 0 || n >= sizeof(h->host)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    char host[sizeof(h->host)], port[sizeof(h->port)] = "80";
+    memcpy(host, p, n);
+    host[n] = '\0';
+    p += n;
+    if (*p == ':') {
+        n = strcspn(++p, "/?#");
+        if (n == 0 || n >= sizeof(port)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(port, p, n);
+        port[n] = '\0';
+        p += n;
+    }
+    // 主机变化时不能沿用原连接
+    if (h->fd >= 0 && (strcmp(host, h->host) != 0 || strcmp(port, h->port) != 0)) {
+        esp_http_client_close(h);
+    }
+    strcpy(h->host, host);
+    strcpy(h->port, port);
+    snprintf(h->path, sizeof(h->path), "%s%s", *p == '/' ? "" : "/", p);
+    return ESP_OK;
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    struct esp_http_client *h = calloc(1, sizeof(*h));
+    if (!h) {
+        return NULL;
+    }
+    h->fd = -1;
+    h->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : 5000;
+    h->keep_alive = config->keep_alive_enable;
+    h->cb = config->event_handler;
+    h->user_data = config->user_data;
+    if (parse_url(h, config->url) != ESP_OK) {
+        free(h);
+        return NULL;
+    }
+    return h;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    return parse_url(client, url);
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method)
+{
+    return method == HTTP_METHOD_GET ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key)
+{
+    for (int i = 0; i < client->header_count; i++) {
+        if (strcasecmp(client->headers[i].key, key) == 0) {
+            client->headers[i] = client->headers[--client->header_count];
+            i--;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    esp_http_client_delete_header(client, key);
+    if (client->header_count == HOST_MAX_HEADERS || strlen(key) >= sizeof(client->headers[0].key) ||
+        strlen(value) >= sizeof(client->headers[0].value)) {
+        return ESP_ERR_NO_MEM;
+    }
+    strcpy(client->headers[client->header_count].key, key);
+    strcpy(client->headers[client->header_count].value, value);
+    client->header_count++;
+    return ESP_OK;
+}
+
+static esp_err_t connect_to(esp_http_client_handle_t h)
+{
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, *res;
+
+    if (getaddrinfo(h->host, h->port, &hints, &res) != 0) {
+        return ESP_FAIL;
+    }
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        return ESP_FAIL;
+    }
+    struct timeval tv = { .tv_sec = h->timeout_ms / 1000, .tv_usec = h->timeout_ms % 1000 * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    h->fd = fd;
+    h->rpos = h->rlen = 0;
+    fire(h, HTTP_EVENT_ON_CONNECTED, NULL, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int write_len)
+{
+    char req[1024];
+    int n;
+
+    if (client->fd < 0 && connect_to(client) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    n = snprintf(req, sizeof(req), "GET %s HTTP/1.1\r\nHost: %s:%s\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n%s",
+                 client->path, client->host, client->port, client->keep_alive ? "" : "Connection: close\r\n");
+    for (int i = 0; i < client->header_count; i++) {
+        n += snprintf(req + n, sizeof(req) - n, "%s: %s\r\n", client->headers[i].key, client->headers[i].value);
+    }
+    n += snprintf(req + n, sizeof(req) - n, "\r\n");
+    if (n >= (int)sizeof(req) || send(client->fd, req, n, MSG_NOSIGNAL) != n) {
+        return ESP_FAIL;
+    }
+    fire(client, HTTP_EVENT_HEADERS_SENT, NULL, NULL);
+    return ESP_OK;
+}
+
+static bool fill(esp_http_client_handle_t h)
+{
+    if (h->rpos < h->rlen) {
+        return true;
+    }
+    ssize_t n = recv(h->fd, h->rbuf, sizeof(h->rbuf), 0);
+    if (n <= 0) {
+        return false;
+    }
+    h->rpos = 0;
+    h->rlen = n;
+    return true;
+}
+
+// 读一行，去掉行尾的 CRLF
+static bool read_line(esp_http_client_handle_t h, char *line, size_t len)
+{
+    size_t n = 0;
+
+    while (fill(h)) {
+        char c = h->rbuf[h->rpos++];
+        if (c == '\n') {
+            if (n > 0 && line[n - 1] == '\r') {
+                n--;
+            }
+            line[n] = '\0';
+            return true;
+        }
+        if (n + 1 < len) {
+            line[n++] = c;
+        }
+    }
+    return false;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client)
+{
+    char line[512];
+    int64_t content_length = -1;
+
+    if (client->fd < 0 || !read_line(client, line, sizeof(line)) ||
+        sscanf(line, "HTTP/1.%*d %d", &client->status) != 1) {
+        return ESP_FAIL;
+    }
+    client->chunked = false;
+    while (1) {
+        if (!read_line(client, line, sizeof(line))) {
+            return ESP_FAIL;
+        }
+        if (!line[0]) {
+            break;
+        }
+        char *value = strchr(line, ':');
+        if (!value) {
+            return ESP_FAIL;
+        }
+        *value++ = '\0';
+        while (*value == ' ') {
+            value++;
+        }
+        if (strcasecmp(line, "Content-Length") == 0) {
+            content_length = atoll(value);
+        } else if (strcasecmp(line, "Transfer-Encoding") == 0 && strcasecmp(value, "chunked") == 0) {
+            client->chunked = true;
+        }
+        fire(client, HTTP_EVENT_ON_HEADER, line, value);
+    }
+
+    bool no_body = client->status == 204 || client->status == 304 || client->status / 100 == 1;
+    client->until_close = !client->chunked && content_length < 0 && !no_body;
+    client->remain = client->chunked || content_length < 0 ? 0 : content_length;
+    client->complete = !client->chunked && !client->until_close && client->remain == 0;
+    // 与 ESP-IDF 相同：分块或长度未知时返回 0
+    return content_length > 0 && !client->chunked ? content_length : 0;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client->status;
+}
+
+static int read_body(esp_http_client_handle_t h, char *buf, int len)
+{
+    if (!fill(h)) {
+        return -1;
+    }
+    size_t n = h->rlen - h->rpos;
+    if (n > (size_t)len) {
+        n = len;
+    }
+    if (!h->until_close && (int64_t)n > h->remain) {
+        n = h->remain;
+    }
+    memcpy(buf, h->rbuf + h->rpos, n);
+    h->rpos += n;
+    return n;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char *buffer, int len)
+{
+    char line[64];
+
+    if (client->complete || client->fd < 0) {
+        return client->complete ? 0 : -1;
+    }
+    if (client->until_close) {
+        int n = read_body(client, buffer, len);
+        if (n < 0) {
+            client->complete = true;
+            return 0;
+        }
+        return n;
+    }
+    if (client->chunked && client->remain == 0) {
+        if (!read_line(client, line, sizeof(line))) {
+            return -1;
+        }
+        client->remain = strtoll(line, NULL, 16);
+        if (client->remain == 0) {
+            // 跳过尾部字段
+            do {
+                if (!read_line(client, line, sizeof(line))) {
+                    return -1;
+                }
+            } while (line[0]);
+            client->complete = true;
+            return 0;
+        }
+    }
+    int n = read_body(client, buffer, len);
+    if (n < 0) {
+        return -1;
+    }
+    client->remain -= n;
+    if (client->remain == 0) {
+        if (client->chunked) {
+            if (!read_line(client, line, sizeof(line))) {
+                return -1;
+            }
+        } else {
+            client->complete = true;
+        }
+    }
+    return n;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client)
+{
+    return client->complete;
+}
+
+esp_err_t esp_http_client_flush_response(esp_http_client_handle_t client, int *len)
+{
+    char buf[256];
+    int n, total = 0;
+
+    while ((n = esp_http_client_read(client, buf, sizeof(buf))) > 0) {
+        total += n;
+    }
+    if (len) {
+        *len = total;
+    }
+    return n < 0 ? ESP_FAIL : ESP_OK;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+        fire(client, HTTP_EVENT_DISCONNECTED, NULL, NULL);
+    }
+    client->rpos = client->rlen = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    esp_http_client_close(client);
+    free(client);
+    return ESP_OK;
+}
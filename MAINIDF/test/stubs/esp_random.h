@@ -0,0 +1,10 @@
+/* 主机测试用的 esp_random.h：libc 的伪随机数，测试可用 srand() 固定序列 */
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+static inline uint32_t esp_random(void)
+{
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
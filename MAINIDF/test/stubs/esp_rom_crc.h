@@ -0,0 +1,6 @@
+/* 主机测试用的 esp_rom_crc.h，与 ROM 中的 CRC32 结果一致 */
+#pragma once
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
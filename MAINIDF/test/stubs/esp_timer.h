@@ -0,0 +1,7 @@
+/* 主机测试用的 esp_timer.h：esp_timer_get_time 取单调时钟，实现见 esp_timer.c */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+int64_t esp_timer_get_time(void);
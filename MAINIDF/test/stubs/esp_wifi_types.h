@@ -0,0 +1,4 @@
+/* 主机测试用的 esp_wifi_types.h，只包含 wifi_mgr.h 用到的类型 */
+#pragma once
+
+typedef int wifi_auth_mode_t;
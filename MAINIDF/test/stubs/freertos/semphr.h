@@ -0,0 +1,21 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+/* 互斥锁直接用 pthread 互斥锁；二值信号量按模拟时钟阻塞，实现见 host_rtos.c */
+struct host_mutex {
+    pthread_mutex_t m;
+    bool binary;
+    bool is_static;
+    uint32_t count;
+};
+
+typedef struct host_mutex *SemaphoreHandle_t;
+typedef struct host_mutex StaticSemaphore_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+void vSemaphoreDelete(SemaphoreHandle_t sem);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+/** 不是由 xTaskCreate() 创建的线程（如测试主线程）返回 NULL */
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#define taskENTER_CRITICAL(mux)     pthread_mutex_lock(mux)
+#define taskEXIT_CRITICAL(mux)      pthread_mutex_unlock(mux)
@@ -0,0 +1,333 @@
+#include "host_rtos.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+
+#define HOST_MAX_TASKS 8
+
+struct host_task {
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *arg;
+    uint32_t notify;
+    bool blocked;
+    bool wait_notify;       // 阻塞在 ulTaskNotifyTake
+    bool (*wait_fn)(const void *obj);   // 阻塞在队列或信号量上时的就绪条件
+    const void *wait_obj;
+    TickType_t wake_at;     // portMAX_DELAY 表示不超时
+};
+
+struct host_queue {
+    uint8_t *buf;
+    UBaseType_t item_size;
+    UBaseType_t len;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static TickType_t s_tick;
+static struct host_task *s_tasks[HOST_MAX_TASKS];
+static int s_task_count;
+static __thread struct host_task *s_self;
+
+static bool task_ready(const struct host_task *t)
+{
+    if (t->wait_notify && t->notify) {
+        return true;
+    }
+    if (t->wait_fn && t->wait_fn(t->wait_obj)) {
+        return true;
+    }
+    return t->wake_at != portMAX_DELAY && s_tick >= t->wake_at;
+}
+
+/* 在 s_lock 内阻塞当前任务，直到被通知或到期 */
+static void block_locked(struct host_task *t, bool wait_notify, TickType_t wake_at)
+{
+    t->wait_notify = wait_notify;
+    t->wake_at = wake_at;
+    t->blocked = true;
+    pthread_cond_broadcast(&s_cond);
+    while (!task_ready(t)) {
+        pthread_cond_wait(&s_cond, &s_lock);
+    }
+    t->blocked = false;
+    t->wait_notify = false;
+    t->wait_fn = NULL;
+    t->wake_at = portMAX_DELAY;
+}
+
+/*
+ * 在 s_lock 内等待 ready(obj) 成立或超时。不是任务的线程（测试主线程）用临时的任务结构等待，
+ * 它不在 s_tasks 中，host_rtos_settle() 不等它
+ */
+static void wait_locked(bool (*ready)(const void *obj), const void *obj, TickType_t ticks)
+{
+    struct host_task tmp = { .wake_at = portMAX_DELAY };
+    struct host_task *t = s_self ? s_self : &tmp;
+
+    if (ready(obj) || ticks == 0) {
+        return;
+    }
+    t->wait_fn = ready;
+    t->wait_obj = obj;
+    block_locked(t, false, ticks == portMAX_DELAY ? portMAX_DELAY : s_tick + ticks);
+}
+
+static bool all_idle_locked(void)
+{
+    for (int i = 0; i < s_task_count; i++) {
+        if (!s_tasks[i]->blocked || task_ready(s_tasks[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void *task_entry(void *arg)
+{
+    s_self = arg;
+    s_self->fn(s_self->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                       UBaseType_t prio, TaskHandle_t *handle)
+{
+    struct host_task *t = calloc(1, sizeof(*t));
+    if (!t || s_task_count >= HOST_MAX_TASKS) {
+        free(t);
+        return pdFALSE;
+    }
+    t->fn = fn;
+    t->arg = arg;
+    t->wake_at = portMAX_DELAY;
+    pthread_mutex_lock(&s_lock);
+    s_tasks[s_task_count++] = t;
+    pthread_mutex_unlock(&s_lock);
+    if (handle) {
+        *handle = t;
+    }
+    pthread_create(&t->thread, NULL, task_entry, t);
+    pthread_detach(t->thread);
+    host_rtos_settle();
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    pthread_mutex_lock(&s_lock);
+    block_locked(s_self, false, s_tick + ticks);
+    pthread_mutex_unlock(&s_lock);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    pthread_mutex_lock(&s_lock);
+    TickType_t tick = s_tick;
+    pthread_mutex_unlock(&s_lock);
+    return tick;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&s_lock);
+    task->notify++;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    pthread_mutex_lock(&s_lock);
+    struct host_task *t = s_self;
+    if (!t->notify && ticks) {
+        block_locked(t, true, ticks == portMAX_DELAY ? portMAX_DELAY : s_tick + ticks);
+    }
+    uint32_t value = t->notify;
+    if (clear) {
+        t->notify = 0;
+    } else if (value) {
+        t->notify--;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return value;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return s_self;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    struct host_mutex *sem = calloc(1, sizeof(*sem));
+    if (sem) {
+        pthread_mutex_init(&sem->m, NULL);
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    struct host_mutex *sem = calloc(1, sizeof(*sem));
+    if (sem) {
+        sem->binary = true;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf)
+{
+    memset(buf, 0, sizeof(*buf));
+    buf->binary = true;
+    buf->is_static = true;
+    return buf;
+}
+
+static bool sem_available(const void *obj)
+{
+    return ((const struct host_mutex *)obj)->count > 0;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (!sem->binary) {
+        pthread_mutex_lock(&sem->m);
+        return pdTRUE;
+    }
+    pthread_mutex_lock(&s_lock);
+    wait_locked(sem_available, sem, ticks);
+    BaseType_t ok = sem->count > 0;
+    sem->count = 0;
+    pthread_mutex_unlock(&s_lock);
+    return ok;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (!sem->binary) {
+        pthread_mutex_unlock(&sem->m);
+        return pdTRUE;
+    }
+    pthread_mutex_lock(&s_lock);
+    BaseType_t ok = sem->count == 0;
+    sem->count = 1;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    return ok;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (!sem->binary) {
+        pthread_mutex_destroy(&sem->m);
+    }
+    if (!sem->is_static) {
+        free(sem);
+    }
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size)
+{
+    struct host_queue *q = calloc(1, sizeof(*q));
+    if (!q) {
+        return NULL;
+    }
+    q->buf = malloc((size_t)len * item_size);
+    if (!q->buf) {
+        free(q);
+        return NULL;
+    }
+    q->item_size = item_size;
+    q->len = len;
+    return q;
+}
+
+static bool queue_has_item(const void *obj)
+{
+    return ((const struct host_queue *)obj)->count > 0;
+}
+
+static bool queue_has_space(const void *obj)
+{
+    const struct host_queue *q = obj;
+    return q->count < q->len;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&s_lock);
+    wait_locked(queue_has_space, queue, ticks);
+    BaseType_t ok = queue->count < queue->len;
+    if (ok) {
+        UBaseType_t tail = (queue->head + queue->count) % queue->len;
+        memcpy(queue->buf + (size_t)tail * queue->item_size, item, queue->item_size);
+        queue->count++;
+        pthread_cond_broadcast(&s_cond);
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ok;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *buf, TickType_t ticks)
+{
+    pthread_mutex_lock(&s_lock);
+    wait_locked(queue_has_item, queue, ticks);
+    BaseType_t ok = queue->count > 0;
+    if (ok) {
+        memcpy(buf, queue->buf + (size_t)queue->head * queue->item_size, queue->item_size);
+        queue->head = (queue->head + 1) % queue->len;
+        queue->count--;
+        pthread_cond_broadcast(&s_cond);
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ok;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&s_lock);
+    UBaseType_t n = queue->count;
+    pthread_mutex_unlock(&s_lock);
+    return n;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    free(queue->buf);
+    free(queue);
+}
+
+void host_rtos_settle(void)
+{
+    pthread_mutex_lock(&s_lock);
+    while (!all_idle_locked()) {
+        pthread_cond_wait(&s_cond, &s_lock);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_rtos_advance_ms(uint32_t ms)
+{
+    for (TickType_t n = pdMS_TO_TICKS(ms); n > 0; n--) {
+        host_rtos_settle();
+        pthread_mutex_lock(&s_lock);
+        s_tick++;
+        pthread_cond_broadcast(&s_cond);
+        pthread_mutex_unlock(&s_lock);
+    }
+    host_rtos_settle();
+}
+
+uint32_t host_rtos_now_ms(void)
+{
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file host_rtos.h
+ * @brief 主机测试的 FreeRTOS 模拟时钟
+ *
+ * 任务是真实线程，但 tick 只在测试调用 host_rtos_advance_ms() 时前进。
+ * 前进每个 tick 后等所有任务重新阻塞，测试看到的状态与时间点一一对应。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/** 等待所有任务阻塞（已就绪的任务先运行完） */
+void host_rtos_settle(void);
+
+/**
+ * 模拟时间前进，逐 tick 唤醒到期的任务
+ * @param ms 毫秒，按 tick 向下取整
+ */
+void host_rtos_advance_ms(uint32_t ms);
+
+/** 当前模拟时间（毫秒） */
+uint32_t host_rtos_now_ms(void);
@@ -0,0 +1,190 @@
+#include "mock_nvs.h"
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+
+#define MOCK_NVS_KEYS       64
+#define MOCK_NVS_MAX_VAL    4000
+
+enum {
+    T_NONE,
+    T_I32,
+    T_U32,
+    T_STR,
+    T_BLOB,
+};
+
+typedef struct {
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    uint8_t type;       // T_NONE 表示不存在
+    size_t len;
+    uint8_t data[MOCK_NVS_MAX_VAL];
+} mock_entry_t;
+
+static mock_entry_t s_work[MOCK_NVS_KEYS];
+static mock_entry_t s_committed[MOCK_NVS_KEYS];
+static mock_nvs_counters_t s_cnt;
+
+static mock_entry_t *find(mock_entry_t *tab, const char *key, bool create)
+{
+    mock_entry_t *free_slot = NULL;
+    for (int i = 0; i < MOCK_NVS_KEYS; i++) {
+        if (tab[i].type != T_NONE && strcmp(tab[i].key, key) == 0) {
+            return &tab[i];
+        }
+        if (tab[i].type == T_NONE && !free_slot) {
+            free_slot = &tab[i];
+        }
+    }
+    if (!create || !free_slot) {
+        return NULL;
+    }
+    memset(free_slot, 0, sizeof(*free_slot));
+    strncpy(free_slot->key, key, sizeof(free_slot->key) - 1);
+    return free_slot;
+}
+
+static esp_err_t set(const char *key, uint8_t type, const void *data, size_t len)
+{
+    s_cnt.sets++;
+    if (!key || strlen(key) >= NVS_KEY_NAME_MAX_SIZE || len > MOCK_NVS_MAX_VAL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    mock_entry_t *e = find(s_work, key, false);
+    if (e && e->type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    if (!e) {
+        e = find(s_work, key, true);
+        if (!e) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    e->type = type;
+    e->len = len;
+    memcpy(e->data, data, len);
+    return ESP_OK;
+}
+
+static esp_err_t get(const char *key, uint8_t type, void *out, size_t *len)
+{
+    s_cnt.gets++;
+    mock_entry_t *e = find(s_work, key, false);
+    if (!e || e->type != type) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (!len) {
+        memcpy(out, e->data, e->len);
+        return ESP_OK;
+    }
+    size_t cap = *len;
+    *len = e->len;
+    if (!out) {
+        return ESP_OK;
+    }
+    if (cap < e->len) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out, e->data, e->len);
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    *out = 1;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
+
+esp_err_t nvs_get_i32(nvs_handle_t handle, const char *key, int32_t *out)
+{
+    return get(key, T_I32, out, NULL);
+}
+
+esp_err_t nvs_set_i32(nvs_handle_t handle, const char *key, int32_t value)
+{
+    return set(key, T_I32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out)
+{
+    return get(key, T_U32, out, NULL);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return set(key, T_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out, size_t *len)
+{
+    return get(key, T_STR, out, len);
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    return set(key, T_STR, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out, size_t *len)
+{
+    return get(key, T_BLOB, out, len);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t len)
+{
+    return set(key, T_BLOB, value, len);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    s_cnt.erases++;
+    mock_entry_t *e = find(s_work, key, false);
+    if (!e) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    e->type = T_NONE;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    s_cnt.commits++;
+    memcpy(s_committed, s_work, sizeof(s_work));
+    return ESP_OK;
+}
+
+void mock_nvs_reset(void)
+{
+    memset(s_work, 0, sizeof(s_work));
+    memset(s_committed, 0, sizeof(s_committed));
+    memset(&s_cnt, 0, sizeof(s_cnt));
+}
+
+void mock_nvs_counters(mock_nvs_counters_t *out)
+{
+    *out = s_cnt;
+}
+
+void mock_nvs_power_loss(void)
+{
+    memcpy(s_work, s_committed, sizeof(s_work));
+}
+
+bool mock_nvs_committed_i32(const char *key, int32_t *out)
+{
+    mock_entry_t *e = find(s_committed, key, false);
+    if (!e || e->type != T_I32) {
+        return false;
+    }
+    memcpy(out, e->data, sizeof(*out));
+    return true;
+}
+
+bool mock_nvs_committed_has(const char *key)
+{
+    return find(s_committed, key, false) != NULL;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file mock_nvs.h
+ * @brief 内存中的 NVS 模拟
+ *
+ * 每个键保存类型和值；nvs_set/nvs_erase 只修改工作副本，nvs_commit 后才进入已提交副本，
+ * mock_nvs_power_loss() 丢弃未提交的修改。统计各类调用次数供测试检查写放大。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    uint32_t gets;
+    uint32_t sets;
+    uint32_t erases;
+    uint32_t commits;
+} mock_nvs_counters_t;
+
+/** 清空所有键和计数 */
+void mock_nvs_reset(void);
+
+/** 读取调用计数 */
+void mock_nvs_counters(mock_nvs_counters_t *out);
+
+/** 丢弃未提交的修改，模拟掉电 */
+void mock_nvs_power_loss(void);
+
+/**
+ * 读取已提交的整数
+ * @return bool 键存在且为 i32
+ */
+bool mock_nvs_committed_i32(const char *key, int32_t *out);
+
+/**
+ * 已提交副本中是否存在该键（任意类型）
+ */
+bool mock_nvs_committed_has(const char *key);
@@ -0,0 +1,412 @@
+#include "mqtt_client.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#define HOST_PKT_MAX 1024
+
+struct esp_mqtt_client {
+    char host[64];
+    char port[8];
+    char client_id[32];
+    char will_topic[96];
+    char will_msg[32];
+    int will_qos;
+    int will_retain;
+    int keepalive;
+    esp_event_handler_t handler;
+    void *handler_arg;
+    pthread_mutex_t api_lock;   // 递归锁：发布、订阅和事件回调都持有，与 esp-mqtt 的 MQTT_API_LOCK 相同
+    pthread_mutex_t state_lock; // 保护以下字段
+    pthread_cond_t cond;
+    int fd;                     // -1 表示未连接
+    bool running;
+    bool connected;
+    bool kick;                  // esp_mqtt_client_reconnect()
+    pthread_t thread;
+    uint16_t next_id;
+};
+
+static void dispatch(esp_mqtt_client_handle_t c, esp_mqtt_event_t *evt)
+{
+    evt->client = c;
+    pthread_mutex_lock(&c->api_lock);
+    if (c->handler) {
+        c->handler(c->handler_arg, "MQTT_EVENTS", evt->event_id, evt);
+    }
+    pthread_mutex_unlock(&c->api_lock);
+}
+
+static int put_str(uint8_t *p, const char *s, size_t len)
+{
+    p[0] = len >> 8;
+    p[1] = len & 0xff;
+    memcpy(p + 2, s, len);
+    return len + 2;
+}
+
+// 发送一个报文，调用方持有 api_lock
+static int send_pkt(esp_mqtt_client_handle_t c, uint8_t type, const uint8_t *body, size_t len)
+{
+    uint8_t pkt[HOST_PKT_MAX + 5];
+    size_t n = 0, rem = len;
+
+    if (len > HOST_PKT_MAX || c->fd < 0) {
+        return -1;
+    }
+    pkt[n++] = type;
+    do {
+        uint8_t d = rem % 128;
+        rem /= 128;
+        pkt[n++] = d | (rem ? 0x80 : 0);
+    } while (rem);
+    memcpy(pkt + n, body, len);
+    n += len;
+    return send(c->fd, pkt, n, MSG_NOSIGNAL) == (ssize_t)n ? 0 : -1;
+}
+
+static bool recv_all(int fd, void *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = recv(fd, buf, len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        buf = (uint8_t *)buf + n;
+        len -= n;
+    }
+    return true;
+}
+
+static int open_socket(esp_mqtt_client_handle_t c)
+{
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, *res;
+
+    if (getaddrinfo(c->host, c->port, &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+static void send_connect(esp_mqtt_client_handle_t c)
+{
+    uint8_t body[256];
+    int n = 0;
+    bool will = c->will_topic[0] != '\0';
+
+    n += put_str(body + n, "MQTT", 4);
+    body[n++] = 4;              // 3.1.1
+    body[n++] = 0x02 | (will ? 0x04 | (c->will_qos << 3) | (c->will_retain ? 0x20 : 0) : 0);
+    body[n++] = c->keepalive >> 8;
+    body[n++] = c->keepalive & 0xff;
+    n += put_str(body + n, c->client_id, strlen(c->client_id));
+    if (will) {
+        n += put_str(body + n, c->will_topic, strlen(c->will_topic));
+        n += put_str(body + n, c->will_msg, strlen(c->will_msg));
+    }
+    pthread_mutex_lock(&c->api_lock);
+    send_pkt(c, 0x10, body, n);
+    pthread_mutex_unlock(&c->api_lock);
+}
+
+// 一次连接，直到断开；不发送心跳（测试时间远短于心跳间隔）
+static void session(esp_mqtt_client_handle_t c)
+{
+    uint8_t body[HOST_PKT_MAX];
+    int fd = open_socket(c);
+
+    if (fd < 0) {
+        return;
+    }
+    pthread_mutex_lock(&c->state_lock);
+    if (!c->running) {
+        pthread_mutex_unlock(&c->state_lock);
+        close(fd);
+        return;
+    }
+    c->fd = fd;
+    pthread_mutex_unlock(&c->state_lock);
+    send_connect(c);
+
+    while (1) {
+        uint8_t type, d;
+        size_t len = 0, mul = 1;
+        if (!recv_all(fd, &type, 1)) {
+            break;
+        }
+        do {
+            if (!recv_all(fd, &d, 1)) {
+                goto out;
+            }
+            len += (d & 127) * mul;
+            mul *= 128;
+        } while (d & 0x80);
+        if (len > sizeof(body) || !recv_all(fd, body, len)) {
+            break;
+        }
+
+        esp_mqtt_event_t evt = {0};
+        switch (type >> 4) {
+        case 2:                 // CONNACK
+            if (len < 2 || body[1] != 0) {
+                goto out;
+            }
+            pthread_mutex_lock(&c->state_lock);
+            c->connected = true;
+            pthread_mutex_unlock(&c->state_lock);
+            evt.event_id = MQTT_EVENT_CONNECTED;
+            dispatch(c, &evt);
+            break;
+        case 3: {               // PUBLISH
+            int qos = (type >> 1) & 3;
+            size_t topic_len = body[0] << 8 | body[1];
+            size_t pos = 2 + topic_len;
+            if (qos) {
+                evt.msg_id = body[pos] << 8 | body[pos + 1];
+                pos += 2;
+                pthread_mutex_lock(&c->api_lock);
+                send_pkt(c, 0x40, body + pos - 2, 2);
+                pthread_mutex_unlock(&c->api_lock);
+            }
+            evt.event_id = MQTT_EVENT_DATA;
+            evt.topic = (char *)body + 2;
+            evt.topic_len = topic_len;
+            evt.data = (char *)body + pos;
+            evt.data_len = evt.total_data_len = len - pos;
+            evt.retain = type & 1;
+            evt.qos = qos;
+            dispatch(c, &evt);
+            break;
+        }
+        case 4:                 // PUBACK
+            evt.event_id = MQTT_EVENT_PUBLISHED;
+            evt.msg_id = body[0] << 8 | body[1];
+            dispatch(c, &evt);
+            break;
+        case 9:                 // SUBACK
+            evt.event_id = MQTT_EVENT_SUBSCRIBED;
+            evt.msg_id = body[0] << 8 | body[1];
+            dispatch(c, &evt);
+            break;
+        default:
+            break;
+        }
+    }
+out:
+    pthread_mutex_lock(&c->api_lock);
+    pthread_mutex_lock(&c->state_lock);
+    close(fd);
+    c->fd = -1;
+    pthread_mutex_unlock(&c->state_lock);
+    pthread_mutex_unlock(&c->api_lock);
+}
+
+static bool is_connected(esp_mqtt_client_handle_t c)
+{
+    pthread_mutex_lock(&c->state_lock);
+    bool connected = c->connected;
+    pthread_mutex_unlock(&c->state_lock);
+    return connected;
+}
+
+// 与 disable_auto_reconnect 相同：断开后等待 esp_mqtt_client_reconnect()
+static void *client_thread(void *arg)
+{
+    esp_mqtt_client_handle_t c = arg;
+
+    while (1) {
+        session(c);
+        pthread_mutex_lock(&c->state_lock);
+        c->connected = false;
+        bool running = c->running;
+        pthread_mutex_unlock(&c->state_lock);
+        if (!running) {
+            break;
+        }
+
+        esp_mqtt_event_t evt = { .event_id = MQTT_EVENT_DISCONNECTED };
+        dispatch(c, &evt);
+
+        pthread_mutex_lock(&c->state_lock);
+        while (c->running && !c->kick) {
+            pthread_cond_wait(&c->cond, &c->state_lock);
+        }
+        c->kick = false;
+        running = c->running;
+        pthread_mutex_unlock(&c->state_lock);
+        if (!running) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config)
+{
+    struct esp_mqtt_client *c = calloc(1, sizeof(*c));
+    const char *uri = config->broker.address.uri;
+
+    if (!c) {
+        return NULL;
+    }
+    if (!uri || sscanf(uri, "mqtt://%63[^:/]:%7[0-9]", c->host, c->port) != 2) {
+        free(c);
+        return NULL;
+    }
+    snprintf(c->client_id, sizeof(c->client_id), "%s", config->credentials.client_id);
+    if (config->session.last_will.topic) {
+        snprintf(c->will_topic, sizeof(c->will_topic), "%s", config->session.last_will.topic);
+        snprintf(c->will_msg, sizeof(c->will_msg), "%s", config->session.last_will.msg);
+        c->will_qos = config->session.last_will.qos;
+        c->will_retain = config->session.last_will.retain;
+    }
+    c->keepalive = config->session.keepalive;
+    c->fd = -1;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&c->api_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    pthread_mutex_init(&c->state_lock, NULL);
+    pthread_cond_init(&c->cond, NULL);
+    return c;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void *arg)
+{
+    client->handler = handler;
+    client->handler_arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client)
+{
+    pthread_mutex_lock(&client->state_lock);
+    if (client->running) {
+        pthread_mutex_unlock(&client->state_lock);
+        return ESP_FAIL;
+    }
+    client->running = true;
+    client->kick = false;
+    pthread_mutex_unlock(&client->state_lock);
+    if (pthread_create(&client->thread, NULL, client_thread, client) != 0) {
+        client->running = false;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// 与 esp-mqtt 相同：已连接时发送 DISCONNECT（服务器不发布遗嘱），不回调 MQTT_EVENT_DISCONNECTED
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client)
+{
+    pthread_mutex_lock(&client->state_lock);
+    if (!client->running) {
+        pthread_mutex_unlock(&client->state_lock);
+        return ESP_FAIL;
+    }
+    pthread_mutex_unlock(&client->state_lock);
+
+    pthread_mutex_lock(&client->api_lock);
+    if (is_connected(client)) {
+        send_pkt(client, 0xe0, NULL, 0);
+    }
+    pthread_mutex_lock(&client->state_lock);
+    client->running = false;
+    if (client->fd >= 0) {
+        shutdown(client->fd, SHUT_RDWR);
+    }
+    pthread_cond_broadcast(&client->cond);
+    pthread_mutex_unlock(&client->state_lock);
+    pthread_mutex_unlock(&client->api_lock);
+
+    pthread_join(client->thread, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_reconnect(esp_mqtt_client_handle_t client)
+{
+    pthread_mutex_lock(&client->state_lock);
+    client->kick = true;
+    pthread_cond_broadcast(&client->cond);
+    pthread_mutex_unlock(&client->state_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client)
+{
+    esp_mqtt_client_stop(client);
+    pthread_mutex_destroy(&client->api_lock);
+    pthread_mutex_destroy(&client->state_lock);
+    pthread_cond_destroy(&client->cond);
+    free(client);
+    return ESP_OK;
+}
+
+static uint16_t next_id(esp_mqtt_client_handle_t c)
+{
+    if (++c->next_id == 0) {
+        c->next_id = 1;
+    }
+    return c->next_id;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *topic, int qos)
+{
+    uint8_t body[HOST_PKT_MAX];
+    size_t topic_len = strlen(topic);
+    int n = 0;
+
+    if (topic_len + 5 > sizeof(body)) {
+        return -1;
+    }
+    pthread_mutex_lock(&client->api_lock);
+    uint16_t id = next_id(client);
+    body[n++] = id >> 8;
+    body[n++] = id & 0xff;
+    n += put_str(body + n, topic, topic_len);
+    body[n++] = qos;
+    int ret = is_connected(client) && send_pkt(client, 0x82, body, n) == 0 ? id : -1;
+    pthread_mutex_unlock(&client->api_lock);
+    return ret;
+}
+
+// 未连接时返回 -1，不排队
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos,
+                            int retain)
+{
+    uint8_t body[HOST_PKT_MAX];
+    size_t topic_len = strlen(topic);
+    int n = 0;
+
+    if (len == 0 && data) {
+        len = strlen(data);
+    }
+    if (topic_len + len + 4 > sizeof(body)) {
+        return -1;
+    }
+    pthread_mutex_lock(&client->api_lock);
+    uint16_t id = 0;
+    n += put_str(body + n, topic, topic_len);
+    if (qos) {
+        id = next_id(client);
+        body[n++] = id >> 8;
+        body[n++] = id & 0xff;
+    }
+    memcpy(body + n, data, len);
+    n += len;
+    int ret = is_connected(client) && send_pkt(client, 0x30 | (qos << 1) | (retain ? 1 : 0), body, n) == 0 ? id : -1;
+    pthread_mutex_unlock(&client->api_lock);
+    return ret;
+}
@@ -0,0 +1,2 @@
+/* 主机测试用的 sdkconfig.h：不启用任何可选功能（证书包、TLS 会话票据等） */
+#pragma once
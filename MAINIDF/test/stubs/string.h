@@ -0,0 +1,9 @@
+/* 主机测试用的 string.h：ESP-IDF 的 newlib 提供 strlcpy，glibc 2.38 之前没有 */
+#pragma once
+
+#include_next <string.h>
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+#define HOST_NEED_STRLCPY 1
+size_t strlcpy(char *dst, const char *src, size_t size);
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file test_alarm_heap.c
+ * @brief alarm_heap 主机测试：随机操作与参考实现（线性扫描）对比，每步检查堆性质和位置表；
+ *        以及与线性扫描的耗时对比
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "alarm_heap.h"
+
+#define CAP_MAX     1024
+#define NO_KEY      INT64_MIN
+
+static alarm_heap_node_t s_nodes[CAP_MAX];
+static uint16_t s_pos[CAP_MAX];
+static int64_t s_ref[CAP_MAX];      // 参考实现：按 id 保存截止时间，NO_KEY 表示不在堆中
+
+static uint32_t s_rng = 7;
+
+static uint32_t next_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// 参考实现中最早的元素，截止时间相同时 id 小的在前
+static int ref_min(uint16_t cap)
+{
+    int best = -1;
+
+    for (int i = 0; i < cap; i++) {
+        if (s_ref[i] != NO_KEY && (best < 0 || s_ref[i] < s_ref[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// 堆性质、位置表与参考实现一致
+static bool check_heap(const alarm_heap_t *h)
+{
+    uint16_t count = 0;
+
+    for (uint16_t id = 0; id < h->cap; id++) {
+        if (s_ref[id] == NO_KEY) {
+            if (h->pos[id] != ALARM_HEAP_NONE) {
+                TEST_FAIL("id %u should not be in the heap", id);
+                return false;
+            }
+            continue;
+        }
+        count++;
+        uint16_t i = h->pos[id];
+        if (i >= h->size || h->nodes[i].id != id || h->nodes[i].key != s_ref[id]) {
+            TEST_FAIL("id %u: pos %u, size %u", id, i, h->size);
+            return false;
+        }
+    }
+    if (count != h->size) {
+        TEST_FAIL("size %u, expected %u", h->size, count);
+        return false;
+    }
+    for (uint16_t i = 1; i < h->size; i++) {
+        const alarm_heap_node_t *p = &h->nodes[(i - 1) / 2], *c = &h->nodes[i];
+        if (c->key < p->key || (c->key == p->key && c->id < p->id)) {
+            TEST_FAIL("heap order broken at %u", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_basic(void)
+{
+    alarm_heap_t h;
+    alarm_heap_node_t top;
+
+    alarm_heap_init(&h, s_nodes, s_pos, 8);
+    TEST_ASSERT(!alarm_heap_peek(&h, &top));
+    TEST_ASSERT(!alarm_heap_pop(&h, NULL));
+    TEST_ASSERT(!alarm_heap_remove(&h, 3));
+    TEST_ASSERT(!alarm_heap_set(&h, 8, 100));      // 超出容量
+    TEST_ASSERT(!alarm_heap_contains(&h, 8));
+
+    TEST_ASSERT(alarm_heap_set(&h, 5, 300));
+    TEST_ASSERT(alarm_heap_set(&h, 2, 100));
+    TEST_ASSERT(alarm_heap_set(&h, 7, 200));
+    TEST_ASSERT(alarm_heap_peek(&h, &top) && top.id == 2 && top.key == 100);
+
+    // 修改已有元素：推后、提前
+    TEST_ASSERT(alarm_heap_set(&h, 2, 400));
+    TEST_ASSERT(alarm_heap_peek(&h, &top) && top.id == 7);
+    TEST_ASSERT(alarm_heap_set(&h, 5, 50));
+    TEST_ASSERT(alarm_heap_peek(&h, &top) && top.id == 5);
+    TEST_ASSERT_EQ_INT(3, h.size);
+
+    // 截止时间相同时按 id，与插入顺序无关
+    TEST_ASSERT(alarm_heap_set(&h, 7, 50));
+    TEST_ASSERT(alarm_heap_pop(&h, &top) && top.id == 5);
+    TEST_ASSERT(alarm_heap_pop(&h, &top) && top.id == 7);
+    TEST_ASSERT(alarm_heap_pop(&h, &top) && top.id == 2 && top.key == 400);
+    TEST_ASSERT(!alarm_heap_pop(&h, &top));
+    for (uint16_t id = 0; id < 8; id++) {
+        TEST_ASSERT(!alarm_heap_contains(&h, id));
+    }
+}
+
+/* 随机插入、修改、删除、弹出，每步与参考实现对比 */
+static void test_random_ops(void)
+{
+    static const uint16_t caps[] = { 1, 2, 3, 20, 257, CAP_MAX };
+
+    for (size_t c = 0; c < sizeof(caps) / sizeof(caps[0]); c++) {
+        uint16_t cap = caps[c];
+        alarm_heap_t h;
+
+        alarm_heap_init(&h, s_nodes, s_pos, cap);
+        for (uint16_t i = 0; i < cap; i++) {
+            s_ref[i] = NO_KEY;
+        }
+        int steps = cap < 64 ? 20000 : 100000;
+        for (int step = 0; step < steps; step++) {
+            uint32_t r = next_rand();
+            uint16_t id = (r >> 8) % cap;
+            // 截止时间取值范围小，制造大量相等的键
+            int64_t key = (int64_t)(next_rand() % 64) * 1000000 - 32000000;
+
+            switch (r % 4) {
+            case 0:
+            case 1:
+                alarm_heap_set(&h, id, key);
+                s_ref[id] = key;
+                break;
+            case 2:
+                TEST_ASSERT(alarm_heap_remove(&h, id) == (s_ref[id] != NO_KEY));
+                s_ref[id] = NO_KEY;
+                break;
+            case 3: {
+                alarm_heap_node_t top;
+                int exp = ref_min(cap);
+                TEST_ASSERT(alarm_heap_pop(&h, &top) == (exp >= 0));
+                if (exp >= 0) {
+                    TEST_ASSERT(top.id == exp && top.key == s_ref[exp]);
+                    s_ref[exp] = NO_KEY;
+                }
+                break;
+            }
+            }
+            // 大容量时每 97 步检查一次，保持测试时间短
+            if ((cap < 64 || step % 97 == 0) && !check_heap(&h)) {
+                printf("  cap %u step %d\n", cap, step);
+                break;
+            }
+        }
+    }
+}
+
+/* 全部弹出的顺序就是排序结果 */
+static void test_drain_sorted(void)
+{
+    alarm_heap_t h;
+    alarm_heap_node_t prev = { .key = INT64_MIN, .id = 0 }, top;
+
+    alarm_heap_init(&h, s_nodes, s_pos, CAP_MAX);
+    for (uint16_t id = 0; id < CAP_MAX; id++) {
+        alarm_heap_set(&h, id, (int64_t)(next_rand() % 500));
+    }
+    int n = 0;
+    while (alarm_heap_pop(&h, &top)) {
+        TEST_ASSERT(top.key > prev.key || (top.key == prev.key && top.id > prev.id) || n == 0);
+        prev = top;
+        n++;
+    }
+    TEST_ASSERT_EQ_INT(CAP_MAX, n);
+}
+
+/*
+ * 模拟闹钟任务的负载：n 个元素，反复取出最早的并按新的截止时间放回，
+ * 与每次线性扫描全部截止时间对比
+ */
+static void test_bench(void)
+{
+    static const uint16_t sizes[] = { 8, 20, 64, 256, 1024 };
+    static int64_t keys[CAP_MAX];
+    const int ops = 200000;
+    volatile int64_t sink = 0;
+
+    printf("  %6s %12s %12s\n", "n", "heap ns/op", "scan ns/op");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint16_t n = sizes[s];
+        alarm_heap_t h;
+        alarm_heap_node_t top;
+
+        alarm_heap_init(&h, s_nodes, s_pos, n);
+        for (uint16_t i = 0; i < n; i++) {
+            keys[i] = (int64_t)(next_rand() % 1000000);
+            alarm_heap_set(&h, i, keys[i]);
+        }
+        int64_t t0 = esp_timer_get_time();
+        for (int k = 0; k < ops; k++) {
+            alarm_heap_peek(&h, &top);
+            alarm_heap_set(&h, top.id, top.key + 1 + next_rand() % 1000000);
+        }
+        int64_t t1 = esp_timer_get_time();
+        for (int k = 0; k < ops; k++) {
+            uint16_t best = 0;
+            for (uint16_t i = 1; i < n; i++) {
+                if (keys[i] < keys[best]) {
+                    best = i;
+                }
+            }
+            keys[best] += 1 + next_rand() % 1000000;
+        }
+        int64_t t2 = esp_timer_get_time();
+        sink += keys[0] + top.key;
+
+        printf("  %6u %12.1f %12.1f\n", n, (t1 - t0) * 1000.0 / ops, (t2 - t1) * 1000.0 / ops);
+    }
+    (void)sink;
+}
+
+int main(void)
+{
+    RUN_TEST(test_basic);
+    RUN_TEST(test_random_ops);
+    RUN_TEST(test_drain_sorted);
+    RUN_TEST(test_bench);
+    return TEST_EXIT();
+}
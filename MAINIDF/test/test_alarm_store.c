@@ -0,0 +1,283 @@
+/*
+ * alarm_store 掉电测试
+ * 链接时用 --wrap 接管 write/rename/unlink/fsync：写入字节数达到预算后"掉电"，之后的写入、
+ * 重命名和删除全部失败。对一组固定的修改序列，在每一个字节位置掉电一次，
+ * 重新打开后的闹钟列表必须等于掉电时正在进行的那次修改之前或之后的列表。
+ * ALARM_STORE_COMPACT_SIZE 在 CMakeLists.txt 中调小，使序列中包含多次快照和压缩。
+ */
+#include "test_common.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include "esp_log.h"
+#include "alarm_store.h"
+
+#define SCRIPT_OPS  120
+#define CUT_OPS     60      // 掉电测试的步数，耗时与步数的平方成正比
+
+ssize_t __real_write(int fd, const void *buf, size_t n);
+int __real_rename(const char *from, const char *to);
+int __real_unlink(const char *path);
+
+static long s_budget = -1;      // 剩余可写字节数，-1 表示不限
+static long s_written;          // 累计写入字节数
+static bool s_dead;
+
+ssize_t __wrap_write(int fd, const void *buf, size_t n)
+{
+    if (s_dead) {
+        errno = EIO;
+        return -1;
+    }
+    if (s_budget >= 0 && (long)n >= s_budget) {
+        ssize_t r = s_budget ? __real_write(fd, buf, s_budget) : 0;
+        s_written += s_budget;
+        s_budget = 0;
+        s_dead = true;
+        if (r > 0) {
+            return r;
+        }
+        errno = EIO;
+        return -1;
+    }
+    ssize_t r = __real_write(fd, buf, n);
+    if (r > 0) {
+        s_written += r;
+        if (s_budget > 0) {
+            s_budget -= r;
+        }
+    }
+    return r;
+}
+
+int __wrap_rename(const char *from, const char *to)
+{
+    if (s_dead) {
+        errno = EIO;
+        return -1;
+    }
+    return __real_rename(from, to);
+}
+
+int __wrap_unlink(const char *path)
+{
+    if (s_dead) {
+        errno = EIO;
+        return -1;
+    }
+    return __real_unlink(path);
+}
+
+int __wrap_fsync(int fd)
+{
+    // 掉电以 write 为粒度模拟，不需要真的刷盘
+    return s_dead ? (errno = EIO, -1) : 0;
+}
+
+static void power_on(void)
+{
+    s_budget = -1;
+    s_dead = false;
+}
+
+/* ---------------- 参照模型 ---------------- */
+
+typedef struct {
+    uint8_t count;
+    alarm_cfg_t alarms[ALARM_MAX];
+} model_t;
+
+static bool model_eq(const model_t *m, const alarm_cfg_t *alarms, uint8_t count)
+{
+    return m->count == count && memcmp(m->alarms, alarms, count * sizeof(alarm_cfg_t)) == 0;
+}
+
+static alarm_cfg_t make_cfg(uint32_t n)
+{
+    alarm_cfg_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.hour = n % 24;
+    cfg.minute = (n * 7) % 60;
+    cfg.days = n % 0x80;
+    cfg.enabled = n & 1;
+    snprintf(cfg.label, sizeof(cfg.label), "op%lu", (unsigned long)n);
+    return cfg;
+}
+
+/* 对存储和模型执行第 n 步，返回存储的结果 */
+static esp_err_t script_step(alarm_store_t *st, model_t *m, uint32_t n, uint32_t *rng)
+{
+    *rng = *rng * 1103515245 + 12345;
+    uint32_t r = *rng >> 16;
+    alarm_cfg_t cfg = make_cfg(n);
+
+    if (m->count == 0 || (m->count < ALARM_MAX && r % 3 == 0)) {
+        m->alarms[m->count++] = cfg;
+        return alarm_store_put(st, m->alarms, m->count, m->count - 1);
+    }
+    uint8_t i = (r / 3) % m->count;
+    if (r % 3 == 1) {
+        m->alarms[i] = cfg;
+        return alarm_store_put(st, m->alarms, m->count, i);
+    }
+    memmove(&m->alarms[i], &m->alarms[i + 1], (m->count - i - 1) * sizeof(alarm_cfg_t));
+    m->count--;
+    return alarm_store_remove(st, m->alarms, m->count, i);
+}
+
+static char s_path[64];
+static char s_tmp[72];
+
+static void reset_files(void)
+{
+    power_on();
+    unlink(s_path);
+    unlink(s_tmp);
+}
+
+static bool reopen_matches(const model_t *m)
+{
+    alarm_store_t st;
+    alarm_cfg_t alarms[ALARM_MAX];
+    uint8_t count;
+
+    power_on();
+    if (alarm_store_open(&st, s_path, alarms, &count) != ESP_OK) {
+        return false;
+    }
+    alarm_store_close(&st);
+    return model_eq(m, alarms, count);
+}
+
+/* 不掉电：每一步后重新打开都与模型一致，快照后文件不再增长 */
+static void test_replay_and_compaction(void)
+{
+    alarm_store_t st;
+    alarm_cfg_t alarms[ALARM_MAX];
+    uint8_t count;
+    model_t m = { 0 };
+    uint32_t rng = 1;
+
+    reset_files();
+    TEST_ASSERT_EQ_INT(ESP_OK, alarm_store_open(&st, s_path, alarms, &count));
+    TEST_ASSERT_EQ_INT(0, count);
+    for (uint32_t n = 0; n < SCRIPT_OPS; n++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, script_step(&st, &m, n, &rng));
+        TEST_ASSERT(st.j.size <= ALARM_STORE_COMPACT_SIZE);
+        if (n % 10 == 9) {
+            alarm_store_close(&st);
+            TEST_ASSERT(reopen_matches(&m));
+            TEST_ASSERT_EQ_INT(ESP_OK, alarm_store_open(&st, s_path, alarms, &count));
+        }
+    }
+    alarm_store_close(&st);
+    TEST_ASSERT(reopen_matches(&m));
+    TEST_ASSERT(st.base_gen > 0);
+    printf("  %lu bytes after %d changes, snapshot gen %lu\n",
+           (unsigned long)st.j.size, SCRIPT_OPS, (unsigned long)st.base_gen);
+}
+
+/* 在每个字节位置掉电 */
+static void test_cut_every_byte(void)
+{
+    long total;
+    {
+        alarm_store_t st;
+        alarm_cfg_t alarms[ALARM_MAX];
+        uint8_t count;
+        model_t m = { 0 };
+        uint32_t rng = 7;
+
+        reset_files();
+        s_written = 0;
+        alarm_store_open(&st, s_path, alarms, &count);
+        for (uint32_t n = 0; n < CUT_OPS; n++) {
+            script_step(&st, &m, n, &rng);
+        }
+        alarm_store_close(&st);
+        total = s_written;
+    }
+
+    int as_before = 0, as_after = 0, bad = 0;
+    host_log_level = ESP_LOG_NONE;     // 每次掉电都会打印写入失败和截断尾部
+    for (long cut = 0; cut <= total; cut++) {
+        alarm_store_t st;
+        alarm_cfg_t alarms[ALARM_MAX];
+        uint8_t count;
+        model_t m = { 0 }, before = { 0 };
+        uint32_t rng = 7;
+
+        reset_files();
+        s_budget = cut;
+        alarm_store_open(&st, s_path, alarms, &count);
+        for (uint32_t n = 0; n < CUT_OPS && !s_dead; n++) {
+            before = m;
+            script_step(&st, &m, n, &rng);
+        }
+        alarm_store_close(&st);
+
+        if (reopen_matches(&m)) {
+            as_after++;
+        } else if (reopen_matches(&before)) {
+            as_before++;
+        } else {
+            if (bad++ < 5) {
+                TEST_FAIL("cut at byte %ld of %ld: list matches neither side of the interrupted change", cut, total);
+            }
+        }
+    }
+    host_log_level = ESP_LOG_INFO;
+    TEST_ASSERT_EQ_INT(0, bad);
+    printf("  %ld cut points: %d kept the interrupted change, %d rolled it back\n",
+           total + 1, as_after, as_before);
+}
+
+/* 掉电后重新打开不会丢失已完成的修改，之后可以继续写入 */
+static void test_continue_after_cut(void)
+{
+    alarm_store_t st;
+    alarm_cfg_t alarms[ALARM_MAX];
+    uint8_t count;
+    model_t m = { 0 };
+    uint32_t rng = 3;
+
+    reset_files();
+    alarm_store_open(&st, s_path, alarms, &count);
+    for (uint32_t n = 0; n < 20; n++) {
+        script_step(&st, &m, n, &rng);
+    }
+    model_t done = m;
+    s_budget = 5;                   // 下一条记录只写入 5 字节
+    script_step(&st, &m, 20, &rng);
+    alarm_store_close(&st);
+
+    power_on();
+    TEST_ASSERT_EQ_INT(ESP_OK, alarm_store_open(&st, s_path, alarms, &count));
+    TEST_ASSERT(model_eq(&done, alarms, count));
+    TEST_ASSERT(st.j.stats.recovered_bytes > 0);
+    m = done;
+    for (uint32_t n = 21; n < 60; n++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, script_step(&st, &m, n, &rng));
+    }
+    alarm_store_close(&st);
+    TEST_ASSERT(reopen_matches(&m));
+}
+
+int main(void)
+{
+    char dir[] = "/tmp/alarm_store.XXXXXX";
+    if (!mkdtemp(dir)) {
+        return 1;
+    }
+    snprintf(s_path, sizeof(s_path), "%s/alarms.jnl", dir);
+    snprintf(s_tmp, sizeof(s_tmp), "%s" SYS_FILE_TMP_SUFFIX, s_path);
+
+    RUN_TEST(test_replay_and_compaction);
+    RUN_TEST(test_continue_after_cut);
+    RUN_TEST(test_cut_every_byte);
+
+    reset_files();
+    rmdir(dir);
+    return TEST_EXIT();
+}
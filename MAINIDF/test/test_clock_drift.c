@@ -0,0 +1,305 @@
+/**
+ * @file test_clock_drift.c
+ * @brief clock_drift 主机测试：估计器本身，以及按 timesync 的流程模拟一周的晶振漂移
+ *
+ * 模拟模型：
+ * - 本地单调时钟比真实时间快 true_ppm，随温度按日周期变化
+ * - 系统时间 = 单调时钟 + 偏移 + 已完成的 adjtime 调整，
+ *   adjtime 按 ESP-IDF 的实现以 1/64 的速率完成（ADJTIME_CORRECTION_FACTOR 6）
+ * - 对时应答带 ±20 ms 的网络抖动
+ * 对时、直接设置/平滑调整、漂移补偿和对时间隔都走 timesync.c 使用的 clock_drift 接口。
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "test_common.h"
+#include "clock_drift.h"
+#include "timesync.h"
+
+#define STEP_MS         60000                   // 与 timesync.c 的 STEP_THRESHOLD_MS 一致
+#define SIM_DT_US       1000000LL               // 模拟步长 1 s
+#define DAY_US          (24 * 3600 * 1000000LL)
+#define ADJ_SHIFT       6
+
+typedef struct {
+    /* 真实世界 */
+    double real_us;
+    double base_ppm;
+    double swing_ppm;       // 日温差带来的漂移变化幅度
+    uint32_t rng;
+    /* 设备 */
+    int64_t mono_us;
+    int64_t sys_off_us;     // 系统时间 = mono + sys_off + adj_done
+    int64_t adj_pending_us;
+    bool valid;
+    int64_t next_sync_us;
+    int64_t last_trim_us;
+    clock_drift_t drift;
+    /* 统计 */
+    uint32_t syncs;
+    uint32_t steps;
+    uint32_t slews;
+    double max_err_us;      // 首次平滑调整之后系统时间与真实时间的最大偏差
+    bool settled;
+} sim_t;
+
+static double true_ppm(const sim_t *s)
+{
+    return s->base_ppm + s->swing_ppm * sin(2 * M_PI * s->real_us / DAY_US);
+}
+
+static int64_t sys_time(const sim_t *s)
+{
+    return s->mono_us + s->sys_off_us;
+}
+
+static int32_t jitter_us(sim_t *s)
+{
+    s->rng = s->rng * 1103515245u + 12345u;
+    return (int32_t)((s->rng >> 8) % 40001) - 20000;
+}
+
+static void sim_init(sim_t *s, double base_ppm, double swing_ppm)
+{
+    memset(s, 0, sizeof(*s));
+    s->real_us = 1.7e15;        // 2023 年末，系统时间从 0 开始，无效
+    s->base_ppm = base_ppm;
+    s->swing_ppm = swing_ppm;
+    s->rng = 1;
+    clock_drift_init(&s->drift, 0, 0, 0);
+}
+
+static void sim_sync(sim_t *s)
+{
+    int64_t server = (int64_t)s->real_us + jitter_us(s);
+    int64_t offset = sys_time(s) - server;
+
+    if (clock_drift_need_step(s->valid, offset, STEP_MS * 1000LL)) {
+        s->sys_off_us = server - s->mono_us;
+        s->adj_pending_us = 0;  // settimeofday 取消未完成的调整
+        s->steps++;
+    } else {
+        s->adj_pending_us = -offset;
+        s->slews++;
+        s->settled = true;
+    }
+    s->valid = true;
+    s->last_trim_us = s->mono_us;
+    clock_drift_update(&s->drift, s->mono_us, server);
+    s->next_sync_us = s->mono_us + clock_drift_interval_ms(&s->drift, TIMESYNC_TOLERANCE_MS,
+                                                           TIMESYNC_MIN_INTERVAL_MS,
+                                                           TIMESYNC_MAX_INTERVAL_MS) * 1000LL;
+    s->syncs++;
+}
+
+static void sim_run(sim_t *s, int64_t duration_us)
+{
+    int64_t end = s->mono_us + duration_us;
+
+    while (s->mono_us < end) {
+        s->mono_us += SIM_DT_US;
+        s->real_us += SIM_DT_US / (1 + true_ppm(s) / 1e6);
+
+        // adjtime 以 1/64 的速率完成
+        int64_t step = SIM_DT_US >> ADJ_SHIFT;
+        int64_t adj = llabs(s->adj_pending_us) < step ? s->adj_pending_us
+                      : (s->adj_pending_us > 0 ? step : -step);
+        s->sys_off_us += adj;
+        s->adj_pending_us -= adj;
+
+        if (s->mono_us >= s->next_sync_us) {
+            sim_sync(s);
+        }
+        if (s->valid && s->drift.samples > 0 && s->mono_us >= s->last_trim_us + TIMESYNC_TRIM_MS * 1000LL) {
+            s->adj_pending_us = clock_drift_trim_us(&s->drift, s->mono_us - s->last_trim_us, s->adj_pending_us);
+            s->last_trim_us = s->mono_us;
+        }
+        if (s->settled) {
+            double err = fabs((double)sys_time(s) - s->real_us);
+            if (err > s->max_err_us) {
+                s->max_err_us = err;
+            }
+        }
+    }
+}
+
+static void test_init_rejects_bad_history(void)
+{
+    clock_drift_t d;
+
+    clock_drift_init(&d, 12.5f, 1.0f, 7);
+    TEST_ASSERT(d.ppm == 12.5f && d.err_ppm == 1.0f && d.samples == 7);
+
+    clock_drift_init(&d, 12.5f, 0, 7);          // 没有历史
+    TEST_ASSERT(d.ppm == 0 && d.err_ppm == CLOCK_DRIFT_INIT_ERR_PPM && d.samples == 0);
+    clock_drift_init(&d, 900.0f, 1.0f, 7);      // 不可能的漂移率
+    TEST_ASSERT(d.ppm == 0 && d.samples == 0);
+    clock_drift_init(&d, 1.0f, 80.0f, 7);       // 不确定度比没有历史还大
+    TEST_ASSERT(d.err_ppm == CLOCK_DRIFT_INIT_ERR_PPM && d.samples == 0);
+}
+
+static void test_short_span_keeps_reference(void)
+{
+    clock_drift_t d;
+    const int64_t t0 = 1000000000000LL;
+
+    clock_drift_init(&d, 0, 0, 0);
+    TEST_ASSERT(!clock_drift_update(&d, 0, t0));
+    TEST_ASSERT(!clock_drift_update(&d, 60000000, t0 + 60000000));
+    TEST_ASSERT_EQ_INT(0, d.ref_mono_us);       // 参考点不变，下次基线更长
+
+    // 1 h 快 36 ms = 10 ppm；样本误差约 ±28 ppm，按方差加权只拉过去约 3/4
+    TEST_ASSERT(clock_drift_update(&d, 3600036000LL, t0 + 3600000000LL));
+    TEST_ASSERT(d.ppm > 7.0f && d.ppm < 8.0f);
+    TEST_ASSERT_EQ_INT(1, d.samples);
+}
+
+static void test_outlier_rejected_then_relaxed(void)
+{
+    clock_drift_t d;
+    int64_t mono = 0, t = 0;
+    const int64_t h = 3600000000LL;
+
+    clock_drift_init(&d, 0, 0, 0);
+    clock_drift_update(&d, mono, t);
+    for (int i = 0; i < 6; i++) {
+        mono += h + 18000;      // 5 ppm
+        t += h;
+        clock_drift_update(&d, mono, t);
+    }
+    float before = d.ppm;
+    TEST_ASSERT(fabsf(before - 5.0f) < 1.0f);
+
+    // 时间被外部改了 10 s：丢弃，不影响估计，但放宽不确定度
+    float err = d.err_ppm;
+    mono += h + 18000;
+    t += h + 10000000;
+    TEST_ASSERT(!clock_drift_update(&d, mono, t));
+    TEST_ASSERT_EQ_INT(1, d.outliers);
+    TEST_ASSERT(d.ppm == before);
+    TEST_ASSERT(d.err_ppm == err * 2);
+
+    // 换了晶振（-40 ppm）：放宽后的不确定度接受新样本，估计向新值收敛
+    for (int i = 0; i < 40; i++) {
+        mono += h - 144000;
+        t += h;
+        clock_drift_update(&d, mono, t);
+    }
+    TEST_ASSERT_EQ_INT(1, d.outliers);
+    TEST_ASSERT(fabsf(d.ppm + 40.0f) < 2 * d.err_ppm);
+}
+
+static void test_predict_and_trim(void)
+{
+    clock_drift_t d;
+
+    clock_drift_init(&d, 20.0f, 1.0f, 3);
+    TEST_ASSERT_EQ_INT(12000, clock_drift_predict_us(&d, 600000000LL));     // 10 min 快 12 ms
+    TEST_ASSERT_EQ_INT(-12000, clock_drift_trim_us(&d, 600000000LL, 0));
+    TEST_ASSERT_EQ_INT(-2000, clock_drift_trim_us(&d, 600000000LL, 10000)); // 在未完成的调整上扣除
+}
+
+static void test_interval_clamped(void)
+{
+    clock_drift_t d;
+
+    clock_drift_init(&d, 0, 0, 0);
+    TEST_ASSERT_EQ_INT(TIMESYNC_MIN_INTERVAL_MS,
+                       clock_drift_interval_ms(&d, 1, TIMESYNC_MIN_INTERVAL_MS, TIMESYNC_MAX_INTERVAL_MS));
+    d.err_ppm = 0.01f;
+    TEST_ASSERT_EQ_INT(TIMESYNC_MAX_INTERVAL_MS,
+                       clock_drift_interval_ms(&d, 500, TIMESYNC_MIN_INTERVAL_MS, TIMESYNC_MAX_INTERVAL_MS));
+    d.err_ppm = 100.0f;         // 500 ms / 100 ppm = 5000 s
+    TEST_ASSERT_EQ_INT(5000000, clock_drift_interval_ms(&d, 500, 0, TIMESYNC_MAX_INTERVAL_MS));
+}
+
+static void test_need_step(void)
+{
+    const int64_t th = STEP_MS * 1000LL;
+
+    TEST_ASSERT(clock_drift_need_step(false, 0, th));          // 时间无效
+    TEST_ASSERT(!clock_drift_need_step(true, th, th));
+    TEST_ASSERT(clock_drift_need_step(true, th + 1, th));
+    TEST_ASSERT(clock_drift_need_step(true, -th - 1, th));
+    TEST_ASSERT(!clock_drift_need_step(true, -th, th));
+}
+
+/* 一周 +35 ppm、日温差 ±3 ppm：首次直接设置，之后只平滑调整，误差不超过容限 */
+static void test_sim_week_slew(void)
+{
+    static sim_t s;
+
+    sim_init(&s, 35.0, 3.0);
+    sim_sync(&s);
+    sim_run(&s, 7 * DAY_US);
+
+    printf("  %u syncs (%u step, %u slew), drift %.2f +/- %.2f ppm, max error %.0f ms, interval %lld min\n",
+           (unsigned)s.syncs, (unsigned)s.steps, (unsigned)s.slews, s.drift.ppm, s.drift.err_ppm,
+           s.max_err_us / 1000, (long long)((s.next_sync_us - s.mono_us) / 60000000));
+    TEST_ASSERT_EQ_INT(1, s.steps);
+    TEST_ASSERT(s.slews >= 3);
+    TEST_ASSERT(fabs(s.drift.ppm - 35.0) < 4.0);
+    TEST_ASSERT(s.max_err_us < TIMESYNC_TOLERANCE_MS * 1000.0);
+    // 估计收敛后不再每 30 分钟对时
+    TEST_ASSERT(s.syncs < 7 * 24 * 2 / 4);
+}
+
+/* 没有漂移补偿时同样的晶振一周内积累的误差远超容限，说明上面的结果来自补偿 */
+static void test_sim_without_trim_drifts(void)
+{
+    static sim_t s;
+
+    sim_init(&s, 35.0, 3.0);
+    sim_sync(&s);
+    s.next_sync_us = INT64_MAX;
+    s.drift.samples = 0;        // 没有样本时 timesync 不做补偿
+    sim_run(&s, DAY_US);
+    double err = fabs((double)sys_time(&s) - s.real_us);
+    TEST_ASSERT(err > 35e-6 * DAY_US * 0.9);
+}
+
+/* 时间被改动超过阈值：直接设置，漂移估计按单调时钟计算，不受影响 */
+static void test_sim_step_after_jump(void)
+{
+    static sim_t s;
+
+    sim_init(&s, -18.0, 1.0);
+    sim_sync(&s);
+    sim_run(&s, 3 * DAY_US);
+    float ppm = s.drift.ppm;
+    uint32_t steps = s.steps;
+    uint16_t outliers = s.drift.outliers;
+
+    s.sys_off_us += 2 * 3600 * 1000000LL;       // 用户手动把时间改快 2 小时
+    s.next_sync_us = s.mono_us + SIM_DT_US;
+    s.settled = false;
+    sim_run(&s, 2 * SIM_DT_US);
+
+    TEST_ASSERT_EQ_INT(steps + 1, s.steps);
+    TEST_ASSERT_EQ_INT(outliers, s.drift.outliers);
+    TEST_ASSERT(fabsf(s.drift.ppm - ppm) < 1.0f);
+    TEST_ASSERT(fabs((double)sys_time(&s) - s.real_us) < 100000);
+
+    // 小于阈值的偏差（30 s）平滑调整
+    uint32_t slews = s.slews;
+    s.sys_off_us += 30 * 1000000LL;
+    s.next_sync_us = s.mono_us + SIM_DT_US;
+    sim_run(&s, 2 * SIM_DT_US);
+    TEST_ASSERT_EQ_INT(steps + 1, s.steps);
+    TEST_ASSERT_EQ_INT(slews + 1, s.slews);
+    TEST_ASSERT(llabs(s.adj_pending_us + 30 * 1000000LL) < 100000);
+}
+
+int main(void)
+{
+    RUN_TEST(test_init_rejects_bad_history);
+    RUN_TEST(test_short_span_keeps_reference);
+    RUN_TEST(test_outlier_rejected_then_relaxed);
+    RUN_TEST(test_predict_and_trim);
+    RUN_TEST(test_interval_clamped);
+    RUN_TEST(test_need_step);
+    RUN_TEST(test_sim_week_slew);
+    RUN_TEST(test_sim_without_trim_drifts);
+    RUN_TEST(test_sim_step_after_jump);
+    return TEST_EXIT();
+}
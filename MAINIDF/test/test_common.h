@@ -0,0 +1,48 @@
+/**
+ * @file test_common.h
+ * @brief 主机测试的断言与运行宏
+ *
+ * 每个测试程序只有一个源文件，失败时打印位置并继续执行其余用例，
+ * main 返回非 0 由 ctest 判定失败。
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+static int test_failures = 0;
+
+#define TEST_FAIL(fmt, ...) do { \
+        printf("  FAIL %s:%d: " fmt "\n", __FILE__, __LINE__, ##__VA_ARGS__); \
+        test_failures++; \
+    } while (0)
+
+#define TEST_ASSERT(cond) do { \
+        if (!(cond)) { \
+            TEST_FAIL("%s", #cond); \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQ_INT(exp, act) do { \
+        long long e_ = (long long)(exp), a_ = (long long)(act); \
+        if (e_ != a_) { \
+            TEST_FAIL("%s == %lld, expected %lld", #act, a_, e_); \
+        } \
+    } while (0)
+
+#define TEST_ASSERT_EQ_STR(exp, act) do { \
+        const char *e_ = (exp), *a_ = (act); \
+        if (strcmp(e_, a_) != 0) { \
+            TEST_FAIL("%s == \"%s\", expected \"%s\"", #act, a_, e_); \
+        } \
+    } while (0)
+
+#define RUN_TEST(fn) do { \
+        int before_ = test_failures; \
+        fn(); \
+        printf("%s %s\n", test_failures == before_ ? "PASS" : "FAIL", #fn); \
+    } while (0)
+
+#define TEST_EXIT() (test_failures ? 1 : 0)
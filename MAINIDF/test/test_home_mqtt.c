@@ -0,0 +1,879 @@
+/**
+ * @file test_home_mqtt.c
+ * @brief home_mqtt 主机测试：真实的 home_mqtt 任务经 stubs 中的 MQTT 客户端连接测试进程中的 MQTT 服务器
+ *
+ * 服务器实现 MQTT 3.1.1 的 QoS 0/1、保留消息、+ 通配订阅和遗嘱，可以暂扣 PUBACK、断开所有连接。
+ * FreeRTOS 和 esp_timer 用模拟时钟，批量发送、熄屏唤醒、重连退避和队列保存由测试推进时间触发；
+ * 网络收发是真实的，用 WAIT_UNTIL 等待结果。设置项、WLAN 状态和队列文件由测试提供。
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "test_common.h"
+#include "host_rtos.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_event.h"
+#include "home_mqtt.h"
+#include "mqtt_outbox.h"
+#include "settings.h"
+#include "sys_file.h"
+#include "wifi_mgr.h"
+
+ESP_EVENT_DEFINE_BASE(WIFI_MGR_EVENT);
+
+#define NODE            "home/clock-abcdef"     // stubs 中 esp_efuse_mac_get_default() 的 MAC
+#define BRK_CONNS       8
+#define BRK_RETAINED    16
+#define BRK_LOG         1024
+#define BRK_HELD        64
+
+/* ---------- MQTT 服务器 ---------- */
+
+typedef struct {
+    int fd;                     // -1 表示空闲
+    pthread_mutex_t wlock;
+    char filter[64];            // 只支持一个订阅
+    char will_topic[96];
+    char will_msg[32];
+    bool will_retain;
+} brk_conn_t;
+
+typedef struct {
+    char topic[96];
+    char payload[160];
+    int qos;
+    bool retain;
+} brk_msg_t;
+
+static struct {
+    pthread_mutex_t lock;
+    int fd;
+    int port;
+    brk_conn_t conns[BRK_CONNS];
+    brk_msg_t retained[BRK_RETAINED];
+    brk_msg_t log[BRK_LOG];     // 客户端发来的消息
+    int log_count;
+    int connects;
+    int disconnects;            // 客户端主动断开
+    int wills;                  // 连接异常断开，发布遗嘱
+    bool hold_acks;             // 暂扣 PUBACK
+    struct {
+        brk_conn_t *conn;
+        uint8_t id[2];
+    } held[BRK_HELD];
+    int held_count;
+} s_brk = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void brk_send(brk_conn_t *c, uint8_t type, const uint8_t *body, size_t len)
+{
+    uint8_t pkt[512];
+    size_t n = 0, rem = len;
+
+    pkt[n++] = type;
+    do {
+        uint8_t d = rem % 128;
+        rem /= 128;
+        pkt[n++] = d | (rem ? 0x80 : 0);
+    } while (rem);
+    memcpy(pkt + n, body, len);
+    n += len;
+    pthread_mutex_lock(&c->wlock);
+    if (c->fd >= 0) {
+        send(c->fd, pkt, n, MSG_NOSIGNAL);
+    }
+    pthread_mutex_unlock(&c->wlock);
+}
+
+static void brk_deliver(brk_conn_t *c, const char *topic, const char *payload, bool retain)
+{
+    uint8_t body[300];
+    size_t tl = strlen(topic), pl = strlen(payload);
+
+    body[0] = tl >> 8;
+    body[1] = tl & 0xff;
+    memcpy(body + 2, topic, tl);
+    memcpy(body + 2 + tl, payload, pl);
+    brk_send(c, 0x30 | (retain ? 1 : 0), body, 2 + tl + pl);
+}
+
+// 只支持 '+'
+static bool brk_match(const char *filter, const char *topic)
+{
+    while (*filter && *topic) {
+        if (*filter == '+') {
+            filter++;
+            topic += strcspn(topic, "/");
+        } else if (*filter++ != *topic++) {
+            return false;
+        }
+    }
+    return *filter == '\0' && *topic == '\0';
+}
+
+// 调用方持有 s_brk.lock
+static void brk_route(const char *topic, const char *payload, bool retain)
+{
+    if (retain) {
+        int slot = -1;
+        for (int i = 0; i < BRK_RETAINED; i++) {
+            if (s_brk.retained[i].topic[0] && strcmp(s_brk.retained[i].topic, topic) == 0) {
+                slot = i;
+            } else if (!s_brk.retained[i].topic[0] && slot < 0) {
+                slot = i;
+            }
+        }
+        if (slot >= 0) {
+            if (payload[0]) {
+                snprintf(s_brk.retained[slot].topic, sizeof(s_brk.retained[0].topic), "%s", topic);
+                snprintf(s_brk.retained[slot].payload, sizeof(s_brk.retained[0].payload), "%s", payload);
+            } else {
+                s_brk.retained[slot].topic[0] = '\0';
+            }
+        }
+    }
+    for (int i = 0; i < BRK_CONNS; i++) {
+        brk_conn_t *c = &s_brk.conns[i];
+        if (c->fd >= 0 && c->filter[0] && brk_match(c->filter, topic)) {
+            brk_deliver(c, topic, payload, false);
+        }
+    }
+}
+
+static bool brk_recv(int fd, void *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = recv(fd, buf, len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        buf = (uint8_t *)buf + n;
+        len -= n;
+    }
+    return true;
+}
+
+static size_t get_str(const uint8_t *p, char *out, size_t cap)
+{
+    size_t len = p[0] << 8 | p[1];
+    snprintf(out, cap, "%.*s", (int)len, (const char *)p + 2);
+    return len + 2;
+}
+
+static void brk_packet(brk_conn_t *c, uint8_t type, const uint8_t *body, size_t len, bool *clean)
+{
+    switch (type >> 4) {
+    case 1: {                   // CONNECT
+        size_t pos = get_str(body, (char[8]){0}, 8) + 1;
+        uint8_t flags = body[pos];
+        char id[32];
+        pos += 3;
+        pos += get_str(body + pos, id, sizeof(id));
+        pthread_mutex_lock(&s_brk.lock);
+        if (flags & 0x04) {
+            pos += get_str(body + pos, c->will_topic, sizeof(c->will_topic));
+            get_str(body + pos, c->will_msg, sizeof(c->will_msg));
+            c->will_retain = flags & 0x20;
+        }
+        s_brk.connects++;
+        pthread_mutex_unlock(&s_brk.lock);
+        brk_send(c, 0x20, (const uint8_t[]){0, 0}, 2);
+        break;
+    }
+    case 3: {                   // PUBLISH
+        int qos = (type >> 1) & 3;
+        brk_msg_t m = { .qos = qos, .retain = type & 1 };
+        size_t pos = get_str(body, m.topic, sizeof(m.topic));
+        const uint8_t *id = body + pos;
+        pos += qos ? 2 : 0;
+        snprintf(m.payload, sizeof(m.payload), "%.*s", (int)(len - pos), (const char *)body + pos);
+        pthread_mutex_lock(&s_brk.lock);
+        if (s_brk.log_count < BRK_LOG) {
+            s_brk.log[s_brk.log_count++] = m;
+        }
+        brk_route(m.topic, m.payload, m.retain);
+        bool hold = qos && s_brk.hold_acks && s_brk.held_count < BRK_HELD;
+        if (hold) {
+            s_brk.held[s_brk.held_count].conn = c;
+            memcpy(s_brk.held[s_brk.held_count].id, id, 2);
+            s_brk.held_count++;
+        }
+        pthread_mutex_unlock(&s_brk.lock);
+        if (qos && !hold) {
+            brk_send(c, 0x40, id, 2);
+        }
+        break;
+    }
+    case 8: {                   // SUBSCRIBE
+        pthread_mutex_lock(&s_brk.lock);
+        get_str(body + 2, c->filter, sizeof(c->filter));
+        brk_send(c, 0x90, (const uint8_t[]){body[0], body[1], 0}, 3);
+        for (int i = 0; i < BRK_RETAINED; i++) {
+            if (s_brk.retained[i].topic[0] && brk_match(c->filter, s_brk.retained[i].topic)) {
+                brk_deliver(c, s_brk.retained[i].topic, s_brk.retained[i].payload, true);
+            }
+        }
+        pthread_mutex_unlock(&s_brk.lock);
+        break;
+    }
+    case 12:                    // PINGREQ
+        brk_send(c, 0xd0, NULL, 0);
+        break;
+    case 14:                    // DISCONNECT
+        *clean = true;
+        break;
+    default:
+        break;
+    }
+}
+
+static void *brk_conn_thread(void *arg)
+{
+    brk_conn_t *c = arg;
+    int fd = c->fd;
+    bool clean = false;
+    uint8_t body[512];
+
+    while (!clean) {
+        uint8_t type, d;
+        size_t len = 0, mul = 1;
+        if (!brk_recv(fd, &type, 1)) {
+            break;
+        }
+        do {
+            if (!brk_recv(fd, &d, 1)) {
+                goto out;
+            }
+            len += (d & 127) * mul;
+            mul *= 128;
+        } while (d & 0x80);
+        if (len > sizeof(body) || !brk_recv(fd, body, len)) {
+            break;
+        }
+        brk_packet(c, type, body, len, &clean);
+    }
+out:
+    pthread_mutex_lock(&s_brk.lock);
+    pthread_mutex_lock(&c->wlock);
+    close(fd);
+    c->fd = -1;
+    pthread_mutex_unlock(&c->wlock);
+    c->filter[0] = '\0';
+    for (int i = 0; i < s_brk.held_count; i++) {
+        if (s_brk.held[i].conn == c) {
+            s_brk.held[i--] = s_brk.held[--s_brk.held_count];
+        }
+    }
+    if (clean) {
+        s_brk.disconnects++;
+    } else if (c->will_topic[0]) {
+        s_brk.wills++;
+        brk_route(c->will_topic, c->will_msg, c->will_retain);
+    }
+    c->will_topic[0] = '\0';
+    pthread_mutex_unlock(&s_brk.lock);
+    return NULL;
+}
+
+static void *brk_accept_thread(void *arg)
+{
+    while (1) {
+        int fd = accept(s_brk.fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        brk_conn_t *c = NULL;
+        pthread_mutex_lock(&s_brk.lock);
+        for (int i = 0; i < BRK_CONNS && !c; i++) {
+            if (s_brk.conns[i].fd < 0) {
+                c = &s_brk.conns[i];
+                c->fd = fd;
+            }
+        }
+        pthread_mutex_unlock(&s_brk.lock);
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        pthread_t t;
+        pthread_create(&t, NULL, brk_conn_thread, c);
+        pthread_detach(t);
+    }
+    return NULL;
+}
+
+static bool brk_start(void)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = 0 };
+    socklen_t alen = sizeof(addr);
+
+    for (int i = 0; i < BRK_CONNS; i++) {
+        s_brk.conns[i].fd = -1;
+        pthread_mutex_init(&s_brk.conns[i].wlock, NULL);
+    }
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    s_brk.fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (s_brk.fd < 0 || bind(s_brk.fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s_brk.fd, 8) != 0) {
+        return false;
+    }
+    getsockname(s_brk.fd, (struct sockaddr *)&addr, &alen);
+    s_brk.port = ntohs(addr.sin_port);
+    pthread_t t;
+    pthread_create(&t, NULL, brk_accept_thread, NULL);
+    pthread_detach(t);
+    return true;
+}
+
+// 服务器侧发布保留消息（设备上报状态）
+static void brk_inject(const char *topic, const char *payload)
+{
+    pthread_mutex_lock(&s_brk.lock);
+    brk_route(topic, payload, true);
+    pthread_mutex_unlock(&s_brk.lock);
+}
+
+static void brk_hold_acks(bool hold)
+{
+    pthread_mutex_lock(&s_brk.lock);
+    s_brk.hold_acks = hold;
+    if (!hold) {
+        for (int i = 0; i < s_brk.held_count; i++) {
+            brk_send(s_brk.held[i].conn, 0x40, s_brk.held[i].id, 2);
+        }
+        s_brk.held_count = 0;
+    }
+    pthread_mutex_unlock(&s_brk.lock);
+}
+
+// 模拟网络中断：不发送任何报文，直接关闭所有连接
+static void brk_drop_all(void)
+{
+    pthread_mutex_lock(&s_brk.lock);
+    for (int i = 0; i < BRK_CONNS; i++) {
+        if (s_brk.conns[i].fd >= 0) {
+            shutdown(s_brk.conns[i].fd, SHUT_RDWR);
+        }
+    }
+    pthread_mutex_unlock(&s_brk.lock);
+}
+
+static int brk_get(const int *field)
+{
+    pthread_mutex_lock(&s_brk.lock);
+    int v = *field;
+    pthread_mutex_unlock(&s_brk.lock);
+    return v;
+}
+
+static int brk_open_conns(void)
+{
+    int n = 0;
+    pthread_mutex_lock(&s_brk.lock);
+    for (int i = 0; i < BRK_CONNS; i++) {
+        n += s_brk.conns[i].fd >= 0;
+    }
+    pthread_mutex_unlock(&s_brk.lock);
+    return n;
+}
+
+// 从第 from 条起，主题为 topic 的消息数
+static int brk_count(int from, const char *topic)
+{
+    int n = 0;
+    pthread_mutex_lock(&s_brk.lock);
+    for (int i = from; i < s_brk.log_count; i++) {
+        n += strcmp(s_brk.log[i].topic, topic) == 0;
+    }
+    pthread_mutex_unlock(&s_brk.lock);
+    return n;
+}
+
+static brk_msg_t brk_msg(int i)
+{
+    pthread_mutex_lock(&s_brk.lock);
+    brk_msg_t m = s_brk.log[i];
+    pthread_mutex_unlock(&s_brk.lock);
+    return m;
+}
+
+static const char *brk_retained(const char *topic)
+{
+    static char buf[160];
+    buf[0] = '\0';
+    pthread_mutex_lock(&s_brk.lock);
+    for (int i = 0; i < BRK_RETAINED; i++) {
+        if (s_brk.retained[i].topic[0] && strcmp(s_brk.retained[i].topic, topic) == 0) {
+            strcpy(buf, s_brk.retained[i].payload);
+        }
+    }
+    pthread_mutex_unlock(&s_brk.lock);
+    return buf;
+}
+
+/* ---------- 被测模块的依赖 ---------- */
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)host_rtos_now_ms() * 1000;
+}
+
+static char s_url[96];
+
+esp_err_t settings_get_str(setting_id_t id, char *buf, size_t len)
+{
+    snprintf(buf, len, "%s", id == SETTING_MQTT_URL ? s_url : "home");
+    return ESP_OK;
+}
+
+esp_err_t settings_subscribe(setting_id_t id, settings_cb_t cb, void *arg)
+{
+    return ESP_OK;
+}
+
+static wifi_mgr_state_t s_wifi_state = WIFI_MGR_STATE_CONNECTED;
+
+wifi_mgr_state_t wifi_mgr_get_state(void)
+{
+    return s_wifi_state;
+}
+
+/* 队列文件保存在内存中 */
+static pthread_mutex_t s_file_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t *s_file;
+static size_t s_file_len;
+static int s_file_writes;
+
+esp_err_t sys_file_write_atomic(const char *path, const void *data, size_t len)
+{
+    pthread_mutex_lock(&s_file_lock);
+    free(s_file);
+    s_file = malloc(len);
+    memcpy(s_file, data, len);
+    s_file_len = len;
+    s_file_writes++;
+    pthread_mutex_unlock(&s_file_lock);
+    return ESP_OK;
+}
+
+void *sys_file_read_all(const char *path, size_t *len, bool prefer_psram)
+{
+    void *copy = NULL;
+    pthread_mutex_lock(&s_file_lock);
+    if (s_file) {
+        copy = malloc(s_file_len);
+        memcpy(copy, s_file, s_file_len);
+        *len = s_file_len;
+    }
+    pthread_mutex_unlock(&s_file_lock);
+    return copy;
+}
+
+// 文件中的队列，-1 表示没有文件或校验失败；文件格式与 home_mqtt.c 的 home_file_t 相同（4 字节头）
+static int file_queued(void)
+{
+    int count = -1;
+    pthread_mutex_lock(&s_file_lock);
+    if (s_file && s_file_len == 4 + sizeof(mqtt_outbox_t)) {
+        static mqtt_outbox_t ob;
+        memcpy(&ob, s_file + 4, sizeof(ob));
+        count = mqtt_outbox_check(&ob) ? mqtt_outbox_count(&ob) : -1;
+    }
+    pthread_mutex_unlock(&s_file_lock);
+    return count;
+}
+
+/* ---------- 事件 ---------- */
+
+static pthread_mutex_t s_ev_lock = PTHREAD_MUTEX_INITIALIZER;
+static int s_ev_connected, s_ev_disconnected, s_ev_device;
+static home_mqtt_device_t s_devices[HOME_MQTT_DEVICES];
+
+static void home_event_cb(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    pthread_mutex_lock(&s_ev_lock);
+    if (id == HOME_MQTT_EVENT_CONNECTED) {
+        s_ev_connected++;
+    } else if (id == HOME_MQTT_EVENT_DISCONNECTED) {
+        s_ev_disconnected++;
+    } else if (id == HOME_MQTT_EVENT_DEVICE) {
+        const home_mqtt_device_t *dev = data;
+        s_devices[dev->slot] = *dev;
+        s_ev_device++;
+    }
+    pthread_mutex_unlock(&s_ev_lock);
+}
+
+static int ev_get(const int *field)
+{
+    pthread_mutex_lock(&s_ev_lock);
+    int v = *field;
+    pthread_mutex_unlock(&s_ev_lock);
+    return v;
+}
+
+static int find_device(const char *name)
+{
+    int slot = -1;
+    pthread_mutex_lock(&s_ev_lock);
+    for (int i = 0; i < HOME_MQTT_DEVICES; i++) {
+        if (strcmp(s_devices[i].name, name) == 0) {
+            slot = i;
+        }
+    }
+    pthread_mutex_unlock(&s_ev_lock);
+    return slot;
+}
+
+/* ---------- 辅助 ---------- */
+
+static home_mqtt_stats_t stats(void)
+{
+    home_mqtt_stats_t st;
+    host_rtos_settle();
+    home_mqtt_get_stats(&st);
+    return st;
+}
+
+// 网络收发在真实时间中进行：等待条件成立，最多 ms 毫秒
+#define WAIT_MS(cond, ms) ({ \
+        bool ok_ = false; \
+        for (int i_ = 0; i_ < (ms) && !ok_; i_++) { \
+            host_rtos_settle(); \
+            ok_ = (cond); \
+            if (!ok_) { \
+                usleep(1000); \
+            } \
+        } \
+        ok_; \
+    })
+
+#define WAIT_UNTIL(cond) WAIT_MS(cond, 2000)
+
+// 条件在一段时间内保持不成立
+#define STAYS_FALSE(cond) ({ \
+        bool ok_ = true; \
+        for (int i_ = 0; i_ < 50 && ok_; i_++) { \
+            host_rtos_settle(); \
+            ok_ = !(cond); \
+            usleep(1000); \
+        } \
+        ok_; \
+    })
+
+static void wifi_event(int32_t id)
+{
+    s_wifi_state = id == WIFI_MGR_EVENT_CONNECTED ? WIFI_MGR_STATE_CONNECTED : WIFI_MGR_STATE_BACKOFF;
+    esp_event_post(WIFI_MGR_EVENT, id, NULL, 0, 0);
+}
+
+// 推迟时间直到重连成功（退避有随机成分）
+static bool advance_until_connected(int connects)
+{
+    for (int i = 0; i < 600; i++) {
+        if (WAIT_MS(stats().connects >= (uint32_t)connects, 20)) {
+            return true;
+        }
+        host_rtos_advance_ms(1000);
+    }
+    return false;
+}
+
+/* ---------- 用例 ---------- */
+
+static void test_not_initialized(void)
+{
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_STATE, home_mqtt_publish("x", "1", 0));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_STATE, home_mqtt_device_set("lamp", "ON"));
+}
+
+/* 连接后发布 online、订阅设备状态，保留的设备状态逐个发布事件 */
+static void test_connect(void)
+{
+    TEST_ASSERT_EQ_INT(ESP_OK, home_mqtt_init());
+    TEST_ASSERT(WAIT_UNTIL(ev_get(&s_ev_connected) == 1));
+    TEST_ASSERT(WAIT_UNTIL(ev_get(&s_ev_device) == 3));
+    TEST_ASSERT(WAIT_UNTIL(strcmp(brk_retained(NODE "/status"), "online") == 0));
+    TEST_ASSERT_EQ_INT(1, brk_get(&s_brk.connects));
+
+    int lamp = find_device("lamp"), fan = find_device("fan"), temp = find_device("temp");
+    TEST_ASSERT(lamp >= 0 && fan >= 0 && temp >= 0);
+    if (lamp >= 0 && fan >= 0 && temp >= 0) {
+        TEST_ASSERT_EQ_INT(1, s_devices[lamp].on);
+        TEST_ASSERT_EQ_INT(0, s_devices[fan].on);
+        TEST_ASSERT_EQ_INT(-1, s_devices[temp].on);
+        TEST_ASSERT_EQ_STR("23.5", s_devices[temp].state);
+    }
+    home_mqtt_stats_t st = stats();
+    TEST_ASSERT_EQ_INT(1, st.connects);
+    TEST_ASSERT_EQ_INT(3, st.device_updates);
+}
+
+/* 亮屏时每 HOME_MQTT_BATCH_MS 最多发送一批；LATEST 只发最新值，其余按入队顺序 */
+static void test_batching(void)
+{
+    char v[8];
+
+    host_rtos_advance_ms(HOME_MQTT_BATCH_MS + 1000);
+    int from = brk_get(&s_brk.log_count);
+    home_mqtt_stats_t st0 = stats();
+
+    // 距上一批已超过间隔，第一条立即发出
+    TEST_ASSERT_EQ_INT(ESP_OK, home_mqtt_publish("log", "first", 0));
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/log") == 1));
+    from = brk_get(&s_brk.log_count);
+
+    for (int i = 0; i < 6; i++) {
+        snprintf(v, sizeof(v), "e%d", i);
+        TEST_ASSERT_EQ_INT(ESP_OK, home_mqtt_publish("log", v, 0));
+        snprintf(v, sizeof(v), "%d", 90 - i);
+        TEST_ASSERT_EQ_INT(ESP_OK, home_mqtt_publish("battery", v, HOME_MQTT_F_LATEST | HOME_MQTT_F_RETAIN));
+    }
+    host_rtos_advance_ms(HOME_MQTT_BATCH_MS - 1000);
+    TEST_ASSERT(STAYS_FALSE(brk_get(&s_brk.log_count) > from));
+    TEST_ASSERT_EQ_INT(7, stats().queued);
+
+    host_rtos_advance_ms(2000);
+    TEST_ASSERT(WAIT_UNTIL(brk_get(&s_brk.log_count) == from + 7));
+    for (int i = 0; i < 6; i++) {
+        brk_msg_t m = brk_msg(from + i);
+        snprintf(v, sizeof(v), "e%d", i);
+        TEST_ASSERT_EQ_STR(NODE "/log", m.topic);
+        TEST_ASSERT_EQ_STR(v, m.payload);
+        TEST_ASSERT_EQ_INT(0, m.qos);
+    }
+    brk_msg_t m = brk_msg(from + 6);
+    TEST_ASSERT_EQ_STR(NODE "/battery", m.topic);
+    TEST_ASSERT_EQ_STR("85", m.payload);
+    TEST_ASSERT(m.retain);
+
+    home_mqtt_stats_t st = stats();
+    TEST_ASSERT_EQ_INT(0, st.queued);
+    TEST_ASSERT_EQ_INT(2, st.batches - st0.batches);
+    TEST_ASSERT_EQ_INT(8, st.published - st0.published);
+    TEST_ASSERT_EQ_INT(5, st.coalesced - st0.coalesced);
+}
+
+/* 队列达到 HOME_MQTT_BATCH_MAX 条时不等间隔 */
+static void test_batch_max(void)
+{
+    char v[8];
+    int from = brk_get(&s_brk.log_count);
+
+    for (int i = 0; i < HOME_MQTT_BATCH_MAX - 1; i++) {
+        snprintf(v, sizeof(v), "b%d", i);
+        home_mqtt_publish("log", v, 0);
+    }
+    TEST_ASSERT(STAYS_FALSE(brk_get(&s_brk.log_count) > from));
+    home_mqtt_publish("log", "last", 0);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/log") == HOME_MQTT_BATCH_MAX));
+    TEST_ASSERT_EQ_INT(0, stats().queued);
+}
+
+/* QoS 1：收到 PUBACK 前消息留在队列中 */
+static void test_qos1_puback(void)
+{
+    int from = brk_get(&s_brk.log_count);
+
+    brk_hold_acks(true);
+    TEST_ASSERT_EQ_INT(ESP_OK, home_mqtt_publish("alarm", "fired", HOME_MQTT_F_NOW));
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/alarm") == 1));
+    TEST_ASSERT_EQ_INT(1, brk_msg(from).qos);
+    TEST_ASSERT(STAYS_FALSE(stats().queued == 0));
+    TEST_ASSERT_EQ_INT(1, stats().queued);
+
+    // 等待确认期间的 QoS 0 消息照常发出，不重发等待确认的消息
+    home_mqtt_publish("log", "during", 0);
+    host_rtos_advance_ms(HOME_MQTT_BATCH_MS + 1000);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/log") == 1));
+    TEST_ASSERT_EQ_INT(1, brk_count(from, NODE "/alarm"));
+    TEST_ASSERT_EQ_INT(1, stats().queued);
+
+    brk_hold_acks(false);
+    TEST_ASSERT(WAIT_UNTIL(stats().queued == 0));
+}
+
+/* 连接中断时未确认的 QoS 1 消息在重连后重发，已发出的 QoS 0 消息不重发 */
+static void test_qos1_resend(void)
+{
+    int from = brk_get(&s_brk.log_count);
+    int connects = stats().connects;
+    int wills = brk_get(&s_brk.wills);
+
+    brk_hold_acks(true);
+    home_mqtt_publish("door", "open", HOME_MQTT_F_NOW);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/door") == 1));
+    host_rtos_advance_ms(HOME_MQTT_BATCH_MS + 1000);
+    home_mqtt_publish("log", "x", 0);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/log") == 1));
+
+    brk_drop_all();
+    brk_hold_acks(false);
+    TEST_ASSERT(WAIT_UNTIL(ev_get(&s_ev_disconnected) == 1));
+    TEST_ASSERT(WAIT_UNTIL(brk_get(&s_brk.wills) == wills + 1));
+    TEST_ASSERT_EQ_STR("offline", brk_retained(NODE "/status"));
+    TEST_ASSERT_EQ_INT(1, stats().queued);
+
+    TEST_ASSERT(advance_until_connected(connects + 1));
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/door") == 2));
+    TEST_ASSERT(WAIT_UNTIL(stats().queued == 0));
+    TEST_ASSERT_EQ_INT(1, brk_count(from, NODE "/log"));
+    TEST_ASSERT(WAIT_UNTIL(strcmp(brk_retained(NODE "/status"), "online") == 0));
+}
+
+/* 等待确认的消息达到 HOME_MQTT_INFLIGHT 条时暂停，之后的消息按顺序等待，收到确认后继续 */
+static void test_inflight_limit(void)
+{
+    char v[8];
+    int from = brk_get(&s_brk.log_count);
+    const int n = HOME_MQTT_INFLIGHT + 3;
+
+    brk_hold_acks(true);
+    for (int i = 0; i < n; i++) {
+        snprintf(v, sizeof(v), "n%d", i);
+        home_mqtt_publish("now", v, HOME_MQTT_F_NOW);
+    }
+    home_mqtt_publish("log", "after", 0);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/now") == HOME_MQTT_INFLIGHT));
+    TEST_ASSERT(STAYS_FALSE(brk_count(from, NODE "/now") > HOME_MQTT_INFLIGHT));
+    TEST_ASSERT_EQ_INT(0, brk_count(from, NODE "/log"));
+    TEST_ASSERT_EQ_INT(n + 1, stats().queued);
+
+    brk_hold_acks(false);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/log") == 1));
+    TEST_ASSERT(WAIT_UNTIL(stats().queued == 0));
+    TEST_ASSERT_EQ_INT(n, brk_count(from, NODE "/now"));
+    for (int i = 0; i < n; i++) {
+        snprintf(v, sizeof(v), "n%d", i);
+        TEST_ASSERT_EQ_STR(v, brk_msg(from + i).payload);
+    }
+    TEST_ASSERT_EQ_STR("after", brk_msg(from + n).payload);
+}
+
+/* 设备状态只在变化时发布事件；切换开关发布 set 命令 */
+static void test_devices(void)
+{
+    int lamp = find_device("lamp");
+    int fan = find_device("fan");
+    int events = ev_get(&s_ev_device);
+    int from = brk_get(&s_brk.log_count);
+
+    brk_inject("home/device/lamp/state", "OFF");
+    TEST_ASSERT(WAIT_UNTIL(ev_get(&s_ev_device) == events + 1));
+    TEST_ASSERT_EQ_INT(0, s_devices[lamp].on);
+    brk_inject("home/device/lamp/state", "OFF");
+    brk_inject("home/other/lamp/state", "ON");
+    TEST_ASSERT(STAYS_FALSE(ev_get(&s_ev_device) > events + 1));
+
+    TEST_ASSERT_EQ_INT(ESP_OK, home_mqtt_device_toggle(fan));
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, "home/device/fan/set") == 1));
+    TEST_ASSERT_EQ_STR("ON", brk_msg(from).payload);
+    TEST_ASSERT_EQ_INT(1, brk_msg(from).qos);
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FOUND, home_mqtt_device_toggle(find_device("temp")));
+
+    // 空的保留消息表示设备已删除
+    brk_inject("home/device/fan/state", "");
+    TEST_ASSERT(WAIT_UNTIL(ev_get(&s_ev_device) == events + 2));
+    TEST_ASSERT_EQ_STR("", s_devices[fan].name);
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FOUND, home_mqtt_device_toggle(fan));
+    TEST_ASSERT(WAIT_UNTIL(stats().queued == 0));
+}
+
+/* 熄屏：发送完断开，不保持连接；每 HOME_MQTT_BATCH_OFF_MS 连接一次，F_NOW 立即连接 */
+static void test_screen_off(void)
+{
+    home_mqtt_stats_t st0 = stats();
+    int disconnects = brk_get(&s_brk.disconnects);
+    int from = brk_get(&s_brk.log_count);
+
+    home_mqtt_set_screen_on(false);
+    host_rtos_advance_ms(HOME_MQTT_LINGER_MS + 100);
+    TEST_ASSERT(WAIT_UNTIL(brk_open_conns() == 0));
+    TEST_ASSERT_EQ_INT(disconnects + 1, brk_get(&s_brk.disconnects));   // 主动断开，不发布遗嘱
+    TEST_ASSERT_EQ_STR("offline", brk_retained(NODE "/status"));
+
+    home_mqtt_publish("battery", "70", HOME_MQTT_F_LATEST | HOME_MQTT_F_RETAIN);
+    host_rtos_advance_ms(HOME_MQTT_BATCH_OFF_MS / 2);
+    home_mqtt_publish("battery", "69", HOME_MQTT_F_LATEST | HOME_MQTT_F_RETAIN);
+    TEST_ASSERT(STAYS_FALSE(brk_open_conns() > 0));
+
+    host_rtos_advance_ms(HOME_MQTT_BATCH_OFF_MS / 2 + 1000);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/battery") == 1));
+    TEST_ASSERT_EQ_STR("69", brk_retained(NODE "/battery"));
+    host_rtos_advance_ms(HOME_MQTT_LINGER_MS + 100);
+    TEST_ASSERT(WAIT_UNTIL(brk_open_conns() == 0));
+    home_mqtt_stats_t st = stats();
+    TEST_ASSERT_EQ_INT(1, st.wakeups - st0.wakeups);
+
+    // 熄屏时 F_NOW 立即连接，未确认的消息不因断开而丢失
+    brk_hold_acks(true);
+    home_mqtt_publish("alarm", "again", HOME_MQTT_F_NOW);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/alarm") == 1));
+    host_rtos_advance_ms(HOME_MQTT_LINGER_MS + 100);
+    TEST_ASSERT(WAIT_UNTIL(brk_open_conns() == 0));
+    brk_hold_acks(false);
+    TEST_ASSERT_EQ_INT(1, stats().queued);
+    TEST_ASSERT_EQ_INT(2, stats().wakeups - st0.wakeups);
+
+    home_mqtt_set_screen_on(true);
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/alarm") == 2));
+    TEST_ASSERT(WAIT_UNTIL(stats().queued == 0));
+}
+
+/* WLAN 断开时队列在 HOME_MQTT_SAVE_MS 后写入文件，重连后发出并清空文件 */
+static void test_offline_queue(void)
+{
+    char v[8];
+    int from = brk_get(&s_brk.log_count);
+    int connects = stats().connects;
+
+    wifi_event(WIFI_MGR_EVENT_DISCONNECTED);
+    TEST_ASSERT(WAIT_UNTIL(brk_open_conns() == 0));
+    for (int i = 0; i < 5; i++) {
+        snprintf(v, sizeof(v), "o%d", i);
+        home_mqtt_publish("event", v, 0);
+    }
+    host_rtos_advance_ms(HOME_MQTT_SAVE_MS - 1000);
+    TEST_ASSERT_EQ_INT(5, stats().queued);
+    TEST_ASSERT(file_queued() != 5);
+    host_rtos_advance_ms(2000);
+    TEST_ASSERT(WAIT_UNTIL(file_queued() == 5));
+
+    wifi_event(WIFI_MGR_EVENT_CONNECTED);
+    TEST_ASSERT(advance_until_connected(connects + 1));
+    TEST_ASSERT(WAIT_UNTIL(brk_count(from, NODE "/event") == 5));
+    TEST_ASSERT(WAIT_UNTIL(file_queued() == 0));
+    TEST_ASSERT_EQ_INT(0, stats().queued);
+}
+
+int main(void)
+{
+    host_log_level = ESP_LOG_ERROR;
+    if (!brk_start()) {
+        printf("cannot listen on 127.0.0.1\n");
+        return 1;
+    }
+    snprintf(s_url, sizeof(s_url), "mqtt://127.0.0.1:%d", s_brk.port);
+    brk_inject("home/device/lamp/state", "ON");
+    brk_inject("home/device/fan/state", "off");
+    brk_inject("home/device/temp/state", "23.5");
+    esp_event_handler_register(HOME_MQTT_EVENT, ESP_EVENT_ANY_ID, home_event_cb, NULL);
+
+    RUN_TEST(test_not_initialized);
+    RUN_TEST(test_connect);
+    RUN_TEST(test_batching);
+    RUN_TEST(test_batch_max);
+    RUN_TEST(test_qos1_puback);
+    RUN_TEST(test_qos1_resend);
+    RUN_TEST(test_inflight_limit);
+    RUN_TEST(test_devices);
+    RUN_TEST(test_screen_off);
+    RUN_TEST(test_offline_queue);
+    return TEST_EXIT();
+}
@@ -0,0 +1,760 @@
+/**
+ * @file test_http_pool.c
+ * @brief http_pool 主机测试：真实的 HTTP 任务与本机 HTTP 服务器之间的请求
+ *
+ * 服务器在测试进程中，监听 127.0.0.1 的几个端口（不同端口即不同主机），按路径返回不同的响应：
+ * 保持连接、分块传输、ETag / max-age 缓存、Connection: close、响应后静默断开等。
+ * FreeRTOS 用 host_rtos 模拟时钟，esp_timer 也取模拟时间，推迟和空闲关闭由测试推进时间触发。
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "test_common.h"
+#include "host_rtos.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_event.h"
+#include "wifi_mgr.h"
+#include "http_pool.h"
+
+ESP_EVENT_DEFINE_BASE(WIFI_MGR_EVENT);
+
+#define SERVER_PORTS    4
+#define BODY_MAX        8192
+
+/* ---------- 本机 HTTP 服务器 ---------- */
+
+typedef struct {
+    int fd;
+    int port;
+    int connections;            // 接受的连接数
+    int open;                   // 当前未关闭的连接数
+} server_t;
+
+static server_t s_srv[SERVER_PORTS];
+static pthread_mutex_t s_srv_lock = PTHREAD_MUTEX_INITIALIZER;
+static int s_requests;                  // 服务器收到的请求数
+static char s_last_inm[64];             // 最近一个请求的 If-None-Match
+static char s_last_path[256];
+static int s_etag_version = 1;
+
+// 响应体内容由路径决定，测试按同样的规则核对
+static size_t body_len(const char *path)
+{
+    static const struct {
+        const char *prefix;
+        size_t len;
+    } lens[] = {
+        {"/chunked", 700}, {"/etag", 300}, {"/fresh", 300}, {"/nostore", 300},
+        {"/close", 100}, {"/drop", 100}, {"/big", 5000},
+    };
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        if (strncmp(path, lens[i].prefix, strlen(lens[i].prefix)) == 0) {
+            return lens[i].len;
+        }
+    }
+    return 200;
+}
+
+static void make_body(const char *path, char *out, size_t len)
+{
+    size_t seed = strlen(path);
+    for (size_t i = 0; i < len; i++) {
+        out[i] = 'a' + (i * 7 + seed) % 26;
+    }
+}
+
+static bool read_request(int fd, char *path, size_t path_len, char *inm, size_t inm_len)
+{
+    char head[2048];
+    size_t n = 0;
+
+    // 逐字节读到空行，不会读入下一个请求
+    while (n + 1 < sizeof(head)) {
+        if (recv(fd, head + n, 1, 0) != 1) {
+            return false;
+        }
+        n++;
+        if (n >= 4 && memcmp(head + n - 4, "\r\n\r\n", 4) == 0) {
+            break;
+        }
+    }
+    head[n] = '\0';
+    if (sscanf(head, "GET %255s HTTP/1.1", path) != 1) {
+        return false;
+    }
+    inm[0] = '\0';
+    const char *h = strstr(head, "\r\nIf-None-Match: ");
+    if (h) {
+        h += strlen("\r\nIf-None-Match: ");
+        size_t m = strcspn(h, "\r");
+        if (m < inm_len) {
+            memcpy(inm, h, m);
+            inm[m] = '\0';
+        }
+    }
+    return true;
+}
+
+static void send_all(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+// 处理一个连接上的请求，返回 false 时关闭连接
+static bool respond(int fd, const char *path, const char *inm)
+{
+    char head[512], body[BODY_MAX], etag[16];
+    size_t len = body_len(path);
+    int n;
+
+    make_body(path, body, len);
+    snprintf(etag, sizeof(etag), "\"v%d\"", s_etag_version);
+
+    if (strncmp(path, "/404", 4) == 0) {
+        n = snprintf(head, sizeof(head), "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nnot found");
+        send_all(fd, head, n);
+        return true;
+    }
+    if (strncmp(path, "/etag", 5) == 0 && strcmp(inm, etag) == 0) {
+        n = snprintf(head, sizeof(head), "HTTP/1.1 304 Not Modified\r\nETag: %s\r\n\r\n", etag);
+        send_all(fd, head, n);
+        return true;
+    }
+    n = snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n");
+    if (strncmp(path, "/etag", 5) == 0) {
+        n += snprintf(head + n, sizeof(head) - n, "ETag: %s\r\n", etag);
+    } else if (strncmp(path, "/fresh", 6) == 0) {
+        n += snprintf(head + n, sizeof(head) - n, "Cache-Control: public, max-age=60\r\n");
+    } else if (strncmp(path, "/nostore", 8) == 0) {
+        n += snprintf(head + n, sizeof(head) - n, "ETag: %s\r\nCache-Control: no-store\r\n", etag);
+    } else if (strncmp(path, "/close", 6) == 0) {
+        n += snprintf(head + n, sizeof(head) - n, "Connection: close\r\n");
+    }
+
+    if (strncmp(path, "/chunked", 8) == 0) {
+        n += snprintf(head + n, sizeof(head) - n, "Transfer-Encoding: chunked\r\n\r\n");
+        send_all(fd, head, n);
+        for (size_t off = 0; off < len; off += 50) {
+            size_t m = len - off < 50 ? len - off : 50;
+            n = snprintf(head, sizeof(head), "%zx\r\n", m);
+            send_all(fd, head, n);
+            send_all(fd, body + off, m);
+            send_all(fd, "\r\n", 2);
+        }
+        send_all(fd, "0\r\n\r\n", 5);
+    } else {
+        n += snprintf(head + n, sizeof(head) - n, "Content-Length: %zu\r\n\r\n", len);
+        send_all(fd, head, n);
+        send_all(fd, body, len);
+    }
+    // /drop 不通知客户端，响应后直接断开，模拟服务器关闭空闲连接
+    return strncmp(path, "/close", 6) != 0 && strncmp(path, "/drop", 5) != 0;
+}
+
+static void *conn_thread(void *arg)
+{
+    int fd = (int)(intptr_t)arg;
+    server_t *srv = NULL;
+    struct sockaddr_in addr;
+    socklen_t alen = sizeof(addr);
+    char path[256], inm[64];
+
+    getsockname(fd, (struct sockaddr *)&addr, &alen);
+    for (int i = 0; i < SERVER_PORTS; i++) {
+        if (s_srv[i].port == ntohs(addr.sin_port)) {
+            srv = &s_srv[i];
+        }
+    }
+    while (read_request(fd, path, sizeof(path), inm, sizeof(inm))) {
+        pthread_mutex_lock(&s_srv_lock);
+        s_requests++;
+        snprintf(s_last_inm, sizeof(s_last_inm), "%s", inm);
+        snprintf(s_last_path, sizeof(s_last_path), "%s", path);
+        pthread_mutex_unlock(&s_srv_lock);
+        if (!respond(fd, path, inm)) {
+            break;
+        }
+    }
+    close(fd);
+    pthread_mutex_lock(&s_srv_lock);
+    srv->open--;
+    pthread_mutex_unlock(&s_srv_lock);
+    return NULL;
+}
+
+static void *accept_thread(void *arg)
+{
+    server_t *srv = arg;
+
+    while (1) {
+        int fd = accept(srv->fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        // 响应头和响应体分开发送，关掉 Nagle 免得等对方的延迟确认
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        pthread_mutex_lock(&s_srv_lock);
+        srv->connections++;
+        srv->open++;
+        pthread_mutex_unlock(&s_srv_lock);
+        pthread_t t;
+        pthread_create(&t, NULL, conn_thread, (void *)(intptr_t)fd);
+        pthread_detach(t);
+    }
+    return NULL;
+}
+
+// 监听 127.0.0.1 的随机端口
+static int listen_any(int *port)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = 0 };
+    socklen_t alen = sizeof(addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        return -1;
+    }
+    getsockname(fd, (struct sockaddr *)&addr, &alen);
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static bool server_start(void)
+{
+    for (int i = 0; i < SERVER_PORTS; i++) {
+        s_srv[i].fd = listen_any(&s_srv[i].port);
+        if (s_srv[i].fd < 0) {
+            return false;
+        }
+        pthread_t t;
+        pthread_create(&t, NULL, accept_thread, &s_srv[i]);
+        pthread_detach(t);
+    }
+    return true;
+}
+
+static int srv_get(const int *field)
+{
+    pthread_mutex_lock(&s_srv_lock);
+    int v = *field;
+    pthread_mutex_unlock(&s_srv_lock);
+    return v;
+}
+
+/* ---------- 客户端辅助 ---------- */
+
+// 模拟时间，与 host_rtos 的 tick 一致
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)host_rtos_now_ms() * 1000;
+}
+
+typedef struct {
+    char body[BODY_MAX];
+    size_t len;
+    int calls;
+    esp_err_t abort_with;       // 非 ESP_OK 时第一块后返回该值
+    bool nested_get;            // 在回调中调用 http_pool_get()
+    esp_err_t nested_err;
+} sink_t;
+
+static esp_err_t sink_body(const char *data, size_t len, void *arg)
+{
+    sink_t *s = arg;
+
+    if (s->len + len <= sizeof(s->body)) {
+        memcpy(s->body + s->len, data, len);
+    }
+    s->len += len;
+    s->calls++;
+    if (s->nested_get) {
+        s->nested_err = http_pool_get("http://127.0.0.1:1/", 0, sink_body, NULL, NULL);
+        s->nested_get = false;
+    }
+    return s->abort_with;
+}
+
+static const char *url(int srv, const char *path)
+{
+    static char buf[128];
+    snprintf(buf, sizeof(buf), "http://127.0.0.1:%d%s", s_srv[srv].port, path);
+    return buf;
+}
+
+static esp_err_t get(int srv, const char *path, uint32_t flags, sink_t *sink, http_pool_result_t *res)
+{
+    memset(sink, 0, sizeof(*sink));
+    return http_pool_get(url(srv, path), flags, sink_body, sink, res);
+}
+
+// 响应体与服务器按路径生成的内容一致
+static bool body_ok(const sink_t *sink, const char *path)
+{
+    char exp[BODY_MAX];
+    size_t len = body_len(path);
+
+    make_body(path, exp, len);
+    return sink->len == len && memcmp(sink->body, exp, len) == 0;
+}
+
+static http_pool_stats_t stats(void)
+{
+    http_pool_stats_t st;
+    host_rtos_settle();     // http_pool_get() 返回时批次计数可能还没更新
+    http_pool_get_stats(&st);
+    return st;
+}
+
+// 关闭所有空闲连接，下一个用例从新连接开始
+static void idle_out(void)
+{
+    host_rtos_advance_ms(HTTP_POOL_IDLE_MS + 100);
+}
+
+/* ---------- 用例 ---------- */
+
+static void test_not_initialized(void)
+{
+    http_pool_req_t req = { .url = "http://127.0.0.1:1/", .on_body = sink_body };
+    sink_t sink;
+
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_STATE, http_pool_submit(&req));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_STATE, http_pool_get(req.url, 0, sink_body, &sink, NULL));
+    TEST_ASSERT_EQ_INT(ESP_OK, http_pool_init());
+    TEST_ASSERT_EQ_INT(ESP_OK, http_pool_init());
+}
+
+/* 同一主机的请求复用一个连接 */
+static void test_keep_alive(void)
+{
+    http_pool_stats_t st0 = stats();
+    int conns = srv_get(&s_srv[0].connections);
+    sink_t sink;
+    http_pool_result_t res;
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+        TEST_ASSERT_EQ_INT(200, res.status);
+        TEST_ASSERT(body_ok(&sink, "/json"));
+        TEST_ASSERT_EQ_INT(200, res.bytes);
+        TEST_ASSERT(res.reused == (i > 0));
+        TEST_ASSERT(!res.from_cache);
+    }
+    http_pool_stats_t st = stats();
+    TEST_ASSERT_EQ_INT(conns + 1, srv_get(&s_srv[0].connections));
+    TEST_ASSERT_EQ_INT(1, st.handshakes - st0.handshakes);
+    TEST_ASSERT_EQ_INT(4, st.reuses - st0.reuses);
+    TEST_ASSERT_EQ_INT(5, st.requests - st0.requests);
+    TEST_ASSERT_EQ_INT(0, st.failures - st0.failures);
+}
+
+/* 没有路径、直接跟查询串的地址与同一主机的其他地址共用连接 */
+static void test_origin_without_path(void)
+{
+    int conns = srv_get(&s_srv[0].connections);
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "?x=1", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    TEST_ASSERT_EQ_STR("/?x=1", s_last_path);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "?y=2&z=3", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    TEST_ASSERT(srv_get(&s_srv[0].connections) <= conns + 1);
+}
+
+static void test_chunked(void)
+{
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/chunked", 0, &sink, &res));
+    TEST_ASSERT(body_ok(&sink, "/chunked"));
+    TEST_ASSERT_EQ_INT(700, res.bytes);
+    // 分块响应读完后连接仍可复用
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+}
+
+/* 非 2xx：返回 ESP_ERR_INVALID_RESPONSE，响应体读掉后连接继续使用 */
+static void test_error_status(void)
+{
+    http_pool_stats_t st0 = stats();
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_RESPONSE, get(0, "/404", 0, &sink, &res));
+    TEST_ASSERT_EQ_INT(404, res.status);
+    TEST_ASSERT_EQ_INT(0, sink.len);
+    TEST_ASSERT_EQ_INT(1, stats().failures - st0.failures);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+}
+
+/* ETag：之后发送条件请求，304 时由缓存提供同样的内容 */
+static void test_conditional(void)
+{
+    http_pool_stats_t st0 = stats();
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/etag", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT(!res.from_cache);
+    TEST_ASSERT_EQ_STR("", s_last_inm);
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/etag", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT_EQ_STR("\"v1\"", s_last_inm);
+    TEST_ASSERT(res.from_cache);
+    TEST_ASSERT_EQ_INT(200, res.status);
+    TEST_ASSERT_EQ_INT(0, res.bytes);
+    TEST_ASSERT(body_ok(&sink, "/etag"));
+    http_pool_stats_t st = stats();
+    TEST_ASSERT_EQ_INT(1, st.not_modified - st0.not_modified);
+    TEST_ASSERT_EQ_INT(300, st.saved_bytes - st0.saved_bytes);
+    TEST_ASSERT_EQ_INT(300, st.cache_used);
+
+    // 服务器内容更新
+    s_etag_version = 2;
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/etag", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT(!res.from_cache);
+    TEST_ASSERT_EQ_INT(300, res.bytes);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/etag", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT_EQ_STR("\"v2\"", s_last_inm);
+    TEST_ASSERT(res.from_cache);
+
+    // 不带 HTTP_POOL_F_CACHE 的请求不发送条件请求头
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/etag", 0, &sink, &res));
+    TEST_ASSERT_EQ_STR("", s_last_inm);
+    TEST_ASSERT(!res.from_cache);
+
+    // no-store 的响应不保存
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/nostore", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/nostore", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT_EQ_STR("", s_last_inm);
+    TEST_ASSERT(!res.from_cache);
+}
+
+/* max-age 未过期时不发请求 */
+static void test_max_age(void)
+{
+    http_pool_stats_t st0 = stats();
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(1, "/fresh", HTTP_POOL_F_CACHE, &sink, &res));
+    int requests = srv_get(&s_requests);
+    host_rtos_advance_ms(30000);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(1, "/fresh", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT(res.from_cache);
+    TEST_ASSERT(body_ok(&sink, "/fresh"));
+    TEST_ASSERT_EQ_INT(requests, srv_get(&s_requests));
+    TEST_ASSERT_EQ_INT(1, stats().cache_fresh - st0.cache_fresh);
+
+    host_rtos_advance_ms(31000);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(1, "/fresh", HTTP_POOL_F_CACHE, &sink, &res));
+    TEST_ASSERT(!res.from_cache);
+    TEST_ASSERT_EQ_INT(requests + 1, srv_get(&s_requests));
+}
+
+/* 服务器要求关闭，或响应后静默断开：下一个请求新建连接并成功 */
+static void test_server_close(void)
+{
+    http_pool_stats_t st0 = stats();
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    int conns = srv_get(&s_srv[0].connections);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/close", 0, &sink, &res));
+    TEST_ASSERT(body_ok(&sink, "/close"));
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(!res.reused);
+    TEST_ASSERT_EQ_INT(conns + 1, srv_get(&s_srv[0].connections));
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/drop", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    usleep(20000);      // 等服务器关闭套接字
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(body_ok(&sink, "/json"));
+    TEST_ASSERT(!res.reused);
+    TEST_ASSERT_EQ_INT(conns + 2, srv_get(&s_srv[0].connections));
+    TEST_ASSERT_EQ_INT(0, stats().failures - st0.failures);
+}
+
+/* 连接槽满时替换最久未用的主机 */
+static void test_slot_lru(void)
+{
+    int conns[SERVER_PORTS];
+    sink_t sink;
+    http_pool_result_t res;
+
+    idle_out();
+    for (int i = 0; i < SERVER_PORTS; i++) {
+        conns[i] = srv_get(&s_srv[i].connections);
+    }
+    for (int i = 0; i < HTTP_POOL_SLOTS; i++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, get(i, "/json", 0, &sink, &res));
+        TEST_ASSERT(!res.reused);
+        host_rtos_advance_ms(10);
+    }
+    TEST_ASSERT_EQ_INT(ESP_OK, get(3, "/json", 0, &sink, &res));     // 替换 0
+    TEST_ASSERT(!res.reused);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(1, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));     // 替换 2
+    TEST_ASSERT(!res.reused);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(3, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    TEST_ASSERT_EQ_INT(conns[0] + 2, srv_get(&s_srv[0].connections));
+    TEST_ASSERT_EQ_INT(conns[1] + 1, srv_get(&s_srv[1].connections));
+    TEST_ASSERT_EQ_INT(conns[3] + 1, srv_get(&s_srv[3].connections));
+}
+
+/* 空闲 HTTP_POOL_IDLE_MS 后关闭连接，期间有请求则重新计时 */
+static void test_idle_close(void)
+{
+    sink_t sink;
+    http_pool_result_t res;
+
+    idle_out();
+    TEST_ASSERT_EQ_INT(ESP_OK, get(2, "/json", 0, &sink, &res));
+    host_rtos_advance_ms(HTTP_POOL_IDLE_MS - 1000);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(2, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    host_rtos_advance_ms(HTTP_POOL_IDLE_MS - 1000);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(2, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    host_rtos_advance_ms(HTTP_POOL_IDLE_MS + 100);
+    // 客户端已关闭，服务器端随后看到连接断开
+    for (int i = 0; i < 100 && srv_get(&s_srv[2].open) > 0; i++) {
+        usleep(1000);
+    }
+    TEST_ASSERT_EQ_INT(0, srv_get(&s_srv[2].open));
+    TEST_ASSERT_EQ_INT(ESP_OK, get(2, "/json", 0, &sink, &res));
+    TEST_ASSERT(!res.reused);
+}
+
+/* 响应体回调中止请求：返回回调的错误，连接关闭，之后的请求正常 */
+static void test_body_abort(void)
+{
+    sink_t sink;
+    http_pool_result_t res;
+
+    memset(&sink, 0, sizeof(sink));
+    sink.abort_with = ESP_ERR_INVALID_SIZE;
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_SIZE, http_pool_get(url(0, "/big"), 0, sink_body, &sink, &res));
+    TEST_ASSERT_EQ_INT(1, sink.calls);
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(body_ok(&sink, "/json"));
+    TEST_ASSERT(!res.reused);
+
+    // 在 HTTP 任务中调用同步接口会死锁，直接拒绝
+    memset(&sink, 0, sizeof(sink));
+    sink.nested_get = true;
+    TEST_ASSERT_EQ_INT(ESP_OK, http_pool_get(url(0, "/json"), 0, sink_body, &sink, &res));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_STATE, sink.nested_err);
+}
+
+/* ---------- 推迟与合并 ---------- */
+
+typedef struct {
+    bool done;
+    int order;
+    esp_err_t err;
+    http_pool_result_t res;
+    sink_t sink;
+} done_rec_t;
+
+static int s_done_seq;
+
+static void on_done(esp_err_t err, const http_pool_result_t *res, void *arg)
+{
+    done_rec_t *d = arg;
+    d->done = true;
+    d->order = ++s_done_seq;
+    d->err = err;
+    d->res = *res;
+}
+
+static void submit(int srv, const char *path, uint32_t flags, uint32_t defer_ms, done_rec_t *d)
+{
+    memset(d, 0, sizeof(*d));
+    http_pool_req_t req = {
+        .url = url(srv, path),
+        .flags = flags,
+        .defer_ms = defer_ms,
+        .on_body = sink_body,
+        .body_arg = &d->sink,
+        .on_done = on_done,
+        .done_arg = d,
+    };
+    TEST_ASSERT_EQ_INT(ESP_OK, http_pool_submit(&req));
+    host_rtos_settle();
+}
+
+static void test_defer(void)
+{
+    done_rec_t a, b, c, d;
+    http_pool_stats_t st0 = stats();
+    int requests = srv_get(&s_requests);
+
+    // 只有可推迟的请求时等待
+    submit(0, "/json", HTTP_POOL_F_DEFER, 5000, &a);
+    host_rtos_advance_ms(4000);
+    TEST_ASSERT(!a.done);
+    TEST_ASSERT_EQ_INT(requests, srv_get(&s_requests));
+
+    // 普通请求到来时一起执行，按提交顺序
+    submit(1, "/json", 0, 0, &b);
+    TEST_ASSERT(a.done && b.done);
+    TEST_ASSERT(a.order < b.order);
+    TEST_ASSERT_EQ_INT(ESP_OK, a.err);
+    TEST_ASSERT(body_ok(&a.sink, "/json"));
+    TEST_ASSERT_EQ_INT(1, stats().batches - st0.batches);
+
+    // 没有其他请求时到期执行
+    submit(0, "/json", HTTP_POOL_F_DEFER | HTTP_POOL_F_CACHE, 5000, &c);
+    host_rtos_advance_ms(4900);
+    TEST_ASSERT(!c.done);
+    host_rtos_advance_ms(200);
+    TEST_ASSERT(c.done);
+    TEST_ASSERT_EQ_INT(ESP_OK, c.err);
+    TEST_ASSERT_EQ_INT(2, stats().batches - st0.batches);
+
+    // 天气服务的用法：两个可推迟请求一起提交，同一批完成
+    submit(0, "/json", HTTP_POOL_F_DEFER | HTTP_POOL_F_CACHE, 60000, &c);
+    submit(1, "/fresh?air", HTTP_POOL_F_DEFER | HTTP_POOL_F_CACHE, 60000, &d);
+    host_rtos_advance_ms(59000);
+    TEST_ASSERT(!c.done && !d.done);
+    host_rtos_advance_ms(1100);
+    TEST_ASSERT(c.done && d.done);
+    TEST_ASSERT(body_ok(&d.sink, "/fresh?air"));
+    TEST_ASSERT_EQ_INT(3, stats().batches - st0.batches);
+
+    // 没有推迟标志时 defer_ms 不起作用
+    submit(0, "/json", 0, 60000, &c);
+    TEST_ASSERT(c.done);
+}
+
+/* 等待的请求达到队列长度时不再等待 */
+static void test_defer_queue_full(void)
+{
+    static done_rec_t recs[HTTP_POOL_QUEUE_LEN];
+    http_pool_stats_t st0 = stats();
+
+    for (int i = 0; i < HTTP_POOL_QUEUE_LEN; i++) {
+        submit(i % SERVER_PORTS, "/json", HTTP_POOL_F_DEFER, 60000, &recs[i]);
+        TEST_ASSERT(recs[i].done == (i == HTTP_POOL_QUEUE_LEN - 1));
+    }
+    for (int i = 0; i < HTTP_POOL_QUEUE_LEN; i++) {
+        TEST_ASSERT(recs[i].done && recs[i].err == ESP_OK);
+    }
+    TEST_ASSERT_EQ_INT(1, stats().batches - st0.batches);
+}
+
+/* WLAN 断开时关闭所有连接 */
+static void test_wifi_disconnect(void)
+{
+    sink_t sink;
+    http_pool_result_t res;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(res.reused);
+    esp_event_post(WIFI_MGR_EVENT, WIFI_MGR_EVENT_DISCONNECTED, NULL, 0, 0);
+    host_rtos_settle();
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+    TEST_ASSERT(!res.reused);
+}
+
+static void test_connect_refused(void)
+{
+    http_pool_stats_t st0 = stats();
+    http_pool_result_t res;
+    char buf[64];
+    int port;
+    int fd = listen_any(&port);
+    sink_t sink;
+
+    close(fd);      // 端口不再有人监听
+    snprintf(buf, sizeof(buf), "http://127.0.0.1:%d/json", port);
+    memset(&sink, 0, sizeof(sink));
+    TEST_ASSERT(http_pool_get(buf, 0, sink_body, &sink, &res) != ESP_OK);
+    TEST_ASSERT_EQ_INT(0, res.status);
+    TEST_ASSERT_EQ_INT(1, stats().failures - st0.failures);
+    // 不影响其他主机
+    TEST_ASSERT_EQ_INT(ESP_OK, get(0, "/json", 0, &sink, &res));
+}
+
+static int64_t real_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* 本机回环上复用连接与每次新建连接的耗时（不含 TLS，设备上新建 HTTPS 连接的差距大得多） */
+static void test_bench(void)
+{
+    const int n = 300;
+    sink_t sink;
+    http_pool_result_t res;
+
+    get(0, "/json", 0, &sink, &res);
+    int64_t t0 = real_us();
+    for (int i = 0; i < n; i++) {
+        get(0, "/json", 0, &sink, &res);
+    }
+    int64_t t1 = real_us();
+    for (int i = 0; i < n; i++) {
+        get(0, "/close", 0, &sink, &res);
+    }
+    int64_t t2 = real_us();
+    printf("  per request on loopback: keep-alive %.0f us, new connection %.0f us\n", (double)(t1 - t0) / n,
+           (double)(t2 - t1) / n);
+}
+
+int main(void)
+{
+    host_log_level = ESP_LOG_ERROR;
+    if (!server_start()) {
+        printf("cannot listen on 127.0.0.1\n");
+        return 1;
+    }
+    RUN_TEST(test_not_initialized);
+    RUN_TEST(test_keep_alive);
+    RUN_TEST(test_origin_without_path);
+    RUN_TEST(test_chunked);
+    RUN_TEST(test_error_status);
+    RUN_TEST(test_conditional);
+    RUN_TEST(test_max_age);
+    RUN_TEST(test_server_close);
+    RUN_TEST(test_slot_lru);
+    RUN_TEST(test_idle_close);
+    RUN_TEST(test_body_abort);
+    RUN_TEST(test_defer);
+    RUN_TEST(test_defer_queue_full);
+    RUN_TEST(test_wifi_disconnect);
+    RUN_TEST(test_connect_refused);
+    RUN_TEST(test_bench);
+    return TEST_EXIT();
+}
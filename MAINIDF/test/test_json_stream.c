@@ -0,0 +1,518 @@
+/**
+ * @file test_json_stream.c
+ * @brief json_stream 主机测试
+ *
+ * 随机生成 JSON 文档，生成时同时记下应得到的回调（路径、类型、解码后的值），
+ * 整块、逐字节和随机分块送入后与之比较；另有错误输入、转义与代理项、截断和吞吐量测试。
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "json_stream.h"
+
+#define DOC_MAX     65536
+#define EVENT_MAX   2048
+
+typedef struct {
+    char path[JSON_STREAM_PATH_MAX];
+    json_stream_type_t type;
+    char val[JSON_STREAM_VALUE_MAX];
+} event_t;
+
+typedef struct {
+    event_t ev[EVENT_MAX];
+    int count;
+} events_t;
+
+static events_t s_exp, s_act;
+static char s_doc[DOC_MAX];
+static size_t s_len;
+
+static uint32_t s_rng = 46;
+
+static uint32_t next_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static void record_cb(const char *path, json_stream_type_t type, const char *value, void *arg)
+{
+    events_t *e = arg;
+
+    if (e->count < EVENT_MAX) {
+        event_t *ev = &e->ev[e->count];
+        snprintf(ev->path, sizeof(ev->path), "%s", path);
+        ev->type = type;
+        snprintf(ev->val, sizeof(ev->val), "%s", value);
+    }
+    e->count++;
+}
+
+/* ---- 生成器 ---- */
+
+static void put(const char *s)
+{
+    size_t n = strlen(s);
+    if (s_len + n < DOC_MAX) {
+        memcpy(s_doc + s_len, s, n);
+        s_len += n;
+    }
+}
+
+static void put_ws(void)
+{
+    static const char *const ws[] = { "", "", "", " ", "\n", "\r\n  ", "\t" };
+    put(ws[next_rand() % 7]);
+}
+
+static void expect(const char *path, json_stream_type_t type, const char *val)
+{
+    if (s_exp.count < EVENT_MAX) {
+        event_t *ev = &s_exp.ev[s_exp.count];
+        snprintf(ev->path, sizeof(ev->path), "%s", path);
+        ev->type = type;
+        snprintf(ev->val, sizeof(ev->val), "%s", val);
+    }
+    s_exp.count++;
+}
+
+/*
+ * 随机字符串，写入带转义的 JSON 文本，decoded 得到解码结果；长度不超过值缓冲区。
+ * ident 为真时只用字母数字，作键名时路径不含 '.'
+ */
+static void gen_string(char *decoded, bool ident)
+{
+    static const char *const pieces[][2] = {
+        {"a", "a"}, {"Z", "Z"}, {"7", "7"}, {" ", " "}, {"\\\"", "\""}, {"\\\\", "\\"}, {"\\/", "/"},
+        {"\\n", "\n"}, {"\\t", "\t"}, {"\\u0041", "A"}, {"\\u00e9", "\xc3\xa9"}, {"\xe4\xb8\xad", "\xe4\xb8\xad"},
+        {"\\u4e2d", "\xe4\xb8\xad"}, {"\\ud83d\\ude00", "\xf0\x9f\x98\x80"}, {"\\uD834\\uDD1E", "\xf0\x9d\x84\x9e"},
+    };
+    size_t n = 0, count = next_rand() % 8;
+
+    decoded[0] = '\0';
+    put("\"");
+    for (size_t i = 0; i < count; i++) {
+        size_t k = ident ? next_rand() % 3 : next_rand() % (sizeof(pieces) / sizeof(pieces[0]));
+        size_t m = strlen(pieces[k][1]);
+        if (n + m >= JSON_STREAM_VALUE_MAX - 1) {
+            break;
+        }
+        put(pieces[k][0]);
+        memcpy(decoded + n, pieces[k][1], m + 1);
+        n += m;
+    }
+    put("\"");
+}
+
+static void gen_number(char *text)
+{
+    static const char *const forms[] = { "%d", "-%d", "%d.%d", "-%d.%de+%d", "%dE-%d", "%d.%de%d" };
+    int a = next_rand() % 100000, b = next_rand() % 1000, c = next_rand() % 300;
+
+    snprintf(text, 32, forms[next_rand() % 6], a, b, c);
+    put(text);
+}
+
+static void gen_value(const char *path, int depth)
+{
+    char text[JSON_STREAM_VALUE_MAX];
+    uint32_t r = next_rand() % (depth < 6 ? 8 : 5);
+
+    put_ws();
+    switch (r) {
+    case 0:
+    case 1:
+        gen_string(text, false);
+        expect(path, JSON_STREAM_STRING, text);
+        break;
+    case 2:
+        gen_number(text);
+        expect(path, JSON_STREAM_NUMBER, text);
+        break;
+    case 3: {
+        static const char *const lits[] = { "true", "false", "null" };
+        const char *l = lits[next_rand() % 3];
+        put(l);
+        expect(path, l[0] == 'n' ? JSON_STREAM_NULL : JSON_STREAM_BOOL, l);
+        break;
+    }
+    case 4:
+        gen_number(text);
+        expect(path, JSON_STREAM_NUMBER, text);
+        break;
+    case 5:
+    case 6: {
+        int n = next_rand() % 5;
+        put("{");
+        for (int i = 0; i < n; i++) {
+            char key[JSON_STREAM_VALUE_MAX], sub[JSON_STREAM_PATH_MAX];
+            put_ws();
+            gen_string(key, true);
+            put_ws();
+            put(":");
+            snprintf(sub, sizeof(sub), "%s%s%s", path, path[0] ? "." : "", key);
+            gen_value(sub, depth + 1);
+            put_ws();
+            if (i + 1 < n) {
+                put(",");
+            }
+        }
+        put_ws();
+        put("}");
+        break;
+    }
+    default: {
+        int n = next_rand() % 5;
+        put("[");
+        for (int i = 0; i < n; i++) {
+            char sub[JSON_STREAM_PATH_MAX];
+            snprintf(sub, sizeof(sub), "%s%s%d", path, path[0] ? "." : "", i);
+            gen_value(sub, depth + 1);
+            put_ws();
+            if (i + 1 < n) {
+                put(",");
+            }
+        }
+        put_ws();
+        put("]");
+        break;
+    }
+    }
+}
+
+/* ---- 比较 ---- */
+
+// 按 chunk 分块送入（0 为随机分块），返回 finish 的结果
+static esp_err_t parse(const char *doc, size_t len, size_t chunk, events_t *out)
+{
+    json_stream_t js;
+    esp_err_t err = ESP_OK;
+
+    out->count = 0;
+    json_stream_init(&js, record_cb, out);
+    for (size_t i = 0; i < len && err == ESP_OK;) {
+        size_t n = chunk ? chunk : 1 + next_rand() % 16;
+        if (n > len - i) {
+            n = len - i;
+        }
+        err = json_stream_feed(&js, doc + i, n);
+        i += n;
+    }
+    return err == ESP_OK ? json_stream_finish(&js) : err;
+}
+
+static bool events_equal(const events_t *exp, const events_t *act, const char *what)
+{
+    if (exp->count != act->count) {
+        TEST_FAIL("%s: %d events, expected %d", what, act->count, exp->count);
+        return false;
+    }
+    for (int i = 0; i < exp->count && i < EVENT_MAX; i++) {
+        const event_t *a = &act->ev[i], *e = &exp->ev[i];
+        if (a->type != e->type || strcmp(a->path, e->path) != 0 || strcmp(a->val, e->val) != 0) {
+            TEST_FAIL("%s: event %d \"%s\" %d \"%s\", expected \"%s\" %d \"%s\"", what, i, a->path, a->type, a->val,
+                      e->path, e->type, e->val);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_random_documents(void)
+{
+    static const size_t chunks[] = { 1 << 20, 1, 2, 3, 7, 0 };
+
+    for (int doc = 0; doc < 3000; doc++) {
+        s_len = 0;
+        s_exp.count = 0;
+        gen_value("", 0);
+        put_ws();
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+            char what[48];
+            snprintf(what, sizeof(what), "doc %d chunk %zu", doc, chunks[c]);
+            if (parse(s_doc, s_len, chunks[c], &s_act) != ESP_OK) {
+                TEST_FAIL("%s rejected: %.*s", what, (int)s_len, s_doc);
+                return;
+            }
+            if (!events_equal(&s_exp, &s_act, what)) {
+                printf("  %.*s\n", (int)s_len, s_doc);
+                return;
+            }
+        }
+    }
+}
+
+/* 每个可能的切分点各切一次 */
+static void test_every_split(void)
+{
+    const char *doc = "{\"a\": [1, -2.5e3, \"x\\u4e2dy\", {\"b\": null}], \"c\\\"d\": true, \"e\": \"\\ud83d\\ude00\"}";
+    size_t len = strlen(doc);
+    events_t *whole = malloc(sizeof(*whole));
+
+    TEST_ASSERT(whole != NULL);
+    if (!whole) {
+        return;
+    }
+    TEST_ASSERT_EQ_INT(ESP_OK, parse(doc, len, len, whole));
+    TEST_ASSERT_EQ_INT(6, whole->count);
+    TEST_ASSERT_EQ_STR("a.2", whole->ev[2].path);
+    TEST_ASSERT_EQ_STR("x\xe4\xb8\xady", whole->ev[2].val);
+    TEST_ASSERT_EQ_STR("a.3.b", whole->ev[3].path);
+    TEST_ASSERT_EQ_STR("c\"d", whole->ev[4].path);
+    TEST_ASSERT_EQ_STR("\xf0\x9f\x98\x80", whole->ev[5].val);
+
+    for (size_t cut = 1; cut < len; cut++) {
+        json_stream_t js;
+        s_act.count = 0;
+        json_stream_init(&js, record_cb, &s_act);
+        TEST_ASSERT_EQ_INT(ESP_OK, json_stream_feed(&js, doc, cut));
+        TEST_ASSERT_EQ_INT(ESP_OK, json_stream_feed(&js, doc + cut, len - cut));
+        TEST_ASSERT_EQ_INT(ESP_OK, json_stream_finish(&js));
+        if (!events_equal(whole, &s_act, "split")) {
+            printf("  cut at %zu\n", cut);
+            break;
+        }
+    }
+    free(whole);
+}
+
+static void test_top_level_scalars(void)
+{
+    static const struct {
+        const char *doc;
+        json_stream_type_t type;
+        const char *val;
+    } cases[] = {
+        {"42", JSON_STREAM_NUMBER, "42"},
+        {" -1.5e-3 \n", JSON_STREAM_NUMBER, "-1.5e-3"},
+        {"true", JSON_STREAM_BOOL, "true"},
+        {"null ", JSON_STREAM_NULL, "null"},
+        {"\"s\"", JSON_STREAM_STRING, "s"},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, parse(cases[i].doc, strlen(cases[i].doc), 1, &s_act));
+        TEST_ASSERT_EQ_INT(1, s_act.count);
+        TEST_ASSERT_EQ_STR("", s_act.ev[0].path);
+        TEST_ASSERT_EQ_INT(cases[i].type, s_act.ev[0].type);
+        TEST_ASSERT_EQ_STR(cases[i].val, s_act.ev[0].val);
+    }
+    TEST_ASSERT_EQ_INT(ESP_OK, parse("{}", 2, 1, &s_act));
+    TEST_ASSERT_EQ_INT(0, s_act.count);
+    TEST_ASSERT_EQ_INT(ESP_OK, parse("[[],{}]", 7, 1, &s_act));
+    TEST_ASSERT_EQ_INT(0, s_act.count);
+}
+
+/* 错误输入：at 为出错字节的位置，-1 表示 feed 全部接受、finish 报告不完整 */
+static void test_errors(void)
+{
+    static const struct {
+        const char *doc;
+        int at;
+    } cases[] = {
+        {"", -1},
+        {"   ", -1},
+        {"{", -1},
+        {"[1, 2", -1},
+        {"\"abc", -1},
+        {"\"\\u12", -1},
+        {"tru", -1},
+        {"{\"a\":", -1},
+        {"[1,]", 3},
+        {"{\"a\":1,}", 7},
+        {"{\"a\" 1}", 5},
+        {"[1 2]", 3},
+        {"{1:2}", 1},
+        {"[}", 1},
+        {"{]", 1},
+        {"]", 0},
+        {"{}}", 2},
+        {"1 2", 2},
+        {"truex", -1},                  // 字面量到结束才检查
+        {"nul]", 3},
+        {"\"a\nb\"", 2},
+        {"\"a\\x\"", 3},
+        {"\"\\u12G4\"", 5},
+        {"[1,+2]", 3},
+        {"[[[[[[[[[1]]]]]]]]]", 8},     // 第 9 层
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const char *doc = cases[i].doc;
+        size_t len = strlen(doc);
+        json_stream_t js;
+
+        json_stream_init(&js, record_cb, &s_act);
+        esp_err_t err = json_stream_feed(&js, doc, len);
+        if (cases[i].at < 0) {
+            TEST_ASSERT_EQ_INT(ESP_OK, err);
+        } else if (err != ESP_ERR_INVALID_RESPONSE || js.offset != (uint32_t)cases[i].at) {
+            TEST_FAIL("\"%s\": err %d at %u, expected error at %d", doc, err, js.offset, cases[i].at);
+        }
+        TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_RESPONSE, json_stream_finish(&js));
+        // 出错后一直拒绝
+        if (cases[i].at >= 0) {
+            TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_RESPONSE, json_stream_feed(&js, "{}", 2));
+        }
+        // 逐字节送入结果相同
+        TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_RESPONSE, parse(doc, len, 1, &s_act));
+    }
+    // 正好 8 层可以
+    TEST_ASSERT_EQ_INT(ESP_OK, parse("[[[[[[[[1]]]]]]]]", 17, 1, &s_act));
+    TEST_ASSERT_EQ_STR("0.0.0.0.0.0.0.0", s_act.ev[0].path);
+}
+
+/* 不成对的代理项输出 U+FFFD */
+static void test_surrogates(void)
+{
+    static const struct {
+        const char *doc;
+        const char *val;
+    } cases[] = {
+        {"\"\\ud83d\\ude00\"", "\xf0\x9f\x98\x80"},
+        {"\"\\ud83da\"", "\xef\xbf\xbd" "a"},
+        {"\"\\ude00\"", "\xef\xbf\xbd"},
+        {"\"\\ud83d\"", "\xef\xbf\xbd"},
+        {"\"\\ud83d\\ud83d\\ude00\"", "\xef\xbf\xbd\xf0\x9f\x98\x80"},
+        {"\"\\ud83d\\n\"", "\xef\xbf\xbd\n"},
+        {"\"\\u0000x\"", "" /* NUL 截断 C 字符串 */},
+        {"\"\\u007f\\u0080\\u07ff\\u0800\\uffff\"", "\x7f\xc2\x80\xdf\xbf\xe0\xa0\x80\xef\xbf\xbf"},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, parse(cases[i].doc, strlen(cases[i].doc), 1, &s_act));
+        TEST_ASSERT_EQ_STR(cases[i].val, s_act.ev[0].val);
+    }
+}
+
+/* 超长键名、值和路径被截断，不影响后续解析 */
+static void test_truncation(void)
+{
+    char doc[512], key[101], val[101];
+
+    memset(key, 'k', 100);
+    key[100] = '\0';
+    memset(val, 'v', 100);
+    val[100] = '\0';
+    snprintf(doc, sizeof(doc), "{\"%s\": \"%s\", \"n\": 1, \"%s\": {\"%s\": [2]}}", key, val, key, key);
+    TEST_ASSERT_EQ_INT(ESP_OK, parse(doc, strlen(doc), 3, &s_act));
+    TEST_ASSERT_EQ_INT(3, s_act.count);
+    TEST_ASSERT_EQ_INT(JSON_STREAM_VALUE_MAX - 1, strlen(s_act.ev[0].path));
+    TEST_ASSERT_EQ_INT(JSON_STREAM_VALUE_MAX - 1, strlen(s_act.ev[0].val));
+    TEST_ASSERT_EQ_STR("n", s_act.ev[1].path);
+    TEST_ASSERT_EQ_STR("1", s_act.ev[1].val);
+    TEST_ASSERT_EQ_INT(JSON_STREAM_PATH_MAX - 1, strlen(s_act.ev[2].path));
+    TEST_ASSERT_EQ_STR("2", s_act.ev[2].val);
+
+    // \u 转义的多字节字符不会被截成半个："中" 3 字节，47 字节放 15 个
+    char *p = doc;
+    p += sprintf(p, "[\"");
+    for (int i = 0; i < 20; i++) {
+        p += sprintf(p, "\\u4e2d");
+    }
+    sprintf(p, "\"]");
+    TEST_ASSERT_EQ_INT(ESP_OK, parse(doc, strlen(doc), 1 << 20, &s_act));
+    TEST_ASSERT_EQ_INT(45, strlen(s_act.ev[0].val));
+}
+
+/* weather 使用的 open-meteo 响应，按 HTTP 读取的块大小送入 */
+static void test_open_meteo(void)
+{
+    const char *doc =
+        "{\"latitude\":31.2,\"longitude\":121.5,\"generationtime_ms\":0.05,\"utc_offset_seconds\":28800,"
+        "\"timezone\":\"Asia/Shanghai\",\"current_units\":{\"time\":\"iso8601\",\"temperature_2m\":\"\xc2\xb0" "C\"},"
+        "\"current\":{\"time\":\"2024-06-01T12:00\",\"interval\":900,\"temperature_2m\":27.4,"
+        "\"relative_humidity_2m\":61,\"weather_code\":3,\"wind_speed_10m\":11.2},"
+        "\"daily_units\":{\"temperature_2m_max\":\"\xc2\xb0" "C\"},"
+        "\"daily\":{\"time\":[\"2024-06-01\",\"2024-06-02\"],\"temperature_2m_max\":[29.1,30.0],"
+        "\"temperature_2m_min\":[21.3,null]}}";
+    static const char *const want[][2] = {
+        {"current.temperature_2m", "27.4"},
+        {"current.weather_code", "3"},
+        {"current.relative_humidity_2m", "61"},
+        {"current.wind_speed_10m", "11.2"},
+        {"daily.temperature_2m_max.0", "29.1"},
+        {"daily.temperature_2m_min.0", "21.3"},
+        {"daily.temperature_2m_min.1", "null"},
+        {"current_units.temperature_2m", "\xc2\xb0" "C"},
+    };
+
+    for (size_t chunk = 1; chunk <= 512; chunk *= 2) {
+        TEST_ASSERT_EQ_INT(ESP_OK, parse(doc, strlen(doc), chunk, &s_act));
+        for (size_t k = 0; k < sizeof(want) / sizeof(want[0]); k++) {
+            int found = 0;
+            for (int i = 0; i < s_act.count; i++) {
+                if (strcmp(s_act.ev[i].path, want[k][0]) == 0) {
+                    found++;
+                    TEST_ASSERT_EQ_STR(want[k][1], s_act.ev[i].val);
+                }
+            }
+            TEST_ASSERT_EQ_INT(1, found);
+        }
+    }
+}
+
+static void count_cb(const char *path, json_stream_type_t type, const char *value, void *arg)
+{
+    (*(uint32_t *)arg)++;
+}
+
+/* 吞吐量：open-meteo 七天逐小时预报格式，约 6 KB */
+static void test_bench(void)
+{
+    const int rounds = 200;
+    uint32_t values = 0;
+
+    s_len = 0;
+    put("{\"hourly\":{\"time\":[");
+    for (int i = 0; i < 168; i++) {
+        char t[32];
+        snprintf(t, sizeof(t), "%s\"2024-06-%02dT%02d:00\"", i ? "," : "", 1 + i / 24, i % 24);
+        put(t);
+    }
+    static const char *const fields[] = { "temperature_2m", "relative_humidity_2m", "weather_code", "wind_speed_10m" };
+    for (size_t f = 0; f < 4; f++) {
+        put("],\"");
+        put(fields[f]);
+        put("\":[");
+        for (int i = 0; i < 168; i++) {
+            char t[16];
+            snprintf(t, sizeof(t), "%s%d.%d", i ? "," : "", (int)(next_rand() % 40), (int)(next_rand() % 10));
+            put(t);
+        }
+    }
+    put("]}}");
+
+    for (size_t chunk = 64; chunk <= 4096; chunk *= 64) {
+        int64_t t0 = esp_timer_get_time();
+        for (int r = 0; r < rounds; r++) {
+            json_stream_t js;
+            json_stream_init(&js, count_cb, &values);
+            for (size_t i = 0; i < s_len; i += chunk) {
+                json_stream_feed(&js, s_doc + i, s_len - i < chunk ? s_len - i : chunk);
+            }
+            TEST_ASSERT_EQ_INT(ESP_OK, json_stream_finish(&js));
+        }
+        int64_t t1 = esp_timer_get_time();
+        printf("  %zu B document, %zu B chunks: %.1f MB/s, %.0f ns per value\n", s_len, chunk,
+               (double)s_len * rounds / (t1 - t0), (t1 - t0) * 1000.0 / (168 * 5 * rounds));
+    }
+    TEST_ASSERT_EQ_INT(168 * 5 * rounds * 2, values);
+}
+
+int main(void)
+{
+    RUN_TEST(test_random_documents);
+    RUN_TEST(test_every_split);
+    RUN_TEST(test_top_level_scalars);
+    RUN_TEST(test_errors);
+    RUN_TEST(test_surrogates);
+    RUN_TEST(test_truncation);
+    RUN_TEST(test_open_meteo);
+    RUN_TEST(test_bench);
+    return TEST_EXIT();
+}
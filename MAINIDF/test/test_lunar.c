@@ -0,0 +1,423 @@
+/**
+ * @file test_lunar.c
+ * @brief lunar 主机测试
+ *
+ * 参考数据为公开日历（万年历）上的已知日期：历年春节、闰月起始、节日和节气。
+ * 另外对支持范围内的每一天做公历→农历→公历往返，并检查逐日递推、按月计算与逐日查询一致。
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "lunar.h"
+
+typedef struct {
+    int y, m, d;            // 公历
+    int ly, lm, ld;         // 农历
+    bool leap;
+} ref_date_t;
+
+/* 春节、闰月初一、年末等 */
+static const ref_date_t s_dates[] = {
+    {1900,  1, 31, 1900,  1,  1, false},    // 支持范围的第一天
+    {1949,  1, 29, 1949,  1,  1, false},
+    {1950,  2, 17, 1950,  1,  1, false},
+    {1976,  1, 31, 1976,  1,  1, false},
+    {1985,  2, 20, 1985,  1,  1, false},
+    {2000,  2,  5, 2000,  1,  1, false},
+    {2001,  1, 24, 2001,  1,  1, false},
+    {2008,  2,  7, 2008,  1,  1, false},
+    {2010,  2, 14, 2010,  1,  1, false},
+    {2012,  1, 23, 2012,  1,  1, false},
+    {2015,  2, 19, 2015,  1,  1, false},
+    {2017,  1, 28, 2017,  1,  1, false},
+    {2019,  2,  5, 2019,  1,  1, false},
+    {2020,  1, 25, 2020,  1,  1, false},
+    {2021,  2, 12, 2021,  1,  1, false},
+    {2022,  2,  1, 2022,  1,  1, false},
+    {2023,  1, 22, 2023,  1,  1, false},
+    {2024,  2, 10, 2024,  1,  1, false},
+    {2025,  1, 29, 2025,  1,  1, false},
+    {2026,  2, 17, 2026,  1,  1, false},
+    {2027,  2,  6, 2027,  1,  1, false},
+    {2028,  1, 26, 2028,  1,  1, false},
+    {2030,  2,  3, 2030,  1,  1, false},
+    {2050,  1, 23, 2050,  1,  1, false},
+    {2100,  2,  9, 2100,  1,  1, false},
+    {2024,  2,  9, 2023, 12, 30, false},    // 除夕为腊月三十
+    {2025,  1, 28, 2024, 12, 29, false},    // 2025 年没有年三十
+    {2009,  6, 23, 2009,  5,  1, true},     // 闰五月
+    {2012,  5, 21, 2012,  4,  1, true},     // 闰四月
+    {2014, 10, 24, 2014,  9,  1, true},     // 闰九月
+    {2017,  7, 23, 2017,  6,  1, true},     // 闰六月
+    {2020,  5, 23, 2020,  4,  1, true},     // 闰四月
+    {2020,  6, 20, 2020,  4, 29, true},
+    {2020,  6, 21, 2020,  5,  1, false},
+    {2023,  3, 22, 2023,  2,  1, true},     // 闰二月
+    {2025,  7, 25, 2025,  6,  1, true},     // 闰六月
+    {2033, 12, 22, 2033, 11,  1, true},     // 闰十一月（“2033 年问题”）
+    {2101,  1, 28, 2100, 12, 29, false},    // 支持范围的最后一天，2100 年腊月小
+};
+
+/* 节日，2020-10-01 中秋与国庆同一天时按公历节日 */
+static const struct {
+    int y, m, d;
+    lunar_holiday_t holiday;
+} s_holidays[] = {
+    {2024,  1,  1, LUNAR_HOLIDAY_NEW_YEAR},
+    {2024,  2, 10, LUNAR_HOLIDAY_SPRING},
+    {2024,  3,  8, LUNAR_HOLIDAY_WOMEN},
+    {2019,  4,  5, LUNAR_HOLIDAY_QINGMING},
+    {2020,  4,  4, LUNAR_HOLIDAY_QINGMING},
+    {2023,  4,  5, LUNAR_HOLIDAY_QINGMING},
+    {2024,  4,  4, LUNAR_HOLIDAY_QINGMING},
+    {2025,  4,  4, LUNAR_HOLIDAY_QINGMING},
+    {2024,  5,  1, LUNAR_HOLIDAY_LABOUR},
+    {2024,  6,  1, LUNAR_HOLIDAY_CHILDREN},
+    {2020,  6, 25, LUNAR_HOLIDAY_DRAGON_BOAT},
+    {2022,  6,  3, LUNAR_HOLIDAY_DRAGON_BOAT},
+    {2023,  6, 22, LUNAR_HOLIDAY_DRAGON_BOAT},
+    {2024,  6, 10, LUNAR_HOLIDAY_DRAGON_BOAT},
+    {2025,  5, 31, LUNAR_HOLIDAY_DRAGON_BOAT},
+    {2021,  9, 21, LUNAR_HOLIDAY_MID_AUTUMN},
+    {2022,  9, 10, LUNAR_HOLIDAY_MID_AUTUMN},
+    {2023,  9, 29, LUNAR_HOLIDAY_MID_AUTUMN},
+    {2024,  9, 17, LUNAR_HOLIDAY_MID_AUTUMN},
+    {2025, 10,  6, LUNAR_HOLIDAY_MID_AUTUMN},
+    {2020, 10,  1, LUNAR_HOLIDAY_NATIONAL},
+    {2024, 10,  2, LUNAR_HOLIDAY_NONE},
+    {2020,  6, 24, LUNAR_HOLIDAY_NONE},
+    {2009,  6, 27, LUNAR_HOLIDAY_NONE},     // 闰五月初五不是端午
+    {1900,  1, 30, LUNAR_HOLIDAY_NONE},     // 超出范围
+};
+
+/* 节气：0 小寒 2 立春 11 夏至 17 秋分 23 冬至 */
+static const struct {
+    int y, m, d, term;
+} s_terms[] = {
+    {2024,  1,  6,  0}, {2025,  1,  5,  0},
+    {2021,  2,  3,  2}, {2023,  2,  4,  2}, {2024,  2,  4,  2}, {2025,  2,  3,  2},
+    {2023,  4,  5,  6}, {2024,  4,  4,  6},
+    {2023,  6, 21, 11}, {2024,  6, 21, 11},
+    {2023,  9, 23, 17}, {2024,  9, 22, 17},
+    {2021, 12, 21, 23}, {2022, 12, 22, 23}, {2023, 12, 22, 23}, {2024, 12, 21, 23},
+};
+
+static int32_t s_days_in[13] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+static int month_days(int y, int m)
+{
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return s_days_in[m] + (m == 2 && leap);
+}
+
+static void test_reference_dates(void)
+{
+    for (size_t i = 0; i < sizeof(s_dates) / sizeof(s_dates[0]); i++) {
+        const ref_date_t *r = &s_dates[i];
+        lunar_date_t ld;
+        int y, m, d;
+
+        if (lunar_from_solar(r->y, r->m, r->d, &ld) != ESP_OK) {
+            TEST_FAIL("%04d-%02d-%02d rejected", r->y, r->m, r->d);
+            continue;
+        }
+        if (ld.year != r->ly || ld.month != r->lm || ld.day != r->ld || ld.leap != r->leap) {
+            TEST_FAIL("%04d-%02d-%02d: %d %s%d-%d, expected %d %s%d-%d", r->y, r->m, r->d, ld.year,
+                      ld.leap ? "leap " : "", ld.month, ld.day, r->ly, r->leap ? "leap " : "", r->lm, r->ld);
+        }
+        lunar_date_t in = { .year = r->ly, .month = r->lm, .day = r->ld, .leap = r->leap };
+        if (lunar_to_solar(&in, &y, &m, &d) != ESP_OK) {
+            TEST_FAIL("lunar %d %s%d-%d rejected", r->ly, r->leap ? "leap " : "", r->lm, r->ld);
+        } else if (y != r->y || m != r->m || d != r->d) {
+            TEST_FAIL("lunar %d %s%d-%d -> %04d-%02d-%02d, expected %04d-%02d-%02d", r->ly, r->leap ? "leap " : "",
+                      r->lm, r->ld, y, m, d, r->y, r->m, r->d);
+        }
+    }
+}
+
+static void test_reference_holidays_and_terms(void)
+{
+    for (size_t i = 0; i < sizeof(s_holidays) / sizeof(s_holidays[0]); i++) {
+        lunar_holiday_t h = lunar_holiday(s_holidays[i].y, s_holidays[i].m, s_holidays[i].d);
+        if (h != s_holidays[i].holiday) {
+            TEST_FAIL("%04d-%02d-%02d: holiday %d \"%s\", expected %d", s_holidays[i].y, s_holidays[i].m,
+                      s_holidays[i].d, h, lunar_holiday_name(h), s_holidays[i].holiday);
+        }
+    }
+    for (size_t i = 0; i < sizeof(s_terms) / sizeof(s_terms[0]); i++) {
+        int t = lunar_solar_term(s_terms[i].y, s_terms[i].m, s_terms[i].d);
+        if (t != s_terms[i].term) {
+            TEST_FAIL("%04d-%02d-%02d: term %d, expected %d (%s)", s_terms[i].y, s_terms[i].m, s_terms[i].d, t,
+                      s_terms[i].term, lunar_term_name(s_terms[i].term));
+        }
+        TEST_ASSERT_EQ_INT(s_terms[i].d, lunar_term_day(s_terms[i].y, s_terms[i].term));
+        TEST_ASSERT_EQ_INT(LUNAR_NO_TERM, lunar_solar_term(s_terms[i].y, s_terms[i].m, s_terms[i].d + 1));
+    }
+    TEST_ASSERT_EQ_STR("冬至", lunar_term_name(23));
+    TEST_ASSERT_EQ_STR("", lunar_term_name(24));
+    TEST_ASSERT_EQ_STR("中秋节", lunar_holiday_name(LUNAR_HOLIDAY_MID_AUTUMN));
+    TEST_ASSERT_EQ_STR("", lunar_holiday_name(LUNAR_HOLIDAY_MAX));
+}
+
+static void test_range_edges(void)
+{
+    lunar_date_t ld;
+    int y, m, d;
+
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(1900, 1, 30, &ld));
+    TEST_ASSERT_EQ_INT(ESP_OK, lunar_from_solar(1900, 1, 31, &ld));
+    TEST_ASSERT_EQ_INT(ESP_OK, lunar_from_solar(2101, 1, 28, &ld));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(2101, 1, 29, &ld));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(1899, 12, 31, &ld));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(2024, 2, 30, &ld));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(2023, 2, 29, &ld));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(2024, 13, 1, &ld));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_from_solar(2024, 0, 1, &ld));
+
+    lunar_date_t bad[] = {
+        {1899, 12, 1, false},
+        {2101, 1, 1, false},
+        {2024, 13, 1, false},
+        {2024, 1, 31, false},
+        {2024, 4, 1, true},     // 2024 年没有闰月
+        {2020, 5, 1, true},     // 2020 年闰四月，不是闰五月
+        {2025, 1, 0, false},
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_to_solar(&bad[i], &y, &m, &d));
+    }
+    // 小月没有三十：2024 年腊月（2025-01-28 为廿九，次日春节）
+    lunar_date_t small = {2024, 12, 30, false};
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_to_solar(&small, &y, &m, &d));
+
+    TEST_ASSERT_EQ_INT(0, lunar_term_day(1899, 0));
+    TEST_ASSERT_EQ_INT(0, lunar_term_day(2101, 0));
+    TEST_ASSERT_EQ_INT(0, lunar_term_day(2024, 24));
+    TEST_ASSERT_EQ_INT(0, lunar_term_day(2024, -1));
+    TEST_ASSERT(lunar_term_day(1900, 0) > 0 && lunar_term_day(2100, 23) > 0);
+
+    lunar_month_t mo;
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_month_fill(1900, 1, &mo));     // 1 月 1~30 日超出范围
+    TEST_ASSERT_EQ_INT(ESP_OK, lunar_month_fill(1900, 2, &mo));
+    TEST_ASSERT_EQ_INT(ESP_OK, lunar_month_fill(2100, 12, &mo));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, lunar_month_fill(2101, 1, &mo));
+}
+
+/*
+ * 范围内每一天：往返一致；农历逐日连续（日加一或进入下一个月的初一），
+ * 月长 29/30 天，每年 12 或 13 个月，闰月紧跟同名月
+ */
+static void test_every_day(void)
+{
+    lunar_date_t prev = {0};
+    int month_len = 0, months_in_year = 0, days = 0;
+    bool have_prev = false;
+
+    for (int y = 1900; y <= 2101; y++) {
+        for (int m = 1; m <= 12; m++) {
+            for (int d = 1; d <= month_days(y, m); d++) {
+                lunar_date_t ld;
+                int y2, m2, d2;
+
+                if (lunar_from_solar(y, m, d, &ld) != ESP_OK) {
+                    continue;
+                }
+                days++;
+                if (lunar_to_solar(&ld, &y2, &m2, &d2) != ESP_OK || y2 != y || m2 != m || d2 != d) {
+                    TEST_FAIL("%04d-%02d-%02d does not round-trip", y, m, d);
+                    return;
+                }
+                if (have_prev) {
+                    bool ok;
+                    if (ld.day == prev.day + 1) {
+                        ok = ld.month == prev.month && ld.leap == prev.leap && ld.year == prev.year;
+                        month_len++;
+                    } else {
+                        ok = ld.day == 1 && (month_len == 29 || month_len == 30);
+                        if (ld.year != prev.year) {
+                            ok = ok && ld.year == prev.year + 1 && ld.month == 1 && !ld.leap && prev.month == 12 &&
+                                 (months_in_year == 12 || months_in_year == 13);
+                            months_in_year = 0;
+                        } else if (ld.leap) {
+                            ok = ok && ld.month == prev.month && !prev.leap;
+                        } else {
+                            ok = ok && ld.month == prev.month + 1;
+                        }
+                        month_len = 1;
+                        months_in_year++;
+                    }
+                    if (!ok) {
+                        TEST_FAIL("%04d-%02d-%02d: %d %s%d-%d after %d %s%d-%d", y, m, d, ld.year,
+                                  ld.leap ? "leap " : "", ld.month, ld.day, prev.year, prev.leap ? "leap " : "",
+                                  prev.month, prev.day);
+                        return;
+                    }
+                } else {
+                    month_len = 1;
+                    months_in_year = 1;
+                }
+                prev = ld;
+                have_prev = true;
+            }
+        }
+    }
+    // 1900-01-31 ~ 2101-01-28
+    TEST_ASSERT_EQ_INT(73412, days);
+}
+
+// 比较有效部分，当月天数之后的元素不定
+static bool month_equal(const lunar_month_t *a, const lunar_month_t *b)
+{
+    if (a->year != b->year || a->month != b->month || a->days != b->days || a->mark_mask != b->mark_mask) {
+        return false;
+    }
+    for (int i = 0; i < a->days; i++) {
+        const lunar_date_t *x = &a->lunar[i], *y = &b->lunar[i];
+        if (x->year != y->year || x->month != y->month || x->day != y->day || x->leap != y->leap ||
+            a->term[i] != b->term[i] || a->holiday[i] != b->holiday[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* 按月计算与逐日查询一致；每年 24 个节气各出现一次 */
+static void test_month_fill_matches(void)
+{
+    lunar_month_t mo;
+    lunar_cache_t cache;
+
+    memset(&cache, 0, sizeof(cache));
+    for (int y = 1900; y <= 2100; y++) {
+        int terms = 0;
+        for (int m = 1; m <= 12; m++) {
+            if (lunar_month_fill(y, m, &mo) != ESP_OK) {
+                TEST_ASSERT(y == 1900 && m == 1);
+                continue;
+            }
+            const lunar_month_t *c = lunar_cache_get(&cache, y, m);
+            if (!c || !month_equal(c, &mo)) {
+                TEST_FAIL("%04d-%02d: cache differs from lunar_month_fill", y, m);
+                return;
+            }
+            for (int d = 1; d <= mo.days; d++) {
+                lunar_date_t ld;
+                lunar_from_solar(y, m, d, &ld);
+                int term = lunar_solar_term(y, m, d);
+                lunar_holiday_t h = lunar_holiday(y, m, d);
+                const lunar_date_t *f = &mo.lunar[d - 1];
+                bool marked = (mo.mark_mask >> (d - 1)) & 1;
+                if (f->year != ld.year || f->month != ld.month || f->day != ld.day || f->leap != ld.leap ||
+                    mo.term[d - 1] != term || mo.holiday[d - 1] != h ||
+                    marked != (term != LUNAR_NO_TERM || h != LUNAR_HOLIDAY_NONE)) {
+                    TEST_FAIL("%04d-%02d-%02d: month fill differs from per-day lookup", y, m, d);
+                    return;
+                }
+                terms += term != LUNAR_NO_TERM;
+            }
+        }
+        // 1900 年 1 月不在范围内，缺小寒、大寒
+        if (terms != (y == 1900 ? 22 : 24)) {
+            TEST_FAIL("%d: %d solar terms", y, terms);
+            return;
+        }
+    }
+}
+
+/* 缓存：命中返回同一项，满后替换最久未用的一项，超出范围返回 NULL 且不占用 */
+static void test_cache(void)
+{
+    lunar_cache_t cache;
+    const lunar_month_t *first, *p;
+
+    memset(&cache, 0, sizeof(cache));
+    first = lunar_cache_get(&cache, 2024, 1);
+    TEST_ASSERT(first != NULL && first->year == 2024 && first->month == 1);
+    for (int i = 1; i < LUNAR_CACHE_MONTHS; i++) {
+        TEST_ASSERT(lunar_cache_get(&cache, 2024, 1 + i) != NULL);
+    }
+    TEST_ASSERT(lunar_cache_get(&cache, 2024, 1) == first);     // 刷新 1 月
+    TEST_ASSERT(lunar_cache_get(&cache, 1900, 1) == NULL);
+    TEST_ASSERT(lunar_cache_get(&cache, 2101, 2) == NULL);
+    p = lunar_cache_get(&cache, 2025, 6);                      // 替换 2 月
+    TEST_ASSERT(p != NULL && p != first && p->year == 2025 && p->month == 6);
+    TEST_ASSERT(lunar_cache_get(&cache, 2024, 1) == first && first->month == 1);
+    uint32_t clock = cache.clock;
+    TEST_ASSERT(lunar_cache_get(&cache, 2024, 2) != NULL && cache.clock == clock + 1);
+}
+
+static void test_format(void)
+{
+    static const struct {
+        lunar_date_t date;
+        const char *text;
+    } cases[] = {
+        {{2020, 4, 5, true}, "闰四月初五"},
+        {{2024, 12, 23, false}, "腊月廿三"},
+        {{2024, 1, 1, false}, "正月初一"},
+        {{2024, 11, 10, false}, "冬月初十"},
+        {{2024, 8, 15, false}, "八月十五"},
+        {{2024, 3, 20, false}, "三月二十"},
+        {{2023, 12, 30, false}, "腊月三十"},
+        {{2024, 10, 21, false}, "十月廿一"},
+    };
+    char buf[24];
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        size_t n = lunar_format(&cases[i].date, buf, sizeof(buf));
+        TEST_ASSERT_EQ_INT(strlen(cases[i].text), n);
+        TEST_ASSERT_EQ_STR(cases[i].text, buf);
+    }
+    // "闰四月初五" 15 字节，缓冲区 15 字节放不下 '\0'
+    TEST_ASSERT_EQ_INT(0, lunar_format(&cases[0].date, buf, 15));
+    lunar_date_t bad = {2024, 13, 1, false};
+    TEST_ASSERT_EQ_INT(0, lunar_format(&bad, buf, sizeof(buf)));
+}
+
+/* 日历翻页：缓存命中与逐日转换的耗时 */
+static void test_bench(void)
+{
+    lunar_cache_t cache;
+    lunar_month_t mo;
+    const int n = 20000;
+    volatile uint32_t sink = 0;
+
+    memset(&cache, 0, sizeof(cache));
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        lunar_month_fill(2000 + i % 100, 1 + i % 12, &mo);
+        sink += mo.mark_mask;
+    }
+    int64_t t1 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        for (int d = 1; d <= 28; d++) {
+            lunar_date_t ld;
+            lunar_from_solar(2000 + i % 100, 1 + i % 12, d, &ld);
+            sink += ld.day + lunar_holiday(2000 + i % 100, 1 + i % 12, d);
+        }
+    }
+    int64_t t2 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        const lunar_month_t *c = lunar_cache_get(&cache, 2024, 1 + (i / 100) % 3);
+        sink += c->mark_mask;
+    }
+    int64_t t3 = esp_timer_get_time();
+
+    printf("  per month: lunar_month_fill %.0f ns, 28 per-day lookups %.0f ns, cache hit %.0f ns\n",
+           (t1 - t0) * 1000.0 / n, (t2 - t1) * 1000.0 / n, (t3 - t2) * 1000.0 / n);
+    (void)sink;
+}
+
+int main(void)
+{
+    RUN_TEST(test_reference_dates);
+    RUN_TEST(test_reference_holidays_and_terms);
+    RUN_TEST(test_range_edges);
+    RUN_TEST(test_every_day);
+    RUN_TEST(test_month_fill_matches);
+    RUN_TEST(test_cache);
+    RUN_TEST(test_format);
+    RUN_TEST(test_bench);
+    return TEST_EXIT();
+}
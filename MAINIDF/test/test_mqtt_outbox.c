@@ -0,0 +1,457 @@
+/**
+ * @file test_mqtt_outbox.c
+ * @brief mqtt_outbox 主机测试：边界、环绕、丢弃、合并、按序号移出（含不在队首的记录）；
+ *        随机操作与参考实现（记录列表）对比，每步校验缓冲区
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+#include "mqtt_outbox.h"
+
+#define HDR     4       // 记录头大小，与 mqtt_outbox.c 一致
+
+static uint32_t s_rng = 11;
+
+static uint32_t next_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static bool push_str(mqtt_outbox_t *ob, const char *topic, const char *payload, uint8_t flags)
+{
+    return mqtt_outbox_push(ob, topic, payload, strlen(payload), flags);
+}
+
+static void test_fifo(void)
+{
+    static mqtt_outbox_t ob;
+    mqtt_outbox_rec_t rec;
+
+    mqtt_outbox_init(&ob);
+    TEST_ASSERT(!mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT(!mqtt_outbox_pop(&ob, 0));
+    TEST_ASSERT(push_str(&ob, "a/1", "one", MQTT_OUTBOX_QOS1));
+    TEST_ASSERT(push_str(&ob, "a/2", "two", MQTT_OUTBOX_RETAIN));
+    TEST_ASSERT(push_str(&ob, "a/3", "", 0));
+    TEST_ASSERT_EQ_INT(3, mqtt_outbox_count(&ob));
+
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_STR("a/1", rec.topic);
+    TEST_ASSERT_EQ_STR("one", rec.payload);
+    TEST_ASSERT_EQ_INT(3, rec.len);
+    TEST_ASSERT_EQ_INT(MQTT_OUTBOX_QOS1, rec.flags);
+    TEST_ASSERT_EQ_INT(0, rec.seq);
+    // peek 不移出
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_INT(0, rec.seq);
+    TEST_ASSERT(mqtt_outbox_pop(&ob, 0));
+    TEST_ASSERT(!mqtt_outbox_pop(&ob, 0));
+
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_STR("a/2", rec.topic);
+    TEST_ASSERT_EQ_INT(MQTT_OUTBOX_RETAIN, rec.flags);
+    TEST_ASSERT_EQ_INT(1, rec.seq);
+    TEST_ASSERT(mqtt_outbox_pop(&ob, 1));
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_STR("", rec.payload);
+    TEST_ASSERT_EQ_INT(0, rec.len);
+    TEST_ASSERT(mqtt_outbox_pop(&ob, 2));
+    TEST_ASSERT_EQ_INT(0, mqtt_outbox_count(&ob));
+    TEST_ASSERT_EQ_INT(0, ob.used);
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+}
+
+static void test_limits(void)
+{
+    static mqtt_outbox_t ob;
+    char topic[MQTT_OUTBOX_TOPIC_MAX + 2];
+    char payload[MQTT_OUTBOX_PAYLOAD_MAX + 2];
+    mqtt_outbox_rec_t rec;
+
+    mqtt_outbox_init(&ob);
+    memset(topic, 't', sizeof(topic));
+    memset(payload, 'p', sizeof(payload));
+    topic[MQTT_OUTBOX_TOPIC_MAX + 1] = '\0';
+
+    TEST_ASSERT(!mqtt_outbox_push(&ob, "", "x", 1, 0));
+    TEST_ASSERT(!mqtt_outbox_push(&ob, topic, "x", 1, 0));
+    TEST_ASSERT(!mqtt_outbox_push(&ob, "t", payload, MQTT_OUTBOX_PAYLOAD_MAX + 1, 0));
+    TEST_ASSERT_EQ_INT(0, mqtt_outbox_count(&ob));
+
+    topic[MQTT_OUTBOX_TOPIC_MAX] = '\0';
+    TEST_ASSERT(mqtt_outbox_push(&ob, topic, payload, MQTT_OUTBOX_PAYLOAD_MAX, 0xff));
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_INT(MQTT_OUTBOX_TOPIC_MAX, strlen(rec.topic));
+    TEST_ASSERT_EQ_INT(MQTT_OUTBOX_PAYLOAD_MAX, rec.len);
+    TEST_ASSERT(memcmp(rec.payload, payload, MQTT_OUTBOX_PAYLOAD_MAX) == 0);
+    TEST_ASSERT_EQ_INT(0, rec.payload[MQTT_OUTBOX_PAYLOAD_MAX]);
+    // 只保留调用方可用的标志
+    TEST_ASSERT_EQ_INT(MQTT_OUTBOX_FLAGS, rec.flags);
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+}
+
+/* 空间不足时丢弃最早的记录，记录跨越数组末尾时内容完整 */
+static void test_wrap_and_drop(void)
+{
+    static mqtt_outbox_t ob;
+    char payload[64];
+    mqtt_outbox_rec_t rec;
+    const int size = HDR + 5 + 40;  // "m/xxx" + 40 字节内容
+    const int fit = MQTT_OUTBOX_BYTES / size;
+    const int total = fit * 3 + 7;
+
+    mqtt_outbox_init(&ob);
+    for (int i = 0; i < total; i++) {
+        char topic[8];
+        snprintf(topic, sizeof(topic), "m/%03d", i);
+        memset(payload, 'a' + i % 26, 40);
+        TEST_ASSERT(mqtt_outbox_push(&ob, topic, payload, 40, 0));
+        TEST_ASSERT(mqtt_outbox_check(&ob));
+        TEST_ASSERT(ob.used <= MQTT_OUTBOX_BYTES);
+    }
+    TEST_ASSERT_EQ_INT(fit, mqtt_outbox_count(&ob));
+    TEST_ASSERT_EQ_INT(total - fit, ob.dropped);
+    TEST_ASSERT_EQ_INT(total - fit, ob.seq);
+
+    // 剩下最新的 fit 条，序号连续
+    for (int i = total - fit; i < total; i++) {
+        char topic[8];
+        snprintf(topic, sizeof(topic), "m/%03d", i);
+        TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+        TEST_ASSERT_EQ_STR(topic, rec.topic);
+        TEST_ASSERT_EQ_INT(i, rec.seq);
+        TEST_ASSERT_EQ_INT(40, rec.len);
+        TEST_ASSERT(rec.payload[0] == 'a' + i % 26 && rec.payload[39] == 'a' + i % 26);
+        TEST_ASSERT(mqtt_outbox_pop(&ob, rec.seq));
+    }
+    TEST_ASSERT_EQ_INT(0, mqtt_outbox_count(&ob));
+    TEST_ASSERT_EQ_INT(0, ob.head);
+}
+
+/* LATEST：作废同主题的旧记录，作废的记录到达队首时回收 */
+static void test_coalesce(void)
+{
+    static mqtt_outbox_t ob;
+    mqtt_outbox_rec_t rec;
+
+    mqtt_outbox_init(&ob);
+    TEST_ASSERT(push_str(&ob, "bat", "90", MQTT_OUTBOX_LATEST));
+    TEST_ASSERT(push_str(&ob, "log", "a", 0));
+    TEST_ASSERT(push_str(&ob, "bat", "89", MQTT_OUTBOX_LATEST));
+    TEST_ASSERT(push_str(&ob, "log", "b", 0));
+    TEST_ASSERT(push_str(&ob, "bat", "88", MQTT_OUTBOX_LATEST | MQTT_OUTBOX_RETAIN));
+    // 不带 LATEST 的同主题记录不合并
+    TEST_ASSERT(push_str(&ob, "log", "c", MQTT_OUTBOX_LATEST));
+    TEST_ASSERT_EQ_INT(4, mqtt_outbox_count(&ob));
+    TEST_ASSERT_EQ_INT(2, ob.coalesced);
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+
+    // 队首的 "90" 已回收，序号仍按位置计
+    static const char *const exp[][2] = {{"log", "a"}, {"log", "b"}, {"bat", "88"}, {"log", "c"}};
+    static const uint32_t exp_seq[] = {1, 3, 4, 5};
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+        TEST_ASSERT_EQ_STR(exp[i][0], rec.topic);
+        TEST_ASSERT_EQ_STR(exp[i][1], rec.payload);
+        TEST_ASSERT_EQ_INT(exp_seq[i], rec.seq);
+        TEST_ASSERT(mqtt_outbox_pop(&ob, rec.seq));
+    }
+    TEST_ASSERT(!mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_INT(6, ob.seq);
+}
+
+/* 发送期间队首被丢弃：旧序号的 pop 失败，不误删新的队首 */
+static void test_pop_stale(void)
+{
+    static mqtt_outbox_t ob;
+    char payload[MQTT_OUTBOX_PAYLOAD_MAX];
+    mqtt_outbox_rec_t rec, head;
+
+    mqtt_outbox_init(&ob);
+    memset(payload, 'x', sizeof(payload));
+    TEST_ASSERT(push_str(&ob, "first", "1", 0));
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    while (ob.dropped == 0) {
+        TEST_ASSERT(mqtt_outbox_push(&ob, "fill", payload, sizeof(payload), 0));
+    }
+    uint16_t count = mqtt_outbox_count(&ob);
+    TEST_ASSERT(!mqtt_outbox_pop(&ob, rec.seq));
+    TEST_ASSERT_EQ_INT(count, mqtt_outbox_count(&ob));
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &head));
+    TEST_ASSERT_EQ_STR("fill", head.topic);
+    TEST_ASSERT_EQ_INT(ob.seq, head.seq);
+    TEST_ASSERT(head.seq > rec.seq);
+    TEST_ASSERT(!mqtt_outbox_pop(&ob, head.seq + count));    // 还没有的序号
+    TEST_ASSERT_EQ_INT(count, mqtt_outbox_count(&ob));
+}
+
+/* 已发出、等待确认的记录之后继续发送，确认的顺序与发送顺序不同 */
+static void test_out_of_order(void)
+{
+    static mqtt_outbox_t ob;
+    mqtt_outbox_rec_t rec;
+    uint32_t seq[4];
+
+    mqtt_outbox_init(&ob);
+    TEST_ASSERT(push_str(&ob, "q/a", "A", MQTT_OUTBOX_QOS1));
+    TEST_ASSERT(push_str(&ob, "q/b", "B", MQTT_OUTBOX_QOS1 | MQTT_OUTBOX_LATEST));
+    TEST_ASSERT(push_str(&ob, "q/c", "C", 0));
+    TEST_ASSERT(push_str(&ob, "q/d", "D", MQTT_OUTBOX_QOS1));
+
+    // 依次发出
+    uint32_t next = ob.seq;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT(mqtt_outbox_peek_from(&ob, next, &rec));
+        TEST_ASSERT_EQ_INT('A' + i, rec.payload[0]);
+        seq[i] = rec.seq;
+        next = rec.seq + 1;
+    }
+    TEST_ASSERT(!mqtt_outbox_peek_from(&ob, next, &rec));
+
+    // QoS 0 的 C 发出即移出；D 先确认，A 最后
+    TEST_ASSERT(mqtt_outbox_pop(&ob, seq[2]));
+    TEST_ASSERT(mqtt_outbox_pop(&ob, seq[3]));
+    TEST_ASSERT_EQ_INT(2, mqtt_outbox_count(&ob));
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+    TEST_ASSERT(!mqtt_outbox_pop(&ob, seq[3]));
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_INT(seq[0], rec.seq);
+
+    // 等待确认期间入队的新记录接在后面，序号不受移出影响
+    TEST_ASSERT(push_str(&ob, "q/e", "E", 0));
+    TEST_ASSERT(mqtt_outbox_peek_from(&ob, next, &rec));
+    TEST_ASSERT_EQ_STR("E", rec.payload);
+    TEST_ASSERT_EQ_INT(next, rec.seq);
+
+    // 等待确认的 B 被新值作废，之后的确认不移出其他记录
+    TEST_ASSERT(push_str(&ob, "q/b", "B2", MQTT_OUTBOX_QOS1 | MQTT_OUTBOX_LATEST));
+    TEST_ASSERT(!mqtt_outbox_pop(&ob, seq[1]));
+    TEST_ASSERT_EQ_INT(3, mqtt_outbox_count(&ob));
+
+    TEST_ASSERT(mqtt_outbox_pop(&ob, seq[0]));
+    // A、B、C、D 都已回收，队首是 E
+    TEST_ASSERT(mqtt_outbox_peek(&ob, &rec));
+    TEST_ASSERT_EQ_STR("E", rec.payload);
+    TEST_ASSERT_EQ_INT(next, ob.seq);
+    TEST_ASSERT(mqtt_outbox_peek_from(&ob, 0, &rec));   // 早于队首从队首开始
+    TEST_ASSERT_EQ_STR("E", rec.payload);
+    TEST_ASSERT(mqtt_outbox_peek_from(&ob, next + 1, &rec));
+    TEST_ASSERT_EQ_STR("B2", rec.payload);
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+}
+
+/* 从文件读回的内容损坏时校验失败 */
+static void test_check(void)
+{
+    static mqtt_outbox_t ob, bad;
+
+    mqtt_outbox_init(&ob);
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+    for (int i = 0; i < 60; i++) {
+        TEST_ASSERT(push_str(&ob, i % 3 ? "s/x" : "s/y", "0123456789012345678901234567890123456789",
+                             i % 2 ? MQTT_OUTBOX_LATEST : 0));
+    }
+    mqtt_outbox_rec_t rec;
+    TEST_ASSERT(mqtt_outbox_peek_from(&ob, ob.seq + 3, &rec));
+    TEST_ASSERT(mqtt_outbox_pop(&ob, rec.seq));
+    TEST_ASSERT(mqtt_outbox_check(&ob));
+
+    bad = ob;
+    bad.count++;
+    TEST_ASSERT(!mqtt_outbox_check(&bad));
+    bad = ob;
+    bad.head = MQTT_OUTBOX_BYTES;
+    TEST_ASSERT(!mqtt_outbox_check(&bad));
+    bad = ob;
+    bad.used += 1;
+    TEST_ASSERT(!mqtt_outbox_check(&bad));
+    bad = ob;
+    bad.buf[ob.head] = 0x40;        // 未定义的标志
+    TEST_ASSERT(!mqtt_outbox_check(&bad));
+    bad = ob;
+    bad.buf[(ob.head + 1) % MQTT_OUTBOX_BYTES] = 0;     // 主题长度为 0
+    TEST_ASSERT(!mqtt_outbox_check(&bad));
+    bad = ob;
+    bad.buf[(ob.head + 3) % MQTT_OUTBOX_BYTES] = 0x7f;  // 内容长度超限
+    TEST_ASSERT(!mqtt_outbox_check(&bad));
+}
+
+/* ---------- 随机操作与参考实现对比 ---------- */
+
+typedef struct {
+    uint32_t seq;
+    uint16_t size;
+    uint8_t flags;
+    bool live;
+    char topic[8];
+    uint8_t payload[MQTT_OUTBOX_PAYLOAD_MAX];
+    uint16_t len;
+} ref_rec_t;
+
+#define REF_MAX (MQTT_OUTBOX_BYTES / (HDR + 1) + 1)
+
+static ref_rec_t s_ref[REF_MAX];
+static int s_ref_n;
+static uint32_t s_ref_seq;          // 队首记录的序号
+static uint32_t s_ref_used;
+static uint32_t s_ref_dropped, s_ref_coalesced;
+
+static void ref_drop_head(void)
+{
+    s_ref_used -= s_ref[0].size;
+    s_ref_seq++;
+    memmove(&s_ref[0], &s_ref[1], (s_ref_n - 1) * sizeof(s_ref[0]));
+    s_ref_n--;
+}
+
+static void ref_reclaim(void)
+{
+    while (s_ref_n > 0 && !s_ref[0].live) {
+        ref_drop_head();
+    }
+}
+
+static void ref_push(const char *topic, const uint8_t *payload, uint16_t len, uint8_t flags)
+{
+    size_t topic_len = strlen(topic);
+
+    if (flags & MQTT_OUTBOX_LATEST) {
+        for (int i = 0; i < s_ref_n; i++) {
+            if (s_ref[i].live && (s_ref[i].flags & MQTT_OUTBOX_LATEST) && strcmp(s_ref[i].topic, topic) == 0) {
+                s_ref[i].live = false;
+                s_ref_coalesced++;
+            }
+        }
+        ref_reclaim();
+    }
+    uint16_t size = HDR + topic_len + len;
+    while (MQTT_OUTBOX_BYTES - s_ref_used < size) {
+        s_ref_dropped += s_ref[0].live;
+        ref_drop_head();
+        ref_reclaim();
+    }
+    ref_rec_t *r = &s_ref[s_ref_n++];
+    r->seq = s_ref_seq + s_ref_n - 1;
+    r->size = size;
+    r->flags = flags;
+    r->live = true;
+    strcpy(r->topic, topic);
+    memcpy(r->payload, payload, len);
+    r->len = len;
+    s_ref_used += size;
+}
+
+static bool ref_pop(uint32_t seq)
+{
+    for (int i = 0; i < s_ref_n; i++) {
+        if (s_ref[i].seq == seq && s_ref[i].live) {
+            s_ref[i].live = false;
+            ref_reclaim();
+            return true;
+        }
+    }
+    return false;
+}
+
+static const ref_rec_t *ref_peek_from(uint32_t seq)
+{
+    ref_reclaim();
+    for (int i = 0; i < s_ref_n; i++) {
+        if (s_ref[i].live && (int32_t)(s_ref[i].seq - seq) >= 0) {
+            return &s_ref[i];
+        }
+    }
+    return NULL;
+}
+
+static int ref_count(void)
+{
+    int n = 0;
+    for (int i = 0; i < s_ref_n; i++) {
+        n += s_ref[i].live;
+    }
+    return n;
+}
+
+static bool same(const mqtt_outbox_rec_t *rec, const ref_rec_t *r)
+{
+    return rec->seq == r->seq && rec->flags == r->flags && rec->len == r->len && strcmp(rec->topic, r->topic) == 0 &&
+           memcmp(rec->payload, r->payload, r->len) == 0 && rec->payload[r->len] == '\0';
+}
+
+static void test_random(void)
+{
+    static mqtt_outbox_t ob, copy;
+    static const char *const topics[] = {"r/a", "r/b", "r/c", "r/dd", "r/eee"};
+    mqtt_outbox_rec_t rec;
+    uint8_t payload[MQTT_OUTBOX_PAYLOAD_MAX];
+    long pushes = 0, pops = 0, peeks = 0;
+    int steps = 0;
+    int failures = test_failures;
+
+    // 出错后停止，避免重复输出
+    for (int round = 0; round < 20 && test_failures == failures; round++) {
+        mqtt_outbox_init(&ob);
+        s_ref_n = 0;
+        s_ref_seq = s_ref_used = s_ref_dropped = s_ref_coalesced = 0;
+        // 序号接近回绕时也要正确
+        if (round % 4 == 3) {
+            ob.seq = s_ref_seq = 0xfffffff0u;
+        }
+
+        for (int step = 0; step < 5000 && test_failures == failures; step++, steps++) {
+            uint32_t op = next_rand() % 10;
+            if (op < 5) {
+                const char *topic = topics[next_rand() % 5];
+                uint16_t len = next_rand() % 4 == 0 ? next_rand() % (MQTT_OUTBOX_PAYLOAD_MAX + 1) : next_rand() % 16;
+                uint8_t flags = next_rand() & MQTT_OUTBOX_FLAGS;
+                for (int i = 0; i < len; i++) {
+                    payload[i] = next_rand();
+                }
+                TEST_ASSERT(mqtt_outbox_push(&ob, topic, payload, len, flags));
+                ref_push(topic, payload, len, flags);
+                pushes++;
+            } else if (op < 8) {
+                // 随机选一条记录（可能已作废或不存在）移出
+                uint32_t seq = s_ref_seq + next_rand() % (s_ref_n + 2);
+                TEST_ASSERT_EQ_INT(ref_pop(seq), mqtt_outbox_pop(&ob, seq));
+                pops++;
+            } else {
+                uint32_t seq = s_ref_seq + next_rand() % (s_ref_n + 2) - 1;
+                const ref_rec_t *r = ref_peek_from(seq);
+                bool have = mqtt_outbox_peek_from(&ob, seq, &rec);
+                TEST_ASSERT(have == (r != NULL));
+                if (have && r && !same(&rec, r)) {
+                    TEST_FAIL("round %d step %d: peek_from(%u) seq %u, expected %u", round, step, seq, rec.seq,
+                              r->seq);
+                }
+                peeks++;
+            }
+            TEST_ASSERT_EQ_INT(ref_count(), mqtt_outbox_count(&ob));
+            TEST_ASSERT_EQ_INT(s_ref_used, ob.used);
+            TEST_ASSERT_EQ_INT(s_ref_seq, ob.seq);
+            TEST_ASSERT_EQ_INT(s_ref_dropped, ob.dropped);
+            TEST_ASSERT_EQ_INT(s_ref_coalesced, ob.coalesced);
+            // 整体复制（写入文件再读回）后仍然有效
+            copy = ob;
+            TEST_ASSERT(mqtt_outbox_check(&copy));
+        }
+    }
+    printf("  %d steps: %ld pushes, %ld pops, %ld peeks\n", steps, pushes, pops, peeks);
+}
+
+int main(void)
+{
+    RUN_TEST(test_fifo);
+    RUN_TEST(test_limits);
+    RUN_TEST(test_wrap_and_drop);
+    RUN_TEST(test_coalesce);
+    RUN_TEST(test_pop_stale);
+    RUN_TEST(test_out_of_order);
+    RUN_TEST(test_check);
+    RUN_TEST(test_random);
+    return TEST_EXIT();
+}
@@ -0,0 +1,302 @@
+/*
+ * settings 测试：sys_kv + mock_nvs 作为存储，FreeRTOS 用模拟时钟（host_rtos）
+ * 用例按顺序执行并共享同一个已初始化的子系统；逐项检查的用例由 SETTINGS_SCHEMA 展开，
+ * 表中新增设置项时自动覆盖。
+ */
+#include "test_common.h"
+#include <math.h>
+#include "settings.h"
+#include "sys_kv.h"
+#include "nvs.h"
+#include "mock_nvs.h"
+#include "host_rtos.h"
+
+/* main 在初始化前写入 NVS 的值：一个有效，两个超出范围 */
+#define STORED_MID      40
+#define STORED_FADE     99999
+#define STORED_LAT      123.0f
+
+static uint32_t nvs_gets(void)
+{
+    mock_nvs_counters_t c;
+    mock_nvs_counters(&c);
+    return c.gets;
+}
+
+/* settings 向 sys_kv 读取的次数 */
+static uint32_t kv_lookups(void)
+{
+    sys_kv_stats_t st;
+    sys_kv_get_stats(&st);
+    return st.hits + st.misses;
+}
+
+/* 与默认值不同的合法值，每项不同 */
+static int32_t int_test_value(setting_id_t id, int32_t def, int32_t lo, int32_t hi)
+{
+    int32_t v = lo + (int32_t)id % (hi - lo + 1);
+    return v != def ? v : (v < hi ? v + 1 : lo);
+}
+
+static float float_test_value(setting_id_t id, float def, float lo, float hi)
+{
+    float v = lo + (hi - lo) * (0.25f + 0.05f * (int)id);
+    return v != def ? v : (lo + hi) / 2;
+}
+
+/* 填满最大长度的字符串，首字符区分设置项 */
+static void str_test_value(setting_id_t id, size_t maxlen, char *buf)
+{
+    for (size_t i = 0; i < maxlen; i++) {
+        buf[i] = (char)('a' + (id + i) % 26);
+    }
+    buf[maxlen] = '\0';
+}
+
+/* 首次访问才读取 NVS，之后由 settings 自己的存储返回 */
+static void test_lazy_load(void)
+{
+    host_rtos_settle();
+    uint32_t gets = nvs_gets();
+
+    TEST_ASSERT_EQ_INT(STORED_MID, settings_get_int(SETTING_BRIGHTNESS_MID));
+    TEST_ASSERT_EQ_INT(gets + 1, nvs_gets());
+    TEST_ASSERT_EQ_INT(STORED_MID, settings_get_int(SETTING_BRIGHTNESS_MID));
+    TEST_ASSERT_EQ_INT(gets + 1, nvs_gets());
+}
+
+/* NVS 中没有的项和超出范围的项都取表中默认值 */
+static void test_defaults(void)
+{
+    char buf[128];
+
+#define CHECK_DEF_INT(id, field, key, def, lo, hi)                                     \
+    if (id != SETTING_BRIGHTNESS_MID) {                                                \
+        TEST_ASSERT_EQ_INT(def, settings_get_int(id));                                 \
+    }
+#define CHECK_DEF_FLOAT(id, field, key, def, lo, hi)                                   \
+    TEST_ASSERT(settings_get_float(id) == (float)(def));
+#define CHECK_DEF_STR(id, field, key, def, maxlen)                                     \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_get_str(id, buf, sizeof(buf)));                \
+    TEST_ASSERT_EQ_STR(def, buf);
+    SETTINGS_SCHEMA(CHECK_DEF_INT, CHECK_DEF_FLOAT, CHECK_DEF_STR)
+#undef CHECK_DEF_INT
+#undef CHECK_DEF_FLOAT
+#undef CHECK_DEF_STR
+
+    // 超出范围的已存值被忽略
+    TEST_ASSERT_EQ_INT(500, settings_get_int(SETTING_FADE_MS));
+    TEST_ASSERT(settings_get_float(SETTING_WEATHER_LAT) == 39.90f);
+}
+
+/* 每一项写入后丢弃已加载的值，重新读取得到写入的值；写回后 NVS 中存在该键 */
+static void test_round_trip(void)
+{
+    char buf[128], exp[128];
+
+#define SET_INT(id, field, key, def, lo, hi)                                           \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_int(id, int_test_value(id, def, lo, hi)));
+#define SET_FLOAT(id, field, key, def, lo, hi)                                         \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_float(id, float_test_value(id, def, lo, hi)));
+#define SET_STR(id, field, key, def, maxlen)                                           \
+    str_test_value(id, maxlen, exp);                                                   \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_str(id, exp));
+    SETTINGS_SCHEMA(SET_INT, SET_FLOAT, SET_STR)
+#undef SET_INT
+#undef SET_FLOAT
+#undef SET_STR
+
+    settings_reload();
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_flush());
+    uint32_t lookups = kv_lookups();
+
+#define GET_INT(id, field, key, def, lo, hi)                                           \
+    TEST_ASSERT_EQ_INT(int_test_value(id, def, lo, hi), settings_get_int(id));         \
+    TEST_ASSERT(mock_nvs_committed_has(key));
+#define GET_FLOAT(id, field, key, def, lo, hi)                                         \
+    TEST_ASSERT(settings_get_float(id) == float_test_value(id, def, lo, hi));          \
+    TEST_ASSERT(mock_nvs_committed_has(key));
+#define GET_STR(id, field, key, def, maxlen)                                           \
+    str_test_value(id, maxlen, exp);                                                   \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_get_str(id, buf, sizeof(buf)));                \
+    TEST_ASSERT_EQ_STR(exp, buf);                                                      \
+    TEST_ASSERT(mock_nvs_committed_has(key));
+    SETTINGS_SCHEMA(GET_INT, GET_FLOAT, GET_STR)
+#undef GET_INT
+#undef GET_FLOAT
+#undef GET_STR
+
+    // 每一项都重新从 sys_kv 读取了一次
+    TEST_ASSERT_EQ_INT(lookups + SETTING_COUNT, kv_lookups());
+
+    // 缓冲区不足时截断
+    char small[4];
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_get_str(SETTING_TIMEZONE, small, sizeof(small)));
+    TEST_ASSERT_EQ_INT(3, strlen(small));
+}
+
+/* 超出 min/max 或最大长度的值被拒绝，原值不变；类型不符的访问被拒绝 */
+static void test_out_of_range(void)
+{
+    char buf[128], exp[128];
+
+#define RANGE_INT(id, field, key, def, lo, hi)                                         \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_int(id, (lo) - 1));           \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_int(id, (hi) + 1));           \
+    TEST_ASSERT_EQ_INT(int_test_value(id, def, lo, hi), settings_get_int(id));         \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_float(id, 1.0f));             \
+    TEST_ASSERT_EQ_INT(0, settings_get_float(id));
+#define RANGE_FLOAT(id, field, key, def, lo, hi)                                       \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_float(id, (lo) - 0.5f));      \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_float(id, (hi) + 0.5f));      \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_float(id, NAN));              \
+    TEST_ASSERT(settings_get_float(id) == float_test_value(id, def, lo, hi));          \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_str(id, "1"));
+#define RANGE_STR(id, field, key, def, maxlen)                                         \
+    memset(buf, 'x', (maxlen) + 1);                                                    \
+    buf[(maxlen) + 1] = '\0';                                                          \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_SIZE, settings_set_str(id, buf));               \
+    str_test_value(id, maxlen, exp);                                                   \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_get_str(id, buf, sizeof(buf)));                \
+    TEST_ASSERT_EQ_STR(exp, buf);                                                      \
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_int(id, 1));
+    SETTINGS_SCHEMA(RANGE_INT, RANGE_FLOAT, RANGE_STR)
+#undef RANGE_INT
+#undef RANGE_FLOAT
+#undef RANGE_STR
+
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_int(SETTING_COUNT, 1));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_reset(SETTING_COUNT));
+    TEST_ASSERT(settings_describe(SETTING_COUNT, NULL) == NULL);
+}
+
+/* settings_reset 恢复默认值并写入存储，重新加载后仍为默认值 */
+static void test_reset(void)
+{
+    char buf[128];
+
+    for (int id = 0; id < SETTING_COUNT; id++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, settings_reset((setting_id_t)id));
+    }
+    settings_reload();
+    uint32_t lookups = kv_lookups();
+
+#define RESET_INT(id, field, key, def, lo, hi)                                         \
+    TEST_ASSERT_EQ_INT(def, settings_get_int(id));
+#define RESET_FLOAT(id, field, key, def, lo, hi)                                       \
+    TEST_ASSERT(settings_get_float(id) == (float)(def));
+#define RESET_STR(id, field, key, def, maxlen)                                         \
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_get_str(id, buf, sizeof(buf)));                \
+    TEST_ASSERT_EQ_STR(def, buf);
+    SETTINGS_SCHEMA(RESET_INT, RESET_FLOAT, RESET_STR)
+#undef RESET_INT
+#undef RESET_FLOAT
+#undef RESET_STR
+
+    TEST_ASSERT_EQ_INT(lookups + SETTING_COUNT, kv_lookups());
+
+    int32_t v = 0;
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_get_i32("bl_level", &v));
+    TEST_ASSERT_EQ_INT(100, v);
+}
+
+typedef struct {
+    int calls;
+    setting_id_t last;
+    int32_t seen;       // 回调中读到的亮度，回调不持有内部锁
+} sub_log_t;
+
+static void on_change(setting_id_t id, void *arg)
+{
+    sub_log_t *log = arg;
+    log->calls++;
+    log->last = id;
+    log->seen = settings_get_int(SETTING_BRIGHTNESS);
+}
+
+/* 指定项的订阅者只收到该项的变更，SETTING_ANY 收到全部；值不变时不通知 */
+static void test_subscribe(void)
+{
+    sub_log_t one = { 0 }, any = { 0 };
+
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_subscribe(SETTING_BRIGHTNESS, on_change, &one));
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_subscribe(SETTING_ANY, on_change, &any));
+
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_int(SETTING_BRIGHTNESS, 60));
+    TEST_ASSERT_EQ_INT(1, one.calls);
+    TEST_ASSERT_EQ_INT(SETTING_BRIGHTNESS, one.last);
+    TEST_ASSERT_EQ_INT(60, one.seen);
+    TEST_ASSERT_EQ_INT(1, any.calls);
+
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_int(SETTING_FADE_MS, 800));
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_float(SETTING_WEATHER_LON, 121.47f));
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_str(SETTING_TIMEZONE, "Europe/Berlin"));
+    TEST_ASSERT_EQ_INT(1, one.calls);
+    TEST_ASSERT_EQ_INT(4, any.calls);
+    TEST_ASSERT_EQ_INT(SETTING_TIMEZONE, any.last);
+
+    // 相同的值、被拒绝的值都不通知
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_int(SETTING_BRIGHTNESS, 60));
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_ARG, settings_set_int(SETTING_BRIGHTNESS, 0));
+    TEST_ASSERT_EQ_INT(1, one.calls);
+    TEST_ASSERT_EQ_INT(4, any.calls);
+
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_reset(SETTING_BRIGHTNESS));
+    TEST_ASSERT_EQ_INT(2, one.calls);
+    TEST_ASSERT_EQ_INT(100, one.seen);
+    TEST_ASSERT_EQ_INT(5, any.calls);
+
+    // 取消订阅需匹配订阅时的 id
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FOUND, settings_unsubscribe(SETTING_FADE_MS, on_change));
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_unsubscribe(SETTING_BRIGHTNESS, on_change));
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_int(SETTING_BRIGHTNESS, 30));
+    TEST_ASSERT_EQ_INT(2, one.calls);
+    TEST_ASSERT_EQ_INT(6, any.calls);
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_unsubscribe(SETTING_ANY, on_change));
+}
+
+/* 订阅表满时返回 ESP_ERR_NO_MEM */
+static void test_subscribe_full(void)
+{
+    sub_log_t log = { 0 };
+    int added = 0;
+
+    while (settings_subscribe(SETTING_FADE_MS, on_change, &log) == ESP_OK) {
+        added++;
+    }
+    TEST_ASSERT_EQ_INT(8, added);
+    TEST_ASSERT_EQ_INT(ESP_ERR_NO_MEM, settings_subscribe(SETTING_ANY, on_change, &log));
+
+    TEST_ASSERT_EQ_INT(ESP_OK, settings_set_int(SETTING_FADE_MS, 900));
+    TEST_ASSERT_EQ_INT(8, log.calls);
+    while (settings_unsubscribe(SETTING_FADE_MS, on_change) == ESP_OK) {
+        added--;
+    }
+    TEST_ASSERT_EQ_INT(0, added);
+}
+
+int main(void)
+{
+    union {
+        float f;
+        uint32_t u;
+    } lat = { .f = STORED_LAT };
+
+    mock_nvs_reset();
+    nvs_set_i32(1, "bl_step_mid", STORED_MID);
+    nvs_set_i32(1, "bl_fade_ms", STORED_FADE);
+    nvs_set_u32(1, "wx_lat", lat.u);
+    nvs_commit(1);
+    if (sys_kv_init() != ESP_OK || settings_init() != ESP_OK) {
+        return 1;
+    }
+
+    RUN_TEST(test_lazy_load);
+    RUN_TEST(test_defaults);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_out_of_range);
+    RUN_TEST(test_reset);
+    RUN_TEST(test_subscribe);
+    RUN_TEST(test_subscribe_full);
+    return TEST_EXIT();
+}
@@ -0,0 +1,200 @@
+/*
+ * sys_file 流式读写测试，在临时目录中运行
+ * 最后执行 sys_file_benchmark / sys_file_write_benchmark，结果输出到测试日志（主机文件系统上的数值仅供对比）
+ */
+#include "test_common.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "sys_file.h"
+
+static char s_dir[64];
+
+static const char *path_of(const char *name)
+{
+    static char path[SYS_FILE_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", s_dir, name);
+    return path;
+}
+
+typedef struct {
+    size_t total;
+    size_t calls;
+    size_t max_chunk;
+    uint32_t sum;
+} chunk_ctx_t;
+
+static esp_err_t chunk_cb(const void *data, size_t len, void *arg)
+{
+    chunk_ctx_t *ctx = arg;
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        ctx->sum += p[i];
+    }
+    ctx->total += len;
+    ctx->calls++;
+    if (len > ctx->max_chunk) {
+        ctx->max_chunk = len;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stop_cb(const void *data, size_t len, void *arg)
+{
+    return ESP_ERR_NOT_FINISHED;
+}
+
+/* 二进制写入后分块读回，块大小不超过缓冲区 */
+static void test_binary_chunks(void)
+{
+    uint8_t data[1000];
+    uint32_t sum = 0;
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);     // 含 0 字节
+        sum += data[i];
+    }
+    char path[SYS_FILE_PATH_MAX];
+    strcpy(path, path_of("bin"));
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_write_all(path, data, sizeof(data)));
+
+    uint8_t buf[64];
+    chunk_ctx_t ctx = { 0 };
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_read_chunks(path, buf, sizeof(buf), chunk_cb, &ctx));
+    TEST_ASSERT_EQ_INT(sizeof(data), ctx.total);
+    TEST_ASSERT_EQ_INT(sum, ctx.sum);
+    TEST_ASSERT_EQ_INT(sizeof(buf), ctx.max_chunk);
+    TEST_ASSERT_EQ_INT((sizeof(data) + sizeof(buf) - 1) / sizeof(buf), ctx.calls);
+
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FINISHED, sys_file_read_chunks(path, buf, sizeof(buf), stop_cb, NULL));
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FOUND, sys_file_read_chunks(path_of("none"), buf, sizeof(buf), chunk_cb, &ctx));
+
+    size_t len = 0;
+    uint8_t *all = sys_file_read_all(path, &len, true);
+    TEST_ASSERT(all != NULL);
+    if (all) {
+        TEST_ASSERT_EQ_INT(sizeof(data), len);
+        TEST_ASSERT(memcmp(all, data, sizeof(data)) == 0);
+        TEST_ASSERT_EQ_INT(0, all[len]);
+        free(all);
+    }
+}
+
+/* 行迭代：CRLF、无结尾换行、超长行截断后继续下一行 */
+static void test_lines(void)
+{
+    const char *text = "first\r\n\nthis line is longer than the window\nlast";
+    const char *path = path_of("lines");
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_write_all(path, text, strlen(text)));
+
+    char win[16];
+    sys_file_iter_t it;
+    const char *line;
+    size_t len;
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_iter_open(&it, path, win, sizeof(win)));
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_next_line(&it, &line, &len));
+    TEST_ASSERT_EQ_STR("first", line);
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_next_line(&it, &line, &len));
+    TEST_ASSERT_EQ_INT(0, len);
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_SIZE, sys_file_next_line(&it, &line, &len));
+    TEST_ASSERT_EQ_STR("this line is lo", line);
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_next_line(&it, &line, &len));
+    TEST_ASSERT_EQ_STR("last", line);
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FOUND, sys_file_next_line(&it, &line, &len));
+    TEST_ASSERT_EQ_INT(4, it.line_no);
+    sys_file_iter_close(&it);
+}
+
+/* 定长记录：窗口内原地返回，末尾不足一条报 INVALID_SIZE */
+static void test_records(void)
+{
+    uint32_t recs[10];
+    for (int i = 0; i < 10; i++) {
+        recs[i] = 0x1000 + i;
+    }
+    const char *path = path_of("recs");
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_write_all(path, recs, sizeof(recs)));
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_append(path, "xy", 2));
+
+    char win[13];   // 不是记录大小的整数倍
+    sys_file_iter_t it;
+    const void *rec;
+    int n = 0;
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_iter_open(&it, path, win, sizeof(win)));
+    esp_err_t err;
+    while ((err = sys_file_next_record(&it, &rec, sizeof(uint32_t))) == ESP_OK) {
+        uint32_t v;
+        memcpy(&v, rec, sizeof(v));
+        TEST_ASSERT_EQ_INT(0x1000 + n, v);
+        TEST_ASSERT((const char *)rec >= win && (const char *)rec < win + sizeof(win));
+        n++;
+    }
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_SIZE, err);
+    TEST_ASSERT_EQ_INT(10, n);
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_FOUND, sys_file_next_record(&it, &rec, sizeof(uint32_t)));
+    sys_file_iter_close(&it);
+}
+
+/* 原子替换成功后不留临时文件 */
+static void test_atomic_replace(void)
+{
+    const char *path = path_of("atomic");
+    char tmp[SYS_FILE_PATH_MAX];
+    struct stat st;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_write_atomic(path, "old", 3));
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_write_atomic(path, "new content", 11));
+    snprintf(tmp, sizeof(tmp), "%s" SYS_FILE_TMP_SUFFIX, path);
+    TEST_ASSERT(stat(tmp, &st) != 0);
+
+    size_t len;
+    char *s = sys_file_read_all(path, &len, false);
+    TEST_ASSERT(s != NULL);
+    if (s) {
+        TEST_ASSERT_EQ_STR("new content", s);
+        free(s);
+    }
+}
+
+static void test_benchmarks(void)
+{
+    static uint8_t block[4096];
+    char path[SYS_FILE_PATH_MAX];
+    strcpy(path, path_of("bench_read.bin"));
+    sys_file_t f;
+
+    for (size_t i = 0; i < sizeof(block); i++) {
+        block[i] = (uint8_t)rand();
+    }
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_file_open(&f, path, SYS_FILE_WRITE));
+    for (int i = 0; i < 64; i++) {     // 256 KB
+        sys_file_write(&f, block, sizeof(block));
+    }
+    sys_file_close(&f);
+
+    sys_file_benchmark(path);
+    sys_file_write_benchmark(s_dir);
+
+    // 写入测试用完的文件应已删除
+    struct stat st;
+    TEST_ASSERT(stat(path_of("bench.bin"), &st) != 0);
+    TEST_ASSERT(stat(path_of("bench.jnl"), &st) != 0);
+}
+
+int main(void)
+{
+    strcpy(s_dir, "/tmp/sys_file.XXXXXX");
+    if (!mkdtemp(s_dir)) {
+        return 1;
+    }
+
+    RUN_TEST(test_binary_chunks);
+    RUN_TEST(test_lines);
+    RUN_TEST(test_records);
+    RUN_TEST(test_atomic_replace);
+    RUN_TEST(test_benchmarks);
+
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", s_dir);
+    system(cmd);
+    return TEST_EXIT();
+}
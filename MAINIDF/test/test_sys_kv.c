@@ -0,0 +1,214 @@
+/*
+ * sys_kv 写回缓存测试：NVS 用 mock_nvs，FreeRTOS 用模拟时钟（host_rtos）
+ * 用例共享同一个已初始化的存储，按顺序执行，用统计增量判断写入次数。
+ */
+#include "test_common.h"
+#include "sys_kv.h"
+#include "mock_nvs.h"
+#include "host_rtos.h"
+
+static mock_nvs_counters_t s_base;
+
+static void mark(void)
+{
+    host_rtos_settle();
+    mock_nvs_counters(&s_base);
+}
+
+static uint32_t sets_since(void)
+{
+    mock_nvs_counters_t c;
+    mock_nvs_counters(&c);
+    return c.sets - s_base.sets;
+}
+
+static uint32_t commits_since(void)
+{
+    mock_nvs_counters_t c;
+    mock_nvs_counters(&c);
+    return c.commits - s_base.commits;
+}
+
+/* 初始化前 NVS 中已有的值：首次读取未命中，之后命中缓存 */
+static void test_load_from_nvs(void)
+{
+    sys_kv_stats_t st;
+    int32_t v = 0;
+
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_get_i32("pre", &v));
+    TEST_ASSERT_EQ_INT(42, v);
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_get_i32("pre", &v));
+    sys_kv_get_stats(&st);
+    TEST_ASSERT_EQ_INT(1, st.misses);
+    TEST_ASSERT_EQ_INT(1, st.hits);
+    TEST_ASSERT_EQ_INT(ESP_ERR_NVS_NOT_FOUND, sys_kv_get_i32("none", &v));
+}
+
+/* 合并窗口从首个脏写入开始计时，窗口内的后续写入不推迟写回，只写最终值 */
+static void test_coalesce_window(void)
+{
+    mark();
+    uint32_t t0 = host_rtos_now_ms();
+
+    sys_kv_set_i32("a", 1);
+    host_rtos_advance_ms(1000);
+    sys_kv_set_i32("a", 2);
+    sys_kv_set_i32("b", 3);
+    host_rtos_advance_ms(1000);
+    sys_kv_set_i32("a", 3);
+
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS - 10 - (host_rtos_now_ms() - t0));
+    TEST_ASSERT_EQ_INT(0, commits_since());
+    TEST_ASSERT_EQ_INT(0, sets_since());
+    TEST_ASSERT(!mock_nvs_committed_has("a"));
+
+    host_rtos_advance_ms(10);
+    TEST_ASSERT_EQ_INT(SYS_KV_COMMIT_DELAY_MS, host_rtos_now_ms() - t0);
+    TEST_ASSERT_EQ_INT(1, commits_since());
+    TEST_ASSERT_EQ_INT(2, sets_since());
+
+    int32_t v = 0;
+    TEST_ASSERT(mock_nvs_committed_i32("a", &v));
+    TEST_ASSERT_EQ_INT(3, v);
+    TEST_ASSERT(mock_nvs_committed_i32("b", &v));
+    TEST_ASSERT_EQ_INT(3, v);
+
+    // 没有新的写入就不再提交
+    host_rtos_advance_ms(2 * SYS_KV_COMMIT_DELAY_MS);
+    TEST_ASSERT_EQ_INT(1, commits_since());
+}
+
+/* 写入相同的值不产生 flash 写入，也不启动写回 */
+static void test_same_value_skipped(void)
+{
+    sys_kv_stats_t before, after;
+
+    mark();
+    sys_kv_get_stats(&before);
+    sys_kv_set_i32("a", 3);
+    sys_kv_set_str("s", "hello");
+    sys_kv_set_str("s", "hello");
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS);
+    sys_kv_get_stats(&after);
+    TEST_ASSERT_EQ_INT(2, after.skipped - before.skipped);
+    TEST_ASSERT_EQ_INT(1, sets_since());
+    TEST_ASSERT_EQ_INT(1, commits_since());
+
+    mark();
+    sys_kv_set_str("s", "hello");
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS);
+    TEST_ASSERT_EQ_INT(0, sets_since());
+    TEST_ASSERT_EQ_INT(0, commits_since());
+}
+
+/* 窗口结束前掉电只丢失窗口内的修改 */
+static void test_power_loss_in_window(void)
+{
+    int32_t v = 0;
+
+    mark();
+    sys_kv_set_i32("a", 4);
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS / 2);
+    TEST_ASSERT(mock_nvs_committed_i32("a", &v));
+    TEST_ASSERT_EQ_INT(3, v);
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS / 2);
+    TEST_ASSERT(mock_nvs_committed_i32("a", &v));
+    TEST_ASSERT_EQ_INT(4, v);
+}
+
+/* 缓存全部为脏条目时，分配新条目前立即写回，不等合并窗口 */
+static void test_full_cache_flushes(void)
+{
+    char key[16];
+
+    sys_kv_flush();
+    mark();
+    for (int i = 0; i < SYS_KV_CACHE_SIZE; i++) {
+        snprintf(key, sizeof(key), "k%d", i);
+        TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_set_i32(key, i));
+    }
+    TEST_ASSERT_EQ_INT(0, commits_since());
+
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_set_i32("overflow", -1));
+    TEST_ASSERT_EQ_INT(1, commits_since());
+    TEST_ASSERT_EQ_INT(SYS_KV_CACHE_SIZE, sets_since());
+    int32_t v = -2;
+    TEST_ASSERT(mock_nvs_committed_i32("k31", &v));
+    TEST_ASSERT_EQ_INT(31, v);
+    TEST_ASSERT(!mock_nvs_committed_has("overflow"));
+
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS);
+    TEST_ASSERT_EQ_INT(2, commits_since());
+    TEST_ASSERT_EQ_INT(SYS_KV_CACHE_SIZE + 1, sets_since());
+    TEST_ASSERT(mock_nvs_committed_i32("overflow", &v));
+    TEST_ASSERT_EQ_INT(-1, v);
+}
+
+/* 换类型时先删除旧条目，删除也合并到窗口结束 */
+static void test_retype_and_erase(void)
+{
+    char buf[8];
+    size_t len = sizeof(buf);
+    int32_t v;
+
+    sys_kv_set_i32("r", 1);
+    sys_kv_flush();
+    mark();
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_set_str("r", "x"));
+    TEST_ASSERT_EQ_INT(ESP_ERR_NVS_TYPE_MISMATCH, sys_kv_get_i32("r", &v));
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_get_str("r", buf, &len));
+    TEST_ASSERT_EQ_STR("x", buf);
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS);
+    mock_nvs_counters_t c;
+    mock_nvs_counters(&c);
+    TEST_ASSERT_EQ_INT(1, c.erases - s_base.erases);
+    TEST_ASSERT_EQ_INT(1, sets_since());
+
+    mark();
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_erase("r"));
+    TEST_ASSERT_EQ_INT(ESP_ERR_NVS_NOT_FOUND, sys_kv_get_str("r", buf, &len));
+    TEST_ASSERT(mock_nvs_committed_has("r"));
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS);
+    TEST_ASSERT(!mock_nvs_committed_has("r"));
+    TEST_ASSERT_EQ_INT(1, commits_since());
+}
+
+/* 超过 SYS_KV_CACHE_MAX_VAL 的数据直写 NVS，只延迟提交 */
+static void test_large_blob_direct(void)
+{
+    uint8_t big[SYS_KV_CACHE_MAX_VAL + 64];
+    uint8_t out[sizeof(big)];
+    size_t len = sizeof(out);
+
+    for (size_t i = 0; i < sizeof(big); i++) {
+        big[i] = (uint8_t)i;
+    }
+    mark();
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_set_blob("big", big, sizeof(big)));
+    TEST_ASSERT_EQ_INT(1, sets_since());
+    TEST_ASSERT_EQ_INT(0, commits_since());
+    host_rtos_advance_ms(SYS_KV_COMMIT_DELAY_MS);
+    TEST_ASSERT_EQ_INT(1, commits_since());
+    TEST_ASSERT_EQ_INT(ESP_OK, sys_kv_get_blob("big", out, &len));
+    TEST_ASSERT_EQ_INT(sizeof(big), len);
+    TEST_ASSERT(memcmp(big, out, sizeof(big)) == 0);
+}
+
+int main(void)
+{
+    mock_nvs_reset();
+    nvs_set_i32(1, "pre", 42);
+    nvs_commit(1);
+    if (sys_kv_init() != ESP_OK) {
+        return 1;
+    }
+
+    RUN_TEST(test_load_from_nvs);
+    RUN_TEST(test_coalesce_window);
+    RUN_TEST(test_same_value_skipped);
+    RUN_TEST(test_power_loss_in_window);
+    RUN_TEST(test_full_cache_flushes);
+    RUN_TEST(test_retype_and_erase);
+    RUN_TEST(test_large_blob_direct);
+    return TEST_EXIT();
+}
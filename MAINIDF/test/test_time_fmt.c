@@ -0,0 +1,189 @@
+/**
+ * @file test_time_fmt.c
+ * @brief time_fmt 主机测试：与主机 strftime（C locale）逐字比较，增量更新与完整格式化一致
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "time_fmt.h"
+
+static const char *const s_formats[] = {
+    "%Y-%m-%d %H:%M:%S",
+    "%y/%m/%e %I:%M:%S %p",
+    "%a %b %e %H:%M:%S %Y",
+    "%A, %B %d",
+    "%j %%",
+    "%Y年%m月%d日 %A",
+    "%H:%M",
+    "%B %A %S",
+};
+
+#define FORMAT_COUNT    (sizeof(s_formats) / sizeof(s_formats[0]))
+
+static uint32_t s_rng = 12345;
+
+static uint32_t next_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 1;
+}
+
+static void test_matches_strftime(void)
+{
+    time_fmt_t f;
+    char exp[TIME_FMT_MAX_LEN], act[TIME_FMT_MAX_LEN];
+
+    for (size_t k = 0; k < FORMAT_COUNT; k++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, s_formats[k]));
+        for (int i = 0; i < 20000; i++) {
+            // 1970 ~ 2099
+            time_t t = (time_t)(((uint64_t)next_rand() << 2) % 4102444800ULL);
+            struct tm tm;
+            gmtime_r(&t, &tm);
+            size_t n = strftime(exp, sizeof(exp), s_formats[k], &tm);
+            size_t m = time_fmt_format(&f, &tm, act, sizeof(act));
+            if (n != m || strcmp(exp, act) != 0) {
+                TEST_FAIL("\"%s\" at %lld: \"%s\", expected \"%s\"", s_formats[k], (long long)t, act, exp);
+                break;
+            }
+        }
+    }
+}
+
+static void test_compile_errors(void)
+{
+    time_fmt_t f;
+
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_SUPPORTED, time_fmt_compile(&f, "%H:%M %Z"));
+    TEST_ASSERT_EQ_INT(ESP_ERR_NOT_SUPPORTED, time_fmt_compile(&f, "%"));
+    // 最长输出超过 TIME_FMT_MAX_LEN
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_SIZE, time_fmt_compile(&f, "%B %B %B %B %B %B %B"));
+    // 字段数超过 TIME_FMT_MAX_TOKENS
+    TEST_ASSERT_EQ_INT(ESP_ERR_INVALID_SIZE, time_fmt_compile(&f, "%S%S%S%S%S%S%S%S%S%S%S%S%S%S%S%S%S"));
+    // 相邻文本段合并，不占用字段数
+    TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, "a%%b%%c%%d"));
+    TEST_ASSERT_EQ_INT(1, f.count);
+    TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, ""));
+    TEST_ASSERT_EQ_INT(0, f.max_len);
+}
+
+static void test_small_buffer(void)
+{
+    time_fmt_t f;
+    char buf[16];
+    struct tm tm = { .tm_year = 124, .tm_mon = 4, .tm_mday = 7, .tm_hour = 9, .tm_min = 5, .tm_sec = 3, .tm_wday = 2 };
+
+    TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, "%H:%M:%S"));
+    TEST_ASSERT_EQ_INT(8, time_fmt_format(&f, &tm, buf, 9));
+    TEST_ASSERT_EQ_STR("09:05:03", buf);
+    memset(buf, 'x', sizeof(buf));
+    TEST_ASSERT_EQ_INT(0, time_fmt_format(&f, &tm, buf, 8));     // 与 strftime 相同：放不下返回 0
+    TEST_ASSERT(buf[7] == 'x');                                 // 不写越界
+
+    // 可变宽度字段：最长 "Wednesday" 放不下但 "Tuesday" 放得下
+    TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, "%A"));
+    TEST_ASSERT_EQ_INT(7, time_fmt_format(&f, &tm, buf, 8));
+    TEST_ASSERT_EQ_STR("Tuesday", buf);
+}
+
+static void test_out_of_range_clamped(void)
+{
+    time_fmt_t f;
+    char buf[TIME_FMT_MAX_LEN];
+    struct tm tm = { .tm_year = 9000, .tm_mon = 15, .tm_mday = 0, .tm_hour = 30, .tm_min = -1, .tm_sec = 61,
+                     .tm_wday = 9, .tm_yday = 400 };
+
+    TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, "%Y %m %d %H %M %S %a %b"));
+    time_fmt_format(&f, &tm, buf, sizeof(buf));
+    TEST_ASSERT_EQ_STR("9999 12 01 23 00 60 Sat Dec", buf);
+    TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, "%j %B %A"));
+    time_fmt_format(&f, &tm, buf, sizeof(buf));
+    TEST_ASSERT_EQ_STR("366 December Saturday", buf);
+}
+
+/* 逐秒推进跨过日、月、年边界，增量结果始终与完整格式化相同 */
+static void test_update_matches_full(void)
+{
+    time_fmt_t f;
+    char exp[TIME_FMT_MAX_LEN];
+    // 2023-12-31 23:00:00 起 26 小时，跨年；再从 2024-02-28 跨闰日
+    const time_t starts[] = { 1704063600, 1709161200 };
+
+    for (size_t k = 0; k < FORMAT_COUNT; k++) {
+        TEST_ASSERT_EQ_INT(ESP_OK, time_fmt_compile(&f, s_formats[k]));
+        for (size_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+            time_fmt_cache_t cache;
+            memset(&cache, 0, sizeof(cache));
+            uint32_t changes = 0;
+            for (time_t t = starts[s]; t < starts[s] + 26 * 3600; t++) {
+                struct tm tm;
+                gmtime_r(&t, &tm);
+                changes += time_fmt_update(&f, &cache, &tm);
+                strftime(exp, sizeof(exp), s_formats[k], &tm);
+                if (strcmp(exp, cache.buf) != 0) {
+                    TEST_FAIL("\"%s\" at %lld: \"%s\", expected \"%s\"", s_formats[k], (long long)t, cache.buf, exp);
+                    break;
+                }
+            }
+            // 不含秒的格式每分钟才变化一次
+            if (!strstr(s_formats[k], "%S")) {
+                TEST_ASSERT(changes <= 26 * 60 + 1);
+            }
+        }
+    }
+}
+
+/* 逐秒格式化的耗时，时间分量预先算好，不计 gmtime_r */
+static void test_bench(void)
+{
+    time_fmt_t f;
+    time_fmt_cache_t cache;
+    char buf[TIME_FMT_MAX_LEN];
+    const char *fmt = "%Y-%m-%d %H:%M:%S";
+    const int n = 100000;
+    volatile size_t sink = 0;
+    struct tm *tms = malloc(n * sizeof(*tms));
+
+    TEST_ASSERT(tms != NULL);
+    if (!tms) {
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        time_t t = 1704063600 + i;
+        gmtime_r(&t, &tms[i]);
+    }
+    time_fmt_compile(&f, fmt);
+    memset(&cache, 0, sizeof(cache));
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        sink += strftime(buf, sizeof(buf), fmt, &tms[i]);
+    }
+    int64_t t1 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        sink += time_fmt_format(&f, &tms[i], buf, sizeof(buf));
+    }
+    int64_t t2 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        sink += time_fmt_update(&f, &cache, &tms[i]);
+    }
+    int64_t t3 = esp_timer_get_time();
+
+    printf("  per call: strftime %.0f ns, time_fmt_format %.0f ns, time_fmt_update %.0f ns\n",
+           (t1 - t0) * 1000.0 / n, (t2 - t1) * 1000.0 / n, (t3 - t2) * 1000.0 / n);
+    free(tms);
+    (void)sink;
+}
+
+int main(void)
+{
+    RUN_TEST(test_matches_strftime);
+    RUN_TEST(test_compile_errors);
+    RUN_TEST(test_small_buffer);
+    RUN_TEST(test_out_of_range_clamped);
+    RUN_TEST(test_update_matches_full);
+    RUN_TEST(test_bench);
+    return TEST_EXIT();
+}
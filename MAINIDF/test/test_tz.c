@@ -0,0 +1,201 @@
+/**
+ * @file test_tz.c
+ * @brief tz 主机测试：每个内置时区与主机 libc 按同一 POSIX TZ 串的换算结果逐一比较
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "test_common.h"
+#include "esp_timer.h"
+#include "tz.h"
+
+#define Y1970       0LL
+#define Y2100       4102444800LL
+
+static uint32_t s_rng = 2024;
+
+static uint32_t next_rand(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 1;
+}
+
+static void use_posix(const tz_zone_t *z)
+{
+    setenv("TZ", z->posix, 1);
+    tzset();
+}
+
+// 与 libc 比较一个时刻，不一致时打印并返回 false
+static bool check_one(tz_t *tz, const tz_zone_t *z, time_t t)
+{
+    struct tm exp, act;
+
+    localtime_r(&t, &exp);
+    tz_localtime(tz, t, &act);
+    if (exp.tm_year != act.tm_year || exp.tm_mon != act.tm_mon || exp.tm_mday != act.tm_mday ||
+        exp.tm_hour != act.tm_hour || exp.tm_min != act.tm_min || exp.tm_sec != act.tm_sec ||
+        exp.tm_wday != act.tm_wday || exp.tm_yday != act.tm_yday || !exp.tm_isdst != !act.tm_isdst) {
+        TEST_FAIL("%s at %lld: %04d-%02d-%02d %02d:%02d dst %d, expected %04d-%02d-%02d %02d:%02d dst %d",
+                  z->name, (long long)t, act.tm_year + 1900, act.tm_mon + 1, act.tm_mday, act.tm_hour,
+                  act.tm_min, act.tm_isdst, exp.tm_year + 1900, exp.tm_mon + 1, exp.tm_mday, exp.tm_hour,
+                  exp.tm_min, exp.tm_isdst);
+        return false;
+    }
+    return true;
+}
+
+static void test_zone_table(void)
+{
+    TEST_ASSERT(tz_zone_count() > 0);
+    TEST_ASSERT(tz_zone_get(tz_zone_count()) == NULL);
+    for (size_t i = 0; i < tz_zone_count(); i++) {
+        const tz_zone_t *z = tz_zone_get(i);
+        TEST_ASSERT(tz_find(z->name) == z);
+        // 有夏令时的时区规则完整
+        if (z->dst_min != z->std_min) {
+            TEST_ASSERT(z->start.month >= 1 && z->start.month <= 12 && z->start.week >= 1 && z->start.week <= 5);
+            TEST_ASSERT(z->end.month >= 1 && z->end.month <= 12 && z->end.week >= 1 && z->end.week <= 5);
+        }
+    }
+    TEST_ASSERT(tz_find("Mars/Olympus_Mons") == NULL);
+}
+
+/* 随机时刻：每次跳到不相关的年份，覆盖切换表重建 */
+static void test_random_matches_libc(void)
+{
+    for (size_t i = 0; i < tz_zone_count(); i++) {
+        const tz_zone_t *z = tz_zone_get(i);
+        tz_t tz;
+
+        use_posix(z);
+        tz_load(&tz, z);
+        for (int k = 0; k < 20000; k++) {
+            time_t t = (time_t)(((uint64_t)next_rand() << 2) % Y2100);
+            if (!check_one(&tz, z, t)) {
+                break;
+            }
+        }
+    }
+}
+
+/* 2020 ~ 2045 逐 15 分钟顺序推进，覆盖每个切换点前后以及缓存区间的延续 */
+static void test_sweep_matches_libc(void)
+{
+    const time_t from = 1577836800;     // 2020-01-01
+    const time_t to = 2398377600;       // 2046-01-01
+
+    for (size_t i = 0; i < tz_zone_count(); i++) {
+        const tz_zone_t *z = tz_zone_get(i);
+        tz_t tz;
+
+        use_posix(z);
+        tz_load(&tz, z);
+        for (time_t t = from; t < to; t += 15 * 60) {
+            if (!check_one(&tz, z, t)) {
+                break;
+            }
+        }
+    }
+}
+
+/* 切换点前后一秒：欧洲统一在 01:00 UTC，美国在当地 02:00 */
+static void test_transition_edges(void)
+{
+    static const struct {
+        const char *zone;
+        time_t at;          // 切换时刻（UTC）
+        bool dst_after;
+    } cases[] = {
+        {"Europe/London",       1711846800, true},  // 2024-03-31 01:00 UTC
+        {"Europe/Berlin",       1729990800, false}, // 2024-10-27 01:00 UTC
+        {"America/New_York",    1710054000, true},  // 2024-03-10 07:00 UTC
+        {"America/New_York",    1730613600, false}, // 2024-11-03 06:00 UTC
+        {"Australia/Sydney",    1712419200, false}, // 2024-04-06 16:00 UTC
+        {"Australia/Sydney",    1728144000, true},  // 2024-10-05 16:00 UTC
+        {"Pacific/Auckland",    1727532000, true},  // 2024-09-28 14:00 UTC
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const tz_zone_t *z = tz_find(cases[i].zone);
+        tz_t tz;
+        bool dst;
+
+        TEST_ASSERT(z != NULL);
+        if (!z) {
+            continue;
+        }
+        tz_load(&tz, z);
+        int32_t before = tz_offset(&tz, cases[i].at - 1, &dst);
+        TEST_ASSERT(dst == !cases[i].dst_after);
+        int32_t after = tz_offset(&tz, cases[i].at, &dst);
+        TEST_ASSERT(dst == cases[i].dst_after);
+        TEST_ASSERT_EQ_INT((z->dst_min - z->std_min) * 60, cases[i].dst_after ? after - before : before - after);
+    }
+}
+
+/* 支持的时间范围两端和负时间（1970 年以前） */
+static void test_range_edges(void)
+{
+    const time_t edges[] = {
+        Y1970, Y1970 - 1, -86400LL * 365 * 50, Y2100 - 1, Y2100, 32503680000LL /* 3000 年 */,
+    };
+
+    for (size_t i = 0; i < tz_zone_count(); i++) {
+        const tz_zone_t *z = tz_zone_get(i);
+        tz_t tz;
+
+        use_posix(z);
+        tz_load(&tz, z);
+        for (size_t k = 0; k < sizeof(edges) / sizeof(edges[0]); k++) {
+            if (!check_one(&tz, z, edges[k])) {
+                break;
+            }
+        }
+    }
+}
+
+/* 缓存命中时的耗时，与 localtime_r 对比 */
+static void test_bench(void)
+{
+    const tz_zone_t *z = tz_find("Europe/Berlin");
+    const int n = 1000000;
+    volatile int64_t sink = 0;
+    tz_t tz;
+    struct tm tm;
+
+    use_posix(z);
+    tz_load(&tz, z);
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        sink += tz_offset(&tz, 1717200000 + i, NULL);
+    }
+    int64_t t1 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        time_t t = 1717200000 + i;
+        tz_localtime(&tz, t, &tm);
+        sink += tm.tm_sec;
+    }
+    int64_t t2 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) {
+        time_t t = 1717200000 + i;
+        localtime_r(&t, &tm);
+        sink += tm.tm_sec;
+    }
+    int64_t t3 = esp_timer_get_time();
+
+    printf("  per call: tz_offset %.1f ns, tz_localtime %.1f ns, libc localtime_r %.1f ns\n",
+           (t1 - t0) * 1000.0 / n, (t2 - t1) * 1000.0 / n, (t3 - t2) * 1000.0 / n);
+    (void)sink;
+}
+
+int main(void)
+{
+    RUN_TEST(test_zone_table);
+    RUN_TEST(test_random_matches_libc);
+    RUN_TEST(test_sweep_matches_libc);
+    RUN_TEST(test_transition_edges);
+    RUN_TEST(test_range_edges);
+    RUN_TEST(test_bench);
+    return TEST_EXIT();
+}
@@ -0,0 +1,185 @@
+/**
+ * @file test_wifi_policy.c
+ * @brief wifi_policy 主机测试：退避上限、抖动范围和分布、亮屏重算
+ *
+ * 时钟由测试自己推进（毫秒计数），按 wifi_mgr 的用法保存截止时间：
+ * 失败后 until = now + wifi_policy_fail()，亮屏时 now + wifi_policy_delay(ON) 更早则提前。
+ */
+
+#include <stdlib.h>
+#include "test_common.h"
+#include "wifi_policy.h"
+
+#define FLEET       200     // 模拟的设备数
+
+static uint64_t s_now_ms;
+
+/* 不加抖动时第 n 轮的等待时间 */
+static uint64_t nominal(const wifi_policy_cfg_t *cfg, unsigned n)
+{
+    uint64_t d = cfg->base_ms;
+    for (unsigned i = 1; i < n && d < cfg->max_ms; i++) {
+        d <<= 1;
+    }
+    return d > cfg->max_ms ? cfg->max_ms : d;
+}
+
+static void test_no_jitter_doubles_to_cap(void)
+{
+    wifi_policy_t p;
+    const wifi_policy_cfg_t cfg = { .base_ms = 1000, .max_ms = 20000, .jitter_pct = 0 };
+    const uint32_t expect[] = { 1000, 2000, 4000, 8000, 16000, 20000, 20000 };
+
+    wifi_policy_init(&p, 1);
+    wifi_policy_set(&p, WIFI_POLICY_SCREEN_ON, &cfg);
+    TEST_ASSERT_EQ_INT(0, wifi_policy_delay(&p, WIFI_POLICY_SCREEN_ON));
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        TEST_ASSERT_EQ_INT(expect[i], wifi_policy_fail(&p, WIFI_POLICY_SCREEN_ON));
+    }
+    TEST_ASSERT_EQ_INT(7, p.failures);
+
+    wifi_policy_reset(&p);
+    TEST_ASSERT_EQ_INT(0, wifi_policy_delay(&p, WIFI_POLICY_SCREEN_ON));
+    TEST_ASSERT_EQ_INT(1000, wifi_policy_fail(&p, WIFI_POLICY_SCREEN_ON));
+}
+
+static void test_jitter_within_bounds(void)
+{
+    for (uint32_t seed = 1; seed <= FLEET; seed++) {
+        wifi_policy_t p;
+        wifi_policy_init(&p, seed);
+        for (unsigned n = 1; n <= 20; n++) {
+            wifi_policy_mode_t mode = (n & 1) ? WIFI_POLICY_SCREEN_ON : WIFI_POLICY_SCREEN_OFF;
+            const wifi_policy_cfg_t *cfg = &p.cfg[mode];
+            uint32_t d = wifi_policy_fail(&p, mode);
+            uint64_t nom = nominal(cfg, n);
+            uint64_t span = nom * cfg->jitter_pct / 100;
+            uint64_t hi = nom + span > cfg->max_ms ? cfg->max_ms : nom + span;
+            if (d < nom - span || d > hi) {
+                TEST_FAIL("seed %u round %u: %u not in [%llu, %llu]", (unsigned)seed, n, (unsigned)d,
+                          (unsigned long long)(nom - span), (unsigned long long)hi);
+                return;
+            }
+        }
+    }
+}
+
+static void test_same_seed_same_sequence(void)
+{
+    wifi_policy_t a, b;
+
+    wifi_policy_init(&a, 42);
+    wifi_policy_init(&b, 42);
+    for (int i = 0; i < 30; i++) {
+        TEST_ASSERT_EQ_INT(wifi_policy_fail(&a, WIFI_POLICY_SCREEN_OFF), wifi_policy_fail(&b, WIFI_POLICY_SCREEN_OFF));
+    }
+
+    // 种子 0 替换为非零值，否则 xorshift 一直输出 0，抖动失效
+    wifi_policy_init(&a, 0);
+    TEST_ASSERT(a.rng != 0);
+}
+
+static void test_set_clamps_jitter(void)
+{
+    wifi_policy_t p;
+    const wifi_policy_cfg_t cfg = { .base_ms = 1000, .max_ms = 1000, .jitter_pct = 250 };
+
+    wifi_policy_init(&p, 7);
+    wifi_policy_set(&p, WIFI_POLICY_SCREEN_OFF, &cfg);
+    TEST_ASSERT_EQ_INT(100, p.cfg[WIFI_POLICY_SCREEN_OFF].jitter_pct);
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT(wifi_policy_fail(&p, WIFI_POLICY_SCREEN_OFF) <= 1000);
+    }
+    // 越界的模式不修改，也不产生等待
+    wifi_policy_set(&p, WIFI_POLICY_MODE_MAX, &cfg);
+    TEST_ASSERT_EQ_INT(0, wifi_policy_delay(&p, WIFI_POLICY_MODE_MAX));
+}
+
+static void test_failures_saturate(void)
+{
+    wifi_policy_t p;
+
+    wifi_policy_init(&p, 3);
+    p.failures = UINT16_MAX - 1;
+    wifi_policy_fail(&p, WIFI_POLICY_SCREEN_ON);
+    uint32_t d = wifi_policy_fail(&p, WIFI_POLICY_SCREEN_ON);
+    TEST_ASSERT_EQ_INT(UINT16_MAX, p.failures);
+    TEST_ASSERT(d <= p.cfg[WIFI_POLICY_SCREEN_ON].max_ms);
+    TEST_ASSERT(d >= p.cfg[WIFI_POLICY_SCREEN_ON].max_ms * 80 / 100);
+}
+
+/* 熄屏退避中亮屏：按亮屏策略重算，只会提前不会推迟 */
+static void test_screen_on_shortens_backoff(void)
+{
+    wifi_policy_t p;
+
+    wifi_policy_init(&p, 99);
+    s_now_ms = 0;
+    for (int i = 0; i < 5; i++) {
+        s_now_ms += wifi_policy_fail(&p, WIFI_POLICY_SCREEN_OFF);
+    }
+    // 第 6 轮熄屏等待约 30 s << 5 = 16 min，亮屏上限 5 min；失败 1 s 后亮屏
+    uint64_t until = s_now_ms + wifi_policy_fail(&p, WIFI_POLICY_SCREEN_OFF);
+    s_now_ms += 1000;
+    uint64_t on_until = s_now_ms + wifi_policy_delay(&p, WIFI_POLICY_SCREEN_ON);
+    TEST_ASSERT(on_until < until);
+    TEST_ASSERT(on_until - s_now_ms <= p.cfg[WIFI_POLICY_SCREEN_ON].max_ms);
+    TEST_ASSERT_EQ_INT(6, p.failures);   // 重算不计入失败轮数
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/*
+ * 路由器断电 10 分钟后恢复：所有设备同时掉线，熄屏策略退避。
+ * 恢复后每台设备在下一次重试时连上，检查重连时刻足够分散、等待时间有上限。
+ */
+static void test_fleet_reconnect_spread(void)
+{
+    const uint64_t outage_ms = 10 * 60 * 1000;
+    static wifi_policy_t fleet[FLEET];
+    uint64_t reconnect[FLEET];
+
+    for (int i = 0; i < FLEET; i++) {
+        wifi_policy_init(&fleet[i], 0x1000 + i * 7919);
+        s_now_ms = 0;
+        while (s_now_ms < outage_ms) {
+            s_now_ms += wifi_policy_fail(&fleet[i], WIFI_POLICY_SCREEN_OFF);
+        }
+        reconnect[i] = s_now_ms;
+    }
+    qsort(reconnect, FLEET, sizeof(reconnect[0]), cmp_u64);
+
+    // 最晚的设备不超过恢复后一个最大等待时间（含抖动上限）
+    uint64_t worst = reconnect[FLEET - 1] - outage_ms;
+    TEST_ASSERT(worst <= fleet[0].cfg[WIFI_POLICY_SCREEN_OFF].max_ms);
+
+    // 任意 1 秒内重连的设备不超过 5%，没有抖动时会全部挤在同一时刻
+    int busiest = 0;
+    for (int lo = 0, hi = 0; hi < FLEET; hi++) {
+        while (reconnect[hi] - reconnect[lo] >= 1000) {
+            lo++;
+        }
+        if (hi - lo + 1 > busiest) {
+            busiest = hi - lo + 1;
+        }
+    }
+    printf("  fleet of %d: worst wait %llu ms, busiest second %d devices\n", FLEET,
+           (unsigned long long)worst, busiest);
+    TEST_ASSERT(busiest <= FLEET / 20);
+}
+
+int main(void)
+{
+    RUN_TEST(test_no_jitter_doubles_to_cap);
+    RUN_TEST(test_jitter_within_bounds);
+    RUN_TEST(test_same_seed_same_sequence);
+    RUN_TEST(test_set_clamps_jitter);
+    RUN_TEST(test_failures_saturate);
+    RUN_TEST(test_screen_on_shortens_backoff);
+    RUN_TEST(test_fleet_reconnect_spread);
+    return TEST_EXIT();
+}
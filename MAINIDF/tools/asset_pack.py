@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+"""
+asset_pack.py - 打包只读资源分区镜像
+
+格式定义见 main/basic/assets.h / assets.c。
+按子目录决定资源类型，资源名为去掉扩展名的相对路径（如 img/logo）:
+    img/*.bin    LVGL 图片二进制（lv_img_header_t + 像素数据，LVGL 图片转换器的 Binary 输出）
+    img/*.ppm    其它图片（PPM，或安装 Pillow 后的 PNG 等）转换为 LV_IMG_CF_TRUE_COLOR，
+                 RGB565 高字节在前，与 sdkconfig 中的 LV_COLOR_16_SWAP=y 一致
+    font/*.bin   lv_font_conv 二进制字体（需 --format bin --no-compress），转换为可原地使用的 AFN1 格式
+    其它文件     原始数据（如 sounds/*.bmf）
+
+--add 名称=文件 把目录之外的文件按名称加入，类型同样由名称的第一级目录决定。
+
+用法:
+    python tools/asset_pack.py assets/ -o build/assets.bin --size 0x200000
+    python tools/asset_pack.py --add img/logo=images/splash_logo.ppm -o build/assets.bin
+    python tools/asset_pack.py --list build/assets.bin
+
+字体生成示例:
+    lv_font_conv --font SourceHanSans.otf -r 0x20-0x7F --symbols 时钟闹钟 --size 20 --bpp 4 \\
+                 --format bin --no-compress -o assets/font/siyuan_20.bin
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from img2splash import read_image, rgb565_bytes  # noqa: E402
+
+PACK_MAGIC = b'AST1'
+PACK_VERSION = 1
+HDR_FMT = '<4sHHIII12x'             # 32 字节
+ENTRY_FMT = '<IIIIB3x'              # 20 字节
+FONT_HDR_FMT = '<4sHhBBHbbHIIII'    # 32 字节
+FONT_CMAP_FMT = '<IHHHBBII'         # 20 字节
+
+TYPE_RAW = 0
+TYPE_IMG = 1
+TYPE_FONT = 2
+TYPE_NAMES = {TYPE_RAW: 'raw', TYPE_IMG: 'img', TYPE_FONT: 'font'}
+
+NAME_MAX = 64
+
+LV_IMG_CF_TRUE_COLOR = 4
+IMG_BG = (0xFF, 0xFF, 0xFF)         # 透明像素混合的背景色，与默认浅色主题一致
+
+# lv_font_fmt_txt_cmap_type_t
+CMAP_FORMAT0_FULL = 0
+CMAP_SPARSE_FULL = 1
+CMAP_FORMAT0_TINY = 2
+CMAP_SPARSE_TINY = 3
+
+
+def fnv1a(name):
+    """与 assets.c 中 name_hash() 一致"""
+    h = 2166136261
+    for b in name.encode('utf-8'):
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def align(data, n=4):
+    return data + b'\0' * (-len(data) % n)
+
+
+class BitReader:
+    """高位在前的位读取器，与 LVGL lv_font_loader 的 bit_iterator 一致"""
+
+    def __init__(self, data, pos=0):
+        self.data = data
+        self.bit = pos * 8
+
+    def read(self, n):
+        v = 0
+        for _ in range(n):
+            byte = self.data[self.bit // 8]
+            v = (v << 1) | ((byte >> (7 - self.bit % 8)) & 1)
+            self.bit += 1
+        return v
+
+    def read_signed(self, n):
+        v = self.read(n)
+        if n and v & (1 << (n - 1)):
+            v -= 1 << n
+        return v
+
+
+def read_tables(data):
+    tables = {}
+    pos = 0
+    while pos + 8 <= len(data):
+        length, tag = struct.unpack_from('<I4s', data, pos)
+        if length < 8:
+            raise ValueError('bad table length at %d' % pos)
+        tables[tag.decode('ascii')] = (pos, length)
+        pos += length
+    return tables
+
+
+def convert_font(data, label):
+    """把 lv_font_conv 二进制字体转换为 AFN1 格式"""
+    tables = read_tables(data)
+    for t in ('head', 'cmap', 'loca', 'glyf'):
+        if t not in tables:
+            raise ValueError('%s: missing "%s" table, not an lv_font_conv bin font' % (label, t))
+
+    h = struct.unpack_from('<IHHHhHhHhhHH10BhH', data, tables['head'][0] + 8)
+    (_, _, _, ascent, descent, _, _, _, _, _, default_adv_w, _,
+     loca_fmt, _, adv_w_fmt, bpp, xy_bits, wh_bits, adv_w_bits, compression, _, _,
+     ul_pos, ul_thick) = h
+    if compression != 0:
+        raise ValueError('%s: compressed fonts cannot be used in place, regenerate with --no-compress' % label)
+    if bpp not in (1, 2, 4, 8):
+        raise ValueError('%s: unsupported bpp %d' % (label, bpp))
+    if 'kern' in tables:
+        print('warning: %s: kerning table ignored' % label, file=sys.stderr)
+
+    # cmap
+    cpos = tables['cmap'][0]
+    (count,) = struct.unpack_from('<I', data, cpos + 8)
+    cmaps = []
+    for i in range(count):
+        off, start, length, gid_start, entries, fmt, _ = struct.unpack_from('<IIHHHBB', data, cpos + 12 + i * 16)
+        dpos = cpos + off
+        unicode_list = gid_list = None
+        list_length = 0
+        if fmt == CMAP_FORMAT0_FULL:
+            gid_list = data[dpos:dpos + entries]
+            list_length = length
+        elif fmt in (CMAP_SPARSE_FULL, CMAP_SPARSE_TINY):
+            unicode_list = data[dpos:dpos + entries * 2]
+            list_length = entries
+            if fmt == CMAP_SPARSE_FULL:
+                gid_list = data[dpos + entries * 2:dpos + entries * 4]
+        elif fmt != CMAP_FORMAT0_TINY:
+            raise ValueError('%s: unknown cmap format %d' % (label, fmt))
+        cmaps.append((start, length, gid_start, list_length, fmt, unicode_list, gid_list))
+
+    # loca
+    lpos = tables['loca'][0]
+    (loca_count,) = struct.unpack_from('<I', data, lpos + 8)
+    lfmt = '<%d%s' % (loca_count, 'H' if loca_fmt == 0 else 'I')
+    loca = struct.unpack_from(lfmt, data, lpos + 12)
+
+    # glyf
+    gpos, glen = tables['glyf']
+    dscs = []
+    bitmaps = bytearray()
+    for i in range(loca_count):
+        br = BitReader(data, gpos + loca[i])
+        adv_w = br.read(adv_w_bits) if adv_w_bits else default_adv_w
+        if adv_w_fmt == 0:
+            adv_w *= 16
+        ofs_x = br.read_signed(xy_bits)
+        ofs_y = br.read_signed(xy_bits)
+        box_w = br.read(wh_bits)
+        box_h = br.read(wh_bits)
+        if i == 0:
+            adv_w = box_w = box_h = ofs_x = ofs_y = 0
+
+        nbits = box_w * box_h * bpp
+        bitmap_index = len(bitmaps)
+        out = 0
+        for b in range(nbits):
+            out = (out << 1) | br.read(1)
+            if b % 8 == 7:
+                bitmaps.append(out)
+                out = 0
+        if nbits % 8:
+            bitmaps.append(out << (8 - nbits % 8))
+
+        if adv_w >= 1 << 12 or bitmap_index >= 1 << 20:
+            raise ValueError('%s: glyph %d does not fit the compact glyph descriptor' % (label, i))
+        if not (-128 <= ofs_x < 128 and -128 <= ofs_y < 128 and box_w < 256 and box_h < 256):
+            raise ValueError('%s: glyph %d box out of range' % (label, i))
+        dscs.append(struct.pack('<IBBbb', bitmap_index | (adv_w << 20), box_w, box_h, ofs_x, ofs_y))
+
+    # 组装：头部、cmap 表、cmap 列表、字形表、位图
+    hdr_size = struct.calcsize(FONT_HDR_FMT)
+    cmap_off = hdr_size
+    lists = bytearray()
+    lists_base = cmap_off + len(cmaps) * struct.calcsize(FONT_CMAP_FMT)
+    cmap_bin = bytearray()
+    for start, length, gid_start, list_length, fmt, ulist, glist in cmaps:
+        uoff = goff = 0
+        if ulist:
+            uoff = lists_base + len(lists)
+            lists += align(ulist)
+        if glist:
+            goff = lists_base + len(lists)
+            lists += align(glist)
+        cmap_bin += struct.pack(FONT_CMAP_FMT, start, length, gid_start, list_length, fmt, 0, uoff, goff)
+
+    glyph_dsc_off = lists_base + len(lists)
+    bitmap_off = glyph_dsc_off + len(dscs) * 8
+    clamp8 = lambda v: max(-128, min(127, v))
+    hdr = struct.pack(FONT_HDR_FMT, b'AFN1', ascent - descent, -descent, bpp, len(cmaps), loca_count,
+                      clamp8(ul_pos), clamp8(ul_thick), 0, glyph_dsc_off, bitmap_off, cmap_off, 0)
+    return hdr + bytes(cmap_bin) + bytes(lists) + b''.join(dscs) + bytes(bitmaps)
+
+
+def check_image(data, label):
+    if len(data) < 4:
+        raise ValueError('%s: too short for an LVGL image' % label)
+    (h,) = struct.unpack_from('<I', data, 0)
+    cf, w, h_ = h & 0x1F, (h >> 10) & 0x7FF, (h >> 21) & 0x7FF
+    if cf == 0 or w == 0 or h_ == 0:
+        raise ValueError('%s: invalid LVGL image header' % label)
+    return data
+
+
+def convert_image(path, label):
+    """把普通图片转换为 LVGL 真彩色图片"""
+    w, h, pixels = read_image(path, IMG_BG)
+    if not (0 < w < 2048 and 0 < h < 2048):
+        raise ValueError('%s: %dx%d does not fit lv_img_header_t' % (label, w, h))
+    hdr = struct.pack('<I', LV_IMG_CF_TRUE_COLOR | (w << 10) | (h << 21))
+    return hdr + b''.join(rgb565_bytes(p) for p in pixels)
+
+
+def load(name, path, label):
+    top = name.split('/', 1)[0] if '/' in name else ''
+    if top == 'img':
+        if path.lower().endswith('.bin'):
+            with open(path, 'rb') as f:
+                return name, TYPE_IMG, check_image(f.read(), label)
+        return name, TYPE_IMG, convert_image(path, label)
+    with open(path, 'rb') as f:
+        data = f.read()
+    if top == 'font':
+        return name, TYPE_FONT, convert_font(data, label)
+    return name, TYPE_RAW, data
+
+
+def collect(root):
+    items = []
+    for dirpath, _, files in os.walk(root):
+        for fn in sorted(files):
+            path = os.path.join(dirpath, fn)
+            rel = os.path.relpath(path, root).replace(os.sep, '/')
+            items.append(load(os.path.splitext(rel)[0], path, rel))
+    return items
+
+
+def build_pack(items):
+    names = {}
+    for name, _, _ in items:
+        if len(name.encode('utf-8')) >= NAME_MAX:
+            raise ValueError('name too long: %s' % name)
+        if name in names:
+            raise ValueError('duplicate asset name: %s' % name)
+        names[name] = True
+
+    items = sorted(items, key=lambda it: (fnv1a(it[0]), it[0]))
+    hdr_size = struct.calcsize(HDR_FMT)
+    index_size = len(items) * struct.calcsize(ENTRY_FMT)
+
+    name_tab = bytearray()
+    name_offs = []
+    for name, _, _ in items:
+        name_offs.append(hdr_size + index_size + len(name_tab))
+        name_tab += name.encode('utf-8') + b'\0'
+    names_size = len(name_tab)
+
+    body = bytearray(align(bytes(name_tab)))
+    data_base = hdr_size + index_size
+    index = bytearray()
+    for (name, typ, data), noff in zip(items, name_offs):
+        doff = data_base + len(body)
+        body += align(data)
+        index += struct.pack(ENTRY_FMT, fnv1a(name), noff, doff, len(data), typ)
+
+    crc = zlib.crc32(bytes(index) + bytes(name_tab)) & 0xFFFFFFFF
+    total = hdr_size + len(index) + len(body)
+    hdr = struct.pack(HDR_FMT, PACK_MAGIC, PACK_VERSION, len(items), crc, total, names_size)
+    return hdr + bytes(index) + bytes(body)
+
+
+def list_pack(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, ver, count, crc, total, names_size = struct.unpack_from(HDR_FMT, data, 0)
+    if magic != PACK_MAGIC:
+        sys.exit('%s: not an asset pack' % path)
+    hdr_size = struct.calcsize(HDR_FMT)
+    esize = struct.calcsize(ENTRY_FMT)
+    ok = zlib.crc32(data[hdr_size:hdr_size + count * esize + names_size]) & 0xFFFFFFFF == crc
+    print('%s: version %d, %d assets, %d bytes, index crc %s' % (path, ver, count, total, 'ok' if ok else 'BAD'))
+    for i in range(count):
+        h, noff, doff, size, typ = struct.unpack_from(ENTRY_FMT, data, hdr_size + i * esize)
+        name = data[noff:data.index(b'\0', noff)].decode('utf-8')
+        print('  %08x  %-5s %8d @ 0x%06x  %s' % (h, TYPE_NAMES.get(typ, '?'), size, doff, name))
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Build the read-only assets partition image')
+    ap.add_argument('input', nargs='?', help='asset directory')
+    ap.add_argument('--add', action='append', default=[], metavar='NAME=FILE',
+                    help='add a file outside the asset directory under NAME')
+    ap.add_argument('-o', '--output', help='output image')
+    ap.add_argument('--size', type=lambda s: int(s, 0), help='partition size; fail if the pack does not fit')
+    ap.add_argument('--list', metavar='IMAGE', help='list the contents of an existing image')
+    args = ap.parse_args()
+
+    if args.list:
+        list_pack(args.list)
+        return
+    if not (args.input or args.add) or not args.output:
+        ap.error('an input directory or --add, and -o are required')
+    if args.input and not os.path.isdir(args.input):
+        ap.error('%s is not a directory' % args.input)
+
+    try:
+        items = collect(args.input) if args.input else []
+        for spec in args.add:
+            name, sep, path = spec.partition('=')
+            if not sep or not name or not path:
+                ap.error('--add expects NAME=FILE, got %s' % spec)
+            items.append(load(name, path, path))
+        pack = build_pack(items)
+    except ValueError as e:
+        sys.exit('error: %s' % e)
+
+    if args.size is not None and len(pack) > args.size:
+        sys.exit('error: pack is %d bytes, partition is only %d' % (len(pack), args.size))
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'wb') as f:
+        f.write(pack)
+    print('%s: %d bytes' % (args.output, len(pack)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+beep_timing_check.py - 核对蜂鸣器音调引擎的包络时序
+
+将日志级别 BEEP 设为 DEBUG（esp_log_level_set("BEEP", ESP_LOG_DEBUG)），
+播放铃声并保存串口日志，然后：
+
+    python tools/beep_timing_check.py monitor.log [--tolerance-us 1000]
+
+脚本按 beepdrive.c 的调度模型，从每条 "Tone ..." 日志计算各阶段的计划结束时间，
+与随后的 "tone ... phase N ..." 时间戳日志逐条比较，输出误差统计。
+误差超过容差时返回非零退出码。
+"""
+
+import argparse
+import re
+import sys
+
+TONE_RE = re.compile(r'BEEP: Tone (\d+)Hz vol (\d+) dur (\d+)ms \(A(\d+) D(\d+) R(\d+)\)')
+PHASE_RE = re.compile(r'BEEP: tone (\d+)Hz phase (\d) at (-?\d+) us \(\+(-?\d+) us from start\)')
+
+PHASE_NAMES = {1: 'attack', 2: 'decay', 3: 'sustain', 4: 'release'}
+
+
+def expected_end_ms(phase, dur, a, d, r):
+    """与 beepdrive.c 中 tone_phase_deadline() 相同的模型"""
+    return {1: a, 2: a + d, 3: dur - r, 4: dur}[phase]
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Check beep envelope timing against logged timestamps')
+    ap.add_argument('log', help='serial monitor log file')
+    ap.add_argument('--tolerance-us', type=int, default=1000,
+                    help='max allowed deviation per transition (default 1000)')
+    args = ap.parse_args()
+
+    tone = None
+    errors = []
+    worst = (0, None)
+
+    with open(args.log, encoding='utf-8', errors='replace') as f:
+        for lineno, line in enumerate(f, 1):
+            m = TONE_RE.search(line)
+            if m:
+                tone = tuple(int(v) for v in m.groups())
+                continue
+            m = PHASE_RE.search(line)
+            if not m or tone is None:
+                continue
+            freq, phase, _, since_start = (int(v) for v in m.groups())
+            if freq != tone[0]:
+                continue
+            _, _, dur, a, d, r = tone
+            err = since_start - expected_end_ms(phase, dur, a, d, r) * 1000
+            errors.append(err)
+            if abs(err) > abs(worst[0]):
+                worst = (err, '%s:%d %dHz %s' % (args.log, lineno, freq, PHASE_NAMES[phase]))
+
+    if not errors:
+        print('no tone transitions found (is BEEP log level DEBUG?)')
+        return 1
+
+    errors.sort()
+    n = len(errors)
+    print('transitions: %d' % n)
+    print('mean error : %.1f us' % (sum(errors) / n))
+    print('median     : %d us' % errors[n // 2])
+    print('p99        : %d us' % errors[min(n - 1, int(n * 0.99))])
+    print('worst      : %d us at %s' % worst)
+
+    bad = [e for e in errors if abs(e) > args.tolerance_us]
+    if bad:
+        print('%d transitions exceed %d us tolerance' % (len(bad), args.tolerance_us))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+img2splash.py - 把图片转换为启动画面 logo 的 RLE 压缩 C 数组
+
+格式定义见 main/basic/splash.h：
+    控制字节 c：c & 0x80 为重复段，(c & 0x7F) + 1 个相同像素，后跟 1 个像素；
+               否则为原样段，后跟 c + 1 个像素
+    像素为 RGB565，按发送到屏幕的字节顺序（高字节在前）保存，像素流跨行连续
+
+输入支持二进制 PPM（P6，无需额外依赖）；安装了 Pillow 时也支持 PNG 等格式，
+透明像素按 --bg 指定的背景色混合。
+
+用法:
+    python tools/img2splash.py images/splash_logo.ppm -o main/ui/splash_logo.c
+    python tools/img2splash.py logo.png -o main/ui/splash_logo.c --bg 0x10,0x18,0x20
+"""
+
+import argparse
+import os
+import sys
+
+
+def read_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    tokens = []
+    pos = 0
+    while len(tokens) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos) + 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        tokens.append(data[start:pos])
+    if tokens[0] != b'P6' or int(tokens[3]) != 255:
+        raise ValueError('%s: only binary 8-bit PPM (P6) is supported' % path)
+    w, h = int(tokens[1]), int(tokens[2])
+    pix = data[pos + 1:pos + 1 + w * h * 3]
+    return w, h, [tuple(pix[i:i + 3]) for i in range(0, w * h * 3, 3)]
+
+
+def read_image(path, bg):
+    if path.lower().endswith('.ppm'):
+        return read_ppm(path)
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('error: Pillow is required for %s, or convert it to PPM first' % path)
+    img = Image.open(path).convert('RGBA')
+    out = []
+    for r, g, b, a in img.getdata():
+        out.append(tuple((c * a + k * (255 - a)) // 255 for c, k in zip((r, g, b), bg)))
+    return img.width, img.height, out
+
+
+def rgb565_bytes(rgb):
+    r, g, b = rgb
+    v = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+    return bytes((v >> 8, v & 0xFF))
+
+
+def rle_encode(pixels):
+    px = [rgb565_bytes(p) for p in pixels]
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:128]
+            del literal[:128]
+            out.append(len(chunk) - 1)
+            for p in chunk:
+                out.extend(p)
+
+    i = 0
+    while i < len(px):
+        run = 1
+        while i + run < len(px) and run < 128 and px[i + run] == px[i]:
+            run += 1
+        if run >= 3:
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out += px[i]
+            i += run
+        else:
+            literal.append(px[i])
+            i += 1
+    flush_literal()
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Convert an image to the RLE splash logo C source')
+    ap.add_argument('input', help='PPM (P6) image, or PNG etc. with Pillow installed')
+    ap.add_argument('-o', '--output', required=True, help='output .c file')
+    ap.add_argument('--name', default='splash_logo', help='C symbol name (default splash_logo)')
+    ap.add_argument('--bg', default='0x10,0x18,0x20',
+                    help='background r,g,b for transparent pixels (default matches SPLASH_BG)')
+    args = ap.parse_args()
+
+    bg = tuple(int(v, 0) for v in args.bg.split(','))
+    w, h, pixels = read_image(args.input, bg)
+    data = rle_encode(pixels)
+
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append('    ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+
+    src = '''/* 由 tools/img2splash.py 从 %s 生成，请勿手动修改 */
+#include "splash.h"
+
+static const uint8_t %s_data[%d] = {
+%s
+};
+
+const splash_img_t %s = {
+    .w = %d,
+    .h = %d,
+    .size = sizeof(%s_data),
+    .data = %s_data,
+};
+''' % (os.path.basename(args.input), args.name, len(data), '\n'.join(lines),
+       args.name, w, h, args.name, args.name)
+
+    with open(args.output, 'w', encoding='utf-8') as f:
+        f.write(src)
+    print('%s: %dx%d, %d bytes (raw %d, %.1f%%)' % (args.output, w, h, len(data), w * h * 2,
+                                                   100.0 * len(data) / (w * h * 2)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,373 @@
+#!/usr/bin/env python3
+"""
+lunar_table.py - 生成农历与节气数据表 main/basic/lunar_data.c
+
+农历月表以公开发布的 1900~2100 农历数据（香港天文台/紫金山天文台历表，即常见的
+lunarInfo 表）为准，节气由太阳视黄经计算。生成前先用天文算法独立核对：
+
+- 用 Meeus 算法计算朔日和中气（1929 年前用北京地方平时，之后用东八区），
+  按"冬至在十一月、无中气月置闰"规则推出每年的月序和大小月，与发布的月表逐年比较；
+  只允许出现在朔或中气距午夜不到 NEAR_MIDNIGHT_MIN 分钟、超出本算法精度的年份
+- 节气时刻距午夜不到 NEAR_MIDNIGHT_MIN 分钟时，按寿星通式及其已公布的修正表确定日期
+
+用法:
+    python tools/lunar_table.py -o main/basic/lunar_data.c
+    python tools/lunar_table.py --check        # 只核对，输出差异
+"""
+
+import argparse
+import bisect
+import math
+import sys
+
+YEAR_MIN = 1900
+YEAR_MAX = 2100
+NEAR_MIDNIGHT_MIN = 10      # 本算法节气误差约 ±8 分钟
+
+TERM_NAMES = ['小寒', '大寒', '立春', '雨水', '惊蛰', '春分', '清明', '谷雨',
+              '立夏', '小满', '芒种', '夏至', '小暑', '大暑', '立秋', '处暑',
+              '白露', '秋分', '寒露', '霜降', '立冬', '小雪', '大雪', '冬至']
+
+# 发布的农历数据，每年 20 位：
+# bit0~3 闰月月份（0 无闰月），bit4~15 正月~十二月大小（bit15 为正月，1 为 30 天），bit16 闰月大小
+PUBLISHED = [
+    0x04bd8, 0x04ae0, 0x0a570, 0x054d5, 0x0d260, 0x0d950, 0x16554, 0x056a0, 0x09ad0, 0x055d2,  # 1900
+    0x04ae0, 0x0a5b6, 0x0a4d0, 0x0d250, 0x1d255, 0x0b540, 0x0d6a0, 0x0ada2, 0x095b0, 0x14977,  # 1910
+    0x04970, 0x0a4b0, 0x0b4b5, 0x06a50, 0x06d40, 0x1ab54, 0x02b60, 0x09570, 0x052f2, 0x04970,  # 1920
+    0x06566, 0x0d4a0, 0x0ea50, 0x16a95, 0x05ad0, 0x02b60, 0x186e3, 0x092e0, 0x1c8d7, 0x0c950,  # 1930
+    0x0d4a0, 0x1d8a6, 0x0b550, 0x056a0, 0x1a5b4, 0x025d0, 0x092d0, 0x0d2b2, 0x0a950, 0x0b557,  # 1940
+    0x06ca0, 0x0b550, 0x15355, 0x04da0, 0x0a5b0, 0x14573, 0x052b0, 0x0a9a8, 0x0e950, 0x06aa0,  # 1950
+    0x0aea6, 0x0ab50, 0x04b60, 0x0aae4, 0x0a570, 0x05260, 0x0f263, 0x0d950, 0x05b57, 0x056a0,  # 1960
+    0x096d0, 0x04dd5, 0x04ad0, 0x0a4d0, 0x0d4d4, 0x0d250, 0x0d558, 0x0b540, 0x0b6a0, 0x195a6,  # 1970
+    0x095b0, 0x049b0, 0x0a974, 0x0a4b0, 0x0b27a, 0x06a50, 0x06d40, 0x0af46, 0x0ab60, 0x09570,  # 1980
+    0x04af5, 0x04970, 0x064b0, 0x074a3, 0x0ea50, 0x06b58, 0x05ac0, 0x0ab60, 0x096d5, 0x092e0,  # 1990
+    0x0c960, 0x0d954, 0x0d4a0, 0x0da50, 0x07552, 0x056a0, 0x0abb7, 0x025d0, 0x092d0, 0x0cab5,  # 2000
+    0x0a950, 0x0b4a0, 0x0baa4, 0x0ad50, 0x055d9, 0x04ba0, 0x0a5b0, 0x15176, 0x052b0, 0x0a930,  # 2010
+    0x07954, 0x06aa0, 0x0ad50, 0x05b52, 0x04b60, 0x0a6e6, 0x0a4e0, 0x0d260, 0x0ea65, 0x0d530,  # 2020
+    0x05aa0, 0x076a3, 0x096d0, 0x04afb, 0x04ad0, 0x0a4d0, 0x1d0b6, 0x0d250, 0x0d520, 0x0dd45,  # 2030
+    0x0b5a0, 0x056d0, 0x055b2, 0x049b0, 0x0a577, 0x0a4b0, 0x0aa50, 0x1b255, 0x06d20, 0x0ada0,  # 2040
+    0x14b63, 0x09370, 0x049f8, 0x04970, 0x064b0, 0x168a6, 0x0ea50, 0x06b20, 0x1a6c4, 0x0aae0,  # 2050
+    0x092e0, 0x0d2e3, 0x0c960, 0x0d557, 0x0d4a0, 0x0da50, 0x05d55, 0x056a0, 0x0a6d0, 0x055d4,  # 2060
+    0x052d0, 0x0a9b8, 0x0a950, 0x0b4a0, 0x0b6a6, 0x0ad50, 0x055a0, 0x0aba4, 0x0a5b0, 0x052b0,  # 2070
+    0x0b273, 0x06930, 0x07337, 0x06aa0, 0x0ad50, 0x14b55, 0x04b60, 0x0a570, 0x054e4, 0x0d160,  # 2080
+    0x0e968, 0x0d520, 0x0daa0, 0x16aa6, 0x056d0, 0x04ae0, 0x0a9d4, 0x0a2d0, 0x0d150, 0x0f252,  # 2090
+    0x0d520,                                                                                    # 2100
+]
+FIRST_NEW_YEAR = (1900, 1, 31)
+
+# 寿星通式 [Y*D+C]-L 的世纪常数（20 世纪、21 世纪）及已公布的修正，只用于距午夜过近的节气
+TERM_C20 = [6.11, 20.84, 4.6295, 19.4599, 6.3826, 21.4155, 5.59, 20.888, 6.318, 21.86, 6.5, 22.2,
+            7.928, 23.65, 8.35, 23.95, 8.44, 23.822, 9.098, 24.218, 8.218, 23.08, 7.9, 22.6]
+TERM_C21 = [5.4055, 20.12, 3.87, 18.73, 5.63, 20.646, 4.81, 20.1, 5.52, 21.04, 5.678, 21.37,
+            7.108, 22.83, 7.5, 23.13, 7.646, 23.042, 8.318, 23.438, 7.438, 22.36, 7.18, 21.94]
+TERM_FIX = {(1918, 23): -1, (2021, 23): -1, (2019, 0): -1, (1982, 0): 1, (2082, 1): 1,
+            (2026, 3): -1, (2084, 5): 1, (1911, 8): 1, (2008, 9): 1, (1902, 10): 1, (1928, 11): 1,
+            (1925, 12): 1, (2016, 12): 1, (1922, 13): 1, (2002, 14): 1, (1927, 16): 1, (1942, 17): 1,
+            (2089, 19): 1, (2089, 20): 1, (1978, 21): 1, (1954, 22): 1}
+
+
+# ---------------------------------------------------------------- 天文计算
+
+def rad(x):
+    return math.radians(x % 360.0)
+
+
+def jd_from_civil(y, m, d):
+    if m <= 2:
+        y -= 1
+        m += 12
+    a = y // 100
+    return math.floor(365.25 * (y + 4716)) + math.floor(30.6001 * (m + 1)) + d + 2 - a + a // 4 - 1524.5
+
+
+def civil_from_jdn(jdn):
+    """整数儒略日数 -> (年, 月, 日)"""
+    a = jdn + 32044
+    b = (4 * a + 3) // 146097
+    c = a - 146097 * b // 4
+    d = (4 * c + 3) // 1461
+    e = c - 1461 * d // 4
+    m = (5 * e + 2) // 153
+    return 100 * b + d - 4800 + m // 10, m + 3 - 12 * (m // 10), e - (153 * m + 2) // 5 + 1
+
+
+def delta_t(year):
+    """TT - UT（秒），Espenak & Meeus 多项式"""
+    if year < 1920:
+        t = year - 1900
+        return -2.79 + 1.494119 * t - 0.0598939 * t ** 2 + 0.0061966 * t ** 3 - 0.000197 * t ** 4
+    if year < 1941:
+        t = year - 1920
+        return 21.20 + 0.84493 * t - 0.076100 * t ** 2 + 0.0020936 * t ** 3
+    if year < 1961:
+        t = year - 1950
+        return 29.07 + 0.407 * t - t ** 2 / 233 + t ** 3 / 2547
+    if year < 1986:
+        t = year - 1975
+        return 45.45 + 1.067 * t - t ** 2 / 260 - t ** 3 / 718
+    if year < 2005:
+        t = year - 2000
+        return (63.86 + 0.3345 * t - 0.060374 * t ** 2 + 0.0017275 * t ** 3
+                + 0.000651814 * t ** 4 + 0.00002373599 * t ** 5)
+    if year < 2050:
+        t = year - 2000
+        return 62.92 + 0.32217 * t + 0.005589 * t ** 2
+    return -20 + 32 * ((year - 1820) / 100) ** 2 - 0.5628 * (2150 - year)
+
+
+NEW_MOON_TERMS = [
+    # (系数, E 的次数, M, M', F)
+    (-0.40720, 0, 0, 1, 0), (0.17241, 1, 1, 0, 0), (0.01608, 0, 0, 2, 0), (0.01039, 0, 0, 0, 2),
+    (0.00739, 1, -1, 1, 0), (-0.00514, 1, 1, 1, 0), (0.00208, 2, 2, 0, 0), (-0.00111, 0, 0, 1, -2),
+    (-0.00057, 0, 0, 1, 2), (0.00056, 1, 1, 2, 0), (-0.00042, 0, 0, 3, 0), (0.00042, 1, 1, 0, 2),
+    (0.00038, 1, 1, 0, -2), (-0.00024, 1, -1, 2, 0), (-0.00007, 0, 2, 1, 0), (0.00004, 0, 0, 2, -2),
+    (0.00004, 0, 3, 0, 0), (0.00003, 0, 1, 1, -2), (0.00003, 0, 0, 2, 2), (-0.00003, 0, 1, 1, 2),
+    (0.00003, 0, -1, 1, 2), (-0.00002, 0, -1, 1, -2), (-0.00002, 0, 1, 3, 0), (0.00002, 0, 0, 4, 0),
+]
+
+NEW_MOON_PLANETARY = [
+    (299.77, 0.107408, 0.000325), (251.88, 0.016321, 0.000165), (251.83, 26.651886, 0.000164),
+    (349.42, 36.412478, 0.000126), (84.66, 18.206239, 0.000110), (141.74, 53.303771, 0.000062),
+    (207.14, 2.453732, 0.000060), (154.84, 7.306860, 0.000056), (34.52, 27.261239, 0.000047),
+    (207.19, 0.121824, 0.000042), (291.34, 1.844379, 0.000040), (161.72, 24.198154, 0.000037),
+    (239.56, 25.513099, 0.000035), (331.55, 3.592518, 0.000023),
+]
+
+
+def new_moon_jde(k):
+    """第 k 个朔（k=0 为 2000-01-06）的 TT 儒略日，Meeus 第 49 章"""
+    t = k / 1236.85
+    jde = 2451550.09766 + 29.530588861 * k + 0.00015437 * t ** 2 - 0.000000150 * t ** 3 + 0.00000000073 * t ** 4
+    e = 1 - 0.002516 * t - 0.0000074 * t ** 2
+    m = 2.5534 + 29.10535670 * k - 0.0000014 * t ** 2 - 0.00000011 * t ** 3
+    mp = 201.5643 + 385.81693528 * k + 0.0107582 * t ** 2 + 0.00001238 * t ** 3 - 0.000000058 * t ** 4
+    f = 160.7108 + 390.67050284 * k - 0.0016118 * t ** 2 - 0.00000227 * t ** 3 + 0.000000011 * t ** 4
+    om = 124.7746 - 1.56375588 * k + 0.0020672 * t ** 2 + 0.00000215 * t ** 3
+    for coef, ep, cm, cmp, cf in NEW_MOON_TERMS:
+        jde += coef * e ** ep * math.sin(rad(cm * m + cmp * mp + cf * f))
+    jde -= 0.00017 * math.sin(rad(om))
+    for i, (a0, a1, coef) in enumerate(NEW_MOON_PLANETARY):
+        jde += coef * math.sin(rad(a0 + a1 * k - (0.009173 * t ** 2 if i == 0 else 0)))
+    return jde
+
+
+def sun_longitude(jde):
+    """太阳视黄经（度），Meeus 低精度公式加主要摄动项，误差约 0.003°"""
+    t = (jde - 2451545.0) / 36525
+    l0 = 280.46646 + 36000.76983 * t + 0.0003032 * t ** 2
+    m = rad(357.52911 + 35999.05029 * t - 0.0001537 * t ** 2)
+    c = ((1.914602 - 0.004817 * t - 0.000014 * t ** 2) * math.sin(m)
+         + (0.019993 - 0.000101 * t) * math.sin(2 * m) + 0.000289 * math.sin(3 * m))
+    c += (0.00134 * math.cos(rad(153.23 + 22518.7541 * t)) + 0.00154 * math.cos(rad(216.57 + 45037.5082 * t))
+          + 0.00200 * math.cos(rad(312.69 + 32964.3577 * t))
+          + 0.00179 * math.sin(rad(350.74 + 445267.1142 * t - 0.00144 * t ** 2))
+          + 0.00178 * math.sin(rad(231.19 + 20.20 * t)))
+    return (l0 + c - 0.00569 - 0.00478 * math.sin(rad(125.04 - 1934.136 * t))) % 360
+
+
+def term_jde(year, i):
+    """year 年第 i 个节气（0 为小寒）的 TT 儒略日"""
+    angle = (285 + 15 * i) % 360
+    jd = jd_from_civil(year, 1, 6) + i * 15.2184
+    for _ in range(50):
+        d = (angle - sun_longitude(jd) + 180) % 360 - 180
+        jd += d * 365.2422 / 360
+        if abs(d) < 1e-9:
+            break
+    return jd
+
+
+def to_beijing(jde):
+    """TT 儒略日 -> 北京时间儒略日，1929 年前为北京地方平时（东经 116°25'）"""
+    year = 2000 + (jde - 2451545.0) / 365.25
+    ut = jde - delta_t(year) / 86400
+    return ut + (8 if year >= 1929 else (116 + 25 / 60) / 15) / 24
+
+
+def day_and_margin(jde):
+    """北京时间所在日（整数儒略日数）与距最近午夜的分钟数"""
+    x = to_beijing(jde) + 0.5
+    frac = x - math.floor(x)
+    return math.floor(x), min(frac, 1 - frac) * 1440
+
+
+# ---------------------------------------------------------------- 节气
+
+def term_formula(year, i):
+    y = year - 1900 if year <= 2000 else year - 2000
+    c = TERM_C20[i] if year <= 2000 else TERM_C21[i]
+    leap = (y - 1) // 4 if i < 4 else y // 4
+    return math.floor(y * 0.2422 + c) - leap + TERM_FIX.get((year, i), 0)
+
+
+def term_days():
+    """[年][节气] -> 当月日期，以及靠近午夜改用通式的列表"""
+    table = {}
+    near = []
+    for year in range(YEAR_MIN, YEAR_MAX + 1):
+        row = []
+        for i in range(24):
+            jdn, margin = day_and_margin(term_jde(year, i))
+            y, m, d = civil_from_jdn(jdn)
+            assert (y, m) == (year, i // 2 + 1), (year, i)
+            if margin < NEAR_MIDNIGHT_MIN:
+                f = term_formula(year, i)
+                near.append((year, i, d, f, margin))
+                d = f
+            row.append(d)
+        table[year] = row
+    return table, near
+
+
+# ---------------------------------------------------------------- 农历月表
+
+def published_months(year):
+    """发布表中 year 年的月序列 [(月, 闰, 天数)]"""
+    info = PUBLISHED[year - YEAR_MIN]
+    leap = info & 0xf
+    months = []
+    for m in range(1, 13):
+        months.append((m, False, 30 if info & (0x10000 >> m) else 29))
+        if m == leap:
+            months.append((m, True, 30 if info & 0x10000 else 29))
+    return months
+
+
+def astronomical_months(first, last):
+    """按朔和中气推出 first~last 年的月表：{年: [(月, 闰, 天数)]} 以及正月初一"""
+    k0 = math.floor((first - 1.5 - 2000) * 12.3685)
+    k1 = math.floor((last + 1.5 - 2000) * 12.3685)
+    moons = [new_moon_jde(k) for k in range(k0, k1)]
+    moon_days = [day_and_margin(j)[0] for j in moons]
+    zq_days = sorted(day_and_margin(term_jde(y, i))[0] for y in range(first - 1, last + 2) for i in range(1, 24, 2))
+
+    def has_zhongqi(a, b):
+        i = bisect.bisect_left(zq_days, a)
+        return i < len(zq_days) and zq_days[i] < b
+
+    seq = []    # (起始日, 月, 闰)
+    for y in range(first - 1, last + 1):
+        a = bisect.bisect_right(moon_days, day_and_margin(term_jde(y, 23))[0]) - 1
+        b = bisect.bisect_right(moon_days, day_and_margin(term_jde(y + 1, 23))[0]) - 1
+        need_leap = b - a == 13
+        num = 11
+        for idx in range(a, b):
+            if idx > a and need_leap and not has_zhongqi(moon_days[idx], moon_days[idx + 1]):
+                seq.append((moon_days[idx], num, True))
+                need_leap = False
+                continue
+            if idx > a:
+                num = num % 12 + 1
+            seq.append((moon_days[idx], num, False))
+    seq.append((moon_days[b], 11, False))
+
+    years, new_years = {}, {}
+    y = None
+    for i in range(len(seq) - 1):
+        start, num, leap = seq[i]
+        if num == 1 and not leap:
+            y = civil_from_jdn(start)[0]
+            years[y] = []
+            new_years[y] = start
+        if y is not None:
+            years[y].append((num, leap, seq[i + 1][0] - start))
+    return years, new_years, moons
+
+
+def check_months():
+    """逐年核对发布表，返回 (差异年份, 不可解释的差异)"""
+    years, new_years, moons = astronomical_months(YEAR_MIN, YEAR_MAX)
+    diffs, bad = [], []
+    ny = math.floor(jd_from_civil(*FIRST_NEW_YEAR) + 0.5)
+    for year in range(YEAR_MIN, YEAR_MAX + 1):
+        pub = published_months(year)
+        if years.get(year) != pub or new_years.get(year) != ny:
+            nxt = ny + sum(m[2] for m in pub)
+            near = [j for j in moons if ny - 30 <= day_and_margin(j)[0] <= nxt and day_and_margin(j)[1] < NEAR_MIDNIGHT_MIN]
+            near += [term_jde(y, i) for y in (year, year + 1) for i in range(1, 24, 2)
+                     if ny - 30 <= day_and_margin(term_jde(y, i))[0] <= nxt and day_and_margin(term_jde(y, i))[1] < NEAR_MIDNIGHT_MIN]
+            diffs.append(year)
+            if not near:
+                bad.append(year)
+        ny += sum(m[2] for m in pub)
+    return diffs, bad
+
+
+# ---------------------------------------------------------------- 输出
+
+def pack_years():
+    """lunar.c 使用的格式：bit0~12 按顺序各月大小（含闰月），bit13~16 闰月，bit17~22 正月初一距 1 月 1 日天数"""
+    packed = []
+    ny = math.floor(jd_from_civil(*FIRST_NEW_YEAR) + 0.5)
+    for year in range(YEAR_MIN, YEAR_MAX + 1):
+        months = published_months(year)
+        bits = sum(1 << i for i, m in enumerate(months) if m[2] == 30)
+        leap = PUBLISHED[year - YEAR_MIN] & 0xf
+        offset = ny - math.floor(jd_from_civil(year, 1, 1) + 0.5)
+        assert 0 <= offset < 64
+        packed.append(bits | leap << 13 | offset << 17)
+        ny += sum(m[2] for m in months)
+    return packed
+
+
+def emit(path, terms):
+    base = [min(terms[y][i] for y in terms) for i in range(24)]
+    lines = [
+        '/**',
+        ' * @file lunar_data.c',
+        ' * @brief 农历与节气数据（由 tools/lunar_table.py 生成，请勿手工修改）',
+        ' */',
+        '',
+        '#include <stdint.h>',
+        '',
+        '/* %d~%d 年，格式见 lunar.c */' % (YEAR_MIN, YEAR_MAX),
+        'const uint32_t lunar_year_info[%d] = {' % (YEAR_MAX - YEAR_MIN + 1),
+    ]
+    packed = pack_years()
+    for i in range(0, len(packed), 8):
+        lines.append('    ' + ' '.join('0x%06x,' % v for v in packed[i:i + 8]) + '  // %d' % (YEAR_MIN + i))
+    lines += ['};', '', '/* 各节气最早的日期 */',
+              'const uint8_t lunar_term_base[24] = {',
+              '    ' + ' '.join('%d,' % b for b in base),
+              '};', '',
+              '/* 各年节气相对最早日期的偏移，每个节气 2 位，小寒在最低位 */',
+              'const uint8_t lunar_term_delta[%d][6] = {' % (YEAR_MAX - YEAR_MIN + 1)]
+    for year in range(YEAR_MIN, YEAR_MAX + 1):
+        v = 0
+        for i in range(24):
+            delta = terms[year][i] - base[i]
+            assert 0 <= delta < 4, (year, i)
+            v |= delta << (2 * i)
+        lines.append('    {' + ', '.join('0x%02x' % ((v >> (8 * b)) & 0xff) for b in range(6)) + '},  // %d' % year)
+    lines += ['};', '']
+    with open(path, 'w', encoding='utf-8', newline='\n') as f:
+        f.write('\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='生成农历与节气数据表')
+    parser.add_argument('-o', '--output', help='输出的 C 文件')
+    parser.add_argument('--check', action='store_true', help='只核对，不生成')
+    args = parser.parse_args()
+
+    diffs, bad = check_months()
+    print('农历月表：%d 年与天文推算一致，%d 年因朔或中气靠近午夜而不同：%s'
+          % (YEAR_MAX - YEAR_MIN + 1 - len(diffs), len(diffs), ' '.join(map(str, diffs))))
+    terms, near = term_days()
+    changed = [n for n in near if n[2] != n[3]]
+    print('节气：%d 个距午夜不到 %d 分钟，按通式确定，其中 %d 个与天文推算的日期不同'
+          % (len(near), NEAR_MIDNIGHT_MIN, len(changed)))
+    for year, i, d, f, margin in changed:
+        print('  %d %s 推算 %d 日（距午夜 %.1f 分钟），采用 %d 日' % (year, TERM_NAMES[i], d, margin, f))
+    if bad:
+        print('错误：以下年份的差异无法用精度解释：%s' % ' '.join(map(str, bad)))
+        return 1
+
+    if args.output and not args.check:
+        emit(args.output, terms)
+        print('已生成 %s' % args.output)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""
+rtttl2bmf.py - 将RTTTL铃声转换为蜂鸣器BMF二进制格式
+
+格式定义见 main/basic/beep_melody.h。
+生成的 .bmf 文件放入LittleFS镜像的 sounds/ 目录即可由 beep_melody_play() 播放。
+
+用法:
+    python tools/rtttl2bmf.py alarm.rtttl -o alarm.bmf
+    python tools/rtttl2bmf.py "warn:d=16,o=6,b=180:c,e,g" -o warn.bmf --loop 2
+    python tools/rtttl2bmf.py sounds/ -o build/littlefs/sounds/    # 批量转换目录
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+OP_END = 0x00
+OP_NOTE = 0x10
+OP_REST = 0x20
+OP_VOLUME = 0x30
+OP_ENVELOPE = 0x40
+OP_LOOP_START = 0x50
+OP_LOOP_END = 0x51
+
+# 蜂鸣器可用频率范围，与 beepdrive.c 保持一致
+FREQ_MIN = 200
+FREQ_MAX = 2700
+
+NOTE_INDEX = {'c': 0, 'c#': 1, 'd': 2, 'd#': 3, 'e': 4, 'f': 5,
+              'f#': 6, 'g': 7, 'g#': 8, 'a': 9, 'a#': 10, 'b': 11, 'h': 11}
+
+NOTE_RE = re.compile(r'^(\d*)([a-hp]#?)(\.?)(\d?)(\.?)$')
+
+
+def note_freq(name, octave):
+    """十二平均律，A4 = 440Hz"""
+    semitone = NOTE_INDEX[name] + (octave - 4) * 12 - 9
+    return 440.0 * (2.0 ** (semitone / 12.0))
+
+
+def fit_range(freq, warn):
+    """超出蜂鸣器范围的音符按八度移入可用范围"""
+    orig = freq
+    while freq < FREQ_MIN:
+        freq *= 2
+    while freq > FREQ_MAX:
+        freq /= 2
+    if freq != orig:
+        warn('%.0f Hz out of buzzer range, shifted to %.0f Hz' % (orig, freq))
+    return int(round(freq))
+
+
+def parse_rtttl(text):
+    """解析RTTTL字符串，返回 (名称, [(freq或0, 时长ms), ...])"""
+    text = ''.join(text.split())
+    parts = text.split(':')
+    if len(parts) != 3:
+        raise ValueError('RTTTL must have 3 sections: name:defaults:notes')
+    name, defaults, notes = parts
+
+    d, o, b = 4, 6, 63
+    for item in filter(None, defaults.split(',')):
+        key, _, val = item.partition('=')
+        key = key.lower()
+        if key == 'd':
+            d = int(val)
+        elif key == 'o':
+            o = int(val)
+        elif key == 'b':
+            b = int(val)
+        else:
+            raise ValueError('unknown default: %s' % item)
+
+    whole_ms = 60000.0 / b * 4
+    events = []
+    for tok in filter(None, notes.lower().split(',')):
+        m = NOTE_RE.match(tok)
+        if not m:
+            raise ValueError('bad note: %s' % tok)
+        dur_s, note, dot1, oct_s, dot2 = m.groups()
+        dur = int(dur_s) if dur_s else d
+        octave = int(oct_s) if oct_s else o
+        ms = whole_ms / dur
+        if dot1 or dot2:
+            ms *= 1.5
+        freq = 0 if note == 'p' else note_freq(note, octave)
+        events.append((freq, int(round(ms))))
+    return name, events
+
+
+def encode(events, volume, envelope, loop, gap_ms, warn):
+    """编码为BMF字节串"""
+    out = bytearray(b'BMF1')
+    out += struct.pack('<BBH', 1, volume, 0)
+
+    if envelope:
+        a, dcy, s, r = envelope
+        out += struct.pack('<BBBBB', OP_ENVELOPE,
+                           min(a // 4, 255), min(dcy // 4, 255), s, min(r // 4, 255))
+
+    if loop is not None:
+        out.append(OP_LOOP_START)
+
+    for freq, ms in events:
+        # 时长字段为16位，超长音符拆分
+        while ms > 0:
+            chunk = min(ms, 0xFFFF)
+            ms -= chunk
+            if freq == 0:
+                out += struct.pack('<BH', OP_REST, chunk)
+            elif gap_ms and ms == 0 and chunk > gap_ms:
+                # 音符尾部留出间隙，避免连续相同音符粘连
+                out += struct.pack('<BHH', OP_NOTE, fit_range(freq, warn), chunk - gap_ms)
+                out += struct.pack('<BH', OP_REST, gap_ms)
+            else:
+                out += struct.pack('<BHH', OP_NOTE, fit_range(freq, warn), chunk)
+
+    if loop is not None:
+        out += struct.pack('<BB', OP_LOOP_END, loop)
+
+    out.append(OP_END)
+    return bytes(out)
+
+
+def convert_one(src_text, args, label):
+    def warn(msg):
+        print('%s: warning: %s' % (label, msg), file=sys.stderr)
+
+    name, events = parse_rtttl(src_text)
+    return name, encode(events, args.volume, args.envelope, args.loop, args.gap, warn)
+
+
+def parse_envelope(s):
+    vals = [int(v) for v in s.split(',')]
+    if len(vals) != 4:
+        raise argparse.ArgumentTypeError('envelope must be attack,decay,sustain,release')
+    if not 0 <= vals[2] <= 100:
+        raise argparse.ArgumentTypeError('sustain must be 0-100')
+    return vals
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Convert RTTTL ringtones to BMF buzzer melodies')
+    ap.add_argument('input', help='RTTTL string, .rtttl/.txt file, or directory of them')
+    ap.add_argument('-o', '--output', help='output file, or directory when input is a directory')
+    ap.add_argument('--volume', type=int, default=100, help='initial volume 0-100 (default 100)')
+    ap.add_argument('--envelope', type=parse_envelope,
+                    help='attack_ms,decay_ms,sustain_pct,release_ms, e.g. 8,40,70,20')
+    ap.add_argument('--loop', type=int, metavar='N',
+                    help='wrap melody in a loop; N extra repeats, 0 = forever')
+    ap.add_argument('--gap', type=int, default=10, help='silence after each note in ms (default 10)')
+    args = ap.parse_args()
+
+    if not 0 <= args.volume <= 100:
+        ap.error('volume must be 0-100')
+    if args.loop is not None and not 0 <= args.loop <= 255:
+        ap.error('loop must be 0-255')
+
+    if os.path.isdir(args.input):
+        outdir = args.output or args.input
+        os.makedirs(outdir, exist_ok=True)
+        for fn in sorted(os.listdir(args.input)):
+            stem, ext = os.path.splitext(fn)
+            if ext.lower() not in ('.rtttl', '.txt'):
+                continue
+            with open(os.path.join(args.input, fn), encoding='utf-8') as f:
+                _, data = convert_one(f.read(), args, fn)
+            dst = os.path.join(outdir, stem + '.bmf')
+            with open(dst, 'wb') as f:
+                f.write(data)
+            print('%s -> %s (%d bytes)' % (fn, dst, len(data)))
+        return
+
+    if os.path.isfile(args.input):
+        with open(args.input, encoding='utf-8') as f:
+            text = f.read()
+        label = args.input
+    else:
+        text = args.input
+        label = 'rtttl'
+
+    name, data = convert_one(text, args, label)
+    dst = args.output or (name or 'melody') + '.bmf'
+    with open(dst, 'wb') as f:
+        f.write(data)
+    print('%s -> %s (%d bytes)' % (label, dst, len(data)))
+
+
+if __name__ == '__main__':
+    main()